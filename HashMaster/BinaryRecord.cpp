@@ -1,4 +1,5 @@
 #include "BinaryRecord.h"
+#include "SpecCache.h"
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -73,6 +74,11 @@ const FieldInfo* RecordLayout::getField(const std::string& name) const {
     return nullptr;
 }
 
+FieldHandle RecordLayout::handle(const std::string& name) const {
+    auto it = _fieldIndex.find(name);
+    return it != _fieldIndex.end() ? FieldHandle(_fields[it->second], it->second) : FieldHandle();
+}
+
 void RecordLayout::calculateLayout() {
     int offset = 0;
     for (auto& field : _fields) {
@@ -175,10 +181,6 @@ void BinaryRecord::setBuffer(char* buffer, bool takeOwnership) {
     _ownBuffer = takeOwnership;
 }
 
-int BinaryRecord::getSize() const {
-    return _layout ? _layout->getRecordSize() : 0;
-}
-
 void BinaryRecord::clear() {
     if (_buffer && _layout) {
         memset(_buffer, 0, _layout->getRecordSize());
@@ -192,84 +194,32 @@ const FieldInfo* BinaryRecord::getFieldInfo(const std::string& name) const {
 
 // 문자열 쓰기
 bool BinaryRecord::setString(const std::string& fieldName, const std::string& value) {
-    const FieldInfo* field = getFieldInfo(fieldName);
-
-    if (!field || !_buffer) return false;
-    // std::cout << "setValue: " << fieldName << " " << fieldTypeToString(field->type) << std::endl;
-    if (field->type == FieldType::CHAR) {
-        if (field->length <= 0) {
-            std::cerr << "ERROR: Invalid field length for " << fieldName << ": " << field->length << std::endl;
-            return false;
-        }
-        int copyLen = std::min(static_cast<int>(value.length()), field->length - 1);
-        if (copyLen < 0) copyLen = 0;  // Safety check
-        memset(_buffer + field->offset, 0, field->length);
-        if (copyLen > 0) {
-            memcpy(_buffer + field->offset, value.c_str(), copyLen);
-        }
-        return true;
-    }
-    
-    return setValue(fieldName, value);
+    return setString(getHandle(fieldName), value);
 }
 
 // 정수 쓰기
 bool BinaryRecord::setInt(const std::string& fieldName, int value) {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return false;
-    
-    if (field->type == FieldType::INT && field->length >= 4) {
-        memcpy(_buffer + field->offset, &value, sizeof(int));
-        return true;
-    }
-    
-    return setValue(fieldName, std::to_string(value));
+    return setInt(getHandle(fieldName), value);
 }
 
 // 롱 쓰기
 bool BinaryRecord::setLong(const std::string& fieldName, long long value) {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return false;
-    
-    if ((field->type == FieldType::ULONG || field->type == FieldType::LONG) && field->length >= 8) {
-        memcpy(_buffer + field->offset, &value, sizeof(long long));
-        return true;
-    }
-    
-    return setValue(fieldName, std::to_string(value));
+    return setLong(getHandle(fieldName), value);
 }
 
 // 더블 쓰기
 bool BinaryRecord::setDouble(const std::string& fieldName, double value) {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return false;
-    
-    if (field->type == FieldType::DOUBLE && field->length >= 8) {
-        memcpy(_buffer + field->offset, &value, sizeof(double));
-        return true;
-    }
-    
-    return setValue(fieldName, std::to_string(value));
+    return setDouble(getHandle(fieldName), value);
 }
 
 // X 모드 쓰기
 bool BinaryRecord::setXMode(const std::string& fieldName, const std::string& value) {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return false;
-    
-    std::string formatted = formatXMode(value, field->length);
-    memcpy(_buffer + field->offset, formatted.c_str(), field->length);
-    return true;
+    return setXMode(getHandle(fieldName), value.data(), value.size());
 }
 
 // 9 모드 쓰기
 bool BinaryRecord::set9Mode(const std::string& fieldName, const std::string& value) {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return false;
-    
-    std::string formatted = format9Mode(value, field->length, field->decimal);
-    memcpy(_buffer + field->offset, formatted.c_str(), field->length);
-    return true;
+    return set9Mode(getHandle(fieldName), value.data(), value.size());
 }
 
 // X 모드 초기화 (특정 문자로 필드를 채움)
@@ -304,59 +254,22 @@ bool BinaryRecord::init9Mode(const std::string& fieldName, char fillChar) {
 
 // 문자열 읽기
 std::string BinaryRecord::getString(const std::string& fieldName) const {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return "";
-    
-    if (field->type == FieldType::CHAR) {
-        return std::string(_buffer + field->offset, field->length);
-    }
-    
-    return getValue(fieldName);
+    return getString(getHandle(fieldName));
 }
 
 // 정수 읽기
 int BinaryRecord::getInt(const std::string& fieldName) const {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return 0;
-    
-    if (field->type == FieldType::INT && field->length >= 4) {
-        int value;
-        memcpy(&value, _buffer + field->offset, sizeof(int));
-        return value;
-    }
-    
-    std::string str = getValue(fieldName);
-    return str.empty() ? 0 : std::atoi(str.c_str());
+    return getInt(getHandle(fieldName));
 }
 
 // 롱 읽기
 long long BinaryRecord::getLong(const std::string& fieldName) const {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return 0;
-    
-    if ((field->type == FieldType::ULONG || field->type == FieldType::LONG) && field->length >= 8) {
-        long long value;
-        memcpy(&value, _buffer + field->offset, sizeof(long long));
-        return value;
-    }
-    
-    std::string str = getValue(fieldName);
-    return str.empty() ? 0 : std::atoll(str.c_str());
+    return getLong(getHandle(fieldName));
 }
 
 // 더블 읽기
 double BinaryRecord::getDouble(const std::string& fieldName) const {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return 0.0;
-    
-    if (field->type == FieldType::DOUBLE && field->length >= 8) {
-        double value;
-        memcpy(&value, _buffer + field->offset, sizeof(double));
-        return value;
-    }
-    
-    std::string str = getValue(fieldName);
-    return str.empty() ? 0.0 : std::atof(str.c_str());
+    return getDouble(getHandle(fieldName));
 }
 
 // X 모드 읽기
@@ -364,7 +277,7 @@ std::string BinaryRecord::getXMode(const std::string& fieldName) const {
     const FieldInfo* field = getFieldInfo(fieldName);
     if (!field || !_buffer) return "";
     
-    return parseXMode(_buffer + field->offset, field->length);
+    return BinaryRecordView::parseXMode(_buffer + field->offset, field->length);
 }
 
 // 9 모드 읽기
@@ -372,108 +285,338 @@ std::string BinaryRecord::get9Mode(const std::string& fieldName) const {
     const FieldInfo* field = getFieldInfo(fieldName);
     if (!field || !_buffer) return "";
     
-    return parse9Mode(_buffer + field->offset, field->length, field->decimal);
+    return BinaryRecordView::parse9Mode(_buffer + field->offset, field->length, field->decimal);
 }
 
 // 범용 값 설정
+// X/9/char 는 각 모드로 포맷, 바이너리 타입들은 문자열 그대로 저장
 bool BinaryRecord::setValue(const std::string& fieldName, const std::string& value) {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return false;
-    
-    if (field->type == FieldType::X_MODE) {
-        return setXMode(fieldName, value);
-    } else if (field->type == FieldType::NINE_MODE) {
-        return set9Mode(fieldName, value);
-    } else if (field->type == FieldType::CHAR) {
-        return setString(fieldName, value);
-    } else {
-        // 바이너리 타입들은 문자열로 변환해서 저장
-        std::string formatted = value;
-        formatted.resize(field->length, '\0');
-        memcpy(_buffer + field->offset, formatted.c_str(), field->length);
-        return true;
-    }
+    return setString(getHandle(fieldName), value);
 }
 
 // 범용 값 가져오기
 std::string BinaryRecord::getValue(const std::string& fieldName) const {
-    const FieldInfo* field = getFieldInfo(fieldName);
-    if (!field || !_buffer) return "";
-    
-    switch (field->type) {
+    return getValue(getHandle(fieldName));
+}
+
+// ===== 핸들 기반 접근 (BinaryRecordView, BinaryRecord 의 핸들 함수는 view 로 넘김) =====
+
+// 부호 있는 정수를 10진 문자열로 (NUL 없이 길이 반환)
+static int formatInteger(char* buf, long long value) {
+    char tmp[24];
+    unsigned long long v = value < 0 ? 0ULL - (unsigned long long)value : (unsigned long long)value;
+    int n = 0;
+    do {
+        tmp[n++] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while (v);
+    
+    int len = 0;
+    if (value < 0) buf[len++] = '-';
+    while (n) buf[len++] = tmp[--n];
+    return len;
+}
+
+void BinaryRecordView::writeText(char* dst, const FieldHandle& h, const char* value, size_t len) {
+    switch (h.type) {
         case FieldType::X_MODE:
-            return getXMode(fieldName);
+            writeXMode(dst, h.length, value, len);
+            break;
         case FieldType::NINE_MODE:
-            return get9Mode(fieldName);
+            write9Mode(dst, h.length, h.decimal, value, len);
+            break;
         case FieldType::CHAR: {
-            std::string result(_buffer + field->offset, field->length);
-            // null terminator 찾기
-            size_t nullPos = result.find('\0');
-            if (nullPos != std::string::npos) {
-                result = result.substr(0, nullPos);
-            }
-            return result;
+            // NUL 종료를 위해 마지막 1바이트는 남긴다
+            size_t copyLen = std::min(len, static_cast<size_t>(h.length - 1));
+            memset(dst, 0, h.length);
+            memcpy(dst, value, copyLen);
+            break;
+        }
+        default: {
+            // 바이너리 타입에 문자열을 쓰면 그대로 복사하고 나머지는 0
+            size_t copyLen = std::min(len, static_cast<size_t>(h.length));
+            memcpy(dst, value, copyLen);
+            memset(dst + copyLen, 0, h.length - copyLen);
+            break;
+        }
+    }
+}
+
+// X 모드 (고정길이, 우측 공백 패딩)
+void BinaryRecordView::writeXMode(char* dst, int length, const char* value, size_t len) {
+    if (length <= 0) return;
+    len = strnlen(value, len);
+    size_t copyLen = std::min(len, static_cast<size_t>(length));
+    memcpy(dst, value, copyLen);
+    memset(dst + copyLen, ' ', length - copyLen);
+}
+
+// 9 모드 (소수점 포함, 앞쪽 0 패딩)
+// decimal > 0 이면 "정수부.소수부(decimal 자리)" 로 맞추고, 길이를 넘으면 앞쪽을 잘라낸다.
+// 음수는 첫 자리에 '-' 를 두고 나머지 length-1 자리에 같은 규칙을 적용한다.
+void BinaryRecordView::write9Mode(char* dst, int length, int decimal, const char* value, size_t len) {
+    if (length <= 0) return;
+    len = strnlen(value, len);
+    
+    bool isNegative = len > 0 && value[0] == '-';
+    if (isNegative) {
+        value++;
+        len--;
+        *dst++ = '-';
+        length--;
+    }
+    
+    size_t intLen = len;
+    const char* decPart = nullptr;
+    size_t decLen = 0;
+    size_t resultLen = len;
+    if (decimal > 0) {
+        const char* dot = static_cast<const char*>(memchr(value, '.', len));
+        if (dot) {
+            intLen = dot - value;
+            decPart = dot + 1;
+            decLen = len - intLen - 1;
         }
+        resultLen = intLen + 1 + decimal;
+    }
+    
+    // 결과 문자열의 뒤쪽 length 자리 (모자라면 앞에 0)
+    long pad = static_cast<long>(length) - static_cast<long>(resultLen);
+    for (int i = 0; i < length; ++i) {
+        long pos = i - pad;
+        char c;
+        if (pos < 0) {
+            c = '0';
+        } else if (decimal <= 0 || pos < static_cast<long>(intLen)) {
+            c = value[pos];
+        } else if (pos == static_cast<long>(intLen)) {
+            c = '.';
+        } else {
+            size_t k = pos - intLen - 1;
+            c = k < decLen ? decPart[k] : '0';
+        }
+        dst[i] = c;
+    }
+}
+
+bool BinaryRecordView::setString(const FieldHandle& h, const char* value, size_t len) {
+    if (!h.valid() || !_buffer) return false;
+    if (h.type == FieldType::CHAR && h.length <= 0) {
+        std::cerr << "ERROR: Invalid field length at offset " << h.offset << ": " << h.length << std::endl;
+        return false;
+    }
+    if (!value) len = 0;
+    writeText(_buffer + h.offset, h, value ? value : "", len);
+    return true;
+}
+
+bool BinaryRecordView::setInt(const FieldHandle& h, int value) {
+    if (!h.valid() || !_buffer) return false;
+    
+    if (h.type == FieldType::INT && h.length >= 4) {
+        memcpy(_buffer + h.offset, &value, sizeof(int));
+        return true;
+    }
+    
+    char buf[24];
+    return setString(h, buf, formatInteger(buf, value));
+}
+
+bool BinaryRecordView::setLong(const FieldHandle& h, long long value) {
+    if (!h.valid() || !_buffer) return false;
+    
+    if ((h.type == FieldType::ULONG || h.type == FieldType::LONG) && h.length >= 8) {
+        memcpy(_buffer + h.offset, &value, sizeof(long long));
+        return true;
+    }
+    
+    char buf[24];
+    return setString(h, buf, formatInteger(buf, value));
+}
+
+bool BinaryRecordView::setDouble(const FieldHandle& h, double value) {
+    if (!h.valid() || !_buffer) return false;
+    
+    if (h.type == FieldType::DOUBLE && h.length >= 8) {
+        memcpy(_buffer + h.offset, &value, sizeof(double));
+        return true;
+    }
+    
+    // std::to_string(double) 과 같은 "%f" 포맷
+    char buf[400];
+    int n = snprintf(buf, sizeof(buf), "%f", value);
+    if (n < 0) return false;
+    return setString(h, buf, std::min(static_cast<size_t>(n), sizeof(buf) - 1));
+}
+
+bool BinaryRecordView::setXMode(const FieldHandle& h, const char* value, size_t len) {
+    if (!h.valid() || !_buffer) return false;
+    writeXMode(_buffer + h.offset, h.length, value ? value : "", value ? len : 0);
+    return true;
+}
+
+bool BinaryRecordView::set9Mode(const FieldHandle& h, const char* value, size_t len) {
+    if (!h.valid() || !_buffer) return false;
+    write9Mode(_buffer + h.offset, h.length, h.decimal, value ? value : "", value ? len : 0);
+    return true;
+}
+
+bool BinaryRecordView::fill(const FieldHandle& h, char fillChar) {
+    if (!h.valid() || !_buffer) return false;
+    memset(_buffer + h.offset, fillChar, h.length);
+    return true;
+}
+
+bool BinaryRecordView::copyField(const FieldHandle& h, const BinaryRecordView& src, const FieldHandle& srcHandle) {
+    if (!srcHandle.valid() || !src._buffer) return false;
+    
+    // char 필드는 NUL 전까지가 값이므로 버퍼에서 바로 복사
+    if (srcHandle.type == FieldType::CHAR) {
+        return setString(h, src.data(srcHandle), src.textLength(srcHandle));
+    }
+    return setString(h, src.getValue(srcHandle));
+}
+
+bool BinaryRecordView::updateBytes(const FieldHandle& h, const char* formatted, DirtyFieldSet* dirty) {
+    char* dst = _buffer + h.offset;
+    if (memcmp(dst, formatted, h.length) == 0) return false;
+    memcpy(dst, formatted, h.length);
+    if (dirty) dirty->mark(h);
+    return true;
+}
+
+bool BinaryRecordView::updateString(const FieldHandle& h, const char* value, size_t len, DirtyFieldSet* dirty) {
+    if (!h.valid() || !_buffer || h.length <= 0) return false;
+    char formatted[h.length];
+    writeText(formatted, h, value ? value : "", value ? len : 0);
+    return updateBytes(h, formatted, dirty);
+}
+
+bool BinaryRecordView::updateDouble(const FieldHandle& h, double value, DirtyFieldSet* dirty) {
+    if (!h.valid() || !_buffer || h.length <= 0) return false;
+    if (h.type == FieldType::DOUBLE && h.length >= 8) {
+        char formatted[h.length];
+        memcpy(formatted, _buffer + h.offset, h.length);
+        memcpy(formatted, &value, sizeof(double));
+        return updateBytes(h, formatted, dirty);
+    }
+    // setDouble 과 같은 "%f" 포맷
+    char buf[400];
+    int n = snprintf(buf, sizeof(buf), "%f", value);
+    if (n < 0) return false;
+    return updateString(h, buf, std::min(static_cast<size_t>(n), sizeof(buf) - 1), dirty);
+}
+
+size_t BinaryRecordView::textLength(const FieldHandle& h) const {
+    if (!h.valid() || !_buffer) return 0;
+    if (h.type == FieldType::CHAR) {
+        return strnlen(_buffer + h.offset, h.length);
+    }
+    return h.length;
+}
+
+bool BinaryRecordView::copyText(const FieldHandle& h, char* buf, size_t size) const {
+    const char* p = _buffer + h.offset;
+    size_t len = textLength(h);
+    
+    // 9 모드는 parse9Mode() 처럼 앞쪽 0을 제거 (소수점 앞 한 자리는 유지)
+    if (h.type == FieldType::NINE_MODE && len > 0) {
+        const char* dot = h.decimal > 0 ? static_cast<const char*>(memchr(p, '.', len)) : nullptr;
+        size_t keep = dot ? static_cast<size_t>(dot - p) : len;
+        size_t skip = 0;
+        while (skip + 1 < keep && p[skip] == '0') skip++;
+        p += skip;
+        len -= skip;
+    }
+    
+    if (len + 1 > size) return false;
+    memcpy(buf, p, len);
+    buf[len] = '\0';
+    return true;
+}
+
+std::string BinaryRecordView::getString(const FieldHandle& h) const {
+    if (!h.valid() || !_buffer) return "";
+    
+    if (h.type == FieldType::CHAR) {
+        return std::string(_buffer + h.offset, h.length);
+    }
+    
+    return getValue(h);
+}
+
+std::string BinaryRecordView::getValue(const FieldHandle& h) const {
+    if (!h.valid() || !_buffer) return "";
+    
+    const char* p = _buffer + h.offset;
+    switch (h.type) {
+        case FieldType::X_MODE:
+            return parseXMode(p, h.length);
+        case FieldType::NINE_MODE:
+            return parse9Mode(p, h.length, h.decimal);
+        case FieldType::CHAR:
+            // null terminator 까지
+            return std::string(p, strnlen(p, h.length));
         case FieldType::INT: {
-            if (field->length >= 4) {
+            if (h.length >= 4) {
                 int value;
-                memcpy(&value, _buffer + field->offset, sizeof(int));
+                memcpy(&value, p, sizeof(int));
                 return std::to_string(value);
             }
             break;
         }
         case FieldType::UINT: {
-            if (field->length >= 4) {
+            if (h.length >= 4) {
                 unsigned int value;
-                memcpy(&value, _buffer + field->offset, sizeof(unsigned int));
+                memcpy(&value, p, sizeof(unsigned int));
                 return std::to_string(value);
             }
             break;
         }
         case FieldType::SHORT: {
-            if (field->length >= 2) {
+            if (h.length >= 2) {
                 short value;
-                memcpy(&value, _buffer + field->offset, sizeof(short));
+                memcpy(&value, p, sizeof(short));
                 return std::to_string(value);
             }
             break;
         }
         case FieldType::USHORT: {
-            if (field->length >= 2) {
+            if (h.length >= 2) {
                 unsigned short value;
-                memcpy(&value, _buffer + field->offset, sizeof(unsigned short));
+                memcpy(&value, p, sizeof(unsigned short));
                 return std::to_string(value);
             }
             break;
         }
         case FieldType::LONG: {
-            if (field->length >= 8) {
+            if (h.length >= 8) {
                 long long value;
-                memcpy(&value, _buffer + field->offset, sizeof(long long));
+                memcpy(&value, p, sizeof(long long));
                 return std::to_string(value);
             }
             break;
         }
         case FieldType::ULONG: {
-            if (field->length >= 8) {
+            if (h.length >= 8) {
                 unsigned long long value;
-                memcpy(&value, _buffer + field->offset, sizeof(unsigned long long));
+                memcpy(&value, p, sizeof(unsigned long long));
                 return std::to_string(value);
             }
             break;
         }
         case FieldType::DOUBLE: {
-            if (field->length >= 8) {
+            if (h.length >= 8) {
                 double value;
-                memcpy(&value, _buffer + field->offset, sizeof(double));
+                memcpy(&value, p, sizeof(double));
                 return std::to_string(value);
             }
             break;
         }
         case FieldType::FLOAT: {
-            if (field->length >= 4) {
+            if (h.length >= 4) {
                 float value;
-                memcpy(&value, _buffer + field->offset, sizeof(float));
+                memcpy(&value, p, sizeof(float));
                 return std::to_string(value);
             }
             break;
@@ -483,7 +626,71 @@ std::string BinaryRecord::getValue(const std::string& fieldName) const {
     }
     
     // 기본적으로 바이너리 데이터를 문자열로 반환
-    return std::string(_buffer + field->offset, field->length);
+    return std::string(p, h.length);
+}
+
+// 텍스트 필드(char/X/9)는 스택 버퍼에서 바로 변환, 그 외는 getValue() 결과를 변환
+static bool isTextField(FieldType type) {
+    return type == FieldType::CHAR || type == FieldType::X_MODE || type == FieldType::NINE_MODE;
+}
+
+int BinaryRecordView::getInt(const FieldHandle& h) const {
+    if (!h.valid() || !_buffer) return 0;
+    
+    if (h.type == FieldType::INT && h.length >= 4) {
+        int value;
+        memcpy(&value, _buffer + h.offset, sizeof(int));
+        return value;
+    }
+    
+    char buf[64];
+    if (isTextField(h.type) && copyText(h, buf, sizeof(buf))) {
+        return std::atoi(buf);
+    }
+    std::string str = getValue(h);
+    return str.empty() ? 0 : std::atoi(str.c_str());
+}
+
+long long BinaryRecordView::getLong(const FieldHandle& h) const {
+    if (!h.valid() || !_buffer) return 0;
+    
+    if ((h.type == FieldType::ULONG || h.type == FieldType::LONG) && h.length >= 8) {
+        long long value;
+        memcpy(&value, _buffer + h.offset, sizeof(long long));
+        return value;
+    }
+    
+    char buf[64];
+    if (isTextField(h.type) && copyText(h, buf, sizeof(buf))) {
+        return std::atoll(buf);
+    }
+    std::string str = getValue(h);
+    return str.empty() ? 0 : std::atoll(str.c_str());
+}
+
+double BinaryRecordView::getDouble(const FieldHandle& h) const {
+    if (!h.valid() || !_buffer) return 0.0;
+    
+    if (h.type == FieldType::DOUBLE && h.length >= 8) {
+        double value;
+        memcpy(&value, _buffer + h.offset, sizeof(double));
+        return value;
+    }
+    
+    char buf[64];
+    if (isTextField(h.type) && copyText(h, buf, sizeof(buf))) {
+        return std::atof(buf);
+    }
+    std::string str = getValue(h);
+    return str.empty() ? 0.0 : std::atof(str.c_str());
+}
+
+bool BinaryRecordView::equals(const FieldHandle& h, const char* value, size_t len) const {
+    if (!h.valid() || !_buffer || h.length <= 0) return false;
+    
+    char formatted[h.length];
+    writeText(formatted, h, value ? value : "", value ? len : 0);
+    return memcmp(formatted, _buffer + h.offset, h.length) == 0;
 }
 
 // Map에서 데이터 로드
@@ -541,24 +748,14 @@ bool BinaryRecord::copyTo(char* dest, int size) const {
 
 // X 모드 포맷팅 (고정길이, 우측 패딩)
 std::string BinaryRecord::formatXMode(const std::string& value, int length) const {
-    // null 문자가 포함된 문자열을 정리 (첫 번째 null 문자까지만 사용)
-    std::string cleanValue = value;
-    size_t nullPos = cleanValue.find('\0');
-    if (nullPos != std::string::npos) {
-        cleanValue = cleanValue.substr(0, nullPos);
-    }
-    
-    std::string result = cleanValue;
-    if (result.length() > static_cast<size_t>(length)) {
-        result = result.substr(0, length);
-    } else {
-        result.resize(length, ' ');  // 공백으로 패딩
-    }
+    if (length <= 0) return "";
+    std::string result(length, ' ');
+    BinaryRecordView::writeXMode(&result[0], length, value.data(), value.size());
     return result;
 }
 
 // X 모드 파싱 (뒤쪽 공백 제거)
-std::string BinaryRecord::parseXMode(const char* data, int length) const {
+std::string BinaryRecordView::parseXMode(const char* data, int length) {
     std::string result(data, length);
     
     // null 문자가 있으면 그 앞까지만 사용
@@ -576,72 +773,14 @@ std::string BinaryRecord::parseXMode(const char* data, int length) const {
 
 // 9 모드 포맷팅 (소수점 포함, 앞쪽 0 패딩)
 std::string BinaryRecord::format9Mode(const std::string& value, int length, int decimal) const {
-    std::string result;
-    bool isNegative = false;
-    
-    // null 문자가 포함된 문자열을 정리 (첫 번째 null 문자까지만 사용)
-    std::string cleanValue = value;
-    size_t nullPos = cleanValue.find('\0');
-    if (nullPos != std::string::npos) {
-        cleanValue = cleanValue.substr(0, nullPos);
-    }
-    
-    std::string workValue = cleanValue;
-    
-    // 음수 처리
-    if (!workValue.empty() && workValue[0] == '-') {
-        isNegative = true;
-        workValue = workValue.substr(1);  // '-' 제거
-    }
-    
-    if (decimal > 0) {
-        // 소수점이 있는 경우
-        size_t dotPos = workValue.find('.');
-        std::string intPart, decPart;
-        
-        if (dotPos != std::string::npos) {
-            intPart = workValue.substr(0, dotPos);
-            decPart = workValue.substr(dotPos + 1);
-        } else {
-            intPart = workValue;
-            decPart = "";
-        }
-        
-        // 소수점 자리수 맞추기 (뒤쪽에 0 패딩)
-        decPart.resize(decimal, '0');
-        
-        // 정수부 + 소수점 + 소수부
-        result = intPart + "." + decPart;
-    } else {
-        // 소수점이 없는 경우 그대로 사용
-        result = workValue;
-    }
-    
-    // 전체 길이 조정 (앞쪽 0 패딩)
-    int result_length = result.length();
-    int target_length = length;
-    
-    if (isNegative) {
-        target_length = length - 1;  // '-' 기호 자리 확보
-    }
-    
-    if (result_length < target_length) {
-        result = std::string(target_length - result_length, '0') + result;
-    } else if (result_length > target_length) {
-        // 길이가 초과하면 뒤에서 잘라내기
-        result = result.substr(result_length - target_length);
-    }
-    
-    // 음수인 경우 '-' 기호 추가
-    if (isNegative) {
-        result = "-" + result;
-    }
-    
+    if (length <= 0) return "";
+    std::string result(length, '0');
+    BinaryRecordView::write9Mode(&result[0], length, decimal, value.data(), value.size());
     return result;
 }
 
 // 9 모드 파싱 (소수점 포함 데이터 그대로 반환)
-std::string BinaryRecord::parse9Mode(const char* data, int length, int decimal) const {
+std::string BinaryRecordView::parse9Mode(const char* data, int length, int decimal) {
     std::string result(data, length);
     
     // 앞쪽 0 제거 (단, 소수점 앞의 마지막 0은 유지)
@@ -793,43 +932,53 @@ void SpecFileParser::dump() const {
 }
 
 // YAML 디렉토리에서 모든 레이아웃 로드
+// 디렉토리 내용 hash 가 같은 cache ("<directory>.cache") 가 있으면 파싱하지 않고 읽는다 (SpecCache)
 bool SpecFileParser::loadFromYamlDirectory(const std::string& directory) {
-    DIR* dir = opendir(directory.c_str());
-    if (!dir) {
+    std::vector<std::string> files;
+    uint64_t hash = 0;
+    if (!SpecCache::scanDirectory(directory, ".yaml", files, hash)) {
         std::cerr << "Cannot open directory: " << directory << std::endl;
         return false;
     }
     
-    struct dirent* entry;
-    bool success = true;
+    bool use_cache = SpecCache::enabled();
+    std::string cache_path = SpecCache::cachePath(directory);
+    SpecCache::LayoutMap cached;
+    if (use_cache && SpecCache::loadLayouts(cache_path, hash, cached)) {
+        for (auto& pair : cached) {
+            _layouts[pair.first] = pair.second;
+        }
+        std::cout << "Loaded " << cached.size() << " layouts from spec cache: " << cache_path << std::endl;
+        return true;
+    }
     
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string filename = entry->d_name;
+    bool success = true;
+    SpecCache::LayoutMap loaded;
+    for (const auto& filename : files) {
+        std::string filepath = directory + "/" + filename;
         
-        // .yaml 파일만 처리
-        if (filename.length() > 5 && filename.substr(filename.length() - 5) == ".yaml") {
-            std::string filepath = directory + "/" + filename;
-            
-            std::cout << "Loading YAML file: " << filepath << std::endl;
-            if (!loadSingleYamlFile(filepath)) {
-                std::cerr << "Failed to load: " << filepath << std::endl;
-                success = false;
-            }
+        std::cout << "Loading YAML file: " << filepath << std::endl;
+        if (!loadSingleYamlFile(filepath, loaded)) {
+            std::cerr << "Failed to load: " << filepath << std::endl;
+            success = false;
         }
     }
     
-    closedir(dir);
-    
     // 모든 레이아웃의 오프셋 계산
-    for (auto& pair : _layouts) {
+    for (auto& pair : loaded) {
         pair.second->calculateLayout();
+        _layouts[pair.first] = pair.second;
     }
     
+    // 일부 파일이 실패했으면 다음에 다시 파싱하도록 cache 를 쓰지 않는다
+    if (use_cache && success && !SpecCache::saveLayouts(cache_path, hash, loaded)) {
+        std::cerr << "WARNING: cannot write spec cache: " << cache_path << std::endl;
+    }
     return success;
 }
 
 // 단일 YAML 파일 로드
-bool SpecFileParser::loadSingleYamlFile(const std::string& filepath) {
+bool SpecFileParser::loadSingleYamlFile(const std::string& filepath, std::map<std::string, std::shared_ptr<RecordLayout>>& layouts) {
     std::ifstream file(filepath);
     if (!file.is_open()) {
         std::cerr << "Cannot open YAML file: " << filepath << std::endl;
@@ -926,7 +1075,7 @@ bool SpecFileParser::loadSingleYamlFile(const std::string& filepath) {
     }
     
     if (layout && !layoutName.empty()) {
-        _layouts[layoutName] = layout;
+        layouts[layoutName] = layout;
         std::cout << "Successfully loaded layout: " << layoutName << " with " << layout->getFields().size() << " fields" << std::endl;
         return true;
     }
@@ -6,6 +6,8 @@
 #include <map>
 #include <cstring>
 #include <memory>
+#include <algorithm>
+#include <stdint.h>
 
 // 필드 타입 열거형
 enum class FieldType {
@@ -40,6 +42,23 @@ struct FieldInfo {
         : name(n), type(t), offset(0), length(len), decimal(0), isKey(false) {}
 };
 
+// 필드 핸들 (RecordLayout::handle() 로 한번 찾아두고 재사용)
+// 필드 위치/타입을 값으로 복사해 두므로 매 호출마다 이름 lookup 이 없다.
+// calculateLayout() 이후에 만들어야 하고, 레이아웃이 다시 계산되면 다시 찾아야 한다.
+struct FieldHandle {
+    int offset;             // -1 이면 없는 필드
+    int length;
+    int decimal;
+    FieldType type;
+    int index;              // 레이아웃 안 필드 순서 (DirtyFieldSet / RecordDelta 용, -1: 모름)
+    
+    FieldHandle() : offset(-1), length(0), decimal(0), type(FieldType::CHAR), index(-1) {}
+    explicit FieldHandle(const FieldInfo& f, int i = -1)
+        : offset(f.offset), length(f.length), decimal(f.decimal), type(f.type), index(i) {}
+    
+    bool valid() const { return offset >= 0; }
+};
+
 // 바이너리 레코드 스펙
 class RecordLayout {
 private:
@@ -57,6 +76,7 @@ public:
     
     // 필드 정보
     const FieldInfo* getField(const std::string& name) const;
+    FieldHandle handle(const std::string& name) const;    // 없는 필드면 valid() == false
     const std::vector<FieldInfo>& getFields() const { return _fields; }
     int getRecordSize() const { return _recordSize; }
     const std::string& getRecordType() const { return _recordType; }
@@ -69,6 +89,114 @@ private:
     void updateIndex();
 };
 
+// 레코드에서 바뀐 필드 (레이아웃 필드 index bitmap)
+// 갱신 한번 동안 BinaryRecordView::update* 가 표시하고, delta 메시지 (RecordDelta) 를 만들 때 읽는다.
+// reset() 은 할당한 word 를 재사용한다.
+class DirtyFieldSet {
+private:
+    std::vector<uint64_t> _words;
+    size_t _count;
+    
+public:
+    DirtyFieldSet() : _count(0) {}
+    explicit DirtyFieldSet(size_t fields) : _count(0) { reset(fields); }
+    
+    void reset(size_t fields) {
+        _words.assign((fields + 63) / 64, 0);
+        _count = 0;
+    }
+    void clear() {
+        std::fill(_words.begin(), _words.end(), 0);
+        _count = 0;
+    }
+    void mark(int index) {
+        if (index < 0 || static_cast<size_t>(index) >= _words.size() * 64) return;
+        uint64_t bit = 1ULL << (index & 63);
+        uint64_t& w = _words[index >> 6];
+        if (!(w & bit)) {
+            w |= bit;
+            _count++;
+        }
+    }
+    void mark(const FieldHandle& h) { mark(h.index); }
+    bool test(int index) const {
+        return index >= 0 && static_cast<size_t>(index) < _words.size() * 64 &&
+               ((_words[index >> 6] >> (index & 63)) & 1);
+    }
+    size_t count() const { return _count; }
+    bool empty() const { return _count == 0; }
+    size_t capacity() const { return _words.size() * 64; }
+    const std::vector<uint64_t>& words() const { return _words; }
+};
+
+// 레코드 버퍼 view (할당 / 소유 / 레이아웃 참조 없음, 복사해도 포인터만 복사)
+// HashMaster::get_by_primary 가 돌려준 mmap 레코드처럼 이미 있는 버퍼를 제자리에서 읽고 고칠 때 쓴다.
+// 필드 접근은 FieldHandle 로만 한다 (이름 lookup / 키 / dump 등은 BinaryRecord).
+// 다른 스레드가 같이 고치는 레코드를 읽으면 찢어진 값을 볼 수 있으므로 writer 스레드에서 쓰거나
+// Master::read_by_primary 로 복사한 스냅샷에 쓴다.
+class BinaryRecordView {
+private:
+    char* _buffer;
+    int _size;
+    
+public:
+    BinaryRecordView() : _buffer(nullptr), _size(0) {}
+    BinaryRecordView(char* buffer, int size) : _buffer(buffer), _size(buffer ? size : 0) {}
+    BinaryRecordView(const RecordLayout& layout, char* buffer)
+        : _buffer(buffer), _size(buffer ? layout.getRecordSize() : 0) {}
+    
+    void reset(char* buffer, int size) { _buffer = buffer; _size = buffer ? size : 0; }
+    char* getBuffer() const { return _buffer; }
+    int getSize() const { return _size; }
+    bool valid() const { return _buffer != nullptr; }
+    void clear() { if (_buffer) memset(_buffer, 0, _size); }
+    
+    // 쓰기 (BinaryRecord 의 핸들 기반 쓰기와 같음)
+    bool setString(const FieldHandle& h, const char* value, size_t len);
+    bool setString(const FieldHandle& h, const char* value) { return setString(h, value, value ? strlen(value) : 0); }
+    bool setString(const FieldHandle& h, const std::string& value) { return setString(h, value.data(), value.size()); }
+    bool setInt(const FieldHandle& h, int value);
+    bool setLong(const FieldHandle& h, long long value);
+    bool setDouble(const FieldHandle& h, double value);
+    bool setXMode(const FieldHandle& h, const char* value, size_t len);
+    bool set9Mode(const FieldHandle& h, const char* value, size_t len);
+    bool fill(const FieldHandle& h, char fillChar);
+    bool copyField(const FieldHandle& h, const BinaryRecordView& src, const FieldHandle& srcHandle);
+    
+    // 값이 달라질 때만 기록 (같으면 버퍼를 건드리지 않는다 - mmap page 를 dirty 로 만들지 않음)
+    // 기록했으면 true, dirty 가 있으면 그 필드를 표시
+    bool updateString(const FieldHandle& h, const char* value, size_t len, DirtyFieldSet* dirty = nullptr);
+    bool updateString(const FieldHandle& h, const std::string& value, DirtyFieldSet* dirty = nullptr) {
+        return updateString(h, value.data(), value.size(), dirty);
+    }
+    bool updateDouble(const FieldHandle& h, double value, DirtyFieldSet* dirty = nullptr);
+    
+    // 읽기
+    const char* data(const FieldHandle& h) const { return (_buffer && h.valid()) ? _buffer + h.offset : nullptr; }
+    size_t textLength(const FieldHandle& h) const;
+    std::string getString(const FieldHandle& h) const;
+    std::string getValue(const FieldHandle& h) const;
+    int getInt(const FieldHandle& h) const;
+    long long getLong(const FieldHandle& h) const;
+    double getDouble(const FieldHandle& h) const;
+    bool equals(const FieldHandle& h, const char* value, size_t len) const;
+    bool equals(const FieldHandle& h, const std::string& value) const { return equals(h, value.data(), value.size()); }
+    
+private:
+    friend class BinaryRecord;
+    
+    // dst 에 length 바이트로 포맷해서 기록 (value 는 첫 NUL 까지만 사용)
+    static void writeText(char* dst, const FieldHandle& h, const char* value, size_t len);
+    static void writeXMode(char* dst, int length, const char* value, size_t len);
+    static void write9Mode(char* dst, int length, int decimal, const char* value, size_t len);
+    static std::string parseXMode(const char* data, int length);
+    static std::string parse9Mode(const char* data, int length, int decimal);
+    // 텍스트 필드를 NUL 종료 문자열로 buf 에 복사 (숫자 변환용, getValue() 와 같은 결과). 넘치면 false
+    bool copyText(const FieldHandle& h, char* buf, size_t size) const;
+    // 포맷한 값 (h.length 바이트) 이 다르면 기록
+    bool updateBytes(const FieldHandle& h, const char* formatted, DirtyFieldSet* dirty);
+};
+
 // 바이너리 레코드 읽기/쓰기 클래스
 class BinaryRecord {
 private:
@@ -91,7 +219,7 @@ public:
     void allocateBuffer();
     void setBuffer(char* buffer, bool takeOwnership = false);
     char* getBuffer() const { return _buffer; }
-    int getSize() const;
+    int getSize() const { return _layout ? _layout->getRecordSize() : 0; }
     void clear();
     
     // 데이터 쓰기
@@ -122,6 +250,41 @@ public:
     void fromMap(const std::map<std::string, std::string>& data);
     std::map<std::string, std::string> toMap() const;
     
+    // 핸들 기반 쓰기 (문자열 lookup/임시 std::string 없이 버퍼에 바로 기록)
+    bool setString(const FieldHandle& h, const char* value, size_t len) { return view().setString(h, value, len); }
+    bool setString(const FieldHandle& h, const char* value) { return view().setString(h, value); }
+    bool setString(const FieldHandle& h, const std::string& value) { return view().setString(h, value); }
+    bool setInt(const FieldHandle& h, int value) { return view().setInt(h, value); }
+    bool setLong(const FieldHandle& h, long long value) { return view().setLong(h, value); }
+    bool setDouble(const FieldHandle& h, double value) { return view().setDouble(h, value); }
+    bool setXMode(const FieldHandle& h, const char* value, size_t len) { return view().setXMode(h, value, len); }
+    bool set9Mode(const FieldHandle& h, const char* value, size_t len) { return view().set9Mode(h, value, len); }
+    bool fill(const FieldHandle& h, char fillChar) { return view().fill(h, fillChar); }
+    
+    // 다른 레코드의 텍스트 필드(char/X/9) 값을 그대로 옮긴다. setString(h, src.getString(srcHandle)) 과 같음
+    bool copyField(const FieldHandle& h, const BinaryRecord& src, const FieldHandle& srcHandle) {
+        return view().copyField(h, src.view(), srcHandle);
+    }
+    bool copyField(const FieldHandle& h, const BinaryRecordView& src, const FieldHandle& srcHandle) {
+        return view().copyField(h, src, srcHandle);
+    }
+    
+    // 핸들 기반 읽기
+    const char* data(const FieldHandle& h) const { return (_buffer && h.valid()) ? _buffer + h.offset : nullptr; }
+    size_t textLength(const FieldHandle& h) const { return view().textLength(h); }   // char 필드: NUL 전까지 길이, 그 외: 필드 길이
+    std::string getString(const FieldHandle& h) const { return view().getString(h); }
+    std::string getValue(const FieldHandle& h) const { return view().getValue(h); }
+    int getInt(const FieldHandle& h) const { return view().getInt(h); }
+    long long getLong(const FieldHandle& h) const { return view().getLong(h); }
+    double getDouble(const FieldHandle& h) const { return view().getDouble(h); }
+    
+    // value 를 쓰면 필드 내용이 그대로인지 (변경 감지용)
+    bool equals(const FieldHandle& h, const char* value, size_t len) const { return view().equals(h, value, len); }
+    bool equals(const FieldHandle& h, const std::string& value) const { return equals(h, value.data(), value.size()); }
+    
+    // 같은 버퍼의 view (layout 참조 카운트 없이 핸들 기반 접근)
+    BinaryRecordView view() const { return BinaryRecordView(_buffer, getSize()); }
+    
     // 키 필드 처리
     std::string getPrimaryKey() const;
     std::vector<std::string> getKeyValues() const;
@@ -136,14 +299,15 @@ public:
     
 private:
     const FieldInfo* getFieldInfo(const std::string& name) const;
+    FieldHandle getHandle(const std::string& name) const {
+        return _layout ? _layout->handle(name) : FieldHandle();
+    }
     bool writeField(const FieldInfo* field, const std::string& value);
     std::string readField(const FieldInfo* field) const;
     
     // X/9 모드 처리
     std::string formatXMode(const std::string& value, int length) const;
-    std::string parseXMode(const char* data, int length) const;
     std::string format9Mode(const std::string& value, int length, int decimal) const;
-    std::string parse9Mode(const char* data, int length, int decimal) const;
 };
 
 // 스펙 파일 파서
@@ -156,7 +320,7 @@ public:
     bool loadFromFile(const std::string& filename);
     bool loadFromString(const std::string& content);
     
-    // YAML 파일에서 스펙 로드
+    // YAML 파일에서 스펙 로드 (내용이 같으면 "<directory>.cache" 에서 바로 읽음, SpecCache.h)
     bool loadFromYamlDirectory(const std::string& directory);
     
     // 레이아웃 접근
@@ -172,7 +336,7 @@ private:
     FieldType parseType(const std::string& typeStr);
     
     // YAML 파싱 헬퍼 함수들
-    bool loadSingleYamlFile(const std::string& filepath);
+    bool loadSingleYamlFile(const std::string& filepath, std::map<std::string, std::shared_ptr<RecordLayout>>& layouts);
     std::string parseYamlValue(const std::string& line);
     bool parseBool(const std::string& value);
 };
@@ -0,0 +1,58 @@
+#ifndef BULK_LOAD_H
+#define BULK_LOAD_H
+
+#include <thread>
+#include <vector>
+
+/**
+ * bulk_load (HashTable / HashMaster / MemoryMaster) 공용 병렬 처리 helper
+ *
+ * 시작 시 마스터 전체를 한번에 적재할 때 key hash 계산, record 복사 같이 서로 독립인 작업을
+ * 구간으로 나눠 돌린다. 작은 입력은 스레드 생성 비용이 더 크므로 호출 스레드에서 바로 처리한다.
+ */
+#define BULK_PARALLEL_MIN 65536     // 이보다 적으면 단일 스레드
+#define BULK_MAX_THREADS 8
+
+// threads <= 0 (자동) 일 때 쓸 스레드 수
+inline int bulk_load_threads(int count) {
+    if (count < BULK_PARALLEL_MIN) return 1;
+    int hw = (int)std::thread::hardware_concurrency();
+    if (hw <= 0) return 1;
+    return hw < BULK_MAX_THREADS ? hw : BULK_MAX_THREADS;
+}
+
+// [0, count) 를 threads 개 구간으로 나눠 fn(begin, end) 를 실행 (첫 구간은 호출 스레드)
+template <typename Fn>
+inline void bulk_parallel_for(int count, int threads, Fn fn) {
+    if (threads <= 0) threads = bulk_load_threads(count);
+    if (threads <= 1 || count < BULK_PARALLEL_MIN) {
+        fn(0, count);
+        return;
+    }
+
+    int chunk = (count + threads - 1) / threads;
+    std::vector<std::thread> workers;
+    for (int begin = chunk; begin < count; begin += chunk) {
+        int end = begin + chunk < count ? begin + chunk : count;
+        workers.emplace_back(fn, begin, end);
+    }
+    fn(0, chunk < count ? chunk : count);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+// 이미 나눠둔 tasks 개 구간을 각자 스레드에서 fn(task) 로 실행 (0 번은 호출 스레드)
+template <typename Fn>
+inline void bulk_parallel_tasks(int tasks, Fn fn) {
+    std::vector<std::thread> workers;
+    for (int task = 1; task < tasks; task++) {
+        workers.emplace_back(fn, task);
+    }
+    if (tasks > 0) fn(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif // BULK_LOAD_H
@@ -0,0 +1,253 @@
+#include "CapacityAdvisor.h"
+#include "HashMaster.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+int round_up(long long value, int step) {
+    if (step <= 1) return static_cast<int>(value);
+    return static_cast<int>((value + step - 1) / step * step);
+}
+
+std::string percent(double ratio) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.1f%%", ratio * 100);
+    return buf;
+}
+
+// "key: value  # comment" 의 value 만 바꾼다 (들여쓰기 / 주석 위치 유지)
+bool replace_value(std::string& line, const char* key, int value) {
+    size_t start = line.find_first_not_of(" \t");
+    size_t key_len = strlen(key);
+    if (start == std::string::npos || line.compare(start, key_len, key) != 0) return false;
+    size_t colon = start + key_len;
+    if (colon >= line.size() || line[colon] != ':') return false;
+    size_t comment = line.find('#', colon);
+    std::string text = line.substr(0, colon + 1) + " " + std::to_string(value);
+    if (comment != std::string::npos) {
+        size_t value_end = line.find_last_not_of(" \t", comment - 1);
+        size_t pad = comment - (value_end == std::string::npos ? comment : value_end + 1);
+        // 원래 주석 열을 맞출 수 있으면 맞추고, 값이 길어졌으면 한 칸
+        size_t width = text.size() < comment ? comment - text.size() : std::max<size_t>(pad, 1);
+        text += std::string(width, ' ') + line.substr(comment);
+    }
+    line = text;
+    return true;
+}
+
+} // namespace
+
+std::string CapacityAdvice::to_string() const {
+    std::ostringstream os;
+    os << name << ": records " << used_records << "/" << total_records << " (" << percent(record_utilization) << ")";
+    if (index_utilization > 0) {
+        os << ", index " << percent(index_utilization) << ", chain max " << max_chain_length
+           << " avg " << std::fixed << std::setprecision(2) << avg_chain_length;
+    }
+    os << " -> max_record_count " << recommended_record_count << ", hash_count " << recommended_hash_count
+       << ", max_record_size " << recommended_record_size;
+    if (!changed()) {
+        os << " (현재 설정 유지)";
+    }
+    for (const auto& reason : reasons) {
+        os << "\n  - " << reason;
+    }
+    return os.str();
+}
+
+CapacityAdvisor::CapacityAdvisor(const std::string& name, const CapacityPolicy& policy)
+    : _name(name), _policy(policy), _record_size(0) {
+    _used_records = make_gauge("used_records");
+    _total_records = make_gauge("total_records");
+    _record_util = make_gauge("record_util_x100");
+    _index_util = make_gauge("index_util_x100");
+    _max_chain = make_gauge("max_chain");
+    _avg_chain = make_gauge("avg_chain_x100");
+    _recommended_records = make_gauge("recommended_record_count");
+    _recommended_hash_count = make_gauge("recommended_hash_count");
+    _recommended_record_size = make_gauge("recommended_record_size");
+    _alerts = make_gauge("alerts");
+}
+
+std::unique_ptr<SimplePubSub::StatsCounter> CapacityAdvisor::make_gauge(const char* field) const {
+    std::string name = "capacity." + _name + "." + field;
+    return std::unique_ptr<SimplePubSub::StatsCounter>(new SimplePubSub::StatsCounter(name.c_str()));
+}
+
+int CapacityAdvisor::next_prime(int n) {
+    if (n <= 2) return 2;
+    for (int candidate = n | 1; ; candidate += 2) {
+        bool prime = true;
+        for (int d = 3; (long long)d * d <= candidate; d += 2) {
+            if (candidate % d == 0) {
+                prime = false;
+                break;
+            }
+        }
+        if (prime) return candidate;
+    }
+}
+
+CapacityAdvice CapacityAdvisor::sample(Master* master) {
+    CapacityAdvice a;
+    a.name = _name;
+    if (!master) {
+        return a;
+    }
+    const MasterConfig& config = master->get_config();
+    a.max_record_count = config._max_record_count;
+    a.max_record_size = config._max_record_size;
+    a.hash_count = config._hash_count;
+    a.record_size = _record_size;
+
+    HashMaster* hash_master = dynamic_cast<HashMaster*>(master);
+    int index_version = config._index_version;
+    if (hash_master) {
+        HashMaster::HashMasterStats stats = hash_master->get_hash_master_statistics();
+        a.used_records = stats.used_records;
+        a.total_records = stats.total_records;
+        const HashTableStats& primary = stats.primary_stats;
+        const HashTableStats& secondary = stats.secondary_stats;
+        if (primary.total_slots > 0) {
+            a.index_utilization = static_cast<double>(primary.used_slots) / primary.total_slots;
+            index_version = primary.index_version;
+        }
+        a.max_chain_length = std::max(primary.max_chain_length, secondary.max_chain_length);
+        a.avg_chain_length = std::max(primary.avg_chain_length, secondary.avg_chain_length);
+    } else {
+        MasterStats stats = master->get_statistics();
+        a.used_records = stats.used_records;
+        a.total_records = stats.total_records;
+    }
+    if (a.total_records > 0) {
+        a.record_utilization = static_cast<double>(a.used_records) / a.total_records;
+    }
+    int capacity = std::max(a.total_records, a.max_record_count);
+
+    // 레코드 수 / free list
+    int step = std::max(_policy.record_count_step, 1);
+    int needed = std::max(round_up(static_cast<long long>(std::ceil(a.used_records / _policy.target_ratio)), step), step);
+    a.recommended_record_count = capacity;
+    if (a.record_utilization >= _policy.full_ratio || a.index_utilization >= _policy.full_ratio) {
+        a.near_full = true;
+        a.recommended_record_count = std::max(needed, capacity);
+        a.reasons.push_back("near full: records " + percent(a.record_utilization) + ", index " +
+                            percent(a.index_utilization) + " (>= " + percent(_policy.full_ratio) + ")");
+    } else if (a.record_utilization < _policy.shrink_ratio && needed < capacity / 2) {
+        a.recommended_record_count = needed;
+        a.reasons.push_back("oversized: records " + percent(a.record_utilization) + " used, max_record_count " +
+                            std::to_string(capacity) + " -> " + std::to_string(needed));
+    }
+    if (a.total_records > a.max_record_count) {
+        a.reasons.push_back("auto_grow/resize 로 용량이 " + std::to_string(a.total_records) + " 까지 늘어남 (yaml 반영 필요)");
+    }
+
+    // chain / probe 길이
+    if (index_version == HASH_INDEX_V2_OPEN_ADDRESSING) {
+        a.long_chains = a.max_chain_length > _policy.max_probe_groups;
+    } else {
+        a.long_chains = a.max_chain_length > _policy.max_chain || a.avg_chain_length > _policy.max_avg_chain;
+    }
+    int buckets = a.recommended_record_count;
+    if (a.long_chains) {
+        buckets = std::max(a.hash_count * 2, buckets);
+        a.reasons.push_back("long chains: max " + std::to_string(a.max_chain_length) + " (v" +
+                            std::to_string(index_version) + "), hash_count " + std::to_string(a.hash_count) + " -> x2");
+    }
+    if (a.long_chains || a.recommended_record_count != a.max_record_count) {
+        // repo 설정 관례: bucket 수는 레코드 수 이상의 소수
+        a.recommended_hash_count = next_prime(buckets);
+    } else {
+        a.recommended_hash_count = a.hash_count;
+    }
+
+    // 레코드 slot 크기 (레이아웃 레코드 크기를 cache line 배수로)
+    a.recommended_record_size = a.max_record_size;
+    if (a.record_size > 0) {
+        int aligned = round_up(a.record_size, std::max(_policy.record_align, 1));
+        if (a.record_size > a.max_record_size) {
+            a.recommended_record_size = aligned;
+            a.reasons.push_back("record " + std::to_string(a.record_size) + " bytes > max_record_size " +
+                                std::to_string(a.max_record_size) + " (put 실패)");
+        } else if (aligned < a.max_record_size) {
+            a.recommended_record_size = aligned;
+            long long saved = (long long)(a.max_record_size - aligned) * a.recommended_record_count;
+            a.reasons.push_back("slot " + std::to_string(a.max_record_size) + " -> " + std::to_string(aligned) +
+                                " bytes (layout " + std::to_string(a.record_size) + ", mmap " +
+                                std::to_string(saved / (1024 * 1024)) + " MB 감소)");
+        }
+    }
+
+    publish(a);
+    return a;
+}
+
+void CapacityAdvisor::publish(const CapacityAdvice& a) {
+    _used_records->set(static_cast<uint64_t>(a.used_records));
+    _total_records->set(static_cast<uint64_t>(a.total_records));
+    _record_util->set(static_cast<uint64_t>(a.record_utilization * 10000));
+    _index_util->set(static_cast<uint64_t>(a.index_utilization * 10000));
+    _max_chain->set(static_cast<uint64_t>(a.max_chain_length));
+    _avg_chain->set(static_cast<uint64_t>(a.avg_chain_length * 100));
+    _recommended_records->set(static_cast<uint64_t>(a.recommended_record_count));
+    _recommended_hash_count->set(static_cast<uint64_t>(a.recommended_hash_count));
+    _recommended_record_size->set(static_cast<uint64_t>(a.recommended_record_size));
+    if (a.near_full || a.long_chains) {
+        _alerts->inc();
+    }
+}
+
+bool CapacityAdvisor::write_recommended(const std::string& config_file, const std::string& out_path,
+                                        const CapacityAdvice& advice) {
+    std::ifstream in(config_file);
+    if (!in.is_open()) {
+        fprintf(stderr, "CapacityAdvisor: cannot read %s\n", config_file.c_str());
+        return false;
+    }
+    std::ostringstream out;
+    out << "# capacity advisor 권장값 (" << config_file << " 기준, 사용 " << advice.used_records << "/"
+        << advice.total_records << ")\n";
+    for (const auto& reason : advice.reasons) {
+        out << "#   " << reason << "\n";
+    }
+    std::string line;
+    while (std::getline(in, line)) {
+        replace_value(line, "max_record_count", advice.recommended_record_count) ||
+            replace_value(line, "max_record_size", advice.recommended_record_size) ||
+            replace_value(line, "hash_count", advice.recommended_hash_count);
+        out << line << "\n";
+    }
+
+    // 임시 파일에 쓰고 rename (보는 쪽은 이전 권장이나 새 권장만 본다)
+    std::string data = out.str();
+    std::string tmp = out_path + ".tmp." + std::to_string(getpid());
+    FILE* fp = fopen(tmp.c_str(), "wb");
+    if (!fp) {
+        fprintf(stderr, "CapacityAdvisor: cannot write %s\n", tmp.c_str());
+        return false;
+    }
+    bool ok = fwrite(data.data(), 1, data.size(), fp) == data.size();
+    ok = (fclose(fp) == 0) && ok;
+    if (ok && rename(tmp.c_str(), out_path.c_str()) == 0) return true;
+    unlink(tmp.c_str());
+    fprintf(stderr, "CapacityAdvisor: failed to write %s\n", out_path.c_str());
+    return false;
+}
+
+bool CapacityAdvisor::apply_resize(Master* master, const CapacityAdvice& advice) {
+    HashMaster* hash_master = dynamic_cast<HashMaster*>(master);
+    if (!hash_master || !advice.near_full || hash_master->is_resizing()) {
+        return false;
+    }
+    if (advice.recommended_record_count <= hash_master->get_record_capacity()) {
+        return false;
+    }
+    return hash_master->resize(advice.recommended_record_count) == HASH_OK;
+}
@@ -0,0 +1,113 @@
+#ifndef CAPACITY_ADVISOR_H
+#define CAPACITY_ADVISOR_H
+
+#include "Master.h"
+#include "../common/StatsRegistry.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+// 용량 판단 기준 (비율은 0~1)
+struct CapacityPolicy {
+    double full_ratio = 0.9;        // 레코드 / index slot 사용률이 이 이상이면 near full
+    double target_ratio = 0.7;      // 권장 max_record_count 는 사용 레코드가 이 비율이 되도록
+    double shrink_ratio = 0.2;      // 사용률이 이 아래면 max_record_count 축소 권장
+    int max_chain = 8;              // v1 (chaining): bucket chain 최대 길이
+    double max_avg_chain = 2.0;     // v1: 평균 chain 길이
+    int max_probe_groups = 3;       // v2 (open addressing): entry 의 최대 probe group 수
+    int record_align = 64;          // 권장 max_record_size 를 이 배수로 (cache line)
+    int record_count_step = 1000;   // 권장 max_record_count 를 이 배수로
+};
+
+// 한 번 sample 한 결과와 권장 설정
+struct CapacityAdvice {
+    std::string name;
+    // 현재 (total_records 는 auto_grow / resize 로 늘어난 용량 포함)
+    int used_records = 0;
+    int total_records = 0;
+    int max_record_count = 0;
+    int max_record_size = 0;
+    int hash_count = 0;
+    int record_size = 0;            // 레이아웃 레코드 크기 (0: 모름)
+    double record_utilization = 0;
+    double index_utilization = 0;   // primary index slot 사용률 (HashMaster 만)
+    int max_chain_length = 0;       // primary / secondary 중 큰 값
+    double avg_chain_length = 0;
+    // 권장
+    int recommended_record_count = 0;
+    int recommended_hash_count = 0;
+    int recommended_record_size = 0;
+    bool near_full = false;         // 레코드나 index 가 full_ratio 이상 (resize 대상)
+    bool long_chains = false;
+    std::vector<std::string> reasons;
+
+    bool changed() const {
+        return recommended_record_count != max_record_count || recommended_hash_count != hash_count ||
+               recommended_record_size != max_record_size;
+    }
+    std::string to_string() const;
+};
+
+/**
+ * @brief 마스터 / 해시 테이블 용량 advisor
+ *
+ * config/MASTERs 의 마스터 yaml (hash_count / max_record_count / max_record_size) 은 손으로 잡은 값이라
+ * 종목 수가 늘면 chain 이 길어지거나 free list 가 바닥나고, 반대로 레코드 slot 이 실제 레이아웃보다
+ * 훨씬 크면 mmap 크기와 cache 사용만 늘어난다. advisor 는 주기적으로 (T2MA scheduler)
+ *  - Master::get_statistics / HashMaster::get_hash_master_statistics 를 읽어 "capacity.<name>.*" gauge 로
+ *    StatsRegistry 에 올리고 (stats snapshot 으로 계속 보임)
+ *  - 사용률이 full_ratio 이상이거나 chain / probe 길이가 기준을 넘으면 경고하고
+ *  - 사용 레코드 수와 레이아웃 레코드 크기 (BinaryRecord RecordLayout::getRecordSize) 로 권장값을 계산해
+ *    원래 yaml 을 권장값으로 바꾼 사본을 쓰거나 (write_recommended, 설정 반영은 재시작 시)
+ *  - HashMaster 면 online resize (HashMaster::resize) 로 레코드 / index 를 미리 늘린다 (apply_resize).
+ * max_record_size / hash_count 는 기존 파일 크기를 바꾸므로 online 으로는 바꾸지 않는다.
+ * HashMaster 통계는 index 전체를 훑으므로 (읽기 lock) 수십 초 이상 주기로 호출한다.
+ * 마스터를 교체하는 스레드 (T2MA event loop) 에서 호출한다 (Master* 는 매번 새로 받는다).
+ */
+class CapacityAdvisor {
+public:
+    CapacityAdvisor(const std::string& name, const CapacityPolicy& policy = CapacityPolicy());
+
+    CapacityAdvisor(const CapacityAdvisor&) = delete;
+    CapacityAdvisor& operator=(const CapacityAdvisor&) = delete;
+
+    // 레이아웃 레코드 크기 (put 하는 record_size, 0: 모름 -> max_record_size 는 그대로 권장)
+    void set_record_size(int bytes) { _record_size = bytes; }
+    void set_policy(const CapacityPolicy& policy) { _policy = policy; }
+    const std::string& name() const { return _name; }
+
+    // 통계를 읽어 gauge 갱신 후 권장값 계산
+    CapacityAdvice sample(Master* master);
+
+    // config_file 의 세 값만 권장값으로 바꿔 out_path 에 쓴다 (주석 / 다른 키는 그대로, tmp + rename)
+    static bool write_recommended(const std::string& config_file, const std::string& out_path,
+                                  const CapacityAdvice& advice);
+
+    // near_full 이고 HashMaster 면 recommended_record_count 까지 online resize (이미 resize 중이면 false)
+    // HashMaster::resize 는 single writer 라 writer 와 같은 스레드이거나 use_lock 일 때만 호출한다.
+    static bool apply_resize(Master* master, const CapacityAdvice& advice);
+
+    static int next_prime(int n);
+
+private:
+    std::string _name;
+    CapacityPolicy _policy;
+    int _record_size;
+
+    // capacity.<name>.* gauge (비율은 % x 100, 평균 chain 은 x 100)
+    std::unique_ptr<SimplePubSub::StatsCounter> _used_records;
+    std::unique_ptr<SimplePubSub::StatsCounter> _total_records;
+    std::unique_ptr<SimplePubSub::StatsCounter> _record_util;
+    std::unique_ptr<SimplePubSub::StatsCounter> _index_util;
+    std::unique_ptr<SimplePubSub::StatsCounter> _max_chain;
+    std::unique_ptr<SimplePubSub::StatsCounter> _avg_chain;
+    std::unique_ptr<SimplePubSub::StatsCounter> _recommended_records;
+    std::unique_ptr<SimplePubSub::StatsCounter> _recommended_hash_count;
+    std::unique_ptr<SimplePubSub::StatsCounter> _recommended_record_size;
+    std::unique_ptr<SimplePubSub::StatsCounter> _alerts;           // near full / long chain 이 보인 sample 수
+
+    std::unique_ptr<SimplePubSub::StatsCounter> make_gauge(const char* field) const;
+    void publish(const CapacityAdvice& advice);
+};
+
+#endif // CAPACITY_ADVISOR_H
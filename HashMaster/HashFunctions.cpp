@@ -0,0 +1,169 @@
+#include "HashFunctions.h"
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <nmmintrin.h>
+#define HASH_HAVE_X86_CRC32 1
+#endif
+
+uint32_t hash_djb2(const char* key, int len) {
+    uint32_t hash = 5381;
+    for (int i = 0; i < len; i++) {
+        hash = ((hash << 5) + hash) + (unsigned char)key[i];
+    }
+    return hash;
+}
+
+// ===== wymix =====
+
+static inline uint64_t wymix(uint64_t a, uint64_t b) {
+    __uint128_t r = (__uint128_t)a * b;
+    return (uint64_t)r ^ (uint64_t)(r >> 64);
+}
+
+static inline uint64_t read64(const char* p) {
+    uint64_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static inline uint64_t read32(const char* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// 0~8 byte 꼬리: 4 byte 이상이면 앞/뒤 4 byte 를 겹쳐 읽고 (분기 없이 loop 제거),
+// 그보다 짧으면 처음/중간/끝 byte 로 조립한다 (wyhash 방식)
+static inline uint64_t read_tail(const char* p, int n) {
+    if (n >= 4) {
+        return (read32(p) << 32) | read32(p + n - 4);
+    }
+    if (n > 0) {
+        return ((uint64_t)(unsigned char)p[0] << 16) |
+               ((uint64_t)(unsigned char)p[n >> 1] << 8) |
+               (uint64_t)(unsigned char)p[n - 1];
+    }
+    return 0;
+}
+
+uint32_t hash_wymix(const char* key, int len) {
+    static const uint64_t s0 = 0xa0761d6478bd642full;
+    static const uint64_t s1 = 0xe7037ed1a0b428dbull;
+    static const uint64_t s2 = 0x8ebc6af09c88c6e3ull;
+
+    uint64_t seed = s0 ^ (uint64_t)len;
+    const char* p = key;
+    int n = len;
+    while (n > 8) {
+        seed = wymix(read64(p) ^ s1, seed ^ s2);
+        p += 8;
+        n -= 8;
+    }
+    uint64_t h = wymix(read_tail(p, n) ^ s1 ^ (uint64_t)len, seed ^ s2);
+    return (uint32_t)(h ^ (h >> 32));
+}
+
+// ===== CRC32-C (Castagnoli) =====
+
+struct Crc32cTable {
+    uint32_t v[256];
+    Crc32cTable() {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? (c >> 1) ^ 0x82F63B78u : (c >> 1);
+            }
+            v[i] = c;
+        }
+    }
+};
+
+static const uint32_t* crc32c_table() {
+    static const Crc32cTable table;
+    return table.v;
+}
+
+static uint32_t crc32c_software(const char* key, int len) {
+    const uint32_t* table = crc32c_table();
+    uint32_t crc = 0xFFFFFFFFu;
+    for (int i = 0; i < len; i++) {
+        crc = table[(crc ^ (unsigned char)key[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return ~crc;
+}
+
+#ifdef HASH_HAVE_X86_CRC32
+__attribute__((target("sse4.2")))
+static uint32_t crc32c_hardware(const char* key, int len) {
+    uint64_t crc = 0xFFFFFFFFu;
+    const char* p = key;
+    int n = len;
+#ifdef __x86_64__
+    while (n >= 8) {
+        crc = _mm_crc32_u64(crc, read64(p));
+        p += 8;
+        n -= 8;
+    }
+#endif
+    uint32_t crc32 = (uint32_t)crc;
+    if (n >= 4) {
+        uint32_t v;
+        memcpy(&v, p, sizeof(v));
+        crc32 = _mm_crc32_u32(crc32, v);
+        p += 4;
+        n -= 4;
+    }
+    while (n > 0) {
+        crc32 = _mm_crc32_u8(crc32, (unsigned char)*p++);
+        n--;
+    }
+    return ~crc32;
+}
+#endif
+
+bool crc32c_hardware_supported() {
+#ifdef HASH_HAVE_X86_CRC32
+    static const bool supported = __builtin_cpu_supports("sse4.2");
+    return supported;
+#else
+    return false;
+#endif
+}
+
+uint32_t hash_crc32c(const char* key, int len) {
+#ifdef HASH_HAVE_X86_CRC32
+    if (crc32c_hardware_supported()) {
+        return crc32c_hardware(key, len);
+    }
+#endif
+    return crc32c_software(key, len);
+}
+
+// ===== id <-> function / name =====
+
+HashFunction get_builtin_hash_function(int id) {
+    switch (id) {
+        case HASH_FUNC_DJB2:   return hash_djb2;
+        case HASH_FUNC_WYMIX:  return hash_wymix;
+        case HASH_FUNC_CRC32C: return hash_crc32c;
+        default:               return nullptr;
+    }
+}
+
+const char* hash_function_name(int id) {
+    switch (id) {
+        case HASH_FUNC_DJB2:   return "djb2";
+        case HASH_FUNC_WYMIX:  return "wymix";
+        case HASH_FUNC_CRC32C: return "crc32c";
+        case HASH_FUNC_CUSTOM: return "custom";
+        default:               return "unknown";
+    }
+}
+
+int hash_function_id_from_name(const char* name) {
+    if (!name) return -1;
+    if (strcmp(name, "djb2") == 0)   return HASH_FUNC_DJB2;
+    if (strcmp(name, "wymix") == 0)  return HASH_FUNC_WYMIX;
+    if (strcmp(name, "crc32c") == 0) return HASH_FUNC_CRC32C;
+    return -1;
+}
@@ -0,0 +1,41 @@
+#ifndef HASH_FUNCTIONS_H
+#define HASH_FUNCTIONS_H
+
+#include <stdint.h>
+
+// Hash function type
+typedef uint32_t (*HashFunction)(const char* key, int len);
+
+// Built-in hash function ids (HashIndexTable::_hash_func_id 에 기록)
+// 기존 파일은 이 자리가 0 이므로 djb2 로 해석된다.
+enum HashFunctionId {
+    HASH_FUNC_DJB2 = 0,         // byte-at-a-time djb2 (기존 기본값)
+    HASH_FUNC_WYMIX = 1,        // wyhash 계열 64-bit multiply-mix, 8 byte 단위
+    HASH_FUNC_CRC32C = 2,       // CRC32-C (SSE4.2 crc32 명령, 미지원 CPU는 table 방식 - 결과 동일)
+    HASH_FUNC_CUSTOM = 255      // setHashFunction() 으로 지정한 사용자 함수
+};
+
+// Built-in hash functions: key[0..len) 전체를 해싱한 32-bit 값을 반환 (modulo 없음)
+uint32_t hash_djb2(const char* key, int len);
+uint32_t hash_wymix(const char* key, int len);
+uint32_t hash_crc32c(const char* key, int len);
+
+// id <-> function / name
+HashFunction get_builtin_hash_function(int id);         // 알 수 없는 id 이면 nullptr
+const char* hash_function_name(int id);
+int hash_function_id_from_name(const char* name);       // "djb2", "wymix", "crc32c", 알 수 없으면 -1
+
+// murmur3 fmix32: 하위/상위 bit를 고르게 섞는다 (v2 index: group 선택 = 하위 bit, tag = 상위 7bit)
+static inline uint32_t hash_mix32(uint32_t h) {
+    h ^= h >> 16;
+    h *= 0x85ebca6b;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35;
+    h ^= h >> 16;
+    return h;
+}
+
+// 현재 CPU에서 CRC32-C 를 하드웨어로 계산하는지
+bool crc32c_hardware_supported();
+
+#endif // HASH_FUNCTIONS_H
@@ -1,4 +1,7 @@
 #include "HashMaster.h"
+#include "BulkLoad.h"
+#include "../common/AsyncLog.h"
+#include "../common/Tracepoints.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <fcntl.h>
@@ -8,15 +11,29 @@
 #include <errno.h>
 #include <stdarg.h>
 #include <string.h>
+#include <sched.h>
+#include <limits.h>
 #include <fstream>
 #include <iostream>
+#include <vector>
 #include "common/YAMLParser.h"
 
 // Constructor
 HashMaster::HashMaster(const HashMasterConfig& config)
     : Master(config), _records_fd(-1), 
-      _records_addr(MAP_FAILED), _storage_size(0), _record_entry_addr(nullptr),
-      _htmaster_header(nullptr),  _total_records(0), _free_records(0) {
+      _records_addr(MAP_FAILED), _storage_size(0), _records_map_size(0), _record_entry_addr(nullptr),
+      _htmaster_header(nullptr), _live_fd(-1), _live_addr(MAP_FAILED), _live_map_size(0),
+      _live_words(nullptr), _live_rebuild(false), _segment_count(0), _migration_stop(false), _migration_running(false),
+      _total_records(0), _free_records(0) {
+    
+    for (int i = 0; i < MAX_RECORD_SEGMENTS; i++) {
+        _segments[i].fd = -1;
+        _segments[i].addr = nullptr;
+        _segments[i].size = 0;
+        _segments[i].live_fd = -1;
+        _segments[i].live = nullptr;
+        _segments[i].live_size = 0;
+    }
     
     if (!_config.validate()) {
         log(LOG_ERROR, "Invalid HashMaster configuration");
@@ -38,6 +55,9 @@ HashMaster::HashMaster(const HashMasterConfig& config)
 HashMaster::~HashMaster() {
     log(LOG_INFO, "HashMaster destructor called");
     
+    // migration 스레드가 hash table을 쓰고 있으므로 먼저 멈춘다
+    stop_migration_thread();
+    
     // Clean up hash tables
     _primary_hash_table.reset();
     _secondary_hash_table.reset();
@@ -65,6 +85,35 @@ int HashMaster::init() {
         }
     }
     
+    int ret = open_storage();
+    if (ret != HASH_OK) {
+        return ret;
+    }
+    
+    // Initialize record management
+    // 마스터는 공유되므로 지우는 것은 명시적으로 하는 것으로
+    // clear();
+    
+    _initialized = true;
+    
+    // 이전 실행에서 끝나지 못한 인덱스 migration 이어서 진행
+    if (is_resizing()) {
+        log(LOG_INFO, "Index migration in progress, resuming");
+        start_migration_thread();
+    }
+    
+    log(LOG_INFO, "HashMaster initialized successfully");
+    return HASH_OK;
+}
+
+// hash table 과 레코드 파일을 연다 (init, bulk_load 파일 교체 후)
+int HashMaster::open_storage() {
+    int hash_func_id = hash_function_id_from_name(_config._hash_function.c_str());
+    if (hash_func_id < 0) {
+        log(LOG_ERROR, "Unknown hash function: %s", _config._hash_function.c_str());
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
     // Create hash tables
     _primary_hash_table = std::unique_ptr<HashTable>(new HashTable(
         _config._hash_count, _config._primary_field_len, _config._max_record_count,
@@ -82,6 +131,10 @@ int HashMaster::init() {
     
     // Set log levels
     _primary_hash_table->setLogLevel(_config._log_level);
+    _primary_hash_table->setLockFreeRead(_config._lock_free_read);
+    _primary_hash_table->setIndexVersion(_config._index_version);
+    _primary_hash_table->setMmapOptions(_config._mmap);
+    _primary_hash_table->setHashFunctionId(hash_func_id);
     
     // Initialize hash tables
     int ret = _primary_hash_table->init();
@@ -92,6 +145,10 @@ int HashMaster::init() {
 
     if(_secondary_hash_table != nullptr) {
         _secondary_hash_table->setLogLevel(_config._log_level);
+        _secondary_hash_table->setLockFreeRead(_config._lock_free_read);
+        _secondary_hash_table->setIndexVersion(_config._index_version);
+        _secondary_hash_table->setMmapOptions(_config._mmap);
+        _secondary_hash_table->setHashFunctionId(hash_func_id);
         
         ret = _secondary_hash_table->init();
         if (ret != HASH_OK) {
@@ -107,13 +164,6 @@ int HashMaster::init() {
         log(LOG_ERROR, "Failed to allocate record storage: %d", ret);
         return ret;
     }
-    
-    // Initialize record management
-    // 마스터는 공유되므로 지우는 것은 명시적으로 하는 것으로
-    // clear();
-    
-    _initialized = true;
-    log(LOG_INFO, "HashMaster initialized successfully");
     return HASH_OK;
 }
 
@@ -141,14 +191,20 @@ int HashMaster::clear() {
     _htmaster_header->_secondary_field_len = _config._secondary_field_len;
     _htmaster_header->_use_lock = _config._use_lock;
 
+    // 늘어난 segment 는 그대로 두고 전체를 하나의 free list로 다시 묶는다
+    int capacity = record_capacity();
     _total_records = 0;
-    _free_records = _config._max_record_count;
+    _free_records = capacity;
     
-    for (int i = 0; i < _config._max_record_count; i++) {
+    for (int i = 0; i < capacity; i++) {
         DataRecordEntry *record_entry = get_record_entry(i);
         record_entry->_occupied = false;
         // Set up free list
-        record_entry->_nextEmpty = (i == _config._max_record_count - 1) ? -1 : i + 1;
+        record_entry->_nextEmpty = (i == capacity - 1) ? -1 : i + 1;
+    }
+    memset(_live_words, 0, _live_map_size - sizeof(HashMasterLiveHeader));
+    for (int k = 0; k < _segment_count.load(); k++) {
+        memset(_segments[k].live, 0, _segments[k].live_size);
     }
     
     if (_config._use_lock) {
@@ -172,22 +228,37 @@ int HashMaster::allocate_record_storage() {
     }
     
     // Set file size
-    if (ftruncate(_records_fd, _storage_size) == -1) {
+    _records_map_size = mmap_map_size(_records_fd, _storage_size);
+    if (ftruncate(_records_fd, _records_map_size) == -1) {
         log(LOG_ERROR, "Failed to set records file size: %s", strerror(errno));
         return HASH_ERROR_FILE_ERROR;
     }
     
     // Map header + records file
-    _records_addr = mmap(NULL, _storage_size, PROT_READ | PROT_WRITE, MAP_SHARED, _records_fd, 0);
+    _records_addr = mmap(NULL, _records_map_size, PROT_READ | PROT_WRITE, mmap_flags(_config._mmap), _records_fd, 0);
     if (_records_addr == MAP_FAILED) {
         log(LOG_ERROR, "Failed to map records file: %s", strerror(errno));
         return HASH_ERROR_MEMORY_ERROR;
     }
+    const char* failed = mmap_apply_options(_records_addr, _records_map_size, _config._mmap);
+    if (failed) {
+        log(LOG_WARNING, "%s failed for %s: %s", failed, records_filename.c_str(), strerror(errno));
+    }
     
     // Set up pointers
     _htmaster_header = (HashMasterHeader*)_records_addr;
     _record_entry_addr = (char *)(_records_addr + sizeof(HashMasterHeader));
     
+    // live bitmap: header + base 영역 bit
+    std::string live_filename = "mmap/" + _config._filename + "_records.live";
+    size_t live_bytes = sizeof(HashMasterLiveHeader) + ((size_t)_config._max_record_count + 63) / 64 * sizeof(uint64_t);
+    bool live_fresh = false;
+    int ret = map_live(live_filename, live_bytes, &_live_fd, &_live_addr, &_live_map_size, &live_fresh);
+    if (ret != HASH_OK) {
+        return ret;
+    }
+    _live_words = (uint64_t*)((char*)_live_addr + sizeof(HashMasterLiveHeader));
+    
     // Initialize header if this is a new file (all zeros)
     if (_htmaster_header->_max_record_count == 0) {
         _htmaster_header->_first_free_record = 0;
@@ -198,20 +269,454 @@ int HashMaster::allocate_record_storage() {
         _htmaster_header->_primary_field_len = _config._primary_field_len;
         _htmaster_header->_secondary_field_len = _config._secondary_field_len;
         _htmaster_header->_use_lock = _config._use_lock;
-        
+
+        // free list: 새 파일은 _nextEmpty 가 모두 0 이라 두번째 put 부터 slot 0 을 다시 쓰게 된다
+        const int capacity = _config._max_record_count;
+        for (int i = 0; i < capacity; i++) {
+            get_record_entry(i)->_nextEmpty = i + 1 < capacity ? i + 1 : -1;
+        }
+
         log(LOG_INFO, "Initialized new HashMaster header with config");
     } else {
         log(LOG_INFO, "Using existing HashMaster header");
     }
     
-    log(LOG_INFO, "Record storage allocated: %zu bytes", _storage_size);
+    // auto_grow 로 늘어난 segment 매핑
+    refresh_segments();
+    if (_segment_count.load() != _htmaster_header->_segment_count) {
+        log(LOG_ERROR, "Failed to map record segments (%d of %d)",
+            _segment_count.load(), _htmaster_header->_segment_count);
+        return HASH_ERROR_FILE_ERROR;
+    }
+    
+    const HashMasterLiveHeader* live_header = (const HashMasterLiveHeader*)_live_addr;
+    if (_live_rebuild || live_header->_magic_number != HASH_MASTER_LIVE_MAGIC ||
+        live_header->_max_record_count != _config._max_record_count) {
+        rebuild_live_bitmap();
+    }
+    
+    log(LOG_INFO, "Record storage allocated: %zu bytes, %d segments, capacity %d",
+        _storage_size, _segment_count.load(), record_capacity());
+    return HASH_OK;
+}
+
+// segment 파일 하나를 매핑한다. create 면 새로 만들어 0으로 채운다.
+int HashMaster::map_segment(int segment, bool create) {
+    if (segment < 1 || segment > MAX_RECORD_SEGMENTS) {
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    std::string filename = "mmap/" + _config._filename + "_records." + std::to_string(segment) + ".dat";
+    size_t count = (size_t)_config._max_record_count << (segment - 1);
+    size_t size = count * _record_entry_size;
+    
+    int fd = open(filename.c_str(), create ? (O_RDWR | O_CREAT) : O_RDWR, 0644);
+    if (fd == -1) {
+        log(LOG_ERROR, "Failed to open record segment %s: %s", filename.c_str(), strerror(errno));
+        return HASH_ERROR_FILE_ERROR;
+    }
+    size = mmap_map_size(fd, size);
+    
+    // 예전 clear 이전에 남아있던 파일일 수 있으므로 새로 만들 때는 비운다
+    if (create && ftruncate(fd, 0) == -1) {
+        log(LOG_ERROR, "Failed to truncate record segment %s: %s", filename.c_str(), strerror(errno));
+        close(fd);
+        return HASH_ERROR_FILE_ERROR;
+    }
+    
+    struct stat st;
+    if (fstat(fd, &st) == -1 || ((size_t)st.st_size < size && (!create || ftruncate(fd, size) == -1))) {
+        log(LOG_ERROR, "Invalid record segment size %s: %s", filename.c_str(), strerror(errno));
+        close(fd);
+        return HASH_ERROR_FILE_ERROR;
+    }
+    
+    void* addr = mmap(NULL, size, PROT_READ | PROT_WRITE, mmap_flags(_config._mmap), fd, 0);
+    if (addr == MAP_FAILED) {
+        log(LOG_ERROR, "Failed to map record segment %s: %s", filename.c_str(), strerror(errno));
+        close(fd);
+        return HASH_ERROR_MEMORY_ERROR;
+    }
+    const char* failed = mmap_apply_options(addr, size, _config._mmap);
+    if (failed) {
+        log(LOG_WARNING, "%s failed for %s: %s", failed, filename.c_str(), strerror(errno));
+    }
+    
+    std::string live_filename = "mmap/" + _config._filename + "_records." + std::to_string(segment) + ".live";
+    int live_fd = -1;
+    void* live_addr = MAP_FAILED;
+    size_t live_size = 0;
+    bool fresh = false;
+    if (create) {
+        unlink(live_filename.c_str());
+    }
+    if (map_live(live_filename, (count + 63) / 64 * sizeof(uint64_t), &live_fd, &live_addr, &live_size, &fresh) != HASH_OK) {
+        munmap(addr, size);
+        close(fd);
+        return HASH_ERROR_FILE_ERROR;
+    }
+    // 이전 빌드가 만든 segment 는 bitmap 이 없다 (init 에서 다시 채움)
+    if (fresh && !create) {
+        _live_rebuild = true;
+    }
+    
+    RecordSegment& seg = _segments[segment - 1];
+    seg.fd = fd;
+    seg.addr = (char*)addr;
+    seg.size = size;
+    seg.live_fd = live_fd;
+    seg.live = (uint64_t*)live_addr;
+    seg.live_size = live_size;
+    return HASH_OK;
+}
+
+// bitmap 파일 하나를 매핑한다 (없으면 만든다). 새로 만들었거나 짧았으면 *fresh = true
+int HashMaster::map_live(const std::string& filename, size_t bytes, int* fd, void** addr, size_t* size, bool* fresh) {
+    *fd = open(filename.c_str(), O_RDWR | O_CREAT, 0644);
+    if (*fd == -1) {
+        log(LOG_ERROR, "Failed to open live bitmap %s: %s", filename.c_str(), strerror(errno));
+        return HASH_ERROR_FILE_ERROR;
+    }
+    *size = mmap_map_size(*fd, bytes);
+    
+    struct stat st;
+    if (fstat(*fd, &st) == -1 || ((size_t)st.st_size != *size && ftruncate(*fd, *size) == -1)) {
+        log(LOG_ERROR, "Failed to size live bitmap %s: %s", filename.c_str(), strerror(errno));
+        close(*fd);
+        *fd = -1;
+        return HASH_ERROR_FILE_ERROR;
+    }
+    *fresh = (size_t)st.st_size < *size;
+    
+    *addr = mmap(NULL, *size, PROT_READ | PROT_WRITE, mmap_flags(_config._mmap), *fd, 0);
+    if (*addr == MAP_FAILED) {
+        log(LOG_ERROR, "Failed to map live bitmap %s: %s", filename.c_str(), strerror(errno));
+        close(*fd);
+        *fd = -1;
+        return HASH_ERROR_MEMORY_ERROR;
+    }
+    return HASH_OK;
+}
+
+// _occupied 를 한번 훑어 bitmap 을 다시 채운다 (bitmap 이 없던 파일 / 다른 max_record_count)
+void HashMaster::rebuild_live_bitmap() {
+    HashMasterLiveHeader* header = (HashMasterLiveHeader*)_live_addr;
+    header->_magic_number = 0;
+    
+    memset(_live_words, 0, _live_map_size - sizeof(HashMasterLiveHeader));
+    for (int k = 0; k < _segment_count.load(); k++) {
+        memset(_segments[k].live, 0, _segments[k].live_size);
+    }
+    int capacity = record_capacity();
+    int live = 0;
+    for (int i = 0; i < capacity; i++) {
+        DataRecordEntry* re = get_record_entry(i);
+        if (re && re->_occupied) {
+            live_set(i);
+            live++;
+        }
+    }
+    
+    header->_max_record_count = _config._max_record_count;
+    __atomic_store_n(&header->_magic_number, HASH_MASTER_LIVE_MAGIC, __ATOMIC_RELEASE);
+    _live_rebuild = false;
+    log(LOG_INFO, "Live record bitmap rebuilt: %d of %d records", live, capacity);
+}
+
+// record index 의 bitmap word (base 영역 또는 segment 영역, 영역마다 0 번 bit 부터)
+uint64_t* HashMaster::live_word(int index, uint64_t* mask) {
+    if (index < 0 || !_live_words) {
+        return nullptr;
+    }
+    if (index < _config._max_record_count) {
+        *mask = 1ull << (index & 63);
+        return &_live_words[index >> 6];
+    }
+    
+    int segment = 32 - __builtin_clz((unsigned)(index / _config._max_record_count));
+    if (segment > MAX_RECORD_SEGMENTS) {
+        return nullptr;
+    }
+    if (segment > _segment_count.load(std::memory_order_acquire)) {
+        refresh_segments();
+        if (segment > _segment_count.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+    }
+    size_t offset = (size_t)index - ((size_t)_config._max_record_count << (segment - 1));
+    *mask = 1ull << (offset & 63);
+    return &_segments[segment - 1].live[offset >> 6];
+}
+
+// from 이상 end 미만의 첫 live record index (없으면 -1). 빈 word 는 64 개씩 건너뛴다.
+int HashMaster::next_live(int from, int end) {
+    if (from < 0) {
+        from = 0;
+    }
+    while (from < end) {
+        // from 이 속한 영역: base [0, B) 또는 segment k [B * 2^(k-1), B * 2^k)
+        long long base = 0;
+        long long limit = _config._max_record_count;
+        const uint64_t* words = _live_words;
+        if (from >= _config._max_record_count) {
+            int segment = 32 - __builtin_clz((unsigned)(from / _config._max_record_count));
+            if (segment > MAX_RECORD_SEGMENTS) {
+                return -1;
+            }
+            if (segment > _segment_count.load(std::memory_order_acquire)) {
+                refresh_segments();
+                if (segment > _segment_count.load(std::memory_order_acquire)) {
+                    return -1;
+                }
+            }
+            base = (long long)_config._max_record_count << (segment - 1);
+            limit = (long long)_config._max_record_count << segment;
+            words = _segments[segment - 1].live;
+        }
+        if (limit > end) {
+            limit = end;
+        }
+        
+        size_t off = (size_t)(from - base);
+        size_t stop = (size_t)(limit - base);
+        size_t w = off >> 6;
+        uint64_t bits = __atomic_load_n(&words[w], __ATOMIC_ACQUIRE) & (~0ull << (off & 63));
+        for (;;) {
+            if (bits) {
+                size_t i = (w << 6) + __builtin_ctzll(bits);
+                if (i < stop) {
+                    return (int)(base + i);
+                }
+                break;
+            }
+            if ((++w << 6) >= stop) {
+                break;
+            }
+            bits = __atomic_load_n(&words[w], __ATOMIC_ACQUIRE);
+        }
+        from = (int)limit;
+    }
+    return -1;
+}
+
+// 다른 프로세스가 늘린 segment 를 매핑 (header 의 _segment_count 까지)
+void HashMaster::refresh_segments() {
+    if (!_htmaster_header) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> guard(_segment_mutex);
+    int target = __atomic_load_n(&_htmaster_header->_segment_count, __ATOMIC_ACQUIRE);
+    if (target > MAX_RECORD_SEGMENTS) {
+        target = MAX_RECORD_SEGMENTS;
+    }
+    
+    for (int k = _segment_count.load(std::memory_order_relaxed) + 1; k <= target; k++) {
+        if (map_segment(k, false) != HASH_OK) {
+            break;
+        }
+        _segment_count.store(k, std::memory_order_release);
+    }
+}
+
+DataRecordEntry* HashMaster::get_segment_entry(int index) {
+    if (index < 0) {
+        return nullptr;
+    }
+    
+    int segment = 32 - __builtin_clz((unsigned)(index / _config._max_record_count));
+    if (segment > MAX_RECORD_SEGMENTS) {
+        return nullptr;
+    }
+    if (segment > _segment_count.load(std::memory_order_acquire)) {
+        refresh_segments();
+        if (segment > _segment_count.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+    }
+    
+    size_t offset = (size_t)index - ((size_t)_config._max_record_count << (segment - 1));
+    return (DataRecordEntry*)(_segments[segment - 1].addr + offset * _record_entry_size);
+}
+
+// index / 레코드 파일 page 를 모두 미리 fault (feed 시작 전 startup 단계에서 호출)
+int HashMaster::warm() {
+    if (!_initialized) {
+        log(LOG_ERROR, "HashMaster not initialized");
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    int ret = _primary_hash_table->warm();
+    if (ret == HASH_OK && _secondary_hash_table) {
+        ret = _secondary_hash_table->warm();
+    }
+    
+    mmap_prefault(_records_addr, _records_map_size);
+    mmap_prefault(_live_addr, _live_map_size);
+    size_t bytes = _records_map_size;
+    refresh_segments();
+    for (int i = 0; i < _segment_count.load(std::memory_order_acquire); i++) {
+        mmap_prefault(_segments[i].addr, _segments[i].size);
+        mmap_prefault(_segments[i].live, _segments[i].live_size);
+        bytes += _segments[i].size;
+    }
+    
+    log(LOG_INFO, "Warmed %zu record bytes (%d segments)", bytes, _segment_count.load());
+    return ret;
+}
+
+void HashMaster::cleanup_segments() {
+    for (int i = 0; i < MAX_RECORD_SEGMENTS; i++) {
+        RecordSegment& seg = _segments[i];
+        if (seg.addr) {
+            munmap(seg.addr, seg.size);
+            seg.addr = nullptr;
+        }
+        if (seg.fd != -1) {
+            close(seg.fd);
+            seg.fd = -1;
+        }
+        if (seg.live) {
+            munmap(seg.live, seg.live_size);
+            seg.live = nullptr;
+        }
+        if (seg.live_fd != -1) {
+            close(seg.live_fd);
+            seg.live_fd = -1;
+        }
+    }
+    _segment_count.store(0);
+}
+
+// 레코드가 가득 찼을 때 (master write lock 안에서 호출)
+// 인덱스를 먼저 새 generation으로 늘린 뒤 현재 용량만큼의 segment 를 추가해 free list에 붙인다.
+int HashMaster::grow_records() {
+    int segment = _segment_count.load() + 1;
+    if (segment > MAX_RECORD_SEGMENTS ||
+        ((long long)_config._max_record_count << segment) > INT_MAX) {
+        log(LOG_ERROR, "Cannot grow records beyond %d", record_capacity());
+        return HASH_ERROR_NO_SPACE;
+    }
+    
+    int first = record_capacity();
+    int new_capacity = _config._max_record_count << segment;
+    long long hash_count = (long long)_config._hash_count << segment;
+    if (hash_count > INT_MAX) {
+        hash_count = INT_MAX;
+    }
+    
+    int ret = _primary_hash_table->resize((int)hash_count, new_capacity);
+    if (ret == HASH_OK && _secondary_hash_table) {
+        ret = _secondary_hash_table->resize((int)hash_count, new_capacity);
+    }
+    if (ret != HASH_OK) {
+        log(LOG_ERROR, "Failed to resize hash tables: %d", ret);
+        return ret;
+    }
+    
+    ret = map_segment(segment, true);
+    if (ret != HASH_OK) {
+        return ret;
+    }
+    
+    int count = new_capacity - first;
+    char* addr = _segments[segment - 1].addr;
+    for (int i = 0; i < count; i++) {
+        DataRecordEntry* re = (DataRecordEntry*)(addr + (size_t)i * _record_entry_size);
+        re->_occupied = false;
+        re->_nextEmpty = (i == count - 1) ? _htmaster_header->_first_free_record : first + i + 1;
+    }
+    
+    // 다른 프로세스의 reader가 새 index를 보기 전에 segment 수가 먼저 보여야 한다
+    _segment_count.store(segment, std::memory_order_release);
+    __atomic_store_n(&_htmaster_header->_segment_count, (uint16_t)segment, __ATOMIC_RELEASE);
+    _htmaster_header->_first_free_record = first;
+    _free_records += count;
+    
+    log(LOG_INFO, "Records grown: capacity %d -> %d (segment %d)", first, new_capacity, segment);
+    
+    start_migration_thread();
     return HASH_OK;
 }
 
+int HashMaster::resize(int new_max_record_count) {
+    if (!_initialized) {
+        log(LOG_ERROR, "HashMaster not initialized");
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    if (_config._use_lock) {
+        pthread_rwlock_wrlock(&_master_rwlock);
+    }
+    
+    int result = HASH_OK;
+    while (result == HASH_OK && record_capacity() < new_max_record_count) {
+        result = grow_records();
+    }
+    
+    if (_config._use_lock) {
+        pthread_rwlock_unlock(&_master_rwlock);
+    }
+    
+    return result;
+}
+
+bool HashMaster::is_resizing() {
+    if (!_initialized) {
+        return false;
+    }
+    return _primary_hash_table->is_resizing() ||
+           (_secondary_hash_table && _secondary_hash_table->is_resizing());
+}
+
+int HashMaster::migrate_step(int max_entries) {
+    if (!_initialized) {
+        return 0;
+    }
+    int moved = _primary_hash_table->migrate(max_entries);
+    if (_secondary_hash_table) {
+        moved += _secondary_hash_table->migrate(max_entries);
+    }
+    return moved;
+}
+
+// use_lock 이 없으면 writer 가 하나라고 가정하므로 migration은 put 에서만 진행한다.
+void HashMaster::start_migration_thread() {
+    if (!_config._use_lock || _migration_running.load()) {
+        return;
+    }
+    if (_migration_thread.joinable()) {
+        _migration_thread.join();
+    }
+    
+    _migration_stop.store(false);
+    _migration_running.store(true);
+    _migration_thread = std::thread(&HashMaster::migration_loop, this);
+}
+
+void HashMaster::stop_migration_thread() {
+    _migration_stop.store(true);
+    if (_migration_thread.joinable()) {
+        _migration_thread.join();
+    }
+    _migration_running.store(false);
+}
+
+void HashMaster::migration_loop() {
+    while (!_migration_stop.load()) {
+        if (migrate_step(256) == 0 && !is_resizing()) {
+            break;
+        }
+        usleep(1000);
+    }
+    log(LOG_INFO, "Index migration thread finished");
+    _migration_running.store(false);
+}
+
 // Cleanup record storage
 void HashMaster::cleanup_record_storage() {
     if (_records_addr != MAP_FAILED) {
-        if (munmap(_records_addr, _storage_size) == -1) {
+        if (munmap(_records_addr, _records_map_size) == -1) {
             log(LOG_ERROR, "Failed to unmap records: %s", strerror(errno));
         }
         _records_addr = MAP_FAILED;
@@ -222,6 +727,18 @@ void HashMaster::cleanup_record_storage() {
         _records_fd = -1;
     }
     
+    cleanup_segments();
+    
+    if (_live_addr != MAP_FAILED) {
+        munmap(_live_addr, _live_map_size);
+        _live_addr = MAP_FAILED;
+        _live_words = nullptr;
+    }
+    if (_live_fd != -1) {
+        close(_live_fd);
+        _live_fd = -1;
+    }
+    
     _record_entry_addr = nullptr;
     _htmaster_header = nullptr;
 }
@@ -288,7 +805,10 @@ void HashMaster::free_record(int index) {
     
     // Add to free list
     DataRecordEntry *re = get_record_entry(index);
+    live_clear(index);
+    record_write_begin(re);
     re->_occupied = false;
+    record_write_end(re);
     re->_nextEmpty = _htmaster_header->_first_free_record;
     _htmaster_header->_first_free_record = index;
     _free_records++;
@@ -323,6 +843,9 @@ int HashMaster::put(const char* pkey, const char* skey, const char* record, int
         
         // Find free record
         int record_index = _htmaster_header->_first_free_record;
+        if (record_index == -1 && _config._auto_grow && grow_records() == HASH_OK) {
+            record_index = _htmaster_header->_first_free_record;
+        }
         if (record_index == -1) {
             log(LOG_ERROR, "No free records available");
             result = HASH_ERROR_NO_SPACE;
@@ -331,9 +854,12 @@ int HashMaster::put(const char* pkey, const char* skey, const char* record, int
         
         DataRecordEntry *re = get_record_entry(record_index);
         _htmaster_header->_first_free_record = re->_nextEmpty;
+        record_write_begin(re);
         re->_occupied = true;
         re->_nextEmpty = -1;
         memcpy(re->_value,  record, record_size);
+        record_write_end(re);
+        live_set(record_index);
         
         // Add to primary hash table
         int ret = _primary_hash_table->put(pkey, record_index);
@@ -368,6 +894,192 @@ int HashMaster::put(const char* pkey, const char* skey, const char* record, int
     return result;
 }
 
+// bulk_load 로 새로 만들어 교체하는 파일 (mmap/<filename><suffix>).
+// _records.dat 이 마지막이다: 헤더 (free list, segment 수) 가 새 파일로 바뀌는 시점
+static const char* const BULK_FILE_SUFFIXES[] = {
+    "_primary.hashindex", "_primary.dataindex", "_primary.revindex",
+    "_secondary.hashindex", "_secondary.dataindex", "_secondary.revindex",
+    "_records.live", "_records.dat"
+};
+
+static void remove_bulk_files(const std::string& filename) {
+    for (const char* suffix : BULK_FILE_SUFFIXES) {
+        unlink(("mmap/" + filename + suffix).c_str());
+    }
+}
+
+// Bulk load: <filename>.bulk 로 새 파일을 lock 없이 만든 뒤 rename 으로 교체하고 다시 연다.
+// 교체하는 동안 master write lock 을 잡지만, lock_free_read reader 나 다른 프로세스는
+// 이전 매핑을 보고 있으므로 그 동안 읽지 않아야 한다 (다른 프로세스는 다시 init 해야 새 파일을 본다).
+int HashMaster::bulk_load(const MasterBulkRecord* records, int count, int* loaded) {
+    if (loaded) {
+        *loaded = 0;
+    }
+    if (!_initialized) {
+        log(LOG_ERROR, "HashMaster not initialized");
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    if (!records && count > 0) {
+        return HASH_ERROR_NULL_POINTER;
+    }
+    
+    // base 용량을 넘으면 segment 와 index generation 이 필요하므로 put 으로 넣는다
+    if (count > _config._max_record_count) {
+        if (!_config._auto_grow) {
+            log(LOG_ERROR, "Bulk load of %d records exceeds max_record_count %d", count, _config._max_record_count);
+            return HASH_ERROR_NO_SPACE;
+        }
+        log(LOG_WARNING, "Bulk load of %d records exceeds base capacity %d, using put",
+            count, _config._max_record_count);
+        return Master::bulk_load(records, count, loaded);
+    }
+    
+    HashMasterConfig staging_config(_config);
+    staging_config._filename = _config._filename + ".bulk";
+    staging_config._use_lock = false;
+    staging_config._lock_free_read = false;
+    staging_config._auto_grow = false;
+    staging_config._mmap = MmapOptions();   // 전부 쓰는 새 파일이라 page 는 한번에 채운다 (lock / warm 은 불필요)
+    staging_config._mmap.populate = true;
+    remove_bulk_files(staging_config._filename);
+    
+    int stored = 0;
+    int ret;
+    {
+        HashMaster staging(staging_config);
+        ret = staging.init();
+        if (ret == HASH_OK) {
+            ret = staging.build_bulk(records, count, &stored);
+        }
+    }
+    if (ret != HASH_OK) {
+        log(LOG_ERROR, "Failed to build bulk load files: %d", ret);
+        remove_bulk_files(staging_config._filename);
+        return ret;
+    }
+    
+    // 교체: 이 프로세스의 매핑을 닫고 파일을 옮긴 뒤 다시 연다
+    stop_migration_thread();
+    if (_config._use_lock) {
+        pthread_rwlock_wrlock(&_master_rwlock);
+    }
+    
+    _primary_hash_table.reset();
+    _secondary_hash_table.reset();
+    cleanup_record_storage();
+    
+    for (const char* suffix : BULK_FILE_SUFFIXES) {
+        std::string from = "mmap/" + staging_config._filename + suffix;
+        std::string to = "mmap/" + _config._filename + suffix;
+        if (rename(from.c_str(), to.c_str()) == 0) {
+            continue;
+        }
+        if (errno == ENOENT) {
+            // staging 에 없는 파일 (secondary 없음, revindex 생성 실패) 은 이전 것도 지운다
+            unlink(to.c_str());
+            continue;
+        }
+        log(LOG_ERROR, "Failed to rename %s to %s: %s", from.c_str(), to.c_str(), strerror(errno));
+        ret = HASH_ERROR_FILE_ERROR;
+        break;
+    }
+    
+    if (ret == HASH_OK) {
+        ret = open_storage();
+    }
+    if (ret == HASH_OK) {
+        _total_records = stored;
+        _free_records = record_capacity() - stored;
+    } else {
+        log(LOG_ERROR, "Failed to reopen storage after bulk load: %d", ret);
+        _initialized = false;
+    }
+    
+    if (_config._use_lock) {
+        pthread_rwlock_unlock(&_master_rwlock);
+    }
+    
+    if (ret == HASH_OK) {
+        if (loaded) {
+            *loaded = stored;
+        }
+        log(LOG_INFO, "Bulk loaded %d of %d records", stored, count);
+    }
+    return ret;
+}
+
+// 새로 만든 (0 으로 채워진) 자신의 파일에 레코드를 채운다. record 는 받아들인 순서대로 0,1,2..
+int HashMaster::build_bulk(const MasterBulkRecord* records, int count, int* stored) {
+    const int threads = bulk_load_threads(count);
+    const bool secondary = _config.use_secondary_index() && _secondary_hash_table != nullptr;
+    
+    // put 이 거절할 행은 primary key 를 nullptr 로 두어 index 에서 건너뛴다
+    std::vector<const char*> pkeys(count);
+    bulk_parallel_for(count, threads, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const MasterBulkRecord& r = records[i];
+            bool valid = r.pkey && strnlen(r.pkey, _config._primary_field_len) < (size_t)_config._primary_field_len &&
+                         r.record && r.record_size > 0 && r.record_size <= _config._max_record_size;
+            if (valid && _config.use_secondary_index()) {
+                valid = r.skey && strnlen(r.skey, _config._secondary_field_len) < (size_t)_config._secondary_field_len;
+            }
+            pkeys[i] = valid ? r.pkey : nullptr;
+        }
+    });
+    
+    std::vector<int> assigned(count);
+    int n = _primary_hash_table->bulk_load(pkeys.data(), nullptr, count, threads, assigned.data());
+    if (n < 0) {
+        return n;
+    }
+    
+    // 레코드 복사 (병렬, 서로 다른 slot)
+    bulk_parallel_for(count, threads, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            if (assigned[i] < 0) continue;
+            DataRecordEntry* re = get_record_entry(assigned[i]);
+            re->_occupied = true;
+            re->_nextEmpty = -1;
+            memcpy(re->_value, records[i].record, records[i].record_size);
+        }
+    });
+    
+    // live bitmap: [0, n)
+    memset(_live_words, 0xff, (size_t)(n / 64) * sizeof(uint64_t));
+    if (n % 64) {
+        _live_words[n / 64] = (1ULL << (n % 64)) - 1;
+    }
+    
+    // free list: 나머지 slot 을 i -> i+1 로 묶는다 (새 파일이라 _occupied 는 이미 0)
+    const int capacity = _config._max_record_count;
+    for (int i = n; i < capacity; i++) {
+        get_record_entry(i)->_nextEmpty = i + 1 < capacity ? i + 1 : -1;
+    }
+    _htmaster_header->_first_free_record = n < capacity ? n : -1;
+    _total_records = n;
+    _free_records = capacity - n;
+    
+    if (secondary) {
+        std::vector<const char*> skeys;
+        std::vector<int> indexes;
+        skeys.reserve(n);
+        indexes.reserve(n);
+        for (int i = 0; i < count; i++) {
+            if (assigned[i] >= 0 && records[i].skey && records[i].skey[0]) {
+                skeys.push_back(records[i].skey);
+                indexes.push_back(assigned[i]);
+            }
+        }
+        int ret = _secondary_hash_table->bulk_load(skeys.data(), indexes.data(), (int)skeys.size(), threads, nullptr);
+        if (ret < 0) {
+            return ret;
+        }
+    }
+    
+    *stored = n;
+    return HASH_OK;
+}
+
 // Get by field index
 char* HashMaster::get(int field_index, const char* key) {
     if (field_index == 0) {
@@ -384,7 +1096,9 @@ char* HashMaster::get_by_primary(const char* pkey) {
         return nullptr;
     }
     
-    if (_config._use_lock) {
+    // lock-free 모드에서는 writer가 하나이므로 포인터 조회에 rwlock이 필요 없다.
+    bool use_lock = _config._use_lock && !_config._lock_free_read;
+    if (use_lock) {
         pthread_rwlock_rdlock(&_master_rwlock);
     }
     
@@ -392,10 +1106,11 @@ char* HashMaster::get_by_primary(const char* pkey) {
     
     int record_index = _primary_hash_table->get(pkey);
     if (record_index != HASH_ERROR_KEY_NOT_FOUND) {
-        result = get_record_entry(record_index)->_value;
+        DataRecordEntry* re = get_record_entry(record_index);
+        result = re ? re->_value : nullptr;
     }
     
-    if (_config._use_lock) {
+    if (use_lock) {
         pthread_rwlock_unlock(&_master_rwlock);
     }
     
@@ -408,7 +1123,9 @@ char* HashMaster::get_by_secondary(const char* skey) {
         return nullptr;
     }
     
-    if (_config._use_lock) {
+    // lock-free 모드에서는 writer가 하나이므로 포인터 조회에 rwlock이 필요 없다.
+    bool use_lock = _config._use_lock && !_config._lock_free_read;
+    if (use_lock) {
         pthread_rwlock_rdlock(&_master_rwlock);
     }
     
@@ -416,16 +1133,108 @@ char* HashMaster::get_by_secondary(const char* skey) {
     
     int record_index = _secondary_hash_table->get(skey);
     if (record_index != HASH_ERROR_KEY_NOT_FOUND) {
-        result = get_record_entry(record_index)->_value;
+        DataRecordEntry* re = get_record_entry(record_index);
+        result = re ? re->_value : nullptr;
     }
     
-    if (_config._use_lock) {
+    if (use_lock) {
+        pthread_rwlock_unlock(&_master_rwlock);
+    }
+    
+    return result;
+}
+
+// Record pointer (get_by_*) -> DataRecordEntry
+DataRecordEntry* HashMaster::entry_from_record(char* record) {
+    if (!_initialized || !record) {
+        return nullptr;
+    }
+    // 기본 파일, 그 다음 segment 순으로 record 가 속한 영역을 찾는다
+    int segments = _segment_count.load(std::memory_order_acquire);
+    for (int k = 0; k <= segments; k++) {
+        char* first = k == 0 ? (char*)get_record_entry(0)->_value
+                             : _segments[k - 1].addr + sizeof(DataRecordEntry);
+        ptrdiff_t count = k == 0 ? _config._max_record_count
+                                 : (ptrdiff_t)_config._max_record_count << (k - 1);
+        ptrdiff_t offset = record - first;
+        if (offset >= 0 && offset % (ptrdiff_t)_record_entry_size == 0 &&
+            offset / (ptrdiff_t)_record_entry_size < count) {
+            return (DataRecordEntry*)(record - sizeof(DataRecordEntry));
+        }
+    }
+    log(LOG_ERROR, "Record pointer %p is not a record of this master", record);
+    return nullptr;
+}
+
+void HashMaster::begin_record_update(char* record) {
+    DataRecordEntry* re = entry_from_record(record);
+    if (re) {
+        record_write_begin(re);
+    }
+}
+
+void HashMaster::end_record_update(char* record) {
+    DataRecordEntry* re = entry_from_record(record);
+    if (re) {
+        record_write_end(re);
+    }
+    T2MA_TRACE1(master_update, record);
+}
+
+// Seqlock snapshot read
+// record 복사 중에 _version 이 바뀌었거나 key가 다른 record로 옮겨졌으면 다시 읽는다.
+// 주의: 같은 스레드에서 begin_record_update ~ end_record_update 사이에 호출하면 끝나지 않는다.
+int HashMaster::read_record(HashTable* table, const char* key, char* out, int out_size) {
+    if (!_initialized || !table || !key || !out || out_size <= 0) {
+        return MASTER_ERROR_INVALID_PARAMETER;
+    }
+    
+    int copy_size = out_size < _config._max_record_size ? out_size : _config._max_record_size;
+    bool use_lock = _config._use_lock && !_config._lock_free_read;
+    if (use_lock) {
+        pthread_rwlock_rdlock(&_master_rwlock);
+    }
+    
+    int result = MASTER_ERROR_KEY_NOT_FOUND;
+    for (int spins = 0; ; ++spins) {
+        int record_index = table->get(key);
+        DataRecordEntry* re = record_index < 0 ? nullptr : get_record_entry(record_index);
+        if (!re) {
+            break;
+        }
+        
+        uint16_t before = __atomic_load_n(&re->_version, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            if (spins > 64) sched_yield();
+            continue;
+        }
+        bool occupied = re->_occupied;
+        memcpy(out, re->_value, copy_size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&re->_version, __ATOMIC_RELAXED) != before ||
+            table->get(key) != record_index) {
+            continue;
+        }
+        
+        result = occupied ? copy_size : MASTER_ERROR_KEY_NOT_FOUND;
+        break;
+    }
+    
+    if (use_lock) {
         pthread_rwlock_unlock(&_master_rwlock);
     }
     
     return result;
 }
 
+int HashMaster::read_by_primary(const char* pkey, char* out, int out_size) {
+    return read_record(_primary_hash_table.get(), pkey, out, out_size);
+}
+
+int HashMaster::read_by_secondary(const char* skey, char* out, int out_size) {
+    return read_record(_secondary_hash_table.get(), skey, out, out_size);
+}
+
 // Delete operation
 int HashMaster::del(const char* pkey) {
     if (!_initialized || !pkey) {
@@ -489,6 +1298,48 @@ int HashMaster::del(const char* pkey) {
     return result;
 }
 
+// Re-key secondary index: 이전 secondary key 는 reverse index 로 바로 찾는다
+int HashMaster::update_secondary_key(const char* pkey, const char* new_skey) {
+    if (!_initialized || !pkey || !new_skey || _secondary_hash_table == nullptr) {
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    if (_config._use_lock) {
+        pthread_rwlock_wrlock(&_master_rwlock);
+    }
+    
+    int result = HASH_OK;
+    
+    do {
+        int record_index = _primary_hash_table->get(pkey);
+        if (record_index < 0) {
+            result = HASH_ERROR_KEY_NOT_FOUND;
+            break;
+        }
+        
+        if (_secondary_hash_table->get(new_skey) >= 0) {
+            result = HASH_ERROR_KEY_EXISTS;
+            break;
+        }
+        
+        char old_skey[_config._secondary_field_len];
+        if (_secondary_hash_table->find_key_by_data_index(record_index, old_skey) == HASH_OK) {
+            _secondary_hash_table->del(old_skey);
+        }
+        
+        result = _secondary_hash_table->put(new_skey, record_index);
+        if (result != HASH_OK) {
+            log(LOG_ERROR, "Failed to put new secondary key for record_index %d: %d", record_index, result);
+        }
+    } while(0);
+    
+    if (_config._use_lock) {
+        pthread_rwlock_unlock(&_master_rwlock);
+    }
+    
+    return result;
+}
+
 // Add record (allocate space and return pointer)
 char* HashMaster::add_record(const char* pkey, const char* skey, int record_size) {
     if (!_initialized) {
@@ -515,6 +1366,9 @@ char* HashMaster::add_record(const char* pkey, const char* skey, int record_size
         
         // Find free record
         int record_index = _htmaster_header->_first_free_record;
+        if (record_index == -1 && _config._auto_grow && grow_records() == HASH_OK) {
+            record_index = _htmaster_header->_first_free_record;
+        }
         if (record_index == -1) {
             break;
         }
@@ -522,6 +1376,7 @@ char* HashMaster::add_record(const char* pkey, const char* skey, int record_size
         _htmaster_header->_first_free_record = entry->_nextEmpty;
         entry->_occupied = true;
         entry->_nextEmpty = -1;
+        live_set(record_index);
         
         // Add to hash tables
         if (_primary_hash_table->put(pkey, record_index) != HASH_OK) {
@@ -573,10 +1428,10 @@ HashMaster::HashMasterStats HashMaster::get_hash_master_statistics() {
         pthread_rwlock_rdlock(&_master_rwlock);
     }
     
-    stats.total_records = _config._max_record_count;
+    stats.total_records = record_capacity();
     stats.free_records = _free_records;
     stats.used_records = _total_records;
-    stats.record_utilization = (double)_total_records / _config._max_record_count;
+    stats.record_utilization = (double)_total_records / stats.total_records;
     
     if (_primary_hash_table) {
         stats.primary_stats = _primary_hash_table->get_statistics();
@@ -629,9 +1484,9 @@ void HashMaster::display_hashtable() const {
 
 // Validation methods
 bool HashMaster::validate_record_index(int index) {
-    if (index < 0 || index >= _config._max_record_count) {
+    if (index < 0 || index >= record_capacity()) {
         log(LOG_ERROR, "Invalid record index: %d (valid range: 0-%d)", 
-            index, _config._max_record_count - 1);
+            index, record_capacity() - 1);
         return false;
     }
     return true;
@@ -668,16 +1523,11 @@ void HashMaster::log(LogLevel level, const char* format, ...) {
     if (level < _config._log_level) {
         return;
     }
-    
-    const char* level_str[] = {"DEBUG", "INFO", "WARN", "ERROR"};
-    printf("[%s] HashMaster: ", level_str[level]);
-    
+
     va_list args;
     va_start(args, format);
-    vprintf(format, args);
+    SimplePubSub::AsyncLogger::instance().logv(level, "HashMaster", format, args);
     va_end(args);
-    
-    printf("\n");
 }
 
 // Set log level
@@ -702,6 +1552,17 @@ void HashMaster::setUseLock(bool use_lock) {
     }
 }
 
+// Set lock-free read mode (single writer / multi reader)
+void HashMaster::setLockFreeRead(bool enable) {
+    _config._lock_free_read = enable;
+    if (_primary_hash_table) {
+        _primary_hash_table->setLockFreeRead(enable);
+    }
+    if (_secondary_hash_table) {
+        _secondary_hash_table->setLockFreeRead(enable);
+    }
+}
+
 // Sequential access methods
 int HashMaster::getBySeq(int seq) {
     if (!validate_record_index(seq)) {
@@ -753,15 +1614,68 @@ void HashMaster::display_records() {
     // TODO: Implement record display
 }
 
+int HashMaster::count_live_records() {
+    if (!_initialized) {
+        return 0;
+    }
+    
+    int count = 0;
+    size_t words = ((size_t)_config._max_record_count + 63) / 64;
+    for (size_t w = 0; w < words; w++) {
+        count += __builtin_popcountll(__atomic_load_n(&_live_words[w], __ATOMIC_RELAXED));
+    }
+    refresh_segments();
+    for (int k = 0; k < _segment_count.load(std::memory_order_acquire); k++) {
+        words = (((size_t)_config._max_record_count << k) + 63) / 64;
+        for (size_t w = 0; w < words; w++) {
+            count += __builtin_popcountll(__atomic_load_n(&_segments[k].live[w], __ATOMIC_RELAXED));
+        }
+    }
+    return count;
+}
+
 // Iterator methods
 bool HashMaster::Iterator::has_next() {
-    // TODO: Implement iterator
-    return false;
+    if (_current_index >= _end) {
+        return false;
+    }
+    int index = _hash_master->next_live(_current_index, _end);
+    _current_index = index < 0 ? _end : index;
+    return index >= 0;
 }
 
 char* HashMaster::Iterator::next() {
-    // TODO: Implement iterator
-    return nullptr;
+    if (!has_next()) {
+        return nullptr;
+    }
+    _index = _current_index++;
+    DataRecordEntry* re = _hash_master->get_record_entry(_index);
+    return re ? re->_value : nullptr;
+}
+
+HashMaster::Iterator HashMaster::range(int part, int parts) {
+    int capacity = record_capacity();
+    if (parts <= 0 || part < 0 || part >= parts) {
+        return Iterator(this, capacity, capacity);
+    }
+    // 구간 경계는 64 배수 (bitmap word 단위로 나눈다)
+    long long words = ((long long)capacity + 63) / 64;
+    long long begin = words * part / parts * 64;
+    long long end = words * (part + 1) / parts * 64;
+    if (end > capacity) {
+        end = capacity;
+    }
+    if (begin > end) {
+        begin = end;
+    }
+    return Iterator(this, (int)begin, (int)end);
+}
+
+std::unique_ptr<Master::Iterator> HashMaster::create_iterator() {
+    if (!_initialized) {
+        return nullptr;
+    }
+    return std::unique_ptr<Master::Iterator>(new Iterator(this));
 }
 
 // Config utility functions - DEPRECATED: Use MasterManager instead
@@ -915,7 +1829,8 @@ HashMasterConfig get_config_from_hashmaster(const char* filename) {
     }
     
     // Memory map the header
-    void* mapped_addr = mmap(nullptr, sizeof(HashMasterHeader), PROT_READ, MAP_SHARED, fd, 0);
+    size_t header_map_size = mmap_map_size(fd, sizeof(HashMasterHeader));
+    void* mapped_addr = mmap(nullptr, header_map_size, PROT_READ, MAP_SHARED, fd, 0);
     if (mapped_addr == MAP_FAILED) {
         printf("[ERROR] HashMaster: Failed to mmap header: %s (errno: %d)\n", 
                records_filename.c_str(), errno);
@@ -945,7 +1860,7 @@ HashMasterConfig get_config_from_hashmaster(const char* filename) {
     printf("  use_lock: %s\n", config._use_lock ? "true" : "false");
     
     // Clean up
-    munmap(mapped_addr, sizeof(HashMasterHeader));
+    munmap(mapped_addr, header_map_size);
     close(fd);
 
     return config;
@@ -5,6 +5,12 @@
 #include "HashTable.h"
 #include <memory>
 #include <string>
+#include <atomic>
+#include <mutex>
+#include <thread>
+
+// auto_grow 로 추가되는 레코드 segment 최대 개수 (segment k 는 기본 용량의 2^(k-1) 배)
+#define MAX_RECORD_SEGMENTS 16
 
 // HashMaster-specific configuration extends MasterConfig
 struct HashMasterConfig : public MasterConfig {
@@ -39,16 +45,29 @@ struct HashMasterHeader {
     int _primary_field_len;     // Primary key field length
     int _secondary_field_len;   // Secondary key field length
     bool _use_lock;             // Enable thread safety
+    char _filler;
+    uint16_t _segment_count;    // auto_grow 로 추가된 segment 수 (기존 padding 자리)
+};
+
+// 사용 중인 레코드 bitmap (mmap/<filename>_records.live, segment k 는 _records.<k>.live)
+// bit i = record i 가 occupied. 전체 scan 을 용량이 아니라 live 레코드 수에 비례하게 한다.
+// base 파일만 header 를 갖고, bitmap 이 없던 이전 파일은 init 시 _occupied 를 한번 훑어 만든다.
+#define HASH_MASTER_LIVE_MAGIC 0x484d4c56
+
+struct HashMasterLiveHeader {
+    int _magic_number;
+    int _max_record_count;
 };
 
 // Data entry structure (variable length)
 struct DataRecordEntry {
     bool _occupied;       // 0: empty, 1: occupied
-    char _filler[3];
+    char _filler;
+    uint16_t _version;    // record seqlock (홀수: 쓰기 진행 중), 기존 _filler[3] 자리 재사용
     int _nextEmpty;      // Next empty slot in free list
     char _value[];       // Variable length key value
     
-    DataRecordEntry() : _occupied(0), _nextEmpty(-1){}
+    DataRecordEntry() : _occupied(0), _filler(0), _version(0), _nextEmpty(-1){}
 };
 
 class HashMaster : public Master {
@@ -60,6 +79,7 @@ private:
     // size_t _records_size;
     size_t _record_entry_size;
     size_t _storage_size;
+    size_t _records_map_size;   // mmap 길이 (hugetlbfs 면 huge page 배수로 올림)
     
     // Hash tables for dual indexing
     std::unique_ptr<HashTable> _primary_hash_table;
@@ -71,6 +91,32 @@ private:
     HashMasterHeader *_htmaster_header;
     char *_record_entry_addr;
     
+    // live 레코드 bitmap (base 영역)
+    int _live_fd;
+    void* _live_addr;
+    size_t _live_map_size;
+    uint64_t* _live_words;
+    bool _live_rebuild;     // 기존 segment 의 bitmap 파일을 새로 만들었음 (기존 레코드로 다시 채워야 함)
+    
+    // 추가 레코드 segment (mmap/<filename>_records.<k>.dat)
+    // record index 는 전체에서 연속: segment k 는 [B * 2^(k-1), B * 2^k), B = _max_record_count
+    struct RecordSegment {
+        int fd;
+        char* addr;
+        size_t size;
+        int live_fd;        // _records.<k>.live
+        uint64_t* live;
+        size_t live_size;
+    };
+    RecordSegment _segments[MAX_RECORD_SEGMENTS];
+    std::atomic<int> _segment_count;    // 이 프로세스에서 매핑된 segment 수
+    std::mutex _segment_mutex;
+    
+    // 인덱스 resize 후 남은 key를 옮기는 백그라운드 스레드 (use_lock 일 때만)
+    std::thread _migration_thread;
+    std::atomic<bool> _migration_stop;
+    std::atomic<bool> _migration_running;
+    
     // Free record management
     // int _first_free_record; // move to HashMasterHeader
     pthread_rwlock_t _master_rwlock;
@@ -80,14 +126,59 @@ private:
     int _free_records;
     
     // Internal helper methods
+    int open_storage();
     int allocate_record_storage();
     void cleanup_record_storage();
     int find_free_record();
     void free_record(int index);
     char* get_record_data(int index);
     inline DataRecordEntry *get_record_entry(int index) { 
-       return (DataRecordEntry *)(_records_addr + sizeof(HashMasterHeader) + (_record_entry_size * index));
+       if (index < _config._max_record_count) {
+           return (DataRecordEntry *)(_records_addr + sizeof(HashMasterHeader) + (_record_entry_size * index));
+       }
+       return get_segment_entry(index);
+    }
+    DataRecordEntry* get_segment_entry(int index);
+    int record_capacity() const {
+        return _config._max_record_count << _segment_count.load(std::memory_order_acquire);
+    }
+    
+    // Live record bitmap
+    int map_live(const std::string& filename, size_t bytes, int* fd, void** addr, size_t* size, bool* fresh);
+    void rebuild_live_bitmap();
+    uint64_t* live_word(int index, uint64_t* mask);
+    inline void live_set(int index) {
+        uint64_t mask;
+        uint64_t* w = live_word(index, &mask);
+        if (w) __atomic_fetch_or(w, mask, __ATOMIC_RELEASE);
+    }
+    inline void live_clear(int index) {
+        uint64_t mask;
+        uint64_t* w = live_word(index, &mask);
+        if (w) __atomic_fetch_and(w, ~mask, __ATOMIC_RELEASE);
+    }
+    int next_live(int from, int end);
+    
+    // Growth
+    int map_segment(int segment, bool create);
+    void refresh_segments();
+    void cleanup_segments();
+    int grow_records();
+    void start_migration_thread();
+    void stop_migration_thread();
+    void migration_loop();
+    
+    // Record seqlock (single writer). begin은 홀수로 만들고 end는 다시 짝수로 만든다.
+    static inline void record_write_begin(DataRecordEntry* re) {
+        __atomic_fetch_or(&re->_version, (uint16_t)1, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
     }
+    static inline void record_write_end(DataRecordEntry* re) {
+        __atomic_fetch_add(&re->_version, (uint16_t)1, __ATOMIC_RELEASE);
+    }
+    DataRecordEntry* entry_from_record(char* record);
+    int read_record(HashTable* table, const char* key, char* out, int out_size);
+    int build_bulk(const MasterBulkRecord* records, int count, int* stored);
     
     // Lock management
     int init_master_locks();
@@ -115,10 +206,22 @@ public:
 
     // Main operations - implementing Master interface
     int put(const char* pkey, const char* skey, const char* record, int record_size) override;
+    // 새 파일 (<filename>.bulk_*) 을 lock 없이 한번에 만들고 rename 으로 교체한 뒤 다시 연다.
+    // count 가 max_record_count 를 넘으면 auto_grow 일 때만 put 으로 넣는다.
+    int bulk_load(const MasterBulkRecord* records, int count, int* loaded = nullptr) override;
     char* get_by_primary(const char* pkey) override;
     char* get_by_secondary(const char* skey) override;
     int del(const char* pkey) override;
 
+    // Seqlock snapshot reads / versioned in-place updates
+    int read_by_primary(const char* pkey, char* out, int out_size) override;
+    int read_by_secondary(const char* skey, char* out, int out_size) override;
+    void begin_record_update(char* record) override;
+    void end_record_update(char* record) override;
+
+    // index / record page 를 모두 미리 fault (MmapOptions::warm)
+    int warm() override;
+
     // Additional HashMaster-specific operations
     char* get(int field_index, const char* key);  // field_index: 0=primary, 1=secondary
     
@@ -154,6 +257,8 @@ public:
     // Record management
     char* add_record(const char* pkey, const char* skey, int record_size);
     int update_record(const char* pkey, const char* record, int record_size);
+    // secondary key 교체 (record 는 그대로). 새 key 가 이미 있으면 HASH_ERROR_KEY_EXISTS
+    int update_secondary_key(const char* pkey, const char* new_skey);
     int get_record_size(const char* pkey);
     
     // Sequential access
@@ -185,6 +290,7 @@ public:
     // Lock management
     void setUseLock(bool use_lock) override;
     bool getUseLock() const override { return _config._use_lock; }
+    void setLockFreeRead(bool enable) override;
     
     // Display and debugging
     void display_hashtable() const;
@@ -194,23 +300,40 @@ public:
     int defragment_records();
     int compact_storage();
     
-    // Iterator support (future enhancement)
-    class Iterator {
+    // Online resize: 레코드 용량을 new_max_record_count 이상으로 늘리고 인덱스를 새 generation으로 옮기기 시작한다.
+    // 옮기는 동안에도 get/put 은 계속 동작한다 (두 generation 모두 조회).
+    int resize(int new_max_record_count);
+    bool is_resizing();
+    int migrate_step(int max_entries);     // 남은 key를 최대 max_entries 개 옮긴다 (옮긴 수 반환)
+    int get_record_capacity() const { return record_capacity(); }
+    
+    // Live record 수 (bitmap popcount, 다른 프로세스가 쓴 레코드 포함)
+    int count_live_records();
+    
+    // Live record iterator: bitmap 에서 set bit 만 따라가므로 빈 slot 은 64개씩 건너뛴다.
+    // [start, end) 범위만 돈다. 여러 스레드로 나눠 돌 때는 range(part, parts) 를 쓴다.
+    // lock 을 잡지 않으므로 (get_record_by_seq 와 같이) 도는 중 지워진 레코드는 건너뛸 수 있다.
+    class Iterator : public Master::Iterator {
     private:
-        HashMaster* _master;
-        int _current_index;
+        HashMaster* _hash_master;
+        int _end;
+        int _index;     // 마지막으로 next() 가 돌려준 record index
         
     public:
-        Iterator(HashMaster* master, int start_index = 0) 
-            : _master(master), _current_index(start_index) {}
+        Iterator(HashMaster* master, int start_index = 0, int end_index = -1)
+            : Master::Iterator(master, start_index), _hash_master(master),
+              _end(end_index < 0 ? master->record_capacity() : end_index), _index(-1) {}
         
-        bool has_next();
-        char* next();
-        int get_current_index() const { return _current_index; }
+        bool has_next() override;
+        char* next() override;
+        int get_current_index() const override { return _index; }
     };
     
     Iterator begin() { return Iterator(this, 0); }
-    Iterator end() { return Iterator(this, _config._max_record_count); }
+    Iterator end() { return Iterator(this, record_capacity()); }
+    // 전체 용량을 parts 개로 나눈 part 번째 구간 (bitmap word 경계로 자름)
+    Iterator range(int part, int parts);
+    std::unique_ptr<Master::Iterator> create_iterator() override;
 };
 
 // Utility functions
@@ -0,0 +1,253 @@
+#include "HashMasterReader.h"
+#include "MmapOptions.h"
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace {
+
+// 쓰기 중 (_version 홀수) 레코드를 기다리는 최대 횟수 (그 뒤엔 busy 로 건너뜀)
+const int READ_MAX_SPINS = 4096;
+
+} // namespace
+
+HashMasterReader::HashMasterReader()
+    : _entry_size(0), _capacity(0), _use_live(false), _release_pages(true) {
+    memset(&_header, 0, sizeof(_header));
+}
+
+HashMasterReader::~HashMasterReader() {
+    close();
+}
+
+bool HashMasterReader::map_region(const std::string& path, size_t min_size, Region& r) {
+    r.fd = ::open(path.c_str(), O_RDONLY);
+    if (r.fd == -1) {
+        fprintf(stderr, "HashMasterReader: cannot open %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    struct stat st;
+    if (fstat(r.fd, &st) == -1 || (size_t)st.st_size < min_size) {
+        fprintf(stderr, "HashMasterReader: %s is smaller than expected (%zu bytes)\n", path.c_str(), min_size);
+        return false;
+    }
+    r.size = (size_t)st.st_size;
+    void* addr = mmap(NULL, r.size, PROT_READ, MAP_SHARED, r.fd, 0);
+    if (addr == MAP_FAILED) {
+        fprintf(stderr, "HashMasterReader: cannot map %s: %s\n", path.c_str(), strerror(errno));
+        return false;
+    }
+    r.addr = static_cast<char*>(addr);
+    return true;
+}
+
+// bitmap 파일 (offset 뒤 words 개 uint64) 이 없거나 짧으면 false
+bool HashMasterReader::map_live(const std::string& path, size_t offset, size_t words, Region& r) {
+    r.live_fd = ::open(path.c_str(), O_RDONLY);
+    if (r.live_fd == -1) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(r.live_fd, &st) == -1 || (size_t)st.st_size < offset + words * sizeof(uint64_t)) {
+        return false;
+    }
+    r.live_size = (size_t)st.st_size;
+    void* addr = mmap(NULL, r.live_size, PROT_READ, MAP_SHARED, r.live_fd, 0);
+    if (addr == MAP_FAILED) {
+        r.live_size = 0;
+        return false;
+    }
+    r.live = reinterpret_cast<const uint64_t*>(static_cast<char*>(addr) + offset);
+    return true;
+}
+
+void HashMasterReader::unmap_region(Region& r) {
+    if (r.addr) munmap(r.addr, r.size);
+    if (r.fd != -1) ::close(r.fd);
+    if (r.live) {
+        size_t offset = &_regions[0] == &r ? sizeof(HashMasterLiveHeader) : 0;
+        munmap(const_cast<char*>(reinterpret_cast<const char*>(r.live)) - offset, r.live_size);
+    }
+    if (r.live_fd != -1) ::close(r.live_fd);
+}
+
+bool HashMasterReader::open(const std::string& filename) {
+    close();
+    std::string base = "mmap/" + filename + "_records";
+
+    Region r;
+    memset(&r, 0, sizeof(r));
+    r.fd = r.live_fd = -1;
+    _regions.push_back(r);
+    if (!map_region(base + ".dat", sizeof(HashMasterHeader), _regions[0])) {
+        close();
+        return false;
+    }
+    memcpy(&_header, _regions[0].addr, sizeof(_header));
+    if (_header._max_record_count <= 0 || _header._max_record_size <= 0) {
+        fprintf(stderr, "HashMasterReader: %s.dat has no valid header\n", base.c_str());
+        close();
+        return false;
+    }
+    _entry_size = sizeof(DataRecordEntry) + _header._max_record_size;
+    const int B = _header._max_record_count;
+    _regions[0].first = 0;
+    _regions[0].count = B;
+    _regions[0].entries_offset = sizeof(HashMasterHeader);
+    if (_regions[0].size < sizeof(HashMasterHeader) + (size_t)B * _entry_size) {
+        fprintf(stderr, "HashMasterReader: %s.dat is truncated\n", base.c_str());
+        close();
+        return false;
+    }
+
+    // live bitmap: base 는 header 가 맞아야 하고, segment 는 모두 있어야 쓴다
+    _use_live = map_live(base + ".live", sizeof(HashMasterLiveHeader), ((size_t)B + 63) / 64, _regions[0]);
+    if (_use_live) {
+        const HashMasterLiveHeader* lh = reinterpret_cast<const HashMasterLiveHeader*>(
+            reinterpret_cast<const char*>(_regions[0].live) - sizeof(HashMasterLiveHeader));
+        _use_live = __atomic_load_n(&lh->_magic_number, __ATOMIC_ACQUIRE) == HASH_MASTER_LIVE_MAGIC &&
+                    lh->_max_record_count == B;
+    }
+
+    int segments = __atomic_load_n(&reinterpret_cast<const HashMasterHeader*>(_regions[0].addr)->_segment_count,
+                                   __ATOMIC_ACQUIRE);
+    if (segments > MAX_RECORD_SEGMENTS) segments = MAX_RECORD_SEGMENTS;
+    _capacity = B;
+    for (int k = 1; k <= segments; k++) {
+        Region seg;
+        memset(&seg, 0, sizeof(seg));
+        seg.fd = seg.live_fd = -1;
+        seg.first = B << (k - 1);
+        seg.count = B << (k - 1);
+        std::string name = base + "." + std::to_string(k);
+        if (!map_region(name + ".dat", (size_t)seg.count * _entry_size, seg)) {
+            unmap_region(seg);
+            break;
+        }
+        if (_use_live && !map_live(name + ".live", 0, ((size_t)seg.count + 63) / 64, seg)) {
+            _use_live = false;
+        }
+        _regions.push_back(seg);
+        _capacity = B << k;
+    }
+    return true;
+}
+
+void HashMasterReader::close() {
+    for (auto& r : _regions) {
+        unmap_region(r);
+    }
+    _regions.clear();
+    _capacity = 0;
+    _use_live = false;
+}
+
+const HashMasterReader::Region* HashMasterReader::region_of(int index) const {
+    if (index < 0 || index >= _capacity) return nullptr;
+    if (index < _header._max_record_count) return &_regions[0];
+    int k = 32 - __builtin_clz((unsigned)(index / _header._max_record_count));
+    return k < (int)_regions.size() ? &_regions[k] : nullptr;
+}
+
+int HashMasterReader::next_live(int from, int end) const {
+    if (from < 0) from = 0;
+    if (end > _capacity) end = _capacity;
+    while (from < end) {
+        const Region* r = region_of(from);
+        if (!r) return -1;
+        int limit = r->first + r->count < end ? r->first + r->count : end;
+        if (!_use_live) {
+            for (int i = from; i < limit; ++i) {
+                if (__atomic_load_n(&entry(*r, i)->_occupied, __ATOMIC_ACQUIRE)) return i;
+            }
+        } else {
+            size_t off = (size_t)(from - r->first);
+            size_t stop = (size_t)(limit - r->first);
+            size_t w = off >> 6;
+            uint64_t bits = __atomic_load_n(&r->live[w], __ATOMIC_ACQUIRE) & (~0ull << (off & 63));
+            for (;;) {
+                if (bits) {
+                    size_t i = (w << 6) + __builtin_ctzll(bits);
+                    if (i < stop) return r->first + (int)i;
+                    break;
+                }
+                if ((++w << 6) >= stop) break;
+                bits = __atomic_load_n(&r->live[w], __ATOMIC_ACQUIRE);
+            }
+        }
+        from = limit;
+    }
+    return -1;
+}
+
+bool HashMasterReader::read(int index, char* out, bool* busy) const {
+    if (busy) *busy = false;
+    const Region* r = region_of(index);
+    if (!r || !out) return false;
+    const DataRecordEntry* re = entry(*r, index);
+    for (int spins = 0; spins < READ_MAX_SPINS; ++spins) {
+        uint16_t before = __atomic_load_n(&re->_version, __ATOMIC_ACQUIRE);
+        if (before & 1) {
+            if (spins > 64) sched_yield();
+            continue;
+        }
+        bool occupied = re->_occupied;
+        memcpy(out, re->_value, _header._max_record_size);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&re->_version, __ATOMIC_RELAXED) == before) {
+            return occupied;
+        }
+    }
+    if (busy) *busy = true;
+    return false;
+}
+
+int HashMasterReader::scan(int from, int end, const RecordCallback& callback, int* busy) const {
+    if (from < 0) from = 0;
+    if (end > _capacity) end = _capacity;
+    std::vector<char> record(_header._max_record_size);
+    std::vector<unsigned char> pages;
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    int read_count = 0;
+    bool stop = false;
+
+    // region (base / segment) 단위로 나눠서 page residency 를 기록하고 읽은 뒤 새로 올린 page 만 놓는다
+    while (from < end && !stop) {
+        const Region* r = region_of(from);
+        if (!r) break;
+        int limit = r->first + r->count < end ? r->first + r->count : end;
+
+        size_t begin_off = r->entries_offset + (size_t)(from - r->first) * _entry_size;
+        size_t end_off = r->entries_offset + (size_t)(limit - r->first) * _entry_size;
+        size_t map_off = begin_off / page * page;
+        size_t map_len = (end_off < r->size ? end_off : r->size) - map_off;
+        bool track = _release_pages && mmap_residency(r->addr + map_off, map_len, pages);
+
+        for (int i = next_live(from, limit); i >= 0 && !stop; i = next_live(i + 1, limit)) {
+            bool is_busy = false;
+            if (read(i, record.data(), &is_busy)) {
+                read_count++;
+                stop = !callback(i, record.data());
+            } else if (is_busy && busy) {
+                (*busy)++;
+            }
+        }
+        if (track) {
+            mmap_release_cold(r->addr + map_off, map_len, r->fd, (off_t)map_off, pages);
+        }
+        from = limit;
+    }
+    return read_count;
+}
+
+int HashMasterReader::count_live() const {
+    int count = 0;
+    for (int i = next_live(0, _capacity); i >= 0; i = next_live(i + 1, _capacity)) {
+        count++;
+    }
+    return count;
+}
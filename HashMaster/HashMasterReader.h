@@ -0,0 +1,83 @@
+#ifndef HASH_MASTER_READER_H
+#define HASH_MASTER_READER_H
+
+#include "HashMaster.h"
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * @brief HashMaster 레코드 파일 읽기 전용 reader (viewer / 점검 도구용)
+ *
+ * HashMaster::init() 은 파일을 O_RDWR 로 열고 header / free list / live bitmap 을 고칠 수 있으므로
+ * 운영 중인 마스터를 볼 때는 이 reader 를 쓴다.
+ *  - mmap/<filename>_records.dat, segment (_records.<k>.dat), live bitmap (.live) 을 O_RDONLY / PROT_READ 로 매핑
+ *  - index (hash table) 파일은 열지 않는다 (key 조회 없음, key 필드 값으로 거르는 scan 만)
+ *  - 레코드는 seqlock (_version) 으로 복사해서 읽으므로 feed 가 쓰는 중에도 찢어진 값을 보지 않는다
+ *    (쓰기 중인 상태가 오래 계속되는 레코드 - 쓰다 죽은 writer 등 - 는 건너뛰고 busy 로 센다)
+ *  - live bitmap 이 없거나 용량이 다르면 (이전 파일) _occupied 를 직접 본다
+ *  - open 이후 늘어난 segment (auto_grow) 는 보이지 않는다
+ *  - 상태를 바꾸지 않으므로 여러 스레드가 서로 다른 구간을 동시에 scan 해도 된다
+ */
+class HashMasterReader {
+public:
+    // false 를 돌려주면 scan 중단
+    typedef std::function<bool(int index, const char* record)> RecordCallback;
+
+    HashMasterReader();
+    ~HashMasterReader();
+    HashMasterReader(const HashMasterReader&) = delete;
+    HashMasterReader& operator=(const HashMasterReader&) = delete;
+
+    /* filename: HashMaster config 의 _filename (mmap/ 아래 base 이름) */
+    bool open(const std::string& filename);
+    void close();
+    bool is_open() const { return !_regions.empty(); }
+
+    const HashMasterHeader& header() const { return _header; }
+    int capacity() const { return _capacity; }
+    int record_size() const { return _header._max_record_size; }
+    int segment_count() const { return static_cast<int>(_regions.size()) - 1; }
+    bool has_live_bitmap() const { return _use_live; }
+
+    /* scan 이 새로 올린 page cache 를 chunk 마다 놓아줌 (기본 true) */
+    void set_release_pages(bool release) { _release_pages = release; }
+
+    /* [from, end) 의 첫 live 레코드 (없으면 -1) */
+    int next_live(int from, int end) const;
+    /* index 레코드를 out (record_size 바이트) 에 일관된 snapshot 으로 복사, 비었거나 busy 면 false */
+    bool read(int index, char* out, bool* busy = nullptr) const;
+    /* [from, end) 의 live 레코드를 index 순서로 callback (record 는 callback 안에서만 유효), 읽은 수 반환 */
+    int scan(int from, int end, const RecordCallback& callback, int* busy = nullptr) const;
+    int count_live() const;
+
+private:
+    struct Region {
+        int fd;
+        char* addr;
+        size_t size;
+        int first;              // 첫 record index
+        int count;
+        size_t entries_offset;  // 파일 안 첫 entry 위치 (base 는 HashMasterHeader 뒤)
+        int live_fd;
+        const uint64_t* live;
+        size_t live_size;
+    };
+
+    std::vector<Region> _regions;       // [0] base, [k] segment k
+    HashMasterHeader _header;
+    size_t _entry_size;
+    int _capacity;
+    bool _use_live;
+    bool _release_pages;
+
+    const Region* region_of(int index) const;
+    const DataRecordEntry* entry(const Region& r, int index) const {
+        return reinterpret_cast<const DataRecordEntry*>(r.addr + r.entries_offset + (size_t)(index - r.first) * _entry_size);
+    }
+    bool map_region(const std::string& path, size_t min_size, Region& r);
+    bool map_live(const std::string& path, size_t offset, size_t words, Region& r);
+    void unmap_region(Region& r);
+};
+
+#endif // HASH_MASTER_READER_H
@@ -1,5 +1,7 @@
 #include "HashTable.h"
 #include "Master.h"
+#include "BulkLoad.h"
+#include "../common/AsyncLog.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <fcntl.h>
@@ -11,16 +13,55 @@
 #include <iostream>
 #include <algorithm>
 #include <climits>
+#include <vector>
+#include <sched.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// v2 tag group matching: ctrl[0..15] 중 b 와 같은 byte 위치를 bitmask로 반환
+static inline uint32_t match_group(const int8_t* ctrl, int8_t b) {
+#ifdef __SSE2__
+    __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+    return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(b)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < HASH_GROUP_WIDTH; i++) {
+        if (ctrl[i] == b) mask |= (1u << i);
+    }
+    return mask;
+#endif
+}
+
+// EMPTY/DELETED 는 최상위 bit가 1, FULL(tag)은 0
+static inline uint32_t match_empty_or_deleted(const int8_t* ctrl) {
+#ifdef __SSE2__
+    return (uint32_t)_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)));
+#else
+    uint32_t mask = 0;
+    for (int i = 0; i < HASH_GROUP_WIDTH; i++) {
+        if (ctrl[i] < 0) mask |= (1u << i);
+    }
+    return mask;
+#endif
+}
+
 
 // Constructor
 HashTable::HashTable(int hash_count, int field_len, int data_count, bool use_lock, 
                      const char* filename, bool is_char)
     : _fd_hash_index_table(-1), _fd_data_index_table(-1),
       _hash_index_table_addr(MAP_FAILED), _data_index_table_addr(MAP_FAILED),
+      _fd_reverse_index(-1), _reverse_index_addr(MAP_FAILED), _reverse(nullptr),
       _hash_count(hash_count), _data_count(data_count), _field_len(field_len),
-      _use_lock(use_lock), _is_char(is_char),
+      _hash_map_size(0), _data_map_size(0), _reverse_map_size(0),
+      _use_lock(use_lock), _is_char(is_char), _lock_free_read(false),
+      _index_version(HASH_INDEX_V1_CHAINED), _requested_version(HASH_INDEX_V1_CHAINED),
+      _capacity(0), _group_count(0), _ctrl(nullptr), _slots(nullptr),
       _hash_index_table(nullptr), _data_index_table(nullptr),
-      _initialized(false), _hash_function(nullptr), _log_level(LOG_INFO) {
+      _initialized(false), _hash_function(nullptr), _builtin_hash(hash_djb2),
+      _hash_func_id(HASH_FUNC_DJB2), _file_hash_func_id(-1),
+      _generation(0), _next(nullptr), _migration_cursor(0), _log_level(LOG_INFO) {
     
     // Input validation
     if (hash_count <= 0 || field_len <= 0 || data_count <= 0) {
@@ -40,9 +81,10 @@ HashTable::HashTable(int hash_count, int field_len, int data_count, bool use_loc
     } else {
         snprintf(_filename, sizeof(_filename), "hashtable");
     }
+    snprintf(_base_filename, sizeof(_base_filename), "%s", _filename);
     
     // Set default hash function
-    _hash_function = nullptr;  // Will use default_hash method
+    _hash_function = nullptr;  // Will use built-in (_builtin_hash)
     
     // Initialize rwlock attributes
     memset(&_rwlock, 0, sizeof(_rwlock));
@@ -59,24 +101,33 @@ HashTable::~HashTable() {
 
 // Resource cleanup
 void HashTable::cleanup_resources() {
+    // 다음 generation 먼저 정리
+    delete _next.exchange(nullptr);
+    
     // Destroy locks first
     destroy_locks();
     
     // Unmap memory
     if (_hash_index_table_addr != MAP_FAILED) {
-        if (munmap(_hash_index_table_addr, _hash_table_size) == -1) {
+        if (munmap(_hash_index_table_addr, _hash_map_size) == -1) {
             log(LOG_ERROR, "Failed to unmap hash index table: %s", strerror(errno));
         }
         _hash_index_table_addr = MAP_FAILED;
     }
     
     if (_data_index_table_addr != MAP_FAILED) {
-        if (munmap(_data_index_table_addr, _data_table_size) == -1) {
+        if (munmap(_data_index_table_addr, _data_map_size) == -1) {
             log(LOG_ERROR, "Failed to unmap data index table: %s", strerror(errno));
         }
         _data_index_table_addr = MAP_FAILED;
     }
     
+    if (_reverse_index_addr != MAP_FAILED) {
+        munmap(_reverse_index_addr, _reverse_map_size);
+        _reverse_index_addr = MAP_FAILED;
+        _reverse = nullptr;
+    }
+    
     // Close file descriptors
     if (_fd_hash_index_table != -1) {
         close(_fd_hash_index_table);
@@ -88,9 +139,16 @@ void HashTable::cleanup_resources() {
         _fd_data_index_table = -1;
     }
     
+    if (_fd_reverse_index != -1) {
+        close(_fd_reverse_index);
+        _fd_reverse_index = -1;
+    }
+    
     // Reset pointers
     _hash_index_table = nullptr;
     _data_index_table = nullptr;
+    _ctrl = nullptr;
+    _slots = nullptr;
     _initialized = false;
 }
 
@@ -111,6 +169,26 @@ int HashTable::init() {
     // Set up pointers
     _hash_index_table = (HashIndexTable*)_hash_index_table_addr;
     _data_index_table = (DataIndexEntry*)_data_index_table_addr;
+    if (_index_version == HASH_INDEX_V2_OPEN_ADDRESSING) {
+        _ctrl = (int8_t*)_hash_index_table_addr + v2_ctrl_offset();
+        _slots = (HashSlotV2*)((char*)_hash_index_table_addr + v2_slots_offset(_capacity));
+    }
+    
+    // reverse index 가 이 index 와 맞지 않으면 (새 파일 / 이전 버전 파일) 다시 만든다
+    if (_reverse) {
+        const HashReverseHeader* header = (const HashReverseHeader*)_reverse_index_addr;
+        if (__atomic_load_n(&header->_magic_number, __ATOMIC_ACQUIRE) != HASH_REVERSE_MAGIC ||
+            header->_data_count != _data_count) {
+            rebuild_reverse_index();
+        }
+    }
+    
+    // 기존 파일의 hash 함수 확인
+    ret = adopt_file_hash_function();
+    if (ret != HASH_OK) {
+        cleanup_resources();
+        return ret;
+    }
     
     // Initialize locks
     if (_use_lock) {
@@ -125,10 +203,17 @@ int HashTable::init() {
     // Validate file integrity
     if (!validate_file_integrity()) {
         log(LOG_INFO, "File integrity check failed, initializing new hash table");
+        _hash_index_table->_forward = 0;
         clear();
     }
     
     _initialized = true;
+    
+    // 이전 실행에서 resize 되었으면 다음 generation도 연다 (migration 중이면 이어서 진행)
+    if (forward_generation() != 0 && !next_generation()) {
+        log(LOG_ERROR, "Failed to open next generation %d of %s", forward_generation(), _base_filename);
+    }
+    
     log(LOG_INFO, "HashTable initialized successfully");
     return HASH_OK;
 }
@@ -149,20 +234,28 @@ int HashTable::allocate_files() {
         return HASH_ERROR_FILE_ERROR;
     }
     
+    // 기존 파일이 유효한 v1/v2 이면 그 포맷을, 아니면 요청된 포맷을 사용
+    setup_layout(detect_index_version());
+    
     // Set file size
-    if (ftruncate(_fd_hash_index_table, _hash_table_size) == -1) {
+    _hash_map_size = mmap_map_size(_fd_hash_index_table, _hash_table_size);
+    if (ftruncate(_fd_hash_index_table, _hash_map_size) == -1) {
         log(LOG_ERROR, "Failed to set hash index file size: %s", strerror(errno));
         return HASH_ERROR_FILE_ERROR;
     }
     
     // Map hash index file
-    _hash_index_table_addr = mmap(NULL, _hash_table_size, 
-                                  PROT_READ | PROT_WRITE, MAP_SHARED, 
+    _hash_index_table_addr = mmap(NULL, _hash_map_size, 
+                                  PROT_READ | PROT_WRITE, mmap_flags(_mmap_options), 
                                   _fd_hash_index_table, 0);
     if (_hash_index_table_addr == MAP_FAILED) {
         log(LOG_ERROR, "Failed to map hash index file: %s", strerror(errno));
         return HASH_ERROR_MEMORY_ERROR;
     }
+    const char* failed = mmap_apply_options(_hash_index_table_addr, _hash_map_size, _mmap_options);
+    if (failed) {
+        log(LOG_WARNING, "%s failed for %s: %s", failed, hash_filename, strerror(errno));
+    }
     
     // Create data index file
     _fd_data_index_table = open(data_filename, O_RDWR | O_CREAT, 0644);
@@ -173,23 +266,191 @@ int HashTable::allocate_files() {
     }
     
     // Set file size
-    if (ftruncate(_fd_data_index_table, _data_table_size) == -1) {
+    _data_map_size = mmap_map_size(_fd_data_index_table, _data_table_size);
+    if (ftruncate(_fd_data_index_table, _data_map_size) == -1) {
         log(LOG_ERROR, "Failed to set data index file size: %s", strerror(errno));
         return HASH_ERROR_FILE_ERROR;
     }
     
     // Map data index file
-    _data_index_table_addr = mmap(NULL, _data_table_size, 
-                                  PROT_READ | PROT_WRITE, MAP_SHARED, 
+    _data_index_table_addr = mmap(NULL, _data_map_size, 
+                                  PROT_READ | PROT_WRITE, mmap_flags(_mmap_options), 
                                   _fd_data_index_table, 0);
     if (_data_index_table_addr == MAP_FAILED) {
         log(LOG_ERROR, "Failed to map data index file: %s", strerror(errno));
         return HASH_ERROR_MEMORY_ERROR;
     }
+    failed = mmap_apply_options(_data_index_table_addr, _data_map_size, _mmap_options);
+    if (failed) {
+        log(LOG_WARNING, "%s failed for %s: %s", failed, data_filename, strerror(errno));
+    }
+    
+    // reverse index 는 없어도 동작하므로 (scan) 실패해도 계속한다
+    if (allocate_reverse_index() != HASH_OK) {
+        log(LOG_WARNING, "Reverse index unavailable for %s, find_key_by_data_index will scan", _filename);
+    }
+    
+    return HASH_OK;
+}
+
+// Create / map reverse index file (dataIndex -> DataIndexEntry slot)
+int HashTable::allocate_reverse_index() {
+    char reverse_filename[512];
+    snprintf(reverse_filename, sizeof(reverse_filename), "mmap/%s.revindex", _filename);
+    
+    _fd_reverse_index = open(reverse_filename, O_RDWR | O_CREAT, 0644);
+    if (_fd_reverse_index == -1) {
+        log(LOG_ERROR, "Failed to create reverse index file %s: %s", reverse_filename, strerror(errno));
+        return HASH_ERROR_FILE_ERROR;
+    }
+    
+    _reverse_map_size = mmap_map_size(_fd_reverse_index, sizeof(HashReverseHeader) + (size_t)_data_count * sizeof(int));
+    if (ftruncate(_fd_reverse_index, _reverse_map_size) == -1) {
+        log(LOG_ERROR, "Failed to set reverse index file size: %s", strerror(errno));
+        return HASH_ERROR_FILE_ERROR;
+    }
+    
+    _reverse_index_addr = mmap(NULL, _reverse_map_size, PROT_READ | PROT_WRITE,
+                               mmap_flags(_mmap_options), _fd_reverse_index, 0);
+    if (_reverse_index_addr == MAP_FAILED) {
+        log(LOG_ERROR, "Failed to map reverse index file: %s", strerror(errno));
+        return HASH_ERROR_MEMORY_ERROR;
+    }
+    const char* failed = mmap_apply_options(_reverse_index_addr, _reverse_map_size, _mmap_options);
+    if (failed) {
+        log(LOG_WARNING, "%s failed for %s: %s", failed, reverse_filename, strerror(errno));
+    }
     
+    _reverse = (int*)((char*)_reverse_index_addr + sizeof(HashReverseHeader));
     return HASH_OK;
 }
 
+// data index 를 한번 훑어 reverse index 를 다시 만든다 (새 파일, 이전 버전에서 만든 index)
+void HashTable::rebuild_reverse_index() {
+    if (!_reverse) {
+        return;
+    }
+    
+    HashReverseHeader* header = (HashReverseHeader*)_reverse_index_addr;
+    header->_magic_number = 0;
+    for (int i = 0; i < _data_count; i++) {
+        _reverse[i] = -1;
+    }
+    for (int i = 0; i < _data_count; i++) {
+        DataIndexEntry* de = get_data_entry(i);
+        if (de && de->occupied) {
+            set_reverse(de->dataIndex, i);
+        }
+    }
+    header->_data_count = _data_count;
+    __atomic_store_n(&header->_magic_number, HASH_REVERSE_MAGIC, __ATOMIC_RELEASE);
+    log(LOG_INFO, "Reverse index rebuilt: %s", _filename);
+}
+
+// v2 layout helpers
+int HashTable::v2_capacity_for(int data_count) {
+    // load factor 7/8 이하, 최소 1 group
+    long need = (long)data_count * 8 / 7 + 1;
+    int capacity = HASH_GROUP_WIDTH;
+    while (capacity < need) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+int HashTable::v2_ctrl_offset() {
+    return (int)((sizeof(HashIndexTable) + 63) & ~(size_t)63);
+}
+
+int HashTable::v2_slots_offset(int capacity) {
+    return v2_ctrl_offset() + ((capacity + 63) & ~63);
+}
+
+// 기존 hash index 파일 헤더를 읽어 현재 설정과 맞는 포맷인지 확인
+int HashTable::detect_index_version() {
+    struct stat st;
+    if (fstat(_fd_hash_index_table, &st) == 0 && st.st_size >= (off_t)sizeof(HashIndexTable)) {
+        int header[sizeof(HashIndexTable) / sizeof(int)];
+        if (pread(_fd_hash_index_table, header, sizeof(header), 0) == (ssize_t)sizeof(header)) {
+            const HashIndexTable* h = reinterpret_cast<const HashIndexTable*>(header);
+            bool same = h->_magic_number == HASH_INDEX_MAGIC &&
+                        h->_data_count == _data_count &&
+                        h->_field_len == _field_len &&
+                        h->_is_char_key == (_is_char ? 1 : 0);
+            if (same && h->_version == HASH_INDEX_V1_CHAINED && h->_hash_count == _hash_count) {
+                _file_hash_func_id = h->_hash_func_id;
+                return HASH_INDEX_V1_CHAINED;
+            }
+            if (same && h->_version == HASH_INDEX_V2_OPEN_ADDRESSING &&
+                h->_hash_count == v2_capacity_for(_data_count)) {
+                _file_hash_func_id = h->_hash_func_id;
+                return HASH_INDEX_V2_OPEN_ADDRESSING;
+            }
+        }
+    }
+    _file_hash_func_id = -1;
+    return _requested_version;
+}
+
+// 유효한 기존 파일이면 헤더에 기록된 hash 함수를 사용한다.
+// writer와 reader가 서로 다른 함수로 조회하면 key를 찾지 못하므로 파일 쪽을 우선한다.
+int HashTable::adopt_file_hash_function() {
+    if (_file_hash_func_id < 0 || _file_hash_func_id == _hash_func_id) {
+        return HASH_OK;
+    }
+    
+    if (_file_hash_func_id == HASH_FUNC_CUSTOM) {
+        log(LOG_ERROR, "%s was built with a custom hash function; call setHashFunction() before init()", _filename);
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    HashFunction func = get_builtin_hash_function(_file_hash_func_id);
+    if (!func) {
+        log(LOG_ERROR, "%s uses unknown hash function id %d", _filename, _file_hash_func_id);
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    log(LOG_WARNING, "%s uses hash function %s (requested %s), using the file's",
+        _filename, hash_function_name(_file_hash_func_id), hash_function_name(_hash_func_id));
+    _hash_function = nullptr;
+    _builtin_hash = func;
+    _hash_func_id = _file_hash_func_id;
+    return HASH_OK;
+}
+
+int HashTable::setHashFunctionId(int id) {
+    if (_initialized) {
+        log(LOG_ERROR, "Hash function must be set before init()");
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    HashFunction func = get_builtin_hash_function(id);
+    if (!func) {
+        log(LOG_ERROR, "Unknown hash function id %d", id);
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    _hash_function = nullptr;
+    _builtin_hash = func;
+    _hash_func_id = id;
+    return HASH_OK;
+}
+
+void HashTable::setup_layout(int version) {
+    if (version == HASH_INDEX_V2_OPEN_ADDRESSING) {
+        _index_version = HASH_INDEX_V2_OPEN_ADDRESSING;
+        _capacity = v2_capacity_for(_data_count);
+        _group_count = _capacity / HASH_GROUP_WIDTH;
+        _hash_table_size = v2_slots_offset(_capacity) + _capacity * (int)sizeof(HashSlotV2);
+    } else {
+        _index_version = HASH_INDEX_V1_CHAINED;
+        _capacity = 0;
+        _group_count = 0;
+        _hash_table_size = sizeof(HashIndexTable) + _hash_count * sizeof(HashEntry);
+    }
+    log(LOG_DEBUG, "Index format v%d, hash index size %d", _index_version, _hash_table_size);
+}
+
 // Lock initialization
 int HashTable::init_locks() {
     pthread_rwlockattr_t attr;
@@ -227,31 +488,59 @@ void HashTable::destroy_locks() {
     }
 }
 
+// index 파일 page 를 모두 미리 fault (MmapOptions::warm)
+int HashTable::warm() {
+    if (!_initialized) {
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    mmap_prefault(_hash_index_table_addr, _hash_map_size);
+    mmap_prefault(_data_index_table_addr, _data_map_size);
+    if (_reverse) {
+        mmap_prefault(_reverse_index_addr, _reverse_map_size);
+    }
+    
+    HashTable* next = forward_generation() != 0 ? next_generation() : nullptr;
+    return next ? next->warm() : HASH_OK;
+}
+
 // Clear hash table
 int HashTable::clear() {
     if (!_initialized && !_hash_index_table) {
         return HASH_ERROR_INVALID_PARAMETER;
     }
     
+    // resize 된 적이 있으면 generation 연결은 유지하고 최신 generation까지 모두 비운다
+    int forward = forward_generation();
+    HashTable* next = forward != 0 ? next_generation() : nullptr;
+    
     if (_use_lock) {
         pthread_rwlock_wrlock(&_rwlock);
     }
+    write_begin();
     
     // Initialize header
     _hash_index_table->_first_free_slot = 0;
-    _hash_index_table->_magic_number = 0x48415348;
-    _hash_index_table->_version = 1;
-    _hash_index_table->_hash_count = _hash_count;
+    _hash_index_table->_magic_number = HASH_INDEX_MAGIC;
+    _hash_index_table->_version = _index_version;
+    _hash_index_table->_hash_count = _index_version == HASH_INDEX_V2_OPEN_ADDRESSING ? _capacity : _hash_count;
     _hash_index_table->_data_count = _data_count;
     _hash_index_table->_field_len = _field_len;
     _hash_index_table->_is_char_key = _is_char ? 1 : 0;
-    _hash_index_table->_reserved[0] = 0;
-    _hash_index_table->_reserved[1] = 0;
-    _hash_index_table->_reserved[2] = 0;
+    _hash_index_table->_hash_func_id = _hash_func_id;
+    _hash_index_table->_forward = next ? -abs(forward) : 0;
     
     // Initialize hash entries
-    for (int i = 0; i < _hash_count; i++) {
-        _hash_index_table->_hash_entries[i].index = -1;
+    if (_index_version == HASH_INDEX_V2_OPEN_ADDRESSING) {
+        memset(_ctrl, HASH_CTRL_EMPTY, _capacity);
+        for (int i = 0; i < _capacity; i++) {
+            _slots[i].hash = 0;
+            _slots[i].entry = -1;
+        }
+    } else {
+        for (int i = 0; i < _hash_count; i++) {
+            _hash_index_table->_hash_entries[i].index = -1;
+        }
     }
     
     // Initialize data entries and free list
@@ -265,11 +554,19 @@ int HashTable::clear() {
             memset(de->value, 0, _field_len);
         }
     }
+    for (int i = 0; _reverse && i < _data_count; i++) {
+        _reverse[i] = -1;
+    }
     
+    write_end();
     if (_use_lock) {
         pthread_rwlock_unlock(&_rwlock);
     }
     
+    if (next) {
+        next->clear();
+    }
+    
     log(LOG_INFO, "HashTable cleared successfully");
     return HASH_OK;
 }
@@ -289,25 +586,9 @@ const DataIndexEntry* HashTable::get_data_entry(int index) const {
     return (const DataIndexEntry*)((const char*)_data_index_table_addr + index * _sizeof_data_entry);
 }
 
-// Hash functions
-uint32_t HashTable::djb2_hash(const char* key, int len) {
-    uint32_t hash = 5381;
-    for (int i = 0; i < len; i++) {
-        hash = ((hash << 5) + hash) + (unsigned char)key[i];
-    }
-    return hash % _hash_count;
-}
-
-uint32_t HashTable::djb2_string_hash(const char* key, int len) {
-    uint32_t hash = 5381;
-    for (int i = 0; i < len && key[i] != '\0'; i++) {
-        hash = ((hash << 5) + hash) + (unsigned char)key[i];
-    }
-    return hash % _hash_count;
-}
-
-uint32_t HashTable::default_hash(const char* key, int len) {
-    return _is_char ? djb2_string_hash(key, len) : djb2_hash(key, len);
+// v2 fingerprint: 전체 32-bit hash (slot에 저장하여 key 비교 전에 걸러낸다)
+uint32_t HashTable::fingerprint(const char* key) {
+    return hash_mix32(_hash_function ? _hash_function(key, _field_len) : raw_hash(key));
 }
 
 // Validation methods
@@ -355,9 +636,23 @@ int HashTable::put(const char* key, int dataIndex) {
         return HASH_ERROR_INVALID_PARAMETER;
     }
     
+    // resize 이후의 새 key는 다음 generation에 넣고, migration을 조금씩 진행한다
+    int forward = forward_generation();
+    if (forward != 0) {
+        HashTable* next = next_generation();
+        if (next) {
+            int result = next->put(key, dataIndex);
+            if (forward > 0) {
+                migrate(HASH_MIGRATE_BATCH);
+            }
+            return result;
+        }
+    }
+    
     if (_use_lock) {
         pthread_rwlock_wrlock(&_rwlock);
     }
+    write_begin();
     
     int result = HASH_OK;
     
@@ -382,19 +677,37 @@ int HashTable::put(const char* key, int dataIndex) {
         de->occupied = 1;
         de->dataIndex = dataIndex;
         copy(de->value, key, _field_len);
+        set_reverse(dataIndex, index);
         
         // Update free slot list
         _hash_index_table->_first_free_slot = de->nextEmpty;
         
-        // Insert into hash chain
-        uint32_t hash_value = _hash_function ? _hash_function(key, _field_len) : default_hash(key, _field_len);
-        de->nextIndex = _hash_index_table->_hash_entries[hash_value].index;
-        _hash_index_table->_hash_entries[hash_value].index = index;
-        
-        log(LOG_DEBUG, "Put key at index %d, hash %u, dataIndex %d", index, hash_value, dataIndex);
+        if (_index_version == HASH_INDEX_V2_OPEN_ADDRESSING) {
+            // Insert into open addressing slot
+            int pos = insert_slot_v2(fingerprint(key), index);
+            if (pos < 0) {
+                // capacity > data_count 이므로 발생하지 않아야 함
+                log(LOG_ERROR, "No free open addressing slot for index %d", index);
+                de->occupied = 0;
+                clear_reverse(dataIndex, index);
+                _hash_index_table->_first_free_slot = index;
+                result = HASH_ERROR_NO_SPACE;
+                break;
+            }
+            de->nextIndex = -1;
+            log(LOG_DEBUG, "Put key at index %d, slot %d, dataIndex %d", index, pos, dataIndex);
+        } else {
+            // Insert into hash chain
+            uint32_t hash_value = bucket_of(key);
+            de->nextIndex = _hash_index_table->_hash_entries[hash_value].index;
+            _hash_index_table->_hash_entries[hash_value].index = index;
+            
+            log(LOG_DEBUG, "Put key at index %d, hash %u, dataIndex %d", index, hash_value, dataIndex);
+        }
         
     } while (0);
     
+    write_end();
     if (_use_lock) {
         pthread_rwlock_unlock(&_rwlock);
     }
@@ -413,36 +726,199 @@ int HashTable::get(const char* key) {
         return HASH_ERROR_INVALID_PARAMETER;
     }
     
+    // resize 중이면 이전 generation을 먼저 본다 (writer는 새 generation에 넣은 뒤 이전 것을 지움)
+    int forward = forward_generation();
+    if (forward != 0) {
+        HashTable* next = next_generation();
+        if (next) {
+            if (forward > 0) {
+                int result = get_local(key);
+                if (result != HASH_ERROR_KEY_NOT_FOUND) {
+                    return result;
+                }
+            }
+            return next->get(key);
+        }
+    }
+    
+    return get_local(key);
+}
+
+// Lookup in this generation only
+int HashTable::get_local(const char* key) {
+    if (_lock_free_read) {
+        // seqlock read: 쓰기 중(홀수)이면 대기, 읽은 뒤 카운터가 바뀌었으면 재시도
+        const uint32_t* seq = &_hash_index_table->_write_seq;
+        for (int spins = 0; ; ++spins) {
+            uint32_t before = __atomic_load_n(seq, __ATOMIC_ACQUIRE);
+            if (before & 1) {
+                if (spins > 64) sched_yield();
+                continue;
+            }
+            int result = lookup(key, true);
+            __atomic_thread_fence(__ATOMIC_ACQUIRE);
+            if (__atomic_load_n(seq, __ATOMIC_RELAXED) == before) {
+                return result;
+            }
+        }
+    }
+    
     if (_use_lock) {
         pthread_rwlock_rdlock(&_rwlock);
     }
     
-    int result = HASH_ERROR_KEY_NOT_FOUND;
+    int result = lookup(key, false);
+    
+    if (_use_lock) {
+        pthread_rwlock_unlock(&_rwlock);
+    }
+    
+    return result;
+}
+
+// Chain lookup (caller handles locking / seqlock validation)
+// racy=true 이면 writer와 동시에 읽을 수 있으므로 깨진 chain을 만나도 로그 없이 멈춘다.
+int HashTable::lookup(const char* key, bool racy) {
+    if (_index_version == HASH_INDEX_V2_OPEN_ADDRESSING) {
+        int pos = find_slot_v2(key, fingerprint(key), racy);
+        if (pos < 0) {
+            return HASH_ERROR_KEY_NOT_FOUND;
+        }
+        // racy 모드에서는 find 이후 slot이 지워졌을 수 있다 (seqlock 검증에서 재시도)
+        int entry = __atomic_load_n(&_slots[pos].entry, __ATOMIC_RELAXED);
+        if (entry < 0 || entry >= _data_count) {
+            return HASH_ERROR_KEY_NOT_FOUND;
+        }
+        const DataIndexEntry* de = (const DataIndexEntry*)((const char*)_data_index_table_addr + entry * _sizeof_data_entry);
+        return de->dataIndex;
+    }
     
-    uint32_t hash_value = _hash_function ? _hash_function(key, _field_len) : default_hash(key, _field_len);
-    int index = _hash_index_table->_hash_entries[hash_value].index;
+    uint32_t hash_value = bucket_of(key);
+    int index = __atomic_load_n(&_hash_index_table->_hash_entries[hash_value].index, __ATOMIC_RELAXED);
+    int steps = 0;
     
     while (index != -1) {
-        DataIndexEntry* de = get_data_entry(index);
-        if (!de) {
-            log(LOG_ERROR, "Invalid data entry at index %d", index);
+        if (index < 0 || index >= _data_count || steps++ >= _data_count) {
+            if (!racy) {
+                log(LOG_ERROR, "Invalid data entry at index %d", index);
+            }
             break;
         }
+        const DataIndexEntry* de = (const DataIndexEntry*)((const char*)_data_index_table_addr + index * _sizeof_data_entry);
         
         if (de->occupied && compare(de->value, key, _field_len) == 0) {
-            result = de->dataIndex;
-            log(LOG_DEBUG, "Found key at index %d, dataIndex %d", index, result);
-            break;
+            int result = de->dataIndex;
+            if (!racy) {
+                log(LOG_DEBUG, "Found key at index %d, dataIndex %d", index, result);
+            }
+            return result;
         }
         
-        index = de->nextIndex;
+        index = __atomic_load_n(&de->nextIndex, __ATOMIC_RELAXED);
     }
     
-    if (_use_lock) {
-        pthread_rwlock_unlock(&_rwlock);
+    return HASH_ERROR_KEY_NOT_FOUND;
+}
+
+// v2: key가 들어있는 slot 위치 검색 (없으면 -1)
+// group 단위(16 slot)로 tag를 한번에 비교하고, EMPTY가 있는 group에서 탐색을 끝낸다.
+int HashTable::find_slot_v2(const char* key, uint32_t fp, bool racy) {
+    const int8_t tag = (int8_t)(fp >> 25);
+    const uint32_t group_mask = (uint32_t)_group_count - 1;
+    uint32_t group = fp & group_mask;
+    
+    for (int probe = 0; probe < _group_count; probe++) {
+        const int8_t* ctrl = _ctrl + group * HASH_GROUP_WIDTH;
+        uint32_t match = match_group(ctrl, tag);
+        while (match) {
+            int pos = group * HASH_GROUP_WIDTH + __builtin_ctz(match);
+            match &= match - 1;
+            
+            if (_slots[pos].hash != fp) {
+                continue;
+            }
+            int entry = __atomic_load_n(&_slots[pos].entry, __ATOMIC_RELAXED);
+            if (entry < 0 || entry >= _data_count) {
+                if (!racy) {
+                    log(LOG_ERROR, "Invalid data entry %d at slot %d", entry, pos);
+                }
+                continue;
+            }
+            const DataIndexEntry* de = (const DataIndexEntry*)((const char*)_data_index_table_addr + entry * _sizeof_data_entry);
+            if (de->occupied && compare(de->value, key, _field_len) == 0) {
+                return pos;
+            }
+        }
+        if (match_group(ctrl, HASH_CTRL_EMPTY)) {
+            return -1;
+        }
+        // triangular probing: 2의 거듭제곱 group 수에서 모든 group을 한번씩 방문
+        group = (group + probe + 1) & group_mask;
+    }
+    return -1;
+}
+
+// v2: 첫번째 EMPTY/DELETED slot에 기록. slot 내용을 먼저 쓰고 ctrl byte를 마지막에 공개한다.
+int HashTable::insert_slot_v2(uint32_t fp, int entry) {
+    const uint32_t group_mask = (uint32_t)_group_count - 1;
+    uint32_t group = fp & group_mask;
+    
+    for (int probe = 0; probe < _group_count; probe++) {
+        int8_t* ctrl = _ctrl + group * HASH_GROUP_WIDTH;
+        uint32_t avail = match_empty_or_deleted(ctrl);
+        if (avail) {
+            int pos = group * HASH_GROUP_WIDTH + __builtin_ctz(avail);
+            _slots[pos].hash = fp;
+            _slots[pos].entry = entry;
+            __atomic_store_n(&_ctrl[pos], (int8_t)(fp >> 25), __ATOMIC_RELEASE);
+            return pos;
+        }
+        group = (group + probe + 1) & group_mask;
+    }
+    return -1;
+}
+
+int HashTable::del_v2(const char* key) {
+    int pos = find_slot_v2(key, fingerprint(key), false);
+    if (pos < 0) {
+        return HASH_ERROR_KEY_NOT_FOUND;
     }
     
-    return result;
+    int index = _slots[pos].entry;
+    DataIndexEntry* de = get_data_entry(index);
+    if (!de) {
+        return HASH_ERROR_MEMORY_ERROR;
+    }
+    
+    // group에 EMPTY가 남아있으면 이 group을 지나쳐 간 탐색이 없으므로 EMPTY로 되돌릴 수 있다
+    const int8_t* group_ctrl = _ctrl + (pos / HASH_GROUP_WIDTH) * HASH_GROUP_WIDTH;
+    int8_t mark = match_group(group_ctrl, HASH_CTRL_EMPTY) ? HASH_CTRL_EMPTY : HASH_CTRL_DELETED;
+    __atomic_store_n(&_ctrl[pos], mark, __ATOMIC_RELEASE);
+    _slots[pos].entry = -1;
+    
+    // Mark as free and add to free list
+    de->occupied = 0;
+    clear_reverse(de->dataIndex, index);
+    de->nextEmpty = _hash_index_table->_first_free_slot;
+    _hash_index_table->_first_free_slot = index;
+    
+    log(LOG_DEBUG, "Deleted key at index %d, slot %d", index, pos);
+    return HASH_OK;
+}
+
+// v2: slot이 home group에서 몇 번째 probe 위치인지 (1 = home group)
+int HashTable::probe_distance_v2(int pos) {
+    const uint32_t group_mask = (uint32_t)_group_count - 1;
+    uint32_t target = (uint32_t)pos / HASH_GROUP_WIDTH;
+    uint32_t group = _slots[pos].hash & group_mask;
+    
+    for (int probe = 0; probe < _group_count; probe++) {
+        if (group == target) {
+            return probe + 1;
+        }
+        group = (group + probe + 1) & group_mask;
+    }
+    return _group_count;
 }
 
 // Delete operation
@@ -456,50 +932,79 @@ int HashTable::del(const char* key) {
         return HASH_ERROR_INVALID_PARAMETER;
     }
     
+    // resize 중이면 양쪽 generation에서 지운다
+    int forward = forward_generation();
+    if (forward != 0) {
+        HashTable* next = next_generation();
+        if (next) {
+            int result = forward > 0 ? del_local(key) : HASH_ERROR_KEY_NOT_FOUND;
+            int next_result = next->del(key);
+            return result == HASH_OK ? HASH_OK : next_result;
+        }
+    }
+    
+    return del_local(key);
+}
+
+int HashTable::del_local(const char* key) {
     if (_use_lock) {
         pthread_rwlock_wrlock(&_rwlock);
     }
+    write_begin();
+    
+    int result = del_locked(key);
     
+    write_end();
+    if (_use_lock) {
+        pthread_rwlock_unlock(&_rwlock);
+    }
+    
+    return result;
+}
+
+// Delete from this generation (caller holds the write lock and seqlock)
+int HashTable::del_locked(const char* key) {
     int result = HASH_ERROR_KEY_NOT_FOUND;
     
-    uint32_t hash_value = _hash_function ? _hash_function(key, _field_len) : default_hash(key, _field_len);
-    int index = _hash_index_table->_hash_entries[hash_value].index;
-    int prev_index = -1;
+    if (_index_version == HASH_INDEX_V2_OPEN_ADDRESSING) {
+        result = del_v2(key);
+    } else {
+        uint32_t hash_value = bucket_of(key);
+        int index = _hash_index_table->_hash_entries[hash_value].index;
+        int prev_index = -1;
     
-    while (index != -1) {
-        DataIndexEntry* de = get_data_entry(index);
-        if (!de) {
-            log(LOG_ERROR, "Invalid data entry at index %d", index);
-            break;
-        }
+        while (index != -1) {
+            DataIndexEntry* de = get_data_entry(index);
+            if (!de) {
+                log(LOG_ERROR, "Invalid data entry at index %d", index);
+                break;
+            }
         
-        if (de->occupied && compare(de->value, key, _field_len) == 0) {
-            // Remove from hash chain
-            if (prev_index == -1) {
-                _hash_index_table->_hash_entries[hash_value].index = de->nextIndex;
-            } else {
-                DataIndexEntry* prev_de = get_data_entry(prev_index);
-                if (prev_de) {
-                    prev_de->nextIndex = de->nextIndex;
+            if (de->occupied && compare(de->value, key, _field_len) == 0) {
+                // Remove from hash chain
+                if (prev_index == -1) {
+                    _hash_index_table->_hash_entries[hash_value].index = de->nextIndex;
+                } else {
+                    DataIndexEntry* prev_de = get_data_entry(prev_index);
+                    if (prev_de) {
+                        prev_de->nextIndex = de->nextIndex;
+                    }
                 }
-            }
             
-            // Mark as free and add to free list
-            de->occupied = 0;
-            de->nextEmpty = _hash_index_table->_first_free_slot;
-            _hash_index_table->_first_free_slot = index;
+                // Mark as free and add to free list
+                de->occupied = 0;
+                clear_reverse(de->dataIndex, index);
+                de->nextEmpty = _hash_index_table->_first_free_slot;
+                _hash_index_table->_first_free_slot = index;
             
-            result = HASH_OK;
-            log(LOG_DEBUG, "Deleted key at index %d", index);
-            break;
-        }
+                result = HASH_OK;
+                log(LOG_DEBUG, "Deleted key at index %d", index);
+                break;
+            }
         
-        prev_index = index;
-        index = de->nextIndex;
-    }
-    
-    if (_use_lock) {
-        pthread_rwlock_unlock(&_rwlock);
+            prev_index = index;
+            index = de->nextIndex;
+        }
     }
     
     return result;
@@ -513,6 +1018,156 @@ int HashTable::add(const char* key, int dataIndex) {
     return put(key, dataIndex);
 }
 
+// Bulk load
+int HashTable::bulk_load(const char* const* keys, const int* data_indexes, int count, int threads, int* assigned) {
+    if (!_initialized) {
+        log(LOG_ERROR, "HashTable not initialized");
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    if (!keys || count < 0) {
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    if (count > _data_count) {
+        log(LOG_ERROR, "Bulk load of %d keys exceeds data count %d", count, _data_count);
+        return HASH_ERROR_NO_SPACE;
+    }
+    // resize 로 generation 이 생긴 table 은 generation 마다 나눠 넣어야 하므로 지원하지 않는다
+    if (forward_generation() != 0) {
+        log(LOG_ERROR, "Bulk load is not supported while the index has a resize generation");
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    int ret = clear();
+    if (ret != HASH_OK) {
+        return ret;
+    }
+    
+    const bool v2 = _index_version == HASH_INDEX_V2_OPEN_ADDRESSING;
+    const uint32_t home_count = v2 ? (uint32_t)_group_count : (uint32_t)_hash_count;
+    const uint32_t invalid_home = UINT32_MAX;
+    
+    // 1. key 검사 + hash (병렬). home = v1 bucket / v2 첫 probe group
+    std::vector<uint32_t> home(count);
+    std::vector<uint32_t> hash(count);
+    bulk_parallel_for(count, threads, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const char* key = keys[i];
+            bool valid = key && (!_is_char || strnlen(key, _field_len) < (size_t)_field_len) &&
+                         (!data_indexes || data_indexes[i] >= 0);
+            if (!valid) {
+                home[i] = invalid_home;
+                continue;
+            }
+            if (v2) {
+                hash[i] = fingerprint(key);
+                home[i] = hash[i] & (home_count - 1);
+            } else if (_hash_function) {
+                hash[i] = _hash_function(key, _field_len);
+                home[i] = hash[i] < home_count ? hash[i] : invalid_home;
+            } else {
+                hash[i] = raw_hash(key);
+                home[i] = hash[i] % home_count;
+            }
+        }
+    });
+    
+    // 2. home 별 counting sort (같은 home 안은 입력 순서 유지).
+    //    home 순으로 넣으면 bucket head / ctrl byte 쓰기가 앞에서부터 이어진다.
+    std::vector<int> start(home_count + 1, 0);
+    int invalid = 0;
+    for (int i = 0; i < count; i++) {
+        if (home[i] == invalid_home) {
+            invalid++;
+        } else {
+            start[home[i] + 1]++;
+        }
+    }
+    for (uint32_t h = 0; h < home_count; h++) {
+        start[h + 1] += start[h];
+    }
+    std::vector<int> sorted(count - invalid);
+    {
+        std::vector<int> fill(start.begin(), start.end() - 1);
+        for (int i = 0; i < count; i++) {
+            if (home[i] != invalid_home) {
+                sorted[fill[home[i]]++] = i;
+            }
+        }
+    }
+    
+    // 3. 중복 제거: 같은 home 안에서 hash 가 같을 때만 key 비교 (먼저 나온 key 가 남는다)
+    std::vector<int> order;     // 받아들인 입력 위치 (home 순)
+    order.reserve(sorted.size());
+    int duplicates = 0;
+    for (uint32_t h = 0; h < home_count; h++) {
+        size_t run_first = order.size();
+        for (int j = start[h]; j < start[h + 1]; j++) {
+            int input = sorted[j];
+            bool duplicate = false;
+            for (size_t k = run_first; k < order.size() && !duplicate; k++) {
+                int other = order[k];
+                duplicate = hash[other] == hash[input] && compare(keys[other], keys[input], _field_len) == 0;
+            }
+            if (duplicate) {
+                duplicates++;
+            } else {
+                order.push_back(input);
+            }
+        }
+    }
+    
+    // dataIndex: 지정값 또는 받아들인 key 의 입력 순서
+    std::vector<int> data_index(count, -1);
+    for (size_t k = 0; k < order.size(); k++) {
+        data_index[order[k]] = -2;
+    }
+    int next_data_index = 0;
+    for (int i = 0; i < count; i++) {
+        if (data_index[i] == -2) {
+            data_index[i] = data_indexes ? data_indexes[i] : next_data_index++;
+        }
+    }
+    
+    // 4. entry 는 0 부터 순서대로, free list 는 clear() 가 묶어둔 나머지 꼬리
+    if (_use_lock) {
+        pthread_rwlock_wrlock(&_rwlock);
+    }
+    write_begin();
+    
+    int used = (int)order.size();
+    for (int e = 0; e < used; e++) {
+        int input = order[e];
+        DataIndexEntry* de = get_data_entry(e);
+        de->occupied = 1;
+        de->nextEmpty = -1;
+        de->dataIndex = data_index[input];
+        copy(de->value, keys[input], _field_len);
+        set_reverse(de->dataIndex, e);
+        
+        if (v2) {
+            de->nextIndex = -1;
+            insert_slot_v2(hash[input], e);     // capacity > data_count 이므로 실패하지 않는다
+        } else {
+            HashEntry& head = _hash_index_table->_hash_entries[home[input]];
+            de->nextIndex = head.index;
+            head.index = e;
+        }
+    }
+    _hash_index_table->_first_free_slot = used < _data_count ? used : -1;
+    
+    write_end();
+    if (_use_lock) {
+        pthread_rwlock_unlock(&_rwlock);
+    }
+    
+    if (assigned && count > 0) {
+        memcpy(assigned, data_index.data(), count * sizeof(int));
+    }
+    
+    log(LOG_INFO, "Bulk loaded %d keys (%d duplicate, %d invalid)", used, duplicates, invalid);
+    return used;
+}
+
 // Get by sequence
 int HashTable::getBySeq(int seq) {
     if (!_initialized) {
@@ -556,8 +1211,18 @@ int HashTable::find_key_by_data_index(int target_data_index, char* found_key) {
 
     int result = HASH_ERROR_KEY_NOT_FOUND;
 
-    // Iterate through all data entries to find the one with matching dataIndex
-    for (int i = 0; i < _data_count; i++) {
+    if (_reverse && target_data_index < _data_count) {
+        // reverse index: slot 을 바로 찾고 그 entry 가 아직 이 dataIndex 인지 확인
+        int slot = _reverse[target_data_index];
+        DataIndexEntry* de = (slot >= 0 && slot < _data_count) ? get_data_entry(slot) : nullptr;
+        if (de && de->occupied && de->dataIndex == target_data_index) {
+            copy(found_key, de->value, _field_len);
+            result = HASH_OK;
+        }
+    }
+
+    // reverse index 가 없거나 범위 밖의 dataIndex 는 전체 scan
+    for (int i = 0; (!_reverse || target_data_index >= _data_count) && i < _data_count; i++) {
         DataIndexEntry* de = get_data_entry(i);
         if (de && de->occupied && de->dataIndex == target_data_index) {
             // Found the entry, copy the key
@@ -572,6 +1237,13 @@ int HashTable::find_key_by_data_index(int target_data_index, char* found_key) {
         pthread_rwlock_unlock(&_rwlock);
     }
 
+    if (result != HASH_OK && forward_generation() != 0) {
+        HashTable* next = next_generation();
+        if (next) {
+            return next->find_key_by_data_index(target_data_index, found_key);
+        }
+    }
+
     if (result != HASH_OK) {
         log(LOG_DEBUG, "Key not found for data_index %d", target_data_index);
     }
@@ -607,6 +1279,7 @@ HashTableStats HashTable::get_statistics() {
     }
     
     stats.total_slots = _data_count;
+    stats.index_version = _index_version;
     stats.used_slots = 0;
     stats.free_slots = 0;
     stats.collision_count = 0;
@@ -628,14 +1301,30 @@ HashTableStats HashTable::get_statistics() {
         }
     }
     
-    // Calculate chain statistics
-    for (int i = 0; i < _hash_count; i++) {
+    // Calculate chain statistics (v2: chain length = probe 한 group 수)
+    for (int i = 0; _index_version == HASH_INDEX_V2_OPEN_ADDRESSING && i < _capacity; i++) {
+        if (_ctrl[i] < 0) {
+            continue;
+        }
+        int chain_len = probe_distance_v2(i);
+        chain_count++;
+        total_chain_length += chain_len;
+        stats.max_chain_length = std::max(stats.max_chain_length, chain_len);
+        stats.min_chain_length = std::min(stats.min_chain_length, chain_len);
+        stats.chain_length_hist[std::min(chain_len, HASH_STATS_CHAIN_BUCKETS) - 1]++;
+        if (chain_len > 1) {
+            stats.collision_count++;
+        }
+    }
+    
+    for (int i = 0; _index_version == HASH_INDEX_V1_CHAINED && i < _hash_count; i++) {
         int chain_len = calculate_chain_length(_hash_index_table->_hash_entries[i].index);
         if (chain_len > 0) {
             chain_count++;
             total_chain_length += chain_len;
             stats.max_chain_length = std::max(stats.max_chain_length, chain_len);
             stats.min_chain_length = std::min(stats.min_chain_length, chain_len);
+            stats.chain_length_hist[std::min(chain_len, HASH_STATS_CHAIN_BUCKETS) - 1]++;
             if (chain_len > 1) {
                 stats.collision_count += chain_len - 1;
             }
@@ -653,6 +1342,19 @@ HashTableStats HashTable::get_statistics() {
         pthread_rwlock_unlock(&_rwlock);
     }
     
+    // resize 되었으면 최신 generation 기준 (migration 중에는 아직 남은 key 포함)
+    int forward = forward_generation();
+    HashTable* next = forward != 0 ? next_generation() : nullptr;
+    if (next) {
+        HashTableStats next_stats = next->get_statistics();
+        if (forward > 0) {
+            next_stats.used_slots += stats.used_slots;
+            next_stats.free_slots = next_stats.total_slots - next_stats.used_slots;
+            next_stats.load_factor = (double)next_stats.used_slots / next_stats.total_slots;
+        }
+        return next_stats;
+    }
+    
     return stats;
 }
 
@@ -686,9 +1388,30 @@ void HashTable::display_hashtable() {
     printf("Hash Count: %d, Data Count: %d, Field Length: %d\n", 
            _hash_count, _data_count, _field_len);
     printf("Key Type: %s\n", _hash_index_table->_is_char_key ? "char string" : "binary");
+    printf("Hash Function: %s\n", hash_function_name(_hash_func_id));
     printf("First Free Slot: %d\n", _hash_index_table->_first_free_slot);
+    printf("Index Format: v%d\n", _index_version);
+    printf("Generation: %d, Forward: %d\n", _generation, _hash_index_table->_forward);
+    
+    for (int g = 0; _index_version == HASH_INDEX_V2_OPEN_ADDRESSING && g < _group_count; g++) {
+        if (match_group(_ctrl + g * HASH_GROUP_WIDTH, HASH_CTRL_EMPTY) == 0xFFFF) {
+            continue;
+        }
+        
+        printf("Group %d: ", g);
+        for (int i = g * HASH_GROUP_WIDTH; i < (g + 1) * HASH_GROUP_WIDTH; i++) {
+            if (_ctrl[i] == HASH_CTRL_EMPTY) continue;
+            if (_ctrl[i] == HASH_CTRL_DELETED) {
+                printf("[%d:deleted] ", i);
+                continue;
+            }
+            const DataIndexEntry* de = get_data_entry(_slots[i].entry);
+            printf("[%d:tag=%02x,ei=%d,datai=%d] ", i, (unsigned)_ctrl[i], _slots[i].entry, de ? de->dataIndex : -1);
+        }
+        printf("\n");
+    }
     
-    for (int i = 0; i < _hash_count; i++) {
+    for (int i = 0; _index_version == HASH_INDEX_V1_CHAINED && i < _hash_count; i++) {
         if (_hash_index_table->_hash_entries[i].index == -1) {
             continue;
         }
@@ -726,6 +1449,11 @@ void HashTable::display_statistics() {
     printf("Max chain length: %d\n", stats.max_chain_length);
     printf("Min chain length: %d\n", stats.min_chain_length);
     printf("Avg chain length: %.2f\n", stats.avg_chain_length);
+    printf("Chain length histogram:");
+    for (int i = 0; i < HASH_STATS_CHAIN_BUCKETS; i++) {
+        printf(" %d%s:%d", i + 1, i == HASH_STATS_CHAIN_BUCKETS - 1 ? "+" : "", stats.chain_length_hist[i]);
+    }
+    printf("\n");
 }
 
 // File validation
@@ -734,9 +1462,11 @@ bool HashTable::validate_file_integrity() {
         return false;
     }
     
-    return _hash_index_table->_magic_number == 0x48415348 &&
-           _hash_index_table->_version == 1 &&
-           _hash_index_table->_hash_count == _hash_count &&
+    int expected_hash_count = _index_version == HASH_INDEX_V2_OPEN_ADDRESSING ? _capacity : _hash_count;
+    return _hash_index_table->_magic_number == HASH_INDEX_MAGIC &&
+           _hash_index_table->_version == _index_version &&
+           _hash_index_table->_hash_count == expected_hash_count &&
+           _hash_index_table->_hash_func_id == _hash_func_id &&
            _hash_index_table->_data_count == _data_count &&
            _hash_index_table->_field_len == _field_len &&
            _hash_index_table->_is_char_key == (_is_char ? 1 : 0);
@@ -747,17 +1477,11 @@ void HashTable::log(LogLevel level, const char* format, ...) {
     if (level < _log_level) {
         return;
     }
-    
-    const char* level_str[] = {"DEBUG", "INFO", "WARN", "ERROR"};
-    
-    printf("[%s] HashTable: ", level_str[level]);
-    
+
     va_list args;
     va_start(args, format);
-    vprintf(format, args);
+    SimplePubSub::AsyncLogger::instance().logv(level, "HashTable", format, args);
     va_end(args);
-    
-    printf("\n");
 }
 
 // Defragmentation (future enhancement)
@@ -766,9 +1490,199 @@ int HashTable::defragment() {
     return HASH_OK;
 }
 
-// Resize (future enhancement)
-int HashTable::resize(int /*new_hash_count*/, int /*new_data_count*/) {
-    // TODO: Implement resize logic
+// ===== Online resize =====
+
+void HashTable::generation_filename(int generation, char* out, size_t size) const {
+    snprintf(out, size, "%s.g%d", _base_filename, generation);
+}
+
+// 다음 generation (다른 프로세스가 resize 했으면 여기서 처음 연다)
+HashTable* HashTable::next_generation() {
+    HashTable* next = _next.load(std::memory_order_acquire);
+    if (next) {
+        return next;
+    }
+    
+    int forward = forward_generation();
+    if (forward == 0) {
+        return nullptr;
+    }
+    
+    std::lock_guard<std::mutex> guard(_next_mutex);
+    next = _next.load(std::memory_order_relaxed);
+    if (!next) {
+        next = open_generation(abs(forward), 0, 0, false);
+        _next.store(next, std::memory_order_release);
+    }
+    return next;
+}
+
+// create=false 이면 기존 generation 파일 헤더에서 크기를 읽어 연다
+HashTable* HashTable::open_generation(int generation, int hash_count, int data_count, bool create) {
+    char name[256];
+    generation_filename(generation, name, sizeof(name));
+    
+    if (!create) {
+        char path[512];
+        snprintf(path, sizeof(path), "mmap/%s.hashindex", name);
+        int fd = open(path, O_RDONLY);
+        if (fd == -1) {
+            log(LOG_ERROR, "Failed to open generation file %s: %s", path, strerror(errno));
+            return nullptr;
+        }
+        int header[sizeof(HashIndexTable) / sizeof(int)];
+        ssize_t n = pread(fd, header, sizeof(header), 0);
+        close(fd);
+        
+        const HashIndexTable* h = reinterpret_cast<const HashIndexTable*>(header);
+        if (n != (ssize_t)sizeof(header) || h->_magic_number != HASH_INDEX_MAGIC) {
+            log(LOG_ERROR, "Invalid generation file %s", path);
+            return nullptr;
+        }
+        // v2 는 _hash_count 가 slot 수지만 생성자에는 양수면 충분하다
+        hash_count = h->_hash_count;
+        data_count = h->_data_count;
+    }
+    
+    HashTable* next = new HashTable(hash_count, _field_len, data_count, _use_lock, name, _is_char);
+    snprintf(next->_base_filename, sizeof(next->_base_filename), "%s", _base_filename);
+    next->_generation = generation;
+    next->_log_level = _log_level;
+    next->_lock_free_read = _lock_free_read;
+    next->_requested_version = _index_version;
+    next->_mmap_options = _mmap_options;
+    if (_hash_function) {
+        next->setHashFunction(_hash_function);
+    } else {
+        next->setHashFunctionId(_hash_func_id);
+    }
+    
+    if (next->init() != HASH_OK) {
+        delete next;
+        return nullptr;
+    }
+    if (create) {
+        // 이전에 남아있던 같은 이름의 파일일 수 있으므로 비운다
+        next->clear();
+    }
+    return next;
+}
+
+int HashTable::resize(int new_hash_count, int new_data_count) {
+    if (!_initialized) {
+        log(LOG_ERROR, "HashTable not initialized");
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    if (new_hash_count <= 0 || new_data_count <= 0) {
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    int forward = forward_generation();
+    if (forward != 0) {
+        HashTable* next = next_generation();
+        if (!next) {
+            return HASH_ERROR_FILE_ERROR;
+        }
+        // 진행 중인 migration을 끝낸 뒤 최신 generation에서 다시 resize
+        if (forward > 0) {
+            while (forward_generation() > 0 && migrate(INT_MAX) > 0) {}
+        }
+        return next->resize(new_hash_count, new_data_count);
+    }
+    
+    if (new_data_count < _data_count) {
+        log(LOG_ERROR, "Shrinking is not supported: data_count %d -> %d", _data_count, new_data_count);
+        return HASH_ERROR_INVALID_PARAMETER;
+    }
+    
+    int generation = _generation + 1;
+    HashTable* next = open_generation(generation, new_hash_count, new_data_count, true);
+    if (!next) {
+        return HASH_ERROR_FILE_ERROR;
+    }
+    
+    _migration_cursor = 0;
+    _next.store(next, std::memory_order_release);
+    __atomic_store_n(&_hash_index_table->_forward, generation, __ATOMIC_RELEASE);
+    
+    log(LOG_INFO, "Resize started: %s -> generation %d (hash_count=%d, data_count=%d)",
+        _filename, generation, new_hash_count, new_data_count);
     return HASH_OK;
 }
 
+// 이 generation의 key를 최대 max_entries 개 다음 generation으로 옮긴다.
+// 새 generation에 먼저 넣고 이전 것을 지우므로, 이전 -> 새 순서로 읽는 reader는 항상 key를 찾는다.
+int HashTable::migrate(int max_entries) {
+    if (!_initialized || max_entries <= 0) {
+        return 0;
+    }
+    
+    int forward = forward_generation();
+    HashTable* next = forward != 0 ? next_generation() : nullptr;
+    if (!next) {
+        return 0;
+    }
+    if (forward < 0) {
+        return next->migrate(max_entries);
+    }
+    
+    char key[_field_len];
+    int moved = 0;
+    
+    if (_use_lock) {
+        pthread_rwlock_wrlock(&_rwlock);
+    }
+    write_begin();
+    
+    while (_migration_cursor < _data_count && moved < max_entries) {
+        DataIndexEntry* de = get_data_entry(_migration_cursor);
+        if (!de || !de->occupied) {
+            _migration_cursor++;
+            continue;
+        }
+        
+        memcpy(key, de->value, _field_len);
+        int ret = next->put(key, de->dataIndex);
+        if (ret != HASH_OK) {
+            log(LOG_ERROR, "Migration to generation %d failed at slot %d: %d", forward, _migration_cursor, ret);
+            break;
+        }
+        del_locked(key);
+        _migration_cursor++;
+        moved++;
+    }
+    
+    bool done = _migration_cursor >= _data_count;
+    write_end();
+    if (done) {
+        __atomic_store_n(&_hash_index_table->_forward, -forward, __ATOMIC_RELEASE);
+    }
+    
+    if (_use_lock) {
+        pthread_rwlock_unlock(&_rwlock);
+    }
+    
+    if (done) {
+        log(LOG_INFO, "Migration of %s to generation %d complete", _filename, forward);
+    }
+    return moved;
+}
+
+bool HashTable::is_resizing() {
+    if (!_initialized) {
+        return false;
+    }
+    int forward = forward_generation();
+    if (forward > 0) {
+        return true;
+    }
+    HashTable* next = forward < 0 ? next_generation() : nullptr;
+    return next ? next->is_resizing() : false;
+}
+
+int HashTable::get_total_data_count() {
+    HashTable* next = (_initialized && forward_generation() != 0) ? next_generation() : nullptr;
+    return next ? next->get_total_data_count() : _data_count;
+}
+
@@ -5,7 +5,10 @@
 #include <string.h>
 #include <stdint.h>
 #include <memory>
+#include <atomic>
+#include <mutex>
 #include "Master.h"
+#include "HashFunctions.h"
 
 // Error codes
 enum HashTableError {
@@ -21,6 +24,23 @@ enum HashTableError {
 };
 
 
+// On-disk index format (HashIndexTable::_version)
+enum HashIndexVersion {
+    HASH_INDEX_V1_CHAINED = 1,          // bucket array + DataIndexEntry::nextIndex chain
+    HASH_INDEX_V2_OPEN_ADDRESSING = 2   // power-of-two open addressing, 16-slot tag groups
+};
+
+#define HASH_INDEX_MAGIC 0x48415348
+#define HASH_REVERSE_MAGIC 0x48524556   // "HREV"
+#define HASH_GROUP_WIDTH 16             // v2: slots per tag group (one SSE2 compare)
+#define HASH_MIGRATE_BATCH 64           // resize: put 한번에 함께 옮기는 entry 수
+
+// v2 control byte values (FULL slot = 7-bit hash tag 0x00..0x7F)
+#define HASH_CTRL_EMPTY   ((int8_t)0x80)
+#define HASH_CTRL_DELETED ((int8_t)0xFE)
+
+#define HASH_STATS_CHAIN_BUCKETS 8      // chain_length_hist 크기 (마지막 칸은 그 이상)
+
 // Hash table statistics
 struct HashTableStats {
     int total_slots;
@@ -31,6 +51,9 @@ struct HashTableStats {
     int max_chain_length;
     int min_chain_length;
     double avg_chain_length;
+    // chain 길이 분포: [i] = 길이 i+1 인 chain 수 (v1: bucket 별 chain, v2: entry 별 probe group 수)
+    int chain_length_hist[HASH_STATS_CHAIN_BUCKETS];
+    int index_version;      // HashIndexVersion (v2 의 chain 길이는 probe group 수라 기준이 다르다)
 };
 
 // Hash entry structure
@@ -51,7 +74,16 @@ struct DataIndexEntry {
     DataIndexEntry() : occupied(0), nextIndex(-1), nextEmpty(-1), dataIndex(-1) {}
 };
 
+// v2 open addressing slot: stored hash fingerprint + DataIndexEntry slot
+struct HashSlotV2 {
+    uint32_t hash;      // Mixed 32-bit hash (compared before the key)
+    int entry;          // DataIndexEntry index
+};
+
 // Hash index table header
+//  v1: header + HashEntry[_hash_count]
+//  v2: header | ctrl bytes[_hash_count] (64B aligned) | HashSlotV2[_hash_count] (64B aligned)
+//      _hash_count 는 slot 수 (2의 거듭제곱, data_count 의 8/7 이상)
 struct HashIndexTable {
     int _first_free_slot;               // First free slot index
     int _magic_number;                  // Magic number for validation
@@ -60,16 +92,24 @@ struct HashIndexTable {
     int _data_count;                    // Number of data entries
     int _field_len;                     // Key field length
     int _is_char_key;                   // 1: char string key, 0: binary key
-    int _reserved[3];                   // Reserved for future use
+    uint32_t _write_seq;                // seqlock 카운터 (홀수: 쓰기 진행 중)
+    int _hash_func_id;                  // HashFunctionId (0: djb2, 기존 파일 호환)
+    int _forward;                       // online resize: 0 없음, >0 다음 generation으로 migration 중,
+                                        //                <0 migration 완료 (-generation, 이 파일은 비어있음)
     struct HashEntry _hash_entries[];   // Hash entries array
     
     HashIndexTable() : _first_free_slot(0), _magic_number(0x48415348), 
                       _version(1), _hash_count(0), _data_count(0), _field_len(0),
-                      _is_char_key(0), _reserved{0, 0, 0} {}
+                      _is_char_key(0), _write_seq(0), _hash_func_id(HASH_FUNC_DJB2), _forward(0) {}
 };
 
-// Hash function type
-typedef uint32_t (*HashFunction)(const char* key, int len);
+// Reverse index file (<filename>.revindex): dataIndex -> DataIndexEntry slot
+//  header | int slot[_data_count] (-1: 없음)
+//  dataIndex 하나에 key 하나를 가정 (HashMaster 사용 방식). dataIndex >= _data_count 는 기록하지 않고 scan 한다.
+struct HashReverseHeader {
+    int _magic_number;
+    int _data_count;
+};
 
 class HashTable {
 private:
@@ -78,17 +118,33 @@ private:
     int _fd_data_index_table;
     void* _hash_index_table_addr;
     void* _data_index_table_addr;
+    int _fd_reverse_index;
+    void* _reverse_index_addr;
+    int* _reverse;              // dataIndex -> slot (파일을 못 만들면 nullptr, find_key_by_data_index 는 scan)
     
     // Configuration
-    char _filename[256];        // _filename.hashindex, _filename.dataindex
+    char _filename[256];        // _filename.hashindex, _filename.dataindex, _filename.revindex
     int _hash_count;            // Number of hash entries
     int _data_count;            // Number of data entries
     int _field_len;             // Key field length
     int _hash_table_size;       // sizeof(HashIndexTable) + _hash_count * sizeof(HashEntry);
     int _data_table_size;       // _data_count * _sizeof_data_entry;
+    size_t _hash_map_size;      // mmap 길이 (hugetlbfs 면 huge page 배수로 올림)
+    size_t _data_map_size;
+    size_t _reverse_map_size;
+    MmapOptions _mmap_options;
     int _sizeof_data_entry;     // sizeof(DataIndexEntry) + field_len;
     bool _use_lock;
     bool _is_char;
+    bool _lock_free_read;       // true: get()은 rwlock 없이 seqlock으로 읽음
+    int _index_version;         // 사용 중인 index 포맷 (HashIndexVersion)
+    int _requested_version;     // 파일을 새로 만들 때 사용할 포맷
+    
+    // v2 open addressing layout
+    int _capacity;              // slot 수 (2의 거듭제곱)
+    int _group_count;           // _capacity / HASH_GROUP_WIDTH
+    int8_t* _ctrl;              // control bytes (EMPTY / DELETED / 7-bit tag)
+    HashSlotV2* _slots;
     
     // Runtime objects
     HashIndexTable* _hash_index_table;
@@ -97,15 +153,35 @@ private:
     bool _initialized;
     
     // Hash function
-    HashFunction _hash_function;
+    HashFunction _hash_function;    // 사용자 지정 함수 (HASH_FUNC_CUSTOM)
+    HashFunction _builtin_hash;     // _hash_func_id 의 built-in 함수
+    int _hash_func_id;              // 사용 중인 HashFunctionId (헤더에 기록)
+    int _file_hash_func_id;         // 기존 파일 헤더의 id (유효한 파일이 없으면 -1)
+    
+    // Online resize: <base>.g<n>.hashindex / .dataindex 로 다음 generation을 만들고
+    // key를 조금씩 옮긴다. 옮기는 동안 읽기는 양쪽 generation을 본다.
+    char _base_filename[256];               // generation 0 의 파일 이름
+    int _generation;                        // 0: base 파일
+    std::atomic<HashTable*> _next;          // 다음 generation (소유)
+    std::mutex _next_mutex;                 // 다른 프로세스가 만든 generation을 열 때
+    int _migration_cursor;                  // 다음에 옮길 DataIndexEntry slot
     
     // Logging
     LogLevel _log_level;
     
     // Internal helper methods
-    uint32_t default_hash(const char* key, int len);
-    uint32_t djb2_hash(const char* key, int len);
-    uint32_t djb2_string_hash(const char* key, int len);
+    // built-in hash: char key 는 NUL 이전까지만 해싱
+    inline uint32_t raw_hash(const char* key) {
+        int len = _is_char ? (int)strnlen(key, _field_len) : _field_len;
+        return _builtin_hash(key, len);
+    }
+    
+    // v1 bucket / v2 fingerprint
+    inline uint32_t bucket_of(const char* key) {
+        return _hash_function ? _hash_function(key, _field_len) : raw_hash(key) % _hash_count;
+    }
+    uint32_t fingerprint(const char* key);
+    int adopt_file_hash_function();
     
     inline int compare(const char* key1, const char* key2, int len) {
         if (!key1 || !key2) return -1;
@@ -128,11 +204,54 @@ private:
     */
     int allocate_files();
     void cleanup_resources();
+    int allocate_reverse_index();
+    void rebuild_reverse_index();
+    inline void set_reverse(int dataIndex, int slot) {
+        if (_reverse && dataIndex >= 0 && dataIndex < _data_count) _reverse[dataIndex] = slot;
+    }
+    // slot 이 지워질 때: 같은 dataIndex 로 나중에 들어간 slot 이 있으면 그대로 둔다
+    inline void clear_reverse(int dataIndex, int slot) {
+        if (_reverse && dataIndex >= 0 && dataIndex < _data_count && _reverse[dataIndex] == slot) _reverse[dataIndex] = -1;
+    }
     
     // Lock management
     int init_locks();
     void destroy_locks();
     
+    // Seqlock (single writer / multi reader)
+    // _write_seq 는 mmap 헤더에 있으므로 같은 파일을 연 다른 프로세스의 reader도 공유한다.
+    // begin은 홀수로 만들기만 하므로(이전 writer가 쓰기 도중 죽어 홀수로 남아 있어도) end 후 짝수가 된다.
+    inline void write_begin() {
+        __atomic_fetch_or(&_hash_index_table->_write_seq, 1u, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+    inline void write_end() {
+        __atomic_fetch_add(&_hash_index_table->_write_seq, 1, __ATOMIC_RELEASE);
+    }
+    int lookup(const char* key, bool racy);
+    int get_local(const char* key);
+    int del_local(const char* key);
+    int del_locked(const char* key);
+    
+    // Online resize
+    inline int forward_generation() const {
+        return __atomic_load_n(&_hash_index_table->_forward, __ATOMIC_ACQUIRE);
+    }
+    HashTable* next_generation();
+    HashTable* open_generation(int generation, int hash_count, int data_count, bool create);
+    void generation_filename(int generation, char* out, size_t size) const;
+    
+    // v2 open addressing
+    static int v2_capacity_for(int data_count);
+    static int v2_ctrl_offset();
+    static int v2_slots_offset(int capacity);
+    int detect_index_version();
+    void setup_layout(int version);
+    int find_slot_v2(const char* key, uint32_t fp, bool racy);
+    int insert_slot_v2(uint32_t fp, int entry);
+    int del_v2(const char* key);
+    int probe_distance_v2(int pos);
+    
     // Logging
     void log(LogLevel level, const char* format, ...);
     
@@ -160,6 +279,14 @@ public:
     int del(const char* key);
     int add(const char* key, int dataIndex);  // Same as put but checks for duplicates
     
+    // Bulk load (single writer, 시작 시 적재용): 기존 내용을 지우고 keys[0..count) 를 한번에 넣는다.
+    //  data_indexes 가 nullptr 이면 받아들인 key 에 입력 순서대로 0,1,2.. 를 준다.
+    //  key hash 는 threads 개 스레드로 계산하고 (threads <= 0: 자동) bucket/group 별로 counting sort 해
+    //  entry 를 앞에서부터 채우므로 lock / write_seq 는 한번만 잡는다.
+    //  같은 key 는 먼저 나온 것만 넣고, 잘못된 key (nullptr, 너무 긴 문자열) 는 건너뛴다.
+    //  assigned[i] (nullptr 가능): 들어간 dataIndex 또는 -1. 넣은 key 수 반환 (< 0: 에러)
+    int bulk_load(const char* const* keys, const int* data_indexes, int count, int threads, int* assigned);
+    
     // Convenience wrappers for numeric key types
     int put(short key, int dataIndex) { return put(reinterpret_cast<const char*>(&key), dataIndex); }
     int get(short key) { return get(reinterpret_cast<const char*>(&key)); }
@@ -174,16 +301,44 @@ public:
     // Sequential access
     int getBySeq(int seq);
 
-    // Find key by data index (for reverse lookup)
+    // Find key by data index (for reverse lookup, .revindex 로 O(1))
     int find_key_by_data_index(int target_data_index, char* found_key);
 
-    // Hash function management
-    void setHashFunction(HashFunction func) { _hash_function = func; }
+    // Index format: 파일을 새로 만들 때의 포맷 (init 전에 호출).
+    // 기존 파일이 유효하면 파일의 포맷(v1/v2)을 그대로 사용한다.
+    void setIndexVersion(int version) { _requested_version = version; }
+    int getIndexVersion() const { return _index_version; }
+    
+    // Hash function management (init 전에 호출, 새 파일의 헤더에 id가 기록된다)
+    // 기존 파일을 열면 파일에 기록된 함수를 따른다.
+    int setHashFunctionId(int id);
+    int getHashFunctionId() const { return _hash_func_id; }
+    // 사용자 함수 (v1: bucket index 반환, v2: 32-bit hash 반환). 헤더에는 HASH_FUNC_CUSTOM 으로 기록
+    void setHashFunction(HashFunction func) {
+        _hash_function = func;
+        if (func) {
+            _hash_func_id = HASH_FUNC_CUSTOM;
+        } else {
+            setHashFunctionId(HASH_FUNC_DJB2);
+        }
+    }
     HashFunction getHashFunction() const { return _hash_function; }
     
     // Lock management
     void setUseLock(bool use_lock);
     bool getUseLock() const { return _use_lock; }
+    
+    // mmap 옵션 (init 전에 호출, resize 로 만드는 generation 에도 적용)
+    void setMmapOptions(const MmapOptions& options) { _mmap_options = options; }
+    const MmapOptions& getMmapOptions() const { return _mmap_options; }
+    
+    // index 파일 전체 page 를 미리 fault (최신 generation 포함)
+    int warm();
+    
+    // Lock-free read mode: writer는 하나라고 가정하고, get()은 락 없이 읽은 뒤
+    // 읽는 동안 쓰기가 있었으면(_write_seq 변경) 다시 읽는다.
+    void setLockFreeRead(bool enable) { _lock_free_read = enable; }
+    bool getLockFreeRead() const { return _lock_free_read; }
 
     inline int get_first_free_slot() { return _hash_index_table->_first_free_slot;}
     
@@ -219,7 +374,15 @@ public:
     
     // Maintenance operations
     int defragment();  // Compact deleted entries
-    int resize(int new_hash_count, int new_data_count);  // Resize hash table
+    
+    // Online resize (single writer)
+    //  resize(): 새 generation 파일을 만들고 바로 반환. 이후 put은 새 generation에 들어가고,
+    //  기존 key는 put 마다 HASH_MIGRATE_BATCH 개씩 또는 migrate() 호출로 옮겨진다.
+    int resize(int new_hash_count, int new_data_count);
+    int migrate(int max_entries);           // 옮긴 entry 수 반환
+    bool is_resizing();
+    int get_generation() const { return _generation; }
+    int get_total_data_count();             // 최신 generation의 data_count
 };
 
 #endif // IMPROVED_HASH_TABLE_H
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <memory>
 #include <string>
+#include <string.h>
+#include "MmapOptions.h"
 
 // Forward declarations
 enum LogLevel {
@@ -34,6 +36,11 @@ struct MasterConfig {
     int _primary_field_len;     // Primary key field length
     int _secondary_field_len;   // Secondary key field length
     bool _use_lock;             // Enable thread safety
+    bool _lock_free_read;       // Single writer: readers use seqlock instead of rwlock
+    int _index_version;         // HashTable index format for new files (1: chained, 2: open addressing)
+    std::string _hash_function; // HashTable hash function for new files (djb2, wymix, crc32c)
+    bool _auto_grow;            // 레코드가 가득 차면 저장소/인덱스를 두 배로 늘린다 (NO_SPACE 대신)
+    MmapOptions _mmap;          // mmap/ 파일 매핑 옵션 (populate, hugepage, willneed, lock, warm)
     std::string _filename;      // Base filename for storage
     LogLevel _log_level;        // Logging level
 
@@ -42,7 +49,7 @@ struct MasterConfig {
         : _max_record_count(10000), _max_record_size(1024),
           _tot_size(0), _hash_count(1000),
           _primary_field_len(64), _secondary_field_len(64),
-          _use_lock(true), _filename("master"), _log_level(LOG_INFO) {
+          _use_lock(true), _lock_free_read(false), _index_version(1), _hash_function("djb2"), _auto_grow(false), _filename("master"), _log_level(LOG_INFO) {
         _tot_size = _max_record_count * _max_record_size;
     }
 
@@ -59,6 +66,21 @@ struct MasterConfig {
     }
 };
 
+// bulk_load 입력 한 건 (포인터는 bulk_load 호출 동안만 유효하면 된다)
+struct MasterBulkRecord {
+    const char* pkey;
+    const char* skey;       // nullptr / "" : secondary key 없음
+    const char* record;
+    int record_size;
+};
+
+// Field-level patch for update_fields (bytes at offset within the record)
+struct MasterFieldPatch {
+    int offset;
+    int length;
+    const char* data;
+};
+
 // Statistics structure for monitoring
 struct MasterStats {
     int total_records;
@@ -120,6 +142,15 @@ public:
      */
     virtual bool is_initialized() const { return _initialized; }
 
+    /**
+     * @brief Prefault all storage pages (index and records) before the first access
+     *
+     * Called by MasterManager after init() when the master config has warm: true,
+     * so the feed does not pay the first-touch page faults.
+     * @return MASTER_OK on success, error code on failure
+     */
+    virtual int warm() { return MASTER_OK; }
+
     // ===== Data Operations =====
 
     /**
@@ -153,6 +184,118 @@ public:
      */
     virtual int del(const char* pkey) = 0;
 
+    /**
+     * @brief Copy a consistent snapshot of a record by primary key
+     *
+     * get_by_primary() returns a pointer into shared storage that the writer may be
+     * updating at the same time. read_by_primary() copies the record and, in
+     * implementations that support it, retries until the copy was not torn by a write.
+     * @param pkey Primary key
+     * @param out Destination buffer
+     * @param out_size Size of destination buffer
+     * @return Number of bytes copied, or error code (< 0)
+     */
+    virtual int read_by_primary(const char* pkey, char* out, int out_size) {
+        if (!out || out_size <= 0) return MASTER_ERROR_INVALID_PARAMETER;
+        char* record = get_by_primary(pkey);
+        if (!record) return MASTER_ERROR_KEY_NOT_FOUND;
+        int n = out_size < _config._max_record_size ? out_size : _config._max_record_size;
+        memcpy(out, record, n);
+        return n;
+    }
+
+    /**
+     * @brief Copy a consistent snapshot of a record by secondary key
+     * @see read_by_primary
+     */
+    virtual int read_by_secondary(const char* skey, char* out, int out_size) {
+        if (!out || out_size <= 0) return MASTER_ERROR_INVALID_PARAMETER;
+        char* record = get_by_secondary(skey);
+        if (!record) return MASTER_ERROR_KEY_NOT_FOUND;
+        int n = out_size < _config._max_record_size ? out_size : _config._max_record_size;
+        memcpy(out, record, n);
+        return n;
+    }
+
+    /**
+     * @brief Mark the start/end of an in-place update of a record returned by get_by_*
+     *
+     * Writers that modify a record through the pointer returned by get_by_primary()
+     * must bracket the modification with these calls so that concurrent
+     * read_by_*() callers can detect the update and retry.
+     * @param record Pointer returned by get_by_primary()/get_by_secondary()
+     */
+    virtual void begin_record_update(char* /*record*/) {}
+    virtual void end_record_update(char* /*record*/) {}
+
+    /**
+     * @brief Apply field patches to a record in place
+     *
+     * Only patches whose bytes differ from the stored record are written, so unchanged
+     * fields do not dirty the mapped page. The write is bracketed by
+     * begin_record_update()/end_record_update() (the whole patch set is one update).
+     * @param pkey Primary key
+     * @param patches Field patches (offset + length must fit in the record)
+     * @param count Number of patches
+     * @return Number of fields changed (>= 0), or error code
+     */
+    virtual int update_fields(const char* pkey, const MasterFieldPatch* patches, int count) {
+        if (!patches && count > 0) return MASTER_ERROR_NULL_POINTER;
+        char* record = get_by_primary(pkey);
+        if (!record) return MASTER_ERROR_KEY_NOT_FOUND;
+        for (int i = 0; i < count; i++) {
+            const MasterFieldPatch& p = patches[i];
+            if (p.offset < 0 || p.length < 0 || p.offset + p.length > _config._max_record_size) {
+                return MASTER_ERROR_INVALID_PARAMETER;
+            }
+        }
+        int changed = 0;
+        bool started = false;
+        for (int i = 0; i < count; i++) {
+            const MasterFieldPatch& p = patches[i];
+            if (memcmp(record + p.offset, p.data, p.length) == 0) continue;
+            if (!started) {
+                begin_record_update(record);
+                started = true;
+            }
+            memcpy(record + p.offset, p.data, p.length);
+            changed++;
+        }
+        if (started) end_record_update(record);
+        return changed;
+    }
+
+    /**
+     * @brief Replace the whole contents with a prepared record set
+     *
+     * Startup load path: instead of clear() followed by a lookup and a put() per row,
+     * the implementation may build the index in one pass without per-record locking
+     * (HashMaster builds new files beside the live ones and renames them into place).
+     * Duplicate primary keys keep the first record; invalid rows are skipped.
+     * Pointers previously returned by get_by_* must not be used afterwards.
+     * @param records Input records
+     * @param count Number of input records
+     * @param loaded Optional: number of records stored
+     * @return MASTER_OK on success, error code on failure
+     */
+    virtual int bulk_load(const MasterBulkRecord* records, int count, int* loaded = nullptr) {
+        if (!records && count > 0) return MASTER_ERROR_NULL_POINTER;
+        int ret = clear();
+        if (ret != MASTER_OK) return ret;
+        int stored = 0;
+        for (int i = 0; i < count; i++) {
+            const MasterBulkRecord& r = records[i];
+            ret = put(r.pkey, r.skey, r.record, r.record_size);
+            if (ret == MASTER_OK) {
+                stored++;
+            } else if (ret == MASTER_ERROR_NO_SPACE) {
+                break;
+            }
+        }
+        if (loaded) *loaded = stored;
+        return ret == MASTER_ERROR_NO_SPACE ? ret : MASTER_OK;
+    }
+
     // ===== Convenience Wrappers for Numeric Keys =====
 
     // Short key wrappers
@@ -230,6 +373,18 @@ public:
      */
     virtual bool getUseLock() const { return _config._use_lock; }
 
+    /**
+     * @brief Enable lock-free (seqlock) reads for single-writer deployments
+     * @param enable Enable/disable lock-free reads
+     */
+    virtual void setLockFreeRead(bool enable) { _config._lock_free_read = enable; }
+
+    /**
+     * @brief Get lock-free read setting
+     * @return true if readers skip the rwlock
+     */
+    virtual bool getLockFreeRead() const { return _config._lock_free_read; }
+
     // ===== Optional Advanced Operations =====
 
     /**
@@ -0,0 +1,137 @@
+#ifndef MASTER_EPOCH_H
+#define MASTER_EPOCH_H
+
+#include <atomic>
+#include <new>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sched.h>
+
+/**
+ * @brief 마스터 generation 교체용 epoch (reader 가 이전 generation 을 다 쓸 때까지 해제를 미룬다)
+ *
+ * MasterManager::swapMaster() 로 새 generation 을 공개한 뒤 retireMaster() 가 synchronize() 로
+ * 그 시점에 읽고 있던 reader 가 모두 빠져나가기를 기다렸다가 이전 인스턴스를 지운다.
+ * reader 는 스레드마다 Reader 를 하나 등록하고, 마스터 포인터를 얻어 쓰는 구간을 Guard 로 감싼다.
+ *
+ *   MasterEpoch::Reader reader(manager.epoch());     // 스레드당 한번
+ *   {
+ *       MasterEpoch::Guard guard(reader);
+ *       Master* master = manager.getMaster("JAPAN_EQUITY_MASTER");
+ *       ...                                          // guard 안에서만 master 사용
+ *   }
+ *
+ * enter / exit 는 자기 slot 에 store 한번씩이라 reader 끼리 cache line 을 나눠쓰지 않는다.
+ * slot 배열은 따로 64 byte 정렬로 할당한다 (C++14 의 new MasterManager 는 alignas(64) 멤버를 맞춰주지 않음).
+ * 교체를 하는 스레드 (T2MA event loop) 와 같은 스레드의 reader 는 Guard 가 필요 없다.
+ */
+#define MASTER_EPOCH_MAX_READERS 64
+
+class MasterEpoch {
+private:
+    struct alignas(64) Slot {
+        std::atomic<uint64_t> epoch;    // 0: 읽는 중 아님, 그 외: 들어올 때의 global epoch
+        std::atomic<bool> used;
+    };
+
+    Slot* _slots;                       // MASTER_EPOCH_MAX_READERS 개, posix_memalign(64)
+    std::atomic<uint64_t> _global;
+
+public:
+    MasterEpoch() : _slots(nullptr), _global(1) {
+        void* p = nullptr;
+        if (posix_memalign(&p, 64, sizeof(Slot) * MASTER_EPOCH_MAX_READERS) != 0) {
+            throw std::bad_alloc();
+        }
+        _slots = static_cast<Slot*>(p);
+        for (int i = 0; i < MASTER_EPOCH_MAX_READERS; i++) {
+            new (&_slots[i]) Slot();
+            _slots[i].epoch.store(0);
+            _slots[i].used.store(false);
+        }
+    }
+
+    ~MasterEpoch() {
+        for (int i = 0; i < MASTER_EPOCH_MAX_READERS; i++) {
+            _slots[i].~Slot();
+        }
+        free(_slots);
+    }
+
+    MasterEpoch(const MasterEpoch&) = delete;
+    MasterEpoch& operator=(const MasterEpoch&) = delete;
+
+    // reader slot (없으면 -1: 그 reader 는 Guard 없이 동작하므로 교체 중 접근을 피해야 한다)
+    int register_reader() {
+        for (int i = 0; i < MASTER_EPOCH_MAX_READERS; i++) {
+            bool expected = false;
+            if (_slots[i].used.compare_exchange_strong(expected, true)) {
+                _slots[i].epoch.store(0, std::memory_order_relaxed);
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    void unregister_reader(int slot) {
+        if (slot < 0) return;
+        _slots[slot].epoch.store(0, std::memory_order_release);
+        _slots[slot].used.store(false, std::memory_order_release);
+    }
+
+    // seq_cst store: 이후 마스터 포인터 load 보다 먼저 보여야 synchronize() 가 놓치지 않는다
+    inline void enter(int slot) {
+        if (slot >= 0) _slots[slot].epoch.store(_global.load(std::memory_order_relaxed), std::memory_order_seq_cst);
+    }
+
+    inline void exit(int slot) {
+        if (slot >= 0) _slots[slot].epoch.store(0, std::memory_order_release);
+    }
+
+    // 호출 전에 공개된 교체를 모든 reader 가 보았을 때까지 대기 (writer 쪽, 백그라운드 스레드에서)
+    void synchronize() {
+        uint64_t target = _global.fetch_add(1, std::memory_order_seq_cst) + 1;
+        for (int i = 0; i < MASTER_EPOCH_MAX_READERS; i++) {
+            if (!_slots[i].used.load(std::memory_order_acquire)) continue;
+            for (;;) {
+                uint64_t e = _slots[i].epoch.load(std::memory_order_seq_cst);
+                if (e == 0 || e >= target) break;
+                sched_yield();
+            }
+        }
+    }
+
+    uint64_t current() const { return _global.load(std::memory_order_relaxed); }
+
+    // 스레드별 등록 (RAII)
+    class Reader {
+    private:
+        MasterEpoch& _epoch;
+        int _slot;
+
+    public:
+        explicit Reader(MasterEpoch& epoch) : _epoch(epoch), _slot(epoch.register_reader()) {}
+        ~Reader() { _epoch.unregister_reader(_slot); }
+
+        Reader(const Reader&) = delete;
+        Reader& operator=(const Reader&) = delete;
+
+        void enter() { _epoch.enter(_slot); }
+        void exit() { _epoch.exit(_slot); }
+        bool registered() const { return _slot >= 0; }
+    };
+
+    class Guard {
+    private:
+        Reader& _reader;
+
+    public:
+        explicit Guard(Reader& reader) : _reader(reader) { _reader.enter(); }
+        ~Guard() { _reader.exit(); }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+    };
+};
+
+#endif // MASTER_EPOCH_H
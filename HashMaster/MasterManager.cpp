@@ -1,6 +1,9 @@
 #include "MasterManager.h"
 #include "HashMaster.h"
 #include "MemoryMaster.h"
+#include "SlabMemoryMaster.h"
+#include "SpecCache.h"
+#include "../common/AsyncLog.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
@@ -8,6 +11,8 @@
 #include <cstdarg>
 #include <cstring>
 #include <algorithm>
+#include <chrono>
+#include <thread>
 
 MasterManager::MasterManager(LogLevel log_level) : log_level_(log_level) {
     log(LOG_INFO, "MasterManager initialized with log level %d", static_cast<int>(log_level));
@@ -24,51 +29,72 @@ bool MasterManager::loadMasterConfigs(const std::string& config_directory) {
 
     log(LOG_INFO, "Loading master configurations from directory: %s", config_directory.c_str());
 
-    DIR* dir = opendir(config_directory.c_str());
-    if (!dir) {
+    std::vector<std::string> files;
+    uint64_t hash = 0;
+    if (!SpecCache::scanDirectory(config_directory, ".yaml", files, hash)) {
         log(LOG_ERROR, "Failed to open config directory: %s", config_directory.c_str());
         return false;
     }
 
-    struct dirent* entry;
-    int loaded_count = 0;
-
-    while ((entry = readdir(dir)) != nullptr) {
-        std::string filename = entry->d_name;
-
-        // Skip non-YAML files
-        if (filename.length() < 5 || filename.substr(filename.length() - 5) != ".yaml") {
-            continue;
+    // 디렉토리 내용이 같으면 파싱한 key-value 표를 cache 에서 읽는다
+    bool use_cache = SpecCache::enabled();
+    std::string cache_path = SpecCache::cachePath(config_directory);
+    SpecCache::TableList tables;
+    bool cached = use_cache && SpecCache::loadTables(cache_path, hash, tables);
+    if (cached) {
+        log(LOG_INFO, "Using master config cache: %s", cache_path.c_str());
+    } else {
+        for (const auto& filename : files) {
+            std::string filepath = config_directory + "/" + filename;
+            std::cout << "Loading master config file: " << filepath << std::endl;
+            tables.push_back(std::make_pair(filename, parseSimpleYAML(filepath)));
         }
+    }
 
-        std::string filepath = config_directory + "/" + filename;
-        if (loadMasterConfigFile(filepath)) {
-            loaded_count++;
+    int loaded_count = 0;
+    for (const auto& table : tables) {
+        std::string filepath = config_directory + "/" + table.first;
+        MasterInfo info;
+        if (!buildMasterInfo(filepath, table.second, info)) {
+            continue;
         }
+        master_infos_[info.name] = info;
+        log(LOG_INFO, "Loaded master config: %s (%s)", info.name.c_str(), info.getMasterTypeString().c_str());
+        loaded_count++;
     }
 
-    closedir(dir);
+    if (use_cache && !cached && !SpecCache::saveTables(cache_path, hash, tables)) {
+        log(LOG_WARNING, "Cannot write master config cache: %s", cache_path.c_str());
+    }
 
     log(LOG_INFO, "Loaded %d master configurations", loaded_count);
     return loaded_count > 0;
 }
 
-bool MasterManager::loadMasterConfigFile(const std::string& filepath) {
-    try {
-        std::cout << "Loading master config file: " << filepath << std::endl;
-        // Parse YAML file into key-value map
-        std::map<std::string, std::string> config_map = parseSimpleYAML(filepath);
+bool MasterManager::parseMasterConfigFile(const std::string& filepath, MasterInfo& info) {
+    std::cout << "Loading master config file: " << filepath << std::endl;
+    // Parse YAML file into key-value map
+    return buildMasterInfo(filepath, parseSimpleYAML(filepath), info);
+}
 
+bool MasterManager::buildMasterInfo(const std::string& filepath, const std::map<std::string, std::string>& config_map,
+                                    MasterInfo& info) {
+    try {
         if (config_map.empty()) {
             log(LOG_ERROR, "Failed to parse YAML file: %s", filepath.c_str());
             return false;
         }
 
+        auto value_of = [&](const char* key, const char* def) {
+            auto it = config_map.find(key);
+            return it != config_map.end() ? it->second : std::string(def);
+        };
+
         // Parse basic info
-        std::string name = config_map.count("name") ? config_map["name"] : "";
-        std::string description = config_map.count("description") ? config_map["description"] : "";
-        std::string layout = config_map.count("layout") ? config_map["layout"] : "";
-        std::string type_str = config_map.count("master_type") ? config_map["master_type"] : "HashMaster";
+        std::string name = value_of("name", "");
+        std::string description = value_of("description", "");
+        std::string layout = value_of("layout", "");
+        std::string type_str = value_of("master_type", "HashMaster");
 
         if (name.empty()) {
             log(LOG_ERROR, "Master name is required in %s", filepath.c_str());
@@ -81,11 +107,8 @@ bool MasterManager::loadMasterConfigFile(const std::string& filepath) {
         // Parse master config
         MasterConfig config = parseMasterConfig(config_map);
 
-        // Store master info
-        MasterInfo info(name, description, layout, master_type, config);
-        master_infos_[name] = info;
-
-        log(LOG_INFO, "Loaded master config: %s (%s)", name.c_str(), info.getMasterTypeString().c_str());
+        info = MasterInfo(name, description, layout, master_type, config);
+        info.config_file = filepath;
         return true;
 
     } catch (const std::exception& e) {
@@ -181,6 +204,16 @@ MasterConfig MasterManager::parseMasterConfig(const std::map<std::string, std::s
     parseInt("primary_field_len", config._primary_field_len);
     parseInt("secondary_field_len", config._secondary_field_len);
     parseBool("use_lock", config._use_lock);
+    parseBool("lock_free_read", config._lock_free_read);
+    parseInt("index_version", config._index_version);
+    parseString("hash_function", config._hash_function);
+    parseBool("auto_grow", config._auto_grow);
+    parseBool("mmap_populate", config._mmap.populate);
+    parseBool("mmap_hugepage", config._mmap.hugepage);
+    parseBool("mmap_willneed", config._mmap.willneed);
+    parseBool("mmap_lock", config._mmap.lock);
+    parseBool("warm", config._mmap.warm);
+    parseInt("numa_node", config._mmap.numa_node);
     parseString("filename", config._filename);
 
     // Parse log level
@@ -198,6 +231,8 @@ MasterConfig MasterManager::parseMasterConfig(const std::map<std::string, std::s
 MasterType MasterManager::parseMasterType(const std::string& type_str) {
     if (type_str == "MemoryMaster") {
         return MasterType::MEMORY_MASTER;
+    } else if (type_str == "SlabMemoryMaster") {
+        return MasterType::SLAB_MEMORY_MASTER;
     } else if (type_str == "HashMaster") {
         return MasterType::HASH_MASTER;
     } else {
@@ -207,7 +242,13 @@ MasterType MasterManager::parseMasterType(const std::string& type_str) {
 }
 
 std::unique_ptr<Master> MasterManager::createMasterInstance(const MasterInfo& info) {
-    return createMaster(info.master_type, info.config);
+    MasterConfig config = info.config;
+    config._mmap.numa_node = numaNodeOf(info);
+    return createMaster(info.master_type, config);
+}
+
+int MasterManager::numaNodeOf(const MasterInfo& info) const {
+    return info.config._mmap.numa_node >= 0 ? info.config._mmap.numa_node : numa_node_;
 }
 
 std::unique_ptr<Master> MasterManager::createMaster(MasterType type, const MasterConfig& config) {
@@ -222,6 +263,11 @@ std::unique_ptr<Master> MasterManager::createMaster(MasterType type, const Maste
             hash_config._primary_field_len = config._primary_field_len;
             hash_config._secondary_field_len = config._secondary_field_len;
             hash_config._use_lock = config._use_lock;
+            hash_config._lock_free_read = config._lock_free_read;
+            hash_config._index_version = config._index_version;
+            hash_config._hash_function = config._hash_function;
+            hash_config._auto_grow = config._auto_grow;
+            hash_config._mmap = config._mmap;
             hash_config._filename = config._filename;
             hash_config._log_level = config._log_level;
 
@@ -244,6 +290,10 @@ std::unique_ptr<Master> MasterManager::createMaster(MasterType type, const Maste
             return std::make_unique<MemoryMaster>(memory_config);
         }
 
+        case MasterType::SLAB_MEMORY_MASTER:
+            // MasterConfig 그대로 사용 (lock_free_read / hash_function 포함)
+            return std::make_unique<SlabMemoryMaster>(config);
+
         default:
             return nullptr;
     }
@@ -288,11 +338,23 @@ std::vector<std::string> MasterManager::getMasterNamesByType(MasterType type) co
     return names;
 }
 
+std::vector<std::string> MasterManager::getOpenMasterNames() const {
+    std::vector<std::string> names;
+    std::lock_guard<std::mutex> lock(masters_mutex_);
+    for (const auto& pair : masters_) {
+        names.push_back(pair.first);
+    }
+    return names;
+}
+
 Master* MasterManager::getMaster(const std::string& name) {
     // Check if master is already created and initialized
-    auto it = masters_.find(name);
-    if (it != masters_.end()) {
-        return it->second.get();
+    {
+        std::lock_guard<std::mutex> lock(masters_mutex_);
+        auto it = masters_.find(name);
+        if (it != masters_.end()) {
+            return it->second.get();
+        }
     }
 
     // Create and initialize master
@@ -306,7 +368,85 @@ Master* MasterManager::createMaster(const std::string& name) {
         return nullptr;
     }
 
-    const MasterInfo& info = info_it->second;
+    auto master = openMaster(info_it->second);
+    if (!master) {
+        return nullptr;
+    }
+
+    Master* master_ptr = master.get();
+    std::lock_guard<std::mutex> lock(masters_mutex_);
+    masters_[name] = std::move(master);
+
+    return master_ptr;
+}
+
+// 마스터마다 스레드 하나로 open (+ warm) 과 loader 를 돌린다. 이미 열린 마스터는 건너뛴다.
+// 마스터끼리는 파일/메모리를 공유하지 않으므로 init 과 적재가 서로 기다릴 이유가 없다.
+bool MasterManager::openMasters(const std::vector<std::string>& names, const MasterLoader& loader) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<const MasterInfo*> infos;
+    bool ok = true;
+    for (const auto& name : names) {
+        auto info_it = master_infos_.find(name);
+        if (info_it == master_infos_.end()) {
+            log(LOG_ERROR, "Master configuration not found: %s", name.c_str());
+            ok = false;
+            continue;
+        }
+        {
+            std::lock_guard<std::mutex> lock(masters_mutex_);
+            if (masters_.count(name)) continue;
+        }
+        if (std::find(infos.begin(), infos.end(), &info_it->second) == infos.end()) {
+            infos.push_back(&info_it->second);
+        }
+    }
+
+    std::vector<std::unique_ptr<Master>> opened(infos.size());
+    std::vector<char> loaded(infos.size(), 0);
+    auto open_one = [&](size_t i) {
+        // 파일을 처음 읽는 스레드의 정책으로 page cache 가 잡히므로 open / warm / loader 를 그 node 에서 한다
+        NumaPlacement::ScopedPreferredNode numa(numaNodeOf(*infos[i]));
+        opened[i] = openMaster(*infos[i]);
+        if (!opened[i]) return;
+        if (loader && !loader(infos[i]->name, opened[i].get())) {
+            log(LOG_ERROR, "Failed to load master: %s", infos[i]->name.c_str());
+            return;
+        }
+        loaded[i] = 1;
+    };
+
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < infos.size(); i++) {
+        workers.emplace_back(open_one, i);
+    }
+    if (!infos.empty()) open_one(0);
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    // 적재까지 끝난 것만 등록 (실패한 마스터는 getMaster 가 나중에 다시 시도할 수 있다)
+    {
+        std::lock_guard<std::mutex> lock(masters_mutex_);
+        for (size_t i = 0; i < infos.size(); i++) {
+            if (loaded[i]) {
+                masters_[infos[i]->name] = std::move(opened[i]);
+            } else {
+                ok = false;
+            }
+        }
+    }
+
+    long ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    log(LOG_INFO, "Opened %zu masters in parallel in %ld ms", infos.size(), ms);
+    return ok;
+}
+
+// 인스턴스 생성 + init (+ warm)
+std::unique_ptr<Master> MasterManager::openMaster(const MasterInfo& info) {
+    const std::string& name = info.name;
 
     // Create master instance
     auto master = createMasterInstance(info);
@@ -324,10 +464,76 @@ Master* MasterManager::createMaster(const std::string& name) {
 
     log(LOG_INFO, "Created and initialized master: %s (%s)", name.c_str(), info.getMasterTypeString().c_str());
 
-    Master* master_ptr = master.get();
-    masters_[name] = std::move(master);
+    // feed 가 들어오기 전에 index / record page fault 를 미리 치른다
+    if (info.config._mmap.warm) {
+        auto start = std::chrono::steady_clock::now();
+        result = master->warm();
+        long ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        if (result != MASTER_OK) {
+            log(LOG_WARNING, "Failed to warm master %s: %d", name.c_str(), result);
+        } else {
+            log(LOG_INFO, "Warmed master %s in %ld ms", name.c_str(), ms);
+        }
+    }
 
-    return master_ptr;
+    return master;
+}
+
+// 파일 기반 마스터는 새 generation 도 같은 파일을 열기 때문에 파일 크기를 정하는 설정이 같아야 한다
+static bool same_storage_layout(const MasterConfig& a, const MasterConfig& b) {
+    return a._max_record_count == b._max_record_count && a._max_record_size == b._max_record_size &&
+           a._hash_count == b._hash_count && a._primary_field_len == b._primary_field_len &&
+           a._secondary_field_len == b._secondary_field_len && a._filename == b._filename;
+}
+
+std::unique_ptr<Master> MasterManager::buildMaster(const std::string& name) {
+    auto info_it = master_infos_.find(name);
+    if (info_it == master_infos_.end()) {
+        log(LOG_ERROR, "Master configuration not found: %s", name.c_str());
+        return nullptr;
+    }
+
+    // YAML 을 다시 읽는다 (실패하면 기존 설정 그대로). master_infos_ 는 바꾸지 않으므로
+    // 새 generation 의 설정은 get_config() 로 본다.
+    const MasterInfo& current = info_it->second;
+    MasterInfo info = current;
+    MasterInfo reloaded;
+    if (!current.config_file.empty() && parseMasterConfigFile(current.config_file, reloaded) && reloaded.name == name) {
+        info = reloaded;
+    }
+    if (current.master_type == MasterType::HASH_MASTER &&
+        (info.master_type != current.master_type || !same_storage_layout(current.config, info.config))) {
+        log(LOG_ERROR, "Storage layout of %s changed in %s, restart required to apply it",
+            name.c_str(), current.config_file.c_str());
+        return nullptr;
+    }
+
+    auto master = openMaster(info);
+    if (master) {
+        log(LOG_INFO, "Built new generation of master %s", name.c_str());
+    }
+    return master;
+}
+
+std::unique_ptr<Master> MasterManager::swapMaster(const std::string& name, std::unique_ptr<Master> next) {
+    std::lock_guard<std::mutex> lock(masters_mutex_);
+    std::unique_ptr<Master> old = std::move(masters_[name]);
+    masters_[name] = std::move(next);
+    log(LOG_INFO, "Swapped master %s (epoch %llu)", name.c_str(), (unsigned long long)epoch_.current());
+    return old;
+}
+
+void MasterManager::retireMaster(std::unique_ptr<Master> old) {
+    if (!old) {
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+    epoch_.synchronize();
+    old.reset();
+    long ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start).count();
+    log(LOG_INFO, "Retired previous master generation in %ld ms", ms);
 }
 
 bool MasterManager::initializeMaster(const std::string& name) {
@@ -335,6 +541,7 @@ bool MasterManager::initializeMaster(const std::string& name) {
 }
 
 void MasterManager::closeMaster(const std::string& name) {
+    std::lock_guard<std::mutex> lock(masters_mutex_);
     auto it = masters_.find(name);
     if (it != masters_.end()) {
         log(LOG_INFO, "Closing master: %s", name.c_str());
@@ -343,6 +550,7 @@ void MasterManager::closeMaster(const std::string& name) {
 }
 
 void MasterManager::closeAllMasters() {
+    std::lock_guard<std::mutex> lock(masters_mutex_);
     if (!masters_.empty()) {
         log(LOG_INFO, "Closing all masters (%zu)", masters_.size());
         masters_.clear();
@@ -405,17 +613,20 @@ void MasterManager::displayMasterSummary() const {
     std::cout << "Active masters: " << masters_.size() << std::endl;
 
     // Group by type
-    int hash_count = 0, memory_count = 0;
+    int hash_count = 0, memory_count = 0, slab_count = 0;
     for (const auto& pair : master_infos_) {
         if (pair.second.master_type == MasterType::HASH_MASTER) {
             hash_count++;
         } else if (pair.second.master_type == MasterType::MEMORY_MASTER) {
             memory_count++;
+        } else if (pair.second.master_type == MasterType::SLAB_MEMORY_MASTER) {
+            slab_count++;
         }
     }
 
     std::cout << "HashMaster configs: " << hash_count << std::endl;
     std::cout << "MemoryMaster configs: " << memory_count << std::endl;
+    std::cout << "SlabMemoryMaster configs: " << slab_count << std::endl;
 
     std::cout << "\nMaster list:" << std::endl;
     for (const auto& pair : master_infos_) {
@@ -433,21 +644,8 @@ void MasterManager::log(LogLevel level, const char* format, ...) {
         return;
     }
 
-    const char* level_str;
-    switch (level) {
-        case LOG_ERROR: level_str = "ERROR"; break;
-        case LOG_WARNING: level_str = "WARNING"; break;
-        case LOG_INFO: level_str = "INFO"; break;
-        case LOG_DEBUG: level_str = "DEBUG"; break;
-        default: level_str = "UNKNOWN"; break;
-    }
-
-    printf("[%s] MasterManager: ", level_str);
-
     va_list args;
     va_start(args, format);
-    vprintf(format, args);
+    SimplePubSub::AsyncLogger::instance().logv(level, "MasterManager", format, args);
     va_end(args);
-
-    printf("\n");
 }
\ No newline at end of file
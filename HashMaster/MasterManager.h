@@ -2,18 +2,22 @@
 #define MASTER_MANAGER_H
 
 #include "Master.h"
+#include "MasterEpoch.h"
 #include "../common/Compat.h"  // For GCC 4.8.5 compatibility
 #include <string>
 #include <map>
 #include <memory>
 #include <vector>
+#include <mutex>
+#include <functional>
 #include <fstream>
 #include <sstream>
 
 // Supported Master implementation types
 enum class MasterType {
-    HASH_MASTER,    // File-based HashMaster
-    MEMORY_MASTER   // In-memory MemoryMaster
+    HASH_MASTER,        // File-based HashMaster
+    MEMORY_MASTER,      // In-memory MemoryMaster
+    SLAB_MEMORY_MASTER  // In-memory SlabMemoryMaster (slab + inline keys, 할당 없는 조회)
 };
 
 // Master configuration information loaded from YAML files
@@ -23,6 +27,7 @@ struct MasterInfo {
     std::string layout;
     MasterType master_type;
     MasterConfig config;
+    std::string config_file;    // 읽어온 YAML 경로 (buildMaster 가 다시 읽는다)
 
     MasterInfo() : master_type(MasterType::HASH_MASTER) {}
     MasterInfo(const std::string& n, const std::string& desc, const std::string& lay,
@@ -33,6 +38,7 @@ struct MasterInfo {
         switch (master_type) {
             case MasterType::HASH_MASTER: return "HashMaster";
             case MasterType::MEMORY_MASTER: return "MemoryMaster";
+            case MasterType::SLAB_MEMORY_MASTER: return "SlabMemoryMaster";
             default: return "Unknown";
         }
     }
@@ -48,7 +54,7 @@ struct MasterInfo {
  * Example YAML configuration:
  * name: "JAPAN_EQUITY_MASTER"
  * description: "일본 주식 마스터"
- * master_type: "HashMaster"  # or "MemoryMaster"
+ * master_type: "HashMaster"  # or "MemoryMaster", "SlabMemoryMaster"
  * layout: "MMP_EQUITY_MASTER"
  * max_record_count: 50000
  * # ... other MasterConfig fields
@@ -57,20 +63,41 @@ struct MasterInfo {
  * MasterManager manager;
  * manager.loadMasterConfigs("config/MASTERs");
  * Master* master = manager.getMaster("JAPAN_EQUITY_MASTER");
+ *
+ * Open several masters at startup in parallel (one thread per master, loader runs on that thread):
+ * manager.openMasters({"JAPAN_EQUITY_MASTER", "NASDAQ_BASIC_EQUITY_MASTER"},
+ *                     [](const std::string& name, Master* master) { return load(name, master); });
+ *
+ * Reload without stopping readers (snapshot-and-swap):
+ * std::unique_ptr<Master> next = manager.buildMaster("JAPAN_EQUITY_MASTER");  // background thread
+ * next->bulk_load(rows, count);
+ * auto old = manager.swapMaster("JAPAN_EQUITY_MASTER", std::move(next));    // publish
+ * manager.retireMaster(std::move(old));   // waits for MasterEpoch readers, then frees
  */
 class MasterManager {
+public:
+    // openMasters 에서 open 직후 (등록 전) 마스터를 채우는 함수, false 면 그 마스터는 등록하지 않는다
+    typedef std::function<bool(const std::string& name, Master* master)> MasterLoader;
+
 private:
     std::string config_directory_;
     std::map<std::string, MasterInfo> master_infos_;
     std::map<std::string, std::unique_ptr<Master>> masters_;
+    mutable std::mutex masters_mutex_;     // masters_ (swapMaster 는 다른 스레드에서 올 수 있다)
+    MasterEpoch epoch_;
     LogLevel log_level_;
+    int numa_node_ = -1;                   // 마스터 yaml 에 numa_node 가 없을 때 쓰는 node (-1: 지정 안함)
 
     // Helper methods
-    bool loadMasterConfigFile(const std::string& filepath);
+    bool parseMasterConfigFile(const std::string& filepath, MasterInfo& info);
+    bool buildMasterInfo(const std::string& filepath, const std::map<std::string, std::string>& config_map,
+                         MasterInfo& info);
     std::map<std::string, std::string> parseSimpleYAML(const std::string& filepath);
     MasterConfig parseMasterConfig(const std::map<std::string, std::string>& config_map);
     MasterType parseMasterType(const std::string& type_str);
     std::unique_ptr<Master> createMasterInstance(const MasterInfo& info);
+    int numaNodeOf(const MasterInfo& info) const;
+    std::unique_ptr<Master> openMaster(const MasterInfo& info);
     void log(LogLevel level, const char* format, ...);
 
 public:
@@ -78,22 +105,42 @@ public:
     ~MasterManager();
 
     // Configuration loading
+    // 디렉토리 내용이 바뀌지 않았으면 "<config_directory>.cache" 의 파싱 결과를 쓴다 (SpecCache.h)
     bool loadMasterConfigs(const std::string& config_directory);
     void reload();
 
+    // 마스터 매핑 / 적재 스레드 할당을 둘 NUMA node (마스터 yaml 의 numa_node 가 우선, open 전에 호출)
+    void setNumaNode(int node) { numa_node_ = node; }
+    int getNumaNode() const { return numa_node_; }
+
     // Master information access
     bool hasMaster(const std::string& name) const;
     const MasterInfo* getMasterInfo(const std::string& name) const;
     std::vector<std::string> getMasterNames() const;
     std::vector<std::string> getMasterNamesByType(MasterType type) const;
+    // 이미 열려 있는 마스터 이름 (getMaster 와 달리 새로 열지 않는다)
+    std::vector<std::string> getOpenMasterNames() const;
 
     // Master instance management
     Master* getMaster(const std::string& name);
     Master* createMaster(const std::string& name);
     bool initializeMaster(const std::string& name);
+    // names 를 마스터마다 스레드 하나로 동시에 open (+ warm) 하고 loader 로 채운 뒤 등록 (모두 성공하면 true)
+    bool openMasters(const std::vector<std::string>& names, const MasterLoader& loader = MasterLoader());
     void closeMaster(const std::string& name);
     void closeAllMasters();
 
+    // Generation swap (reload 중에도 reader 를 멈추지 않는다)
+    //  buildMaster  : YAML 을 다시 읽어 새 인스턴스를 만들고 init (등록하지 않음, 백그라운드 스레드에서 호출 가능)
+    //                 HashMaster 는 같은 파일을 열므로 크기 설정이 바뀌었으면 실패한다 (재시작 필요).
+    //                 새 파일은 bulk_load 가 rename 으로 바꿔 넣으므로 이전 인스턴스의 매핑은 그대로 남는다
+    //  swapMaster   : name 의 현재 인스턴스를 next 로 바꾸고 이전 인스턴스를 돌려준다
+    //  retireMaster : epoch() reader 가 모두 빠져나간 뒤 이전 인스턴스를 지운다
+    std::unique_ptr<Master> buildMaster(const std::string& name);
+    std::unique_ptr<Master> swapMaster(const std::string& name, std::unique_ptr<Master> next);
+    void retireMaster(std::unique_ptr<Master> old);
+    MasterEpoch& epoch() { return epoch_; }
+
     // Statistics and monitoring
     void displayAllMasterStats() const;
     void displayMasterInfo(const std::string& name) const;
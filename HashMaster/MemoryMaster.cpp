@@ -1,4 +1,5 @@
 #include "MemoryMaster.h"
+#include "../common/AsyncLog.h"
 #include <cstdarg>
 #include <cstring>
 #include <iostream>
@@ -9,7 +10,8 @@
 
 // Constructor with MemoryMasterConfig
 MemoryMaster::MemoryMaster(const MemoryMasterConfig& config)
-    : Master(config), _lookup_count(0), _insert_count(0), _delete_count(0), _collision_count(0) {
+    : Master(config), _lookup_count("memory_master.lookup"), _insert_count("memory_master.insert"),
+      _delete_count("memory_master.delete"), _collision_count("memory_master.collision") {
 
     log(LOG_INFO, "MemoryMaster created with config: max_records=%d, max_size=%d, hash_count=%d",
         _config._max_record_count, _config._max_record_size, _config._hash_count);
@@ -17,7 +19,8 @@ MemoryMaster::MemoryMaster(const MemoryMasterConfig& config)
 
 // Constructor with base MasterConfig
 MemoryMaster::MemoryMaster(const MasterConfig& config)
-    : Master(config), _lookup_count(0), _insert_count(0), _delete_count(0), _collision_count(0) {
+    : Master(config), _lookup_count("memory_master.lookup"), _insert_count("memory_master.insert"),
+      _delete_count("memory_master.delete"), _collision_count("memory_master.collision") {
 
     log(LOG_INFO, "MemoryMaster created with base config: max_records=%d, max_size=%d",
         _config._max_record_count, _config._max_record_size);
@@ -56,10 +59,10 @@ int MemoryMaster::init() {
         }
 
         // Reset statistics
-        _lookup_count = 0;
-        _insert_count = 0;
-        _delete_count = 0;
-        _collision_count = 0;
+        _lookup_count.reset();
+        _insert_count.reset();
+        _delete_count.reset();
+        _collision_count.reset();
 
         _initialized = true;
         log(LOG_INFO, "MemoryMaster initialized successfully");
@@ -92,10 +95,10 @@ int MemoryMaster::clear() {
         }
 
         // Reset statistics
-        _lookup_count = 0;
-        _insert_count = 0;
-        _delete_count = 0;
-        _collision_count = 0;
+        _lookup_count.reset();
+        _insert_count.reset();
+        _delete_count.reset();
+        _collision_count.reset();
 
         log(LOG_INFO, "MemoryMaster cleared successfully");
         if (_config._use_lock) {
@@ -193,6 +196,112 @@ int MemoryMaster::put(const char* pkey, const char* skey, const char* record, in
     }
 }
 
+// Replace all records in one pass (single lock, no per-record lookup)
+int MemoryMaster::bulk_load(const MasterBulkRecord* records, int count, int* loaded) {
+    if (loaded) {
+        *loaded = 0;
+    }
+    if (!_initialized) {
+        log(LOG_ERROR, "MemoryMaster not initialized");
+        return MASTER_ERROR_NOT_INITIALIZED;
+    }
+    if (!records && count > 0) {
+        return MASTER_ERROR_NULL_POINTER;
+    }
+
+    if (_config._use_lock) {
+        pthread_mutex_lock(&_rw_mutex);
+    }
+
+    try {
+        const int capacity = _config._max_record_count;
+        _records.clear();
+        _records.resize(capacity);
+        _primary_index.clear();
+        _secondary_index.clear();
+        _free_slots.clear();
+        _primary_index.reserve(count < capacity ? count : capacity);
+        _secondary_index.reserve(count < capacity ? count : capacity);
+
+        int slot = 0;
+        int skipped = 0;
+        bool full = false;
+        for (int i = 0; i < count; ++i) {
+            const MasterBulkRecord& r = records[i];
+            if (!is_valid_key(r.pkey) || !r.record || r.record_size <= 0 || r.record_size > _config._max_record_size) {
+                skipped++;
+                continue;
+            }
+            if (slot >= capacity) {
+                full = true;
+                break;
+            }
+
+            std::string primary_key(r.pkey);
+            std::string secondary_key = r.skey ? std::string(r.skey) : "";
+            if (!_primary_index.emplace(primary_key, slot).second) {
+                skipped++;
+                continue;
+            }
+            if (!secondary_key.empty() && !_secondary_index.emplace(secondary_key, slot).second) {
+                _primary_index.erase(primary_key);
+                skipped++;
+                continue;
+            }
+
+            _records[slot] = std::make_unique<MemoryRecord>(r.record, r.record_size, primary_key, secondary_key);
+            slot++;
+        }
+
+        // put 은 _free_slots 끝에서 꺼내므로 clear() 와 같이 오름차순으로 둔다
+        _free_slots.reserve(capacity - slot);
+        for (int i = slot; i < capacity; ++i) {
+            _free_slots.push_back(i);
+        }
+
+        _lookup_count.reset();
+        _insert_count.reset();
+        _delete_count.reset();
+        _collision_count.reset();
+        _insert_count.inc(slot);
+
+        if (_config._use_lock) {
+            pthread_mutex_unlock(&_rw_mutex);
+        }
+
+        if (loaded) {
+            *loaded = slot;
+        }
+        log(LOG_INFO, "Bulk loaded %d of %d records (%d skipped)", slot, count, skipped);
+        return full ? MASTER_ERROR_NO_SPACE : MASTER_OK;
+
+    } catch (const std::exception& e) {
+        log(LOG_ERROR, "Failed to bulk load records: %s", e.what());
+        if (_config._use_lock) {
+            pthread_mutex_unlock(&_rw_mutex);
+        }
+        return MASTER_ERROR_MEMORY_ERROR;
+    }
+}
+
+int MemoryMaster::load_test_data(const std::vector<std::string>& primary_keys,
+                                 const std::vector<std::string>& secondary_keys,
+                                 const std::vector<std::vector<char>>& records) {
+    if (primary_keys.size() != records.size() ||
+        (!secondary_keys.empty() && secondary_keys.size() != primary_keys.size())) {
+        return MASTER_ERROR_INVALID_PARAMETER;
+    }
+
+    std::vector<MasterBulkRecord> bulk(primary_keys.size());
+    for (size_t i = 0; i < bulk.size(); ++i) {
+        bulk[i].pkey = primary_keys[i].c_str();
+        bulk[i].skey = secondary_keys.empty() ? nullptr : secondary_keys[i].c_str();
+        bulk[i].record = records[i].data();
+        bulk[i].record_size = (int)records[i].size();
+    }
+    return bulk_load(bulk.data(), (int)bulk.size());
+}
+
 // Retrieve record by primary key
 char* MemoryMaster::get_by_primary(const char* pkey) {
     if (!_initialized || !is_valid_key(pkey)) {
@@ -467,14 +576,16 @@ MemoryMaster::MemoryMasterStats MemoryMaster::get_memory_statistics() const {
     stats.record_utilization = static_cast<double>(stats.used_records) / stats.total_records;
 
     // Extended statistics
-    stats.lookup_count = _lookup_count;
-    stats.insert_count = _insert_count;
-    stats.delete_count = _delete_count;
-    stats.collision_count = _collision_count;
+    uint64_t lookups = _lookup_count.value();
+    uint64_t collisions = _collision_count.value();
+    stats.lookup_count = static_cast<int>(lookups);
+    stats.insert_count = static_cast<int>(_insert_count.value());
+    stats.delete_count = static_cast<int>(_delete_count.value());
+    stats.collision_count = static_cast<int>(collisions);
 
     // Calculate hit rate
-    if (_lookup_count > 0) {
-        stats.hit_rate = static_cast<double>(_lookup_count - _collision_count) / _lookup_count;
+    if (lookups > 0) {
+        stats.hit_rate = static_cast<double>(lookups - collisions) / lookups;
     } else {
         stats.hit_rate = 0.0;
     }
@@ -498,10 +609,10 @@ void MemoryMaster::reset_statistics() {
         pthread_mutex_lock(&_rw_mutex);
     }
 
-    _lookup_count = 0;
-    _insert_count = 0;
-    _delete_count = 0;
-    _collision_count = 0;
+    _lookup_count.reset();
+    _insert_count.reset();
+    _delete_count.reset();
+    _collision_count.reset();
 
     if (_config._use_lock) {
         pthread_mutex_unlock(&_rw_mutex);
@@ -553,15 +664,15 @@ bool MemoryMaster::is_valid_key(const char* key) const {
 }
 
 void MemoryMaster::update_statistics_on_insert() {
-    ++_insert_count;
+    _insert_count.inc();
 }
 
 void MemoryMaster::update_statistics_on_lookup() const {
-    ++_lookup_count;
+    _lookup_count.inc();
 }
 
 void MemoryMaster::update_statistics_on_delete() {
-    ++_delete_count;
+    _delete_count.inc();
 }
 
 // Logging implementation
@@ -570,15 +681,10 @@ void MemoryMaster::log(LogLevel level, const char* format, ...) {
         return;
     }
 
-    const char* level_str[] = {"DEBUG", "INFO", "WARN", "ERROR"};
-    printf("[%s] MemoryMaster: ", level_str[level]);
-
     va_list args;
     va_start(args, format);
-    vprintf(format, args);
+    SimplePubSub::AsyncLogger::instance().logv(level, "MemoryMaster", format, args);
     va_end(args);
-
-    printf("\n");
 }
 
 // Memory Iterator Implementation
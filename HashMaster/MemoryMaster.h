@@ -3,6 +3,7 @@
 
 #include "Master.h"
 #include "../common/Compat.h"  // For GCC 4.8.5 compatibility
+#include "../common/StatsRegistry.h"
 #include <unordered_map>
 #include <memory>
 #include <vector>
@@ -58,11 +59,11 @@ private:
     // Process-level thread safety using pthread_mutex
     mutable pthread_mutex_t _rw_mutex;
 
-    // Statistics
-    mutable int _lookup_count;
-    mutable int _insert_count;
-    mutable int _delete_count;
-    mutable int _collision_count;
+    // Statistics (스레드별 shard 카운터 - lock 없이 읽는 조회 경로에서도 cache line 경쟁 없음)
+    mutable SimplePubSub::StatsCounter _lookup_count;
+    mutable SimplePubSub::StatsCounter _insert_count;
+    mutable SimplePubSub::StatsCounter _delete_count;
+    mutable SimplePubSub::StatsCounter _collision_count;
 
     // Internal methods
     int find_free_slot();
@@ -121,6 +122,15 @@ public:
      */
     int put(const char* pkey, const char* skey, const char* record, int record_size) override;
 
+    /**
+     * @brief Replace the contents with a record set under a single lock acquisition
+     *
+     * Index maps are reserved up front and slots are assigned from 0 in input order.
+     * Rows put() would reject (invalid, duplicate primary or secondary key) are skipped.
+     * @return MASTER_OK, or MASTER_ERROR_NO_SPACE if count exceeded max_record_count
+     */
+    int bulk_load(const MasterBulkRecord* records, int count, int* loaded = nullptr) override;
+
     /**
      * @brief Retrieve record by primary key
      * @param pkey Primary key
@@ -0,0 +1,123 @@
+#ifndef MMAP_OPTIONS_H
+#define MMAP_OPTIONS_H
+
+#include <stddef.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/vfs.h>
+#include <vector>
+#include "../common/NumaPlacement.h"
+
+#ifndef HUGETLBFS_MAGIC
+#define HUGETLBFS_MAGIC 0x958458f6
+#endif
+
+/**
+ * mmap/ 파일 (HashMaster records, HashTable index) 매핑 옵션
+ *
+ * 기본값은 모두 off (4K page, 첫 접근 시 page fault). 큰 마스터는 시작 직후 전체를 훑을 때
+ * minor fault / TLB miss 가 몰리므로 마스터 yaml 에서 켠다.
+ *  - populate : mmap(MAP_POPULATE) 로 매핑 시 page table 까지 채움
+ *  - hugepage : madvise(MADV_HUGEPAGE). 파일 매핑은 tmpfs (huge=advise|within_size) 위에서만 THP 가 된다
+ *  - willneed : madvise(MADV_WILLNEED) page cache read-ahead
+ *  - lock     : mlock (RLIMIT_MEMLOCK 이 충분해야 함)
+ *  - warm     : init 후 Master::warm() 으로 모든 page 를 쓰기 fault 까지 미리 냄 (MasterManager)
+ *  - numa_node: mbind(MPOL_PREFERRED) 로 매핑을 그 node 에 둠 (이미 올라온 page 는 옮김, -1: 지정 안함).
+ *               이후 새로 읽는 page cache 는 적재 스레드의 정책을 따르므로 MasterManager 가 같이 건다
+ *
+ * mmap/ 가 hugetlbfs mount (또는 그쪽 symlink) 이면 파일 크기 / 매핑 길이를 huge page 배수로
+ * 맞춘다 (mmap_map_size). 마스터는 프로세스 간 / 재시작 간 경로로 공유하므로 memfd 는 쓰지 않는다.
+ * madvise / mlock 실패는 경고만 하고 매핑은 그대로 쓴다.
+ */
+struct MmapOptions {
+    bool populate;
+    bool hugepage;
+    bool willneed;
+    bool lock;
+    bool warm;
+    int numa_node;
+
+    MmapOptions() : populate(false), hugepage(false), willneed(false), lock(false), warm(false), numa_node(-1) {}
+};
+
+// hugetlbfs 위 파일이면 huge page 크기, 아니면 0
+inline size_t mmap_hugetlb_page_size(int fd) {
+    struct statfs sfs;
+    if (fstatfs(fd, &sfs) == 0 && (unsigned long)sfs.f_type == (unsigned long)HUGETLBFS_MAGIC) {
+        return (size_t)sfs.f_bsize;
+    }
+    return 0;
+}
+
+// ftruncate / mmap / munmap 에 쓸 길이 (hugetlbfs 는 huge page 배수여야 함)
+inline size_t mmap_map_size(int fd, size_t size) {
+    size_t huge = mmap_hugetlb_page_size(fd);
+    return huge ? (size + huge - 1) / huge * huge : size;
+}
+
+inline int mmap_flags(const MmapOptions& options) {
+    return MAP_SHARED | (options.populate ? MAP_POPULATE : 0);
+}
+
+// mbind / madvise / mlock 적용. 실패한 마지막 항목 이름 반환 (nullptr: 모두 성공, errno 는 그 항목의 값)
+inline const char* mmap_apply_options(void* addr, size_t len, const MmapOptions& options) {
+    const char* failed = nullptr;
+    // page 를 채우는 willneed / lock 보다 먼저 걸어야 새 page 가 그 node 에 잡힌다
+    if (options.numa_node >= 0 && !NumaPlacement::bind_memory(addr, len, options.numa_node)) failed = "mbind";
+#ifdef MADV_HUGEPAGE
+    if (options.hugepage && madvise(addr, len, MADV_HUGEPAGE) != 0) failed = "MADV_HUGEPAGE";
+#else
+    if (options.hugepage) failed = "MADV_HUGEPAGE";
+#endif
+    if (options.willneed && madvise(addr, len, MADV_WILLNEED) != 0) failed = "MADV_WILLNEED";
+    if (options.lock && mlock(addr, len) != 0) failed = "mlock";
+    return failed;
+}
+
+// 모든 page 를 쓰기 가능 상태로 fault 시킨다. 값은 바꾸지 않으므로 (atomic += 0) 다른 프로세스가
+// 같은 파일을 쓰는 중이어도 안전하다. MADV_POPULATE_WRITE (5.14+) 가 있으면 그것을 쓴다.
+inline void mmap_prefault(void* addr, size_t len) {
+    if (!addr || addr == MAP_FAILED || len == 0) return;
+#ifdef MADV_POPULATE_WRITE
+    if (madvise(addr, len, MADV_POPULATE_WRITE) == 0) return;
+#endif
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char* p = static_cast<char*>(addr);
+    for (size_t off = 0; off < len; off += page) {
+        __atomic_fetch_add(reinterpret_cast<int*>(p + off), 0, __ATOMIC_RELAXED);
+    }
+}
+
+// ===== 읽기 전용 scan (viewer 등) 의 page cache 영향 줄이기 =====
+// 훑기 전에 mmap_residency 로 이미 올라와 있던 page 를 기록하고, 다 읽은 뒤 mmap_release_cold 로
+// 원래 없던 page 만 놓아준다 (feed 가 쓰던 page 는 그대로 두고 scan 이 올린 page 만 내림).
+// addr / file_offset 은 page 경계여야 한다.
+
+inline bool mmap_residency(void* addr, size_t len, std::vector<unsigned char>& pages) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    pages.assign((len + page - 1) / page, 1);
+    return len == 0 || mincore(addr, len, pages.data()) == 0;
+}
+
+inline void mmap_release_cold(void* addr, size_t len, int fd, off_t file_offset, const std::vector<unsigned char>& pages) {
+    const size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    char* base = static_cast<char*>(addr);
+    size_t count = (len + page - 1) / page;
+    for (size_t i = 0; i < count && i < pages.size();) {
+        if (pages[i] & 1) {
+            i++;
+            continue;
+        }
+        size_t j = i;
+        while (j < count && j < pages.size() && !(pages[j] & 1)) j++;
+        size_t run = (j - i) * page;
+        if (i * page + run > len) run = len - i * page;
+        // 이 매핑의 page table 을 비운 뒤 (다른 프로세스가 매핑하지 않은) page cache 를 내린다
+        madvise(base + i * page, run, MADV_DONTNEED);
+        if (fd >= 0) posix_fadvise(fd, file_offset + (off_t)(i * page), (off_t)run, POSIX_FADV_DONTNEED);
+        i = j;
+    }
+}
+
+#endif // MMAP_OPTIONS_H
@@ -0,0 +1,145 @@
+#include "RecordDelta.h"
+#include "WireCodec.h"
+#include <cstring>
+
+static const size_t FIELD_HEADER_SIZE = 2 * sizeof(uint16_t);
+
+static inline char* put_u16(char* p, uint16_t v) {
+    memcpy(p, &v, sizeof(v));
+    return p + sizeof(v);
+}
+
+static inline const char* get_u16(const char* p, uint16_t& v) {
+    memcpy(&v, p, sizeof(v));
+    return p + sizeof(v);
+}
+
+// 필드 하나 읽기: 바이트 시작 반환, p 는 다음 필드로 (깨졌거나 레이아웃과 다르면 nullptr)
+static const char* next_field(const std::vector<FieldInfo>& fields, const char*& p, const char* end, uint16_t& index) {
+    if (static_cast<size_t>(end - p) < FIELD_HEADER_SIZE) return nullptr;
+    uint16_t length;
+    const char* q = get_u16(p, index);
+    q = get_u16(q, length);
+    if (index >= fields.size() || fields[index].length != length || static_cast<size_t>(end - q) < length) {
+        return nullptr;
+    }
+    p = q + length;
+    return q;
+}
+
+// header 확인 후 첫 필드 위치 (layout id 가 다르면 nullptr)
+static const char* fields_begin(const RecordLayout& layout, const char* data, size_t size,
+                                RecordDeltaHeader& header, std::string& key) {
+    if (!RecordDelta::peek(data, size, header, key)) return nullptr;
+    if (header.layout_id != WireCodec::layout_id_of(layout.getRecordType())) return nullptr;
+    return data + sizeof(header) + header.key_len;
+}
+
+size_t RecordDelta::max_encoded_size(const RecordLayout& layout, size_t key_len) {
+    size_t size = sizeof(RecordDeltaHeader) + key_len;
+    for (const auto& f : layout.getFields()) {
+        size += FIELD_HEADER_SIZE + f.length;
+    }
+    return size;
+}
+
+size_t RecordDelta::encode(const RecordLayout& layout, const BinaryRecordView& record, const DirtyFieldSet& dirty,
+                           const char* key, size_t key_len, char* out, size_t capacity) {
+    if (dirty.empty() || !record.valid() || !out || key_len > UINT16_MAX) return 0;
+    const std::vector<FieldInfo>& fields = layout.getFields();
+    if (fields.size() > UINT16_MAX || record.getSize() < layout.getRecordSize()) return 0;
+
+    size_t header_size = sizeof(RecordDeltaHeader) + key_len;
+    if (capacity < header_size) return 0;
+    char* p = out + header_size;
+    char* end = out + capacity;
+    uint16_t count = 0;
+
+    const std::vector<uint64_t>& words = dirty.words();
+    for (size_t w = 0; w < words.size(); ++w) {
+        uint64_t bits = words[w];
+        while (bits) {
+            size_t index = w * 64 + __builtin_ctzll(bits);
+            bits &= bits - 1;
+            if (index >= fields.size()) continue;
+            const FieldInfo& f = fields[index];
+            if (static_cast<size_t>(end - p) < FIELD_HEADER_SIZE + f.length) return 0;
+            p = put_u16(p, static_cast<uint16_t>(index));
+            p = put_u16(p, static_cast<uint16_t>(f.length));
+            memcpy(p, record.getBuffer() + f.offset, f.length);
+            p += f.length;
+            count++;
+        }
+    }
+    if (count == 0) return 0;
+
+    RecordDeltaHeader header;
+    header.layout_id = WireCodec::layout_id_of(layout.getRecordType());
+    header.key_len = static_cast<uint16_t>(key_len);
+    header.field_count = count;
+    memcpy(out, &header, sizeof(header));
+    if (key_len > 0) memcpy(out + sizeof(header), key, key_len);
+    return static_cast<size_t>(p - out);
+}
+
+bool RecordDelta::peek(const char* data, size_t size, RecordDeltaHeader& header, std::string& key) {
+    if (!data || size < sizeof(RecordDeltaHeader)) return false;
+    memcpy(&header, data, sizeof(header));
+    if (size < sizeof(header) + header.key_len) return false;
+    key.assign(data + sizeof(header), header.key_len);
+    return true;
+}
+
+bool RecordDelta::to_patches(const RecordLayout& layout, const char* data, size_t size, std::string& key,
+                             std::vector<MasterFieldPatch>& patches) {
+    patches.clear();
+    RecordDeltaHeader header;
+    const char* p = fields_begin(layout, data, size, header, key);
+    if (!p) return false;
+
+    const std::vector<FieldInfo>& fields = layout.getFields();
+    const char* end = data + size;
+    for (uint16_t i = 0; i < header.field_count; ++i) {
+        uint16_t index;
+        const char* bytes = next_field(fields, p, end, index);
+        if (!bytes) return false;
+        MasterFieldPatch patch;
+        patch.offset = fields[index].offset;
+        patch.length = fields[index].length;
+        patch.data = bytes;
+        patches.push_back(patch);
+    }
+    return p == end;
+}
+
+int RecordDelta::apply(const RecordLayout& layout, const char* data, size_t size, BinaryRecordView record,
+                       DirtyFieldSet* dirty) {
+    if (!record.valid() || record.getSize() < layout.getRecordSize()) return -1;
+    RecordDeltaHeader header;
+    std::string key;
+    const char* begin = fields_begin(layout, data, size, header, key);
+    if (!begin) return -1;
+
+    // 먼저 전체를 확인하고 반영 (깨진 메시지는 일부만 반영하지 않음)
+    const std::vector<FieldInfo>& fields = layout.getFields();
+    const char* end = data + size;
+    const char* p = begin;
+    uint16_t index;
+    for (uint16_t i = 0; i < header.field_count; ++i) {
+        if (!next_field(fields, p, end, index)) return -1;
+    }
+    if (p != end) return -1;
+
+    int changed = 0;
+    char* buffer = record.getBuffer();
+    p = begin;
+    for (uint16_t i = 0; i < header.field_count; ++i) {
+        const char* bytes = next_field(fields, p, end, index);
+        const FieldInfo& f = fields[index];
+        if (memcmp(buffer + f.offset, bytes, f.length) == 0) continue;
+        memcpy(buffer + f.offset, bytes, f.length);
+        if (dirty) dirty->mark(index);
+        changed++;
+    }
+    return changed;
+}
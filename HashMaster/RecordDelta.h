@@ -0,0 +1,47 @@
+#ifndef RECORD_DELTA_H
+#define RECORD_DELTA_H
+
+#include "BinaryRecord.h"
+#include "Master.h"
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 마스터 레코드의 바뀐 필드만 담은 delta 메시지 (TopicMessage payload 용)
+ *
+ * 틱 하나가 바꾸는 필드는 보통 레코드의 몇 개뿐인데 전체 레코드를 보내면 수백 바이트가 된다.
+ * 갱신하면서 DirtyFieldSet 에 표시한 필드만 (필드 index, 원본 바이트) 로 보낸다.
+ *
+ *   | RecordDeltaHeader | key (key_len) | { uint16 index | uint16 length | bytes } ... |
+ *
+ * 필드 바이트는 레코드에 있는 그대로라서 받는 쪽은 같은 레이아웃 레코드에 memcpy (apply / to_patches) 한다.
+ * layout_id 는 WireCodec::layout_id_of(record type) 이고, 필드 index/length 가 받는 쪽 레이아웃과
+ * 다르면 그 메시지 전체를 버린다 (부분 적용 없음).
+ */
+struct RecordDeltaHeader {
+    uint32_t layout_id;
+    uint16_t key_len;
+    uint16_t field_count;
+};
+
+class RecordDelta {
+public:
+    // dirty 필드만 인코딩, 인코딩 크기 반환 (capacity 부족 / 바뀐 필드 없음이면 0)
+    static size_t encode(const RecordLayout& layout, const BinaryRecordView& record, const DirtyFieldSet& dirty,
+                         const char* key, size_t key_len, char* out, size_t capacity);
+    // 최대 인코딩 크기 (모든 필드가 바뀐 경우)
+    static size_t max_encoded_size(const RecordLayout& layout, size_t key_len);
+
+    // header 와 key 확인 (크기가 모자라면 false)
+    static bool peek(const char* data, size_t size, RecordDeltaHeader& header, std::string& key);
+
+    // 같은 레이아웃 레코드에 반영, 바뀐 필드 수 반환 (깨졌거나 레이아웃이 다르면 -1)
+    static int apply(const RecordLayout& layout, const char* data, size_t size, BinaryRecordView record,
+                     DirtyFieldSet* dirty = nullptr);
+    // Master::update_fields 용 patch 로 변환 (patch data 는 delta 메시지를 가리킴)
+    static bool to_patches(const RecordLayout& layout, const char* data, size_t size, std::string& key,
+                           std::vector<MasterFieldPatch>& patches);
+};
+
+#endif // RECORD_DELTA_H
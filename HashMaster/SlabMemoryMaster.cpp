@@ -0,0 +1,615 @@
+#include "SlabMemoryMaster.h"
+#include "../common/AsyncLog.h"
+#include "../common/Tracepoints.h"
+#include <cstdarg>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sched.h>
+
+namespace {
+
+inline size_t align8(size_t n) {
+    return (n + 7) & ~(size_t)7;
+}
+
+inline void cpu_relax() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    sched_yield();
+#endif
+}
+
+// load factor 3/4 이하가 되는 2의 거듭제곱
+uint32_t index_capacity_for(int count) {
+    uint64_t need = (uint64_t)count * 4 / 3 + 1;
+    uint32_t capacity = 16;
+    while (capacity < need) {
+        capacity <<= 1;
+    }
+    return capacity;
+}
+
+} // namespace
+
+SlabMemoryMaster::SlabMemoryMaster(const MasterConfig& config)
+    : Master(config), _slab(nullptr), _slot_size(0), _pkey_offset(0), _skey_offset(0), _record_offset(0),
+      _record_count(0), _hash_func(nullptr), _lock_initialized(false), _write_seq(0) {
+    memset(&_rwlock, 0, sizeof(_rwlock));
+
+    log(LOG_INFO, "SlabMemoryMaster created with config: max_records=%d, max_size=%d",
+        _config._max_record_count, _config._max_record_size);
+}
+
+SlabMemoryMaster::~SlabMemoryMaster() {
+    free(_slab);
+    _slab = nullptr;
+    if (_lock_initialized) {
+        pthread_rwlock_destroy(&_rwlock);
+    }
+}
+
+int SlabMemoryMaster::init() {
+    if (_initialized) {
+        log(LOG_WARNING, "SlabMemoryMaster already initialized");
+        return MASTER_OK;
+    }
+
+    if (!_config.validate()) {
+        log(LOG_ERROR, "Invalid SlabMemoryMaster configuration");
+        return MASTER_ERROR_INVALID_PARAMETER;
+    }
+
+    int hash_func_id = hash_function_id_from_name(_config._hash_function.c_str());
+    _hash_func = hash_func_id < 0 ? nullptr : get_builtin_hash_function(hash_func_id);
+    if (!_hash_func) {
+        log(LOG_ERROR, "Unknown hash function: %s", _config._hash_function.c_str());
+        return MASTER_ERROR_INVALID_PARAMETER;
+    }
+
+    // slot = header | pkey | skey | record (record 는 8 byte 정렬)
+    _pkey_offset = (int)sizeof(SlotHeader);
+    _skey_offset = _pkey_offset + _config._primary_field_len;
+    _record_offset = (int)align8(_skey_offset + _config._secondary_field_len);
+    _slot_size = align8(_record_offset + _config._max_record_size);
+
+    size_t slab_bytes = _slot_size * (size_t)_config._max_record_count;
+    void* slab = nullptr;
+    if (posix_memalign(&slab, 64, slab_bytes) != 0) {
+        log(LOG_ERROR, "Failed to allocate slab: %zu bytes", slab_bytes);
+        return MASTER_ERROR_MEMORY_ERROR;
+    }
+    _slab = static_cast<char*>(slab);
+    memset(_slab, 0, slab_bytes);
+
+    if (init_index(_primary, _pkey_offset, _config._primary_field_len) != MASTER_OK ||
+        (_config.use_secondary_index() &&
+         init_index(_secondary, _skey_offset, _config._secondary_field_len) != MASTER_OK)) {
+        return MASTER_ERROR_MEMORY_ERROR;
+    }
+
+    try {
+        _free_slots.reserve(_config._max_record_count);
+    } catch (const std::exception& e) {
+        log(LOG_ERROR, "Failed to allocate free list: %s", e.what());
+        return MASTER_ERROR_MEMORY_ERROR;
+    }
+
+    if (_config._use_lock) {
+        int ret = pthread_rwlock_init(&_rwlock, nullptr);
+        if (ret != 0) {
+            log(LOG_ERROR, "Failed to initialize rwlock: %s", strerror(ret));
+            return MASTER_ERROR_LOCK_ERROR;
+        }
+        _lock_initialized = true;
+    }
+
+    _initialized = true;
+    clear();
+
+    log(LOG_INFO, "SlabMemoryMaster initialized: slot_size=%zu, slab=%zu bytes, index=%u/%u slots",
+        _slot_size, slab_bytes, _primary._mask + 1, _secondary._mask + 1);
+    return MASTER_OK;
+}
+
+int SlabMemoryMaster::init_index(FlatIndex& index, int key_offset, int key_len) {
+    uint32_t capacity = index_capacity_for(_config._max_record_count);
+    try {
+        index._entries.assign(capacity, IndexEntry());
+    } catch (const std::exception& e) {
+        log(LOG_ERROR, "Failed to allocate index: %s", e.what());
+        return MASTER_ERROR_MEMORY_ERROR;
+    }
+    index._mask = capacity - 1;
+    index._key_offset = key_offset;
+    index._key_len = key_len;
+    index._size = 0;
+    return MASTER_OK;
+}
+
+int SlabMemoryMaster::clear() {
+    if (!_initialized) {
+        return MASTER_ERROR_NOT_INITIALIZED;
+    }
+
+    write_lock();
+
+    FlatIndex* indexes[] = { &_primary, &_secondary };
+    for (FlatIndex* index : indexes) {
+        for (IndexEntry& e : index->_entries) {
+            e._hash = 0;
+            e._slot = -1;
+        }
+        index->_size = 0;
+    }
+
+    // 낮은 slot 부터 쓰도록 역순으로 쌓는다
+    _free_slots.clear();
+    for (int i = _config._max_record_count - 1; i >= 0; --i) {
+        slot_header(i)->_occupied = 0;
+        _free_slots.push_back(i);
+    }
+    _record_count.store(0);
+
+    write_unlock();
+
+    log(LOG_INFO, "SlabMemoryMaster cleared successfully");
+    return MASTER_OK;
+}
+
+// ===== Index =====
+
+bool SlabMemoryMaster::key_length(const char* key, int field_len, size_t* len) const {
+    if (!key) {
+        return false;
+    }
+    *len = strnlen(key, field_len);
+    return *len > 0 && (int)*len < field_len;
+}
+
+uint32_t SlabMemoryMaster::hash_key(const char* key, size_t len) const {
+    return hash_mix32(_hash_func(key, (int)len));
+}
+
+// key 가 있는 index 위치 (없으면 -1). lock-free reader 는 잘못 읽어도 seqlock 검증에서 다시 한다.
+int SlabMemoryMaster::find(const FlatIndex& index, const char* key, size_t len, uint32_t hash) const {
+    uint32_t pos = hash & index._mask;
+    for (uint32_t probe = 0; probe <= index._mask; probe++) {
+        const IndexEntry& e = index._entries[pos];
+        int slot = __atomic_load_n(&e._slot, __ATOMIC_ACQUIRE);
+        if (slot < 0) {
+            return -1;
+        }
+        if (__atomic_load_n(&e._hash, __ATOMIC_RELAXED) == hash) {
+            const char* stored = _slab + (size_t)slot * _slot_size + index._key_offset;
+            if (memcmp(stored, key, len) == 0 && stored[len] == '\0') {
+                return (int)pos;
+            }
+        }
+        pos = (pos + 1) & index._mask;
+    }
+    return -1;
+}
+
+void SlabMemoryMaster::insert(FlatIndex& index, uint32_t hash, int slot) {
+    uint32_t pos = hash & index._mask;
+    while (index._entries[pos]._slot >= 0) {
+        pos = (pos + 1) & index._mask;
+    }
+    __atomic_store_n(&index._entries[pos]._hash, hash, __ATOMIC_RELAXED);
+    __atomic_store_n(&index._entries[pos]._slot, slot, __ATOMIC_RELEASE);
+    index._size++;
+}
+
+// backward shift: 뒤따르는 entry 중 home 이 (pos, j] 밖인 것을 당겨 빈 자리를 없앤다
+void SlabMemoryMaster::erase(FlatIndex& index, int pos) {
+    uint32_t hole = (uint32_t)pos;
+    uint32_t j = hole;
+    for (;;) {
+        j = (j + 1) & index._mask;
+        const IndexEntry& e = index._entries[j];
+        if (e._slot < 0) {
+            break;
+        }
+        uint32_t home = e._hash & index._mask;
+        bool stays = (hole <= j) ? (hole < home && home <= j) : (hole < home || home <= j);
+        if (!stays) {
+            __atomic_store_n(&index._entries[hole]._hash, e._hash, __ATOMIC_RELAXED);
+            __atomic_store_n(&index._entries[hole]._slot, e._slot, __ATOMIC_RELEASE);
+            hole = j;
+        }
+    }
+    __atomic_store_n(&index._entries[hole]._slot, -1, __ATOMIC_RELEASE);
+    index._size--;
+}
+
+int SlabMemoryMaster::lookup(const FlatIndex& index, const char* key) const {
+    size_t len;
+    if (index._entries.empty() || !key_length(key, index._key_len, &len)) {
+        return -1;
+    }
+    int pos = find(index, key, len, hash_key(key, len));
+    return pos < 0 ? -1 : __atomic_load_n(&index._entries[pos]._slot, __ATOMIC_ACQUIRE);
+}
+
+int SlabMemoryMaster::find_slot(const FlatIndex& index, const char* key) const {
+    if (reader_locks()) {
+        pthread_rwlock_rdlock(&_rwlock);
+        int slot = lookup(index, key);
+        pthread_rwlock_unlock(&_rwlock);
+        return slot;
+    }
+    if (!_config._lock_free_read) {
+        return lookup(index, key);
+    }
+
+    for (;;) {
+        uint32_t seq = __atomic_load_n(&_write_seq, __ATOMIC_ACQUIRE);
+        if (seq & 1) {
+            cpu_relax();
+            continue;
+        }
+        int slot = lookup(index, key);
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&_write_seq, __ATOMIC_RELAXED) == seq) {
+            return slot;
+        }
+    }
+}
+
+// ===== Locking =====
+
+void SlabMemoryMaster::write_lock() {
+    if (_lock_initialized) {
+        pthread_rwlock_wrlock(&_rwlock);
+    }
+    __atomic_fetch_or(&_write_seq, 1u, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+}
+
+void SlabMemoryMaster::write_unlock() {
+    __atomic_fetch_add(&_write_seq, 1u, __ATOMIC_RELEASE);
+    if (_lock_initialized) {
+        pthread_rwlock_unlock(&_rwlock);
+    }
+}
+
+// ===== Master Interface =====
+
+int SlabMemoryMaster::put(const char* pkey, const char* skey, const char* record, int record_size) {
+    if (!_initialized) {
+        log(LOG_ERROR, "SlabMemoryMaster not initialized");
+        return MASTER_ERROR_NOT_INITIALIZED;
+    }
+
+    size_t plen = 0, slen = 0;
+    bool has_skey = _config.use_secondary_index() && skey && skey[0] != '\0';
+    if (!key_length(pkey, _config._primary_field_len, &plen) ||
+        (has_skey && !key_length(skey, _config._secondary_field_len, &slen)) ||
+        !record || record_size <= 0 || record_size > _config._max_record_size) {
+        log(LOG_ERROR, "Invalid parameters for put operation");
+        return MASTER_ERROR_INVALID_PARAMETER;
+    }
+
+    uint32_t phash = hash_key(pkey, plen);
+    uint32_t shash = has_skey ? hash_key(skey, slen) : 0;
+
+    write_lock();
+
+    int result = MASTER_OK;
+    do {
+        if (find(_primary, pkey, plen, phash) >= 0) {
+            log(LOG_ERROR, "Primary key already exists: %s", pkey);
+            result = MASTER_ERROR_KEY_EXISTS;
+            break;
+        }
+        if (has_skey && find(_secondary, skey, slen, shash) >= 0) {
+            log(LOG_ERROR, "Secondary key already exists: %s", skey);
+            result = MASTER_ERROR_KEY_EXISTS;
+            break;
+        }
+        if (_free_slots.empty()) {
+            log(LOG_ERROR, "No free slots available");
+            result = MASTER_ERROR_NO_SPACE;
+            break;
+        }
+
+        int slot = _free_slots.back();
+        _free_slots.pop_back();
+
+        SlotHeader* h = slot_header(slot);
+        char* base = _slab + (size_t)slot * _slot_size;
+        __atomic_fetch_or(&h->_version, 1u, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        memset(base + _pkey_offset, 0, _record_offset - _pkey_offset);
+        memcpy(base + _pkey_offset, pkey, plen);
+        if (has_skey) {
+            memcpy(base + _skey_offset, skey, slen);
+        }
+        memcpy(base + _record_offset, record, record_size);
+        if (record_size < _config._max_record_size) {
+            memset(base + _record_offset + record_size, 0, _config._max_record_size - record_size);
+        }
+        h->_record_size = record_size;
+        h->_occupied = 1;
+        __atomic_fetch_add(&h->_version, 1u, __ATOMIC_RELEASE);
+
+        insert(_primary, phash, slot);
+        if (has_skey) {
+            insert(_secondary, shash, slot);
+        }
+        _record_count.fetch_add(1, std::memory_order_relaxed);
+
+        log(LOG_DEBUG, "Put record: pkey=%s, skey=%s, size=%d, slot=%d",
+            pkey, has_skey ? skey : "(null)", record_size, slot);
+    } while (0);
+
+    write_unlock();
+    return result;
+}
+
+char* SlabMemoryMaster::get_by_primary(const char* pkey) {
+    if (!_initialized) {
+        return nullptr;
+    }
+    int slot = find_slot(_primary, pkey);
+    return slot < 0 ? nullptr : slot_record(slot);
+}
+
+char* SlabMemoryMaster::get_by_secondary(const char* skey) {
+    if (!_initialized || !_config.use_secondary_index()) {
+        return nullptr;
+    }
+    int slot = find_slot(_secondary, skey);
+    return slot < 0 ? nullptr : slot_record(slot);
+}
+
+int SlabMemoryMaster::del(const char* pkey) {
+    if (!_initialized) {
+        return MASTER_ERROR_NOT_INITIALIZED;
+    }
+
+    size_t plen;
+    if (!key_length(pkey, _config._primary_field_len, &plen)) {
+        return MASTER_ERROR_INVALID_PARAMETER;
+    }
+    uint32_t phash = hash_key(pkey, plen);
+
+    write_lock();
+
+    int result = MASTER_OK;
+    do {
+        int pos = find(_primary, pkey, plen, phash);
+        if (pos < 0) {
+            result = MASTER_ERROR_KEY_NOT_FOUND;
+            break;
+        }
+        int slot = _primary._entries[pos]._slot;
+        char* base = _slab + (size_t)slot * _slot_size;
+
+        // slot 에 inline 으로 있는 secondary key 로 바로 찾는다
+        const char* skey = base + _skey_offset;
+        size_t slen;
+        if (_config.use_secondary_index() && key_length(skey, _config._secondary_field_len, &slen)) {
+            int spos = find(_secondary, skey, slen, hash_key(skey, slen));
+            if (spos >= 0) {
+                erase(_secondary, spos);
+            }
+        }
+        erase(_primary, pos);
+
+        SlotHeader* h = slot_header(slot);
+        __atomic_fetch_or(&h->_version, 1u, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+        h->_occupied = 0;
+        __atomic_fetch_add(&h->_version, 1u, __ATOMIC_RELEASE);
+
+        _free_slots.push_back(slot);
+        _record_count.fetch_sub(1, std::memory_order_relaxed);
+
+        log(LOG_DEBUG, "Deleted record: pkey=%s, slot=%d", pkey, slot);
+    } while (0);
+
+    write_unlock();
+    return result;
+}
+
+// index 조회 후 slot version 으로 찢어지지 않은 복사본을 만든다 (지워졌으면 다시 조회)
+int SlabMemoryMaster::read_record(const FlatIndex& index, const char* key, char* out, int out_size) {
+    if (!_initialized) {
+        return MASTER_ERROR_NOT_INITIALIZED;
+    }
+    if (!out || out_size <= 0) {
+        return MASTER_ERROR_INVALID_PARAMETER;
+    }
+
+    for (;;) {
+        int slot = find_slot(index, key);
+        if (slot < 0) {
+            return MASTER_ERROR_KEY_NOT_FOUND;
+        }
+        const SlotHeader* h = slot_header(slot);
+        uint32_t version = __atomic_load_n(&h->_version, __ATOMIC_ACQUIRE);
+        if (version & 1) {
+            cpu_relax();
+            continue;
+        }
+        int size = h->_record_size;
+        int n = out_size < size ? out_size : size;
+        if (n < 0 || n > _config._max_record_size) {
+            n = 0;
+        }
+        memcpy(out, slot_record(slot), n);
+        bool occupied = h->_occupied != 0;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&h->_version, __ATOMIC_RELAXED) == version && occupied) {
+            return n;
+        }
+    }
+}
+
+int SlabMemoryMaster::read_by_primary(const char* pkey, char* out, int out_size) {
+    return read_record(_primary, pkey, out, out_size);
+}
+
+int SlabMemoryMaster::read_by_secondary(const char* skey, char* out, int out_size) {
+    if (!_config.use_secondary_index()) {
+        return MASTER_ERROR_KEY_NOT_FOUND;
+    }
+    return read_record(_secondary, skey, out, out_size);
+}
+
+int SlabMemoryMaster::slot_of_record(const char* record) const {
+    if (!_slab || record < _slab + _record_offset) {
+        return -1;
+    }
+    size_t offset = (size_t)(record - _slab - _record_offset);
+    if (offset % _slot_size != 0 || offset / _slot_size >= (size_t)_config._max_record_count) {
+        return -1;
+    }
+    return (int)(offset / _slot_size);
+}
+
+void SlabMemoryMaster::begin_record_update(char* record) {
+    int slot = slot_of_record(record);
+    if (slot >= 0) {
+        __atomic_fetch_or(&slot_header(slot)->_version, 1u, __ATOMIC_RELAXED);
+        __atomic_thread_fence(__ATOMIC_RELEASE);
+    }
+}
+
+void SlabMemoryMaster::end_record_update(char* record) {
+    int slot = slot_of_record(record);
+    if (slot >= 0) {
+        __atomic_fetch_add(&slot_header(slot)->_version, 1u, __ATOMIC_RELEASE);
+    }
+    T2MA_TRACE1(master_update, record);
+}
+
+// ===== Statistics =====
+
+MasterStats SlabMemoryMaster::get_statistics() {
+    MasterStats stats = {};
+    stats.total_records = _config._max_record_count;
+    stats.used_records = _record_count.load();
+    stats.free_records = stats.total_records - stats.used_records;
+    stats.record_utilization = stats.total_records > 0
+        ? static_cast<double>(stats.used_records) / stats.total_records : 0.0;
+    return stats;
+}
+
+void SlabMemoryMaster::display_statistics() {
+    MasterStats stats = get_statistics();
+
+    printf("=== SlabMemoryMaster Statistics ===\n");
+    printf("Total records: %d\n", stats.total_records);
+    printf("Used records: %d\n", stats.used_records);
+    printf("Free records: %d\n", stats.free_records);
+    printf("Record utilization: %.2f%%\n", stats.record_utilization * 100);
+    printf("Slot size: %zu bytes\n", _slot_size);
+    printf("Memory usage: %zu bytes\n", estimate_memory_usage());
+    printf("Primary index: %d / %u slots\n", _primary._size, _primary._mask + 1);
+    if (_config.use_secondary_index()) {
+        printf("Secondary index: %d / %u slots\n", _secondary._size, _secondary._mask + 1);
+    }
+}
+
+int SlabMemoryMaster::get_record_count() const {
+    return _record_count.load();
+}
+
+int SlabMemoryMaster::get_free_record_count() const {
+    return _initialized ? _config._max_record_count - _record_count.load() : 0;
+}
+
+size_t SlabMemoryMaster::estimate_memory_usage() const {
+    return _slot_size * (size_t)_config._max_record_count +
+           (_primary._entries.size() + _secondary._entries.size()) * sizeof(IndexEntry) +
+           _free_slots.capacity() * sizeof(int);
+}
+
+bool SlabMemoryMaster::validate_integrity() {
+    if (!_initialized) {
+        return false;
+    }
+
+    if (reader_locks()) {
+        pthread_rwlock_rdlock(&_rwlock);
+    }
+
+    bool ok = true;
+    const FlatIndex* indexes[] = { &_primary, &_secondary };
+    for (const FlatIndex* index : indexes) {
+        int count = 0;
+        for (const IndexEntry& e : index->_entries) {
+            if (e._slot < 0) {
+                continue;
+            }
+            count++;
+            if (e._slot >= _config._max_record_count || !slot_header(e._slot)->_occupied) {
+                ok = false;
+                break;
+            }
+            const char* key = _slab + (size_t)e._slot * _slot_size + index->_key_offset;
+            size_t len;
+            if (!key_length(key, index->_key_len, &len) || hash_key(key, len) != e._hash) {
+                ok = false;
+                break;
+            }
+        }
+        if (count != index->_size) {
+            ok = false;
+        }
+    }
+    if (_primary._size != _record_count.load()) {
+        ok = false;
+    }
+
+    if (reader_locks()) {
+        pthread_rwlock_unlock(&_rwlock);
+    }
+    return ok;
+}
+
+// ===== Iterator =====
+
+bool SlabMemoryMaster::SlabIterator::has_next() {
+    int capacity = _slab_master->_config._max_record_count;
+    while (_current_index < capacity && !_slab_master->slot_header(_current_index)->_occupied) {
+        _current_index++;
+    }
+    return _current_index < capacity;
+}
+
+char* SlabMemoryMaster::SlabIterator::next() {
+    if (!has_next()) {
+        return nullptr;
+    }
+    _index = _current_index++;
+    return _slab_master->slot_record(_index);
+}
+
+std::unique_ptr<Master::Iterator> SlabMemoryMaster::create_iterator() {
+    if (!_initialized) {
+        return nullptr;
+    }
+    return std::unique_ptr<Master::Iterator>(new SlabIterator(this));
+}
+
+// Logging implementation
+void SlabMemoryMaster::log(LogLevel level, const char* format, ...) {
+    if (level < _config._log_level) {
+        return;
+    }
+
+    va_list args;
+    va_start(args, format);
+    SimplePubSub::AsyncLogger::instance().logv(level, "SlabMemoryMaster", format, args);
+    va_end(args);
+}
+
+// Factory function
+std::unique_ptr<Master> create_slab_memory_master(const MasterConfig& config) {
+    return std::make_unique<SlabMemoryMaster>(config);
+}
@@ -0,0 +1,164 @@
+#ifndef SLAB_MEMORY_MASTER_H
+#define SLAB_MEMORY_MASTER_H
+
+#include "Master.h"
+#include "HashFunctions.h"
+#include "../common/Compat.h"  // For GCC 4.8.5 compatibility
+#include <pthread.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+#include <vector>
+
+/**
+ * @brief Slab 기반 in-memory Master (MemoryMaster 의 할당 없는 변형)
+ *
+ * MemoryMaster 는 레코드마다 unique_ptr<MemoryRecord> + vector + string key 두 개,
+ * index 는 unordered_map<std::string,int> 두 개라서 레코드당 heap 할당이 4번 이상이고
+ * 조회마다 임시 std::string 을 만든다. SlabMemoryMaster 는
+ *  - 고정 크기 slot 을 하나의 연속 buffer 에 (slot = header | pkey | skey | record)
+ *  - key 는 slot 안에 inline (field_len 고정, '\0' padding)
+ *  - index 는 power-of-two linear probing (hash + slot 번호 8 byte), const char* 로 바로 조회,
+ *    삭제는 backward shift 라 tombstone 이 없다
+ * init 이후에는 put/del 에서 할당이 없고, get_by_* 가 돌려준 포인터는 master 가 살아있는 동안 유효하다.
+ *
+ * Locking (HashMaster 와 같은 설정):
+ *  - _use_lock         : writer 는 rwlock write, reader 는 rwlock read
+ *  - _lock_free_read   : writer 하나, reader 는 lock 없이 index seqlock 으로 검증 후 재시도
+ *                        read_by_*() 는 slot 별 version 으로 찢어지지 않은 복사본을 준다
+ * key 는 C 문자열 (MemoryMaster 와 같이 strlen < field_len).
+ */
+class SlabMemoryMaster : public Master {
+private:
+    // slot header (slot 시작)
+    struct SlotHeader {
+        uint32_t _version;      // record seqlock (홀수: 쓰기 진행 중)
+        uint32_t _occupied;
+        int _record_size;
+    };
+
+    // index entry: _slot < 0 이면 빈 자리
+    struct IndexEntry {
+        uint32_t _hash;
+        int _slot;
+
+        IndexEntry() : _hash(0), _slot(-1) {}
+    };
+
+    struct FlatIndex {
+        std::vector<IndexEntry> _entries;
+        uint32_t _mask;
+        int _key_offset;        // slot 안 key 위치
+        int _key_len;           // field_len
+        int _size;
+
+        FlatIndex() : _mask(0), _key_offset(0), _key_len(0), _size(0) {}
+    };
+
+    // slab
+    char* _slab;
+    size_t _slot_size;
+    int _pkey_offset;
+    int _skey_offset;
+    int _record_offset;
+
+    FlatIndex _primary;
+    FlatIndex _secondary;
+
+    std::vector<int> _free_slots;
+    std::atomic<int> _record_count;
+
+    HashFunction _hash_func;
+
+    // locking
+    mutable pthread_rwlock_t _rwlock;
+    bool _lock_initialized;
+    mutable uint32_t _write_seq;    // index seqlock (홀수: 쓰기 진행 중)
+
+    // slot helpers
+    inline SlotHeader* slot_header(int slot) const {
+        return reinterpret_cast<SlotHeader*>(_slab + (size_t)slot * _slot_size);
+    }
+    inline char* slot_record(int slot) const {
+        return _slab + (size_t)slot * _slot_size + _record_offset;
+    }
+    int slot_of_record(const char* record) const;
+
+    // index
+    int init_index(FlatIndex& index, int key_offset, int key_len);
+    uint32_t hash_key(const char* key, size_t len) const;
+    int find(const FlatIndex& index, const char* key, size_t len, uint32_t hash) const;
+    void insert(FlatIndex& index, uint32_t hash, int slot);
+    void erase(FlatIndex& index, int pos);
+    int lookup(const FlatIndex& index, const char* key) const;     // slot 또는 -1 (lock 없음)
+    int find_slot(const FlatIndex& index, const char* key) const;  // reader lock / seqlock 포함
+    bool key_length(const char* key, int field_len, size_t* len) const;
+
+    // locking
+    inline bool reader_locks() const { return _config._use_lock && !_config._lock_free_read; }
+    void write_lock();
+    void write_unlock();
+    int read_record(const FlatIndex& index, const char* key, char* out, int out_size);
+
+    void log(LogLevel level, const char* format, ...) override;
+
+public:
+    explicit SlabMemoryMaster(const MasterConfig& config);
+    ~SlabMemoryMaster() override;
+
+    SlabMemoryMaster(const SlabMemoryMaster&) = delete;
+    SlabMemoryMaster& operator=(const SlabMemoryMaster&) = delete;
+
+    // ===== Master Interface Implementation =====
+    int init() override;
+    int clear() override;
+    int put(const char* pkey, const char* skey, const char* record, int record_size) override;
+    char* get_by_primary(const char* pkey) override;
+    char* get_by_secondary(const char* skey) override;
+    int del(const char* pkey) override;
+
+    int read_by_primary(const char* pkey, char* out, int out_size) override;
+    int read_by_secondary(const char* skey, char* out, int out_size) override;
+    void begin_record_update(char* record) override;
+    void end_record_update(char* record) override;
+
+    MasterStats get_statistics() override;
+    void display_statistics() override;
+    int get_record_count() const override;
+    int get_free_record_count() const override;
+    bool validate_integrity() override;
+
+    // ===== SlabMemoryMaster-Specific Methods =====
+
+    /**
+     * @brief Estimate memory usage in bytes (slab + index + free list)
+     */
+    size_t estimate_memory_usage() const;
+
+    /**
+     * @brief Bytes per record slot (header + inline keys + record, 8 byte aligned)
+     */
+    size_t get_slot_size() const { return _slot_size; }
+
+    // ===== Iterator Implementation =====
+    class SlabIterator : public Master::Iterator {
+    private:
+        SlabMemoryMaster* _slab_master;
+        int _index;     // 마지막으로 next() 가 돌려준 slot
+
+    public:
+        explicit SlabIterator(SlabMemoryMaster* master)
+            : Master::Iterator(master, 0), _slab_master(master), _index(-1) {}
+
+        bool has_next() override;
+        char* next() override;
+        int get_current_index() const override { return _index; }
+    };
+
+    std::unique_ptr<Iterator> create_iterator() override;
+};
+
+// Factory function for creating SlabMemoryMaster instances
+std::unique_ptr<Master> create_slab_memory_master(const MasterConfig& config);
+
+#endif // SLAB_MEMORY_MASTER_H
@@ -0,0 +1,249 @@
+#include "SpecCache.h"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <dirent.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <unistd.h>
+
+namespace {
+
+const char SPEC_CACHE_MAGIC[4] = {'S', 'P', 'C', 'C'};
+const uint32_t SPEC_CACHE_VERSION = 1;
+
+enum SpecCacheKind : uint32_t {
+    KIND_LAYOUTS = 1,
+    KIND_TABLES = 2
+};
+
+const uint64_t FNV_OFFSET = 14695981039346656037ULL;
+const uint64_t FNV_PRIME = 1099511628211ULL;
+
+inline uint64_t fnv1a(uint64_t h, const char* data, size_t size) {
+    for (size_t i = 0; i < size; ++i) {
+        h ^= static_cast<unsigned char>(data[i]);
+        h *= FNV_PRIME;
+    }
+    return h;
+}
+
+// ===== 직렬화 (native endian, 같은 호스트의 프로세스끼리만 공유) =====
+
+class Writer {
+public:
+    void u32(uint32_t v) { _buf.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+    void u64(uint64_t v) { _buf.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+    void i32(int32_t v) { _buf.append(reinterpret_cast<const char*>(&v), sizeof(v)); }
+    void str(const std::string& s) {
+        u32(static_cast<uint32_t>(s.size()));
+        _buf.append(s);
+    }
+    void header(uint32_t kind, uint64_t hash) {
+        _buf.append(SPEC_CACHE_MAGIC, sizeof(SPEC_CACHE_MAGIC));
+        u32(SPEC_CACHE_VERSION);
+        u32(kind);
+        u64(hash);
+    }
+    const std::string& data() const { return _buf; }
+
+private:
+    std::string _buf;
+};
+
+class Reader {
+public:
+    explicit Reader(const std::string& buf) : _p(buf.data()), _end(buf.data() + buf.size()), _ok(true) {}
+
+    bool ok() const { return _ok; }
+    bool done() const { return _ok && _p == _end; }
+
+    uint32_t u32() { uint32_t v = 0; read(&v, sizeof(v)); return v; }
+    uint64_t u64() { uint64_t v = 0; read(&v, sizeof(v)); return v; }
+    int32_t i32() { int32_t v = 0; read(&v, sizeof(v)); return v; }
+    std::string str() {
+        uint32_t n = u32();
+        if (!_ok || static_cast<size_t>(_end - _p) < n) {
+            _ok = false;
+            return std::string();
+        }
+        std::string s(_p, n);
+        _p += n;
+        return s;
+    }
+    bool header(uint32_t kind, uint64_t hash) {
+        char magic[sizeof(SPEC_CACHE_MAGIC)];
+        read(magic, sizeof(magic));
+        return _ok && memcmp(magic, SPEC_CACHE_MAGIC, sizeof(magic)) == 0 &&
+               u32() == SPEC_CACHE_VERSION && u32() == kind && u64() == hash && _ok;
+    }
+
+private:
+    const char* _p;
+    const char* _end;
+    bool _ok;
+
+    void read(void* out, size_t n) {
+        if (!_ok || static_cast<size_t>(_end - _p) < n) {
+            _ok = false;
+            return;
+        }
+        memcpy(out, _p, n);
+        _p += n;
+    }
+};
+
+bool read_file(const std::string& path, std::string& out) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    std::ostringstream ss;
+    ss << file.rdbuf();
+    out = ss.str();
+    return true;
+}
+
+// 임시 파일에 쓰고 rename (동시에 읽는 프로세스는 이전 cache 나 새 cache 만 본다)
+bool write_file(const std::string& path, const std::string& data) {
+    std::string tmp = path + ".tmp." + std::to_string(getpid());
+    FILE* fp = fopen(tmp.c_str(), "wb");
+    if (!fp) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), fp) == data.size();
+    ok = (fclose(fp) == 0) && ok;
+    if (ok && rename(tmp.c_str(), path.c_str()) == 0) return true;
+    unlink(tmp.c_str());
+    return false;
+}
+
+} // namespace
+
+bool SpecCache::enabled() {
+    const char* env = getenv("SPEC_CACHE");
+    return !(env && (strcmp(env, "0") == 0 || strcmp(env, "off") == 0));
+}
+
+std::string SpecCache::cachePath(const std::string& directory) {
+    std::string dir = directory;
+    while (dir.size() > 1 && dir[dir.size() - 1] == '/') {
+        dir.erase(dir.size() - 1);
+    }
+    return dir + ".cache";
+}
+
+bool SpecCache::scanDirectory(const std::string& directory, const std::string& suffix,
+                              std::vector<std::string>& files, uint64_t& hash) {
+    files.clear();
+    DIR* dir = opendir(directory.c_str());
+    if (!dir) return false;
+
+    std::vector<std::string> names;
+    struct dirent* entry;
+    while ((entry = readdir(dir)) != nullptr) {
+        std::string name = entry->d_name;
+        if (name.size() > suffix.size() && name.compare(name.size() - suffix.size(), suffix.size(), suffix) == 0) {
+            names.push_back(name);
+        }
+    }
+    closedir(dir);
+    std::sort(names.begin(), names.end());
+
+    hash = FNV_OFFSET;
+    std::string content;
+    for (const auto& name : names) {
+        std::string path = directory + "/" + name;
+        // 이름 뒤에 NUL 을 넣어 (이름, 내용) 경계가 섞이지 않도록
+        hash = fnv1a(hash, name.c_str(), name.size() + 1);
+        if (read_file(path, content)) {
+            uint64_t size = content.size();
+            hash = fnv1a(hash, reinterpret_cast<const char*>(&size), sizeof(size));
+            hash = fnv1a(hash, content.data(), content.size());
+        }
+        files.push_back(name);
+    }
+    return true;
+}
+
+bool SpecCache::loadLayouts(const std::string& path, uint64_t hash, LayoutMap& layouts) {
+    std::string buf;
+    if (!read_file(path, buf)) return false;
+    Reader r(buf);
+    if (!r.header(KIND_LAYOUTS, hash)) return false;
+
+    LayoutMap loaded;
+    uint32_t count = r.u32();
+    for (uint32_t i = 0; i < count && r.ok(); ++i) {
+        std::shared_ptr<RecordLayout> layout = std::make_shared<RecordLayout>(r.str());
+        uint32_t fields = r.u32();
+        for (uint32_t f = 0; f < fields && r.ok(); ++f) {
+            FieldInfo field;
+            field.name = r.str();
+            field.type = static_cast<FieldType>(r.u32());
+            field.length = r.i32();
+            field.decimal = r.i32();
+            field.isKey = r.u32() != 0;
+            layout->addField(field);
+        }
+        layout->calculateLayout();
+        loaded[layout->getRecordType()] = layout;
+    }
+    if (!r.done()) return false;
+    layouts.swap(loaded);
+    return true;
+}
+
+bool SpecCache::saveLayouts(const std::string& path, uint64_t hash, const LayoutMap& layouts) {
+    Writer w;
+    w.header(KIND_LAYOUTS, hash);
+    w.u32(static_cast<uint32_t>(layouts.size()));
+    for (const auto& pair : layouts) {
+        const RecordLayout& layout = *pair.second;
+        w.str(layout.getRecordType());
+        w.u32(static_cast<uint32_t>(layout.getFields().size()));
+        for (const auto& field : layout.getFields()) {
+            w.str(field.name);
+            w.u32(static_cast<uint32_t>(field.type));
+            w.i32(field.length);
+            w.i32(field.decimal);
+            w.u32(field.isKey ? 1 : 0);
+        }
+    }
+    return write_file(path, w.data());
+}
+
+bool SpecCache::loadTables(const std::string& path, uint64_t hash, TableList& tables) {
+    std::string buf;
+    if (!read_file(path, buf)) return false;
+    Reader r(buf);
+    if (!r.header(KIND_TABLES, hash)) return false;
+
+    TableList loaded;
+    uint32_t count = r.u32();
+    for (uint32_t i = 0; i < count && r.ok(); ++i) {
+        loaded.push_back(std::make_pair(r.str(), std::map<std::string, std::string>()));
+        std::map<std::string, std::string>& table = loaded.back().second;
+        uint32_t entries = r.u32();
+        for (uint32_t e = 0; e < entries && r.ok(); ++e) {
+            std::string key = r.str();
+            table[key] = r.str();
+        }
+    }
+    if (!r.done()) return false;
+    tables.swap(loaded);
+    return true;
+}
+
+bool SpecCache::saveTables(const std::string& path, uint64_t hash, const TableList& tables) {
+    Writer w;
+    w.header(KIND_TABLES, hash);
+    w.u32(static_cast<uint32_t>(tables.size()));
+    for (const auto& table : tables) {
+        w.str(table.first);
+        w.u32(static_cast<uint32_t>(table.second.size()));
+        for (const auto& entry : table.second) {
+            w.str(entry.first);
+            w.str(entry.second);
+        }
+    }
+    return write_file(path, w.data());
+}
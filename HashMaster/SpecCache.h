@@ -0,0 +1,43 @@
+#ifndef SPEC_CACHE_H
+#define SPEC_CACHE_H
+
+#include "BinaryRecord.h"
+#include <stdint.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief 설정 디렉토리 (config/SPECs, config/MASTERs) 를 파싱한 결과의 binary cache
+ *
+ * 여러 프로세스 (T2MA, viewer 도구 등) 가 시작할 때마다 같은 YAML 을 줄 단위로 다시 파싱하지 않도록
+ * 디렉토리의 파싱 결과를 "<디렉토리>.cache" 파일 하나에 저장해 둔다.
+ *  - key: 디렉토리의 대상 파일들을 이름순으로 (이름 + 내용) hash 한 값 (FNV-1a 64)
+ *    파일 하나라도 바뀌거나 추가/삭제되면 hash 가 달라져 다시 파싱하고 cache 를 새로 쓴다.
+ *  - layouts: RecordLayout (필드 이름/타입/길이/소수/키), 읽은 뒤 calculateLayout() 만 한다.
+ *  - tables : 파일별 key-value 표 (MasterManager 의 master YAML), MasterConfig 는 표에서 바로 만든다.
+ * cache 는 임시 파일에 쓰고 rename 하므로 동시에 시작한 프로세스가 반쯤 쓴 파일을 읽지 않는다.
+ * 디렉토리에 쓸 수 없으면 경고 없이 cache 없이 동작한다. 환경변수 SPEC_CACHE=0 이면 사용하지 않는다.
+ */
+class SpecCache {
+public:
+    typedef std::map<std::string, std::shared_ptr<RecordLayout>> LayoutMap;
+    // (파일 이름, key-value 표) 를 파일 이름순으로 (경로는 읽는 쪽 디렉토리 기준으로 붙인다)
+    typedef std::vector<std::pair<std::string, std::map<std::string, std::string>>> TableList;
+
+    static bool enabled();
+    static std::string cachePath(const std::string& directory);
+
+    // directory 안의 suffix 파일 이름을 이름순으로 files 에 넣고 content hash 계산 (디렉토리를 못 열면 false)
+    static bool scanDirectory(const std::string& directory, const std::string& suffix,
+                              std::vector<std::string>& files, uint64_t& hash);
+
+    // hash 가 맞는 cache 가 있으면 읽어서 true
+    static bool loadLayouts(const std::string& path, uint64_t hash, LayoutMap& layouts);
+    static bool saveLayouts(const std::string& path, uint64_t hash, const LayoutMap& layouts);
+    static bool loadTables(const std::string& path, uint64_t hash, TableList& tables);
+    static bool saveTables(const std::string& path, uint64_t hash, const TableList& tables);
+};
+
+#endif // SPEC_CACHE_H
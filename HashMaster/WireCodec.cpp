@@ -0,0 +1,404 @@
+#include "WireCodec.h"
+#include "HashFunctions.h"
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cstring>
+
+// ===== varint (LEB128) =====
+
+static inline size_t varint_size(uint64_t v) {
+    size_t n = 1;
+    while (v >= 0x80) {
+        v >>= 7;
+        n++;
+    }
+    return n;
+}
+
+static inline char* put_varint(char* p, uint64_t v) {
+    while (v >= 0x80) {
+        *p++ = static_cast<char>((v & 0x7F) | 0x80);
+        v >>= 7;
+    }
+    *p++ = static_cast<char>(v);
+    return p;
+}
+
+static inline const char* get_varint(const char* p, const char* end, uint64_t& v) {
+    v = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t b = static_cast<uint8_t>(*p++);
+        v |= static_cast<uint64_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return p;
+    }
+    return nullptr;
+}
+
+static const uint64_t POW10[WIRE_CODEC_MAX_DIGITS + 1] = {
+    1ULL, 10ULL, 100ULL, 1000ULL, 10000ULL, 100000ULL, 1000000ULL, 10000000ULL, 100000000ULL,
+    1000000000ULL, 10000000000ULL, 100000000000ULL, 1000000000000ULL, 10000000000000ULL,
+    100000000000000ULL, 1000000000000000ULL, 10000000000000000ULL, 100000000000000000ULL,
+    1000000000000000000ULL
+};
+
+// ===== WireCodec =====
+
+WireCodec::WireCodec(std::shared_ptr<RecordLayout> layout)
+    : _layout(layout), _layout_id(0), _record_size(0), _bitmap_size(0), _max_encoded_size(0) {
+    if (!_layout) return;
+    _layout_id = layout_id_of(_layout->getRecordType());
+    _record_size = _layout->getRecordSize();
+
+    std::vector<FieldInfo> fields = _layout->getFields();
+    std::stable_sort(fields.begin(), fields.end(), [](const FieldInfo& a, const FieldInfo& b) {
+        return a.offset < b.offset;
+    });
+
+    // 필드 순서대로 segment 를 만들고, 필드 사이 빈 구간 / 겹치는 부분은 raw 로 채운다
+    int cursor = 0;
+    for (const auto& f : fields) {
+        if (f.length <= 0 || f.offset + f.length > _record_size) continue;
+        if (f.offset > cursor) {
+            _segments.push_back(Segment{cursor, f.offset - cursor, 0, SEG_RAW});
+            cursor = f.offset;
+        }
+        if (f.offset < cursor) {
+            int end = f.offset + f.length;
+            if (end > cursor) {
+                _segments.push_back(Segment{cursor, end - cursor, 0, SEG_RAW});
+                cursor = end;
+            }
+            continue;
+        }
+        SegmentKind kind = SEG_RAW;
+        switch (f.type) {
+            case FieldType::NINE_MODE: kind = SEG_NUMBER; break;
+            case FieldType::X_MODE:    kind = SEG_TEXT; break;
+            case FieldType::CHAR:      kind = SEG_CSTRING; break;
+            default:                   kind = SEG_RAW; break;
+        }
+        _segments.push_back(Segment{f.offset, f.length, f.decimal > 0 ? f.decimal : 0, kind});
+        cursor = f.offset + f.length;
+    }
+    if (cursor < _record_size) {
+        _segments.push_back(Segment{cursor, _record_size - cursor, 0, SEG_RAW});
+    }
+
+    _segment_at.assign(_record_size > 0 ? _record_size : 0, -1);
+    _bitmap_size = (_segments.size() + 7) / 8;
+    _max_encoded_size = sizeof(WireRecordHeader) + _bitmap_size;
+    for (size_t i = 0; i < _segments.size(); ++i) {
+        const Segment& s = _segments[i];
+        _segment_at[s.offset] = static_cast<int>(i);
+        switch (s.kind) {
+            case SEG_NUMBER:
+                _max_encoded_size += std::max(static_cast<size_t>(s.length), varint_size(UINT64_MAX));
+                break;
+            case SEG_TEXT:
+            case SEG_CSTRING:
+                _max_encoded_size += varint_size(s.length) + s.length;
+                break;
+            default:
+                _max_encoded_size += s.length;
+                break;
+        }
+    }
+}
+
+uint32_t WireCodec::layout_id_of(const std::string& record_type) {
+    return hash_djb2(record_type.data(), static_cast<int>(record_type.size()));
+}
+
+bool WireCodec::peek_header(const char* data, size_t size, WireRecordHeader& header) {
+    if (!data || size < sizeof(WireRecordHeader)) return false;
+    memcpy(&header, data, sizeof(header));
+    return true;
+}
+
+int WireCodec::segment_of(const FieldHandle& h) const {
+    if (!h.valid() || h.offset >= _record_size) return -1;
+    int i = _segment_at[h.offset];
+    if (i < 0 || _segments[i].length != h.length) return -1;
+    return i;
+}
+
+// 부호 + 숫자 (+ 정해진 자리의 '.') 로만 되어 있어야 원래 바이트로 되살릴 수 있다
+bool WireCodec::encode_number(const Segment& s, const char* p, uint64_t& packed) const {
+    int n = s.length;
+    bool negative = false;
+    if (*p == '-') {
+        negative = true;
+        p++;
+        n--;
+    }
+    int dot = -1;
+    if (s.decimal > 0) {
+        dot = n - s.decimal - 1;
+        if (dot < 0) return false;
+    }
+    uint64_t v = 0;
+    int digits = 0;
+    for (int i = 0; i < n; ++i) {
+        char c = p[i];
+        if (i == dot) {
+            if (c != '.') return false;
+            continue;
+        }
+        if (c < '0' || c > '9' || ++digits > WIRE_CODEC_MAX_DIGITS) return false;
+        v = v * 10 + static_cast<uint64_t>(c - '0');
+    }
+    packed = (v << 1) | (negative ? 1 : 0);
+    return true;
+}
+
+void WireCodec::decode_number(const Segment& s, uint64_t packed, char* dst) const {
+    int n = s.length;
+    if (packed & 1) {
+        *dst++ = '-';
+        n--;
+    }
+    uint64_t v = packed >> 1;
+    int dot = s.decimal > 0 ? n - s.decimal - 1 : -1;
+    for (int i = n - 1; i >= 0; --i) {
+        if (i == dot) {
+            dst[i] = '.';
+            continue;
+        }
+        dst[i] = static_cast<char>('0' + v % 10);
+        v /= 10;
+    }
+}
+
+size_t WireCodec::encode(const char* record, size_t size, char* out, size_t capacity) const {
+    if (!record || !out || _segments.empty() || size != static_cast<size_t>(_record_size) ||
+        capacity < _max_encoded_size) {
+        return 0;
+    }
+
+    WireRecordHeader header;
+    header.layout_id = _layout_id;
+    header.record_size = static_cast<uint32_t>(_record_size);
+    memcpy(out, &header, sizeof(header));
+    unsigned char* bitmap = reinterpret_cast<unsigned char*>(out + sizeof(header));
+    memset(bitmap, 0, _bitmap_size);
+    char* p = out + sizeof(header) + _bitmap_size;
+
+    for (size_t i = 0; i < _segments.size(); ++i) {
+        const Segment& s = _segments[i];
+        const char* src = record + s.offset;
+        bool raw = false;
+        switch (s.kind) {
+            case SEG_NUMBER: {
+                uint64_t packed;
+                if (encode_number(s, src, packed)) {
+                    p = put_varint(p, packed);
+                } else {
+                    raw = true;
+                }
+                break;
+            }
+            case SEG_TEXT: {
+                size_t len = s.length;
+                while (len > 0 && src[len - 1] == ' ') len--;
+                p = put_varint(p, len);
+                memcpy(p, src, len);
+                p += len;
+                break;
+            }
+            case SEG_CSTRING: {
+                size_t len = strnlen(src, s.length);
+                for (size_t k = len; k < static_cast<size_t>(s.length); ++k) {
+                    if (src[k] != '\0') {
+                        raw = true;
+                        break;
+                    }
+                }
+                if (!raw) {
+                    p = put_varint(p, len);
+                    memcpy(p, src, len);
+                    p += len;
+                }
+                break;
+            }
+            default:
+                memcpy(p, src, s.length);
+                p += s.length;
+                break;
+        }
+        if (raw) {
+            bitmap[i >> 3] |= static_cast<unsigned char>(1u << (i & 7));
+            memcpy(p, src, s.length);
+            p += s.length;
+        }
+    }
+    return static_cast<size_t>(p - out);
+}
+
+const char* WireCodec::decode_segment(size_t index, bool raw, const char* src, const char* end, char* dst) const {
+    const Segment& s = _segments[index];
+    if (raw || s.kind == SEG_RAW) {
+        if (end - src < s.length) return nullptr;
+        memcpy(dst, src, s.length);
+        return src + s.length;
+    }
+    uint64_t v;
+    src = get_varint(src, end, v);
+    if (!src) return nullptr;
+    if (s.kind == SEG_NUMBER) {
+        decode_number(s, v, dst);
+        return src;
+    }
+    if (v > static_cast<uint64_t>(s.length) || static_cast<uint64_t>(end - src) < v) return nullptr;
+    size_t len = static_cast<size_t>(v);
+    memcpy(dst, src, len);
+    memset(dst + len, s.kind == SEG_TEXT ? ' ' : '\0', s.length - len);
+    return src + len;
+}
+
+const char* WireCodec::read_number(const char* src, const char* end, long long& digits, bool& negative) {
+    uint64_t v;
+    src = get_varint(src, end, v);
+    if (!src) return nullptr;
+    digits = static_cast<long long>(v >> 1);
+    negative = (v & 1) != 0;
+    return src;
+}
+
+bool WireCodec::decode(const char* data, size_t size, char* record, size_t capacity) const {
+    WireRecordHeader header;
+    if (!peek_header(data, size, header) || header.layout_id != _layout_id ||
+        header.record_size != static_cast<uint32_t>(_record_size) ||
+        capacity < static_cast<size_t>(_record_size) || size < sizeof(header) + _bitmap_size) {
+        return false;
+    }
+    const unsigned char* bitmap = reinterpret_cast<const unsigned char*>(data + sizeof(header));
+    const char* p = data + sizeof(header) + _bitmap_size;
+    const char* end = data + size;
+    for (size_t i = 0; i < _segments.size(); ++i) {
+        bool raw = (bitmap[i >> 3] >> (i & 7)) & 1;
+        p = decode_segment(i, raw, p, end, record + _segments[i].offset);
+        if (!p) return false;
+    }
+    return true;
+}
+
+// ===== WireRecordView =====
+
+WireRecordView::WireRecordView(std::shared_ptr<const WireCodec> codec)
+    : _codec(codec), _data(nullptr), _size(0), _bitmap(nullptr), _end(nullptr),
+      _scratch(codec ? codec->record_size() : 0, '\0'),
+      _record(codec ? codec->layout() : std::shared_ptr<RecordLayout>(), _scratch.data()) {
+    if (_codec) _positions.resize(_codec->segment_count());
+}
+
+bool WireRecordView::attach(const char* data, size_t size) {
+    _data = nullptr;
+    if (!_codec) return false;
+
+    WireRecordHeader header;
+    size_t bitmap_size = (_codec->segment_count() + 7) / 8;
+    if (!WireCodec::peek_header(data, size, header) || header.layout_id != _codec->layout_id() ||
+        header.record_size != static_cast<uint32_t>(_codec->record_size()) ||
+        size < sizeof(header) + bitmap_size) {
+        return false;
+    }
+
+    // segment 시작 위치만 기록 (복원은 getter 에서)
+    _bitmap = reinterpret_cast<const unsigned char*>(data + sizeof(header));
+    const char* p = data + sizeof(header) + bitmap_size;
+    const char* end = data + size;
+    for (size_t i = 0; i < _codec->segment_count(); ++i) {
+        const WireCodec::Segment& s = _codec->segment(i);
+        _positions[i] = p;
+        if (is_raw(i) || s.kind == WireCodec::SEG_RAW) {
+            if (end - p < s.length) return false;
+            p += s.length;
+            continue;
+        }
+        uint64_t v = 0;
+        p = get_varint(p, end, v);
+        if (!p) return false;
+        if (s.kind != WireCodec::SEG_NUMBER) {
+            if (v > static_cast<uint64_t>(s.length) || static_cast<uint64_t>(end - p) < v) return false;
+            p += v;
+        }
+    }
+    _data = data;
+    _size = size;
+    _end = end;
+    return true;
+}
+
+bool WireRecordView::restore(const FieldHandle& h) const {
+    if (!_data || !h.valid() || h.offset + h.length > _codec->record_size()) return false;
+    int i = _codec->segment_of(h);
+    if (i < 0) {
+        // 이 레이아웃의 필드 경계와 다른 handle - 전체 복원
+        return _codec->decode(_data, _size, _scratch.data(), _scratch.size());
+    }
+    return _codec->decode_segment(i, is_raw(i), _positions[i], _end, _scratch.data() + h.offset) != nullptr;
+}
+
+bool WireRecordView::decode(char* record, size_t capacity) const {
+    return _data && _codec->decode(_data, _size, record, capacity);
+}
+
+std::string WireRecordView::getString(const FieldHandle& h) const {
+    if (!restore(h)) return "";
+    return _record.getString(h);
+}
+
+std::string WireRecordView::getValue(const FieldHandle& h) const {
+    if (!restore(h)) return "";
+    return _record.getValue(h);
+}
+
+// 9 모드는 varint 에서 바로 (atoi/atoll/atof 와 같은 결과: 소수부 버림 / 가장 가까운 double)
+int WireRecordView::getInt(const FieldHandle& h) const {
+    int i = _data ? _codec->segment_of(h) : -1;
+    if (i >= 0 && !is_raw(i) && _codec->segment(i).kind == WireCodec::SEG_NUMBER &&
+        _codec->segment(i).decimal <= WIRE_CODEC_MAX_DIGITS) {
+        long long digits;
+        bool negative;
+        if (WireCodec::read_number(_positions[i], _end, digits, negative)) {
+            long long v = digits / static_cast<long long>(POW10[_codec->segment(i).decimal]);
+            if (v <= INT_MAX) return negative ? -static_cast<int>(v) : static_cast<int>(v);
+        }
+    }
+    if (!restore(h)) return 0;
+    return _record.getInt(h);
+}
+
+long long WireRecordView::getLong(const FieldHandle& h) const {
+    int i = _data ? _codec->segment_of(h) : -1;
+    if (i >= 0 && !is_raw(i) && _codec->segment(i).kind == WireCodec::SEG_NUMBER &&
+        _codec->segment(i).decimal <= WIRE_CODEC_MAX_DIGITS) {
+        long long digits;
+        bool negative;
+        if (WireCodec::read_number(_positions[i], _end, digits, negative)) {
+            long long v = digits / static_cast<long long>(POW10[_codec->segment(i).decimal]);
+            return negative ? -v : v;
+        }
+    }
+    if (!restore(h)) return 0;
+    return _record.getLong(h);
+}
+
+double WireRecordView::getDouble(const FieldHandle& h) const {
+    int i = _data ? _codec->segment_of(h) : -1;
+    if (i >= 0 && !is_raw(i) && _codec->segment(i).kind == WireCodec::SEG_NUMBER &&
+        _codec->segment(i).decimal <= WIRE_CODEC_MAX_DIGITS) {
+        long long digits;
+        bool negative;
+        // 2^53 이상은 나눗셈에서 한번 더 반올림되고, 숫자 자리가 없는 필드 ("-") 는 atof 와 부호가 달라지므로 텍스트 경로로
+        const WireCodec::Segment& s = _codec->segment(i);
+        if (WireCodec::read_number(_positions[i], _end, digits, negative) && digits < (1LL << 53) &&
+            (digits != 0 || s.length > (negative ? 1 : 0) + (s.decimal > 0 ? 1 : 0))) {
+            double v = static_cast<double>(digits) / static_cast<double>(POW10[_codec->segment(i).decimal]);
+            return negative ? -v : v;
+        }
+    }
+    if (!restore(h)) return 0.0;
+    return _record.getDouble(h);
+}
@@ -0,0 +1,133 @@
+#ifndef WIRE_CODEC_H
+#define WIRE_CODEC_H
+
+#include "BinaryRecord.h"
+#include <stdint.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * @brief RecordLayout 레코드의 compact binary 전송 형식 (TopicMessage payload 용)
+ *
+ * sise/hoga 레코드는 대부분 X 모드(공백 padding) / 9 모드(0 padding) ASCII 라서 실제 정보보다
+ * 몇 배 크다. WireCodec 은 레이아웃에서 한번 만들어 두고 필드 단위로 줄여서 보낸다.
+ *  - 9 모드  : 부호 + 숫자만 varint ((magnitude << 1) | 음수) - 소수점 위치는 레이아웃이 안다
+ *  - X 모드  : 뒤쪽 공백을 뺀 길이(varint) + 내용
+ *  - char    : NUL 앞까지 길이(varint) + 내용
+ *  - 바이너리 : 그대로 (native int/double)
+ * 위 규칙으로 원래 바이트를 되살릴 수 없는 필드 (9 모드에 공백, 18 자리 초과, char 의 NUL 뒤 쓰레기 등)
+ * 는 raw bitmap 에 표시하고 원본 그대로 보낸다. 그래서 decode() 결과는 항상 원래 레코드와 같다.
+ *
+ *   | WireRecordHeader | raw bitmap (ceil(fields/8)) | field ... |
+ *
+ * 레이아웃 id 는 record type 이름의 hash 라서 publisher/subscriber 가 같은 spec 을 쓰면 같다.
+ * 레이아웃 (필드 길이/순서) 이 바뀌면 record_size 또는 decode 결과가 달라지므로 양쪽을 함께 배포해야 한다.
+ */
+#define WIRE_CODEC_MAX_DIGITS 18    // 9 모드 숫자 자리수 상한 (uint64 에 들어가는 범위)
+
+struct WireRecordHeader {
+    uint32_t layout_id;         // WireCodec::layout_id_of(record type)
+    uint32_t record_size;       // decode 된 레코드 크기
+};
+
+class WireCodec {
+public:
+    // 인코딩 단위 (필드 하나 또는 필드 사이 빈 구간)
+    enum SegmentKind {
+        SEG_RAW = 0,            // 항상 원본 그대로
+        SEG_NUMBER,             // 9 모드
+        SEG_TEXT,               // X 모드 (뒤쪽 공백 제거)
+        SEG_CSTRING             // char (NUL 앞까지)
+    };
+
+    struct Segment {
+        int offset;
+        int length;
+        int decimal;            // SEG_NUMBER: 소수부 자리수 (0: 소수점 없음)
+        SegmentKind kind;
+    };
+
+private:
+    std::shared_ptr<RecordLayout> _layout;
+    std::vector<Segment> _segments;
+    std::vector<int> _segment_at;       // record offset -> segment 번호 (-1: 필드 시작 아님)
+    uint32_t _layout_id;
+    int _record_size;
+    size_t _bitmap_size;
+    size_t _max_encoded_size;
+
+    bool encode_number(const Segment& s, const char* p, uint64_t& packed) const;
+    void decode_number(const Segment& s, uint64_t packed, char* dst) const;
+
+public:
+    explicit WireCodec(std::shared_ptr<RecordLayout> layout);
+
+    static uint32_t layout_id_of(const std::string& record_type);
+    // payload 앞의 header 확인 (크기가 모자라면 false)
+    static bool peek_header(const char* data, size_t size, WireRecordHeader& header);
+
+    const std::shared_ptr<RecordLayout>& layout() const { return _layout; }
+    uint32_t layout_id() const { return _layout_id; }
+    int record_size() const { return _record_size; }
+    size_t max_encoded_size() const { return _max_encoded_size; }
+    size_t segment_count() const { return _segments.size(); }
+    const Segment& segment(size_t i) const { return _segments[i]; }
+    // FieldHandle 이 가리키는 segment 번호 (-1: 이 레이아웃의 필드가 아님)
+    int segment_of(const FieldHandle& h) const;
+
+    // record_size 바이트 레코드를 out 에 인코딩, 인코딩 크기 반환 (크기 불일치 / capacity 부족이면 0)
+    size_t encode(const char* record, size_t size, char* out, size_t capacity) const;
+    // 인코딩된 payload 를 record_size 바이트 레코드로 복원
+    bool decode(const char* data, size_t size, char* record, size_t capacity) const;
+
+    // segment 하나 복원 (dst 에 s.length 바이트), src 는 그 segment 의 인코딩 시작, 다음 위치 반환 (깨졌으면 nullptr)
+    const char* decode_segment(size_t index, bool raw, const char* src, const char* end, char* dst) const;
+    // 9 모드 segment 를 ASCII 로 만들지 않고 숫자로 (raw 가 아닌 경우)
+    static const char* read_number(const char* src, const char* end, long long& digits, bool& negative);
+};
+
+/**
+ * @brief 인코딩된 payload 위에서 필드를 필요할 때만 복원하는 BinaryRecord 호환 view
+ *
+ * attach() 는 segment 시작 위치만 훑어 두고 (복사 없음), getter 는 요청한 필드만 복원한다.
+ * getter 결과는 decode() 한 레코드에 BinaryRecord 같은 이름의 getter 를 쓴 것과 같다.
+ * 9 모드의 getInt/getLong/getDouble 은 ASCII 를 거치지 않고 varint 에서 바로 계산한다.
+ * attach 한 data 는 view 를 쓰는 동안 유효해야 한다 (topic callback 안에서만 사용).
+ */
+class WireRecordView {
+private:
+    std::shared_ptr<const WireCodec> _codec;
+    const char* _data;
+    size_t _size;
+    const unsigned char* _bitmap;
+    std::vector<const char*> _positions;    // segment 별 인코딩 시작
+    const char* _end;
+    mutable std::vector<char> _scratch;     // 텍스트 getter 용 (해당 필드 자리만 채움)
+    mutable BinaryRecord _record;
+
+    bool is_raw(size_t index) const { return (_bitmap[index >> 3] >> (index & 7)) & 1; }
+    // 필드를 _scratch 의 같은 offset 에 복원
+    bool restore(const FieldHandle& h) const;
+
+public:
+    explicit WireRecordView(std::shared_ptr<const WireCodec> codec);
+    WireRecordView(const WireRecordView&) = delete;
+    WireRecordView& operator=(const WireRecordView&) = delete;
+
+    bool attach(const char* data, size_t size);
+    bool attached() const { return _data != nullptr; }
+    const WireCodec& codec() const { return *_codec; }
+    const std::shared_ptr<RecordLayout>& layout() const { return _codec->layout(); }
+
+    std::string getString(const FieldHandle& h) const;
+    std::string getValue(const FieldHandle& h) const;
+    int getInt(const FieldHandle& h) const;
+    long long getLong(const FieldHandle& h) const;
+    double getDouble(const FieldHandle& h) const;
+
+    // 전체 레코드 복원 (capacity >= record_size)
+    bool decode(char* record, size_t capacity) const;
+};
+
+#endif // WIRE_CODEC_H
@@ -0,0 +1,156 @@
+/*
+ * bench_hash_distribution - HashTable built-in hash 함수 분포/속도 비교
+ *
+ * 실제 RIC 키 (trep_data 디렉터리의 csv 파일) 로 각 hash 함수의
+ *  - v1 (chaining, bucket = hash % hash_count) bucket 분포: 사용 bucket, 최대 chain, chi-square/df
+ *  - v2 (open addressing, 16-slot group) home group 분포: 최대 group 점유, 넘친 key 비율, tag 충돌
+ *  - 처리 속도 (ns/key)
+ * 를 출력한다.
+ *
+ * usage: bench_hash_distribution [hash_count] [csv_file:column ...]
+ *        (repo root 에서 실행, 인자가 없으면 trep_data 의 RIC 컬럼 사용)
+ */
+#include "HashFunctions.h"
+#include "HashTable.h"
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <set>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+static const int FIELD_LEN = 32;    // JAPAN/NASDAQ master primary_field_len
+
+struct KeySet {
+    std::string name;
+    std::vector<std::string> keys;  // FIELD_LEN 크기, NUL padding
+};
+
+static bool load_keys(const std::string& path, int column, KeySet& out) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::set<std::string> seen;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string field;
+        for (int i = 0; i <= column && std::getline(ss, field, ','); i++) {}
+        if (field.empty() || field.size() >= (size_t)FIELD_LEN || !seen.insert(field).second) continue;
+
+        std::string key(FIELD_LEN, '\0');
+        memcpy(&key[0], field.data(), field.size());
+        out.keys.push_back(key);
+    }
+    out.name = path.substr(path.find_last_of('/') + 1) + ":" + std::to_string(column);
+    return !out.keys.empty();
+}
+
+static inline uint32_t key_hash(HashFunction func, const std::string& key) {
+    return func(key.data(), (int)strnlen(key.data(), FIELD_LEN));
+}
+
+static void run(const KeySet& set, int func_id, int hash_count, int data_count) {
+    HashFunction func = get_builtin_hash_function(func_id);
+    size_t n = set.keys.size();
+
+    // v1: bucket 분포
+    std::vector<int> buckets(hash_count, 0);
+    for (const auto& key : set.keys) {
+        buckets[key_hash(func, key) % hash_count]++;
+    }
+    int used = 0, max_chain = 0;
+    double expected = (double)n / hash_count, chi2 = 0;
+    for (int c : buckets) {
+        if (c) used++;
+        max_chain = std::max(max_chain, c);
+        chi2 += (c - expected) * (c - expected) / expected;
+    }
+
+    // v2: home group 분포 + tag 충돌 (같은 group, 같은 7-bit tag, 다른 fingerprint)
+    int groups = 1;
+    while (groups * HASH_GROUP_WIDTH < (long)data_count * 8 / 7 + 1) groups <<= 1;
+    std::vector<std::vector<uint32_t>> home(groups);
+    std::set<uint32_t> fps;
+    for (const auto& key : set.keys) {
+        uint32_t fp = hash_mix32(key_hash(func, key));
+        home[fp & (groups - 1)].push_back(fp);
+        fps.insert(fp);
+    }
+    size_t max_group = 0, overflow = 0, tag_false = 0;
+    for (const auto& g : home) {
+        max_group = std::max(max_group, g.size());
+        if (g.size() > HASH_GROUP_WIDTH) overflow += g.size() - HASH_GROUP_WIDTH;
+        for (size_t i = 0; i < g.size(); i++)
+            for (size_t j = i + 1; j < g.size(); j++)
+                if ((g[i] >> 25) == (g[j] >> 25) && g[i] != g[j]) tag_false++;
+    }
+
+    // 속도
+    const int rounds = std::max(1, (int)(5000000 / n));
+    uint32_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (const auto& key : set.keys) sink += key_hash(func, key);
+    }
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (rounds * n);
+
+    std::cout << std::left << std::setw(8) << hash_function_name(func_id) << std::right
+              << std::setw(8) << used
+              << std::setw(7) << max_chain
+              << std::setw(9) << std::fixed << std::setprecision(3) << chi2 / (hash_count - 1)
+              << std::setw(8) << max_group
+              << std::setw(9) << std::setprecision(2) << 100.0 * overflow / n
+              << std::setw(8) << tag_false
+              << std::setw(7) << (n - fps.size())
+              << std::setw(8) << std::setprecision(1) << ns
+              << (sink == 0xFFFFFFFF ? " " : "") << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int hash_count = 50003;     // config/MASTERs/JAPAN_EQUITY_MASTER.yaml
+    int argi = 1;
+    if (argc > 1 && strchr(argv[1], ':') == nullptr) {
+        hash_count = atoi(argv[1]);
+        argi = 2;
+    }
+    if (hash_count <= 0) {
+        std::cerr << "invalid hash_count" << std::endl;
+        return 1;
+    }
+
+    std::vector<std::pair<std::string, int>> inputs;
+    for (int i = argi; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t colon = arg.rfind(':');
+        inputs.push_back(std::make_pair(arg.substr(0, colon), atoi(arg.substr(colon + 1).c_str())));
+    }
+    if (inputs.empty()) {
+        inputs.push_back(std::make_pair("trep_data/O_JAPAN_EQUITY_M_20250813.csv", 3));
+        inputs.push_back(std::make_pair("trep_data/O_NASDAQ_EQUITY_B_20250728.csv", 0));
+        inputs.push_back(std::make_pair("trep_data/O_TSE_EQUITY_L.csv", 0));
+    }
+
+    std::cout << "CRC32-C: " << (crc32c_hardware_supported() ? "SSE4.2" : "software table") << std::endl;
+
+    for (const auto& input : inputs) {
+        KeySet set;
+        if (!load_keys(input.first, input.second, set)) continue;
+
+        std::cout << "\n=== " << set.name << " (" << set.keys.size() << " keys, hash_count "
+                  << hash_count << ", v2 data_count " << hash_count << ") ===" << std::endl;
+        std::cout << "func       used  chain  chi2/df  maxgrp  over(%)  tagfp  fpdup   ns/key" << std::endl;
+        for (int id : {HASH_FUNC_DJB2, HASH_FUNC_WYMIX, HASH_FUNC_CRC32C}) {
+            run(set, id, hash_count, hash_count);
+        }
+    }
+    return 0;
+}
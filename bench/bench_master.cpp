@@ -0,0 +1,502 @@
+/*
+ * bench_master - HashTable / HashMaster / MemoryMaster / SlabMemoryMaster 연산 microbenchmark
+ *
+ * 실제 RIC 키 (trep_data 디렉터리의 csv 파일) 로 target 마다
+ *  - put  : 키 전체를 (섞은 순서로) 단일 writer 가 넣는 처리량 / 연산별 지연
+ *  - get  : --threads 개 reader 가 동시에 있는 키를 조회
+ *  - miss : 없는 키 조회 (chain / probe 끝까지 걷는 비용)
+ *  - del  : 키 전체 삭제 (단일 writer)
+ * 를 load factor (키 수 / slot 수) x index 포맷 (v1/v2) x lock on/off 별로 잰다.
+ * HashTable / HashMaster 는 put 직후 HashTable::get_statistics() 의 chain 길이 분포도 출력한다.
+ * MemoryMaster / SlabMemoryMaster 는 index 포맷 / load factor 와 무관하므로 lock 모드별로 한번만 돈다.
+ *
+ * 결과는 조건마다 JSON 한 줄 (JSONL). 지연은 연산마다 latency_now_ns() 두번을 포함하므로
+ * 첫 줄 ("bench":"env") 의 clock_ns 만큼 부풀려져 있다.
+ * lock off 에서도 writer 는 하나, reader 만 여러 스레드 (repo 의 single writer 모델).
+ * 라이브러리 로그(printf)는 --verbose 가 아니면 버린다.
+ *
+ * usage: bench_master [--target hashtable,hashmaster,memorymaster,slabmaster] [--load-factors 0.5,0.7,0.9]
+ *                     [--index-versions 1,2] [--locks on,off] [--threads 1,2,4]
+ *                     [--reads N] [--record-size BYTES] [--out FILE] [--verbose]
+ *                     [csv_file:column ...]
+ *        (repo root 에서 실행, mmap/ 에 bench_master_* 파일을 만들고 끝나면 지운다)
+ */
+#include "HashMaster/HashTable.h"
+#include "HashMaster/HashMaster.h"
+#include "HashMaster/MemoryMaster.h"
+#include "HashMaster/SlabMemoryMaster.h"
+#include "common/LatencyStats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace SimplePubSub;
+
+namespace {
+
+static const int FIELD_LEN = 32;    // JAPAN/NASDAQ master primary_field_len
+
+struct Options {
+    std::vector<std::string> targets = {"hashtable", "hashmaster", "memorymaster", "slabmaster"};
+    std::vector<double> load_factors = {0.5, 0.7, 0.9};
+    std::vector<int> index_versions = {HASH_INDEX_V1_CHAINED, HASH_INDEX_V2_OPEN_ADDRESSING};
+    std::vector<bool> locks = {true, false};
+    std::vector<int> threads = {1, 2, 4};
+    uint64_t reads = 1000000;           // get / miss 단계의 스레드당 조회 수
+    int record_size = 512;
+    std::vector<std::pair<std::string, int>> inputs;
+    std::string out;
+    bool verbose = false;
+};
+
+Options g_opt;
+FILE* g_out = nullptr;
+int g_run = 0;
+
+typedef std::chrono::steady_clock Clock;
+
+// JSON 한 줄 결과
+class Result {
+public:
+    explicit Result(const std::string& bench) { _os << "{\"bench\":\"" << bench << "\""; }
+    Result& add(const char* key, const std::string& v) { _os << ",\"" << key << "\":\"" << v << "\""; return *this; }
+    Result& add(const char* key, const char* v) { return add(key, std::string(v)); }
+    Result& add(const char* key, double v) { _os << ",\"" << key << "\":" << v; return *this; }
+    Result& add(const char* key, uint64_t v) { _os << ",\"" << key << "\":" << v; return *this; }
+    Result& add(const char* key, int v) { _os << ",\"" << key << "\":" << v; return *this; }
+    Result& add(const char* key, const int* v, int n) {
+        _os << ",\"" << key << "\":[";
+        for (int i = 0; i < n; ++i) _os << (i ? "," : "") << v[i];
+        _os << "]";
+        return *this;
+    }
+    Result& latency(const StatsSnapshot::Histogram& h) {
+        add("p50_ns", h.percentile(50));
+        add("p99_ns", h.percentile(99));
+        add("p999_ns", h.percentile(99.9));
+        add("max_ns", h.max());
+        return *this;
+    }
+    void emit() {
+        _os << "}\n";
+        fputs(_os.str().c_str(), g_out);
+        fflush(g_out);
+    }
+
+private:
+    std::ostringstream _os;
+};
+
+struct KeySet {
+    std::string name;
+    std::vector<std::string> keys;      // FIELD_LEN 크기, NUL padding
+    std::vector<std::string> misses;    // 어느 키와도 겹치지 않는 키
+};
+
+bool load_keys(const std::string& path, int column, KeySet& out) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "cannot open " << path << std::endl;
+        return false;
+    }
+
+    std::set<std::string> seen;
+    std::string line;
+    while (std::getline(in, line)) {
+        std::stringstream ss(line);
+        std::string field;
+        for (int i = 0; i <= column && std::getline(ss, field, ','); i++) {}
+        if (field.empty() || field.size() + 1 >= (size_t)FIELD_LEN || !seen.insert(field).second) continue;
+
+        std::string key(FIELD_LEN, '\0');
+        memcpy(&key[0], field.data(), field.size());
+        out.keys.push_back(key);
+    }
+    // miss 키: 원래 키 뒤에 '~' (RIC 에 쓰이지 않는 문자) 를 붙임
+    for (const auto& key : out.keys) {
+        std::string miss = key;
+        miss[strnlen(key.data(), FIELD_LEN)] = '~';
+        out.misses.push_back(miss);
+    }
+    out.name = path.substr(path.find_last_of('/') + 1) + ":" + std::to_string(column);
+    return !out.keys.empty();
+}
+
+// 측정 대상 공통 인터페이스
+class Target {
+public:
+    virtual ~Target() {}
+    virtual bool init() = 0;
+    virtual bool put(const char* key, int index) = 0;
+    virtual bool get(const char* key) = 0;
+    virtual bool del(const char* key) = 0;
+    virtual bool chain_stats(HashTableStats* stats) { (void)stats; return false; }
+};
+
+void remove_file(const std::string& path) { unlink(path.c_str()); }
+
+class HashTableTarget : public Target {
+public:
+    HashTableTarget(int hash_count, int data_count, bool lock, int version) : _name(next_name()) {
+        remove_files();
+        _table.reset(new HashTable(hash_count, FIELD_LEN, data_count, lock, _name.c_str(), true));
+        _table->setIndexVersion(version);
+        _table->setLogLevel(LOG_ERROR);
+    }
+    ~HashTableTarget() override {
+        _table.reset();
+        remove_files();
+    }
+    bool init() override { return _table->init() == HASH_OK; }
+    bool put(const char* key, int index) override { return _table->put(key, index) == HASH_OK; }
+    bool get(const char* key) override { return _table->get(key) >= 0; }
+    bool del(const char* key) override { return _table->del(key) == HASH_OK; }
+    bool chain_stats(HashTableStats* stats) override {
+        *stats = _table->get_statistics();
+        return true;
+    }
+
+    static std::string next_name() {
+        return "bench_master_" + std::to_string(getpid()) + "_" + std::to_string(++g_run);
+    }
+
+private:
+    void remove_files() {
+        remove_file("mmap/" + _name + ".hashindex");
+        remove_file("mmap/" + _name + ".dataindex");
+        remove_file("mmap/" + _name + ".revindex");
+    }
+
+    std::string _name;
+    std::unique_ptr<HashTable> _table;
+};
+
+class MasterTarget : public Target {
+public:
+    MasterTarget(Master* master, const std::string& filename) : _master(master), _filename(filename) {
+        remove_files();
+        _record.assign(g_opt.record_size, 'r');
+    }
+    ~MasterTarget() override {
+        _master.reset();
+        remove_files();
+    }
+    // 새 파일은 free list 가 없으므로 init 후 clear 로 만든다 (HashMaster::init 은 공유 마스터를 지우지 않음)
+    bool init() override { return _master->init() == MASTER_OK && _master->clear() == MASTER_OK; }
+    bool put(const char* key, int index) override {
+        memcpy(&_record[0], &index, sizeof(index));
+        return _master->put(key, nullptr, _record.data(), (int)_record.size()) == MASTER_OK;
+    }
+    bool get(const char* key) override { return _master->get_by_primary(key) != nullptr; }
+    bool del(const char* key) override { return _master->del(key) == MASTER_OK; }
+    bool chain_stats(HashTableStats* stats) override {
+        HashMaster* hm = dynamic_cast<HashMaster*>(_master.get());
+        if (!hm) return false;
+        *stats = hm->get_hash_master_statistics().primary_stats;
+        return true;
+    }
+
+private:
+    void remove_files() {
+        if (_filename.empty()) return;
+        remove_file("mmap/" + _filename + "_records.dat");
+        remove_file("mmap/" + _filename + "_records.live");
+        remove_file("mmap/" + _filename + "_primary.hashindex");
+        remove_file("mmap/" + _filename + "_primary.dataindex");
+        remove_file("mmap/" + _filename + "_primary.revindex");
+    }
+
+    std::unique_ptr<Master> _master;
+    std::string _filename;
+    std::string _record;
+};
+
+std::unique_ptr<Target> make_target(const std::string& target, int hash_count, int data_count,
+                                    bool lock, int version) {
+    if (target == "hashtable") {
+        return std::unique_ptr<Target>(new HashTableTarget(hash_count, data_count, lock, version));
+    }
+
+    MasterConfig base;
+    base._max_record_count = data_count;
+    base._max_record_size = g_opt.record_size;
+    base._tot_size = data_count * g_opt.record_size;
+    base._hash_count = hash_count;
+    base._primary_field_len = FIELD_LEN;
+    base._secondary_field_len = 0;
+    base._use_lock = lock;
+    base._index_version = version;
+    base._log_level = LOG_ERROR;
+    base._filename = HashTableTarget::next_name();
+
+    if (target == "hashmaster") {
+        HashMasterConfig config(base);
+        return std::unique_ptr<Target>(new MasterTarget(new HashMaster(config), config._filename));
+    }
+    if (target == "memorymaster") {
+        MemoryMasterConfig config(base);
+        config._thread_safe = lock;
+        return std::unique_ptr<Target>(new MasterTarget(new MemoryMaster(config), ""));
+    }
+    if (target == "slabmaster") {
+        return std::unique_ptr<Target>(new MasterTarget(new SlabMemoryMaster(base), ""));
+    }
+    return nullptr;
+}
+
+// index 포맷 / load factor 설정이 없는 target (in-memory)
+bool in_memory_target(const std::string& target) {
+    return target == "memorymaster" || target == "slabmaster";
+}
+
+// 조회 순서 (스레드별로 다른 seed, 측정 루프에서 난수 생성 비용을 빼기 위해 미리 만든다)
+std::vector<uint32_t> make_order(size_t n, uint64_t count, uint32_t seed) {
+    std::mt19937 rng(seed);
+    std::uniform_int_distribution<uint32_t> dist(0, static_cast<uint32_t>(n - 1));
+    std::vector<uint32_t> order(count);
+    for (auto& i : order) i = dist(rng);
+    return order;
+}
+
+struct Condition {
+    std::string target;
+    const KeySet* set;
+    int version;
+    double load_factor;
+    bool lock;
+};
+
+Result condition_result(const char* bench, const Condition& c) {
+    Result r(bench);
+    r.add("target", c.target).add("keys", c.set->name).add("n", (uint64_t)c.set->keys.size())
+     .add("index_version", in_memory_target(c.target) ? 0 : c.version)
+     .add("load_factor", in_memory_target(c.target) ? 0.0 : c.load_factor)
+     .add("lock", c.lock ? "on" : "off");
+    return r;
+}
+
+// 단일 writer 단계 (put / del)
+void run_writes(const Condition& c, const char* op, const std::vector<uint32_t>& order,
+                const std::function<bool(uint32_t)>& fn) {
+    StatsHistogram latency;
+    uint64_t failures = 0;
+    auto t0 = Clock::now();
+    for (uint32_t i : order) {
+        uint64_t start = latency_now_ns();
+        if (!fn(i)) failures++;
+        latency.record(latency_now_ns() - start);
+    }
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+    condition_result("op", c).add("op", op).add("threads", 1).add("ops", (uint64_t)order.size())
+        .add("failures", failures).add("mops_per_sec", order.size() / sec / 1e6)
+        .latency(latency.snapshot()).emit();
+}
+
+// 동시 reader 단계 (get / miss)
+void run_reads(const Condition& c, const char* op, Target* target,
+               const std::vector<std::string>& keys, bool expect_hit, int threads) {
+    std::vector<std::vector<uint32_t>> orders;
+    for (int t = 0; t < threads; ++t) {
+        orders.push_back(make_order(keys.size(), g_opt.reads, 1000 + t));
+    }
+
+    StatsHistogram latency;
+    std::atomic<uint64_t> failures(0);
+    std::atomic<int> ready(0);
+    std::atomic<bool> go(false);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            uint64_t local_failures = 0;
+            ready++;
+            while (!go.load(std::memory_order_acquire)) {}
+            for (uint32_t i : orders[t]) {
+                uint64_t start = latency_now_ns();
+                bool hit = target->get(keys[i].data());
+                latency.record(latency_now_ns() - start);
+                if (hit != expect_hit) local_failures++;
+            }
+            failures += local_failures;
+        });
+    }
+    while (ready.load() < threads) {}
+    auto t0 = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (auto& w : workers) w.join();
+    double sec = std::chrono::duration<double>(Clock::now() - t0).count();
+
+    uint64_t ops = g_opt.reads * threads;
+    condition_result("op", c).add("op", op).add("threads", threads).add("ops", ops)
+        .add("failures", failures.load()).add("mops_per_sec", ops / sec / 1e6)
+        .latency(latency.snapshot()).emit();
+}
+
+// index 의 bucket / slot 수 (v2 는 data_count 의 8/7 이상인 2의 거듭제곱, bench_hash_distribution 과 같은 계산)
+int index_slots(int version, int slots) {
+    if (version != HASH_INDEX_V2_OPEN_ADDRESSING) return slots;
+    int groups = 1;
+    while (groups * HASH_GROUP_WIDTH < (long)slots * 8 / 7 + 1) groups <<= 1;
+    return groups * HASH_GROUP_WIDTH;
+}
+
+void bench_condition(const Condition& c) {
+    const KeySet& set = *c.set;
+    size_t n = set.keys.size();
+    int slots = static_cast<int>(std::ceil(n / c.load_factor));
+
+    std::unique_ptr<Target> target = make_target(c.target, slots, slots, c.lock, c.version);
+    if (!target || !target->init()) {
+        std::cerr << "init failed: " << c.target << std::endl;
+        return;
+    }
+
+    std::vector<uint32_t> order(n);
+    for (size_t i = 0; i < n; ++i) order[i] = static_cast<uint32_t>(i);
+    std::shuffle(order.begin(), order.end(), std::mt19937(42));
+
+    run_writes(c, "put", order, [&](uint32_t i) { return target->put(set.keys[i].data(), (int)i); });
+
+    HashTableStats stats;
+    if (target->chain_stats(&stats)) {
+        condition_result("chain", c).add("total_slots", stats.total_slots).add("used_slots", stats.used_slots)
+            .add("index_slots", index_slots(c.version, slots))
+            .add("actual_load_factor", stats.load_factor).add("collisions", stats.collision_count)
+            .add("max_chain", stats.max_chain_length).add("avg_chain", stats.avg_chain_length)
+            .add("chain_hist", stats.chain_length_hist, HASH_STATS_CHAIN_BUCKETS).emit();
+    }
+
+    for (int threads : g_opt.threads) {
+        run_reads(c, "get", target.get(), set.keys, true, threads);
+        run_reads(c, "miss", target.get(), set.misses, false, threads);
+    }
+
+    run_writes(c, "del", order, [&](uint32_t i) { return target->del(set.keys[i].data()); });
+}
+
+// 빈 측정 구간 (latency_now_ns 두번) 의 중간값
+uint64_t clock_overhead_ns() {
+    StatsHistogram h;
+    for (int i = 0; i < 100000; ++i) {
+        uint64_t start = latency_now_ns();
+        h.record(latency_now_ns() - start);
+    }
+    return h.snapshot().percentile(50);
+}
+
+template <typename T, typename F>
+std::vector<T> parse_list(const std::string& s, F convert) {
+    std::vector<T> v;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) v.push_back(convert(item));
+    }
+    return v;
+}
+
+bool parse_args(int argc, char* argv[]) {
+    auto to_int = [](const std::string& s) { return atoi(s.c_str()); };
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+        if (a == "--target") g_opt.targets = parse_list<std::string>(next(), [](const std::string& s) { return s; });
+        else if (a == "--load-factors") g_opt.load_factors = parse_list<double>(next(), [](const std::string& s) { return atof(s.c_str()); });
+        else if (a == "--index-versions") g_opt.index_versions = parse_list<int>(next(), to_int);
+        else if (a == "--locks") g_opt.locks = parse_list<bool>(next(), [](const std::string& s) { return s == "on"; });
+        else if (a == "--threads") g_opt.threads = parse_list<int>(next(), to_int);
+        else if (a == "--reads") g_opt.reads = strtoull(next().c_str(), nullptr, 10);
+        else if (a == "--record-size") g_opt.record_size = atoi(next().c_str());
+        else if (a == "--out") g_opt.out = next();
+        else if (a == "--verbose") g_opt.verbose = true;
+        else if (a.find(':') != std::string::npos && a.compare(0, 2, "--") != 0) {
+            size_t colon = a.rfind(':');
+            g_opt.inputs.push_back(std::make_pair(a.substr(0, colon), atoi(a.substr(colon + 1).c_str())));
+        } else {
+            std::cerr << "unknown option: " << a << std::endl;
+            return false;
+        }
+    }
+    for (double lf : g_opt.load_factors) {
+        if (lf <= 0 || lf > 1) {
+            std::cerr << "load factor must be in (0, 1]" << std::endl;
+            return false;
+        }
+    }
+    if (g_opt.reads == 0 || g_opt.record_size < (int)sizeof(int)) {
+        std::cerr << "reads must be > 0, record-size >= " << sizeof(int) << std::endl;
+        return false;
+    }
+    if (g_opt.inputs.empty()) {
+        g_opt.inputs.push_back(std::make_pair("trep_data/O_JAPAN_EQUITY_M_20250813.csv", 3));
+        g_opt.inputs.push_back(std::make_pair("trep_data/O_NASDAQ_EQUITY_B_20250728.csv", 0));
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (!parse_args(argc, argv)) return 1;
+
+    if (!g_opt.out.empty()) {
+        g_out = fopen(g_opt.out.c_str(), "w");
+    } else {
+        g_out = fdopen(dup(STDOUT_FILENO), "w");
+    }
+    if (!g_out) {
+        std::cerr << "cannot open " << (g_opt.out.empty() ? "stdout" : g_opt.out) << std::endl;
+        return 1;
+    }
+    // 라이브러리 로그 (printf) 는 버림 (결과는 g_out 으로만)
+    if (!g_opt.verbose) {
+        int devnull = open("/dev/null", O_WRONLY);
+        if (devnull >= 0) {
+            fflush(stdout);
+            dup2(devnull, STDOUT_FILENO);
+            close(devnull);
+        }
+    }
+    mkdir("mmap", 0755);
+
+    Result("env").add("clock_ns", clock_overhead_ns())
+        .add("hardware_threads", (int)std::thread::hardware_concurrency()).emit();
+
+    for (const auto& input : g_opt.inputs) {
+        KeySet set;
+        if (!load_keys(input.first, input.second, set)) continue;
+
+        for (const auto& target : g_opt.targets) {
+            for (bool lock : g_opt.locks) {
+                if (in_memory_target(target)) {
+                    bench_condition(Condition{target, &set, 0, 1.0, lock});
+                    continue;
+                }
+                for (int version : g_opt.index_versions) {
+                    for (double lf : g_opt.load_factors) {
+                        bench_condition(Condition{target, &set, version, lf, lock});
+                    }
+                }
+            }
+        }
+    }
+
+    fclose(g_out);
+    return 0;
+}
@@ -0,0 +1,544 @@
+/*
+ * bench_pubsub - SimplePublisherV2 / SimpleSubscriber 처리량, 지연, 복구 벤치마크
+ *
+ * 시나리오 (모두 한 프로세스 안에서 publisher event loop 는 main 스레드, 구독자는 각자 스레드/event_base):
+ *  - throughput : 구독자 수 x transport(unix/tcp) 별 publish / 전달 처리량 (msgs/s)
+ *  - latency    : 고정 속도 발행 시 fan-out 지연 p50/p99/p99.9 (payload 앞 8바이트의 발행 시각 기준)
+ *  - recovery   : DB 에 N 개 쌓은 뒤 seq 0 구독자가 N 개를 복구하는 시간 (Memory_SAM / DB_SAM / MMAP_SAM)
+ *  - interference : 구독자 하나가 복구하는 동안 ONLINE 구독자의 지연과 발행 속도 (복구 없을 때와 비교)
+ *
+ * throughput / latency 는 --socket-profiles 의 socket profile (none / latency / throughput) 마다 반복한다
+ * (같은 조건의 tail latency 를 profile 별로 비교, 결과의 "socket_profile").
+ * 한 프로세스 안에서 돌므로 tcp 도 loopback 이다 (NIC / 링크 특성은 포함되지 않음).
+ * 결과는 시나리오/조건마다 JSON 한 줄 (JSONL) 로 stdout 또는 --out 파일에 쓴다.
+ * 라이브러리 로그(std::cout)는 --verbose 가 아니면 버린다.
+ *
+ * usage: bench_pubsub [--scenario all|throughput|latency|recovery|interference]
+ *                     [--messages N] [--recovery-messages N] [--payload BYTES] [--batch N]
+ *                     [--subscribers 1,4,16] [--rate MSGS_PER_SEC] [--port PORT]
+ *                     [--sequence-flush-ms MS] [--socket-profiles none,latency,throughput]
+ *                     [--out FILE] [--verbose]
+ *        (repo root 에서 실행, ./data 와 ./bench_data 를 사용)
+ */
+#include "pubsub/SimplePublisherV2.h"
+#include "pubsub/SimpleSubscriber.h"
+#include "common/LatencyStats.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include <signal.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace SimplePubSub;
+
+namespace {
+
+struct Options {
+    std::string scenario = "all";
+    uint64_t messages = 200000;
+    uint64_t recovery_messages = 100000;
+    size_t payload = 100;
+    size_t batch = 16;
+    std::vector<int> subscribers = {1, 4, 16};
+    uint64_t rate = 20000;              // latency / interference 발행 속도 (msgs/s)
+    int port = 19500;
+    uint32_t sequence_flush_ms = 0;
+    std::vector<std::string> socket_profiles = {"none"};
+    std::string out;
+    bool verbose = false;
+};
+
+Options g_opt;
+SocketProfile g_profile;            // 지금 돌리는 socket profile (publisher / 구독자 양쪽)
+std::string g_profile_name = "none";
+FILE* g_out = stdout;
+int g_run = 0;
+
+typedef std::chrono::steady_clock Clock;
+
+double seconds_since(Clock::time_point t0) {
+    return std::chrono::duration<double>(Clock::now() - t0).count();
+}
+
+// JSON 한 줄 결과
+class Result {
+public:
+    explicit Result(const std::string& bench) { _os << "{\"bench\":\"" << bench << "\""; }
+    Result& add(const char* key, const std::string& v) { _os << ",\"" << key << "\":\"" << v << "\""; return *this; }
+    Result& add(const char* key, const char* v) { return add(key, std::string(v)); }
+    Result& add(const char* key, double v) { _os << ",\"" << key << "\":" << v; return *this; }
+    Result& add(const char* key, uint64_t v) { _os << ",\"" << key << "\":" << v; return *this; }
+    Result& add(const char* key, int v) { _os << ",\"" << key << "\":" << v; return *this; }
+    Result& latency(const char* prefix, const StatsSnapshot::Histogram& h) {
+        std::string p(prefix);
+        add((p + "_p50_us").c_str(), h.percentile(50) / 1000.0);
+        add((p + "_p99_us").c_str(), h.percentile(99) / 1000.0);
+        add((p + "_p999_us").c_str(), h.percentile(99.9) / 1000.0);
+        add((p + "_max_us").c_str(), h.max() / 1000.0);
+        return *this;
+    }
+    void emit() {
+        _os << "}\n";
+        fputs(_os.str().c_str(), g_out);
+        fflush(g_out);
+    }
+
+private:
+    std::ostringstream _os;
+};
+
+struct Endpoint {
+    SocketType type;
+    std::string address;
+    int port;
+    const char* name() const { return type == UNIX_SOCKET ? "unix" : "tcp"; }
+};
+
+Endpoint make_endpoint(const std::string& transport) {
+    g_run++;
+    if (transport == "tcp") {
+        return Endpoint{TCP_SOCKET, "127.0.0.1", g_opt.port + g_run};
+    }
+    return Endpoint{UNIX_SOCKET, "/tmp/bench_pubsub_" + std::to_string(getpid()) + "_" + std::to_string(g_run) + ".sock", 0};
+}
+
+// publisher (main 스레드에서 event loop 를 직접 돌림)
+class BenchPublisher {
+public:
+    BenchPublisher(const Endpoint& ep, MessageDBType db_type) : _base(event_base_new()) {
+        _name = "bench_pub_" + std::to_string(getpid()) + "_" + std::to_string(g_run);
+        _pub.reset(new SimplePublisherV2(_base));
+        _pub->set_publisher_id(1);
+        _pub->set_publisher_name(_name);
+        _pub->set_address(ep.type, ep.address, ep.port);
+        _pub->set_socket_profile(g_profile);
+        if (g_opt.sequence_flush_ms > 0) {
+            _pub->set_sequence_write_behind(g_opt.sequence_flush_ms);
+        }
+        _pub->init_sequence_storage(StorageType::FILE_STORAGE);
+        if (db_type != MessageDBType::MEMORY) {
+            _db_path = "./bench_data/" + _name + ".db";
+        }
+        _ok = _pub->init_database(_db_path, db_type) && _pub->start(2);
+        _payload.assign(std::max<size_t>(g_opt.payload, sizeof(uint64_t)), 'x');
+    }
+
+    ~BenchPublisher() {
+        _pub.reset();
+        event_base_free(_base);
+        if (!_db_path.empty()) {
+            unlink((_db_path + ".idx").c_str());
+            unlink((_db_path + ".data").c_str());
+        }
+        unlink(("./data/sequence_data/" + _name + ".seq").c_str());
+    }
+
+    bool ok() const { return _ok; }
+    const std::string& name() const { return _name; }
+    void pump() { event_base_loop(_base, EVLOOP_NONBLOCK); }
+
+    // payload 앞 8바이트에 발행 시각 (latency_now_ns) 을 넣어 구독자가 fan-out 지연을 잰다
+    void publish(size_t count) {
+        uint64_t now = latency_now_ns();
+        memcpy(&_payload[0], &now, sizeof(now));
+        _items.clear();
+        for (size_t i = 0; i < count; ++i) {
+            _items.push_back(PublishItem{DataTopic::TOPIC1, _payload.data(), _payload.size()});
+        }
+        if (count == 1) {
+            _pub->publish(DataTopic::TOPIC1, _payload.data(), _payload.size());
+        } else {
+            _pub->publish_batch(_items.data(), _items.size());
+        }
+    }
+
+private:
+    event_base* _base;
+    std::unique_ptr<SimplePublisherV2> _pub;
+    std::string _name;
+    std::string _db_path;
+    std::string _payload;
+    std::vector<PublishItem> _items;
+    bool _ok;
+};
+
+// 구독자 (자기 스레드 / event_base)
+class BenchSubscriber {
+public:
+    BenchSubscriber(const Endpoint& ep, uint32_t id, const std::string& pub_name)
+        : _base(event_base_new()), _received(0), _running(true) {
+        _sub = new SimpleSubscriber(_base);
+        _sub->set_client_info(100 + id, "bench_sub_" + std::to_string(id), 1, pub_name);
+        _sub->set_address(ep.type, ep.address, ep.port);
+        _sub->set_socket_profile(g_profile);
+        _sub->set_subscription_mask(DataTopic::ALL_TOPICS);
+        _sub->set_topic_callback([this](DataTopic, const char* data, int size) {
+            if (size >= static_cast<int>(sizeof(uint64_t))) {
+                uint64_t sent_ns;
+                memcpy(&sent_ns, data, sizeof(sent_ns));
+                _latency.record(latency_now_ns() - sent_ns);
+            }
+            _received.fetch_add(1, std::memory_order_relaxed);
+        });
+        _thread = std::thread([this]() {
+            _sub->connect();
+            while (_running.load()) {
+                struct timeval tv = {0, 5000};
+                event_base_loopexit(_base, &tv);
+                event_base_dispatch(_base);
+            }
+            _sub->stop();
+        });
+    }
+
+    ~BenchSubscriber() {
+        _running = false;
+        if (_thread.joinable()) _thread.join();
+        delete _sub;
+        event_base_free(_base);
+    }
+
+    uint64_t received() const { return _received.load(std::memory_order_relaxed); }
+    void merge_latency(StatsSnapshot::Histogram& out) const { _latency.merge_into(out); }
+    void reset_latency() { _latency.reset(); }
+
+private:
+    event_base* _base;
+    SimpleSubscriber* _sub;
+    std::atomic<uint64_t> _received;
+    std::atomic<bool> _running;
+    StatsHistogram _latency;        // 발행 ~ 콜백 (ns), 이 구독자만
+    std::thread _thread;
+};
+
+StatsSnapshot::Histogram fanout_latency(const std::vector<std::unique_ptr<BenchSubscriber>>& subs) {
+    StatsSnapshot::Histogram h;
+    for (const auto& s : subs) s->merge_latency(h);
+    return h;
+}
+
+void reset_latency(const std::vector<std::unique_ptr<BenchSubscriber>>& subs) {
+    for (const auto& s : subs) s->reset_latency();
+}
+
+uint64_t min_received(const std::vector<std::unique_ptr<BenchSubscriber>>& subs) {
+    uint64_t m = UINT64_MAX;
+    for (const auto& s : subs) m = std::min(m, s->received());
+    return subs.empty() ? 0 : m;
+}
+
+// 모든 구독자가 구독을 마치고 한 건 이상 받을 때까지 한 건씩 발행, 받은 수 반환
+bool warm_up(BenchPublisher& pub, const std::vector<std::unique_ptr<BenchSubscriber>>& subs, double timeout_sec) {
+    auto t0 = Clock::now();
+    auto last = t0;
+    while (min_received(subs) == 0) {
+        if (seconds_since(t0) > timeout_sec) return false;
+        pub.pump();
+        if (seconds_since(last) > 0.01) {
+            pub.publish(1);
+            last = Clock::now();
+        }
+    }
+    return true;
+}
+
+// 모든 구독자가 target 개를 받을 때까지 pump
+bool drain_until(BenchPublisher& pub, const std::vector<std::unique_ptr<BenchSubscriber>>& subs,
+                 uint64_t target, double timeout_sec) {
+    auto t0 = Clock::now();
+    while (min_received(subs) < target) {
+        if (seconds_since(t0) > timeout_sec) return false;
+        pub.pump();
+    }
+    return true;
+}
+
+void bench_throughput(const std::string& transport, int subscriber_count) {
+    Endpoint ep = make_endpoint(transport);
+    BenchPublisher pub(ep, MessageDBType::MEMORY);
+    if (!pub.ok()) {
+        Result("throughput").add("transport", ep.name()).add("error", "publisher start failed").emit();
+        return;
+    }
+    std::vector<std::unique_ptr<BenchSubscriber>> subs;
+    for (int i = 0; i < subscriber_count; ++i) {
+        subs.emplace_back(new BenchSubscriber(ep, i, pub.name()));
+    }
+    if (!warm_up(pub, subs, 10.0)) {
+        Result("throughput").add("transport", ep.name()).add("subscribers", subscriber_count)
+            .add("error", "subscribe timeout").emit();
+        return;
+    }
+    uint64_t base = min_received(subs);
+    reset_latency(subs);
+
+    // 구독자가 window 이상 뒤쳐지지 않게 발행 (송신 큐 무한 증가 방지)
+    const uint64_t window = 65536;
+    uint64_t sent = 0;
+    auto t0 = Clock::now();
+    while (sent < g_opt.messages) {
+        if (sent - (min_received(subs) - base) < window) {
+            size_t n = static_cast<size_t>(std::min<uint64_t>(g_opt.batch, g_opt.messages - sent));
+            pub.publish(n);
+            sent += n;
+        }
+        pub.pump();
+    }
+    double publish_sec = seconds_since(t0);
+    bool done = drain_until(pub, subs, base + g_opt.messages, 60.0);
+    double total_sec = seconds_since(t0);
+
+    Result("throughput").add("transport", ep.name()).add("socket_profile", g_profile_name)
+        .add("subscribers", subscriber_count).add("messages", g_opt.messages).add("payload", static_cast<uint64_t>(g_opt.payload))
+        .add("batch", static_cast<uint64_t>(g_opt.batch))
+        .add("publish_msgs_per_sec", g_opt.messages / publish_sec)
+        .add("delivered_msgs_per_sec", done ? g_opt.messages / total_sec : 0.0)
+        .add("complete", done ? 1 : 0)
+        .latency("fanout", fanout_latency(subs)).emit();
+}
+
+// rate msgs/s 로 duration_sec 동안 batch 단위 발행, 실제 발행 수 반환
+uint64_t publish_paced(BenchPublisher& pub, double duration_sec) {
+    const double interval = static_cast<double>(g_opt.batch) / g_opt.rate;
+    auto t0 = Clock::now();
+    auto next = t0;
+    uint64_t sent = 0;
+    while (seconds_since(t0) < duration_sec) {
+        if (Clock::now() >= next) {
+            pub.publish(g_opt.batch);
+            sent += g_opt.batch;
+            next += std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(interval));
+        }
+        pub.pump();
+    }
+    return sent;
+}
+
+void bench_latency(const std::string& transport, int subscriber_count) {
+    Endpoint ep = make_endpoint(transport);
+    BenchPublisher pub(ep, MessageDBType::MEMORY);
+    std::vector<std::unique_ptr<BenchSubscriber>> subs;
+    for (int i = 0; i < subscriber_count; ++i) {
+        subs.emplace_back(new BenchSubscriber(ep, i, pub.name()));
+    }
+    if (!pub.ok() || !warm_up(pub, subs, 10.0)) {
+        Result("latency").add("transport", ep.name()).add("subscribers", subscriber_count)
+            .add("error", "subscribe timeout").emit();
+        return;
+    }
+    uint64_t base = min_received(subs);
+    reset_latency(subs);
+    uint64_t sent = publish_paced(pub, 2.0);
+    drain_until(pub, subs, base + sent, 10.0);
+
+    Result("latency").add("transport", ep.name()).add("socket_profile", g_profile_name)
+        .add("subscribers", subscriber_count).add("rate", g_opt.rate).add("messages", sent).add("batch", static_cast<uint64_t>(g_opt.batch))
+        .latency("fanout", fanout_latency(subs)).emit();
+}
+
+const char* db_type_name(MessageDBType t) {
+    switch (t) {
+        case MessageDBType::MEMORY: return "Memory_SAM";
+        case MessageDBType::FILE: return "DB_SAM";
+        case MessageDBType::MMAP: return "MMAP_SAM";
+        case MessageDBType::SEGMENTED: return "SEGMENT_SAM";
+    }
+    return "unknown";
+}
+
+// DB 에 N 개를 쌓고 seq 0 구독자가 전부 받을 때까지의 시간
+void bench_recovery(MessageDBType db_type) {
+    Endpoint ep = make_endpoint("unix");
+    BenchPublisher pub(ep, db_type);
+    if (!pub.ok()) {
+        Result("recovery").add("db", db_type_name(db_type)).add("error", "publisher start failed").emit();
+        return;
+    }
+    const uint64_t n = g_opt.recovery_messages;
+    for (uint64_t sent = 0; sent < n; ) {
+        size_t k = static_cast<size_t>(std::min<uint64_t>(g_opt.batch, n - sent));
+        pub.publish(k);
+        sent += k;
+    }
+    pub.pump();
+
+    std::vector<std::unique_ptr<BenchSubscriber>> subs;
+    auto t0 = Clock::now();
+    subs.emplace_back(new BenchSubscriber(ep, 0, pub.name()));
+    bool done = drain_until(pub, subs, n, 120.0);
+    double sec = seconds_since(t0);
+
+    Result("recovery").add("db", db_type_name(db_type)).add("messages", n)
+        .add("payload", static_cast<uint64_t>(g_opt.payload))
+        .add("recovery_sec", sec).add("recovery_msgs_per_sec", done ? n / sec : 0.0)
+        .add("complete", done ? 1 : 0).emit();
+}
+
+// 복구 없는 구간과 복구 중인 구간에서 ONLINE 구독자 지연 / 발행 속도 비교
+void bench_interference(MessageDBType db_type) {
+    Endpoint ep = make_endpoint("unix");
+    BenchPublisher pub(ep, db_type);
+    std::vector<std::unique_ptr<BenchSubscriber>> online;
+    online.emplace_back(new BenchSubscriber(ep, 0, pub.name()));
+    if (!pub.ok() || !warm_up(pub, online, 10.0)) {
+        Result("interference").add("db", db_type_name(db_type)).add("error", "subscribe timeout").emit();
+        return;
+    }
+    // 복구할 backlog (ONLINE 구독자는 실시간으로 받음)
+    uint64_t backlog = g_opt.recovery_messages + min_received(online);
+    for (uint64_t sent = 0; sent < g_opt.recovery_messages; ) {
+        size_t k = static_cast<size_t>(std::min<uint64_t>(g_opt.batch, g_opt.recovery_messages - sent));
+        pub.publish(k);
+        sent += k;
+        pub.pump();
+    }
+    drain_until(pub, online, backlog, 30.0);
+
+    // 기준 구간 (복구 없음)
+    reset_latency(online);
+    auto t0 = Clock::now();
+    uint64_t base_sent = publish_paced(pub, 1.0);
+    double base_sec = seconds_since(t0);
+    StatsSnapshot::Histogram base_latency = fanout_latency(online);
+
+    // 복구 구간: 새 구독자가 backlog 전체를 복구하는 동안 같은 속도로 발행 (ONLINE 구독자 지연만 측정)
+    std::vector<std::unique_ptr<BenchSubscriber>> recovering;
+    recovering.emplace_back(new BenchSubscriber(ep, 1, pub.name()));
+    reset_latency(online);
+    t0 = Clock::now();
+    uint64_t rec_sent = 0;
+    while (recovering[0]->received() < backlog && seconds_since(t0) < 60.0) {
+        rec_sent += publish_paced(pub, 0.1);
+    }
+    double rec_sec = seconds_since(t0);
+    bool done = recovering[0]->received() >= backlog;
+    StatsSnapshot::Histogram rec_latency = fanout_latency(online);
+
+    Result("interference").add("db", db_type_name(db_type)).add("rate", g_opt.rate)
+        .add("backlog", g_opt.recovery_messages)
+        .add("baseline_publish_msgs_per_sec", base_sent / base_sec)
+        .add("recovery_publish_msgs_per_sec", rec_sent / rec_sec)
+        .add("recovery_sec", rec_sec).add("complete", done ? 1 : 0)
+        .latency("baseline", base_latency)
+        .latency("during_recovery", rec_latency).emit();
+}
+
+std::vector<std::string> parse_names(const std::string& s) {
+    std::vector<std::string> v;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) v.push_back(item);
+    }
+    return v;
+}
+
+std::vector<int> parse_list(const std::string& s) {
+    std::vector<int> v;
+    std::stringstream ss(s);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) v.push_back(atoi(item.c_str()));
+    }
+    return v;
+}
+
+bool parse_args(int argc, char* argv[]) {
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        auto next = [&]() -> std::string { return i + 1 < argc ? argv[++i] : ""; };
+        if (a == "--scenario") g_opt.scenario = next();
+        else if (a == "--messages") g_opt.messages = strtoull(next().c_str(), nullptr, 10);
+        else if (a == "--recovery-messages") g_opt.recovery_messages = strtoull(next().c_str(), nullptr, 10);
+        else if (a == "--payload") g_opt.payload = strtoul(next().c_str(), nullptr, 10);
+        else if (a == "--batch") g_opt.batch = strtoul(next().c_str(), nullptr, 10);
+        else if (a == "--subscribers") g_opt.subscribers = parse_list(next());
+        else if (a == "--rate") g_opt.rate = strtoull(next().c_str(), nullptr, 10);
+        else if (a == "--port") g_opt.port = atoi(next().c_str());
+        else if (a == "--sequence-flush-ms") g_opt.sequence_flush_ms = static_cast<uint32_t>(atoi(next().c_str()));
+        else if (a == "--socket-profiles") g_opt.socket_profiles = parse_names(next());
+        else if (a == "--out") g_opt.out = next();
+        else if (a == "--verbose") g_opt.verbose = true;
+        else {
+            std::cerr << "unknown option: " << a << std::endl;
+            return false;
+        }
+    }
+    if (g_opt.batch == 0 || g_opt.rate == 0 || g_opt.messages == 0 || g_opt.recovery_messages == 0) {
+        std::cerr << "batch, rate, messages must be > 0" << std::endl;
+        return false;
+    }
+    for (const auto& name : g_opt.socket_profiles) {
+        SocketProfile p;
+        if (!socket_profile_from_name(name, p)) {
+            std::cerr << "unknown socket profile: " << name << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    if (!parse_args(argc, argv)) return 1;
+    signal(SIGPIPE, SIG_IGN);      // 구독자 종료 직후 publisher 쓰기
+
+    if (!g_opt.out.empty()) {
+        g_out = fopen(g_opt.out.c_str(), "w");
+        if (!g_out) {
+            std::cerr << "cannot open " << g_opt.out << std::endl;
+            return 1;
+        }
+    }
+    // 라이브러리 로그는 버림 (결과는 g_out 으로만)
+    std::ofstream devnull("/dev/null");
+    std::streambuf* cout_buf = std::cout.rdbuf();
+    if (!g_opt.verbose) std::cout.rdbuf(devnull.rdbuf());
+
+    mkdir("./data", 0755);
+    mkdir("./data/sequence_data", 0755);
+    mkdir("./bench_data", 0755);
+
+    const std::string& s = g_opt.scenario;
+    for (const auto& profile : g_opt.socket_profiles) {
+        socket_profile_from_name(profile, g_profile);
+        g_profile_name = profile;
+        if (s == "all" || s == "throughput") {
+            for (const char* transport : {"unix", "tcp"}) {
+                for (int n : g_opt.subscribers) bench_throughput(transport, n);
+            }
+        }
+        if (s == "all" || s == "latency") {
+            for (const char* transport : {"unix", "tcp"}) {
+                for (int n : g_opt.subscribers) bench_latency(transport, n);
+            }
+        }
+    }
+    g_profile = SocketProfile();
+    g_profile_name = "none";
+    if (s == "all" || s == "recovery") {
+        bench_recovery(MessageDBType::MEMORY);
+        bench_recovery(MessageDBType::FILE);
+        bench_recovery(MessageDBType::MMAP);
+    }
+    if (s == "all" || s == "interference") {
+        bench_interference(MessageDBType::MEMORY);
+        bench_interference(MessageDBType::FILE);
+    }
+
+    std::cout.rdbuf(cout_buf);
+    if (g_out != stdout) fclose(g_out);
+    return 0;
+}
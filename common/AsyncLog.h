@@ -0,0 +1,491 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include <sys/syscall.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace SimplePubSub {
+
+/**
+ * AsyncLogger - hot path 용 비동기 로그 (스레드별 lock-free ring + background writer)
+ *
+ * 호출 스레드는 format 문자열 포인터와 인자를 binary 그대로 자기 ring 의 slot 에 적고 끝난다
+ * (printf 포맷팅 / stdout lock / write 없음). background writer 스레드가 모든 ring 을 비우면서
+ * 포맷팅하고 한번에 출력한다.
+ *
+ *  - ALOG_DEBUG/INFO/WARN/ERROR(component, fmt, ...) : printf 형식, fmt 와 component 는 문자열 literal
+ *    (writer 가 나중에 읽으므로 수명이 프로그램 전체여야 함). 문자열 인자 (char* / std::string) 는 복사.
+ *  - ASYNC_LOG_MIN_LEVEL 보다 낮은 매크로는 컴파일 시 제거 (예: -DASYNC_LOG_MIN_LEVEL=1 이면 DEBUG 코드 없음)
+ *  - 그 이상은 set_level() 의 runtime level 로 거른다 (꺼진 level 은 atomic load 한번)
+ *  - logv() : 기존 vararg log() 용. 인자를 binary 로 보관할 수 없어서 호출 스레드에서 slot 에 vsnprintf
+ *    하고 출력만 writer 가 한다. level 판단은 호출 측 (컴포넌트별 log level) 이 한다.
+ *
+ * ring 이 꽉 차면 기다리지 않고 버리며, 버린 수는 writer 가 WARN 으로 알린다.
+ * 한 줄은 slot 크기 (ASYNC_LOG_SLOT_SIZE) 안에서 잘린다. 스레드별 출력 순서는 유지되지만
+ * 스레드 간 순서는 writer 가 ring 을 도는 순서다 (각 줄의 시각으로 구분).
+ * flush() 는 지금까지 기록된 것을 모두 출력할 때까지 기다린다 (종료 / 테스트용).
+ */
+
+enum AsyncLogLevel {
+    ASYNC_LOG_DEBUG = 0,
+    ASYNC_LOG_INFO = 1,
+    ASYNC_LOG_WARN = 2,
+    ASYNC_LOG_ERROR = 3,
+    ASYNC_LOG_OFF = 4
+};
+
+#ifndef ASYNC_LOG_MIN_LEVEL
+#define ASYNC_LOG_MIN_LEVEL 0
+#endif
+
+static const size_t ASYNC_LOG_SLOT_SIZE = 256;
+static const size_t ASYNC_LOG_RING_SLOTS = 1024;        // 스레드당 256KB
+static const uint32_t ASYNC_LOG_IDLE_SLEEP_US = 1000;   // writer 가 할 일이 없을 때 쉬는 시간
+
+inline const char* async_log_level_name(int level) {
+    switch (level) {
+        case ASYNC_LOG_DEBUG: return "DEBUG";
+        case ASYNC_LOG_INFO:  return "INFO";
+        case ASYNC_LOG_WARN:  return "WARN";
+        case ASYNC_LOG_ERROR: return "ERROR";
+        default:              return "OFF";
+    }
+}
+
+// "debug" / "info" / "warn"("warning") / "error" / "off", 모르면 false
+inline bool async_log_level_from_name(const std::string& name, AsyncLogLevel& level) {
+    if (name == "debug") level = ASYNC_LOG_DEBUG;
+    else if (name == "info") level = ASYNC_LOG_INFO;
+    else if (name == "warn" || name == "warning") level = ASYNC_LOG_WARN;
+    else if (name == "error") level = ASYNC_LOG_ERROR;
+    else if (name == "off") level = ASYNC_LOG_OFF;
+    else return false;
+    return true;
+}
+
+// slot 하나 = 한 줄
+struct AsyncLogRecord {
+    enum ArgKind : uint8_t { ARG_INT = 0, ARG_UINT, ARG_DOUBLE, ARG_STR, ARG_PTR };
+
+    uint64_t time_us;           // CLOCK_REALTIME
+    const char* component;
+    const char* format;         // nullptr 이면 payload 가 포맷팅된 문자열 (logv)
+    uint32_t tid;
+    uint8_t level;
+    uint8_t argc;
+    uint16_t payload_size;
+    char payload[ASYNC_LOG_SLOT_SIZE - 32];     // [kind][8 byte 값] 또는 [ARG_STR][len 2B][bytes][NUL]
+};
+static_assert(sizeof(AsyncLogRecord) == ASYNC_LOG_SLOT_SIZE, "AsyncLogRecord must fill one slot");
+
+// 인자 binary 인코딩 (producer 스레드)
+class AsyncLogEncoder {
+private:
+    AsyncLogRecord& _r;
+    size_t _at;
+
+    void put_scalar(uint8_t kind, const void* v) {
+        if (_at + 1 + 8 > sizeof(_r.payload)) return;
+        _r.payload[_at] = static_cast<char>(kind);
+        memcpy(_r.payload + _at + 1, v, 8);
+        _at += 9;
+        _r.argc++;
+    }
+
+public:
+    explicit AsyncLogEncoder(AsyncLogRecord& r) : _r(r), _at(0) { r.argc = 0; }
+    size_t size() const { return _at; }
+
+    void put_int(int64_t v) { put_scalar(AsyncLogRecord::ARG_INT, &v); }
+    void put_uint(uint64_t v) { put_scalar(AsyncLogRecord::ARG_UINT, &v); }
+    void put_double(double v) { put_scalar(AsyncLogRecord::ARG_DOUBLE, &v); }
+    void put_ptr(const void* p) {
+        uint64_t v = reinterpret_cast<uintptr_t>(p);
+        put_scalar(AsyncLogRecord::ARG_PTR, &v);
+    }
+    void put_str(const char* s, size_t len) {
+        if (_at + 4 > sizeof(_r.payload)) return;
+        size_t room = sizeof(_r.payload) - _at - 4;
+        if (len > room) len = room;             // 남은 공간만큼 잘라서 보관
+        uint16_t n = static_cast<uint16_t>(len);
+        _r.payload[_at] = static_cast<char>(AsyncLogRecord::ARG_STR);
+        memcpy(_r.payload + _at + 1, &n, 2);
+        memcpy(_r.payload + _at + 3, s, len);
+        _r.payload[_at + 3 + len] = '\0';
+        _at += 4 + len;
+        _r.argc++;
+    }
+
+    // 타입별 분기 (tag dispatch, C++14)
+    template <typename T>
+    void put_value(const T& v, std::true_type /*integral or enum*/) {
+        typedef typename std::conditional<std::is_enum<T>::value, std::underlying_type<T>, std::common_type<T>>::type::type U;
+        if (std::is_signed<U>::value) put_int(static_cast<int64_t>(static_cast<U>(v)));
+        else put_uint(static_cast<uint64_t>(static_cast<U>(v)));
+    }
+    template <typename T>
+    void put_value(const T& v, std::false_type) { put_other(v); }
+
+    void put_other(double v) { put_double(v); }
+    void put_other(float v) { put_double(v); }
+    void put_other(long double v) { put_double(static_cast<double>(v)); }
+    void put_other(const char* s) { if (s) put_str(s, strlen(s)); else put_str("(null)", 6); }
+    void put_other(char* s) { put_other(static_cast<const char*>(s)); }
+    void put_other(const std::string& s) { put_str(s.data(), s.size()); }
+    template <typename P>
+    void put_other(P* p) { put_ptr(p); }
+
+    template <typename T>
+    void put(const T& v) {
+        put_value(v, std::integral_constant<bool, std::is_integral<T>::value || std::is_enum<T>::value>());
+    }
+
+    void put_all() {}
+    template <typename T, typename... Rest>
+    void put_all(const T& v, const Rest&... rest) {
+        put(v);
+        put_all(rest...);
+    }
+};
+
+// 스레드 하나의 ring (SPSC: producer = 그 스레드, consumer = writer)
+struct AsyncLogRing {
+    AsyncLogRecord* slots;
+    uint32_t tid;
+    char _pad0[64];
+    std::atomic<size_t> head;                   // writer 가 갱신
+    char _pad1[64];                             // head / tail 을 다른 cache line 에 (heap 이라 alignas 대신 padding)
+    std::atomic<size_t> tail;                   // producer 가 갱신
+    size_t head_cache;                          // producer 전용
+    std::atomic<uint64_t> dropped;
+    std::atomic<bool> retired;                  // 스레드 종료 (비우고 나면 writer 가 해제)
+
+    AsyncLogRing() : slots(new AsyncLogRecord[ASYNC_LOG_RING_SLOTS]),
+                     tid(static_cast<uint32_t>(syscall(SYS_gettid))),
+                     head(0), tail(0), head_cache(0), dropped(0), retired(false) {}
+    ~AsyncLogRing() { delete[] slots; }
+
+    // 쓸 slot (꽉 차면 nullptr), 채운 뒤 commit()
+    AsyncLogRecord* claim() {
+        size_t t = tail.load(std::memory_order_relaxed);
+        if (t - head_cache >= ASYNC_LOG_RING_SLOTS) {
+            head_cache = head.load(std::memory_order_acquire);
+            if (t - head_cache >= ASYNC_LOG_RING_SLOTS) {
+                dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+        }
+        return &slots[t & (ASYNC_LOG_RING_SLOTS - 1)];
+    }
+    void commit() { tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release); }
+};
+
+class AsyncLogger {
+private:
+    std::atomic<int> _level;
+    std::mutex _rings_mu;                       // 등록 / writer 의 목록 복사에만
+    std::vector<AsyncLogRing*> _rings;
+    std::atomic<FILE*> _out;
+    std::thread _writer;
+    std::atomic<bool> _stop;
+    std::atomic<uint64_t> _written;
+    std::atomic<uint64_t> _committed;
+    std::string _buf;                           // writer 전용 출력 버퍼
+
+    struct RingHolder {
+        AsyncLogRing* ring;
+        RingHolder() : ring(nullptr) {}
+        ~RingHolder() { if (ring) ring->retired.store(true, std::memory_order_release); }
+    };
+
+    AsyncLogger() : _level(ASYNC_LOG_INFO), _out(stdout), _stop(false), _written(0), _committed(0) {
+        const char* env = getenv("ASYNC_LOG_LEVEL");
+        AsyncLogLevel level;
+        if (env && async_log_level_from_name(env, level)) {
+            _level.store(level, std::memory_order_relaxed);
+        }
+        _writer = std::thread([this]() { run(); });
+    }
+
+    ~AsyncLogger() {
+        _stop.store(true, std::memory_order_release);
+        if (_writer.joinable()) _writer.join();
+        for (auto* r : _rings) delete r;
+    }
+
+    AsyncLogRing* thread_ring() {
+        static thread_local RingHolder holder;
+        if (!holder.ring) {
+            holder.ring = new AsyncLogRing();
+            std::lock_guard<std::mutex> lock(_rings_mu);
+            _rings.push_back(holder.ring);
+        }
+        return holder.ring;
+    }
+
+    static uint64_t now_us() {
+        struct timeval tv;
+        gettimeofday(&tv, nullptr);
+        return static_cast<uint64_t>(tv.tv_sec) * 1000000ULL + tv.tv_usec;
+    }
+
+    AsyncLogRecord* begin(int level, const char* component, const char* format) {
+        AsyncLogRing* ring = thread_ring();
+        AsyncLogRecord* r = ring->claim();
+        if (!r) return nullptr;
+        r->time_us = now_us();
+        r->component = component;
+        r->format = format;
+        r->tid = ring->tid;
+        r->level = static_cast<uint8_t>(level);
+        return r;
+    }
+
+    void end() {
+        thread_ring()->commit();
+        _committed.fetch_add(1, std::memory_order_release);
+    }
+
+    // 변환 지정자 하나를 인자 하나로 포맷팅
+    void format_arg(const char* spec, size_t spec_len, char conv, const char*& arg, const char* arg_end) {
+        char fmt[32];
+        char tmp[128];
+        // spec 에서 길이 수식어 (h, l, ll, z, j, t, L, q) 를 빼고 인자 종류에 맞는 것을 붙인다
+        size_t n = 0;
+        for (size_t i = 0; i < spec_len && n < sizeof(fmt) - 4; ++i) {
+            char c = spec[i];
+            if (c == 'h' || c == 'l' || c == 'z' || c == 'j' || c == 't' || c == 'L' || c == 'q') continue;
+            fmt[n++] = c;
+        }
+        if (arg >= arg_end) {
+            _buf.append(spec, spec_len).push_back(conv);    // 인자 부족: 지정자를 그대로
+            return;
+        }
+        uint8_t kind = static_cast<uint8_t>(*arg);
+        int len = 0;
+        if (kind == AsyncLogRecord::ARG_STR) {
+            uint16_t sl;
+            memcpy(&sl, arg + 1, 2);
+            const char* s = arg + 3;
+            arg += 4 + sl;
+            if (conv == 's') {
+                fmt[n++] = 's'; fmt[n] = '\0';
+                if (n == 2) {   // "%s" 는 그대로 붙인다
+                    _buf.append(s, sl);
+                    return;
+                }
+                len = snprintf(tmp, sizeof(tmp), fmt, s);
+            } else {
+                _buf.append(s, sl);
+                return;
+            }
+        } else {
+            uint64_t v;
+            memcpy(&v, arg + 1, 8);
+            arg += 9;
+            if (kind == AsyncLogRecord::ARG_DOUBLE) {
+                double d;
+                memcpy(&d, &v, 8);
+                if (strchr("fFeEgGaA", conv)) { fmt[n++] = conv; fmt[n] = '\0'; }
+                else { fmt[n++] = 'g'; fmt[n] = '\0'; }
+                len = snprintf(tmp, sizeof(tmp), fmt, d);
+            } else if (kind == AsyncLogRecord::ARG_PTR || conv == 'p') {
+                fmt[n++] = 'p'; fmt[n] = '\0';
+                len = snprintf(tmp, sizeof(tmp), fmt, reinterpret_cast<void*>(static_cast<uintptr_t>(v)));
+            } else if (conv == 'c') {
+                fmt[n++] = 'c'; fmt[n] = '\0';
+                len = snprintf(tmp, sizeof(tmp), fmt, static_cast<int>(v));
+            } else if (strchr("uxXo", conv)) {
+                fmt[n++] = 'l'; fmt[n++] = 'l'; fmt[n++] = conv; fmt[n] = '\0';
+                len = snprintf(tmp, sizeof(tmp), fmt, static_cast<unsigned long long>(v));
+            } else if (strchr("fFeEgG", conv)) {
+                fmt[n++] = conv; fmt[n] = '\0';
+                len = snprintf(tmp, sizeof(tmp), fmt, kind == AsyncLogRecord::ARG_INT
+                               ? static_cast<double>(static_cast<int64_t>(v)) : static_cast<double>(v));
+            } else if (kind == AsyncLogRecord::ARG_UINT) {
+                fmt[n++] = 'l'; fmt[n++] = 'l'; fmt[n++] = 'u'; fmt[n] = '\0';
+                len = snprintf(tmp, sizeof(tmp), fmt, static_cast<unsigned long long>(v));
+            } else {
+                fmt[n++] = 'l'; fmt[n++] = 'l'; fmt[n++] = 'd'; fmt[n] = '\0';
+                len = snprintf(tmp, sizeof(tmp), fmt, static_cast<long long>(static_cast<int64_t>(v)));
+            }
+        }
+        if (len > 0) _buf.append(tmp, std::min(static_cast<size_t>(len), sizeof(tmp) - 1));
+    }
+
+    void format_record(const AsyncLogRecord& r) {
+        char head[96];
+        time_t sec = static_cast<time_t>(r.time_us / 1000000ULL);
+        struct tm tm;
+        localtime_r(&sec, &tm);
+        int n = snprintf(head, sizeof(head), "%02d:%02d:%02d.%06u [%s] %s: ",
+                         tm.tm_hour, tm.tm_min, tm.tm_sec, static_cast<unsigned>(r.time_us % 1000000ULL),
+                         async_log_level_name(r.level), r.component ? r.component : "-");
+        _buf.append(head, n > 0 ? static_cast<size_t>(n) : 0);
+
+        if (!r.format) {
+            _buf.append(r.payload, strnlen(r.payload, sizeof(r.payload)));
+        } else {
+            const char* arg = r.payload;
+            const char* arg_end = r.payload + r.payload_size;
+            for (const char* f = r.format; *f; ) {
+                if (*f != '%') {
+                    const char* q = strchr(f, '%');
+                    size_t run = q ? static_cast<size_t>(q - f) : strlen(f);
+                    _buf.append(f, run);
+                    f += run;
+                    continue;
+                }
+                if (f[1] == '%') {
+                    _buf.push_back('%');
+                    f += 2;
+                    continue;
+                }
+                const char* spec = f++;
+                while (*f && strchr("-+ #0", *f)) ++f;
+                while (*f >= '0' && *f <= '9') ++f;
+                if (*f == '.') { ++f; while (*f >= '0' && *f <= '9') ++f; }
+                while (*f && strchr("hlzjtLq", *f)) ++f;
+                if (!*f) {
+                    _buf.append(spec);
+                    break;
+                }
+                char conv = *f++;
+                format_arg(spec, static_cast<size_t>(f - 1 - spec), conv, arg, arg_end);
+            }
+        }
+        if (_buf.empty() || _buf.back() != '\n') _buf.push_back('\n');
+    }
+
+    // 모든 ring 을 한번 비움, 처리한 줄 수 반환
+    size_t drain() {
+        std::vector<AsyncLogRing*> rings;
+        {
+            std::lock_guard<std::mutex> lock(_rings_mu);
+            rings = _rings;
+        }
+        size_t lines = 0;
+        for (AsyncLogRing* ring : rings) {
+            size_t h = ring->head.load(std::memory_order_relaxed);
+            size_t t = ring->tail.load(std::memory_order_acquire);
+            for (; h != t; ++h) {
+                format_record(ring->slots[h & (ASYNC_LOG_RING_SLOTS - 1)]);
+                ++lines;
+            }
+            ring->head.store(h, std::memory_order_release);
+            uint64_t dropped = ring->dropped.exchange(0, std::memory_order_relaxed);
+            if (dropped) {
+                char msg[96];
+                int n = snprintf(msg, sizeof(msg), "[WARN] AsyncLog: thread %u dropped %llu log lines (ring full)\n",
+                                 ring->tid, static_cast<unsigned long long>(dropped));
+                if (n > 0) _buf.append(msg, static_cast<size_t>(n));
+            }
+        }
+        if (!_buf.empty()) {
+            FILE* out = _out.load(std::memory_order_acquire);
+            fwrite(_buf.data(), 1, _buf.size(), out);
+            fflush(out);
+            _buf.clear();
+        }
+        _written.fetch_add(lines, std::memory_order_release);
+
+        // 종료된 스레드의 빈 ring 정리
+        std::lock_guard<std::mutex> lock(_rings_mu);
+        for (size_t i = 0; i < _rings.size(); ) {
+            AsyncLogRing* r = _rings[i];
+            if (r->retired.load(std::memory_order_acquire) &&
+                r->head.load(std::memory_order_relaxed) == r->tail.load(std::memory_order_acquire)) {
+                delete r;
+                _rings[i] = _rings.back();
+                _rings.pop_back();
+            } else {
+                ++i;
+            }
+        }
+        return lines;
+    }
+
+    void run() {
+        while (!_stop.load(std::memory_order_acquire)) {
+            if (drain() == 0) {
+                std::this_thread::sleep_for(std::chrono::microseconds(ASYNC_LOG_IDLE_SLEEP_US));
+            }
+        }
+        drain();
+    }
+
+public:
+    static AsyncLogger& instance() {
+        static AsyncLogger logger;
+        return logger;
+    }
+
+    AsyncLogger(const AsyncLogger&) = delete;
+    AsyncLogger& operator=(const AsyncLogger&) = delete;
+
+    bool enabled(int level) const { return level >= _level.load(std::memory_order_relaxed); }
+    void set_level(AsyncLogLevel level) { _level.store(level, std::memory_order_relaxed); }
+    AsyncLogLevel level() const { return static_cast<AsyncLogLevel>(_level.load(std::memory_order_relaxed)); }
+    // 출력 대상 (기본 stdout), 바꾸기 전에 flush() 권장
+    void set_output(FILE* out) { _out.store(out ? out : stdout, std::memory_order_release); }
+
+    template <typename... Args>
+    void log(int level, const char* component, const char* format, const Args&... args) {
+        AsyncLogRecord* r = begin(level, component, format);
+        if (!r) return;
+        AsyncLogEncoder enc(*r);
+        enc.put_all(args...);
+        r->payload_size = static_cast<uint16_t>(enc.size());
+        end();
+    }
+
+    // 컴포넌트별 vararg log() 가 넘기는 곳: 포맷팅 (vsnprintf) 은 호출 스레드에서 자기 ring slot 안에 하고,
+    // 출력만 writer 스레드가 한다. 여러 스레드에서 호출해도 되며 level 은 호출 측이 이미 거른 것으로 본다
+    void logv(int level, const char* component, const char* format, va_list args) {
+        AsyncLogRecord* r = begin(level, component, nullptr);
+        if (!r) return;
+        int n = vsnprintf(r->payload, sizeof(r->payload), format, args);
+        r->argc = 0;
+        r->payload_size = static_cast<uint16_t>(n < 0 ? 0 : std::min(static_cast<size_t>(n), sizeof(r->payload) - 1));
+        end();
+    }
+
+    // 지금까지 commit 된 줄이 모두 출력될 때까지 대기
+    void flush() {
+        uint64_t target = _committed.load(std::memory_order_acquire);
+        while (_written.load(std::memory_order_acquire) < target) {
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    uint64_t lines_written() const { return _written.load(std::memory_order_relaxed); }
+};
+
+} // namespace SimplePubSub
+
+#define ASYNC_LOG_AT(lvl, component, ...)                                                   \
+    do {                                                                                    \
+        if ((lvl) >= ASYNC_LOG_MIN_LEVEL &&                                                 \
+            ::SimplePubSub::AsyncLogger::instance().enabled(lvl)) {                         \
+            ::SimplePubSub::AsyncLogger::instance().log((lvl), (component), __VA_ARGS__);   \
+        }                                                                                   \
+    } while (0)
+
+#define ALOG_DEBUG(component, ...) ASYNC_LOG_AT(::SimplePubSub::ASYNC_LOG_DEBUG, component, __VA_ARGS__)
+#define ALOG_INFO(component, ...)  ASYNC_LOG_AT(::SimplePubSub::ASYNC_LOG_INFO, component, __VA_ARGS__)
+#define ALOG_WARN(component, ...)  ASYNC_LOG_AT(::SimplePubSub::ASYNC_LOG_WARN, component, __VA_ARGS__)
+#define ALOG_ERROR(component, ...) ASYNC_LOG_AT(::SimplePubSub::ASYNC_LOG_ERROR, component, __VA_ARGS__)
@@ -0,0 +1,232 @@
+#include "BlockCompression.h"
+#include <cstring>
+#ifdef HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace {
+
+// LZ4 block 형식: [token(literal 길이 4bit | match 길이-4 4bit)][literal 길이 확장][literal][offset 2B LE][match 길이 확장]...
+// 마지막 sequence 는 literal 만 있고, 마지막 5 바이트는 항상 literal 이다 (liblz4 와 같은 규칙이라 서로 풀 수 있음).
+const int LZ_HASH_BITS = 12;
+const size_t LZ_MIN_MATCH = 4;
+const size_t LZ_LAST_LITERALS = 5;
+const size_t LZ_MF_LIMIT = 12;          // match 는 입력 끝에서 12 바이트 전까지만 시작
+const size_t LZ_MAX_OFFSET = 65535;
+
+inline uint32_t read32(const uint8_t* p) {
+    uint32_t v;
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+inline uint32_t lz_hash(uint32_t v) {
+    return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+// 15 이상인 길이의 나머지: 255 가 이어지다가 255 미만 한 바이트
+inline bool put_length(uint8_t*& op, const uint8_t* oend, size_t len) {
+    while (len >= 255) {
+        if (op >= oend) return false;
+        *op++ = 255;
+        len -= 255;
+    }
+    if (op >= oend) return false;
+    *op++ = static_cast<uint8_t>(len);
+    return true;
+}
+
+inline bool get_length(const uint8_t*& ip, const uint8_t* iend, size_t& len) {
+    uint8_t b;
+    do {
+        if (ip >= iend) return false;
+        b = *ip++;
+        len += b;
+    } while (b == 255);
+    return true;
+}
+
+// literal + (match_len > 0 이면) match 한 sequence 기록
+bool emit_sequence(uint8_t*& op, const uint8_t* oend, const uint8_t* lit, size_t lit_len,
+                   size_t offset, size_t match_len) {
+    if (op >= oend) return false;
+    uint8_t* token = op++;
+    *token = static_cast<uint8_t>((lit_len >= 15 ? 15 : lit_len) << 4);
+    if (lit_len >= 15 && !put_length(op, oend, lit_len - 15)) return false;
+    if (static_cast<size_t>(oend - op) < lit_len) return false;
+    memcpy(op, lit, lit_len);
+    op += lit_len;
+    if (match_len == 0) return true;
+
+    if (oend - op < 2) return false;
+    *op++ = static_cast<uint8_t>(offset);
+    *op++ = static_cast<uint8_t>(offset >> 8);
+    size_t m = match_len - LZ_MIN_MATCH;
+    *token |= static_cast<uint8_t>(m >= 15 ? 15 : m);
+    if (m >= 15 && !put_length(op, oend, m - 15)) return false;
+    return true;
+}
+
+size_t lz_compress(const uint8_t* src, size_t n, uint8_t* dst, size_t capacity) {
+    uint32_t table[1 << LZ_HASH_BITS];
+    memset(table, 0, sizeof(table));
+    uint8_t* op = dst;
+    const uint8_t* oend = dst + capacity;
+    size_t anchor = 0;
+
+    if (n > LZ_MF_LIMIT) {
+        size_t limit = n - LZ_MF_LIMIT;
+        size_t match_limit = n - LZ_LAST_LITERALS;
+        size_t ip = 0;
+        unsigned misses = 0;
+        while (ip < limit) {
+            uint32_t v = read32(src + ip);
+            uint32_t h = lz_hash(v);
+            size_t ref = table[h];
+            table[h] = static_cast<uint32_t>(ip);
+            if (ref >= ip || ip - ref > LZ_MAX_OFFSET || read32(src + ref) != v) {
+                ip += 1 + (misses++ >> 5);     // 안 맞는 구간은 점점 건너뛴다 (이미 압축된 데이터 등)
+                continue;
+            }
+            misses = 0;
+            size_t len = LZ_MIN_MATCH;
+            while (ip + len < match_limit && src[ref + len] == src[ip + len]) {
+                len++;
+            }
+            if (!emit_sequence(op, oend, src + anchor, ip - anchor, ip - ref, len)) {
+                return 0;
+            }
+            ip += len;
+            anchor = ip;
+            if (ip < limit) {
+                table[lz_hash(read32(src + ip - 2))] = static_cast<uint32_t>(ip - 2);
+            }
+        }
+    }
+    if (!emit_sequence(op, oend, src + anchor, n - anchor, 0, 0)) {
+        return 0;
+    }
+    return static_cast<size_t>(op - dst);
+}
+
+bool lz_decompress(const uint8_t* src, size_t n, uint8_t* dst, size_t raw_size) {
+    const uint8_t* ip = src;
+    const uint8_t* iend = src + n;
+    uint8_t* op = dst;
+    uint8_t* oend = dst + raw_size;
+
+    while (ip < iend) {
+        unsigned token = *ip++;
+        size_t lit = token >> 4;
+        if (lit == 15 && !get_length(ip, iend, lit)) return false;
+        if (lit > static_cast<size_t>(iend - ip) || lit > static_cast<size_t>(oend - op)) return false;
+        memcpy(op, ip, lit);
+        ip += lit;
+        op += lit;
+        if (ip == iend) break;      // 마지막 sequence (literal 만)
+
+        if (iend - ip < 2) return false;
+        size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+        ip += 2;
+        if (offset == 0 || offset > static_cast<size_t>(op - dst)) return false;
+        size_t len = token & 15;
+        if (len == 15 && !get_length(ip, iend, len)) return false;
+        len += LZ_MIN_MATCH;
+        if (len > static_cast<size_t>(oend - op)) return false;
+
+        const uint8_t* m = op - offset;
+        if (offset >= len) {
+            memcpy(op, m, len);
+        } else {
+            for (size_t i = 0; i < len; ++i) op[i] = m[i];     // 겹치는 match (반복 패턴)
+        }
+        op += len;
+    }
+    return op == oend;
+}
+
+} // namespace
+
+const char* block_codec_name(uint32_t codec) {
+    switch (codec) {
+        case BLOCK_CODEC_NONE:    return "none";
+        case BLOCK_CODEC_LZ:      return "lz";
+        case BLOCK_CODEC_DEFLATE: return "deflate";
+        default:                  return "unknown";
+    }
+}
+
+bool block_codec_from_name(const std::string& name, BlockCodec& codec) {
+    if (name.empty() || name == "none") {
+        codec = BLOCK_CODEC_NONE;
+    } else if (name == "lz" || name == "lz4") {
+        codec = BLOCK_CODEC_LZ;
+    } else if (name == "deflate" || name == "zlib") {
+        codec = BLOCK_CODEC_DEFLATE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool block_codec_available(uint32_t codec) {
+    switch (codec) {
+        case BLOCK_CODEC_NONE:
+        case BLOCK_CODEC_LZ:
+            return true;
+        case BLOCK_CODEC_DEFLATE:
+#ifdef HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+size_t block_compress_bound(size_t raw_size) {
+    return raw_size + raw_size / 255 + 64;
+}
+
+size_t block_compress(uint32_t codec, const void* src, size_t size, void* dst, size_t capacity) {
+    size_t out = 0;
+    switch (codec) {
+        case BLOCK_CODEC_LZ:
+            out = lz_compress(static_cast<const uint8_t*>(src), size, static_cast<uint8_t*>(dst), capacity);
+            break;
+#ifdef HAVE_ZLIB
+        case BLOCK_CODEC_DEFLATE: {
+            uLongf len = static_cast<uLongf>(capacity);
+            if (compress2(static_cast<Bytef*>(dst), &len, static_cast<const Bytef*>(src),
+                          static_cast<uLong>(size), Z_BEST_SPEED) == Z_OK) {
+                out = len;
+            }
+            break;
+        }
+#endif
+        default:
+            return 0;
+    }
+    return out < size ? out : 0;
+}
+
+bool block_decompress(uint32_t codec, const void* src, size_t size, void* dst, size_t raw_size) {
+    switch (codec) {
+        case BLOCK_CODEC_NONE:
+            if (size != raw_size) return false;
+            memcpy(dst, src, size);
+            return true;
+        case BLOCK_CODEC_LZ:
+            return lz_decompress(static_cast<const uint8_t*>(src), size, static_cast<uint8_t*>(dst), raw_size);
+#ifdef HAVE_ZLIB
+        case BLOCK_CODEC_DEFLATE: {
+            uLongf len = static_cast<uLongf>(raw_size);
+            return uncompress(static_cast<Bytef*>(dst), &len, static_cast<const Bytef*>(src),
+                              static_cast<uLong>(size)) == Z_OK && len == raw_size;
+        }
+#endif
+        default:
+            return false;
+    }
+}
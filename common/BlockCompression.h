@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/**
+ * Block compression - DB_SAM 데이터 block / TCP 복구 batch 압축
+ *
+ * 실시간 경로는 압축하지 않는다. 수십~수백 개 메시지를 모은 block 단위로만 쓴다.
+ *  - BLOCK_CODEC_LZ      : LZ4 block 형식 호환 (자체 구현, 외부 라이브러리 없음) - 빠르고 압축률 보통
+ *  - BLOCK_CODEC_DEFLATE : zlib deflate (HAVE_ZLIB 빌드에서만) - 느리지만 압축률이 높다
+ *
+ * block_compress() 가 0 을 반환하면 (압축해도 줄지 않음 / 지원 안함) 호출 측이 원본을 BLOCK_CODEC_NONE 으로 저장한다.
+ */
+enum BlockCodec {
+    BLOCK_CODEC_NONE = 0,
+    BLOCK_CODEC_LZ = 1,
+    BLOCK_CODEC_DEFLATE = 2
+};
+
+const char* block_codec_name(uint32_t codec);
+/* "none" / "lz" ("lz4") / "deflate" ("zlib") -> codec, 모르는 이름이면 false */
+bool block_codec_from_name(const std::string& name, BlockCodec& codec);
+/* 이 빌드에서 압축/해제 가능한 codec 인지 (NONE 은 항상 true) */
+bool block_codec_available(uint32_t codec);
+
+/* raw_size 바이트를 어떤 codec 으로 압축해도 넘지 않는 크기 */
+size_t block_compress_bound(size_t raw_size);
+/* src 를 dst 에 압축, 압축 크기 반환 (0: 실패 또는 원본보다 작지 않음) */
+size_t block_compress(uint32_t codec, const void* src, size_t size, void* dst, size_t capacity);
+/* 압축 해제, 정확히 raw_size 바이트가 나와야 true (깨진 입력은 false) */
+bool block_decompress(uint32_t codec, const void* src, size_t size, void* dst, size_t raw_size);
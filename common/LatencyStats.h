@@ -0,0 +1,89 @@
+#pragma once
+
+#include "StatsRegistry.h"
+#include <cstdint>
+#include <string>
+#include <time.h>
+
+namespace SimplePubSub {
+
+/**
+ * 지연 측정용 시각 / 단계 히스토그램
+ *
+ * 같은 프로세스 안의 단계 구간은 CLOCK_MONOTONIC (vDSO, syscall 없음) 으로 잰다.
+ * CLOCK_MONOTONIC_RAW 는 3.x 커널에서 vDSO 가 없어 매 호출 syscall 이고, rdtsc 는 코어별 보정이
+ * 필요해서 쓰지 않는다. 프로세스 간 one-way 지연은 TopicMessage::timestamp 와 같은
+ * get_current_timestamp() (wall clock) 로 잰다.
+ *
+ * 히스토그램은 StatsHistogram (ns 단위) 이고 이름은 "latency." 로 시작해서
+ * StatsRegistry::snapshot("latency.") 로 따로 dump / reset 할 수 있다.
+ */
+
+inline uint64_t latency_now_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000000ull + static_cast<uint64_t>(ts.tv_nsec);
+}
+
+static const char* const LATENCY_STATS_PREFIX = "latency.";
+
+// 구간 측정: 생성 시각부터 소멸까지를 histogram 에 기록 (histogram 이 nullptr 이면 시각도 읽지 않음)
+class LatencyScope {
+public:
+    explicit LatencyScope(StatsHistogram* histogram)
+        : _histogram(histogram), _start(histogram ? latency_now_ns() : 0) {}
+    ~LatencyScope() {
+        if (_histogram) _histogram->record(latency_now_ns() - _start);
+    }
+
+    LatencyScope(const LatencyScope&) = delete;
+    LatencyScope& operator=(const LatencyScope&) = delete;
+
+private:
+    StatsHistogram* _histogram;
+    uint64_t _start;
+};
+
+// T2MA 처리 파이프라인 단계 (source drain -> handler -> parse -> master update -> publish)
+struct PipelineLatency {
+    StatsHistogram queue{"latency.t2ma.queue"};                 // source drain 완료 ~ 메시지 handler 시작
+    StatsHistogram parse{"latency.t2ma.parse"};                 // TREP 파싱
+    StatsHistogram master_update{"latency.t2ma.master_update"}; // 마스터 갱신 (파생 시세 publish 포함)
+    StatsHistogram publish{"latency.t2ma.publish"};             // publisher_->publish() 호출
+    StatsHistogram total{"latency.t2ma.total"};                 // source drain 완료 ~ handler 끝
+};
+
+// publisher publish_batch 단계
+struct PublisherLatency {
+    StatsHistogram db_put{"latency.publisher.db_put"};             // MessageDB put_batch
+    StatsHistogram sequence_save{"latency.publisher.sequence_save"};
+    StatsHistogram fan_out{"latency.publisher.fan_out"};           // shm / multicast / reactor / main 클라이언트 전송
+    StatsHistogram batch{"latency.publisher.batch"};               // publish_batch 전체
+};
+
+// 구독자 one-way 지연 (수신 시각 - publisher 가 찍은 TopicMessage::timestamp), 토픽별
+struct SubscriberLatency {
+    StatsHistogram topic1{"latency.subscriber.topic1"};
+    StatsHistogram topic2{"latency.subscriber.topic2"};
+    StatsHistogram misc{"latency.subscriber.misc"};
+
+    // index: SimpleSubscriber::topic_index (0: TOPIC1, 1: TOPIC2, 2: MISC)
+    void record(int index, uint64_t now_ns, uint64_t sent_ns) {
+        uint64_t d = now_ns > sent_ns ? now_ns - sent_ns : 0;   // 호스트 간 시계 차이로 음수면 0
+        switch (index) {
+            case 0: topic1.record(d); break;
+            case 1: topic2.record(d); break;
+            case 2: misc.record(d); break;
+            default: break;
+        }
+    }
+};
+
+// 이름이 "latency." 인 히스토그램 출력, reset 이면 출력 후 0 으로 (주기 dump 를 구간별 분포로)
+inline std::string dump_latency_stats(bool reset) {
+    StatsSnapshot snap = StatsRegistry::instance().snapshot(LATENCY_STATS_PREFIX);
+    if (reset) StatsRegistry::instance().reset(LATENCY_STATS_PREFIX);
+    return snap.to_string();
+}
+
+} // namespace SimplePubSub
@@ -1,12 +1,21 @@
 #pragma once
 
 #include "../pubsub/Common.h"
+#include "LatencyStats.h"
 #include <functional>
 #include <string>
 #include <atomic>
+#include <thread>
 
 namespace SimplePubSub {
 
+// drain 한번에 받은 메시지 (버퍼는 다음 drain 전까지 유효)
+struct MQMessage {
+    const char* data;
+    size_t size;
+    unsigned int priority;
+};
+
 // POSIX Message Queue Reader with libevent integration
 class MQReader {
 private:
@@ -21,6 +30,7 @@ private:
     // Message processing
     std::function<void(const char* data, size_t size)> data_callback_;
     std::function<void(DataTopic topic, const char* data, size_t size)> topic_callback_;
+    std::function<void(const MQMessage* messages, size_t count)> batch_callback_;
     
     // Configuration
     size_t max_msg_size_;
@@ -28,16 +38,32 @@ private:
     
     // State
     std::atomic<bool> running_{false};
-    std::atomic<uint64_t> messages_received_{0};
+    StatsCounter messages_received_{"mq.messages_received"};
+    
+    StatsCounter drain_count_{"mq.drains"};             // 메시지를 1개 이상 받은 drain 횟수
+    StatsHistogram drain_batch_{"mq.drain_batch"};      // drain 한번에 받은 메시지 수
+    uint64_t last_drain_ns_ = 0;                        // 마지막 drain 완료 시각 (latency_now_ns, 콜백 스레드에서 읽음)
     
-    // Message buffer
+    // Message buffer (batch_size_ 개의 slot, slot 크기 max_msg_size_)
     char* message_buffer_;
+    size_t batch_size_;
+    MQMessage* batch_;
+    
+    // busy-poll 전용 스레드
+    std::thread poll_thread_;
+    int poll_cpu_;
+    long poll_timeout_us_;
     
     // libevent callback (static)
     static void mq_read_callback(evutil_socket_t fd, short events, void* user_data);
     
     // Internal methods
     void process_mq_message();
+    size_t drain(bool timed);
+    void dispatch(size_t count);
+    void poll_loop();
+    bool allocate_buffers();
+    void free_buffers();
     DataTopic classify_mq_data(const char* data, size_t size);
     void cleanup();
     
@@ -54,14 +80,28 @@ public:
     // Callback configuration
     void set_data_callback(std::function<void(const char*, size_t)> callback);
     void set_topic_callback(std::function<void(DataTopic, const char*, size_t)> callback);
+    // 설정되면 drain 한번에 받은 메시지를 묶어서 한번 호출 (data/topic 콜백 대신)
+    void set_batch_callback(std::function<void(const MQMessage*, size_t)> callback);
+    
+    // wakeup 한번에 최대 n 개까지 (EAGAIN 이 날 때까지) 읽는다. 기본 1 (기존 동작)
+    // open_mq/create_mq 전후 어느 때나 가능, start() 이후에는 변경 불가
+    bool set_batch_size(size_t n);
+    size_t get_batch_size() const { return batch_size_; }
     
     // Control
     void start();
+    // libevent 대신 전용 스레드에서 mq_timedreceive 로 수신 (cpu >= 0 이면 해당 코어에 고정)
+    // timeout_us == 0 이면 non-blocking spin. 콜백은 poll 스레드에서 호출된다.
+    void start_poll_thread(int cpu = -1, long timeout_us = 0);
+    // start() 모드에서 event loop 스레드가 직접 non-blocking drain (spin loop 용), 처리한 메시지 수 반환
+    size_t poll();
     void stop();
     bool is_running() const { return running_.load(); }
     
     // Statistics
-    uint64_t get_messages_received() const { return messages_received_.load(); }
+    uint64_t get_messages_received() const { return messages_received_.value(); }
+    uint64_t get_drain_count() const { return drain_count_.value(); }
+    uint64_t get_last_drain_ns() const { return last_drain_ns_; }
     const std::string& get_mq_name() const { return mq_name_; }
     size_t get_max_msg_size() const { return max_msg_size_; }
     long get_max_msg_count() const { return max_msg_count_; }
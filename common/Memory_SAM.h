@@ -2,7 +2,7 @@
 #define MEMORY_SAM_H
 
 #include "MessageDB.h"
-#include <map>
+#include <deque>
 #include <mutex>
 #include <cstdlib>
 #include <cstring>
@@ -14,13 +14,40 @@
  * MessageDB 인터페이스를 구현한 인메모리 데이터베이스.
  * 빠른 읽기/쓰기 성능을 제공하지만 데이터 영속성이 없습니다.
  * 테스트, 캐싱, 임시 데이터 저장 용도로 사용됩니다.
+ *
+ * 저장 구조:
+ *  - 메시지 본문은 큰 arena chunk(기본 16MB)에 순서대로 이어 붙인다. (메시지별 malloc 없음)
+ *  - 인덱스는 sequence 순으로 쌓이는 dense deque (seq - first_seq 로 O(1) 접근)
+ *  - max_bytes > 0 이면 ring 모드: chunk 총량이 상한을 넘으면 가장 오래된 chunk와
+ *    그 안의 메시지들을 통째로 evict 하고 chunk를 재사용한다.
+ *
+ * ring 모드에서는 evict 시 메모리가 재사용되므로 get_direct()는 nullptr를 반환한다.
  */
 class Memory_SAM : public MessageDB {
+public:
+    static constexpr size_t DEFAULT_CHUNK_SIZE = 16 * 1024 * 1024;
+
 private:
-    // 메시지 데이터 저장소
-    std::map<uint32_t, void*> _data_map;
-    // 인덱스 정보 저장소
-    std::map<uint32_t, SAM_INDEX> _index_map;
+    struct Chunk {
+        char* mem;
+        size_t capacity;
+        size_t used;
+        uint32_t last_seq;      // 이 chunk에 저장된 마지막 sequence
+    };
+
+    struct Entry {
+        SAM_INDEX index;
+        const char* data;
+    };
+
+    size_t _chunk_size;
+    size_t _max_bytes;              // 0이면 무제한
+    size_t _allocated_bytes;        // 보유 중인 chunk 총량
+    std::deque<Chunk> _chunks;      // 오래된 순
+    std::deque<Chunk> _spare;       // evict 후 재사용 대기 chunk
+    std::deque<Entry> _entries;     // dense index, _entries[0] 은 _first_seq
+    uint32_t _first_seq;
+    int64_t _data_bytes;            // 보유 중인 메시지 본문 총량
 
     mutable std::mutex _mutex;
     bool _is_open;
@@ -33,8 +60,114 @@ private:
         return static_cast<uint64_t>(nanos.count());
     }
 
+    bool ring_mode() const { return _max_bytes > 0; }
+
+    const Entry* find_entry(uint32_t seq) const {
+        if (_entries.empty() || seq < _first_seq) return nullptr;
+        size_t pos = seq - _first_seq;
+        if (pos >= _entries.size()) return nullptr;
+        return &_entries[pos];
+    }
+
+    // 가장 오래된 chunk 와 그 안의 메시지 제거
+    void evict_oldest_chunk() {
+        Chunk oldest = _chunks.front();
+        _chunks.pop_front();
+        while (!_entries.empty() && _first_seq <= oldest.last_seq) {
+            _data_bytes -= _entries.front().index._size;
+            _entries.pop_front();
+            _first_seq++;
+        }
+        if (oldest.capacity == _chunk_size) {
+            oldest.used = 0;
+            _spare.push_back(oldest);
+        } else {
+            free(oldest.mem);
+            _allocated_bytes -= oldest.capacity;
+        }
+    }
+
+    void free_chunks(std::deque<Chunk>& chunks) {
+        for (auto& c : chunks) free(c.mem);
+        chunks.clear();
+    }
+
+    // size 바이트를 저장할 공간 확보
+    char* reserve(size_t size) {
+        if (!_chunks.empty()) {
+            Chunk& cur = _chunks.back();
+            if (cur.capacity - cur.used >= size) {
+                char* p = cur.mem + cur.used;
+                cur.used += size;
+                return p;
+            }
+        }
+
+        size_t capacity = size > _chunk_size ? size : _chunk_size;
+        if (ring_mode()) {
+            if (capacity > _max_bytes) return nullptr;
+            if (capacity == _chunk_size) {
+                // 상한을 넘으면 오래된 chunk부터 evict (재사용 가능한 chunk가 생길 때까지)
+                while (_spare.empty() && !_chunks.empty() &&
+                       _allocated_bytes + capacity > _max_bytes) {
+                    evict_oldest_chunk();
+                }
+            } else {
+                // 큰 메시지용 chunk는 새로 할당해야 하므로 재사용 chunk까지 반납
+                while (_allocated_bytes + capacity > _max_bytes) {
+                    if (!_spare.empty()) {
+                        free(_spare.front().mem);
+                        _allocated_bytes -= _spare.front().capacity;
+                        _spare.pop_front();
+                    } else if (!_chunks.empty()) {
+                        evict_oldest_chunk();
+                    } else {
+                        break;
+                    }
+                }
+            }
+        }
+
+        Chunk c;
+        if (capacity == _chunk_size && !_spare.empty()) {
+            c = _spare.front();
+            _spare.pop_front();
+        } else {
+            c.mem = static_cast<char*>(malloc(capacity));
+            if (!c.mem) return nullptr;
+            c.capacity = capacity;
+            _allocated_bytes += capacity;
+        }
+        c.used = size;
+        c.last_seq = 0;
+        _chunks.push_back(c);
+        return c.mem;
+    }
+
+    bool put_locked(const void* data, size_t size, uint64_t timestamp) {
+        if (!data || size == 0) return false;
+
+        char* p = reserve(size);
+        if (!p) return false;
+        memcpy(p, data, size);
+
+        uint32_t seq = _next_sequence++;
+        if (_entries.empty()) _first_seq = seq;
+        _chunks.back().last_seq = seq;
+        _entries.push_back(Entry{SAM_INDEX{0, static_cast<uint32_t>(size), seq, timestamp}, p});
+        _data_bytes += size;
+        return true;
+    }
+
 public:
-    Memory_SAM() : _is_open(false), _next_sequence(1) {}
+    /**
+     * @param chunk_size arena chunk 크기
+     * @param max_bytes  0 이면 무제한, 0보다 크면 ring 모드 메모리 상한 (chunk 단위로 evict)
+     *                   chunk_size 가 상한보다 크면 chunk 하나도 만들 수 없으므로 chunk_size 를 max_bytes 로 줄인다
+     */
+    explicit Memory_SAM(size_t chunk_size = DEFAULT_CHUNK_SIZE, size_t max_bytes = 0)
+        : _chunk_size(max_bytes > 0 && chunk_size > max_bytes ? max_bytes : chunk_size), _max_bytes(max_bytes),
+          _allocated_bytes(0), _first_seq(1), _data_bytes(0), _is_open(false), _next_sequence(1) {}
 
     ~Memory_SAM() override {
         close();
@@ -50,12 +183,12 @@ public:
     void close() override {
         std::lock_guard<std::mutex> lock(_mutex);
         if (_is_open) {
-            // 모든 동적 할당된 메모리 해제
-            for (auto& pair : _data_map) {
-                free(pair.second);
-            }
-            _data_map.clear();
-            _index_map.clear();
+            // chunk 단위로 해제 (메시지 수와 무관)
+            free_chunks(_chunks);
+            free_chunks(_spare);
+            _entries.clear();
+            _allocated_bytes = 0;
+            _data_bytes = 0;
             _is_open = false;
         }
     }
@@ -71,28 +204,18 @@ public:
     }
 
     bool put(const void* data, size_t size, uint64_t timestamp) override {
-        if (!data || size == 0) return false;
-
         std::lock_guard<std::mutex> lock(_mutex);
         if (!_is_open) return false;
+        return put_locked(data, size, timestamp);
+    }
 
-        uint32_t seq = _next_sequence++;
-
-        // 데이터 복사본 생성
-        void* data_copy = malloc(size);
-        if (!data_copy) return false;
-
-        memcpy(data_copy, data, size);
-
-        // 데이터와 인덱스 저장
-        _data_map[seq] = data_copy;
-        _index_map[seq] = SAM_INDEX{
-            0,  // seek는 메모리에서는 의미 없음
-            static_cast<uint32_t>(size),
-            seq,
-            timestamp
-        };
+    bool put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_is_open) return false;
 
+        for (size_t i = 0; i < count; ++i) {
+            if (!put_locked(items[i].data, items[i].size, timestamp)) return false;
+        }
         return true;
     }
 
@@ -103,13 +226,10 @@ public:
         std::lock_guard<std::mutex> lock(_mutex);
         if (!_is_open) return false;
 
-        auto index_it = _index_map.find(seq);
-        if (index_it == _index_map.end()) return false;
+        const Entry* e = find_entry(seq);
+        if (!e) return false;
 
-        auto data_it = _data_map.find(seq);
-        if (data_it == _data_map.end()) return false;
-
-        index = index_it->second;
+        index = e->index;
 
         // 버퍼가 충분한지 확인
         if (*buffer_size < index._size) {
@@ -118,23 +238,43 @@ public:
         }
 
         // 데이터 복사
-        memcpy(buffer, data_it->second, index._size);
+        memcpy(buffer, e->data, index._size);
         *buffer_size = index._size;
 
         return true;
     }
 
-    bool get(uint32_t seq, std::string& data) const override {
+    // 무제한 모드에서는 chunk가 close() 전까지 해제되지 않으므로 포인터를 그대로 반환
+    bool get_index(uint32_t seq, SAM_INDEX& index) const override {
         std::lock_guard<std::mutex> lock(_mutex);
         if (!_is_open) return false;
 
-        auto data_it = _data_map.find(seq);
-        if (data_it == _data_map.end()) return false;
+        const Entry* e = find_entry(seq);
+        if (!e) return false;
+
+        index = e->index;
+        return true;
+    }
+
+    const void* get_direct(uint32_t seq, SAM_INDEX& index) const override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_is_open || ring_mode()) return nullptr;
+
+        const Entry* e = find_entry(seq);
+        if (!e) return nullptr;
+
+        index = e->index;
+        return e->data;
+    }
+
+    bool get(uint32_t seq, std::string& data) const override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        if (!_is_open) return false;
 
-        auto index_it = _index_map.find(seq);
-        if (index_it == _index_map.end()) return false;
+        const Entry* e = find_entry(seq);
+        if (!e) return false;
 
-        data = std::string(static_cast<char*>(data_it->second), index_it->second._size);
+        data.assign(e->data, e->index._size);
         return true;
     }
 
@@ -146,12 +286,18 @@ public:
 
     uint32_t count() const override {
         std::lock_guard<std::mutex> lock(_mutex);
-        return static_cast<uint32_t>(_data_map.size());
+        return static_cast<uint32_t>(_entries.size());
     }
 
     uint32_t max_seq() const override {
         std::lock_guard<std::mutex> lock(_mutex);
-        return _index_map.empty() ? 0 : _index_map.rbegin()->first;
+        return _entries.empty() ? 0 : _entries.back().index._seq;
+    }
+
+    // ring 모드에서 아직 보유 중인 가장 오래된 sequence (비어있으면 0)
+    uint32_t min_seq() const override {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _entries.empty() ? 0 : _first_seq;
     }
 
     // 범위 연산 구현
@@ -161,19 +307,19 @@ public:
 
         std::lock_guard<std::mutex> lock(_mutex);
         if (!_is_open) return false;
+        if (_entries.empty()) return true;
+        if (start_seq < _first_seq) {
+            if (_first_seq > 1) return false;   // evict 된 구간 (min_seq 부터 다시 요청)
+            start_seq = _first_seq;
+        }
 
-        auto start_it = _index_map.lower_bound(start_seq);
-        auto end_it = _index_map.upper_bound(end_seq);
-
-        for (auto it = start_it; it != end_it; ++it) {
-            uint32_t seq = it->first;
-            const SAM_INDEX& index = it->second;
-
-            auto data_it = _data_map.find(seq);
-            if (data_it == _data_map.end()) continue;
+        uint32_t last_seq = _entries.back().index._seq;
+        if (end_seq > last_seq) end_seq = last_seq;
 
+        for (uint32_t seq = start_seq; seq <= end_seq; ++seq) {
+            const Entry& e = _entries[seq - _first_seq];
             // 콜백 호출, false를 반환하면 중단
-            if (!callback(seq, index, data_it->second, index._size)) {
+            if (!callback(seq, e.index, e.data, e.index._size)) {
                 break;
             }
         }
@@ -185,19 +331,14 @@ public:
     bool verify_integrity() const override {
         std::lock_guard<std::mutex> lock(_mutex);
 
-        // 데이터와 인덱스의 일관성 검사
-        if (_data_map.size() != _index_map.size()) {
-            return false;
-        }
-
-        for (const auto& index_pair : _index_map) {
-            uint32_t seq = index_pair.first;
-            if (_data_map.find(seq) == _data_map.end()) {
+        // 인덱스가 연속된 sequence 인지 검사
+        uint32_t expected = _first_seq;
+        for (const auto& e : _entries) {
+            if (e.index._seq != expected++) {
                 return false;
             }
         }
-
-        return true;
+        return _entries.empty() || _entries.back().index._seq + 1 == _next_sequence;
     }
 
     bool compact() override {
@@ -208,17 +349,19 @@ public:
     // 메모리 사용량 정보 (바이트 단위)
     int64_t get_data_file_size() const override {
         std::lock_guard<std::mutex> lock(_mutex);
-        int64_t total_size = 0;
-        for (const auto& index_pair : _index_map) {
-            total_size += index_pair.second._size;
-        }
-        return total_size;
+        return _data_bytes;
     }
 
     int64_t get_index_file_size() const override {
         std::lock_guard<std::mutex> lock(_mutex);
-        return static_cast<int64_t>(_index_map.size() * sizeof(SAM_INDEX));
+        return static_cast<int64_t>(_entries.size() * sizeof(SAM_INDEX));
+    }
+
+    // arena chunk 로 할당된 총 메모리 (ring 모드 상한 비교용)
+    size_t get_allocated_bytes() const {
+        std::lock_guard<std::mutex> lock(_mutex);
+        return _allocated_bytes;
     }
 };
 
-#endif // MEMORY_SAM_H
\ No newline at end of file
+#endif // MEMORY_SAM_H
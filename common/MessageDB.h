@@ -18,6 +18,29 @@ struct SAM_INDEX {
     uint64_t _timestamp;   // 저장 시간 (nanoseconds)
 };
 
+// MessageDB 구현체 종류 (설정에서 선택)
+enum class MessageDBType {
+    MEMORY,     // Memory_SAM
+    FILE,       // DB_SAM (fstream)
+    MMAP,       // MMAP_SAM (mmap append-only)
+    SEGMENTED   // SEGMENT_SAM (날짜 / 크기별 segment 파일, 보존 기간 지난 segment 삭제)
+};
+
+// 일괄 저장(put_batch)용 메시지 조각
+struct MessageSlice {
+    const void* data;
+    size_t size;
+};
+
+// get_data_region 결과 - 데이터 파일 내 연속 구간
+struct MessageDataRegion {
+    std::string path;       // 데이터 파일 경로
+    int64_t offset;         // 시작 위치
+    int64_t length;         // 길이 (bytes)
+    uint32_t start_seq;     // 구간에 포함된 첫 sequence
+    uint32_t end_seq;       // 구간에 포함된 마지막 sequence
+};
+
 /**
  * MessageDB - 메시지 데이터베이스 추상 기본 클래스
  *
@@ -38,21 +61,79 @@ public:
     virtual bool put(const void* data, size_t size) = 0;
     virtual bool put(const void* data, size_t size, uint64_t timestamp) = 0;
 
+    // 일괄 저장 - 연속된 시퀀스로 저장 (기본 구현은 put 반복, 구현체에서 한번에 기록하도록 재정의)
+    virtual bool put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!put(items[i].data, items[i].size, timestamp)) return false;
+        }
+        return true;
+    }
+
     // 메시지 검색
     virtual bool get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_size) const = 0;
     virtual bool get(uint32_t seq, std::string& data) const = 0;
 
+    // 인덱스만 조회 (본문은 읽지 않음, 지원하지 않으면 false) - seek_time 이분 탐색용
+    virtual bool get_index(uint32_t seq, SAM_INDEX& index) const { return false; }
+
+    // zero-copy 검색 - DB 내부 메모리를 직접 가리키는 포인터 반환 (지원하지 않으면 nullptr)
+    // 반환된 포인터는 close() 전까지 유효하다.
+    virtual const void* get_direct(uint32_t seq, SAM_INDEX& index) const { return nullptr; }
+
+    // [start_seq, end_seq] 메시지들이 데이터 파일에 연속 저장되어 있는 경우 그 파일 구간 반환
+    // (recovery에서 sendfile/evbuffer_add_file 용, 버퍼링된 데이터는 먼저 flush 한다)
+    virtual bool get_data_region(uint32_t start_seq, uint32_t end_seq, MessageDataRegion& region) const {
+        return false;  // 기본적으로 지원하지 않음
+    }
+
     // 메타데이터
     virtual uint32_t get_next_sequence() const = 0;
     virtual uint32_t count() const = 0;
     virtual uint32_t max_seq() const = 0;
+    // 아직 읽을 수 있는 가장 오래된 sequence (비어있으면 0) - ring / 보존 기간으로 앞을 지우는 구현체만 1 보다 크다
+    virtual uint32_t min_seq() const { return max_seq() > 0 ? 1 : 0; }
+    // 파일에 기록이 끝나 프로세스가 죽어도 남는 마지막 sequence (버퍼에 모아 쓰는 구현체만 max_seq 보다 작다)
+    virtual uint32_t durable_max_seq() const { return max_seq(); }
+    // 오래 버퍼에 머문 쓰기를 기록 - 메시지가 끊겨도 유실 구간이 늘지 않도록 주기적으로 호출 (기본: 할 일 없음)
+    virtual bool flush_if_stale() { return true; }
 
     // 범위 연산 (선택사항 - 기본 구현은 false 반환)
+    // start_seq 가 min_seq 보다 앞 (이미 지운 구간) 이면 false - 호출한 쪽이 min_seq 로 옮겨 다시 요청한다
     virtual bool get_range(uint32_t start_seq, uint32_t end_seq,
                           std::function<bool(uint32_t seq, const SAM_INDEX& index, const void* data, size_t size)> callback) const {
         return false;  // 기본적으로 지원하지 않음
     }
 
+    // 시간 검색 - _timestamp 가 timestamp 이상인 첫 sequence (없으면 0)
+    // timestamp 는 put 순서대로 증가한다고 보고 get_index 로 [1, max_seq] 를 이분 탐색한다.
+    // 조회되지 않는 seq (보존 기간이 지나 지운 구간 등) 는 앞쪽으로 취급한다.
+    virtual uint32_t seek_time(uint64_t timestamp) const {
+        uint32_t lo = 1, hi = max_seq() + 1;    // 답은 [lo, hi], hi 는 "없음"
+        uint32_t end = hi;
+        while (lo < hi) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            SAM_INDEX index;
+            if (get_index(mid, index) && index._timestamp >= timestamp) {
+                hi = mid;
+            } else {
+                lo = mid + 1;
+            }
+        }
+        return lo < end ? lo : 0;
+    }
+
+    // [start_ts, end_ts] 시간 구간 메시지 (seek_time 으로 시작 seq 를 찾고 get_range 로 읽다가 end_ts 를 넘으면 멈춤)
+    virtual bool get_by_time_range(uint64_t start_ts, uint64_t end_ts,
+                                   std::function<bool(uint32_t seq, const SAM_INDEX& index, const void* data, size_t size)> callback) const {
+        uint32_t start_seq = seek_time(start_ts);
+        if (start_seq == 0 || start_ts > end_ts) {
+            return start_ts <= end_ts;
+        }
+        return get_range(start_seq, max_seq(), [&](uint32_t seq, const SAM_INDEX& index, const void* data, size_t size) {
+            return index._timestamp <= end_ts && callback(seq, index, data, size);
+        });
+    }
+
     // 유틸리티 메서드들 (기본 구현 제공)
     virtual bool verify_integrity() const { return true; }
     virtual bool compact() { return true; }
@@ -0,0 +1,230 @@
+#pragma once
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+
+/**
+ * NUMA 배치 helper (header-only, libnuma 없이 syscall 직접 사용)
+ *
+ * T2MA 는 한 인스턴스를 한 node 에 둔다 (system.numa_node). 시작 시 main 스레드를 그 node 의
+ * CPU 에 묶고 preferred memory policy 를 걸면 이후 만드는 스레드 (worker / reactor / recovery /
+ * reader) 와 그 스레드가 처음 만지는 page (마스터 page cache, message DB, ring, pool) 가 모두
+ * 같은 node 에 잡힌다. 스레드별 단일 CPU 고정 (spin_cpu, *_cpus) 은 그 위에 덮어쓴다.
+ *
+ * - cpu list 는 sysfs 형식 ("0-3,8,10-11")
+ * - bind_memory 는 이미 잡힌 page 도 옮긴다 (MPOL_MF_MOVE). 공유 page 는 못 옮길 수 있음
+ * - shm / tmpfs 매핑은 mbind 정책이 파일 자신에 남는다. 일반 파일 page cache 는 처음 읽은
+ *   스레드의 정책을 따르므로 적재 스레드에 ScopedPreferredNode 를 건다
+ * - node 가 하나 뿐이거나 커널이 NUMA 를 모르면 호출은 실패만 하고 동작에는 영향 없다
+ */
+
+#ifndef MPOL_DEFAULT
+#define MPOL_DEFAULT 0
+#endif
+#ifndef MPOL_PREFERRED
+#define MPOL_PREFERRED 1
+#endif
+#ifndef MPOL_BIND
+#define MPOL_BIND 2
+#endif
+#ifndef MPOL_F_NODE
+#define MPOL_F_NODE (1 << 0)
+#endif
+#ifndef MPOL_F_ADDR
+#define MPOL_F_ADDR (1 << 1)
+#endif
+#ifndef MPOL_MF_MOVE
+#define MPOL_MF_MOVE (1 << 1)
+#endif
+
+namespace NumaPlacement {
+
+static const int MAX_NODES = 1024;       // nodemask bit 수
+
+// "0-3,8" -> cpu_set_t. 형식이 틀리면 false
+inline bool parse_cpu_list(const std::string& list, cpu_set_t& cpus) {
+    CPU_ZERO(&cpus);
+    std::stringstream ss(list);
+    std::string item;
+    bool any = false;
+    while (std::getline(ss, item, ',')) {
+        size_t b = item.find_first_not_of(" \t\n");
+        size_t e = item.find_last_not_of(" \t\n");
+        if (b == std::string::npos) continue;
+        item = item.substr(b, e - b + 1);
+        char* end = nullptr;
+        long lo = strtol(item.c_str(), &end, 10);
+        long hi = lo;
+        if (end == item.c_str()) return false;
+        if (*end == '-') {
+            const char* p = end + 1;
+            hi = strtol(p, &end, 10);
+            if (end == p) return false;
+        }
+        if (*end != 0 || lo < 0 || hi < lo || hi >= CPU_SETSIZE) return false;
+        for (long c = lo; c <= hi; c++) CPU_SET(static_cast<int>(c), &cpus);
+        any = true;
+    }
+    return any;
+}
+
+// cpu_set_t -> "0-3,8"
+inline std::string format_cpu_list(const cpu_set_t& cpus) {
+    std::string out;
+    char buf[32];
+    for (int c = 0; c < CPU_SETSIZE; c++) {
+        if (!CPU_ISSET(c, &cpus)) continue;
+        int e = c;
+        while (e + 1 < CPU_SETSIZE && CPU_ISSET(e + 1, &cpus)) e++;
+        if (e == c) snprintf(buf, sizeof(buf), "%s%d", out.empty() ? "" : ",", c);
+        else snprintf(buf, sizeof(buf), "%s%d-%d", out.empty() ? "" : ",", c, e);
+        out += buf;
+        c = e;
+    }
+    return out.empty() ? "-" : out;
+}
+
+inline std::string format_cpu_list(const std::vector<int>& cpus) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int c : cpus) {
+        if (c >= 0 && c < CPU_SETSIZE) CPU_SET(c, &set);
+    }
+    return format_cpu_list(set);
+}
+
+// 가장 큰 node 번호 + 1 (sysfs 가 없으면 1)
+inline int node_count() {
+    int count = 0;
+    for (int n = 0; n < MAX_NODES; n++) {
+        char path[64];
+        snprintf(path, sizeof(path), "/sys/devices/system/node/node%d", n);
+        if (access(path, F_OK) == 0) count = n + 1;
+        else if (n >= 64 && count > 0) break;
+    }
+    return count > 0 ? count : 1;
+}
+
+inline bool node_cpus(int node, cpu_set_t& cpus) {
+    char path[80];
+    snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist", node);
+    std::ifstream in(path);
+    std::string list;
+    if (!in || !std::getline(in, list)) {
+        CPU_ZERO(&cpus);
+        return false;
+    }
+    return parse_cpu_list(list, cpus);
+}
+
+// cpu 가 속한 node (모르면 -1)
+inline int node_of_cpu(int cpu) {
+    int nodes = node_count();
+    for (int n = 0; n < nodes; n++) {
+        cpu_set_t cpus;
+        if (node_cpus(n, cpus) && cpu >= 0 && cpu < CPU_SETSIZE && CPU_ISSET(cpu, &cpus)) return n;
+    }
+    return -1;
+}
+
+// 0 이면 성공, 아니면 errno 값 (pthread_setaffinity_np 와 같음)
+inline int bind_thread(pthread_t th, const cpu_set_t& cpus) {
+    return pthread_setaffinity_np(th, sizeof(cpus), &cpus);
+}
+
+inline int bind_thread(pthread_t th, int cpu) {
+    cpu_set_t cpus;
+    CPU_ZERO(&cpus);
+    CPU_SET(cpu, &cpus);
+    return bind_thread(th, cpus);
+}
+
+inline void node_mask(int node, unsigned long* mask, size_t words) {
+    memset(mask, 0, words * sizeof(unsigned long));
+    mask[node / (8 * sizeof(unsigned long))] |= 1UL << (node % (8 * sizeof(unsigned long)));
+}
+
+// [addr, addr + len) 을 node 우선으로 (이미 있는 page 는 옮김). addr 은 page 경계. 실패 시 false (errno)
+inline bool bind_memory(void* addr, size_t len, int node) {
+    if (node < 0 || node >= MAX_NODES || !addr || len == 0) {
+        errno = EINVAL;
+        return false;
+    }
+    unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))];
+    node_mask(node, mask, sizeof(mask) / sizeof(mask[0]));
+    return syscall(SYS_mbind, addr, len, MPOL_PREFERRED, mask, (unsigned long)MAX_NODES, MPOL_MF_MOVE) == 0;
+}
+
+// 호출 스레드의 이후 할당을 node 우선으로 (node < 0: 기본 정책). 이후 만드는 스레드가 물려받는다
+inline bool prefer_node(int node) {
+    if (node < 0) {
+        return syscall(SYS_set_mempolicy, MPOL_DEFAULT, nullptr, 0UL) == 0;
+    }
+    if (node >= MAX_NODES) {
+        errno = EINVAL;
+        return false;
+    }
+    unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))];
+    node_mask(node, mask, sizeof(mask) / sizeof(mask[0]));
+    return syscall(SYS_set_mempolicy, MPOL_PREFERRED, mask, (unsigned long)MAX_NODES) == 0;
+}
+
+// 호출 스레드의 현재 정책 (MPOL_* , 실패 시 -1). preferred 면 node 도 돌려준다
+inline int current_policy(int* node) {
+    int mode = -1;
+    unsigned long mask[MAX_NODES / (8 * sizeof(unsigned long))];
+    memset(mask, 0, sizeof(mask));
+    if (syscall(SYS_get_mempolicy, &mode, mask, (unsigned long)MAX_NODES, nullptr, 0UL) != 0) return -1;
+    if (node) {
+        *node = -1;
+        for (int n = 0; n < MAX_NODES; n++) {
+            if (mask[n / (8 * sizeof(unsigned long))] & (1UL << (n % (8 * sizeof(unsigned long))))) {
+                *node = n;
+                break;
+            }
+        }
+    }
+    return mode;
+}
+
+// addr 의 page 가 있는 node (page 가 없으면 이 호출이 fault 시킴, 실패 시 -1)
+inline int node_of_address(const void* addr) {
+    int node = -1;
+    if (syscall(SYS_get_mempolicy, &node, nullptr, 0UL, addr, (unsigned long)(MPOL_F_NODE | MPOL_F_ADDR)) != 0) return -1;
+    return node;
+}
+
+// 스코프 안에서만 node 우선 할당 (마스터 적재 스레드 등), 끝나면 이전 정책으로 되돌린다
+class ScopedPreferredNode {
+private:
+    int _prev_mode;
+    int _prev_node;
+    bool _active;
+
+public:
+    explicit ScopedPreferredNode(int node) : _prev_mode(-1), _prev_node(-1), _active(false) {
+        if (node < 0) return;
+        _prev_mode = current_policy(&_prev_node);
+        _active = _prev_mode >= 0 && prefer_node(node);
+    }
+    ~ScopedPreferredNode() {
+        if (!_active) return;
+        if (_prev_mode == MPOL_PREFERRED && _prev_node >= 0) prefer_node(_prev_node);
+        else prefer_node(-1);
+    }
+    ScopedPreferredNode(const ScopedPreferredNode&) = delete;
+    ScopedPreferredNode& operator=(const ScopedPreferredNode&) = delete;
+    bool active() const { return _active; }
+};
+
+} // namespace NumaPlacement
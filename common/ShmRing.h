@@ -0,0 +1,337 @@
+#pragma once
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+#include "NumaPlacement.h"
+
+namespace SimplePubSub {
+
+/**
+ * ShmRing - 공유메모리 single-producer / single-consumer 가변 길이 메시지 ring
+ *
+ * POSIX MQ 대체용. 커널 복사 없이 producer 가 ring 에 직접 쓰고 consumer 는
+ * ring 안의 포인터를 그대로 콜백에 넘긴다 (mq_msgsize 제한 없음, 메시지당 syscall 없음).
+ *
+ * 레이아웃 (/dev/shm/<name>):
+ *   [ShmRingHeader 4KB][data capacity bytes (2의 거듭제곱)]
+ *   레코드: [uint32 length][uint32 reserved][payload][8바이트 정렬 padding]
+ *   끝에 안 들어가는 레코드는 WRAP 표시를 남기고 처음부터 쓴다 (payload 는 항상 연속).
+ *
+ * head/tail 은 단조 증가하는 바이트 위치 (offset = pos & (capacity-1))
+ * consumer 가 잠들 때는 waiting=1 로 표시하고 wake_seq 에 futex wait,
+ * producer 는 head 공개 후 waiting 이면 wake_seq 를 올리고 FUTEX_WAKE (프로세스 간 공유 futex).
+ */
+
+#define SHM_RING_MAGIC 0x53524E47      // "SRNG"
+#define SHM_RING_VERSION 1
+#define SHM_RING_HEADER_SIZE 4096
+#define SHM_RING_WRAP 0xFFFFFFFFu
+#define SHM_RING_RECORD_HEADER 8
+
+struct ShmRingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+
+    alignas(64) std::atomic<uint64_t> head;         // producer 쓰기 위치
+    std::atomic<uint64_t> write_count;
+    std::atomic<uint64_t> drop_count;               // ring 이 꽉 차서 버린 메시지 수
+
+    alignas(64) std::atomic<uint64_t> tail;         // consumer 읽기 위치
+
+    alignas(64) std::atomic<uint32_t> wake_seq;     // futex word
+    std::atomic<uint32_t> waiting;                  // consumer 가 futex wait 중
+};
+
+static_assert(sizeof(ShmRingHeader) <= SHM_RING_HEADER_SIZE, "ShmRingHeader too large");
+
+// ring 에서 꺼낸 메시지 (consumer 가 commit 하기 전까지 유효)
+struct ShmRingMessage {
+    const char* data;
+    size_t size;
+};
+
+class ShmRing {
+private:
+    std::string _name;
+    int _fd;
+    void* _addr;
+    size_t _map_size;
+    ShmRingHeader* _hdr;
+    char* _data;
+    uint64_t _mask;
+
+    static size_t align8(size_t n) { return (n + 7) & ~static_cast<size_t>(7); }
+
+    static long futex(std::atomic<uint32_t>* addr, int op, uint32_t val, const struct timespec* ts) {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val, ts, nullptr, 0);
+    }
+
+    bool map(int fd, size_t size) {
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            std::cerr << "ShmRing mmap failed '" << _name << "': " << strerror(errno) << std::endl;
+            return false;
+        }
+        _fd = fd;
+        _addr = addr;
+        _map_size = size;
+        _hdr = static_cast<ShmRingHeader*>(addr);
+        _data = static_cast<char*>(addr) + SHM_RING_HEADER_SIZE;
+        return true;
+    }
+
+public:
+    ShmRing() : _fd(-1), _addr(nullptr), _map_size(0), _hdr(nullptr), _data(nullptr), _mask(0) {}
+    ~ShmRing() { close(); }
+
+    ShmRing(const ShmRing&) = delete;
+    ShmRing& operator=(const ShmRing&) = delete;
+
+    /**
+     * ring 생성 (이미 있고 capacity 가 같으면 그대로 붙는다)
+     * @param capacity data 영역 크기, 2의 거듭제곱으로 올림
+     */
+    bool create(const std::string& name, size_t capacity) {
+        close();
+        _name = name;
+
+        size_t cap = 4096;
+        while (cap < capacity) cap <<= 1;
+
+        int fd = shm_open(name.c_str(), O_CREAT | O_RDWR, 0644);
+        if (fd < 0) {
+            std::cerr << "ShmRing shm_open failed '" << name << "': " << strerror(errno) << std::endl;
+            return false;
+        }
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size >= static_cast<off_t>(SHM_RING_HEADER_SIZE)) {
+            // 기존 ring 재사용 (consumer 재시작 시 남은 메시지를 이어서 읽는다)
+            if (map(fd, st.st_size) && _hdr->magic == SHM_RING_MAGIC &&
+                _hdr->version == SHM_RING_VERSION && _hdr->capacity == cap &&
+                st.st_size == static_cast<off_t>(SHM_RING_HEADER_SIZE + cap)) {
+                _mask = cap - 1;
+                _hdr->waiting.store(0);
+                return true;
+            }
+            if (_addr) munmap(_addr, _map_size);
+            _addr = nullptr;
+            _hdr = nullptr;
+        }
+
+        size_t size = SHM_RING_HEADER_SIZE + cap;
+        if (ftruncate(fd, 0) != 0 || ftruncate(fd, size) != 0) {
+            std::cerr << "ShmRing ftruncate failed '" << name << "': " << strerror(errno) << std::endl;
+            ::close(fd);
+            return false;
+        }
+        if (!map(fd, size)) {
+            ::close(fd);
+            return false;
+        }
+
+        _hdr->capacity = cap;
+        _hdr->version = SHM_RING_VERSION;
+        _hdr->head.store(0);
+        _hdr->tail.store(0);
+        _hdr->write_count.store(0);
+        _hdr->drop_count.store(0);
+        _hdr->wake_seq.store(0);
+        _hdr->waiting.store(0);
+        std::atomic_thread_fence(std::memory_order_release);
+        _hdr->magic = SHM_RING_MAGIC;      // 마지막에 magic 을 써서 초기화 완료 표시
+        _mask = cap - 1;
+        return true;
+    }
+
+    // 이미 생성된 ring 에 붙기 (producer 측)
+    bool open(const std::string& name) {
+        close();
+        _name = name;
+
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            std::cerr << "ShmRing shm_open failed '" << name << "': " << strerror(errno) << std::endl;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(SHM_RING_HEADER_SIZE)) {
+            std::cerr << "ShmRing '" << name << "' is not initialized" << std::endl;
+            ::close(fd);
+            return false;
+        }
+        if (!map(fd, st.st_size)) {
+            ::close(fd);
+            return false;
+        }
+        if (_hdr->magic != SHM_RING_MAGIC || _hdr->version != SHM_RING_VERSION ||
+            st.st_size != static_cast<off_t>(SHM_RING_HEADER_SIZE + _hdr->capacity)) {
+            std::cerr << "ShmRing '" << name << "' has invalid header" << std::endl;
+            close();
+            return false;
+        }
+        _mask = _hdr->capacity - 1;
+        return true;
+    }
+
+    // ring (header + data) 을 node 에 둔다. shm 정책은 파일에 남으므로 producer 가 쓰는 page 도 그 node
+    bool bind_node(int node) {
+        if (!_addr) return false;
+        if (!NumaPlacement::bind_memory(_addr, _map_size, node)) {
+            std::cerr << "ShmRing mbind failed '" << _name << "' node " << node << ": " << strerror(errno) << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    void close() {
+        if (_addr) {
+            munmap(_addr, _map_size);
+            _addr = nullptr;
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+        _hdr = nullptr;
+        _data = nullptr;
+    }
+
+    bool unlink() { return !_name.empty() && shm_unlink(_name.c_str()) == 0; }
+
+    bool is_open() const { return _hdr != nullptr; }
+    const std::string& name() const { return _name; }
+    size_t capacity() const { return _hdr ? _hdr->capacity : 0; }
+    size_t max_message_size() const { return _hdr ? _hdr->capacity / 2 - SHM_RING_RECORD_HEADER : 0; }
+    uint64_t write_count() const { return _hdr ? _hdr->write_count.load(std::memory_order_relaxed) : 0; }
+    uint64_t drop_count() const { return _hdr ? _hdr->drop_count.load(std::memory_order_relaxed) : 0; }
+    size_t used_bytes() const {
+        return _hdr ? _hdr->head.load(std::memory_order_acquire) - _hdr->tail.load(std::memory_order_acquire) : 0;
+    }
+
+    // ---- producer ----
+
+    /**
+     * 메시지 쓰기 (a 뒤에 b 를 이어 붙여 한 레코드로 저장, ipc_header + payload 용)
+     * ring 이 꽉 차면 기다리지 않고 false (drop_count 증가)
+     */
+    bool write(const void* a, size_t a_size, const void* b = nullptr, size_t b_size = 0) {
+        if (!_hdr) return false;
+        size_t size = a_size + b_size;
+        size_t need = align8(SHM_RING_RECORD_HEADER + size);
+        uint64_t cap = _hdr->capacity;
+        if (size > UINT32_MAX - 1 || need > cap / 2) return false;
+
+        uint64_t head = _hdr->head.load(std::memory_order_relaxed);
+        uint64_t tail = _hdr->tail.load(std::memory_order_acquire);
+        uint64_t off = head & _mask;
+        uint64_t to_end = cap - off;
+        uint64_t total = need + (to_end < need ? to_end : 0);
+        if (head + total - tail > cap) {
+            _hdr->drop_count.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+
+        if (to_end < need) {
+            // 끝에 안 들어가면 WRAP 표시 후 처음부터 (offset 은 8 정렬이므로 to_end >= 8)
+            *reinterpret_cast<uint32_t*>(_data + off) = SHM_RING_WRAP;
+            head += to_end;
+            off = 0;
+        }
+
+        char* rec = _data + off;
+        *reinterpret_cast<uint32_t*>(rec) = static_cast<uint32_t>(size);
+        *reinterpret_cast<uint32_t*>(rec + 4) = 0;
+        if (a_size) memcpy(rec + SHM_RING_RECORD_HEADER, a, a_size);
+        if (b_size) memcpy(rec + SHM_RING_RECORD_HEADER + a_size, b, b_size);
+
+        _hdr->write_count.fetch_add(1, std::memory_order_relaxed);
+        // head 공개와 waiting 확인은 seq_cst (consumer 의 waiting=1 -> head 재확인과 짝)
+        _hdr->head.store(head + need, std::memory_order_seq_cst);
+        if (_hdr->waiting.load(std::memory_order_seq_cst)) {
+            wake();
+        }
+        return true;
+    }
+
+    void wake() {
+        if (!_hdr) return;
+        _hdr->wake_seq.fetch_add(1, std::memory_order_seq_cst);
+        futex(&_hdr->wake_seq, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+
+    // ---- consumer ----
+
+    bool readable() const { return _hdr->head.load(std::memory_order_acquire) != _hdr->tail.load(std::memory_order_relaxed); }
+
+    /**
+     * 최대 max 개 메시지를 out 에 채운다 (복사 없음). commit(next) 전까지 포인터 유효.
+     * @param next commit 에 넘길 다음 tail 위치
+     */
+    size_t peek(ShmRingMessage* out, size_t max, uint64_t& next) const {
+        uint64_t pos = _hdr->tail.load(std::memory_order_relaxed);
+        uint64_t head = _hdr->head.load(std::memory_order_acquire);
+        size_t n = 0;
+        while (pos < head && n < max) {
+            uint64_t off = pos & _mask;
+            uint32_t len = *reinterpret_cast<const uint32_t*>(_data + off);
+            if (len == SHM_RING_WRAP) {
+                pos += _hdr->capacity - off;
+                continue;
+            }
+            out[n].data = _data + off + SHM_RING_RECORD_HEADER;
+            out[n].size = len;
+            n++;
+            pos += align8(SHM_RING_RECORD_HEADER + len);
+        }
+        next = pos;
+        return n;
+    }
+
+    void commit(uint64_t next) { _hdr->tail.store(next, std::memory_order_release); }
+
+    uint64_t head() const { return _hdr->head.load(std::memory_order_acquire); }
+    uint64_t tail() const { return _hdr->tail.load(std::memory_order_relaxed); }
+
+    /**
+     * head 가 seen 에서 바뀔 때까지 대기 (spin_us 동안 spin 후 futex wait)
+     * seen = tail() 이면 "읽을 메시지가 생길 때까지"
+     * @return head 가 바뀌었으면 true, timeout/wake 만 된 경우 false
+     */
+    bool wait(uint64_t seen, long spin_us, long timeout_us) {
+        if (head() != seen) return true;
+
+        if (spin_us > 0) {
+            struct timespec start, now;
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            do {
+                if (head() != seen) return true;
+                clock_gettime(CLOCK_MONOTONIC, &now);
+            } while ((now.tv_sec - start.tv_sec) * 1000000L + (now.tv_nsec - start.tv_nsec) / 1000 < spin_us);
+        }
+
+        uint32_t seq = _hdr->wake_seq.load(std::memory_order_seq_cst);
+        _hdr->waiting.store(1, std::memory_order_seq_cst);
+        if (_hdr->head.load(std::memory_order_seq_cst) == seen) {
+            struct timespec ts = {timeout_us / 1000000, (timeout_us % 1000000) * 1000};
+            futex(&_hdr->wake_seq, FUTEX_WAIT, seq, timeout_us > 0 ? &ts : nullptr);
+        }
+        _hdr->waiting.store(0, std::memory_order_relaxed);
+        return head() != seen;
+    }
+};
+
+} // namespace SimplePubSub
@@ -0,0 +1,236 @@
+#include "ShmRingReader.h"
+#include <iostream>
+#include <errno.h>
+#include <string.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+
+namespace SimplePubSub {
+
+// waiter 가 futex 에서 깨어나 running_ 을 다시 확인하는 주기
+static const long SHM_RING_WAIT_TIMEOUT_US = 100000;
+// event loop 한 턴에 처리할 최대 batch 수
+static const int SHM_RING_MAX_BATCHES_PER_WAKEUP = 64;
+
+ShmRingReader::ShmRingReader(struct event_base* shared_event_base)
+    : event_base_(shared_event_base)
+    , notify_event_(nullptr)
+    , notify_fd_(-1)
+    , batch_size_(1)
+    , slots_(nullptr)
+    , batch_(nullptr)
+    , spin_us_(0) {
+
+    if (!event_base_) {
+        throw std::runtime_error("event_base cannot be null");
+    }
+    allocate_buffers();
+}
+
+ShmRingReader::~ShmRingReader() {
+    stop();
+    close_ring();
+    free_buffers();
+}
+
+void ShmRingReader::allocate_buffers() {
+    free_buffers();
+    slots_ = new ShmRingMessage[batch_size_];
+    batch_ = new MQMessage[batch_size_];
+}
+
+void ShmRingReader::free_buffers() {
+    delete[] slots_;
+    slots_ = nullptr;
+    delete[] batch_;
+    batch_ = nullptr;
+}
+
+bool ShmRingReader::create_ring(const std::string& name, size_t capacity, int numa_node) {
+    if (!ring_.create(name, capacity)) {
+        std::cerr << "Failed to create shm ring '" << name << "'" << std::endl;
+        return false;
+    }
+    if (numa_node >= 0) {
+        ring_.bind_node(numa_node);     // 실패해도 ring 은 그대로 쓴다
+    }
+    std::cout << "Created shm ring: " << name << " (capacity=" << ring_.capacity()
+              << ", max_msg_size=" << ring_.max_message_size() << ")" << std::endl;
+    return true;
+}
+
+void ShmRingReader::close_ring() {
+    if (ring_.is_open()) {
+        ring_.close();
+        std::cout << "Closed shm ring: " << ring_.name() << std::endl;
+    }
+}
+
+bool ShmRingReader::set_batch_size(size_t n) {
+    if (running_.load() || n == 0) {
+        return false;
+    }
+    batch_size_ = n;
+    allocate_buffers();
+    return true;
+}
+
+void ShmRingReader::start() {
+    if (running_.load() || !ring_.is_open()) {
+        return;
+    }
+
+    notify_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (notify_fd_ < 0) {
+        std::cerr << "Failed to create eventfd: " << strerror(errno) << std::endl;
+        return;
+    }
+
+    notify_event_ = event_new(event_base_, notify_fd_, EV_READ | EV_PERSIST, notify_callback, this);
+    if (!notify_event_ || event_add(notify_event_, nullptr) != 0) {
+        std::cerr << "Failed to add shm ring notify event" << std::endl;
+        if (notify_event_) event_free(notify_event_);
+        notify_event_ = nullptr;
+        close(notify_fd_);
+        notify_fd_ = -1;
+        return;
+    }
+
+    running_.store(true);
+    thread_ = std::thread(&ShmRingReader::waiter_loop, this);
+    std::cout << "ShmRingReader started for: " << ring_.name() << " (batch_size=" << batch_size_ << ")" << std::endl;
+}
+
+size_t ShmRingReader::poll() {
+    if (!running_.load(std::memory_order_relaxed) || !notify_event_) {
+        return 0;
+    }
+    return drain();
+}
+
+void ShmRingReader::start_poll_thread(int cpu) {
+    if (running_.load() || !ring_.is_open()) {
+        return;
+    }
+
+    running_.store(true);
+    thread_ = std::thread(&ShmRingReader::poll_loop, this);
+
+    if (cpu >= 0) {
+        cpu_set_t cpuset;
+        CPU_ZERO(&cpuset);
+        CPU_SET(cpu, &cpuset);
+        int rc = pthread_setaffinity_np(thread_.native_handle(), sizeof(cpuset), &cpuset);
+        if (rc != 0) {
+            std::cerr << "Failed to pin shm ring poll thread to cpu " << cpu << ": " << strerror(rc) << std::endl;
+        }
+    }
+
+    std::cout << "ShmRingReader poll thread started for: " << ring_.name() << " (batch_size=" << batch_size_
+              << ", cpu=" << cpu << ", spin_us=" << spin_us_ << ")" << std::endl;
+}
+
+void ShmRingReader::stop() {
+    if (!running_.load()) {
+        return;
+    }
+
+    running_.store(false);
+    ring_.wake();
+    if (thread_.joinable()) {
+        thread_.join();
+    }
+
+    if (notify_event_) {
+        event_del(notify_event_);
+        event_free(notify_event_);
+        notify_event_ = nullptr;
+    }
+    if (notify_fd_ >= 0) {
+        close(notify_fd_);
+        notify_fd_ = -1;
+    }
+
+    std::cout << "ShmRingReader stopped" << std::endl;
+}
+
+// 최대 batch_size_ 개를 꺼내 콜백 호출 후 ring 에 반납
+size_t ShmRingReader::drain() {
+    uint64_t next;
+    size_t count = ring_.peek(slots_, batch_size_, next);
+    if (count == 0) {
+        return 0;
+    }
+
+    messages_received_.inc(count);
+    drain_count_.inc();
+    drain_batch_.record(count);
+    last_drain_ns_ = latency_now_ns();
+
+    if (batch_callback_) {
+        for (size_t i = 0; i < count; ++i) {
+            batch_[i].data = slots_[i].data;
+            batch_[i].size = slots_[i].size;
+            batch_[i].priority = 0;
+        }
+        batch_callback_(batch_, count);
+    } else {
+        for (size_t i = 0; i < count; ++i) {
+            if (data_callback_) {
+                data_callback_(slots_[i].data, slots_[i].size);
+            }
+            if (topic_callback_) {
+                topic_callback_(DataTopic::TOPIC1, slots_[i].data, slots_[i].size);
+            }
+        }
+    }
+
+    ring_.commit(next);
+    return count;
+}
+
+void ShmRingReader::notify_callback(evutil_socket_t fd, short /*events*/, void* user_data) {
+    auto* reader = static_cast<ShmRingReader*>(user_data);
+    uint64_t value;
+    if (read(fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        std::cerr << "Failed to read shm ring eventfd: " << strerror(errno) << std::endl;
+    }
+
+    // batch_size_ 단위로 콜백, 다른 이벤트가 굶지 않도록 wakeup 당 batch 수를 제한하고
+    // 남은 메시지는 event_active 로 다음 루프 턴에 이어서 처리
+    for (int i = 0; i < SHM_RING_MAX_BATCHES_PER_WAKEUP; ++i) {
+        if (reader->drain() == 0) {
+            return;
+        }
+    }
+    if (reader->ring_.readable()) {
+        event_active(reader->notify_event_, EV_READ, 0);
+    }
+}
+
+// ring 에 새 메시지가 쓰이면 eventfd 로 event loop 를 깨운다.
+// 이미 알린 head 까지는 다시 알리지 않고 (event loop 가 한번에 비운다) 다음 쓰기를 기다린다.
+void ShmRingReader::waiter_loop() {
+    uint64_t one = 1;
+    uint64_t notified = ring_.tail();
+    while (running_.load(std::memory_order_relaxed)) {
+        if (!ring_.wait(notified, spin_us_, SHM_RING_WAIT_TIMEOUT_US)) {
+            continue;
+        }
+        notified = ring_.head();
+        if (write(notify_fd_, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            std::cerr << "Failed to write shm ring eventfd: " << strerror(errno) << std::endl;
+        }
+    }
+}
+
+void ShmRingReader::poll_loop() {
+    while (running_.load(std::memory_order_relaxed)) {
+        if (ring_.wait(ring_.tail(), spin_us_, SHM_RING_WAIT_TIMEOUT_US)) {
+            drain();
+        }
+    }
+}
+
+} // namespace SimplePubSub
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "../pubsub/Common.h"
+#include "MQReader.h"
+#include "ShmRing.h"
+#include "LatencyStats.h"
+#include <functional>
+#include <string>
+#include <atomic>
+#include <thread>
+
+namespace SimplePubSub {
+
+/**
+ * ShmRing consumer - MQReader 와 같은 콜백 인터페이스
+ *
+ * start():             waiter 스레드가 ring 을 기다리다가 eventfd 로 libevent 를 깨우고
+ *                      콜백은 event loop 스레드에서 호출된다 (MQReader::start 대체)
+ * start_poll_thread(): 전용 스레드에서 spin/futex 대기 후 바로 콜백 (최저 지연)
+ *
+ * 콜백에 넘기는 data 는 ring 안의 포인터이며 콜백이 끝나면 ring 에 반납된다.
+ */
+class ShmRingReader {
+private:
+    struct event_base* event_base_;
+    struct event* notify_event_;
+    int notify_fd_;             // eventfd (waiter -> event loop)
+    
+    ShmRing ring_;
+    
+    std::function<void(const char* data, size_t size)> data_callback_;
+    std::function<void(DataTopic topic, const char* data, size_t size)> topic_callback_;
+    std::function<void(const MQMessage* messages, size_t count)> batch_callback_;
+    
+    size_t batch_size_;
+    ShmRingMessage* slots_;
+    MQMessage* batch_;
+    
+    long spin_us_;
+    std::thread thread_;        // waiter 또는 poll 스레드
+    
+    std::atomic<bool> running_{false};
+    StatsCounter messages_received_{"shm.messages_received"};
+    StatsCounter drain_count_{"shm.drains"};
+    StatsHistogram drain_batch_{"shm.drain_batch"};     // drain 한번에 받은 메시지 수
+    uint64_t last_drain_ns_ = 0;                        // 마지막 drain 완료 시각 (latency_now_ns, 콜백 스레드에서 읽음)
+    
+    static void notify_callback(evutil_socket_t fd, short events, void* user_data);
+    
+    size_t drain();
+    void waiter_loop();
+    void poll_loop();
+    void allocate_buffers();
+    void free_buffers();
+    
+public:
+    explicit ShmRingReader(struct event_base* shared_event_base);
+    virtual ~ShmRingReader();
+    
+    // ring 생성 (consumer 가 생성, producer 는 ShmRing::open 으로 붙는다)
+    // numa_node >= 0: ring 을 그 node 에 둔다 (ShmRing::bind_node)
+    bool create_ring(const std::string& name, size_t capacity = 4 * 1024 * 1024, int numa_node = -1);
+    void close_ring();
+    
+    void set_data_callback(std::function<void(const char*, size_t)> callback) { data_callback_ = callback; }
+    void set_topic_callback(std::function<void(DataTopic, const char*, size_t)> callback) { topic_callback_ = callback; }
+    void set_batch_callback(std::function<void(const MQMessage*, size_t)> callback) { batch_callback_ = callback; }
+    
+    bool set_batch_size(size_t n);
+    size_t get_batch_size() const { return batch_size_; }
+    // futex 로 잠들기 전에 spin 할 시간 (기본 0)
+    void set_spin_us(long spin_us) { spin_us_ = spin_us; }
+    
+    void start();
+    void start_poll_thread(int cpu = -1);
+    // start() 모드에서 event loop 스레드가 직접 ring 을 drain (spin loop 용), 처리한 메시지 수 반환
+    size_t poll();
+    void stop();
+    bool is_running() const { return running_.load(); }
+    
+    uint64_t get_messages_received() const { return messages_received_.value(); }
+    uint64_t get_drain_count() const { return drain_count_.value(); }
+    uint64_t get_last_drain_ns() const { return last_drain_ns_; }
+    uint64_t get_drop_count() const { return ring_.drop_count(); }
+    const std::string& get_name() const { return ring_.name(); }
+    size_t get_capacity() const { return ring_.capacity(); }
+    
+    struct event_base* get_event_base() const { return event_base_; }
+};
+
+} // namespace SimplePubSub
@@ -0,0 +1,365 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <map>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace SimplePubSub {
+
+/**
+ * StatsRegistry - 스레드별 shard 통계 카운터 / 히스토그램 과 snapshot
+ *
+ * 처리 스레드가 같은 int / atomic 을 올리면 다른 스레드의 통계 조회와 같은 cache line 을 두고 경쟁한다.
+ * StatsCounter 는 값을 스레드별 cache line (64B) 에 나눠 두고, 각 스레드는 자기 shard 만 relaxed 로
+ * 올린다 (lock 없음, 다른 스레드와 line 공유 없음). 읽을 때 shard 합을 구한다.
+ *
+ * - StatsCounter: 단조 증가 카운터, inc()/++ 는 hot path 용, value() 는 전체 합 (조회용)
+ * - StatsHistogram: 2의 거듭제곱마다 8개 sub-bucket 인 HDR 식 히스토그램 (상대 오차 12.5% 이하)
+ *   shard 는 그 스레드가 처음 record() 할 때 할당
+ * - 이름을 준 카운터/히스토그램은 StatsRegistry 에 등록되고 snapshot() 에서 이름별 합으로 보인다
+ *   (같은 이름의 여러 인스턴스는 합산, 예: 여러 MemoryMaster 의 lookup 수)
+ *
+ * snapshot 은 shard 를 relaxed 로 읽기만 하므로 hot path 를 멈추지 않는다 (등록 목록 mutex 는
+ * 생성/소멸과 snapshot 사이에서만 잡힘). 각 값은 읽는 순간의 값이라 카운터 간 정확한 일관성은 없다.
+ * 스레드 shard 번호는 스레드가 처음 통계를 쓸 때 정해지며, MAX_THREADS 를 넘는 스레드는 shard 를
+ * 나눠 쓴다 (fetch_add 라 정확성은 유지, 그 shard 만 cache line 공유).
+ */
+
+static const size_t STATS_MAX_THREADS = 64;
+static const size_t STATS_CACHE_LINE = 64;
+
+// 현재 스레드의 shard 번호
+inline size_t stats_thread_slot() {
+    static std::atomic<size_t> next_slot(0);
+    static thread_local size_t slot = next_slot.fetch_add(1, std::memory_order_relaxed) % STATS_MAX_THREADS;
+    return slot;
+}
+
+inline void* stats_aligned_alloc(size_t size) {
+    void* p = nullptr;
+    if (posix_memalign(&p, STATS_CACHE_LINE, size) != 0) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+class StatsCounter;
+class StatsHistogram;
+
+// snapshot 결과 (이름별 합산)
+struct StatsSnapshot {
+    struct Histogram {
+        uint64_t count = 0;
+        uint64_t sum = 0;
+        std::vector<uint64_t> buckets;
+
+        double mean() const { return count ? static_cast<double>(sum) / count : 0.0; }
+        uint64_t percentile(double p) const;    // p: 0~100, bucket 상한값
+        uint64_t max() const;
+    };
+
+    std::map<std::string, uint64_t> counters;
+    std::map<std::string, Histogram> histograms;
+
+    uint64_t counter(const std::string& name) const {
+        auto it = counters.find(name);
+        return it != counters.end() ? it->second : 0;
+    }
+
+    std::string to_string() const;
+};
+
+class StatsRegistry {
+public:
+    static StatsRegistry& instance() {
+        static StatsRegistry registry;
+        return registry;
+    }
+
+    // prefix 를 주면 이름이 prefix 로 시작하는 항목만 (예: "latency.")
+    inline StatsSnapshot snapshot(const std::string& prefix = std::string());
+    inline void reset_all();
+    inline void reset(const std::string& prefix);
+
+private:
+    friend class StatsCounter;
+    friend class StatsHistogram;
+
+    StatsRegistry() {}
+    StatsRegistry(const StatsRegistry&) = delete;
+    StatsRegistry& operator=(const StatsRegistry&) = delete;
+
+    void add(StatsCounter* c) {
+        std::lock_guard<std::mutex> g(_mu);
+        _counters.push_back(c);
+    }
+    void add(StatsHistogram* h) {
+        std::lock_guard<std::mutex> g(_mu);
+        _histograms.push_back(h);
+    }
+    void remove(StatsCounter* c) {
+        std::lock_guard<std::mutex> g(_mu);
+        _counters.erase(std::remove(_counters.begin(), _counters.end(), c), _counters.end());
+    }
+    void remove(StatsHistogram* h) {
+        std::lock_guard<std::mutex> g(_mu);
+        _histograms.erase(std::remove(_histograms.begin(), _histograms.end(), h), _histograms.end());
+    }
+
+    std::mutex _mu;
+    std::vector<StatsCounter*> _counters;
+    std::vector<StatsHistogram*> _histograms;
+};
+
+class StatsCounter {
+public:
+    explicit StatsCounter(const char* name = nullptr) : _name(name ? name : "") {
+        _cells = static_cast<Cell*>(stats_aligned_alloc(sizeof(Cell) * STATS_MAX_THREADS));
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            new (&_cells[i]) Cell();
+        }
+        if (!_name.empty()) StatsRegistry::instance().add(this);
+    }
+
+    ~StatsCounter() {
+        if (!_name.empty()) StatsRegistry::instance().remove(this);
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            _cells[i].~Cell();
+        }
+        free(_cells);
+    }
+
+    StatsCounter(const StatsCounter&) = delete;
+    StatsCounter& operator=(const StatsCounter&) = delete;
+
+    void inc(uint64_t n = 1) {
+        _cells[stats_thread_slot()].value.fetch_add(n, std::memory_order_relaxed);
+    }
+    StatsCounter& operator++() { inc(); return *this; }
+    void operator++(int) { inc(); }
+    StatsCounter& operator+=(uint64_t n) { inc(n); return *this; }
+
+    // 전체 스레드 합 (조회용, shard 수만큼 읽음)
+    uint64_t value() const {
+        uint64_t total = 0;
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            total += _cells[i].value.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    // 현재 스레드 shard 값 (한 스레드만 올리는 카운터의 주기 로그 판단 등 hot path 용)
+    uint64_t local() const {
+        return _cells[stats_thread_slot()].value.load(std::memory_order_relaxed);
+    }
+
+    // gauge 로 쓸 때 (주기적으로 한 스레드만 갱신하는 현재 값, 예: 마스터 사용률)
+    void set(uint64_t v) {
+        size_t slot = stats_thread_slot();
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            _cells[i].value.store(i == slot ? v : 0, std::memory_order_relaxed);
+        }
+    }
+
+    // 초기화 (동시에 올라가던 증가분은 잃을 수 있음)
+    void reset() {
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            _cells[i].value.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const std::string& name() const { return _name; }
+
+private:
+    struct alignas(STATS_CACHE_LINE) Cell {
+        std::atomic<uint64_t> value;
+        Cell() : value(0) {}
+    };
+
+    std::string _name;
+    Cell* _cells;
+};
+
+class StatsHistogram {
+public:
+    static const int SUB_BITS = 3;
+    static const size_t SUB_BUCKETS = 1u << SUB_BITS;
+    static const size_t BUCKETS = (64 - SUB_BITS + 1) * SUB_BUCKETS;
+
+    explicit StatsHistogram(const char* name = nullptr) : _name(name ? name : "") {
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            _shards[i].store(nullptr, std::memory_order_relaxed);
+        }
+        if (!_name.empty()) StatsRegistry::instance().add(this);
+    }
+
+    ~StatsHistogram() {
+        if (!_name.empty()) StatsRegistry::instance().remove(this);
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            Shard* s = _shards[i].load(std::memory_order_relaxed);
+            if (s) {
+                s->~Shard();
+                free(s);
+            }
+        }
+    }
+
+    StatsHistogram(const StatsHistogram&) = delete;
+    StatsHistogram& operator=(const StatsHistogram&) = delete;
+
+    void record(uint64_t value) {
+        Shard* s = shard();
+        s->buckets[bucket_of(value)].fetch_add(1, std::memory_order_relaxed);
+        s->sum.fetch_add(value, std::memory_order_relaxed);
+    }
+
+    // 값 v 가 들어가는 bucket: v < 8 은 그대로, 그 이상은 (최상위 비트 위치, 다음 3비트)
+    static size_t bucket_of(uint64_t v) {
+        if (v < SUB_BUCKETS) return static_cast<size_t>(v);
+        int e = 63 - __builtin_clzll(v);
+        size_t sub = static_cast<size_t>(v >> (e - SUB_BITS)) & (SUB_BUCKETS - 1);
+        return static_cast<size_t>(e - SUB_BITS + 1) * SUB_BUCKETS + sub;
+    }
+
+    // bucket 에 들어가는 가장 큰 값
+    static uint64_t bucket_upper(size_t b) {
+        if (b < SUB_BUCKETS) return b;
+        int e = static_cast<int>(b / SUB_BUCKETS) + SUB_BITS - 1;
+        uint64_t sub = b % SUB_BUCKETS;
+        uint64_t lo = (SUB_BUCKETS + sub) << (e - SUB_BITS);
+        return lo + ((1ull << (e - SUB_BITS)) - 1);
+    }
+
+    void merge_into(StatsSnapshot::Histogram& out) const {
+        if (out.buckets.size() != BUCKETS) out.buckets.assign(BUCKETS, 0);
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            const Shard* s = _shards[i].load(std::memory_order_acquire);
+            if (!s) continue;
+            for (size_t b = 0; b < BUCKETS; ++b) {
+                uint64_t n = s->buckets[b].load(std::memory_order_relaxed);
+                out.buckets[b] += n;
+                out.count += n;
+            }
+            out.sum += s->sum.load(std::memory_order_relaxed);
+        }
+    }
+
+    StatsSnapshot::Histogram snapshot() const {
+        StatsSnapshot::Histogram h;
+        merge_into(h);
+        return h;
+    }
+
+    void reset() {
+        for (size_t i = 0; i < STATS_MAX_THREADS; ++i) {
+            Shard* s = _shards[i].load(std::memory_order_acquire);
+            if (!s) continue;
+            for (size_t b = 0; b < BUCKETS; ++b) {
+                s->buckets[b].store(0, std::memory_order_relaxed);
+            }
+            s->sum.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    const std::string& name() const { return _name; }
+
+private:
+    struct alignas(STATS_CACHE_LINE) Shard {
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> buckets[BUCKETS];
+        Shard() : sum(0) {
+            for (size_t b = 0; b < BUCKETS; ++b) buckets[b].store(0, std::memory_order_relaxed);
+        }
+    };
+
+    Shard* shard() {
+        size_t slot = stats_thread_slot();
+        Shard* s = _shards[slot].load(std::memory_order_acquire);
+        if (s) return s;
+        Shard* created = new (stats_aligned_alloc(sizeof(Shard))) Shard();
+        if (_shards[slot].compare_exchange_strong(s, created, std::memory_order_acq_rel)) {
+            return created;
+        }
+        // MAX_THREADS 를 넘어 shard 를 나눠 쓰는 스레드가 먼저 만듦
+        created->~Shard();
+        free(created);
+        return s;
+    }
+
+    std::string _name;
+    std::atomic<Shard*> _shards[STATS_MAX_THREADS];
+};
+
+inline uint64_t StatsSnapshot::Histogram::percentile(double p) const {
+    if (count == 0) return 0;
+    uint64_t target = static_cast<uint64_t>(count * (p / 100.0) + 0.5);
+    if (target == 0) target = 1;
+    uint64_t seen = 0;
+    for (size_t b = 0; b < buckets.size(); ++b) {
+        seen += buckets[b];
+        if (seen >= target) return StatsHistogram::bucket_upper(b);
+    }
+    return max();
+}
+
+inline uint64_t StatsSnapshot::Histogram::max() const {
+    for (size_t b = buckets.size(); b > 0; --b) {
+        if (buckets[b - 1]) return StatsHistogram::bucket_upper(b - 1);
+    }
+    return 0;
+}
+
+inline std::string StatsSnapshot::to_string() const {
+    std::ostringstream os;
+    for (const auto& kv : counters) {
+        os << kv.first << " " << kv.second << "\n";
+    }
+    for (const auto& kv : histograms) {
+        const Histogram& h = kv.second;
+        os << kv.first << " count=" << h.count << " mean=" << static_cast<uint64_t>(h.mean())
+           << " p50=" << h.percentile(50) << " p99=" << h.percentile(99)
+           << " p99.9=" << h.percentile(99.9) << " max=" << h.max() << "\n";
+    }
+    return os.str();
+}
+
+inline bool stats_name_matches(const std::string& name, const std::string& prefix) {
+    return prefix.empty() || name.compare(0, prefix.size(), prefix) == 0;
+}
+
+inline StatsSnapshot StatsRegistry::snapshot(const std::string& prefix) {
+    StatsSnapshot snap;
+    std::lock_guard<std::mutex> g(_mu);
+    for (StatsCounter* c : _counters) {
+        if (stats_name_matches(c->name(), prefix)) snap.counters[c->name()] += c->value();
+    }
+    for (StatsHistogram* h : _histograms) {
+        if (stats_name_matches(h->name(), prefix)) h->merge_into(snap.histograms[h->name()]);
+    }
+    return snap;
+}
+
+inline void StatsRegistry::reset_all() {
+    std::lock_guard<std::mutex> g(_mu);
+    for (StatsCounter* c : _counters) c->reset();
+    for (StatsHistogram* h : _histograms) h->reset();
+}
+
+inline void StatsRegistry::reset(const std::string& prefix) {
+    std::lock_guard<std::mutex> g(_mu);
+    for (StatsCounter* c : _counters) {
+        if (stats_name_matches(c->name(), prefix)) c->reset();
+    }
+    for (StatsHistogram* h : _histograms) {
+        if (stats_name_matches(h->name(), prefix)) h->reset();
+    }
+}
+
+} // namespace SimplePubSub
@@ -0,0 +1,34 @@
+#pragma once
+
+/**
+ * USDT (user statically defined tracing) probe
+ *
+ * 운영 중인 프로세스를 다시 빌드하지 않고 perf / bpftrace / systemtap 으로 hot path 를 볼 수 있게
+ * 주요 지점에 provider "t2ma" 의 probe 를 둔다. probe 는 nop 한 개 + ELF note 라서 attach 하지 않으면
+ * 비용이 거의 없다 (인자 계산도 레지스터 이동 정도).
+ *
+ *   publish          (first_seq, count)             SimplePublisherV2::deliver_batch 진입
+ *   db_put           (first_seq, count, ok)         MessageDB::put_batch 한 구간 (ok: 1/0)
+ *   recovery_start   (client_id, from_seq, to_seq)  begin_recovery / hot tail / range fetch
+ *   recovery_end     (client_id, last_seq)          finish_recovery (client 를 되돌려 보내기 직전)
+ *   master_update    (record)                       HashMaster / SlabMemoryMaster::end_record_update
+ *   mq_receive       (count, first_size)            MQReader::drain 에서 메시지를 받았을 때
+ *
+ * 예) perf probe -x ./T2MA_JAPAN_EQUITY sdt_t2ma:publish && perf record -e sdt_t2ma:publish -a
+ *     bpftrace -e 'usdt:./T2MA_JAPAN_EQUITY:t2ma:db_put { @[arg2] = count(); }'
+ *
+ * <sys/sdt.h> (systemtap-sdt-devel) 가 있고 ENABLE_USDT 이면 CMake 가 HAVE_SYS_SDT_H 를 정의한다.
+ * 없으면 모든 T2MA_TRACE* 는 아무것도 하지 않는다 (인자도 평가하지 않음).
+ * 인자는 정수 / 포인터만 (sdt.h 의 operand 제약), 개수별 매크로는 오래된 sdt.h 에도 있는 DTRACE_PROBEn 을 쓴다.
+ */
+
+#if defined(HAVE_SYS_SDT_H)
+#include <sys/sdt.h>
+#define T2MA_TRACE1(name, a1) DTRACE_PROBE1(t2ma, name, a1)
+#define T2MA_TRACE2(name, a1, a2) DTRACE_PROBE2(t2ma, name, a1, a2)
+#define T2MA_TRACE3(name, a1, a2, a3) DTRACE_PROBE3(t2ma, name, a1, a2, a3)
+#else
+#define T2MA_TRACE1(name, a1) do {} while (0)
+#define T2MA_TRACE2(name, a1, a2) do {} while (0)
+#define T2MA_TRACE3(name, a1, a2, a3) do {} while (0)
+#endif
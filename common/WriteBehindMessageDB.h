@@ -0,0 +1,473 @@
+#ifndef WRITE_BEHIND_MESSAGE_DB_H
+#define WRITE_BEHIND_MESSAGE_DB_H
+
+#include "MessageDB.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <algorithm>
+#include <cstring>
+
+// durable watermark 가 뒤쳐졌을 때 put 의 동작
+enum class DurableLagMode {
+    BLOCK,      // 한도 안으로 들어올 때까지 put 이 기다린다 (crash 시 잃는 양이 한도로 제한됨)
+    WARN        // 기다리지 않고 계속 쌓는다 (넘을 때 한번 경고)
+};
+
+struct DurableLagPolicy {
+    uint32_t max_lag_messages;  // durable_seq 가 max_seq 보다 뒤쳐질 수 있는 메시지 수
+    size_t max_lag_bytes;       // 아직 기록하지 않은 tail 의 최대 bytes
+    DurableLagMode mode;
+
+    DurableLagPolicy(uint32_t messages = 100000, size_t bytes = 64 * 1024 * 1024,
+                     DurableLagMode m = DurableLagMode::BLOCK)
+        : max_lag_messages(messages), max_lag_bytes(bytes), mode(m) {}
+};
+
+/**
+ * WriteBehindMessageDB - 다른 MessageDB 앞에서 put 을 메모리 tail 에 받아두고 백그라운드 writer 가 내려쓰는 wrapper
+ *
+ * put / put_batch 는 tail 버퍼에 복사하고 sequence 만 정한 뒤 바로 돌아온다 (publish 경로에 파일 I/O 없음).
+ * writer 스레드는 쌓인 tail 을 통째로 넘겨받아 내부 DB 에 put_batch 하고, 넘긴 만큼 written_seq 를 올린다.
+ * durable_seq 는 내부 DB 의 durable_max_seq (내부 DB 가 파일에 내린 곳, 압축 DB_SAM 의 대기 block 은 제외) 다.
+ *  - tail 은 채우는 버퍼 / 기록 중인 버퍼 두 개를 번갈아 쓴다 (clear 후 capacity 재사용, 메시지별 할당 없음).
+ *  - written_seq 이하는 내부 DB 에서, 그 뒤 (아직 넘기기 전) 는 tail 에서 읽는다 (get / get_range).
+ *    get_direct / get_data_region 은 written 구간만 내부 DB 로 넘긴다.
+ *  - durable_seq 가 written_seq 보다 뒤면 writer 가 RETRY_DELAY_MS 마다 내부 DB 의 flush_if_stale 를 불러 올린다.
+ *  - DurableLagPolicy 로 durable_seq 가 뒤쳐질 수 있는 한도를 정한다 (BLOCK: put 이 기다림, WARN: 경고만).
+ *    내부 DB 기록이 실패하는 동안에는 BLOCK 이라도 기다리지 않는다 (실패한 구간은 writer 가 재시도).
+ *  - close 는 tail 을 모두 기록한 뒤 내부 DB 를 닫는다. crash 시에는 durable_seq 이후가 유실된다.
+ *    (BLOCK 모드 put 은 내부 DB 버퍼가 내려갈 때까지, 최대 내부 DB 의 flush 지연만큼 기다릴 수 있다)
+ * 내부 DB 의 sequence 는 이 wrapper 로만 늘어나야 한다 (open 시 내부 DB 의 next sequence 부터 이어감).
+ */
+class WriteBehindMessageDB : public MessageDB {
+private:
+    struct TailBuffer {
+        std::vector<char> data;
+        std::vector<SAM_INDEX> index;   // _seek = data 안 위치
+        size_t done;                    // 앞에서부터 내부 DB 에 기록된 entry 수
+
+        TailBuffer() : done(0) {}
+        bool empty() const { return done >= index.size(); }
+        void clear() { data.clear(); index.clear(); done = 0; }
+        const SAM_INDEX* find(uint32_t seq) const {
+            if (empty() || seq < index[done]._seq) return nullptr;
+            size_t pos = seq - index.front()._seq;
+            return pos < index.size() ? &index[pos] : nullptr;
+        }
+    };
+
+    enum { RETRY_DELAY_MS = 100, SHUTDOWN_RETRIES = 3 };
+
+    std::unique_ptr<MessageDB> _inner;
+    DurableLagPolicy _policy;
+
+    mutable std::mutex _mu;                 // tail 버퍼 / writer 상태
+    std::condition_variable _work_cv;       // writer 깨움
+    mutable std::condition_variable _space_cv;  // BLOCK 모드 put / wait_durable 깨움
+    TailBuffer _fill;                       // put 이 채우는 버퍼
+    TailBuffer _flushing;                   // writer 가 기록 중인 버퍼
+    std::vector<MessageSlice> _slices;      // writer 전용
+    bool _failing;
+    bool _lag_warned;
+
+    std::atomic<uint32_t> _next_seq;
+    std::atomic<uint32_t> _written_seq;     // 내부 DB 에 넘긴 마지막 sequence (읽기 경로 선택)
+    std::atomic<uint32_t> _durable_seq;     // 내부 DB 가 파일에 내린 마지막 sequence (lag 정책 / wait_durable)
+    std::atomic<bool> _running;
+    std::atomic<bool> _is_open;
+    std::thread _writer;
+    std::atomic<uint64_t> _write_failures;
+    std::atomic<uint64_t> _blocked_puts;
+
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+    }
+
+    // 아직 내부 DB 에 넘기지 않은 tail 메시지 수
+    uint32_t tail_messages() const {
+        return _next_seq.load(std::memory_order_relaxed) - 1 - _written_seq.load(std::memory_order_relaxed);
+    }
+    // 파일에 내려가지 않은 메시지 수 (tail + 내부 DB 버퍼)
+    uint32_t lag_messages() const {
+        return _next_seq.load(std::memory_order_relaxed) - 1 - _durable_seq.load(std::memory_order_relaxed);
+    }
+    size_t lag_bytes() const { return _fill.data.size() + _flushing.data.size(); }
+    // 기록 대기가 없으면 한도보다 큰 batch 도 받는다
+    bool over_limit(size_t incoming) const {
+        uint32_t lag = lag_messages();
+        return lag > 0 && (lag >= _policy.max_lag_messages || lag_bytes() + incoming > _policy.max_lag_bytes);
+    }
+
+    // _flushing 의 남은 entry 를 같은 timestamp 끼리 묶어 내부 DB 에 기록 (_mu 밖에서 호출, _flushing 은 writer 만 바꿈)
+    bool write_out() {
+        const std::vector<SAM_INDEX>& index = _flushing.index;
+        size_t i = _flushing.done;
+        while (i < index.size()) {
+            size_t j = i;
+            _slices.clear();
+            while (j < index.size() && index[j]._timestamp == index[i]._timestamp) {
+                _slices.push_back(MessageSlice{_flushing.data.data() + index[j]._seek, index[j]._size});
+                j++;
+            }
+            if (!_inner->put_batch(_slices.data(), _slices.size(), index[i]._timestamp)) {
+                return false;
+            }
+            i = j;
+        }
+        return true;
+    }
+
+    // 내부 DB 의 durable 을 다시 읽어 올리고 기다리는 put / wait_durable 을 깨움 (_mu 를 잡은 상태에서 호출)
+    void update_durable(std::unique_lock<std::mutex>& lock) {
+        lock.unlock();
+        uint32_t durable = _inner->durable_max_seq();
+        lock.lock();
+        _durable_seq.store(durable, std::memory_order_release);
+        _space_cv.notify_all();
+    }
+
+    void writer_loop() {
+        std::unique_lock<std::mutex> lock(_mu);
+        int shutdown_retries = 0;
+        auto has_work = [this] { return !_fill.empty() || !_running.load(); };
+        while (true) {
+            if (_flushing.empty()) {
+                _flushing.clear();
+                if (_durable_seq.load() < _written_seq.load()) {
+                    // 내부 DB 가 버퍼에 들고 있는 구간은 새 tail 이 없어도 flush_if_stale 로 내린다
+                    if (!_work_cv.wait_for(lock, std::chrono::milliseconds(RETRY_DELAY_MS), has_work)) {
+                        lock.unlock();
+                        _inner->flush_if_stale();
+                        lock.lock();
+                        update_durable(lock);
+                        continue;
+                    }
+                } else {
+                    _work_cv.wait(lock, has_work);
+                }
+                if (_fill.empty()) {
+                    break;      // 종료 요청 + 남은 tail 없음
+                }
+                std::swap(_fill, _flushing);
+            }
+
+            lock.unlock();
+            bool ok = write_out();
+            // 실패해도 내부 DB 가 일부 받았을 수 있으므로 내부 DB 의 sequence 로 written 을 정한다
+            uint32_t written = _inner->get_next_sequence() - 1;
+            lock.lock();
+
+            while (_flushing.done < _flushing.index.size() && _flushing.index[_flushing.done]._seq <= written) {
+                _flushing.done++;
+            }
+            _written_seq.store(written, std::memory_order_release);
+            if (_flushing.empty()) {
+                _flushing.clear();
+            }
+            _failing = !ok;
+            update_durable(lock);
+            if (!ok) {
+                _write_failures++;
+                std::cerr << "WriteBehindMessageDB: write failed at seq " << written + 1 << ", retrying" << std::endl;
+                if (!_running.load() && ++shutdown_retries >= SHUTDOWN_RETRIES) {
+                    std::cerr << "WriteBehindMessageDB: giving up, " << tail_messages()
+                              << " messages were not written" << std::endl;
+                    break;
+                }
+                lock.unlock();
+                std::this_thread::sleep_for(std::chrono::milliseconds(RETRY_DELAY_MS));
+                lock.lock();
+            }
+        }
+    }
+
+    // tail 에서 seq 찾기 (_mu 를 잡은 상태)
+    bool tail_find(uint32_t seq, SAM_INDEX& index, const char*& data) const {
+        const TailBuffer* buffers[2] = {&_flushing, &_fill};
+        for (const TailBuffer* b : buffers) {
+            const SAM_INDEX* e = b->find(seq);
+            if (e) {
+                index = *e;
+                data = b->data.data() + e->_seek;
+                return true;
+            }
+        }
+        return false;
+    }
+
+public:
+    WriteBehindMessageDB(std::unique_ptr<MessageDB> inner, const DurableLagPolicy& policy = DurableLagPolicy())
+        : _inner(std::move(inner)), _policy(policy), _failing(false), _lag_warned(false),
+          _next_seq(1), _written_seq(0), _durable_seq(0), _running(false), _is_open(false), _write_failures(0), _blocked_puts(0) {
+        if (_policy.max_lag_messages == 0) _policy.max_lag_messages = 1;
+    }
+
+    virtual ~WriteBehindMessageDB() {
+        close();
+    }
+
+    bool open() override {
+        if (_is_open.load()) {
+            return true;
+        }
+        if (!_inner->open()) {
+            return false;
+        }
+        uint32_t next = _inner->get_next_sequence();
+        _next_seq.store(next);
+        _written_seq.store(next - 1);
+        _durable_seq.store(_inner->durable_max_seq());
+        _running.store(true);
+        _writer = std::thread(&WriteBehindMessageDB::writer_loop, this);
+        _is_open.store(true);
+        return true;
+    }
+
+    // tail 을 모두 기록하고 내부 DB 를 닫는다
+    void close() override {
+        if (!_is_open.exchange(false)) {
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> g(_mu);
+            _running.store(false);
+        }
+        _work_cv.notify_all();
+        _space_cv.notify_all();
+        if (_writer.joinable()) {
+            _writer.join();
+        }
+        // 내부 DB 의 close 가 남은 버퍼까지 기록한다
+        _inner->close();
+        _durable_seq.store(_written_seq.load(), std::memory_order_release);
+    }
+
+    bool isOpen() const override { return _is_open.load(); }
+
+    bool put(const void* data, size_t size) override {
+        return put(data, size, now_ns());
+    }
+
+    bool put(const void* data, size_t size, uint64_t timestamp) override {
+        MessageSlice item = {data, size};
+        return put_batch(&item, 1, timestamp);
+    }
+
+    bool put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) override {
+        if (!_is_open.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        size_t bytes = 0;
+        for (size_t i = 0; i < count; ++i) {
+            bytes += items[i].size;
+        }
+
+        std::unique_lock<std::mutex> lock(_mu);
+        if (over_limit(bytes)) {
+            if (_policy.mode == DurableLagMode::BLOCK && !_failing) {
+                _blocked_puts++;
+                _space_cv.wait(lock, [&] { return !over_limit(bytes) || _failing || !_running.load(); });
+            }
+            if (over_limit(bytes) && !_lag_warned) {
+                _lag_warned = true;
+                std::cerr << "WriteBehindMessageDB: durable watermark is " << lag_messages() << " messages / "
+                          << lag_bytes() << " bytes behind" << std::endl;
+            }
+        } else {
+            _lag_warned = false;
+        }
+
+        bool wake = _fill.empty();
+        uint32_t seq = _next_seq.load(std::memory_order_relaxed);
+        for (size_t i = 0; i < count; ++i) {
+            SAM_INDEX index;
+            index._seek = static_cast<int64_t>(_fill.data.size());
+            index._size = static_cast<uint32_t>(items[i].size);
+            index._seq = seq++;
+            index._timestamp = timestamp;
+            const char* p = static_cast<const char*>(items[i].data);
+            _fill.data.insert(_fill.data.end(), p, p + items[i].size);
+            _fill.index.push_back(index);
+        }
+        _next_seq.store(seq, std::memory_order_release);
+        lock.unlock();
+        if (wake) {
+            _work_cv.notify_one();
+        }
+        return true;
+    }
+
+    bool get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_size) const override {
+        if (seq <= _written_seq.load(std::memory_order_acquire)) {
+            return _inner->get(seq, index, buffer, buffer_size);
+        }
+        std::lock_guard<std::mutex> g(_mu);
+        const char* p = nullptr;
+        if (seq <= _written_seq.load(std::memory_order_acquire)) {
+            return _inner->get(seq, index, buffer, buffer_size);
+        }
+        if (!buffer_size || !tail_find(seq, index, p)) {
+            return false;
+        }
+        memcpy(buffer, p, index._size);
+        *buffer_size = index._size;
+        return true;
+    }
+
+    bool get(uint32_t seq, std::string& data) const override {
+        if (seq <= _written_seq.load(std::memory_order_acquire)) {
+            return _inner->get(seq, data);
+        }
+        std::lock_guard<std::mutex> g(_mu);
+        if (seq <= _written_seq.load(std::memory_order_acquire)) {
+            return _inner->get(seq, data);
+        }
+        SAM_INDEX index;
+        const char* p = nullptr;
+        if (!tail_find(seq, index, p)) {
+            return false;
+        }
+        data.assign(p, index._size);
+        return true;
+    }
+
+    bool get_index(uint32_t seq, SAM_INDEX& index) const override {
+        if (seq <= _written_seq.load(std::memory_order_acquire)) {
+            return _inner->get_index(seq, index);
+        }
+        std::lock_guard<std::mutex> g(_mu);
+        if (seq <= _written_seq.load(std::memory_order_acquire)) {
+            return _inner->get_index(seq, index);
+        }
+        const char* p = nullptr;
+        return tail_find(seq, index, p);
+    }
+
+    // 기록된 구간은 내부 DB 의 seek_time (SEGMENT_SAM 의 segment 탐색 등) 을 쓰고, 거기 없으면 tail 까지 이분 탐색
+    uint32_t seek_time(uint64_t timestamp) const override {
+        uint32_t seq = _inner->seek_time(timestamp);
+        return seq != 0 ? seq : MessageDB::seek_time(timestamp);
+    }
+
+    // 내부 DB 에 넘긴 구간만 내부 DB 포인터를 돌려준다 (tail 은 재사용되므로 nullptr)
+    const void* get_direct(uint32_t seq, SAM_INDEX& index) const override {
+        if (seq > _written_seq.load(std::memory_order_acquire)) {
+            return nullptr;
+        }
+        return _inner->get_direct(seq, index);
+    }
+
+    bool get_data_region(uint32_t start_seq, uint32_t end_seq, MessageDataRegion& region) const override {
+        uint32_t written = _written_seq.load(std::memory_order_acquire);
+        if (start_seq > written) {
+            return false;
+        }
+        return _inner->get_data_region(start_seq, std::min(end_seq, written), region);
+    }
+
+    uint32_t get_next_sequence() const override { return _next_seq.load(std::memory_order_acquire); }
+    uint32_t count() const override { return _inner->count() + tail_messages(); }
+    uint32_t max_seq() const override { return _next_seq.load(std::memory_order_acquire) - 1; }
+    // 내부 DB 가 비어 있으면 tail 의 첫 메시지부터
+    uint32_t min_seq() const override {
+        uint32_t oldest = _inner->min_seq();
+        if (oldest > 0 || tail_messages() == 0) return oldest;
+        return _written_seq.load(std::memory_order_acquire) + 1;
+    }
+    uint32_t durable_max_seq() const override { return _durable_seq.load(std::memory_order_acquire); }
+    // 내부 DB 버퍼는 writer 가 주기적으로 내리지만, 호출한 쪽 주기로도 바로 내릴 수 있게 넘긴다
+    bool flush_if_stale() override { return !_is_open.load() || _inner->flush_if_stale(); }
+
+    bool get_range(uint32_t start_seq, uint32_t end_seq,
+                   std::function<bool(uint32_t seq, const SAM_INDEX& index, const void* data, size_t size)> callback) const override {
+        if (!_is_open.load() || start_seq > end_seq) {
+            return false;
+        }
+        uint32_t oldest = _inner->min_seq();
+        if (oldest > 1 && start_seq < oldest) {
+            return false;   // 내부 DB 가 이미 지운 구간
+        }
+        uint32_t seq = start_seq;
+        bool stopped = false;
+        while (seq <= end_seq && !stopped) {
+            // 넘긴 구간은 내부 DB 에서 (그 사이 written 이 올라가면 다시 내부 DB 부터)
+            uint32_t written = _written_seq.load(std::memory_order_acquire);
+            if (seq <= written) {
+                uint32_t last = std::min(end_seq, written);
+                bool ranged = _inner->get_range(seq, last, [&](uint32_t s, const SAM_INDEX& index, const void* data, size_t size) {
+                    if (!callback(s, index, data, size)) {
+                        stopped = true;
+                        return false;
+                    }
+                    return true;
+                });
+                if (!ranged) {
+                    std::string data;
+                    for (uint32_t s = seq; s <= last && !stopped; ++s) {
+                        SAM_INDEX index;
+                        if (!_inner->get_index(s, index)) {
+                            index._seek = 0;
+                            index._timestamp = 0;
+                        }
+                        index._seq = s;
+                        if (_inner->get(s, data)) {
+                            index._size = static_cast<uint32_t>(data.size());
+                            stopped = !callback(s, index, data.data(), data.size());
+                        }
+                    }
+                }
+                seq = last + 1;
+                continue;
+            }
+
+            std::lock_guard<std::mutex> g(_mu);
+            if (seq <= _written_seq.load(std::memory_order_acquire)) {
+                continue;
+            }
+            SAM_INDEX index;
+            const char* p = nullptr;
+            for (; seq <= end_seq && tail_find(seq, index, p); ++seq) {
+                if (!callback(seq, index, p, index._size)) {
+                    stopped = true;
+                    break;
+                }
+            }
+            break;
+        }
+        return true;
+    }
+
+    bool verify_integrity() const override { return _inner->verify_integrity(); }
+    bool compact() override { return _inner->compact(); }
+    int64_t get_data_file_size() const override { return _inner->get_data_file_size(); }
+    int64_t get_index_file_size() const override { return _inner->get_index_file_size(); }
+
+    /* 내부 DB 가 파일에 내린 마지막 sequence (= durable_max_seq) */
+    uint32_t durable_seq() const { return _durable_seq.load(std::memory_order_acquire); }
+    /* durable_seq 까지 기다림 (timeout_ms 0: 무한), 성공 여부 */
+    bool wait_durable(uint32_t seq, uint32_t timeout_ms = 0) const {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+        std::unique_lock<std::mutex> lock(_mu);
+        auto done = [&] { return _durable_seq.load() >= seq || !_running.load(); };
+        if (timeout_ms == 0) {
+            _space_cv.wait(lock, done);
+        } else {
+            _space_cv.wait_until(lock, deadline, done);
+        }
+        return _durable_seq.load() >= seq;
+    }
+
+    MessageDB* inner() { return _inner.get(); }
+    const DurableLagPolicy& policy() const { return _policy; }
+    uint64_t get_write_failures() const { return _write_failures.load(); }
+    uint64_t get_blocked_puts() const { return _blocked_puts.load(); }
+};
+
+#endif // WRITE_BEHIND_MESSAGE_DB_H
@@ -2,8 +2,23 @@
 #include <iostream>
 #include <cstring>
 #include <vector>
+#include <chrono>
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
+#include <unistd.h>
+
+namespace {
+const int64_t BLOCK_IN_OFFSET_MASK = (static_cast<int64_t>(1) << DB_SAM_BLOCK_OFFSET_BITS) - 1;
+
+uint64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+}
 
 DB_SAM::DB_SAM(const std::string& base_path) 
     : base_path_(base_path)
@@ -11,13 +26,43 @@ DB_SAM::DB_SAM(const std::string& base_path)
     , data_file_path_(base_path + ".data")
     , message_count_(0)
     , next_sequence_(1)
-    , is_open_(false) {
+    , index_chunks_(new std::atomic<SAM_INDEX*>[DB_SAM_INDEX_MAX_CHUNKS])
+    , mapped_chunks_(DB_SAM_INDEX_MAX_CHUNKS, false)
+    , is_open_(false)
+    , read_only_(false)
+    , codec_(BLOCK_CODEC_NONE)
+    , block_size_(DB_SAM_BLOCK_SIZE)
+    , compressed_(false)
+    , block_offset_(0)
+    , block_started_ms_(0)
+    , unsynced_since_ms_(0)
+    , durable_seq_(0)
+    , cache_offset_(-1) {
+    for (size_t i = 0; i < DB_SAM_INDEX_MAX_CHUNKS; ++i) {
+        index_chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
 }
 
 DB_SAM::~DB_SAM() {
     close();
 }
 
+void DB_SAM::set_compression(BlockCodec codec, size_t block_size) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_open_) {
+        std::cerr << "DB_SAM: set_compression must be called before open" << std::endl;
+        return;
+    }
+    if (!block_codec_available(codec)) {
+        std::cerr << "DB_SAM: codec " << block_codec_name(codec) << " is not available in this build, "
+                  << "blocks will be stored uncompressed" << std::endl;
+    }
+    codec_ = codec;
+    // block 안 위치가 _seek 하위 DB_SAM_BLOCK_OFFSET_BITS 에 들어가야 한다
+    size_t max_block = static_cast<size_t>(BLOCK_IN_OFFSET_MASK) + 1;
+    block_size_ = std::max<size_t>(4096, std::min(block_size, max_block));
+}
+
 bool DB_SAM::open() {
     std::lock_guard<std::mutex> lock(mutex_);
     
@@ -27,7 +72,7 @@ bool DB_SAM::open() {
     
     // Create directory if it doesn't exist (basic implementation for C++11)
     size_t last_slash = base_path_.find_last_of('/');
-    if (last_slash != std::string::npos) {
+    if (!read_only_ && last_slash != std::string::npos) {
         std::string dir_path = base_path_.substr(0, last_slash);
         if (!dir_path.empty()) {
             mkdir(dir_path.c_str(), 0755);
@@ -37,18 +82,17 @@ bool DB_SAM::open() {
     if (!open_files()) {
         return false;
     }
+    // 읽기 전용이면 block tail 을 고치지 않는다 (인덱스가 가리키는 block 만 읽음)
+    if (!detect_format() || (!read_only_ && !(compressed_ ? repair_block_tail() : repair_raw_tail()))) {
+        close_files();
+        return false;
+    }
     
-    // Read existing index to get message count and next sequence
-    index_file_.seekg(0, std::ios::end);
-    size_t index_size = index_file_.tellg();
-    message_count_ = index_size / sizeof(SAM_INDEX);
-    
-    if (message_count_ > 0) {
-        // Read the last index entry to get the next sequence
-        SAM_INDEX last_index;
-        index_file_.seekg(-static_cast<int>(sizeof(SAM_INDEX)), std::ios::end);
-        index_file_.read(reinterpret_cast<char*>(&last_index), sizeof(SAM_INDEX));
-        next_sequence_ = last_index._seq + 1;
+    // 기존 인덱스를 메모리로 읽어 message count / next sequence 결정
+    if (!load_index()) {
+        free_index();
+        close_files();
+        return false;
     }
     
     // Position at end for appending
@@ -56,6 +100,12 @@ bool DB_SAM::open() {
     index_file_.seekp(0, std::ios::end);
     data_file_.clear();
     data_file_.seekp(0, std::ios::end);
+    if (compressed_) {
+        block_offset_ = data_file_.tellp();
+        cache_offset_ = -1;
+        std::cout << "DB_SAM: " << data_file_path_ << " block compressed (" << block_codec_name(codec_)
+                  << ", block " << block_size_ << " bytes)" << std::endl;
+    }
     
     is_open_ = true;
     return true;
@@ -65,12 +115,113 @@ void DB_SAM::close() {
     std::lock_guard<std::mutex> lock(mutex_);
     
     if (is_open_) {
+        if (compressed_ && !read_only_ && !flush_block()) {
+            std::cerr << "DB_SAM: failed to write last block of " << data_file_path_ << std::endl;
+        }
+        block_buf_.clear();
+        block_index_.clear();
+        cache_offset_ = -1;
         close_files();
         is_open_ = false;
+        free_index();
+    }
+}
+
+SAM_INDEX* DB_SAM::index_entry(size_t pos) const {
+    SAM_INDEX* base = index_chunks_[pos / DB_SAM_INDEX_CHUNK_ENTRIES].load(std::memory_order_acquire);
+    if (!base) return nullptr;
+    return base + (pos % DB_SAM_INDEX_CHUNK_ENTRIES);
+}
+
+bool DB_SAM::set_index_entry(size_t pos, const SAM_INDEX& index) {
+    size_t chunk_no = pos / DB_SAM_INDEX_CHUNK_ENTRIES;
+    if (chunk_no >= DB_SAM_INDEX_MAX_CHUNKS) {
+        std::cerr << "DB_SAM: in-memory index is full (" << pos << " entries) for " << base_path_ << std::endl;
+        return false;
+    }
+    SAM_INDEX* base = index_chunks_[chunk_no].load(std::memory_order_relaxed);
+    if (!base) {
+        base = new SAM_INDEX[DB_SAM_INDEX_CHUNK_ENTRIES];
+        index_chunks_[chunk_no].store(base, std::memory_order_release);
+    }
+    base[pos % DB_SAM_INDEX_CHUNK_ENTRIES] = index;
+    return true;
+}
+
+bool DB_SAM::load_index() {
+    index_file_.clear();
+    index_file_.seekg(0, std::ios::end);
+    size_t count = static_cast<size_t>(index_file_.tellg()) / sizeof(SAM_INDEX);
+    if (count > static_cast<size_t>(DB_SAM_INDEX_CHUNK_ENTRIES) * DB_SAM_INDEX_MAX_CHUNKS) {
+        std::cerr << "DB_SAM: " << index_file_path_ << " has more entries (" << count
+                  << ") than the in-memory index can hold" << std::endl;
+        return false;
+    }
+
+    // 꽉 찬 chunk 는 다시 쓰지 않으므로 (set_index_entry 는 count 이후만) 파일을 그대로 mmap 해서 쓴다.
+    // open 은 파일 크기와 상관없이 mmap 몇 번이고, page 는 조회할 때 page cache 에서 들어온다.
+    // 마지막 (덜 찬) chunk 만 heap 으로 읽어 이후 put 이 이어 쓴다
+    size_t full_chunks = count / DB_SAM_INDEX_CHUNK_ENTRIES;
+    const size_t chunk_bytes = DB_SAM_INDEX_CHUNK_ENTRIES * sizeof(SAM_INDEX);
+    if (full_chunks > 0) {
+        int fd = ::open(index_file_path_.c_str(), O_RDONLY);
+        if (fd < 0) {
+            std::cerr << "DB_SAM: failed to open " << index_file_path_ << " for mmap: " << strerror(errno) << std::endl;
+            return false;
+        }
+        for (size_t chunk = 0; chunk < full_chunks; ++chunk) {
+            void* p = mmap(nullptr, chunk_bytes, PROT_READ, MAP_PRIVATE, fd, static_cast<off_t>(chunk * chunk_bytes));
+            if (p == MAP_FAILED) {
+                std::cerr << "DB_SAM: failed to mmap " << index_file_path_ << ": " << strerror(errno) << std::endl;
+                ::close(fd);
+                return false;
+            }
+            mapped_chunks_[chunk] = true;
+            index_chunks_[chunk].store(static_cast<SAM_INDEX*>(p), std::memory_order_release);
+        }
+        ::close(fd);
+    }
+    size_t tail = count - full_chunks * DB_SAM_INDEX_CHUNK_ENTRIES;
+    if (tail > 0) {
+        SAM_INDEX* base = new SAM_INDEX[DB_SAM_INDEX_CHUNK_ENTRIES];
+        index_chunks_[full_chunks].store(base, std::memory_order_release);
+        index_file_.seekg(static_cast<std::streamoff>(full_chunks * chunk_bytes), std::ios::beg);
+        index_file_.read(reinterpret_cast<char*>(base), tail * sizeof(SAM_INDEX));
+        if (index_file_.fail()) {
+            std::cerr << "DB_SAM: failed to read " << index_file_path_ << std::endl;
+            return false;
+        }
+    }
+    index_file_.clear();
+
+    next_sequence_.store(count > 0 ? index_entry(count - 1)->_seq + 1 : 1, std::memory_order_relaxed);
+    message_count_.store(static_cast<uint32_t>(count), std::memory_order_release);
+    durable_seq_.store(next_sequence_.load(std::memory_order_relaxed) - 1, std::memory_order_release);
+    return true;
+}
+
+void DB_SAM::free_index() {
+    message_count_.store(0, std::memory_order_release);
+    next_sequence_.store(1, std::memory_order_relaxed);
+    durable_seq_.store(0, std::memory_order_release);
+    for (size_t i = 0; i < DB_SAM_INDEX_MAX_CHUNKS; ++i) {
+        SAM_INDEX* base = index_chunks_[i].exchange(nullptr);
+        if (mapped_chunks_[i]) {
+            munmap(base, DB_SAM_INDEX_CHUNK_ENTRIES * sizeof(SAM_INDEX));
+            mapped_chunks_[i] = false;
+        } else {
+            delete[] base;
+        }
     }
 }
 
 bool DB_SAM::open_files() {
+    if (read_only_) {
+        index_file_.open(index_file_path_, std::ios::in | std::ios::binary);
+        data_file_.open(data_file_path_, std::ios::in | std::ios::binary);
+        return index_file_.is_open() && data_file_.is_open();
+    }
+    
     // Open index file
     index_file_.open(index_file_path_, std::ios::in | std::ios::out | std::ios::binary);
     if (!index_file_.is_open()) {
@@ -112,9 +263,36 @@ bool DB_SAM::sync_files() {
     if (data_file_.is_open()) {
         data_file_.flush();
     }
+    if (index_file_.fail() || data_file_.fail()) {
+        return false;
+    }
+    // 압축 모드는 flush_block 이 block 을 비운 뒤에만 부르므로 기록 대기 메시지가 없다
+    unsynced_since_ms_ = 0;
+    durable_seq_.store(next_sequence_.load(std::memory_order_relaxed) - 1, std::memory_order_release);
     return true;
 }
 
+bool DB_SAM::flush_if_stale() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_open_ || read_only_) {
+        return true;
+    }
+    if (compressed_) {
+        return block_index_.empty() || now_ms() - block_started_ms_ < DB_SAM_BLOCK_MAX_DELAY_MS || flush_block();
+    }
+    return unsynced_since_ms_ == 0 || now_ms() - unsynced_since_ms_ < DB_SAM_BLOCK_MAX_DELAY_MS || sync_files();
+}
+
+void DB_SAM::set_read_only(bool read_only) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (is_open_) {
+        std::cerr << "DB_SAM: set_read_only must be called before open" << std::endl;
+        return;
+    }
+    read_only_ = read_only;
+}
+
 bool DB_SAM::put(const void* data, size_t size) {
     return put(data, size, std::chrono::duration_cast<std::chrono::nanoseconds>(
         std::chrono::high_resolution_clock::now().time_since_epoch()).count());
@@ -123,9 +301,15 @@ bool DB_SAM::put(const void* data, size_t size) {
 bool DB_SAM::put(const void* data, size_t size, uint64_t timestamp) {
     std::lock_guard<std::mutex> lock(mutex_);
     
-    if (!is_open_) {
+    if (!is_open_ || read_only_) {
         return false;
     }
+    if (compressed_) {
+        if (!append_to_block(data, size, timestamp)) {
+            return false;
+        }
+        return now_ms() - block_started_ms_ < DB_SAM_BLOCK_MAX_DELAY_MS || flush_block();
+    }
     
     // Get current data file position
     data_file_.seekp(0, std::ios::end);
@@ -145,38 +329,107 @@ bool DB_SAM::put(const void* data, size_t size, uint64_t timestamp) {
     index._timestamp = timestamp;
     
     // Write index entry
-    if (!write_index(index)) {
+    uint32_t count = message_count_.load(std::memory_order_relaxed);
+    if (!write_index(index) || !set_index_entry(count, index)) {
         return false;
     }
     
-    message_count_++;
-    next_sequence_++;
+    next_sequence_.store(index._seq + 1, std::memory_order_relaxed);
+    message_count_.store(count + 1, std::memory_order_release);
     
-    // Sync every 100 messages
-    if (message_count_ % 100 == 0) {
+    // Sync every 100 messages (나머지는 flush_if_stale 가 DB_SAM_BLOCK_MAX_DELAY_MS 안에 내림)
+    if ((count + 1) % 100 == 0) {
         sync_files();
+    } else if (unsynced_since_ms_ == 0) {
+        unsynced_since_ms_ = now_ms();
     }
     
     return true;
 }
 
+bool DB_SAM::put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_open_ || read_only_) {
+        return false;
+    }
+    if (count == 0) {
+        return true;
+    }
+    if (compressed_) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!append_to_block(items[i].data, items[i].size, timestamp)) {
+                return false;
+            }
+        }
+        return now_ms() - block_started_ms_ < DB_SAM_BLOCK_MAX_DELAY_MS || flush_block();
+    }
+
+    data_file_.seekp(0, std::ios::end);
+    int64_t data_position = data_file_.tellp();
+
+    // 인덱스는 모아서 한 번에 기록
+    std::vector<SAM_INDEX> indexes(count);
+    for (size_t i = 0; i < count; ++i) {
+        data_file_.write(static_cast<const char*>(items[i].data), items[i].size);
+        indexes[i]._seek = data_position;
+        indexes[i]._size = static_cast<uint32_t>(items[i].size);
+        indexes[i]._seq = next_sequence_ + static_cast<uint32_t>(i);
+        indexes[i]._timestamp = timestamp;
+        data_position += items[i].size;
+    }
+    if (data_file_.fail()) {
+        return false;
+    }
+
+    index_file_.seekp(0, std::ios::end);
+    index_file_.write(reinterpret_cast<const char*>(indexes.data()), count * sizeof(SAM_INDEX));
+    if (index_file_.fail()) {
+        return false;
+    }
+
+    uint32_t prev_count = message_count_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        if (!set_index_entry(prev_count + i, indexes[i])) {
+            return false;
+        }
+    }
+    uint32_t new_count = prev_count + static_cast<uint32_t>(count);
+    next_sequence_.store(indexes[count - 1]._seq + 1, std::memory_order_relaxed);
+    message_count_.store(new_count, std::memory_order_release);
+
+    // 100건 경계를 넘으면 sync (put과 동일한 주기)
+    if (prev_count / 100 != new_count / 100) {
+        sync_files();
+    } else if (unsynced_since_ms_ == 0) {
+        unsynced_since_ms_ = now_ms();
+    }
+
+    return true;
+}
+
 bool DB_SAM::write_index(const SAM_INDEX& index) {
+    // get/put 이 같은 fstream 위치를 쓰므로 (read_index 의 seekg) 항상 끝에서 append
+    index_file_.seekp(0, std::ios::end);
     index_file_.write(reinterpret_cast<const char*>(&index), sizeof(SAM_INDEX));
     return !index_file_.fail();
 }
 
 bool DB_SAM::read_index(uint32_t seq, SAM_INDEX& index) const {
-    if (seq < 1 || seq >= next_sequence_) {
+    return lookup_index(seq, index);
+}
+
+bool DB_SAM::lookup_index(uint32_t seq, SAM_INDEX& index) const {
+    // 기록 대기 block 의 인덱스도 메모리 인덱스에 들어 있다
+    if (seq < 1 || seq > message_count_.load(std::memory_order_acquire)) {
         return false;
     }
-    
-    // Calculate position in index file
-    size_t position = (seq - 1) * sizeof(SAM_INDEX);
-    
-    index_file_.seekg(position, std::ios::beg);
-    index_file_.read(reinterpret_cast<char*>(&index), sizeof(SAM_INDEX));
-    
-    return !index_file_.fail() && index._seq == seq;
+    const SAM_INDEX* e = index_entry(seq - 1);
+    if (!e) {
+        return false;
+    }
+    index = *e;
+    return index._seq == seq;
 }
 
 bool DB_SAM::get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_size) const {
@@ -196,6 +449,16 @@ bool DB_SAM::get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_
     //     *buffer_size = index._size;
     //     return false;
     // }
+
+    if (compressed_) {
+        const char* p = block_message(index);
+        if (!p) {
+            return false;
+        }
+        memcpy(buffer, p, index._size);
+        *buffer_size = index._size;
+        return true;
+    }
     
     // Read data
     data_file_.seekg(index._seek, std::ios::beg);
@@ -221,6 +484,15 @@ bool DB_SAM::get(uint32_t seq, std::string& data) const {
         return false;
     }
     
+    if (compressed_) {
+        const char* p = block_message(index);
+        if (!p) {
+            return false;
+        }
+        data.assign(p, index._size);
+        return true;
+    }
+
     // Resize string and read data
     data.resize(index._size);
     data_file_.seekg(index._seek, std::ios::beg);
@@ -244,6 +516,18 @@ bool DB_SAM::get_range(uint32_t start_seq, uint32_t end_seq,
         if (!read_index(seq, index)) {
             continue;
         }
+
+        if (compressed_) {
+            // 같은 block 의 메시지는 풀어둔 block 에서 바로 전달
+            const char* p = block_message(index);
+            if (!p) {
+                continue;
+            }
+            if (!callback(seq, index, p, index._size)) {
+                break;
+            }
+            continue;
+        }
         
         // Resize buffer if needed
         if (buffer.size() < index._size) {
@@ -267,6 +551,34 @@ bool DB_SAM::get_range(uint32_t start_seq, uint32_t end_seq,
     return true;
 }
 
+bool DB_SAM::get_data_region(uint32_t start_seq, uint32_t end_seq, MessageDataRegion& region) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    // 압축 block 은 파일 구간을 그대로 보낼 수 없다 (get_range 로 전송)
+    if (!is_open_ || compressed_ || start_seq < 1 || start_seq > end_seq) {
+        return false;
+    }
+    if (end_seq >= next_sequence_) {
+        end_seq = next_sequence_ - 1;
+    }
+
+    SAM_INDEX first, last;
+    if (!read_index(start_seq, first) || !read_index(end_seq, last)) {
+        return false;
+    }
+
+    // put은 항상 파일 끝에 append 하므로 [first, last] 데이터는 연속 구간이다.
+    // sendfile은 파일에서 직접 읽으므로 fstream 버퍼를 비워둔다.
+    data_file_.flush();
+
+    region.path = data_file_path_;
+    region.offset = first._seek;
+    region.length = last._seek + last._size - first._seek;
+    region.start_seq = start_seq;
+    region.end_seq = end_seq;
+    return region.length > 0;
+}
+
 bool DB_SAM::verify_integrity() const {
     std::lock_guard<std::mutex> lock(mutex_);
     
@@ -277,7 +589,7 @@ bool DB_SAM::verify_integrity() const {
     // Check if index and data files are consistent
     index_file_.seekg(0, std::ios::end);
     size_t index_size = index_file_.tellg();
-    uint32_t expected_count = index_size / sizeof(SAM_INDEX);
+    uint32_t expected_count = index_size / sizeof(SAM_INDEX) + static_cast<uint32_t>(block_index_.size());
     
     if (expected_count != message_count_) {
         return false;
@@ -293,6 +605,9 @@ bool DB_SAM::verify_integrity() const {
         if (index._seq != seq) {
             return false;
         }
+        if (compressed_ && !block_message(index)) {
+            return false;
+        }
     }
     
     return true;
@@ -327,20 +642,234 @@ int64_t DB_SAM::get_index_file_size() const {
 }
 
 uint32_t DB_SAM::max_seq() const {
-    std::lock_guard<std::mutex> lock(mutex_);
-
-    if (!is_open_ || message_count_ == 0) {
+    // 마지막 메모리 인덱스 엔트리의 시퀀스 번호 (락 없음)
+    uint32_t count = message_count_.load(std::memory_order_acquire);
+    if (!is_open_ || count == 0) {
         return 0;
     }
+    const SAM_INDEX* last = index_entry(count - 1);
+    return last ? last->_seq : count;
+}
+
+bool DB_SAM::read_block_header(int64_t offset, SAM_BLOCK_HEADER& header) const {
+    data_file_.clear();
+    data_file_.seekg(offset, std::ios::beg);
+    data_file_.read(reinterpret_cast<char*>(&header), sizeof(header));
+    return !data_file_.fail() && header._magic == DB_SAM_BLOCK_MAGIC;
+}
 
-    // 마지막 인덱스 엔트리를 읽어서 최대 시퀀스 번호 반환
-    SAM_INDEX last_index;
-    index_file_.seekg(-static_cast<int>(sizeof(SAM_INDEX)), std::ios::end);
-    index_file_.read(reinterpret_cast<char*>(&last_index), sizeof(SAM_INDEX));
+bool DB_SAM::detect_format() {
+    compressed_ = codec_ != BLOCK_CODEC_NONE;
 
-    if (index_file_.good()) {
-        return last_index._seq;
+    data_file_.seekg(0, std::ios::end);
+    int64_t data_size = data_file_.tellg();
+    if (data_size > 0) {
+        SAM_BLOCK_HEADER header;
+        bool is_block = read_block_header(0, header);
+        if (!is_block && compressed_) {
+            std::cout << "DB_SAM: " << data_file_path_ << " already has raw data, compression disabled" << std::endl;
+        }
+        compressed_ = is_block;
+        if (is_block && codec_ == BLOCK_CODEC_NONE) {
+            codec_ = static_cast<BlockCodec>(header._codec);
+        }
     }
+    data_file_.clear();
+    return true;
+}
 
-    return next_sequence_ - 1;
-}
\ No newline at end of file
+bool DB_SAM::repair_block_tail() {
+    data_file_.seekg(0, std::ios::end);
+    int64_t data_size = data_file_.tellg();
+    index_file_.seekg(0, std::ios::end);
+    int64_t index_size = index_file_.tellg();
+
+    // 인덱스는 block 을 기록한 뒤에 쓰므로, 마지막으로 온전한 block 을 가리키는 인덱스까지가 유효하다
+    size_t keep = static_cast<size_t>(index_size) / sizeof(SAM_INDEX);
+    int64_t data_end = 0;
+    while (keep > 0) {
+        SAM_INDEX index;
+        index_file_.clear();
+        index_file_.seekg((keep - 1) * sizeof(SAM_INDEX), std::ios::beg);
+        index_file_.read(reinterpret_cast<char*>(&index), sizeof(SAM_INDEX));
+        if (index_file_.fail()) {
+            return false;
+        }
+        int64_t offset = index._seek >> DB_SAM_BLOCK_OFFSET_BITS;
+        int64_t in_block = index._seek & BLOCK_IN_OFFSET_MASK;
+        SAM_BLOCK_HEADER header;
+        if (read_block_header(offset, header) &&
+            offset + static_cast<int64_t>(sizeof(header)) + header._stored_size <= data_size &&
+            in_block + index._size <= header._raw_size) {
+            data_end = offset + sizeof(header) + header._stored_size;
+            break;
+        }
+        keep--;
+    }
+
+    int64_t keep_bytes = static_cast<int64_t>(keep * sizeof(SAM_INDEX));
+    if (keep_bytes == index_size && data_end == data_size) {
+        return true;
+    }
+    std::cout << "DB_SAM: dropping incomplete block tail of " << base_path_ << " ("
+              << (index_size - keep_bytes) / static_cast<int64_t>(sizeof(SAM_INDEX)) << " index entries, "
+              << (data_size - data_end) << " data bytes)" << std::endl;
+    close_files();
+    if (::truncate(index_file_path_.c_str(), keep_bytes) != 0 ||
+        ::truncate(data_file_path_.c_str(), data_end) != 0) {
+        std::cerr << "DB_SAM: failed to truncate " << base_path_ << std::endl;
+        return false;
+    }
+    return open_files();
+}
+
+bool DB_SAM::repair_raw_tail() {
+    data_file_.seekg(0, std::ios::end);
+    int64_t data_size = data_file_.tellg();
+    index_file_.seekg(0, std::ios::end);
+    int64_t index_size = index_file_.tellg();
+
+    // 데이터를 먼저 쓰고 인덱스를 쓰므로 (put), 끝에서부터 데이터가 다 있는 entry 까지가 유효하다.
+    // 정상 종료한 파일이면 마지막 entry 하나만 읽고 끝난다
+    size_t keep = static_cast<size_t>(index_size) / sizeof(SAM_INDEX);
+    int64_t data_end = 0;
+    while (keep > 0) {
+        SAM_INDEX index;
+        index_file_.clear();
+        index_file_.seekg((keep - 1) * sizeof(SAM_INDEX), std::ios::beg);
+        index_file_.read(reinterpret_cast<char*>(&index), sizeof(SAM_INDEX));
+        if (index_file_.fail()) {
+            return false;
+        }
+        if (index._seek >= 0 && index._seek + static_cast<int64_t>(index._size) <= data_size) {
+            data_end = index._seek + index._size;
+            break;
+        }
+        keep--;
+    }
+    index_file_.clear();
+    data_file_.clear();
+
+    int64_t keep_bytes = static_cast<int64_t>(keep * sizeof(SAM_INDEX));
+    if (keep_bytes == index_size && data_end == data_size) {
+        return true;
+    }
+    // 반쯤 쓴 인덱스 entry 를 남겨두면 이후 append 가 24 byte 경계에서 어긋난다
+    std::cout << "DB_SAM: dropping torn tail of " << base_path_ << " ("
+              << (index_size - keep_bytes) << " index bytes, " << (data_size - data_end) << " data bytes)" << std::endl;
+    close_files();
+    if (::truncate(index_file_path_.c_str(), keep_bytes) != 0 ||
+        ::truncate(data_file_path_.c_str(), data_end) != 0) {
+        std::cerr << "DB_SAM: failed to truncate " << base_path_ << std::endl;
+        return false;
+    }
+    return open_files();
+}
+
+bool DB_SAM::append_to_block(const void* data, size_t size, uint64_t timestamp) {
+    if (block_index_.empty()) {
+        block_started_ms_ = now_ms();
+    }
+
+    SAM_INDEX index;
+    index._seek = (block_offset_ << DB_SAM_BLOCK_OFFSET_BITS) | static_cast<int64_t>(block_buf_.size());
+    index._size = static_cast<uint32_t>(size);
+    index._seq = next_sequence_.load(std::memory_order_relaxed);
+    index._timestamp = timestamp;
+
+    uint32_t count = message_count_.load(std::memory_order_relaxed);
+    if (!set_index_entry(count, index)) {
+        return false;
+    }
+    const char* p = static_cast<const char*>(data);
+    block_buf_.insert(block_buf_.end(), p, p + size);
+    block_index_.push_back(index);
+    next_sequence_.store(index._seq + 1, std::memory_order_relaxed);
+    message_count_.store(count + 1, std::memory_order_release);
+
+    // block 안 위치는 항상 block_size_ 보다 작다 (넘으면 바로 기록)
+    return block_buf_.size() < block_size_ || flush_block();
+}
+
+bool DB_SAM::flush_block() {
+    if (block_index_.empty()) {
+        return true;
+    }
+
+    size_t raw_size = block_buf_.size();
+    size_t stored = 0;
+    if (codec_ != BLOCK_CODEC_NONE) {
+        compress_buf_.resize(block_compress_bound(raw_size));
+        stored = block_compress(codec_, block_buf_.data(), raw_size, compress_buf_.data(), compress_buf_.size());
+    }
+
+    SAM_BLOCK_HEADER header;
+    header._magic = DB_SAM_BLOCK_MAGIC;
+    header._codec = static_cast<uint16_t>(stored ? codec_ : BLOCK_CODEC_NONE);
+    header._reserved = 0;
+    header._raw_size = static_cast<uint32_t>(raw_size);
+    header._stored_size = static_cast<uint32_t>(stored ? stored : raw_size);
+    header._first_seq = block_index_.front()._seq;
+    header._count = static_cast<uint32_t>(block_index_.size());
+
+    data_file_.clear();
+    data_file_.seekp(block_offset_, std::ios::beg);
+    data_file_.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    data_file_.write(stored ? compress_buf_.data() : block_buf_.data(), header._stored_size);
+    if (data_file_.fail()) {
+        return false;
+    }
+
+    index_file_.clear();
+    index_file_.seekp(0, std::ios::end);
+    index_file_.write(reinterpret_cast<const char*>(block_index_.data()), block_index_.size() * sizeof(SAM_INDEX));
+    if (index_file_.fail()) {
+        return false;
+    }
+
+    block_offset_ += sizeof(header) + header._stored_size;
+    block_buf_.clear();
+    block_index_.clear();
+    return sync_files();
+}
+
+const char* DB_SAM::block_message(const SAM_INDEX& index) const {
+    int64_t offset = index._seek >> DB_SAM_BLOCK_OFFSET_BITS;
+    size_t in_block = static_cast<size_t>(index._seek & BLOCK_IN_OFFSET_MASK);
+
+    if (!block_index_.empty() && offset == block_offset_) {
+        if (in_block + index._size > block_buf_.size()) {
+            return nullptr;
+        }
+        return block_buf_.data() + in_block;
+    }
+
+    if (offset != cache_offset_) {
+        SAM_BLOCK_HEADER header;
+        if (!read_block_header(offset, header)) {
+            return nullptr;
+        }
+        cache_offset_ = -1;
+        cache_buf_.resize(header._raw_size);
+        if (header._codec == BLOCK_CODEC_NONE) {
+            data_file_.read(cache_buf_.data(), header._stored_size);
+            if (data_file_.fail() || header._stored_size != header._raw_size) {
+                return nullptr;
+            }
+        } else {
+            read_buf_.resize(header._stored_size);
+            data_file_.read(read_buf_.data(), header._stored_size);
+            if (data_file_.fail() ||
+                !block_decompress(header._codec, read_buf_.data(), header._stored_size, cache_buf_.data(), header._raw_size)) {
+                std::cerr << "DB_SAM: corrupted block at " << offset << " in " << data_file_path_ << std::endl;
+                return nullptr;
+            }
+        }
+        cache_offset_ = offset;
+    }
+
+    if (in_block + index._size > cache_buf_.size()) {
+        return nullptr;
+    }
+    return cache_buf_.data() + in_block;
+}
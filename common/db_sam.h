@@ -3,19 +3,65 @@
 #include <string>
 #include <fstream>
 #include <mutex>
+#include <atomic>
+#include <memory>
 #include <cstdint>
 #include <functional>
+#include <vector>
 #include "MessageDB.h"
+#include "BlockCompression.h"
 
 // Sequential Access Message Database
 // 순차 접근 메시지 데이터베이스 - 메시지를 순서대로 저장하고 인덱스를 통해 빠른 검색
 
+// 압축 block 모드 (set_compression)
+#define DB_SAM_BLOCK_MAGIC 0x424D4153           // 'SAMB'
+#define DB_SAM_BLOCK_SIZE (64 * 1024)           // 기본 block 크기 (압축 전)
+#define DB_SAM_BLOCK_OFFSET_BITS 24             // _seek = (block 파일 위치 << 24) | block 안 위치
+#define DB_SAM_BLOCK_MAX_DELAY_MS 1000          // 이보다 오래된 block (raw 형식은 flush 안 한 쓰기) 은 flush_if_stale 이 기록
+
+// 메모리 인덱스 (index_chunks_) : chunk 당 entry 수 x 최대 chunk 수 = 최대 메시지 수 (64K x 4096 = 268M)
+#define DB_SAM_INDEX_CHUNK_ENTRIES (64 * 1024)
+#define DB_SAM_INDEX_MAX_CHUNKS 4096
+
+// 데이터 파일의 block 앞에 붙는 header (뒤에 stored_size 바이트 payload)
+struct SAM_BLOCK_HEADER {
+    uint32_t _magic;        // DB_SAM_BLOCK_MAGIC
+    uint16_t _codec;        // BLOCK_CODEC_* (줄지 않으면 NONE 으로 원본 저장)
+    uint16_t _reserved;
+    uint32_t _raw_size;     // 압축 해제 크기
+    uint32_t _stored_size;  // payload 크기
+    uint32_t _first_seq;    // block 첫 메시지 sequence
+    uint32_t _count;        // block 메시지 수
+};
+
 /**
  * DB_SAM - 파일 기반 Sequential Access Message Database
  *
  * MessageDB 인터페이스를 구현한 파일 기반 데이터베이스.
  * 데이터를 파일 시스템에 영구 저장하며, 인덱스를 통한 빠른 검색을 지원합니다.
  * 주로 실제 운영 환경에서 데이터 영속성이 필요한 경우 사용됩니다.
+ *
+ * 압축 block 모드 (open 전에 set_compression):
+ *   메시지를 block_size 까지 메모리에 모았다가 [SAM_BLOCK_HEADER][압축 payload] 로 데이터 파일에 append 하고,
+ *   그 block 의 인덱스를 이어서 기록한다. SAM_INDEX 형식은 같고 _seek 만 block 위치 + block 안 위치다.
+ *   아직 기록하지 않은 block 의 메시지도 조회할 수 있지만, block 이 기록되기 전에 죽으면 잃는다.
+ *   put 은 block 이 차거나 다음 put 때 DB_SAM_BLOCK_MAX_DELAY_MS 가 지났으면 기록하고, 메시지가 끊긴 동안은
+ *   flush_if_stale 를 주기적으로 불러야 잃는 구간이 DB_SAM_BLOCK_MAX_DELAY_MS (+ 호출 주기) 로 제한된다.
+ *   읽기는 block 을 통째로 풀어 마지막 한 block 을 캐시한다 (get_range 순차 읽기용).
+ *   형식은 데이터 파일 첫 block header 로 판단하므로 기존 raw 파일은 설정과 관계없이 raw 로 계속 쓴다.
+ *   압축 모드에서는 파일 구간 전송 (get_data_region) 을 지원하지 않는다.
+ *
+ * raw 형식도 fstream 버퍼는 100 건마다 flush 하고, 그 사이 남은 쓰기는 flush_if_stale 가 같은 지연 안에 내린다.
+ * durable_max_seq 는 파일에 내린 (프로세스가 죽어도 남는) 마지막 sequence 다.
+ *
+ * set_read_only(true) 면 파일을 ios::in 으로만 열고 쓰기 경로 (put / repair / flush) 는 모두 false 또는 건너뛴다.
+ *
+ * 인덱스는 open 시 꽉 찬 chunk 는 인덱스 파일을 그대로 mmap (MAP_PRIVATE, 읽기 전용) 하고 마지막 chunk 만
+ * 메모리로 읽어두며, put 때 파일과 함께 갱신한다 (큰 DB 도 재시작 시 인덱스 전체를 읽지 않음).
+ * seq -> SAM_INDEX 는 chunk 포인터 계산만으로 찾으며 (파일 seek/read 없음), chunk 는 close 전까지 이동하지 않는다.
+ * writer 는 entry 를 채운 뒤 message_count_ 를 release 로 올리므로 count / max_seq / lookup_index 는
+ * mutex_ 없이 읽을 수 있다. 메시지 본문 읽기 (get / get_range) 는 fstream 을 공유하므로 계속 mutex_ 를 잡는다.
  */
 class DB_SAM : public MessageDB {
 private:
@@ -26,11 +72,31 @@ private:
     mutable std::fstream index_file_;
     mutable std::fstream data_file_;
     
-    uint32_t message_count_;
-    uint32_t next_sequence_;
+    std::atomic<uint32_t> message_count_;   // 메모리 인덱스에 채워진 entry 수 (release 로 공개)
+    std::atomic<uint32_t> next_sequence_;
+
+    // 메모리 인덱스 chunk 포인터 테이블 (고정 크기, reader 는 락 없이 접근)
+    std::unique_ptr<std::atomic<SAM_INDEX*>[]> index_chunks_;
+    std::vector<bool> mapped_chunks_;       // load_index 가 인덱스 파일을 mmap 한 chunk (open / close 에서만 변경)
     
     mutable std::mutex mutex_;  // Thread-safe operations
-    bool is_open_;
+    std::atomic<bool> is_open_;
+    bool read_only_;                        // set_read_only: 파일을 만들거나 고치지 않음 (viewer 용)
+
+    // 압축 block 모드
+    BlockCodec codec_;                      // 새 block 에 쓸 codec
+    size_t block_size_;
+    bool compressed_;                       // 데이터 파일이 block 형식
+    int64_t block_offset_;                  // 기록 대기 block 이 들어갈 파일 위치 (= 데이터 파일 끝)
+    std::vector<char> block_buf_;           // 기록 대기 block (압축 전)
+    std::vector<SAM_INDEX> block_index_;    // 기록 대기 block 의 인덱스
+    uint64_t block_started_ms_;
+    uint64_t unsynced_since_ms_;            // raw 형식: flush 하지 않은 첫 쓰기 시각 (0: 없음)
+    std::atomic<uint32_t> durable_seq_;     // 파일에 내린 마지막 sequence (sync_files 가 올림)
+    std::vector<char> compress_buf_;
+    mutable int64_t cache_offset_;          // cache_buf_ 에 풀어둔 block 위치 (-1: 없음)
+    mutable std::vector<char> cache_buf_;
+    mutable std::vector<char> read_buf_;
     
     // File operations
     bool open_files();
@@ -40,11 +106,39 @@ private:
     // Index operations
     bool write_index(const SAM_INDEX& index);
     bool read_index(uint32_t seq, SAM_INDEX& index) const;
+    /* 메모리 인덱스 (pos = seq - 1) */
+    SAM_INDEX* index_entry(size_t pos) const;
+    /* pos 위치에 entry 기록 (chunk 가 없으면 할당), message_count_ 는 호출한 쪽에서 올린다 */
+    bool set_index_entry(size_t pos, const SAM_INDEX& index);
+    /* 인덱스 파일 전체를 메모리 인덱스로 읽음 */
+    bool load_index();
+    void free_index();
+
+    // Block operations
+    bool detect_format();
+    /* 마지막 인덱스가 가리키는 block 까지만 남기고 정리 (기록 도중 죽은 block / 인덱스 없는 block) */
+    bool repair_block_tail();
+    /* raw 형식: 데이터가 다 기록되지 않은 인덱스 entry / 반쯤 쓴 entry / 인덱스 없는 데이터를 잘라냄 */
+    bool repair_raw_tail();
+    bool read_block_header(int64_t offset, SAM_BLOCK_HEADER& header) const;
+    bool append_to_block(const void* data, size_t size, uint64_t timestamp);
+    bool flush_block();
+    /* 인덱스가 가리키는 메시지 데이터 (대기 block 또는 풀어둔 block 안), mutex_ 를 잡은 동안만 유효 */
+    const char* block_message(const SAM_INDEX& index) const;
     
 public:
     explicit DB_SAM(const std::string& base_path);
     virtual ~DB_SAM();
 
+    /* 새로 만드는 데이터 파일을 block 압축 형식으로 (open 전에 호출, BLOCK_CODEC_NONE: 기존 raw 형식) */
+    void set_compression(BlockCodec codec, size_t block_size = DB_SAM_BLOCK_SIZE);
+    bool is_compressed() const { return compressed_; }
+    /* 읽기 전용으로 open (open 전에 호출): 없는 파일을 만들지 않고 block tail 정리 / put 을 하지 않는다.
+     * 다른 프로세스가 쓰는 중인 DB 를 볼 때 쓰며, 인덱스는 open 시점까지 기록된 메시지만 보인다. */
+    void set_read_only(bool read_only);
+    bool is_read_only() const { return read_only_; }
+    BlockCodec get_compression() const { return codec_; }
+
     // MessageDB 인터페이스 구현
     bool open() override;
     void close() override;
@@ -53,20 +147,30 @@ public:
     // Message storage
     bool put(const void* data, size_t size) override;
     bool put(const void* data, size_t size, uint64_t timestamp) override;
+    bool put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) override;
 
     // Message retrieval
     bool get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_size) const override;
     bool get(uint32_t seq, std::string& data) const override;
 
+    /* 메모리 인덱스 조회 (mutex_ 없이 호출 가능) */
+    bool lookup_index(uint32_t seq, SAM_INDEX& index) const;
+    bool get_index(uint32_t seq, SAM_INDEX& index) const override { return lookup_index(seq, index); }
+
     // Database information
-    uint32_t count() const override { return message_count_; }
-    uint32_t get_next_sequence() const override { return next_sequence_; }
+    uint32_t count() const override { return message_count_.load(std::memory_order_acquire); }
+    uint32_t get_next_sequence() const override { return next_sequence_.load(std::memory_order_acquire); }
     uint32_t max_seq() const override;
+    uint32_t durable_max_seq() const override { return durable_seq_.load(std::memory_order_acquire); }
+    /* DB_SAM_BLOCK_MAX_DELAY_MS 보다 오래 기록 대기 중인 block / flush 안 한 쓰기를 파일에 내림 */
+    bool flush_if_stale() override;
 
     // Range operations
     bool get_range(uint32_t start_seq, uint32_t end_seq,
                    std::function<bool(uint32_t seq, const SAM_INDEX& index, const void* data, size_t size)> callback) const override;
 
+    bool get_data_region(uint32_t start_seq, uint32_t end_seq, MessageDataRegion& region) const override;
+
     // Maintenance operations
     bool verify_integrity() const override;
     bool compact() override;
@@ -0,0 +1,415 @@
+#include "mmap_sam.h"
+#include <iostream>
+#include <cstring>
+#include <chrono>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+
+namespace {
+
+size_t page_size() {
+    static const size_t ps = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+    return ps;
+}
+
+uint64_t now_ms() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+// [begin, end) 구간을 chunk 단위로 나누어 msync
+bool msync_range(const std::atomic<char*>* chunks, size_t chunk_bytes, int64_t begin, int64_t end) {
+    bool ok = true;
+    while (begin < end) {
+        size_t chunk_no = static_cast<size_t>(begin / chunk_bytes);
+        size_t in_chunk = static_cast<size_t>(begin % chunk_bytes);
+        size_t len = chunk_bytes - in_chunk;
+        if (static_cast<int64_t>(len) > end - begin) len = static_cast<size_t>(end - begin);
+
+        char* base = chunks[chunk_no].load(std::memory_order_acquire);
+        if (base) {
+            size_t aligned = in_chunk - (in_chunk % page_size());
+            if (msync(base + aligned, len + (in_chunk - aligned), MS_SYNC) != 0) ok = false;
+        }
+        begin += len;
+    }
+    return ok;
+}
+
+} // namespace
+
+MMAP_SAM::MMAP_SAM(const std::string& base_path, const MMapSyncPolicy& policy,
+                   size_t data_chunk_size, size_t index_chunk_entries)
+    : base_path_(base_path)
+    , index_file_path_(base_path + ".idx")
+    , data_file_path_(base_path + ".data")
+    , index_fd_(-1)
+    , data_fd_(-1)
+    , data_chunk_size_(data_chunk_size)
+    , index_chunk_entries_(index_chunk_entries)
+    , data_chunk_count_(0)
+    , index_chunk_count_(0)
+    , committed_(0)
+    , data_end_(0)
+    , sync_policy_(policy)
+    , synced_count_(0)
+    , synced_data_end_(0)
+    , last_sync_ms_(0)
+    , is_open_(false) {
+    // mmap offset은 page 단위여야 하므로 chunk 크기를 page 배수로 맞춘다
+    size_t ps = page_size();
+    if (data_chunk_size_ < ps) data_chunk_size_ = ps;
+    data_chunk_size_ = (data_chunk_size_ + ps - 1) / ps * ps;
+    // sizeof(SAM_INDEX) * entries 가 page 배수가 되도록 entries를 page 수의 배수로 올림
+    if (index_chunk_entries_ < ps) index_chunk_entries_ = ps;
+    index_chunk_entries_ = (index_chunk_entries_ + ps - 1) / ps * ps;
+}
+
+MMAP_SAM::~MMAP_SAM() {
+    close();
+}
+
+bool MMAP_SAM::map_data_chunk(size_t chunk_no) {
+    if (chunk_no >= MAX_CHUNKS) return false;
+    if (data_chunks_[chunk_no].load(std::memory_order_relaxed)) return true;
+
+    off_t offset = static_cast<off_t>(chunk_no) * data_chunk_size_;
+    struct stat st;
+    if (fstat(data_fd_, &st) != 0) return false;
+    if (st.st_size < offset + static_cast<off_t>(data_chunk_size_)) {
+        if (ftruncate(data_fd_, offset + data_chunk_size_) != 0) return false;
+    }
+    void* p = mmap(nullptr, data_chunk_size_, PROT_READ | PROT_WRITE, MAP_SHARED, data_fd_, offset);
+    if (p == MAP_FAILED) {
+        std::cerr << "MMAP_SAM: data chunk mmap failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    data_chunks_[chunk_no].store(static_cast<char*>(p), std::memory_order_release);
+    if (chunk_no + 1 > data_chunk_count_) data_chunk_count_ = chunk_no + 1;
+    return true;
+}
+
+bool MMAP_SAM::map_index_chunk(size_t chunk_no) {
+    if (chunk_no >= MAX_CHUNKS) return false;
+    if (index_chunks_[chunk_no].load(std::memory_order_relaxed)) return true;
+
+    size_t chunk_bytes = index_chunk_entries_ * sizeof(SAM_INDEX);
+    off_t offset = static_cast<off_t>(chunk_no) * chunk_bytes;
+    struct stat st;
+    if (fstat(index_fd_, &st) != 0) return false;
+    if (st.st_size < offset + static_cast<off_t>(chunk_bytes)) {
+        if (ftruncate(index_fd_, offset + chunk_bytes) != 0) return false;
+    }
+    void* p = mmap(nullptr, chunk_bytes, PROT_READ | PROT_WRITE, MAP_SHARED, index_fd_, offset);
+    if (p == MAP_FAILED) {
+        std::cerr << "MMAP_SAM: index chunk mmap failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    index_chunks_[chunk_no].store(static_cast<char*>(p), std::memory_order_release);
+    if (chunk_no + 1 > index_chunk_count_) index_chunk_count_ = chunk_no + 1;
+    return true;
+}
+
+void MMAP_SAM::unmap_all() {
+    size_t index_chunk_bytes = index_chunk_entries_ * sizeof(SAM_INDEX);
+    for (size_t i = 0; i < data_chunk_count_; ++i) {
+        char* p = data_chunks_[i].exchange(nullptr);
+        if (p) munmap(p, data_chunk_size_);
+    }
+    for (size_t i = 0; i < index_chunk_count_; ++i) {
+        char* p = index_chunks_[i].exchange(nullptr);
+        if (p) munmap(p, index_chunk_bytes);
+    }
+    data_chunk_count_ = 0;
+    index_chunk_count_ = 0;
+}
+
+SAM_INDEX* MMAP_SAM::index_entry(uint32_t seq) const {
+    size_t pos = seq - 1;
+    char* base = index_chunks_[pos / index_chunk_entries_].load(std::memory_order_acquire);
+    if (!base) return nullptr;
+    return reinterpret_cast<SAM_INDEX*>(base) + (pos % index_chunk_entries_);
+}
+
+const char* MMAP_SAM::data_ptr(int64_t seek) const {
+    char* base = data_chunks_[static_cast<size_t>(seek / data_chunk_size_)].load(std::memory_order_acquire);
+    if (!base) return nullptr;
+    return base + (seek % data_chunk_size_);
+}
+
+// 비정상 종료로 preallocate 영역(0)이 남아있을 수 있으므로 _seq == 위치 인 마지막 엔트리를 찾는다
+uint32_t MMAP_SAM::recover_count() const {
+    size_t mapped_entries = index_chunk_count_ * index_chunk_entries_;
+    if (mapped_entries == 0) return 0;
+
+    size_t lo = 0, hi = mapped_entries;   // [0, lo) 는 유효
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        const SAM_INDEX* e = index_entry(static_cast<uint32_t>(mid + 1));
+        if (e && e->_seq == mid + 1) lo = mid + 1;
+        else hi = mid;
+    }
+    return static_cast<uint32_t>(lo);
+}
+
+bool MMAP_SAM::open() {
+    std::lock_guard<std::mutex> lock(write_mu_);
+
+    if (is_open_) {
+        return true;
+    }
+
+    size_t last_slash = base_path_.find_last_of('/');
+    if (last_slash != std::string::npos) {
+        std::string dir_path = base_path_.substr(0, last_slash);
+        if (!dir_path.empty()) {
+            mkdir(dir_path.c_str(), 0755);
+        }
+    }
+
+    index_fd_ = ::open(index_file_path_.c_str(), O_RDWR | O_CREAT, 0644);
+    data_fd_ = ::open(data_file_path_.c_str(), O_RDWR | O_CREAT, 0644);
+    if (index_fd_ < 0 || data_fd_ < 0) {
+        std::cerr << "MMAP_SAM: failed to open " << base_path_ << ": " << strerror(errno) << std::endl;
+        if (index_fd_ >= 0) ::close(index_fd_);
+        if (data_fd_ >= 0) ::close(data_fd_);
+        index_fd_ = data_fd_ = -1;
+        return false;
+    }
+
+    data_chunks_.reset(new std::atomic<char*>[MAX_CHUNKS]);
+    index_chunks_.reset(new std::atomic<char*>[MAX_CHUNKS]);
+    for (size_t i = 0; i < MAX_CHUNKS; ++i) {
+        data_chunks_[i].store(nullptr, std::memory_order_relaxed);
+        index_chunks_[i].store(nullptr, std::memory_order_relaxed);
+    }
+
+    // 기존 파일 크기만큼 chunk 매핑 (최소 1개)
+    struct stat st;
+    fstat(index_fd_, &st);
+    size_t index_chunk_bytes = index_chunk_entries_ * sizeof(SAM_INDEX);
+    size_t index_chunks = (static_cast<size_t>(st.st_size) + index_chunk_bytes - 1) / index_chunk_bytes;
+    if (index_chunks == 0) index_chunks = 1;
+    for (size_t i = 0; i < index_chunks; ++i) {
+        if (!map_index_chunk(i)) { unmap_all(); return false; }
+    }
+
+    fstat(data_fd_, &st);
+    size_t data_chunks = (static_cast<size_t>(st.st_size) + data_chunk_size_ - 1) / data_chunk_size_;
+    if (data_chunks == 0) data_chunks = 1;
+    for (size_t i = 0; i < data_chunks; ++i) {
+        if (!map_data_chunk(i)) { unmap_all(); return false; }
+    }
+
+    uint32_t n = recover_count();
+    data_end_ = 0;
+    if (n > 0) {
+        const SAM_INDEX* last = index_entry(n);
+        data_end_ = last->_seek + last->_size;
+    }
+    committed_.store(n, std::memory_order_release);
+    synced_count_ = n;
+    synced_data_end_ = data_end_;
+    last_sync_ms_ = now_ms();
+
+    is_open_.store(true, std::memory_order_release);
+    return true;
+}
+
+void MMAP_SAM::close() {
+    std::lock_guard<std::mutex> lock(write_mu_);
+
+    if (!is_open_) {
+        return;
+    }
+    is_open_.store(false, std::memory_order_release);
+
+    sync_locked();
+    unmap_all();
+
+    // 실제 사용한 크기로 truncate (DB_SAM 과 파일 호환)
+    uint32_t n = committed_.load(std::memory_order_acquire);
+    if (ftruncate(index_fd_, static_cast<off_t>(n) * sizeof(SAM_INDEX)) != 0 ||
+        ftruncate(data_fd_, static_cast<off_t>(data_end_)) != 0) {
+        std::cerr << "MMAP_SAM: truncate on close failed: " << strerror(errno) << std::endl;
+    }
+    ::close(index_fd_);
+    ::close(data_fd_);
+    index_fd_ = data_fd_ = -1;
+}
+
+bool MMAP_SAM::put(const void* data, size_t size) {
+    return put(data, size, now_ns());
+}
+
+bool MMAP_SAM::put(const void* data, size_t size, uint64_t timestamp) {
+    MessageSlice item = {data, size};
+    return put_batch(&item, 1, timestamp);
+}
+
+bool MMAP_SAM::put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) {
+    std::lock_guard<std::mutex> lock(write_mu_);
+
+    if (!is_open_) {
+        return false;
+    }
+
+    uint32_t seq = committed_.load(std::memory_order_relaxed);
+    for (size_t i = 0; i < count; ++i) {
+        size_t size = items[i].size;
+        if (size == 0 || size > data_chunk_size_) {
+            std::cerr << "MMAP_SAM: invalid message size " << size << std::endl;
+            return false;
+        }
+
+        // chunk 경계를 넘으면 다음 chunk 시작으로 이동
+        size_t in_chunk = static_cast<size_t>(data_end_ % data_chunk_size_);
+        if (in_chunk + size > data_chunk_size_) {
+            data_end_ += data_chunk_size_ - in_chunk;
+        }
+        if (!map_data_chunk(static_cast<size_t>(data_end_ / data_chunk_size_))) {
+            return false;
+        }
+        memcpy(const_cast<char*>(data_ptr(data_end_)), items[i].data, size);
+
+        ++seq;
+        if (!map_index_chunk((seq - 1) / index_chunk_entries_)) {
+            return false;
+        }
+        SAM_INDEX* e = index_entry(seq);
+        e->_seek = data_end_;
+        e->_size = static_cast<uint32_t>(size);
+        e->_timestamp = timestamp;
+        e->_seq = seq;
+
+        data_end_ += size;
+        committed_.store(seq, std::memory_order_release);
+    }
+
+    maybe_sync_locked();
+    return true;
+}
+
+void MMAP_SAM::maybe_sync_locked() {
+    uint32_t n = committed_.load(std::memory_order_relaxed);
+    switch (sync_policy_.mode) {
+        case MMapSyncMode::NONE:
+            break;
+        case MMapSyncMode::EVERY_MESSAGE:
+            sync_locked();
+            break;
+        case MMapSyncMode::EVERY_N:
+            if (n - synced_count_ >= sync_policy_.every_n) sync_locked();
+            break;
+        case MMapSyncMode::INTERVAL:
+            if (now_ms() - last_sync_ms_ >= sync_policy_.interval_ms) sync_locked();
+            break;
+    }
+}
+
+bool MMAP_SAM::sync_locked() {
+    uint32_t n = committed_.load(std::memory_order_relaxed);
+    bool ok = true;
+    if (data_end_ > synced_data_end_) {
+        ok &= msync_range(data_chunks_.get(), data_chunk_size_, synced_data_end_, data_end_);
+    }
+    if (n > synced_count_) {
+        ok &= msync_range(index_chunks_.get(), index_chunk_entries_ * sizeof(SAM_INDEX),
+                          static_cast<int64_t>(synced_count_) * sizeof(SAM_INDEX),
+                          static_cast<int64_t>(n) * sizeof(SAM_INDEX));
+    }
+    synced_count_ = n;
+    synced_data_end_ = data_end_;
+    last_sync_ms_ = now_ms();
+    return ok;
+}
+
+bool MMAP_SAM::sync() {
+    std::lock_guard<std::mutex> lock(write_mu_);
+    if (!is_open_) return false;
+    return sync_locked();
+}
+
+const void* MMAP_SAM::get_direct(uint32_t seq, SAM_INDEX& index) const {
+    if (!is_open_.load(std::memory_order_acquire)) return nullptr;
+    if (seq < 1 || seq > committed_.load(std::memory_order_acquire)) return nullptr;
+
+    const SAM_INDEX* e = index_entry(seq);
+    if (!e) return nullptr;
+    index = *e;
+    return data_ptr(index._seek);
+}
+
+bool MMAP_SAM::get_index(uint32_t seq, SAM_INDEX& index) const {
+    if (!is_open_.load(std::memory_order_acquire)) return false;
+    if (seq < 1 || seq > committed_.load(std::memory_order_acquire)) return false;
+
+    const SAM_INDEX* e = index_entry(seq);
+    if (!e) return false;
+    index = *e;
+    return true;
+}
+
+bool MMAP_SAM::get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_size) const {
+    if (!buffer_size) return false;
+
+    const void* p = get_direct(seq, index);
+    if (!p) return false;
+
+    memcpy(buffer, p, index._size);
+    *buffer_size = index._size;
+    return true;
+}
+
+bool MMAP_SAM::get(uint32_t seq, std::string& data) const {
+    SAM_INDEX index;
+    const void* p = get_direct(seq, index);
+    if (!p) return false;
+
+    data.assign(static_cast<const char*>(p), index._size);
+    return true;
+}
+
+bool MMAP_SAM::get_range(uint32_t start_seq, uint32_t end_seq,
+                         std::function<bool(uint32_t seq, const SAM_INDEX& index, const void* data, size_t size)> callback) const {
+    if (!callback || start_seq > end_seq || !isOpen()) {
+        return false;
+    }
+    if (start_seq < 1) start_seq = 1;
+    uint32_t last = committed_.load(std::memory_order_acquire);
+    if (end_seq > last) end_seq = last;
+
+    for (uint32_t seq = start_seq; seq <= end_seq; ++seq) {
+        SAM_INDEX index;
+        const void* p = get_direct(seq, index);
+        if (!p) continue;
+        if (!callback(seq, index, p, index._size)) {
+            break;
+        }
+    }
+    return true;
+}
+
+bool MMAP_SAM::verify_integrity() const {
+    if (!isOpen()) return false;
+
+    uint32_t n = committed_.load(std::memory_order_acquire);
+    int64_t prev_end = 0;
+    for (uint32_t seq = 1; seq <= n; ++seq) {
+        const SAM_INDEX* e = index_entry(seq);
+        if (!e || e->_seq != seq || e->_seek < prev_end) {
+            return false;
+        }
+        prev_end = e->_seek + e->_size;
+    }
+    return prev_end == data_end_;
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <string>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include "MessageDB.h"
+
+// MMAP_SAM 내구성(sync) 정책
+enum class MMapSyncMode {
+    NONE,           // OS에 맡김 (close 시에만 msync)
+    EVERY_MESSAGE,  // put 마다 msync
+    EVERY_N,        // N건 마다 msync
+    INTERVAL        // 마지막 sync 이후 interval_ms 경과 시 msync
+};
+
+struct MMapSyncPolicy {
+    MMapSyncMode mode;
+    uint32_t every_n;
+    uint32_t interval_ms;
+
+    MMapSyncPolicy(MMapSyncMode m = MMapSyncMode::EVERY_N, uint32_t n = 100, uint32_t ms = 1000)
+        : mode(m), every_n(n), interval_ms(ms) {}
+};
+
+/**
+ * MMAP_SAM - mmap 기반 append-only Sequential Access Message Database
+ *
+ * DB_SAM과 동일한 파일 포맷(<base>.idx = SAM_INDEX 배열, <base>.data = 메시지 본문)을
+ * 고정 크기 chunk 단위로 mmap 하여 사용한다.
+ *  - chunk는 한번 매핑되면 close 전까지 이동/해제되지 않으므로 get_direct() 포인터가 유효하다.
+ *  - 메시지는 chunk 경계를 넘지 않도록 배치한다 (남는 공간은 건너뜀, _seek는 파일 오프셋).
+ *  - writer(put)는 _write_mu 로 직렬화하고, 인덱스 기록 후 _committed 를 release로 증가시킨다.
+ *    reader(get/get_range/get_direct)는 락 없이 _committed 까지만 읽는다.
+ *  - close 시 파일을 실제 사용 크기로 truncate 하므로 DB_SAM으로도 다시 열 수 있다.
+ */
+class MMAP_SAM : public MessageDB {
+public:
+    static constexpr size_t DEFAULT_DATA_CHUNK_SIZE = 64 * 1024 * 1024;   // 64MB
+    static constexpr size_t DEFAULT_INDEX_CHUNK_ENTRIES = 64 * 1024;      // 64K entries
+    static constexpr size_t MAX_CHUNKS = 4096;
+
+private:
+    std::string base_path_;
+    std::string index_file_path_;
+    std::string data_file_path_;
+
+    int index_fd_;
+    int data_fd_;
+
+    size_t data_chunk_size_;
+    size_t index_chunk_entries_;
+
+    // chunk 포인터 테이블 (고정 크기, reader는 락 없이 접근)
+    std::unique_ptr<std::atomic<char*>[]> data_chunks_;
+    std::unique_ptr<std::atomic<char*>[]> index_chunks_;
+    size_t data_chunk_count_;
+    size_t index_chunk_count_;
+
+    std::atomic<uint32_t> committed_;   // 기록 완료된 메시지 수 (= max seq)
+    int64_t data_end_;                  // 다음 기록 위치 (파일 오프셋)
+
+    MMapSyncPolicy sync_policy_;
+    uint32_t synced_count_;
+    int64_t synced_data_end_;
+    uint64_t last_sync_ms_;
+
+    std::mutex write_mu_;
+    std::atomic<bool> is_open_;
+
+    bool map_data_chunk(size_t chunk_no);
+    bool map_index_chunk(size_t chunk_no);
+    void unmap_all();
+
+    SAM_INDEX* index_entry(uint32_t seq) const;
+    const char* data_ptr(int64_t seek) const;
+
+    uint32_t recover_count() const;
+    bool sync_locked();
+    void maybe_sync_locked();
+
+public:
+    explicit MMAP_SAM(const std::string& base_path,
+                      const MMapSyncPolicy& policy = MMapSyncPolicy(),
+                      size_t data_chunk_size = DEFAULT_DATA_CHUNK_SIZE,
+                      size_t index_chunk_entries = DEFAULT_INDEX_CHUNK_ENTRIES);
+    virtual ~MMAP_SAM();
+
+    // MessageDB 인터페이스 구현
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return is_open_.load(std::memory_order_acquire); }
+
+    // Message storage (single writer)
+    bool put(const void* data, size_t size) override;
+    bool put(const void* data, size_t size, uint64_t timestamp) override;
+    bool put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) override;
+
+    // Message retrieval (lock-free)
+    bool get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_size) const override;
+    bool get(uint32_t seq, std::string& data) const override;
+    const void* get_direct(uint32_t seq, SAM_INDEX& index) const override;
+    bool get_index(uint32_t seq, SAM_INDEX& index) const override;
+
+    // Database information
+    uint32_t count() const override { return committed_.load(std::memory_order_acquire); }
+    uint32_t get_next_sequence() const override { return count() + 1; }
+    uint32_t max_seq() const override { return count(); }
+
+    // Range operations
+    bool get_range(uint32_t start_seq, uint32_t end_seq,
+                   std::function<bool(uint32_t seq, const SAM_INDEX& index, const void* data, size_t size)> callback) const override;
+
+    // Maintenance operations
+    bool verify_integrity() const override;
+    bool sync();
+
+    // Statistics
+    int64_t get_data_file_size() const override { return data_end_; }
+    int64_t get_index_file_size() const override { return static_cast<int64_t>(count()) * sizeof(SAM_INDEX); }
+
+    void set_sync_policy(const MMapSyncPolicy& policy) { sync_policy_ = policy; }
+    const MMapSyncPolicy& get_sync_policy() const { return sync_policy_; }
+
+    // File paths
+    const std::string& get_base_path() const { return base_path_; }
+    const std::string& get_index_file_path() const { return index_file_path_; }
+    const std::string& get_data_file_path() const { return data_file_path_; }
+};
@@ -0,0 +1,714 @@
+#include "segment_sam.h"
+#include <iostream>
+#include <cstring>
+#include <cstdio>
+#include <cerrno>
+#include <ctime>
+#include <chrono>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace {
+
+const size_t RANGE_READ_BYTES = 1024 * 1024;        // get_range 가 한번에 pread 하는 최대 크기
+const size_t WRITE_IOV_MAX = 1024;                  // pwritev 한번에 넘기는 메시지 수 (IOV_MAX)
+const size_t INDEX_PREALLOC_DIVISOR = 16;           // 인덱스 파일 미리 확보 크기 = segment_bytes / 16
+
+uint64_t now_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::high_resolution_clock::now().time_since_epoch()).count();
+}
+
+bool pread_full(int fd, void* buffer, size_t size, int64_t offset) {
+    char* p = static_cast<char*>(buffer);
+    while (size > 0) {
+        ssize_t n = ::pread(fd, p, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+bool pwrite_full(int fd, const void* buffer, size_t size, int64_t offset) {
+    const char* p = static_cast<const char*>(buffer);
+    while (size > 0) {
+        ssize_t n = ::pwrite(fd, p, size, static_cast<off_t>(offset));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        size -= static_cast<size_t>(n);
+        offset += n;
+    }
+    return true;
+}
+
+// 파일 크기는 그대로 두고 디스크 공간만 미리 확보 (지원하지 않는 파일 시스템이면 그냥 이어 쓴다)
+void preallocate(int fd, size_t bytes) {
+#ifdef FALLOC_FL_KEEP_SIZE
+    if (bytes > 0) {
+        (void)::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(bytes));
+    }
+#else
+    (void)fd;
+    (void)bytes;
+#endif
+}
+
+int64_t file_size(int fd) {
+    struct stat st;
+    return fstat(fd, &st) == 0 ? static_cast<int64_t>(st.st_size) : -1;
+}
+
+} // namespace
+
+SEGMENT_SAM::Segment::~Segment() {
+    if (index_fd >= 0) ::close(index_fd);
+    if (data_fd >= 0) ::close(data_fd);
+}
+
+SEGMENT_SAM::SEGMENT_SAM(const std::string& base_path, const SegmentPolicy& policy)
+    : base_path_(base_path)
+    , dir_path_(base_path + ".seg")
+    , policy_(policy)
+    , first_seq_(1)
+    , next_sequence_(1)
+    , message_count_(0)
+    , retired_segments_(0)
+    , date_checked_sec_(-1)
+    , current_date_(0)
+    , is_open_(false) {
+    if (policy_.segment_bytes < 4096) {
+        policy_.segment_bytes = 4096;
+    }
+}
+
+SEGMENT_SAM::~SEGMENT_SAM() {
+    close();
+}
+
+std::string SEGMENT_SAM::segment_name(uint32_t first_seq, int date) const {
+    char name[32];
+    snprintf(name, sizeof(name), "%010u-%08d", first_seq, date);
+    return dir_path_ + "/" + name;
+}
+
+int SEGMENT_SAM::today() {
+    time_t now = time(nullptr);
+    if (static_cast<int64_t>(now) != date_checked_sec_) {
+        struct tm tm_now;
+        localtime_r(&now, &tm_now);
+        current_date_ = (tm_now.tm_year + 1900) * 10000 + (tm_now.tm_mon + 1) * 100 + tm_now.tm_mday;
+        date_checked_sec_ = static_cast<int64_t>(now);
+    }
+    return current_date_;
+}
+
+bool SEGMENT_SAM::open_segment(const SegmentPtr& seg, bool create) {
+    std::string name = segment_name(seg->first_seq, seg->date);
+    seg->index_path = name + ".idx";
+    seg->data_path = name + ".data";
+    int flags = create ? (O_RDWR | O_CREAT) : O_RDWR;
+    seg->index_fd = ::open(seg->index_path.c_str(), flags, 0644);
+    seg->data_fd = ::open(seg->data_path.c_str(), flags, 0644);
+    if (seg->index_fd < 0 || seg->data_fd < 0) {
+        std::cerr << "SEGMENT_SAM: failed to open segment " << name << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    int64_t index_size = file_size(seg->index_fd);
+    seg->count = static_cast<uint32_t>(index_size > 0 ? index_size / static_cast<int64_t>(sizeof(SAM_INDEX)) : 0);
+    seg->data_end = std::max<int64_t>(file_size(seg->data_fd), 0);
+    if (create) {
+        preallocate(seg->data_fd, policy_.segment_bytes);
+        preallocate(seg->index_fd, policy_.segment_bytes / INDEX_PREALLOC_DIVISOR);
+    }
+    return true;
+}
+
+bool SEGMENT_SAM::load_segment_index(Segment& seg) const {
+    if (seg.index_loaded) {
+        return true;
+    }
+    std::vector<SAM_INDEX> index(seg.count);
+    if (seg.count > 0 && !pread_full(seg.index_fd, index.data(), seg.count * sizeof(SAM_INDEX), 0)) {
+        std::cerr << "SEGMENT_SAM: failed to read " << seg.index_path << std::endl;
+        return false;
+    }
+    seg.index.swap(index);
+    seg.index_loaded = true;
+    return true;
+}
+
+bool SEGMENT_SAM::repair_tail(Segment& seg) {
+    if (!load_segment_index(seg)) {
+        return false;
+    }
+    // 인덱스는 데이터를 쓴 뒤에 기록하므로 seq 와 위치가 맞는 앞부분까지가 유효하다
+    uint32_t valid = 0;
+    int64_t data_end = 0;
+    while (valid < seg.count) {
+        const SAM_INDEX& e = seg.index[valid];
+        if (e._seq != seg.first_seq + valid || e._seek != data_end || e._seek + e._size > seg.data_end) {
+            break;
+        }
+        data_end = e._seek + e._size;
+        valid++;
+    }
+    if (valid == seg.count && data_end == seg.data_end) {
+        return true;
+    }
+    std::cout << "SEGMENT_SAM: dropping incomplete tail of " << seg.index_path << " ("
+              << (seg.count - valid) << " index entries, " << (seg.data_end - data_end) << " data bytes)" << std::endl;
+    if (ftruncate(seg.index_fd, static_cast<off_t>(valid) * sizeof(SAM_INDEX)) != 0 ||
+        ftruncate(seg.data_fd, static_cast<off_t>(data_end)) != 0) {
+        std::cerr << "SEGMENT_SAM: failed to truncate " << seg.index_path << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    seg.index.resize(valid);
+    seg.count = valid;
+    seg.data_end = data_end;
+    return true;
+}
+
+bool SEGMENT_SAM::open() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (is_open_) {
+        return true;
+    }
+
+    size_t last_slash = base_path_.find_last_of('/');
+    if (last_slash != std::string::npos) {
+        std::string parent = base_path_.substr(0, last_slash);
+        if (!parent.empty()) {
+            mkdir(parent.c_str(), 0755);
+        }
+    }
+    mkdir(dir_path_.c_str(), 0755);
+
+    // segment 디렉터리: 파일 이름 <first_seq>-<date>.idx
+    DIR* dir = opendir(dir_path_.c_str());
+    if (!dir) {
+        std::cerr << "SEGMENT_SAM: failed to open " << dir_path_ << ": " << strerror(errno) << std::endl;
+        return false;
+    }
+    segments_.clear();
+    while (struct dirent* ent = readdir(dir)) {
+        unsigned first = 0;
+        int date = 0;
+        char tail[8] = {0};
+        if (sscanf(ent->d_name, "%10u-%8d%7s", &first, &date, tail) == 3 && strcmp(tail, ".idx") == 0 && first > 0) {
+            SegmentPtr seg = std::make_shared<Segment>();
+            seg->first_seq = first;
+            seg->date = date;
+            segments_.push_back(seg);
+        }
+    }
+    closedir(dir);
+    std::sort(segments_.begin(), segments_.end(),
+              [](const SegmentPtr& a, const SegmentPtr& b) { return a->first_seq < b->first_seq; });
+
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        if (!open_segment(segments_[i], false)) {
+            segments_.clear();
+            return false;
+        }
+    }
+    // 이전 segment 는 인덱스 파일 크기로 메시지 수만 알고 (lazy), 마지막 segment 만 읽어서 꼬리를 정리한다
+    if (!segments_.empty() && !repair_tail(*segments_.back())) {
+        segments_.clear();
+        return false;
+    }
+    if (segments_.empty()) {
+        SegmentPtr seg = std::make_shared<Segment>();
+        seg->first_seq = 1;
+        seg->date = today();
+        seg->index_loaded = true;
+        if (!open_segment(seg, true)) {
+            return false;
+        }
+        segments_.push_back(seg);
+    }
+
+    uint32_t total = 0;
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        if (i > 0 && segments_[i - 1]->end_seq() != segments_[i]->first_seq) {
+            std::cout << "SEGMENT_SAM: sequence gap between segments " << segments_[i - 1]->index_path
+                      << " and " << segments_[i]->index_path << std::endl;
+        }
+        total += segments_[i]->count;
+    }
+    first_seq_.store(segments_.front()->first_seq, std::memory_order_relaxed);
+    next_sequence_.store(segments_.back()->end_seq(), std::memory_order_relaxed);
+    message_count_.store(total, std::memory_order_release);
+
+    apply_retention_locked();
+    std::cout << "SEGMENT_SAM: " << dir_path_ << " opened with " << segments_.size() << " segments (seq "
+              << first_seq_.load() << "-" << next_sequence_.load() - 1 << ")" << std::endl;
+    is_open_ = true;
+    return true;
+}
+
+void SEGMENT_SAM::close() {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_open_) {
+        return;
+    }
+    is_open_ = false;
+    if (!segments_.empty()) {
+        const SegmentPtr& active = segments_.back();
+        fdatasync(active->data_fd);
+        fdatasync(active->index_fd);
+    }
+    segments_.clear();
+}
+
+bool SEGMENT_SAM::put(const void* data, size_t size) {
+    return put(data, size, now_ns());
+}
+
+bool SEGMENT_SAM::put(const void* data, size_t size, uint64_t timestamp) {
+    MessageSlice item = {data, size};
+    return put_batch(&item, 1, timestamp);
+}
+
+bool SEGMENT_SAM::put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_open_) {
+        return false;
+    }
+    if (policy_.roll_daily && segments_.back()->count > 0 && today() != segments_.back()->date) {
+        if (!roll_segment_locked(today())) {
+            return false;
+        }
+    }
+
+    size_t i = 0;
+    while (i < count) {
+        // 지금 segment 에 들어가는 만큼 한번에 기록 (빈 segment 에는 segment_bytes 보다 큰 메시지도 하나는 넣는다)
+        const Segment& seg = *segments_.back();
+        int64_t limit = static_cast<int64_t>(policy_.segment_bytes);
+        int64_t end = seg.data_end;
+        size_t j = i;
+        while (j < count && (end + static_cast<int64_t>(items[j].size) <= limit || (seg.count == 0 && j == i))) {
+            end += static_cast<int64_t>(items[j].size);
+            j++;
+        }
+        if (j == i) {
+            if (!roll_segment_locked(today())) {
+                return false;
+            }
+            continue;
+        }
+        if (!write_run(items + i, j - i, timestamp)) {
+            return false;
+        }
+        i = j;
+    }
+    return true;
+}
+
+bool SEGMENT_SAM::write_run(const MessageSlice* items, size_t count, uint64_t timestamp) {
+    Segment& seg = *segments_.back();
+    uint32_t seq = seg.end_seq();
+    size_t old_count = seg.index.size();
+
+    // 데이터 먼저, 인덱스는 그 다음 (repair_tail 이 인덱스 기준으로 정리)
+    int64_t position = seg.data_end;
+    struct iovec iov[WRITE_IOV_MAX];
+    for (size_t i = 0; i < count; i += WRITE_IOV_MAX) {
+        size_t n = std::min(WRITE_IOV_MAX, count - i);
+        size_t bytes = 0;
+        for (size_t k = 0; k < n; ++k) {
+            iov[k].iov_base = const_cast<void*>(items[i + k].data);
+            iov[k].iov_len = items[i + k].size;
+            bytes += items[i + k].size;
+        }
+        ssize_t written = ::pwritev(seg.data_fd, iov, static_cast<int>(n), static_cast<off_t>(position));
+        if (written != static_cast<ssize_t>(bytes)) {
+            // 짧게 쓰인 (또는 EINTR) 나머지는 pwrite 로 이어 쓴다
+            bool ok = written >= 0 || errno == EINTR;
+            size_t done = written > 0 ? static_cast<size_t>(written) : 0;
+            int64_t at = position;
+            for (size_t k = 0; k < n && ok; ++k) {
+                size_t len = items[i + k].size;
+                if (done >= len) {
+                    done -= len;
+                } else {
+                    ok = pwrite_full(seg.data_fd, static_cast<const char*>(items[i + k].data) + done, len - done,
+                                     at + static_cast<int64_t>(done));
+                    done = 0;
+                }
+                at += static_cast<int64_t>(len);
+            }
+            if (!ok) {
+                std::cerr << "SEGMENT_SAM: data write failed on " << seg.data_path << ": " << strerror(errno) << std::endl;
+                seg.index.resize(old_count);
+                return false;
+            }
+        }
+        for (size_t k = 0; k < n; ++k) {
+            SAM_INDEX index;
+            index._seek = position;
+            index._size = static_cast<uint32_t>(items[i + k].size);
+            index._seq = seq++;
+            index._timestamp = timestamp;
+            seg.index.push_back(index);
+            position += items[i + k].size;
+        }
+    }
+
+    if (!pwrite_full(seg.index_fd, seg.index.data() + old_count, count * sizeof(SAM_INDEX),
+                     static_cast<int64_t>(old_count) * sizeof(SAM_INDEX))) {
+        std::cerr << "SEGMENT_SAM: index write failed on " << seg.index_path << ": " << strerror(errno) << std::endl;
+        seg.index.resize(old_count);
+        return false;
+    }
+
+    seg.count += static_cast<uint32_t>(count);
+    seg.data_end = position;
+    next_sequence_.store(seq, std::memory_order_release);
+    message_count_.store(message_count_.load(std::memory_order_relaxed) + static_cast<uint32_t>(count),
+                         std::memory_order_release);
+    return true;
+}
+
+bool SEGMENT_SAM::roll_segment() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_open_) {
+        return false;
+    }
+    return segments_.back()->count == 0 || roll_segment_locked(today());
+}
+
+bool SEGMENT_SAM::roll_segment_locked(int date) {
+    SegmentPtr active = segments_.back();
+    SegmentPtr seg = std::make_shared<Segment>();
+    seg->first_seq = active->end_seq();
+    seg->date = date;
+    seg->index_loaded = true;
+
+    if (active->count == 0) {
+        // 빈 segment 는 날짜만 바꿔서 다시 만든다
+        if (active->date == date) {
+            return true;
+        }
+        ::unlink(active->index_path.c_str());
+        ::unlink(active->data_path.c_str());
+        segments_.pop_back();
+    } else {
+        fdatasync(active->data_fd);
+        fdatasync(active->index_fd);
+        // 지난 segment 의 인덱스는 다음 조회 때 다시 읽는다
+        std::vector<SAM_INDEX>().swap(active->index);
+        active->index_loaded = false;
+    }
+
+    if (!open_segment(seg, true)) {
+        if (segments_.empty()) {
+            is_open_ = false;
+        }
+        return false;
+    }
+    segments_.push_back(seg);
+    std::cout << "SEGMENT_SAM: new segment " << seg->data_path << std::endl;
+    apply_retention_locked();
+    return true;
+}
+
+void SEGMENT_SAM::apply_retention_locked() {
+    while (policy_.max_segments > 0 && segments_.size() > policy_.max_segments && segments_.size() > 1) {
+        retire_front_locked();
+    }
+    if (policy_.retain_days > 0) {
+        // 최근 retain_days 개 날짜 (휴일은 segment 가 없으므로 영업일 기준) 보다 오래된 segment 정리
+        uint32_t dates = 0;
+        int cutoff = 0;
+        for (size_t i = segments_.size(); i-- > 0;) {
+            if (i + 1 == segments_.size() || segments_[i]->date != segments_[i + 1]->date) {
+                if (++dates > policy_.retain_days) break;
+                cutoff = segments_[i]->date;
+            }
+        }
+        while (segments_.size() > 1 && segments_.front()->date < cutoff) {
+            retire_front_locked();
+        }
+    }
+}
+
+void SEGMENT_SAM::retire_front_locked() {
+    SegmentPtr seg = segments_.front();
+    segments_.erase(segments_.begin());
+    // 읽고 있는 reader 가 있으면 fd 는 shared_ptr 가 해제될 때 닫힌다
+    ::unlink(seg->index_path.c_str());
+    ::unlink(seg->data_path.c_str());
+    retired_segments_++;
+    first_seq_.store(segments_.front()->first_seq, std::memory_order_release);
+    message_count_.store(message_count_.load(std::memory_order_relaxed) - seg->count, std::memory_order_release);
+    std::cout << "SEGMENT_SAM: retired segment " << seg->data_path << " (seq " << seg->first_seq << "-"
+              << seg->end_seq() - 1 << ")" << std::endl;
+}
+
+size_t SEGMENT_SAM::retire_before(uint32_t seq) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t retired = 0;
+    while (is_open_ && segments_.size() > 1 && segments_.front()->end_seq() <= seq) {
+        retire_front_locked();
+        retired++;
+    }
+    return retired;
+}
+
+bool SEGMENT_SAM::compact() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_open_) {
+        return false;
+    }
+    apply_retention_locked();
+    return true;
+}
+
+size_t SEGMENT_SAM::segment_count() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_.size();
+}
+
+SEGMENT_SAM::SegmentPtr SEGMENT_SAM::find_segment(uint32_t seq) const {
+    // seq 를 포함하거나 seq 뒤에 처음 오는 segment
+    auto it = std::upper_bound(segments_.begin(), segments_.end(), seq,
+                               [](uint32_t s, const SegmentPtr& seg) { return s < seg->first_seq; });
+    if (it != segments_.begin() && seq < (*(it - 1))->end_seq()) {
+        return *(it - 1);
+    }
+    return it != segments_.end() ? *it : SegmentPtr();
+}
+
+bool SEGMENT_SAM::read_index_locked(uint32_t seq, SAM_INDEX& index, SegmentPtr& seg) const {
+    seg = find_segment(seq);
+    if (!seg || seq < seg->first_seq || seq >= seg->end_seq() || !load_segment_index(*seg)) {
+        return false;
+    }
+    index = seg->index[seq - seg->first_seq];
+    return index._seq == seq;
+}
+
+bool SEGMENT_SAM::segment_first_time(const Segment& seg, uint64_t& timestamp) const {
+    if (seg.count == 0) {
+        return false;
+    }
+    if (seg.index_loaded) {
+        timestamp = seg.index[0]._timestamp;
+        return true;
+    }
+    SAM_INDEX first;
+    if (!pread_full(seg.index_fd, &first, sizeof(first), 0)) {
+        return false;
+    }
+    timestamp = first._timestamp;
+    return true;
+}
+
+bool SEGMENT_SAM::get_index(uint32_t seq, SAM_INDEX& index) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    SegmentPtr seg;
+    return is_open_ && read_index_locked(seq, index, seg);
+}
+
+uint32_t SEGMENT_SAM::seek_time(uint64_t timestamp) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!is_open_) {
+        return 0;
+    }
+
+    // 첫 timestamp 가 timestamp 이상인 첫 segment - 답은 그 앞 segment 안에 있거나 그 segment 의 첫 seq
+    size_t lo = 0, hi = segments_.size();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        uint64_t first_ts;
+        if (segment_first_time(*segments_[mid], first_ts) && first_ts >= timestamp) {
+            hi = mid;
+        } else {
+            lo = mid + 1;
+        }
+    }
+
+    if (lo > 0) {
+        Segment& prev = *segments_[lo - 1];
+        if (prev.count > 0 && load_segment_index(prev)) {
+            auto it = std::lower_bound(prev.index.begin(), prev.index.end(), timestamp,
+                                       [](const SAM_INDEX& e, uint64_t t) { return e._timestamp < t; });
+            if (it != prev.index.end()) {
+                return it->_seq;
+            }
+        }
+    }
+    for (size_t i = lo; i < segments_.size(); ++i) {
+        if (segments_[i]->count > 0) {
+            return segments_[i]->first_seq;
+        }
+    }
+    return 0;
+}
+
+bool SEGMENT_SAM::get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_size) const {
+    SegmentPtr seg;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!is_open_ || !buffer_size || !read_index_locked(seq, index, seg)) {
+            return false;
+        }
+    }
+    if (!pread_full(seg->data_fd, buffer, index._size, index._seek)) {
+        return false;
+    }
+    *buffer_size = index._size;
+    return true;
+}
+
+bool SEGMENT_SAM::get(uint32_t seq, std::string& data) const {
+    SegmentPtr seg;
+    SAM_INDEX index;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!is_open_ || !read_index_locked(seq, index, seg)) {
+            return false;
+        }
+    }
+    data.resize(index._size);
+    return index._size == 0 || pread_full(seg->data_fd, &data[0], index._size, index._seek);
+}
+
+bool SEGMENT_SAM::get_range(uint32_t start_seq, uint32_t end_seq,
+                            std::function<bool(uint32_t seq, const SAM_INDEX& index, const void* data, size_t size)> callback) const {
+    if (!is_open_ || start_seq > end_seq) {
+        return false;
+    }
+    if (start_seq < first_seq() && first_seq() > 1) {
+        return false;   // 보존 정책으로 지운 구간 (min_seq 부터 다시 요청)
+    }
+
+    std::vector<SAM_INDEX> slice;
+    std::vector<char> buffer;
+    uint32_t seq = start_seq;
+    while (seq <= end_seq) {
+        // segment 하나 구간의 인덱스만 복사해두고 본문은 락 밖에서 읽는다
+        SegmentPtr seg;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            seg = find_segment(seq);
+            if (!seg || seg->count == 0 || !load_segment_index(*seg)) {
+                break;
+            }
+            seq = std::max(seq, seg->first_seq);
+            uint32_t last = std::min(end_seq, seg->end_seq() - 1);
+            if (seq > last) {
+                break;
+            }
+            slice.assign(seg->index.begin() + (seq - seg->first_seq), seg->index.begin() + (last - seg->first_seq) + 1);
+        }
+
+        // segment 안의 메시지는 연속 저장되어 있으므로 RANGE_READ_BYTES 씩 묶어서 pread
+        size_t i = 0;
+        while (i < slice.size()) {
+            int64_t begin = slice[i]._seek;
+            size_t j = i + 1;
+            while (j < slice.size() && slice[j]._seek == slice[j - 1]._seek + slice[j - 1]._size &&
+                   static_cast<size_t>(slice[j]._seek + slice[j]._size - begin) <= RANGE_READ_BYTES) {
+                j++;
+            }
+            size_t bytes = static_cast<size_t>(slice[j - 1]._seek + slice[j - 1]._size - begin);
+            if (buffer.size() < bytes) {
+                buffer.resize(bytes);
+            }
+            if (!pread_full(seg->data_fd, buffer.data(), bytes, begin)) {
+                std::cerr << "SEGMENT_SAM: failed to read " << seg->data_path << " at " << begin << std::endl;
+                return true;
+            }
+            for (size_t k = i; k < j; ++k) {
+                if (!callback(slice[k]._seq, slice[k], buffer.data() + (slice[k]._seek - begin), slice[k]._size)) {
+                    return true;    // Callback requested to stop
+                }
+            }
+            i = j;
+        }
+        seq = slice.back()._seq + 1;
+    }
+    return true;
+}
+
+bool SEGMENT_SAM::get_data_region(uint32_t start_seq, uint32_t end_seq, MessageDataRegion& region) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_open_ || start_seq < 1 || start_seq > end_seq) {
+        return false;
+    }
+    SAM_INDEX first, last;
+    SegmentPtr seg;
+    if (!read_index_locked(start_seq, first, seg)) {
+        return false;
+    }
+    // segment 경계에서 끊는다 (호출한 쪽이 region.end_seq 다음부터 다시 요청)
+    end_seq = std::min(end_seq, seg->end_seq() - 1);
+    last = seg->index[end_seq - seg->first_seq];
+
+    region.path = seg->data_path;
+    region.offset = first._seek;
+    region.length = last._seek + last._size - first._seek;
+    region.start_seq = start_seq;
+    region.end_seq = end_seq;
+    return region.length > 0;
+}
+
+bool SEGMENT_SAM::verify_integrity() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_open_) {
+        return false;
+    }
+    uint32_t total = 0;
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        Segment& seg = *segments_[i];
+        if (!load_segment_index(seg)) {
+            return false;
+        }
+        int64_t data_end = 0;
+        for (uint32_t pos = 0; pos < seg.count; ++pos) {
+            const SAM_INDEX& e = seg.index[pos];
+            if (e._seq != seg.first_seq + pos || e._seek != data_end) {
+                return false;
+            }
+            data_end = e._seek + e._size;
+        }
+        if (data_end > file_size(seg.data_fd)) {
+            return false;
+        }
+        total += seg.count;
+    }
+    return total == message_count_.load(std::memory_order_acquire);
+}
+
+int64_t SEGMENT_SAM::get_data_file_size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    if (!is_open_) {
+        return -1;
+    }
+    int64_t total = 0;
+    for (size_t i = 0; i < segments_.size(); ++i) {
+        total += segments_[i]->data_end;
+    }
+    return total;
+}
+
+int64_t SEGMENT_SAM::get_index_file_size() const {
+    return is_open_ ? static_cast<int64_t>(count()) * sizeof(SAM_INDEX) : -1;
+}
@@ -0,0 +1,138 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cstdint>
+#include <functional>
+#include "MessageDB.h"
+
+// SEGMENT_SAM segment / 보존 정책
+struct SegmentPolicy {
+    size_t segment_bytes;       // segment 데이터 파일 크기 (fallocate 로 미리 확보, 넘으면 새 segment)
+    uint32_t retain_days;       // 최근 N 일 (segment 날짜 기준) 만 보존, 0: 날짜로 정리하지 않음
+    uint32_t max_segments;      // segment 수 상한, 0: 제한 없음
+    bool roll_daily;            // 날짜 (local yyyymmdd) 가 바뀌면 새 segment
+
+    SegmentPolicy(size_t bytes = 256 * 1024 * 1024, uint32_t days = 0, uint32_t segments = 0, bool daily = true)
+        : segment_bytes(bytes), retain_days(days), max_segments(segments), roll_daily(daily) {}
+};
+
+/**
+ * SEGMENT_SAM - segment 파일로 나눈 append-only Sequential Access Message Database
+ *
+ * <base>.seg/ 디렉터리 아래 segment 마다 DB_SAM 과 같은 형식의 파일 쌍을 둔다.
+ *   <first_seq 10자리>-<yyyymmdd>.idx  : SAM_INDEX 배열 (_seek 는 segment 데이터 파일 안 위치)
+ *   <first_seq 10자리>-<yyyymmdd>.data : 메시지 본문
+ * segment 디렉터리는 파일 이름으로 만들기 때문에 별도 manifest 가 없고, 이름만 보고 seq 구간과 날짜를 안다.
+ *  - 데이터 / 인덱스 파일은 fallocate(KEEP_SIZE) 로 미리 공간을 잡고 pwrite 로 이어 쓴다 (파일 크기 = 실제 기록 크기).
+ *  - segment_bytes 를 넘거나 날짜가 바뀌면 (roll_daily) 새 segment 를 연다. sequence 는 segment 를 넘어 이어진다.
+ *  - 보존 정책 (retain_days / max_segments) 에 걸린 오래된 segment 는 파일 unlink 로 통째로 지운다 (retire_before 도 같음).
+ *    지운 구간의 seq 는 더 이상 조회되지 않는다 (get_range 도 min_seq 앞에서 시작하면 false).
+ *  - open 시 마지막 segment 인덱스만 읽고, 이전 segment 인덱스는 처음 조회할 때 읽는다.
+ *  - get / get_range 는 segment 디렉터리와 인덱스만 mutex_ 안에서 보고 본문은 락 밖에서 pread 한다.
+ *    retire 된 segment 도 읽는 동안은 fd 가 열려 있다 (shared_ptr).
+ *  - get_data_region 은 한 segment 안의 구간만 돌려준다 (region.end_seq 다음부터 다시 요청).
+ *  - seek_time 은 segment 첫 timestamp 를 segment 단위의 성긴 시간 인덱스로 쓴다 (인덱스는 해당 segment 것만 읽음).
+ */
+class SEGMENT_SAM : public MessageDB {
+private:
+    struct Segment {
+        uint32_t first_seq;
+        int date;                           // yyyymmdd
+        std::string index_path;
+        std::string data_path;
+        int index_fd;
+        int data_fd;
+        uint32_t count;                     // 기록된 메시지 수
+        int64_t data_end;                   // 다음 기록 위치
+        bool index_loaded;
+        std::vector<SAM_INDEX> index;       // index_loaded 인 segment 의 인덱스 (count 개)
+
+        Segment() : first_seq(0), date(0), index_fd(-1), data_fd(-1), count(0), data_end(0), index_loaded(false) {}
+        ~Segment();
+        uint32_t end_seq() const { return first_seq + count; }     // 다음 segment 의 first_seq
+    };
+    typedef std::shared_ptr<Segment> SegmentPtr;
+
+    std::string base_path_;
+    std::string dir_path_;
+    SegmentPolicy policy_;
+
+    std::vector<SegmentPtr> segments_;      // first_seq 순, back() 이 기록 중인 segment
+    std::atomic<uint32_t> first_seq_;       // 보존 중인 첫 sequence
+    std::atomic<uint32_t> next_sequence_;
+    std::atomic<uint32_t> message_count_;   // 보존 중인 메시지 수
+    uint32_t retired_segments_;
+
+    int64_t date_checked_sec_;              // 마지막으로 날짜를 계산한 시간 (time())
+    int current_date_;
+
+    mutable std::mutex mutex_;
+    std::atomic<bool> is_open_;
+
+    std::string segment_name(uint32_t first_seq, int date) const;
+    bool open_segment(const SegmentPtr& seg, bool create);
+    bool load_segment_index(Segment& seg) const;
+    /* 마지막 segment 의 불완전한 꼬리 (인덱스 없는 데이터 / 일부만 쓴 인덱스) 정리 */
+    bool repair_tail(Segment& seg);
+    bool roll_segment_locked(int date);
+    void apply_retention_locked();
+    void retire_front_locked();
+    int today();
+
+    /* seq 가 들어 있는 segment (mutex_ 잡은 상태) */
+    SegmentPtr find_segment(uint32_t seq) const;
+    bool read_index_locked(uint32_t seq, SAM_INDEX& index, SegmentPtr& seg) const;
+    /* segment 첫 메시지 timestamp (인덱스를 읽지 않은 segment 는 첫 항목만 pread) */
+    bool segment_first_time(const Segment& seg, uint64_t& timestamp) const;
+    bool write_run(const MessageSlice* items, size_t count, uint64_t timestamp);
+
+public:
+    explicit SEGMENT_SAM(const std::string& base_path, const SegmentPolicy& policy = SegmentPolicy());
+    virtual ~SEGMENT_SAM();
+
+    // MessageDB 인터페이스 구현
+    bool open() override;
+    void close() override;
+    bool isOpen() const override { return is_open_; }
+
+    bool put(const void* data, size_t size) override;
+    bool put(const void* data, size_t size, uint64_t timestamp) override;
+    bool put_batch(const MessageSlice* items, size_t count, uint64_t timestamp) override;
+
+    bool get(uint32_t seq, SAM_INDEX& index, void* buffer, uint32_t* buffer_size) const override;
+    bool get(uint32_t seq, std::string& data) const override;
+
+    uint32_t count() const override { return message_count_.load(std::memory_order_acquire); }
+    uint32_t get_next_sequence() const override { return next_sequence_.load(std::memory_order_acquire); }
+    uint32_t max_seq() const override { return next_sequence_.load(std::memory_order_acquire) - 1; }
+    uint32_t min_seq() const override { return max_seq() > 0 ? first_seq() : 0; }
+
+    bool get_index(uint32_t seq, SAM_INDEX& index) const override;
+    /* segment 첫 timestamp 로 segment 를 고르고 그 segment 인덱스 안에서만 이분 탐색 */
+    uint32_t seek_time(uint64_t timestamp) const override;
+
+    bool get_range(uint32_t start_seq, uint32_t end_seq,
+                   std::function<bool(uint32_t seq, const SAM_INDEX& index, const void* data, size_t size)> callback) const override;
+    bool get_data_region(uint32_t start_seq, uint32_t end_seq, MessageDataRegion& region) const override;
+
+    bool verify_integrity() const override;
+    /* 보존 정책 적용 (오래된 segment 정리) */
+    bool compact() override;
+
+    int64_t get_data_file_size() const override;
+    int64_t get_index_file_size() const override;
+
+    /* 지금 segment 를 닫고 새 segment 시작 (비어 있으면 무시) */
+    bool roll_segment();
+    /* seq 보다 앞의 메시지만 들어 있는 segment 를 모두 지움, 지운 segment 수 반환 (기록 중인 segment 는 남김) */
+    size_t retire_before(uint32_t seq);
+
+    uint32_t first_seq() const { return first_seq_.load(std::memory_order_acquire); }
+    size_t segment_count() const;
+    const std::string& get_base_path() const { return base_path_; }
+    const std::string& get_dir_path() const { return dir_path_; }
+};
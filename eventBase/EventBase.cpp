@@ -1,5 +1,7 @@
 #include "EventBase.h"
 #include "EventUnixDomainSocket.h"
+#include "EventTcpSocket.h"
+#include "EventUdpSocket.h"
 #include "EventTimer.h"
 #include <string>
 #include <iostream>
@@ -71,6 +73,10 @@ void EventBase::resume() {
     _paused = false;
 }
 
+void EventBase::setBatchReadCallback(Protocol::BatchCallback callback) {
+    _batch_read_cb = callback;
+}
+
 void EventBase::setReadCallback(std::function<void(char *data, int size)> callback) {
     _read_cb = std::move(callback);
 }
@@ -191,22 +197,34 @@ void EventBase::static_read_cb(struct bufferevent *bev, void *ctx) {
     EventBase* self = static_cast<EventBase*>(ctx);
     struct evbuffer *input = bufferevent_get_input(bev);
     
-    if (self->_protocol) {
+    if (self->_protocol && self->_batch_read_cb) {
+        // chain 안의 메시지는 제자리, 경계에 걸친 메시지만 복사해 한번에 전달
+        self->_protocol->parseBatch(input, self->_batch_read_cb);
+    } else if (self->_protocol) {
         // Protocol parser 사용 (Zero-Copy)
-        size_t consumed = self->_protocol->parseBuffer(input, [self](const char* data, size_t len) {
+        self->_protocol->parseBuffer(input, [self](const char* data, size_t len) {
             self->call_read_callback(const_cast<char*>(data), len);
         });
-        std::cout << "[EventBase] static_read_cb consumed: " << consumed << std::endl;
         // evbuffer_drain(input, consumed); // protocol 에서 처리하므로 여기서는 처리하지 않음
     } else {
-        // 기본 동작 (기존 Raw 방식)
-        size_t len = evbuffer_get_length(input);
-        if (len > 0) {
-            char *data = new char[len + 1];
-            evbuffer_remove(input, data, len);
-            data[len] = '\0';
-            self->call_read_callback(data, len);
-            delete[] data;
+        // 기본 동작 (Raw): chain 마다 제자리 전달 후 drain (복사/할당 없음, NUL 종료 아님)
+        struct evbuffer_iovec iov[8];
+        while (evbuffer_get_length(input) > 0) {
+            int n = evbuffer_peek(input, -1, nullptr, iov, 8);
+            if (n <= 0) {
+                break;
+            }
+            if (n > 8) n = 8;
+            size_t delivered = 0;
+            for (int i = 0; i < n; ++i) {
+                if (iov[i].iov_len == 0) continue;
+                self->call_read_callback(static_cast<char*>(iov[i].iov_base), static_cast<int>(iov[i].iov_len));
+                delivered += iov[i].iov_len;
+            }
+            evbuffer_drain(input, delivered);
+            if (delivered == 0) {
+                break;
+            }
         }
     }
 }
@@ -242,6 +260,10 @@ void EventBase::static_accept_cb(struct evconnlistener *listener, evutil_socket_
 EventBase* createEventBase(std::string type, struct event_base* base, bool base_owned) {
     if (type == "unix_domain_socket") {
         return new EventUnixDomainSocket(base, base_owned);
+    } else if (type == "tcp_socket") {
+        return new EventTcpSocket(base, base_owned);
+    } else if (type == "udp_socket") {
+        return new EventUdpSocket(base, base_owned);
     } else if (type == "timer") {
         return new EventTimer(base, base_owned);
     }
@@ -29,6 +29,7 @@ protected:
     std::string _path;  // socket path for unix domain socket, address for TCP/UDP
 
     std::function<void(char *data, int size)> _read_cb;
+    Protocol::BatchCallback _batch_read_cb;     // 설정 시 _read_cb 대신 read callback 한번에 파싱된 메시지 전체 전달
     std::function<void(char *data, int size)> _write_cb;
     std::function<void(char *data, int size)> _connect_cb;
     std::function<void(char *data, int size)> _disconnect_cb;
@@ -71,6 +72,8 @@ public:
 
     /* set callback */
     void setReadCallback(std::function<void(char *data, int size)> callback);
+    /* Protocol 사용 시 read 한번에 파싱된 메시지들을 묶어서 전달 (setReadCallback 보다 우선) */
+    void setBatchReadCallback(Protocol::BatchCallback callback);
     void setWriteCallback(std::function<void(char *data, int size)> callback);
     void setConnectCallback(std::function<void(char *data, int size)> callback);
     void setDisconnectCallback(std::function<void(char *data, int size)> callback);
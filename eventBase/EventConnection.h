@@ -0,0 +1,158 @@
+#ifndef EVENT_CONNECTION_H
+#define EVENT_CONNECTION_H
+
+#include <event2/event.h>
+#include <event2/bufferevent.h>
+#include <event2/buffer.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <functional>
+#include "FrameParser.h"
+
+/**
+ * EventConnection<ProtocolT, HandlerT> - compile-time dispatch 소켓 연결
+ *
+ * EventBase + Protocol 과 같은 bufferevent 연결이지만 프레임 해석 (ProtocolT) 과 콜백 (HandlerT)
+ * 을 template 으로 받아 read callback 안에서 virtual / std::function 호출 없이 inline 으로 처리한다.
+ * 수신 버퍼는 연결마다 하나 (FrameParser) 를 재사용하므로 read 마다 할당이 없다.
+ * 구독자처럼 read callback 이 가장 안쪽 루프인 곳에 쓰고, 그 외에는 기존 EventBase API 를 그대로 쓴다.
+ *
+ * ProtocolT : Protocol.h 의 frame decoder (LengthPrefixedFrame, MagicFrame, PubSubTopicFrame ...)
+ * HandlerT  : 아래 멤버 함수를 가진 타입
+ *   void on_frames(const ProtocolMessage* messages, size_t count);   // read 한번에 파싱된 메시지 전체
+ *   void on_connected();
+ *   void on_disconnected();    // EOF, 호출 후 bufferevent 해제
+ *   void on_error();           // 연결 오류, 호출 후 bufferevent 해제
+ * 콜백 안에서 EventConnection 을 delete 하면 안 된다 (재연결은 event_base_once 등으로 미룬다).
+ * set_socket_setup 으로 connect 전에 socket 옵션을 걸 수 있다 (SO_RCVBUF 는 SYN 의 window scale 에 반영되어야 함).
+ * 한 loop 에 연결이 많으면 set_frame_parser 로 수신 버퍼 (iovec / scratch / batch 배열) 를 하나로 공유한다.
+ */
+template <typename ProtocolT, typename HandlerT>
+class EventConnection {
+private:
+    struct event_base* _base;
+    bufferevent* _bev;
+    HandlerT& _handler;
+    ProtocolT _protocol;
+    FrameParser _frames;
+    FrameParser* _parser;       // 기본은 _frames, set_frame_parser 로 같은 base 의 연결끼리 공유
+    std::function<void(evutil_socket_t fd)> _setup;
+
+    void attach() {
+        bufferevent_setcb(_bev, &EventConnection::static_read_cb, nullptr, &EventConnection::static_event_cb, this);
+        bufferevent_enable(_bev, EV_READ | EV_WRITE);
+    }
+
+    void connect_addr(const struct sockaddr* addr, int addr_len) {
+        close();
+        evutil_socket_t fd = -1;
+        if (_setup) {
+            fd = socket(addr->sa_family, SOCK_STREAM, 0);
+            if (fd < 0) {
+                throw std::runtime_error("Failed to create socket");
+            }
+            evutil_make_socket_nonblocking(fd);
+            _setup(fd);
+        }
+        _bev = bufferevent_socket_new(_base, fd, BEV_OPT_CLOSE_ON_FREE);
+        if (_bev == nullptr) {
+            if (fd >= 0) evutil_closesocket(fd);
+            throw std::runtime_error("Failed to create bufferevent");
+        }
+        attach();
+        if (bufferevent_socket_connect(_bev, const_cast<struct sockaddr*>(addr), addr_len) < 0) {
+            bufferevent_free(_bev);
+            _bev = nullptr;
+            throw std::runtime_error("Failed to connect");
+        }
+    }
+
+    static void static_read_cb(struct bufferevent* bev, void* ctx) {
+        EventConnection* self = static_cast<EventConnection*>(ctx);
+        const ProtocolT& protocol = self->_protocol;
+        HandlerT& handler = self->_handler;
+        self->_parser->parse(bufferevent_get_input(bev), protocol.header_size(),
+            [&protocol](const char* p, size_t avail, FrameInfo& frame) { return protocol.decode(p, avail, frame); },
+            [&handler](const ProtocolMessage* messages, size_t count) { handler.on_frames(messages, count); });
+    }
+
+    static void static_event_cb(struct bufferevent* bev, short events, void* ctx) {
+        EventConnection* self = static_cast<EventConnection*>(ctx);
+        if (events & BEV_EVENT_CONNECTED) {
+            self->_handler.on_connected();
+        }
+        if (events & BEV_EVENT_ERROR) {
+            self->_handler.on_error();
+            bufferevent_free(bev); self->_bev = nullptr;
+        } else if (events & BEV_EVENT_EOF) {
+            self->_handler.on_disconnected();
+            bufferevent_free(bev); self->_bev = nullptr;
+        }
+    }
+
+public:
+    EventConnection(struct event_base* base, HandlerT& handler, const ProtocolT& protocol = ProtocolT())
+        : _base(base), _bev(nullptr), _handler(handler), _protocol(protocol), _parser(&_frames) {}
+    ~EventConnection() { close(); }
+
+    EventConnection(const EventConnection&) = delete;
+    EventConnection& operator=(const EventConnection&) = delete;
+
+    ProtocolT& protocol() { return _protocol; }
+    bufferevent* getBev() { return _bev; }
+    /* connectTcp / connectUnix 가 만든 socket 에 connect 전에 호출 */
+    void set_socket_setup(std::function<void(evutil_socket_t fd)> setup) { _setup = std::move(setup); }
+    /* 수신 버퍼 공유 (같은 event_base 연결끼리만, parse 는 read callback 안에서 끝나므로 겹치지 않음), nullptr 이면 자기 것 */
+    void set_frame_parser(FrameParser* parser) { _parser = parser ? parser : &_frames; }
+
+    /* connect : "host:port" (EventTcpSocket 과 같은 형식) */
+    void connectTcp(const std::string& address) {
+        struct sockaddr_storage addr;
+        int addr_len = sizeof(addr);
+        memset(&addr, 0, sizeof(addr));
+        if (evutil_parse_sockaddr_port(address.c_str(), (struct sockaddr*)&addr, &addr_len) < 0) {
+            throw std::runtime_error("Invalid tcp address: " + address);
+        }
+        connect_addr((struct sockaddr*)&addr, addr_len);
+    }
+
+    /* connect : unix domain socket path */
+    void connectUnix(const std::string& path) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        std::strncpy(addr.sun_path, path.c_str(), sizeof(addr.sun_path) - 1);
+        connect_addr((struct sockaddr*)&addr, sizeof(addr));
+    }
+
+    /* accept 된 fd 로 연결 설정 (EventBase::setupBufferevent 와 같음) */
+    bool setupBufferevent(int fd) {
+        close();
+        _bev = bufferevent_socket_new(_base, fd, BEV_OPT_CLOSE_ON_FREE);
+        if (_bev == nullptr) {
+            return false;
+        }
+        attach();
+        return true;
+    }
+
+    /* ProtocolT::encode 로 output evbuffer 에 추가 */
+    bool trySend(const void* buffer, size_t size) {
+        if (_bev == nullptr) {
+            return false;
+        }
+        return _protocol.encode(bufferevent_get_output(_bev), buffer, size);
+    }
+
+    void close() {
+        if (_bev) {
+            bufferevent_free(_bev);
+            _bev = nullptr;
+        }
+    }
+};
+
+#endif // EVENT_CONNECTION_H
@@ -0,0 +1,39 @@
+#include "EventTcpSocket.h"
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <cstring>
+#include <stdexcept>
+#include <iostream>
+
+EventTcpSocket::EventTcpSocket(struct event_base* base, bool base_owned) : EventBase(base, base_owned), _connected(false) {
+}
+
+EventTcpSocket::~EventTcpSocket() {
+    // Note: _bev is handled by parent class EventBase destructor
+}
+
+void EventTcpSocket::connect(const std::string& address) {
+    _path = address;
+    struct sockaddr_storage addr;
+    int addr_len = sizeof(addr);
+    memset(&addr, 0, sizeof(addr));
+    if (evutil_parse_sockaddr_port(address.c_str(), (struct sockaddr*)&addr, &addr_len) < 0) {
+        throw std::runtime_error("Invalid tcp address: " + address);
+    }
+
+    _bev = bufferevent_socket_new(getBase(), -1, BEV_OPT_CLOSE_ON_FREE);
+    if (_bev == nullptr) {
+        throw std::runtime_error("Failed to create bufferevent");
+    }
+
+    bufferevent_setcb(_bev, EventBase::static_read_cb, EventBase::static_write_cb, EventBase::static_event_cb, this);
+    bufferevent_enable(_bev, EV_READ | EV_WRITE);
+
+    if (bufferevent_socket_connect(_bev, (struct sockaddr*)&addr, addr_len) < 0) {
+        bufferevent_free(_bev);
+        _bev = nullptr;
+        throw std::runtime_error("Failed to connect");
+    }
+    _connected = true;
+}
@@ -0,0 +1,25 @@
+#ifndef EVENTTCPSOCKET_H
+#define EVENTTCPSOCKET_H
+
+#include "EventBase.h"
+#include <event2/bufferevent.h>
+#include <string>
+
+/**
+ * EventTcpSocket 클래스 - TCP client 연결
+ *
+ * EventUnixDomainSocket 과 같은 방식으로 bufferevent 를 사용하며
+ * connect 인자는 "host:port" 형식 (예: "127.0.0.1:9998")
+ */
+class EventTcpSocket : public EventBase {
+private:
+    bool _connected;
+
+public:
+    EventTcpSocket(struct event_base* base, bool base_owned = false);
+    ~EventTcpSocket();
+    /* connect : "host:port" */
+    void connect(const std::string& address) override;
+};
+
+#endif // EVENTTCPSOCKET_H
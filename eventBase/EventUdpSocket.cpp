@@ -0,0 +1,187 @@
+#include "EventUdpSocket.h"
+#include <arpa/inet.h>
+#include <sys/socket.h>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+#include <unistd.h>
+#include <iostream>
+
+// wakeup 한번에 읽을 최대 datagram 수 (다른 이벤트가 굶지 않도록)
+static const int UDP_MAX_READS_PER_WAKEUP = 64;
+
+EventUdpSocket::EventUdpSocket(struct event_base* base, bool base_owned)
+    : EventBase(base, base_owned), _fd(-1), _multicast(false), _ttl(1), _loopback(true), _rcvbuf(0),
+      _datagrams_sent(0), _datagrams_received(0), _send_errors(0) {
+    memset(&_addr, 0, sizeof(_addr));
+}
+
+EventUdpSocket::~EventUdpSocket() {
+    close();
+}
+
+bool EventUdpSocket::open_socket(const std::string& address) {
+    close();
+    _path = address;
+
+    int len = sizeof(_addr);
+    memset(&_addr, 0, sizeof(_addr));
+    if (evutil_parse_sockaddr_port(address.c_str(), (struct sockaddr*)&_addr, &len) < 0 ||
+        _addr.sin_family != AF_INET) {
+        std::cerr << "Invalid udp address: " << address << std::endl;
+        return false;
+    }
+    _multicast = IN_MULTICAST(ntohl(_addr.sin_addr.s_addr));
+
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (_fd < 0) {
+        std::cerr << "Failed to create udp socket: " << strerror(errno) << std::endl;
+        return false;
+    }
+    evutil_make_socket_nonblocking(_fd);
+    evutil_make_socket_closeonexec(_fd);
+    return true;
+}
+
+void EventUdpSocket::connect(const std::string& address) {
+    if (!open_socket(address)) {
+        throw std::runtime_error("Failed to open udp socket: " + address);
+    }
+
+    if (_multicast) {
+        unsigned char ttl = static_cast<unsigned char>(_ttl);
+        unsigned char loop = _loopback ? 1 : 0;
+        setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_TTL, &ttl, sizeof(ttl));
+        setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+        if (!_interface.empty()) {
+            struct in_addr iface;
+            if (inet_pton(AF_INET, _interface.c_str(), &iface) != 1 ||
+                setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_IF, &iface, sizeof(iface)) < 0) {
+                std::cerr << "Failed to set multicast interface " << _interface << ": " << strerror(errno) << std::endl;
+            }
+        }
+    }
+
+    // connected UDP: send() 만으로 전송, 목적지 조회 비용 없음
+    if (::connect(_fd, (struct sockaddr*)&_addr, sizeof(_addr)) < 0) {
+        std::string err = strerror(errno);
+        close();
+        throw std::runtime_error("Failed to connect udp socket: " + err);
+    }
+    std::cout << "UDP sender ready: " << address << (_multicast ? " (multicast)" : "") << std::endl;
+}
+
+void EventUdpSocket::listen(const std::string& address, bool keep_alive, bool reuse_addr) {
+    (void)keep_alive;
+    if (!open_socket(address)) {
+        throw std::runtime_error("Failed to open udp socket: " + address);
+    }
+
+    if (reuse_addr) {
+        // 같은 호스트의 여러 구독자가 같은 그룹/포트를 받을 수 있도록
+        int on = 1;
+        setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+    }
+    if (_rcvbuf > 0) {
+        setsockopt(_fd, SOL_SOCKET, SO_RCVBUF, &_rcvbuf, sizeof(_rcvbuf));
+    }
+
+    struct sockaddr_in bind_addr = _addr;
+    if (_multicast) {
+        bind_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    }
+    if (bind(_fd, (struct sockaddr*)&bind_addr, sizeof(bind_addr)) < 0) {
+        std::string err = strerror(errno);
+        close();
+        throw std::runtime_error("Failed to bind udp socket " + address + ": " + err);
+    }
+
+    if (_multicast) {
+        struct ip_mreq mreq;
+        mreq.imr_multiaddr = _addr.sin_addr;
+        mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        if (!_interface.empty() && inet_pton(AF_INET, _interface.c_str(), &mreq.imr_interface) != 1) {
+            std::cerr << "Invalid multicast interface " << _interface << ", using default" << std::endl;
+            mreq.imr_interface.s_addr = htonl(INADDR_ANY);
+        }
+        if (setsockopt(_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) < 0) {
+            std::string err = strerror(errno);
+            close();
+            throw std::runtime_error("Failed to join multicast group " + address + ": " + err);
+        }
+    }
+
+    _recv_buf.resize(MAX_DATAGRAM_SIZE);
+    _event = event_new(getBase(), _fd, EV_READ | EV_PERSIST, static_udp_read_cb, this);
+    if (!_event || event_add(_event, nullptr) != 0) {
+        close();
+        throw std::runtime_error("Failed to add udp read event");
+    }
+    std::cout << "UDP receiver listening: " << address << (_multicast ? " (multicast joined)" : "") << std::endl;
+}
+
+void EventUdpSocket::close() {
+    if (_event) {
+        event_del(_event);
+        event_free(_event);
+        _event = nullptr;
+    }
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool EventUdpSocket::trySend(const void* buffer, size_t size) {
+    if (_fd < 0) {
+        return false;
+    }
+    ssize_t n = ::send(_fd, buffer, size, MSG_DONTWAIT);
+    if (n < 0 || static_cast<size_t>(n) != size) {
+        _send_errors++;
+        return false;
+    }
+    _datagrams_sent++;
+    return true;
+}
+
+bool EventUdpSocket::trySendv(const struct iovec* iov, int iovcnt) {
+    if (_fd < 0) {
+        return false;
+    }
+    size_t total = 0;
+    for (int i = 0; i < iovcnt; ++i) total += iov[i].iov_len;
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = const_cast<struct iovec*>(iov);
+    msg.msg_iovlen = iovcnt;
+    ssize_t n = ::sendmsg(_fd, &msg, MSG_DONTWAIT);
+    if (n < 0 || static_cast<size_t>(n) != total) {
+        _send_errors++;
+        return false;
+    }
+    _datagrams_sent++;
+    return true;
+}
+
+void EventUdpSocket::static_udp_read_cb(evutil_socket_t fd, short events, void* ctx) {
+    (void)events;
+    EventUdpSocket* self = static_cast<EventUdpSocket*>(ctx);
+    for (int i = 0; i < UDP_MAX_READS_PER_WAKEUP; ++i) {
+        ssize_t n = ::recv(fd, self->_recv_buf.data(), self->_recv_buf.size(), MSG_DONTWAIT);
+        if (n < 0) {
+            if (errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+                std::cerr << "UDP recv error: " << strerror(errno) << std::endl;
+                self->call_error_callback();
+            }
+            return;
+        }
+        self->_datagrams_received++;
+        self->call_read_callback(self->_recv_buf.data(), static_cast<int>(n));
+        // 콜백에서 close() 했을 수 있음
+        if (self->_fd < 0) {
+            return;
+        }
+    }
+}
@@ -0,0 +1,65 @@
+#ifndef EVENTUDPSOCKET_H
+#define EVENTUDPSOCKET_H
+
+#include "EventBase.h"
+#include <netinet/in.h>
+#include <sys/uio.h>
+#include <string>
+#include <vector>
+
+/**
+ * EventUdpSocket 클래스 - UDP (unicast/multicast) datagram 송수신
+ *
+ * stream 이 아니므로 bufferevent/Protocol 을 쓰지 않고 datagram 하나를 read callback 한번으로 전달한다.
+ * 주소는 "ip:port" 형식, ip 가 multicast 그룹(224.0.0.0/4)이면 그룹에 join/송신한다.
+ *
+ * 사용 예시:
+ *   송신: udp.setMulticastTtl(1); udp.connect("239.1.1.1:30001"); udp.trySend(buf, len);
+ *   수신: udp.setReadCallback(cb); udp.listen("239.1.1.1:30001");
+ */
+class EventUdpSocket : public EventBase {
+private:
+    int _fd;
+    struct sockaddr_in _addr;       // 송신 대상 또는 수신 그룹
+    bool _multicast;
+    std::string _interface;         // multicast 인터페이스 IP (비어있으면 기본 경로)
+    int _ttl;
+    bool _loopback;
+    int _rcvbuf;
+    std::vector<char> _recv_buf;
+    uint64_t _datagrams_sent;
+    uint64_t _datagrams_received;
+    uint64_t _send_errors;
+
+    bool open_socket(const std::string& address);
+    static void static_udp_read_cb(evutil_socket_t fd, short events, void* ctx);
+
+public:
+    static const size_t MAX_DATAGRAM_SIZE = 65507;
+
+    EventUdpSocket(struct event_base* base, bool base_owned = false);
+    ~EventUdpSocket();
+
+    /* 옵션은 connect/listen 전에 설정 */
+    void setMulticastInterface(const std::string& iface_ip) { _interface = iface_ip; }
+    void setMulticastTtl(int ttl) { _ttl = ttl; }
+    void setMulticastLoopback(bool enable) { _loopback = enable; }
+    void setReceiveBufferSize(int bytes) { _rcvbuf = bytes; }
+
+    /* connect : 송신 대상 "ip:port" */
+    void connect(const std::string& address) override;
+    /* listen : 수신 "ip:port" (multicast 그룹이면 join) */
+    void listen(const std::string& address, bool keep_alive = true, bool reuse_addr = true) override;
+    void close() override;
+
+    /* datagram 하나 송신 (블록하지 않음, 버퍼가 차면 false) */
+    bool trySend(const void* buffer, size_t size) override;
+    /* 여러 조각을 복사 없이 datagram 하나로 송신 (sendmsg) */
+    bool trySendv(const struct iovec* iov, int iovcnt);
+
+    uint64_t getDatagramsSent() const { return _datagrams_sent; }
+    uint64_t getDatagramsReceived() const { return _datagrams_received; }
+    uint64_t getSendErrors() const { return _send_errors; }
+};
+
+#endif // EVENTUDPSOCKET_H
@@ -0,0 +1,147 @@
+#ifndef FRAME_PARSER_H
+#define FRAME_PARSER_H
+
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <utility>
+#include <sys/uio.h>
+#include <event2/buffer.h>
+
+// parseBatch 로 한번에 전달되는 메시지 (evbuffer 내부 또는 scratch 버퍼를 가리킴, 콜백 안에서만 유효)
+struct ProtocolMessage {
+    const char* data;
+    size_t length;
+};
+
+// 프레임 해석 결과 (decodeFrame / frame decoder 의 decode)
+enum FrameStatus {
+    FRAME_OK,           // header + length 바이트가 한 메시지 (header 는 제외하고 전달)
+    FRAME_NEED_MORE,    // 헤더 판단에 더 많은 데이터 필요
+    FRAME_SKIP          // 알 수 없는 데이터, length 바이트 버림
+};
+
+struct FrameInfo {
+    size_t header;
+    size_t length;
+};
+
+/**
+ * evbuffer 를 프레임 단위로 나누는 공통 루프
+ *
+ * evbuffer_peek 으로 chain 을 순회하며 decode 로 프레임을 나눈다.
+ * chain 하나 안에 있는 메시지는 그 자리를 가리키고, chain 경계에 걸친 메시지만 scratch 로 복사한다.
+ * 완전한 메시지를 모아 sink(messages, count) 한번으로 전달하고 처리한 바이트를 drain 한다.
+ *
+ * decode / sink 가 template 인자라서 Protocol (virtual decodeFrame + std::function) 과
+ * EventConnection (inline decoder + handler 직접 호출) 이 같은 루프를 쓴다.
+ * 버퍼는 연결마다 하나 두고 재사용한다 (read callback 마다 할당 없음).
+ */
+class FrameParser {
+private:
+    std::vector<struct evbuffer_iovec> _iov;
+    std::vector<char> _scratch;
+    std::vector<ProtocolMessage> _batch;
+    std::vector<std::pair<size_t, size_t>> _scratch_refs;     // (_batch index, _scratch offset)
+
+    void gather(size_t chain, size_t offset, char* dst, size_t length) const {
+        while (length > 0 && chain < _iov.size()) {
+            size_t n = std::min(length, _iov[chain].iov_len - offset);
+            memcpy(dst, static_cast<const char*>(_iov[chain].iov_base) + offset, n);
+            dst += n;
+            length -= n;
+            ++chain;
+            offset = 0;
+        }
+    }
+
+public:
+    // decode(p, avail, frame) -> FrameStatus, p 는 프레임 시작의 연속된 min(header_size, avail) 바이트
+    template <typename DecodeFn, typename SinkFn>
+    size_t parse(struct evbuffer* input, size_t header_size, DecodeFn&& decode, SinkFn&& sink) {
+        size_t total = evbuffer_get_length(input);
+        if (total == 0) {
+            return 0;
+        }
+        int chains = evbuffer_peek(input, -1, nullptr, nullptr, 0);
+        if (chains <= 0) {
+            return 0;
+        }
+        _iov.resize(chains);
+        evbuffer_peek(input, -1, nullptr, _iov.data(), chains);
+        _batch.clear();
+        _scratch.clear();
+        _scratch_refs.clear();
+
+        char header[64];
+        size_t consumed = 0;        // 프레임 단위로 처리한 바이트
+        size_t chain = 0;           // consumed 위치의 chain
+        size_t offset = 0;          // chain 안의 위치
+
+        while (chain < _iov.size() && _iov[chain].iov_len == 0) {
+            ++chain;
+        }
+        while (consumed < total) {
+            size_t remaining = total - consumed;
+            size_t in_chain = _iov[chain].iov_len - offset;
+            const char* p = static_cast<const char*>(_iov[chain].iov_base) + offset;
+
+            // 헤더가 chain 경계에 걸치면 작은 버퍼로 모은다
+            size_t peek = std::min(std::min(header_size, remaining), sizeof(header));
+            if (in_chain < peek) {
+                gather(chain, offset, header, peek);
+                p = header;
+            }
+
+            FrameInfo frame = {0, 0};
+            FrameStatus status = decode(p, peek, frame);
+            if (status == FRAME_NEED_MORE) {
+                break;
+            }
+            size_t frame_size = frame.header + frame.length;
+            if (status == FRAME_SKIP) {
+                frame_size = std::min(frame.length ? frame.length : sizeof(uint32_t), remaining);
+            } else if (frame_size > remaining) {
+                break;  // 더 많은 데이터 필요
+            } else if (frame_size <= in_chain) {
+                // chain 안에 있는 메시지는 복사 없이 전달
+                _batch.push_back(ProtocolMessage{static_cast<const char*>(_iov[chain].iov_base) + offset + frame.header,
+                                                 frame.length});
+            } else {
+                // chain 경계에 걸친 메시지만 scratch 로 복사 (포인터는 전달 직전에 확정)
+                size_t at = _scratch.size();
+                _scratch.resize(at + frame.length);
+                size_t skip_chain = chain, skip_offset = offset + frame.header;
+                while (skip_chain < _iov.size() && skip_offset >= _iov[skip_chain].iov_len) {
+                    skip_offset -= _iov[skip_chain].iov_len;
+                    ++skip_chain;
+                }
+                gather(skip_chain, skip_offset, _scratch.data() + at, frame.length);
+                _scratch_refs.push_back(std::make_pair(_batch.size(), at));
+                _batch.push_back(ProtocolMessage{nullptr, frame.length});
+            }
+
+            consumed += frame_size;
+            offset += frame_size;
+            while (chain < _iov.size() && offset >= _iov[chain].iov_len) {
+                offset -= _iov[chain].iov_len;
+                ++chain;
+            }
+        }
+
+        for (const auto& ref : _scratch_refs) {
+            _batch[ref.first].data = _scratch.data() + ref.second;
+        }
+        if (!_batch.empty()) {
+            sink(_batch.data(), _batch.size());
+        }
+        if (consumed > 0) {
+            evbuffer_drain(input, consumed);
+        }
+        return consumed;
+    }
+};
+
+#endif // FRAME_PARSER_H
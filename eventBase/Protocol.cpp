@@ -1,8 +1,23 @@
 #include "Protocol.h"
 #include <iostream>
 #include <cstring>
+#include <algorithm>
 #include <arpa/inet.h>  // for ntohl, htonl
 
+// ==================== Protocol ====================
+size_t Protocol::parseBatch(struct evbuffer* input, const BatchCallback& callback) {
+    return parseBuffer(input, [&callback](const char* data, size_t length) {
+        ProtocolMessage m = {data, length};
+        callback(&m, 1);
+    });
+}
+
+size_t Protocol::parseFrames(struct evbuffer* input, const BatchCallback& callback) {
+    return _frames.parse(input, frameHeaderSize(),
+        [this](const char* p, size_t avail, FrameInfo& frame) { return decodeFrame(p, avail, frame); },
+        callback);
+}
+
 // ==================== RawProtocol ====================
 size_t RawProtocol::parseBuffer(struct evbuffer* input, const MessageCallback& callback) {
     size_t len = evbuffer_get_length(input);
@@ -27,187 +42,103 @@ void RawProtocol::reset() {
 }
 
 // ==================== LengthPrefixedProtocol ====================
-LengthPrefixedProtocol::LengthPrefixedProtocol() 
-    : _expected_length(0), _reading_header(true) {
+LengthPrefixedProtocol::LengthPrefixedProtocol() {
 }
 
 size_t LengthPrefixedProtocol::parseBuffer(struct evbuffer* input, const MessageCallback& callback) {
-    size_t total_consumed = 0;
-    
-    while (true) {
-        size_t available = evbuffer_get_length(input);
-        
-        if (_reading_header) {
-            // 4바이트 길이 헤더를 읽어야 함
-            if (available < sizeof(uint32_t)) {
-                break;  // 더 많은 데이터 필요
-            }
-            
-            uint32_t length_be;
-            evbuffer_remove(input, &length_be, sizeof(uint32_t));
-            _expected_length = ntohl(length_be);
-            _reading_header = false;
-            total_consumed += sizeof(uint32_t);
-            
-            std::cout << "[LengthPrefixed] Header read: expecting " << _expected_length << " bytes" << std::endl;
-            available -= sizeof(uint32_t);
+    return parseFrames(input, [&callback](const ProtocolMessage* messages, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            callback(messages[i].data, messages[i].length);
         }
-        
-        if (!_reading_header) {
-            // 데이터 부분을 읽어야 함
-            if (available < _expected_length) {
-                break;  // 더 많은 데이터 필요
-            }
-            
-            // Zero-Copy: evbuffer 내부 데이터에 직접 접근
-            const char* data = (const char*)evbuffer_pullup(input, _expected_length);
-            if (data) {
-                std::cout << "[LengthPrefixed] Complete message read: " << _expected_length << " bytes" << std::endl;
-                callback(data, _expected_length);
-                
-                evbuffer_drain(input, _expected_length);
-                total_consumed += _expected_length;
-                
-                // 다음 메시지를 위해 상태 리셋
-                _reading_header = true;
-                _expected_length = 0;
-            } else {
-                break;  // pullup 실패
-            }
-        }
-    }
-    
-    return total_consumed;
+    });
+}
+
+size_t LengthPrefixedProtocol::parseBatch(struct evbuffer* input, const BatchCallback& callback) {
+    return parseFrames(input, callback);
 }
 
 bool LengthPrefixedProtocol::encodeToBuffer(struct evbuffer* output, const void* data, size_t length) {
-    // 길이를 네트워크 바이트 순서로 변환하여 헤더 추가
-    uint32_t length_be = htonl((uint32_t)length);
-    if (evbuffer_add(output, &length_be, sizeof(uint32_t)) != 0) {
-        return false;
-    }
-    
-    // 실제 데이터 추가
-    return evbuffer_add(output, data, length) == 0;
+    return _frame.encode(output, data, length);
 }
 
 void LengthPrefixedProtocol::reset() {
-    _expected_length = 0;
-    _reading_header = true;
+    // 파싱 상태는 evbuffer 에만 있으므로 리셋할 것이 없음
     std::cout << "[LengthPrefixed] Protocol reset" << std::endl;
 }
 
 // ==================== MagicBasedProtocol ====================
-MagicBasedProtocol::MagicBasedProtocol() 
-    : _current_magic(0), _expected_length(0), _reading_header(true) {
+MagicBasedProtocol::MagicBasedProtocol() {
 }
 
 void MagicBasedProtocol::registerMagic(uint32_t magic, uint32_t fixed_length) {
-    _magic_to_fixed_length[magic] = fixed_length;
+    MagicFrame::MagicEntry& e = _frame.entry(magic);
+    e.fixed_length = fixed_length;
+    e.length_calculator = nullptr;
     std::cout << "[MagicBased] Registered magic 0x" << std::hex << magic 
               << " with fixed length " << std::dec << fixed_length << std::endl;
 }
 
 void MagicBasedProtocol::registerMagic(uint32_t magic, std::function<uint32_t(const char*)> length_calculator) {
-    _magic_to_length_calculator[magic] = length_calculator;
+    _frame.entry(magic).length_calculator = length_calculator;
     std::cout << "[MagicBased] Registered magic 0x" << std::hex << magic 
               << " with variable length calculator" << std::dec << std::endl;
 }
 
 size_t MagicBasedProtocol::parseBuffer(struct evbuffer* input, const MessageCallback& callback) {
-    size_t total_consumed = 0;
-    
-    while (true) {
-        size_t available = evbuffer_get_length(input);
-        std::cout << "\n\n\t#### [MagicBased] Available: " << available << std::endl;
-        std::cout << "\n\n\t#### [MagicBased] _reading_header: " << _reading_header << std::endl;
-        if (_reading_header) {
-            // 4바이트 magic을 읽어야 함
-            if (available < sizeof(uint32_t)) {
-                break;  // 더 많은 데이터 필요
-            }
-            
-            uint32_t magic_be;
-            evbuffer_remove(input, &magic_be, sizeof(uint32_t));
-            _current_magic = ntohl(magic_be);
-            total_consumed += sizeof(uint32_t);
-            
-            std::cout << "[MagicBased] Magic read: 0x" << std::hex << _current_magic << std::dec << std::endl;
-            
-            // Magic에 따른 길이 결정
-            auto fixed_it = _magic_to_fixed_length.find(_current_magic);
-            if (fixed_it != _magic_to_fixed_length.end()) {
-                _expected_length = fixed_it->second;
-                std::cout << "[MagicBased] Using fixed length: " << _expected_length << std::endl;
-            } else {
-                auto calc_it = _magic_to_length_calculator.find(_current_magic);
-                if (calc_it != _magic_to_length_calculator.end()) {
-                    // 가변 길이를 위한 추가 헤더가 필요할 수 있음
-                    // 여기서는 간단히 다음 4바이트를 길이로 읽는다고 가정
-                    if (available < sizeof(uint32_t)) {
-                        // Magic 다시 버퍼에 넣고 나중에 다시 처리
-                        uint32_t magic_be_restore = htonl(_current_magic);
-                        evbuffer_prepend(input, &magic_be_restore, sizeof(uint32_t));
-                        total_consumed -= sizeof(uint32_t);
-                        break;
-                    }
-                    
-                    char length_header[4];
-                    evbuffer_remove(input, length_header, sizeof(uint32_t));
-                    _expected_length = calc_it->second(length_header);
-                    total_consumed += sizeof(uint32_t);
-                    std::cout << "[MagicBased] Using calculated length: " << _expected_length << std::endl;
-                    available -= sizeof(uint32_t);
-                } else {
-                    std::cout << "[MagicBased] Unknown magic 0x" << std::hex << _current_magic 
-                              << ", skipping..." << std::dec << std::endl;
-                    _reading_header = true;
-                    continue;
-                }
-            }
-            
-            _reading_header = false;
-            available -= sizeof(uint32_t);
-        }
-        
-        if (!_reading_header) {
-            // 데이터 부분을 읽어야 함
-            if (available < _expected_length) {
-                break;  // 더 많은 데이터 필요
-            }
-            
-            // Zero-Copy: evbuffer 내부 데이터에 직접 접근
-            const char* data = (const char*)evbuffer_pullup(input, _expected_length);
-            if (data) {
-                std::cout << "[MagicBased] Complete message read: magic=0x" << std::hex << _current_magic
-                          << ", length=" << std::dec << _expected_length << std::endl;
-                
-                callback(data, _expected_length);
-                
-                evbuffer_drain(input, _expected_length);
-                total_consumed += _expected_length;
-                
-                // 다음 메시지를 위해 상태 리셋
-                _reading_header = true;
-                _current_magic = 0;
-                _expected_length = 0;
-            } else {
-                break;  // pullup 실패
-            }
+    return parseFrames(input, [&callback](const ProtocolMessage* messages, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            callback(messages[i].data, messages[i].length);
         }
-    }
-    
-    return total_consumed;
+    });
+}
+
+size_t MagicBasedProtocol::parseBatch(struct evbuffer* input, const BatchCallback& callback) {
+    return parseFrames(input, callback);
 }
 
 bool MagicBasedProtocol::encodeToBuffer(struct evbuffer* output, const void* data, size_t length) {
+    return _frame.encode(output, data, length);
+}
+
+void MagicBasedProtocol::reset() {
+    std::cout << "[MagicBased] Protocol reset" << std::endl;
+}
+
+// ==================== MagicFrame ====================
+// [magic(4, network order)][payload] 또는 [magic][length(4)][payload], payload 만 전달
+FrameStatus MagicFrame::decode(const char* p, size_t avail, FrameInfo& frame) const {
+    if (avail < sizeof(uint32_t)) {
+        return FRAME_NEED_MORE;
+    }
+    uint32_t magic_be;
+    memcpy(&magic_be, p, sizeof(uint32_t));
+    const MagicEntry* e = find(ntohl(magic_be));
+    if (!e) {
+        std::cout << "[MagicBased] Unknown magic 0x" << std::hex << ntohl(magic_be)
+                  << ", skipping..." << std::dec << std::endl;
+        frame.length = sizeof(uint32_t);
+        return FRAME_SKIP;
+    }
+    if (!e->length_calculator) {
+        frame.header = sizeof(uint32_t);
+        frame.length = e->fixed_length;
+        return FRAME_OK;
+    }
+    if (avail < 2 * sizeof(uint32_t)) {
+        return FRAME_NEED_MORE;
+    }
+    frame.header = 2 * sizeof(uint32_t);
+    frame.length = e->length_calculator(p + sizeof(uint32_t));
+    return FRAME_OK;
+}
+
+bool MagicFrame::encode(struct evbuffer* output, const void* data, size_t length) const {
     // Magic을 네트워크 바이트 순서로 변환하여 헤더 추가
     // 기본적으로 첫 번째 등록된 magic을 사용하거나 고정 값 사용
     uint32_t magic = 0x12345678;  // 기본 magic 값
-    if (!_magic_to_fixed_length.empty()) {
-        magic = _magic_to_fixed_length.begin()->first;
-    } else if (!_magic_to_length_calculator.empty()) {
-        magic = _magic_to_length_calculator.begin()->first;
+    const MagicEntry* e = magics.empty() ? nullptr : &magics.front();
+    if (e) {
+        magic = e->magic;
     }
     
     uint32_t magic_be = htonl(magic);
@@ -216,8 +147,7 @@ bool MagicBasedProtocol::encodeToBuffer(struct evbuffer* output, const void* dat
     }
     
     // 가변 길이 magic인 경우 길이 헤더도 추가
-    auto calc_it = _magic_to_length_calculator.find(magic);
-    if (calc_it != _magic_to_length_calculator.end()) {
+    if (e && e->length_calculator) {
         uint32_t length_be = htonl((uint32_t)length);
         if (evbuffer_add(output, &length_be, sizeof(uint32_t)) != 0) {
             return false;
@@ -226,11 +156,4 @@ bool MagicBasedProtocol::encodeToBuffer(struct evbuffer* output, const void* dat
     
     // 실제 데이터 추가
     return evbuffer_add(output, data, length) == 0;
-}
-
-void MagicBasedProtocol::reset() {
-    _current_magic = 0;
-    _expected_length = 0;
-    _reading_header = true;
-    std::cout << "[MagicBased] Protocol reset" << std::endl;
 }
\ No newline at end of file
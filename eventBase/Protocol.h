@@ -6,13 +6,85 @@
 #include <map>
 #include <memory>
 #include <cstdint>
+#include <cstring>
+#include <sys/uio.h>
+#include <arpa/inet.h>
 #include <event2/buffer.h>
+#include "FrameParser.h"
+
+/*
+ * Frame decoder - EventConnection<ProtocolT, HandlerT> 의 ProtocolT
+ *
+ * virtual 없이 inline 으로 호출되는 프레임 해석기. 아래 세 함수를 가진 타입이면 된다.
+ *   size_t header_size() const;
+ *   FrameStatus decode(const char* p, size_t avail, FrameInfo& frame) const;
+ *   bool encode(struct evbuffer* output, const void* data, size_t length) const;
+ * 같은 이름의 Protocol 구현 (LengthPrefixedProtocol, MagicBasedProtocol, PubSubTopicProtocol) 은
+ * decoder 를 하나 갖고 decodeFrame / encodeToBuffer 를 그대로 넘긴다.
+ */
+
+// 길이(4byte, network order) + 데이터
+struct LengthPrefixedFrame {
+    size_t header_size() const { return sizeof(uint32_t); }
+
+    FrameStatus decode(const char* p, size_t avail, FrameInfo& frame) const {
+        if (avail < sizeof(uint32_t)) {
+            return FRAME_NEED_MORE;
+        }
+        uint32_t length_be;
+        memcpy(&length_be, p, sizeof(uint32_t));
+        frame.header = sizeof(uint32_t);
+        frame.length = ntohl(length_be);
+        return FRAME_OK;
+    }
+
+    bool encode(struct evbuffer* output, const void* data, size_t length) const {
+        // 길이를 네트워크 바이트 순서로 변환하여 헤더 추가
+        uint32_t length_be = htonl((uint32_t)length);
+        if (evbuffer_add(output, &length_be, sizeof(uint32_t)) != 0) {
+            return false;
+        }
+        return evbuffer_add(output, data, length) == 0;
+    }
+};
+
+// magic(4byte, network order) 에 따라 고정길이, 또는 [magic][length(4)] 가변길이
+struct MagicFrame {
+    // magic 수가 적으므로 map 대신 선형 탐색하는 flat table
+    struct MagicEntry {
+        uint32_t magic;
+        uint32_t fixed_length;                                  // calculator 가 없으면 고정길이
+        std::function<uint32_t(const char*)> length_calculator; // magic 뒤 4byte 로 가변길이 계산
+    };
+    std::vector<MagicEntry> magics;
+
+    const MagicEntry* find(uint32_t magic) const {
+        for (const auto& e : magics) {
+            if (e.magic == magic) return &e;
+        }
+        return nullptr;
+    }
+    MagicEntry& entry(uint32_t magic) {
+        MagicEntry* e = const_cast<MagicEntry*>(find(magic));
+        if (!e) {
+            magics.push_back(MagicEntry{magic, 0, nullptr});
+            e = &magics.back();
+        }
+        return *e;
+    }
+
+    size_t header_size() const { return 2 * sizeof(uint32_t); }
+    FrameStatus decode(const char* p, size_t avail, FrameInfo& frame) const;
+    bool encode(struct evbuffer* output, const void* data, size_t length) const;
+};
 
 class Protocol {
 public:
     // Zero-Copy 수신: 완전한 메시지가 파싱되면 콜백 함수 호출
     // data는 evbuffer 내부 포인터이므로 복사 없음 (사용 후 즉시 소비해야 함)
     using MessageCallback = std::function<void(const char* data, size_t length)>;
+    // read callback 한번에 파싱된 메시지 전체를 전달
+    using BatchCallback = std::function<void(const ProtocolMessage* messages, size_t count)>;
     
     virtual ~Protocol() = default;
     
@@ -20,10 +92,31 @@ public:
     // 반환값: 처리한 바이트 수 (evbuffer에서 drain할 양)
     virtual size_t parseBuffer(struct evbuffer* input, const MessageCallback& callback) = 0;
     
+    // 수신: 완전한 메시지를 모아 callback 한번으로 전달, 반환값은 parseBuffer 와 같음
+    // (기본 구현은 parseBuffer 로 메시지마다 전달)
+    virtual size_t parseBatch(struct evbuffer* input, const BatchCallback& callback);
+    
     // 송신: evbuffer에 직접 인코딩된 데이터 추가 (Zero-Copy)
     virtual bool encodeToBuffer(struct evbuffer* output, const void* data, size_t length) = 0;
     
     virtual void reset() = 0;  // 연결 종료 시 상태 리셋
+
+protected:
+    typedef ::FrameStatus FrameStatus;
+    typedef ::FrameInfo FrameInfo;
+    
+    // p 는 프레임 시작의 연속된 min(frameHeaderSize(), avail) 바이트
+    virtual size_t frameHeaderSize() const { return 0; }
+    virtual FrameStatus decodeFrame(const char* p, size_t avail, FrameInfo& frame) const {
+        (void)p; (void)frame; (void)avail;
+        return FRAME_NEED_MORE;
+    }
+    
+    // FrameParser 로 decodeFrame 에 따라 프레임을 나눈다 (virtual 호환 경로)
+    size_t parseFrames(struct evbuffer* input, const BatchCallback& callback);
+
+private:
+    FrameParser _frames;
 };
 
 // 1. 기본: evbuffer에 있는 모든 데이터를 즉시 전달 (Zero-Copy)
@@ -37,25 +130,26 @@ public:
 // 2. 길이(4byte) + 데이터 형식
 class LengthPrefixedProtocol : public Protocol {
 private:
-    uint32_t _expected_length;
-    bool _reading_header;
-    
+    LengthPrefixedFrame _frame;
+
 public:
     LengthPrefixedProtocol();
     size_t parseBuffer(struct evbuffer* input, const MessageCallback& callback) override;
+    size_t parseBatch(struct evbuffer* input, const BatchCallback& callback) override;
     bool encodeToBuffer(struct evbuffer* output, const void* data, size_t length) override;
     void reset() override;
+
+protected:
+    size_t frameHeaderSize() const override { return _frame.header_size(); }
+    FrameStatus decodeFrame(const char* p, size_t avail, FrameInfo& frame) const override {
+        return _frame.decode(p, avail, frame);
+    }
 };
 
 // 3. magic (4byte) 를 읽어 magic에 따라 정해진 (또는 가변)길이
 class MagicBasedProtocol : public Protocol {
 private:
-    std::map<uint32_t, uint32_t> _magic_to_fixed_length;  // magic -> 고정길이
-    std::map<uint32_t, std::function<uint32_t(const char*)>> _magic_to_length_calculator;  // magic -> 가변길이 계산
-    
-    uint32_t _current_magic;
-    uint32_t _expected_length;
-    bool _reading_header;
+    MagicFrame _frame;
     
 public:
     MagicBasedProtocol();
@@ -67,8 +161,17 @@ public:
     void registerMagic(uint32_t magic, std::function<uint32_t(const char*)> length_calculator);
     
     size_t parseBuffer(struct evbuffer* input, const MessageCallback& callback) override;
+    size_t parseBatch(struct evbuffer* input, const BatchCallback& callback) override;
     bool encodeToBuffer(struct evbuffer* output, const void* data, size_t length) override;
     void reset() override;
+    
+    const MagicFrame& frame() const { return _frame; }
+
+protected:
+    size_t frameHeaderSize() const override { return _frame.header_size(); }
+    FrameStatus decodeFrame(const char* p, size_t avail, FrameInfo& frame) const override {
+        return _frame.decode(p, avail, frame);
+    }
 };
 
 #endif // PROTOCOL_H
\ No newline at end of file
@@ -0,0 +1,324 @@
+#include "TimerWheel.h"
+#include <iostream>
+#include <sys/time.h>
+
+TimerWheel::TimerWheel(struct event_base* base, std::chrono::microseconds tick)
+    : _base(base), _tick_event(nullptr), _tick_armed(false),
+      _tick_us(tick.count() > 0 ? static_cast<uint64_t>(tick.count()) : 1000),
+      _origin(std::chrono::steady_clock::now()), _now(0),
+      _active(0), _expired_count(0), _firing(NIL), _firing_cancelled(false), _in_advance(false) {
+    // [0, SENTINELS) 는 slot 리스트 head
+    _nodes.resize(SENTINELS);
+    for (uint32_t i = 0; i < SENTINELS; ++i) {
+        _nodes[i].prev = i;
+        _nodes[i].next = i;
+        _nodes[i].generation = 0;
+        _nodes[i].in_use = false;
+        _nodes[i].pending = false;
+        _nodes[i].batch = false;
+        _nodes[i].expire = 0;
+        _nodes[i].interval_ticks = 0;
+        _nodes[i].tag = 0;
+    }
+    _tick_event = event_new(_base, -1, EV_PERSIST, static_tick_cb, this);
+    if (!_tick_event) {
+        std::cerr << "TimerWheel: Failed to create tick event" << std::endl;
+    }
+}
+
+TimerWheel::~TimerWheel() {
+    disarm();
+    if (_tick_event) {
+        event_free(_tick_event);
+        _tick_event = nullptr;
+    }
+}
+
+uint64_t TimerWheel::current_tick() const {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _origin);
+    return static_cast<uint64_t>(elapsed.count()) / _tick_us;
+}
+
+uint64_t TimerWheel::ticks_for(uint64_t us) const {
+    return (us + _tick_us - 1) / _tick_us;
+}
+
+// 요청한 지연보다 일찍 만료되지 않도록 (현재 시각 + 지연) 을 tick 단위로 올림
+uint64_t TimerWheel::expire_tick(uint64_t delay_us) const {
+    auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _origin);
+    uint64_t expire = ticks_for(static_cast<uint64_t>(elapsed.count()) + delay_us);
+    return expire > _now ? expire : _now + 1;
+}
+
+TimerWheel::TimerId TimerWheel::add_timer(uint64_t delay_us, uint64_t interval_us, Callback&& cb,
+                                          uint64_t tag, bool batch) {
+    // 유휴 동안은 tick 을 진행하지 않으므로 현재 시각으로 맞춘다
+    if (_active == 0 && !_in_advance) {
+        _now = current_tick();
+    }
+
+    uint32_t i;
+    if (!_free.empty()) {
+        i = _free.back();
+        _free.pop_back();
+    } else {
+        i = static_cast<uint32_t>(_nodes.size());
+        _nodes.emplace_back();
+        _nodes[i].generation = 0;
+    }
+    Node& n = _nodes[i];
+    n.prev = NIL;
+    n.next = NIL;
+    n.generation++;
+    n.in_use = true;
+    n.pending = false;
+    n.batch = batch;
+    n.tag = tag;
+    n.cb = std::move(cb);
+    n.interval_ticks = interval_us > 0 ? std::max<uint64_t>(1, ticks_for(interval_us)) : 0;
+    n.expire = expire_tick(delay_us);
+    insert(i);
+    _active++;
+    arm();
+    return (static_cast<uint64_t>(n.generation) << 32) | i;
+}
+
+bool TimerWheel::reschedule_us(TimerId id, uint64_t delay_us) {
+    uint32_t i = lookup(id);
+    if (i == NIL) return false;
+    if (_nodes[i].pending) {
+        unlink(i);
+    } else {
+        _active++;      // 콜백 안에서 만료된 자기 자신을 다시 등록
+    }
+    _nodes[i].expire = expire_tick(delay_us);
+    insert(i);
+    arm();
+    return true;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    uint32_t i = lookup(id);
+    if (i == NIL) return false;
+    if (_nodes[i].pending) {
+        unlink(i);
+        _active--;
+    }
+    if (i == _firing) {
+        // 콜백이 끝난 뒤 process_tick 에서 반환
+        _firing_cancelled = true;
+    } else {
+        release(i);
+    }
+    if (_active == 0) disarm();
+    return true;
+}
+
+bool TimerWheel::is_pending(TimerId id) const {
+    uint32_t i = lookup(id);
+    return i != NIL && _nodes[i].pending;
+}
+
+uint32_t TimerWheel::lookup(TimerId id) const {
+    uint32_t i = static_cast<uint32_t>(id & 0xFFFFFFFFu);
+    uint32_t generation = static_cast<uint32_t>(id >> 32);
+    if (i < SENTINELS || i >= _nodes.size()) return NIL;
+    const Node& n = _nodes[i];
+    if (!n.in_use || n.generation != generation) return NIL;
+    return i;
+}
+
+void TimerWheel::link(uint32_t head, uint32_t i) {
+    uint32_t tail = _nodes[head].prev;
+    _nodes[i].prev = tail;
+    _nodes[i].next = head;
+    _nodes[tail].next = i;
+    _nodes[head].prev = i;
+}
+
+void TimerWheel::unlink(uint32_t i) {
+    Node& n = _nodes[i];
+    _nodes[n.prev].next = n.next;
+    _nodes[n.next].prev = n.prev;
+    n.prev = NIL;
+    n.next = NIL;
+    n.pending = false;
+}
+
+// 남은 tick 수로 단계를 고르고 만료 tick 의 해당 자리 비트로 slot 을 고른다
+void TimerWheel::insert(uint32_t i) {
+    Node& n = _nodes[i];
+    uint64_t delta = n.expire > _now ? n.expire - _now : 0;
+    uint64_t expire = n.expire > _now ? n.expire : _now;
+    if (delta >= (1ull << (SLOT_BITS * LEVELS))) {
+        // wheel 범위 밖: 최상위 단계 마지막 slot 에 두고 cascade 때 다시 배치
+        delta = (1ull << (SLOT_BITS * LEVELS)) - 1;
+        expire = _now + delta;
+    }
+    int level = 0;
+    while (level < LEVELS - 1 && delta >= (1ull << (SLOT_BITS * (level + 1)))) {
+        ++level;
+    }
+    uint32_t slot = static_cast<uint32_t>((expire >> (SLOT_BITS * level)) & (SLOTS - 1));
+    link(level * SLOTS + slot, i);
+    n.pending = true;
+}
+
+void TimerWheel::release(uint32_t i) {
+    Node& n = _nodes[i];
+    n.in_use = false;
+    n.cb = Callback();
+    _free.push_back(i);
+}
+
+void TimerWheel::cascade(int level, uint32_t slot) {
+    uint32_t head = level * SLOTS + slot;
+    _cascade_buf.clear();
+    for (uint32_t i = _nodes[head].next; i != head; i = _nodes[i].next) {
+        _cascade_buf.push_back(i);
+    }
+    _nodes[head].prev = head;
+    _nodes[head].next = head;
+    for (uint32_t i : _cascade_buf) {
+        insert(i);
+    }
+}
+
+void TimerWheel::process_tick() {
+    uint32_t idx = static_cast<uint32_t>(_now & (SLOTS - 1));
+    if (idx == 0) {
+        for (int level = 1; level < LEVELS; ++level) {
+            uint32_t slot = static_cast<uint32_t>((_now >> (SLOT_BITS * level)) & (SLOTS - 1));
+            cascade(level, slot);
+            if (slot != 0) break;
+        }
+    }
+
+    // 만료 slot 을 떼어내서 처리 (콜백이 새 타이머를 같은 slot 에 걸어도 다음 바퀴로)
+    uint32_t head = idx;
+    if (_nodes[head].next == head) return;
+    _nodes[EXPIRING].next = _nodes[head].next;
+    _nodes[EXPIRING].prev = _nodes[head].prev;
+    _nodes[_nodes[EXPIRING].next].prev = EXPIRING;
+    _nodes[_nodes[EXPIRING].prev].next = EXPIRING;
+    _nodes[head].next = head;
+    _nodes[head].prev = head;
+
+    while (_nodes[EXPIRING].next != EXPIRING) {
+        uint32_t i = _nodes[EXPIRING].next;
+        unlink(i);
+        _active--;
+        _expired_count++;
+
+        if (_nodes[i].batch) {
+            _expired_tags.push_back(_nodes[i].tag);
+            if (_nodes[i].interval_ticks > 0) {
+                _nodes[i].expire = _now + _nodes[i].interval_ticks;
+                insert(i);
+                _active++;
+            } else {
+                release(i);
+            }
+            continue;
+        }
+
+        // 콜백 안에서 타이머가 추가되면 _nodes 가 재할당될 수 있으므로 콜백은 꺼내서 호출
+        Callback cb = std::move(_nodes[i].cb);
+        _firing = i;
+        _firing_cancelled = false;
+        if (cb) cb();
+        _firing = NIL;
+
+        Node& n = _nodes[i];
+        if (_firing_cancelled) {
+            release(i);
+        } else if (n.pending) {
+            n.cb = std::move(cb);           // 콜백에서 reschedule 함
+        } else if (n.interval_ticks > 0) {
+            n.cb = std::move(cb);
+            n.expire = _now + n.interval_ticks;
+            insert(i);
+            _active++;
+        } else {
+            release(i);
+        }
+    }
+}
+
+void TimerWheel::advance() {
+    if (_in_advance) return;
+    _in_advance = true;
+    uint64_t target = current_tick();
+    while (_now < target) {
+        if (_active == 0) {
+            _now = target;
+            break;
+        }
+        ++_now;
+        process_tick();
+    }
+    _in_advance = false;
+
+    if (!_expired_tags.empty()) {
+        if (_batch_cb) {
+            _batch_tags.swap(_expired_tags);
+            _batch_cb(_batch_tags.data(), _batch_tags.size());
+            _batch_tags.clear();
+        } else {
+            _expired_tags.clear();
+        }
+    }
+    if (_active == 0) disarm();
+}
+
+void TimerWheel::arm() {
+    if (_tick_armed || !_tick_event || _active == 0) return;
+    struct timeval tv;
+    tv.tv_sec = static_cast<time_t>(_tick_us / 1000000);
+    tv.tv_usec = static_cast<suseconds_t>(_tick_us % 1000000);
+    if (event_add(_tick_event, &tv) != 0) {
+        std::cerr << "TimerWheel: Failed to add tick event" << std::endl;
+        return;
+    }
+    _tick_armed = true;
+}
+
+void TimerWheel::disarm() {
+    if (!_tick_armed) return;
+    event_del(_tick_event);
+    _tick_armed = false;
+}
+
+void TimerWheel::static_tick_cb(evutil_socket_t fd, short events, void* ctx) {
+    (void)fd; (void)events;
+    static_cast<TimerWheel*>(ctx)->advance();
+}
+
+// -----------------------------
+// WheelTimer
+// -----------------------------
+WheelTimer::WheelTimer(TimerWheel& wheel)
+    : _wheel(wheel), _id(0), _is_periodic(false), _interval(0) {
+}
+
+WheelTimer::~WheelTimer() {
+    stop();
+}
+
+void WheelTimer::stop() {
+    if (_id) {
+        _wheel.cancel(_id);
+        _id = 0;
+    }
+}
+
+bool WheelTimer::setupTimer(long timeout_ms, bool is_periodic) {
+    stop();
+    _is_periodic = is_periodic;
+    _interval = std::chrono::milliseconds(timeout_ms);
+    auto cb = [this]() {
+        if (_timeout_cb) _timeout_cb(nullptr, 0);
+    };
+    _id = is_periodic ? _wheel.schedule_periodic(_interval, cb) : _wheel.schedule(_interval, cb);
+    return _id != 0;
+}
@@ -0,0 +1,201 @@
+#ifndef TIMERWHEEL_H
+#define TIMERWHEEL_H
+
+#include <event2/event.h>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * TimerWheel 클래스 - libevent 타이머 하나로 구동하는 계층형 timing wheel
+ *
+ * 타이머마다 libevent event(min-heap 항목)를 만드는 대신, tick 주기의 EV_PERSIST 타이머 하나가
+ * 시간을 진행시키고 만료된 항목의 콜백을 호출합니다. 종목별 타이머처럼 수만 개를 걸어도
+ * 등록/취소는 O(1) 입니다.
+ *
+ * 구조: 4 단계 x 256 slot (tick^8, tick^16, tick^24, tick^32 범위), slot 은 intrusive 이중 연결 리스트.
+ * 상위 단계 slot 은 하위 단계 index 가 0 으로 돌아올 때 하위 단계로 다시 나눠 담는다 (cascade).
+ *
+ * 주요 기능:
+ * - schedule() / schedule_periodic(): 콜백 타이머 (periodic 은 만료 시 자동 재등록)
+ * - schedule_tag(): 콜백 대신 tag 만 가진 타이머, 한 tick 에 만료된 tag 들을 batch 콜백으로 한번에 전달
+ * - reschedule(): 만료 시각 갱신 (stale 감지처럼 계속 미루는 용도), cancel(): 취소
+ * - 등록된 타이머가 없으면 libevent 타이머를 내려 유휴 시 wakeup 이 없음
+ *
+ * 만료는 tick 단위로 올림하여 판단하므로 지연은 최대 tick 만큼 늦어질 수 있습니다.
+ * event loop 스레드에서만 사용합니다.
+ *
+ * 사용 예시:
+ * TimerWheel wheel(base, std::chrono::milliseconds(1));
+ * auto id = wheel.schedule(std::chrono::milliseconds(500), []() { std::cout << "fired" << std::endl; });
+ * wheel.set_batch_callback([](const uint64_t* tags, size_t n) { ... });
+ * wheel.schedule_tag(std::chrono::seconds(3), symbol_index);
+ * wheel.cancel(id);
+ */
+class TimerWheel {
+public:
+    typedef uint64_t TimerId;   // 0 은 유효하지 않은 id
+    typedef std::function<void()> Callback;
+    typedef std::function<void(const uint64_t* tags, size_t count)> BatchCallback;
+
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const uint32_t SLOTS = 1u << SLOT_BITS;
+
+    /**
+     * @param base libevent의 event_base
+     * @param tick 시간 해상도 (libevent 타이머 주기)
+     */
+    explicit TimerWheel(struct event_base* base,
+                        std::chrono::microseconds tick = std::chrono::milliseconds(1));
+    ~TimerWheel();
+
+    TimerWheel(const TimerWheel&) = delete;
+    TimerWheel& operator=(const TimerWheel&) = delete;
+
+    template<typename Duration>
+    TimerId schedule(const Duration& delay, Callback cb) {
+        return add_timer(to_us(delay), 0, std::move(cb), 0, false);
+    }
+
+    template<typename Duration>
+    TimerId schedule_periodic(const Duration& interval, Callback cb) {
+        return add_timer(to_us(interval), to_us(interval), std::move(cb), 0, false);
+    }
+
+    template<typename Duration>
+    TimerId schedule_tag(const Duration& delay, uint64_t tag) {
+        return add_timer(to_us(delay), 0, Callback(), tag, true);
+    }
+
+    template<typename Duration>
+    bool reschedule(TimerId id, const Duration& delay) {
+        return reschedule_us(id, to_us(delay));
+    }
+
+    bool cancel(TimerId id);
+    bool is_pending(TimerId id) const;
+
+    void set_batch_callback(BatchCallback cb) { _batch_cb = std::move(cb); }
+
+    size_t size() const { return _active; }
+    std::chrono::microseconds tick() const { return std::chrono::microseconds(_tick_us); }
+    uint64_t get_expired_count() const { return _expired_count; }
+
+    /**
+     * 현재 시각까지 tick 진행 (libevent 타이머 콜백에서 호출, 테스트에서 직접 호출 가능)
+     */
+    void advance();
+
+private:
+    static const uint32_t NIL = 0xFFFFFFFFu;
+    static const uint32_t EXPIRING = LEVELS * SLOTS;     // 이번 tick 에 만료 처리 중인 리스트
+    static const uint32_t SENTINELS = LEVELS * SLOTS + 1;
+
+    struct Node {
+        uint32_t prev;
+        uint32_t next;
+        uint32_t generation;
+        bool in_use;
+        bool pending;
+        bool batch;
+        uint64_t expire;            // 만료 tick
+        uint64_t interval_ticks;    // 0: 일회성
+        uint64_t tag;
+        Callback cb;
+    };
+
+    struct event_base* _base;
+    struct event* _tick_event;
+    bool _tick_armed;
+    uint64_t _tick_us;
+    std::chrono::steady_clock::time_point _origin;
+    uint64_t _now;                  // 마지막으로 처리한 tick
+
+    std::vector<Node> _nodes;       // [0, SENTINELS) 는 slot 리스트의 sentinel
+    std::vector<uint32_t> _free;
+    size_t _active;
+    uint64_t _expired_count;
+
+    // 콜백 실행 중인 타이머 (콜백 안에서 자기 자신을 cancel/reschedule 할 수 있음)
+    uint32_t _firing;
+    bool _firing_cancelled;
+    bool _in_advance;
+
+    BatchCallback _batch_cb;
+    std::vector<uint64_t> _expired_tags;
+    std::vector<uint64_t> _batch_tags;
+    std::vector<uint32_t> _cascade_buf;
+
+    template<typename Duration>
+    static uint64_t to_us(const Duration& d) {
+        auto us = std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+        return us > 0 ? static_cast<uint64_t>(us) : 0;
+    }
+
+    TimerId add_timer(uint64_t delay_us, uint64_t interval_us, Callback&& cb, uint64_t tag, bool batch);
+    bool reschedule_us(TimerId id, uint64_t delay_us);
+    uint32_t lookup(TimerId id) const;
+    uint64_t current_tick() const;
+    uint64_t expire_tick(uint64_t delay_us) const;
+    uint64_t ticks_for(uint64_t us) const;
+
+    void link(uint32_t head, uint32_t i);
+    void unlink(uint32_t i);
+    void insert(uint32_t i);
+    void release(uint32_t i);
+    void cascade(int level, uint32_t slot);
+    void process_tick();
+    void arm();
+    void disarm();
+
+    static void static_tick_cb(evutil_socket_t fd, short events, void* ctx);
+};
+
+/**
+ * WheelTimer 클래스 - EventTimer 와 같은 인터페이스로 TimerWheel 항목 하나를 다루는 facade
+ *
+ * EventTimer 대신 사용하면 libevent event 를 따로 만들지 않고 wheel 에 등록됩니다.
+ *
+ * 사용 예시:
+ * WheelTimer timer(wheel);
+ * timer.setTimeoutCallback([](char* data, int size) { ... });
+ * timer.startPeriodic(std::chrono::milliseconds(1000));
+ */
+class WheelTimer {
+private:
+    TimerWheel& _wheel;
+    TimerWheel::TimerId _id;
+    bool _is_periodic;
+    std::chrono::milliseconds _interval;
+    std::function<void(char* data, int size)> _timeout_cb;
+
+    bool setupTimer(long timeout_ms, bool is_periodic);
+
+public:
+    explicit WheelTimer(TimerWheel& wheel);
+    ~WheelTimer();
+
+    WheelTimer(const WheelTimer&) = delete;
+    WheelTimer& operator=(const WheelTimer&) = delete;
+
+    void setTimeoutCallback(std::function<void(char* data, int size)> callback) { _timeout_cb = callback; }
+
+    template<typename Duration>
+    bool startOnce(const Duration& timeout) {
+        return setupTimer(std::chrono::duration_cast<std::chrono::milliseconds>(timeout).count(), false);
+    }
+
+    template<typename Duration>
+    bool startPeriodic(const Duration& interval) {
+        return setupTimer(std::chrono::duration_cast<std::chrono::milliseconds>(interval).count(), true);
+    }
+
+    void stop();
+    bool isRunning() const { return _wheel.is_pending(_id); }
+    bool isPeriodic() const { return _is_periodic; }
+    std::chrono::milliseconds getInterval() const { return _interval; }
+};
+
+#endif // TIMERWHEEL_H
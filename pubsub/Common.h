@@ -6,7 +6,9 @@
 #include <memory>
 #include <vector>
 #include <map>
+#include <unordered_map>
 #include <queue>
+#include <deque>
 #include <stack>
 #include <atomic>
 #include <mutex>
@@ -19,6 +21,7 @@
 #include <event2/util.h>
 #include <sys/socket.h>
 #include <sys/un.h>
+#include "MessageBufferPool.h"
 #include <netinet/in.h>
 #include <unistd.h>
 #include <fcntl.h>
@@ -34,6 +37,23 @@ enum DataTopic : uint32_t {
     ALL_TOPICS = 7  // 모든 토픽 (TRADE | QUOTE | MISC)
 };
 
+// 토픽 id = (number << TOPIC_GROUP_BITS) | group 비트 (TOPIC1/TOPIC2/MISC 중 하나)
+// number 0 은 위의 기본 토픽, number > 0 은 TopicRegistry 에 등록된 확장 토픽 (시장/보드/종목군 등)
+// 구독 / batch 마스크 (topic_mask, conflate_mask, batch_topics) 는 group 비트 단위로 다룬다
+constexpr uint32_t TOPIC_GROUP_BITS = 3;
+
+inline uint32_t topic_group(uint32_t topic) {
+    return topic & static_cast<uint32_t>(ALL_TOPICS);
+}
+
+inline uint32_t topic_number(uint32_t topic) {
+    return topic >> TOPIC_GROUP_BITS;
+}
+
+inline DataTopic make_topic(uint32_t number, DataTopic group) {
+    return static_cast<DataTopic>((number << TOPIC_GROUP_BITS) | topic_group(group));
+}
+
 // Socket type enumeration
 enum SocketType {
     UNIX_SOCKET,
@@ -67,11 +87,14 @@ struct SubscriptionRequest {
     uint32_t topic_mask;      // 구독할 토픽 마스크 (비트 OR)
     uint32_t last_seq;        // 마지막 수신 시퀀스
     char client_name[64];     // 클라이언트 이름
+    uint32_t conflate_mask;         // key 별 최신값만 받을 토픽 마스크 (0: 모두 전체 수신)
+    uint32_t conflate_interval_ms;  // 0: socket 이 writable 해지면 전송, >0: 이 주기로 최신값 전송
+    uint32_t wire_encoding;         // WIRE_ENCODING_* (socket 실시간 payload 형식)
 };
 
 struct SubscriptionResponse {
     uint32_t magic;           // 0xSUBSCOK
-    uint32_t result;          // 0: 성공, 1: 실패
+    uint32_t result;          // SUB_RESULT_* (0: 성공, 1: 실패, 2/3: 성공 - 데이터는 shm 로그/multicast 로 수신)
     uint32_t approved_topics; // 승인된 토픽 마스크
     uint32_t current_seq;     // 현재 global sequence 번호
 };
@@ -81,6 +104,73 @@ struct RecoveryRequest {
     uint32_t client_id;       // 클라이언트 식별자
     uint32_t topic_mask;      // 복구할 토픽 마스크
     uint32_t last_seq;        // 마지막 수신한 global sequence 번호
+    uint32_t compression;     // BLOCK_CODEC_* (0: 압축 안함), publisher 가 지원하면 복구 스트림을 RecoveryBatch 로 보냄
+};
+
+// 구간 복구 한 요청의 최대 메시지 수. publisher 는 더 큰 구간 요청을 채우지 않고 버리므로
+// 구독자는 이보다 큰 누락은 구간 복구 없이 바로 전체 복구 (RecoveryRequest) 로 받는다
+constexpr uint32_t GAP_RECOVERY_MAX_MESSAGES = 65536;
+
+// ONLINE 상태에서 일부 구간만 다시 받는 요청 (응답 없이 [from_seq, to_seq] 의 TopicMessage 가 이어서 옴)
+// publisher 는 chunk 단위로 high_watermark 아래에서만 보내고 나머지는 송신 큐가 빠질 때 이어 보낸다
+struct GapRecoveryRequest {
+    uint32_t magic;           // MAGIC_GAP_RECOVERY_REQ
+    uint32_t client_id;       // 클라이언트 식별자
+    uint32_t from_seq;        // 누락 구간 시작 global sequence
+    uint32_t to_seq;          // 누락 구간 끝 global sequence (포함)
+};
+
+// 토픽 필터 - SubscriptionRequest 앞에 보내면 topic_mask 의 group 중 이 토픽들만 실시간 전송 (구독자별 토픽 목록)
+// 가변 길이: header 뒤에 count 개의 토픽 id, count 0 이면 필터 해제
+struct TopicFilterRequest {
+    uint32_t magic;           // MAGIC_TOPIC_FILTER
+    uint32_t client_id;       // 클라이언트 식별자
+    uint32_t count;           // topics 개수
+    uint32_t topics[0];       // 토픽 id (DataTopic)
+};
+
+// 종목 필터 - SubscriptionRequest 앞에 보내면 종목 (RIC 등 master key) 이 이 목록에 있는 메시지만 전송 (socket 구독자)
+// 가변 길이: header 뒤에 count 개의 SYMBOL_KEY_SIZE 바이트 key (NUL 패딩), count 0 이면 필터 해제
+// 종목이 없는 메시지 (publisher symbol index 가 -1) 는 항상 보내며, 걸러진 메시지만큼 topic seq 가 건너뛴다
+struct SymbolFilterRequest {
+    uint32_t magic;           // MAGIC_SYMBOL_FILTER
+    uint32_t client_id;       // 클라이언트 식별자
+    uint32_t count;           // symbols 개수
+    char symbols[0];          // count * SYMBOL_KEY_SIZE
+};
+constexpr size_t SYMBOL_KEY_SIZE = 32;
+constexpr uint32_t MAX_SYMBOL_FILTER = 65536;
+
+// 시간 기준 복구 요청 - publisher 가 DB 시간 인덱스 (seek_time) 로 since_ns 이후 첫 seq 를 찾아 RecoveryRequest 처럼 처리
+// 응답 / 복구 흐름은 RecoveryRequest 와 같고, 이미 받은 토픽 seq 는 구독자에서 중복으로 건너뛴다
+struct TimeRecoveryRequest {
+    uint32_t magic;           // MAGIC_TIME_RECOVERY_REQ
+    uint32_t client_id;       // 클라이언트 식별자
+    uint32_t topic_mask;      // 복구할 토픽 마스크
+    uint32_t compression;     // BLOCK_CODEC_* (RecoveryRequest::compression 과 같음)
+    uint64_t since_ns;        // 이 시각 (저장 timestamp, epoch ns) 이후 메시지부터
+};
+
+// 구독하지 않은 별도 연결에서 [from_seq, to_seq] 구간만 받는 요청 (RecoveryFetcher 의 병렬 복구 stream)
+// 응답 없이 구간의 TopicMessage (compression 이면 RecoveryBatch) 뒤에 RecoveryComplete 가 오고, 끝나면 같은 연결로 다음 구간을 요청한다.
+// 연결마다 다른 복구 워커가 DB 를 읽으므로 큰 구간을 여러 연결로 나누면 동시에 읽힌다
+struct RangeFetchRequest {
+    uint32_t magic;           // MAGIC_RANGE_FETCH_REQ
+    uint32_t client_id;       // 클라이언트 식별자
+    uint32_t from_seq;        // 구간 시작 global sequence
+    uint32_t to_seq;          // 구간 끝 global sequence (포함, publisher 현재 seq 로 잘림)
+    uint32_t compression;     // BLOCK_CODEC_* (RecoveryRequest::compression 과 같음)
+    uint32_t reserved;
+};
+
+// standby (PublisherReplica) -> primary: acked_seq 까지 standby DB 에 기록했음 (응답 없음).
+// 메시지마다 보내지 않고 여러 batch 를 한번에 확인하며, primary 는 기다리지 않는다 (lag 확인용)
+struct ReplicaAck {
+    uint32_t magic;           // MAGIC_REPLICA_ACK
+    uint32_t client_id;       // 클라이언트 식별자
+    uint32_t acked_seq;       // standby 가 기록한 마지막 global sequence
+    uint32_t reserved;
+    uint64_t timestamp;       // 보낸 시각 (nanoseconds)
 };
 
 struct RecoveryResponse {
@@ -97,19 +187,94 @@ struct RecoveryComplete {
     uint64_t timestamp;       // 복구 완료 시간
 };
 
+// 압축된 복구 스트림: [RecoveryBatch][stored_size 바이트] -> 풀면 TopicMessage count 개가 이어진 raw_size 바이트
+// (RecoveryRequest::compression 을 요청한 전체 복구의 워커 전송분만, live 꼬리 / 구간 복구는 TopicMessage 그대로)
+struct RecoveryBatch {
+    uint32_t magic;           // MAGIC_RECOVERY_BATCH
+    uint16_t codec;           // BLOCK_CODEC_*
+    uint16_t reserved;
+    uint32_t count;           // 안에 든 TopicMessage 수
+    uint32_t raw_size;        // 압축 해제 크기
+    uint32_t stored_size;     // 뒤따르는 압축 데이터 크기
+};
+
+// UDP multicast datagram: [MulticastHeader][TopicMessage]...[TopicMessage]
+struct MulticastHeader {
+    uint32_t magic;           // MAGIC_MCAST_DATA
+    uint32_t publisher_id;    // 같은 그룹을 여러 publisher 가 쓸 때 구분
+    uint32_t first_seq;       // 첫 TopicMessage 의 global sequence
+    uint16_t count;           // datagram 안의 TopicMessage 수
+    uint16_t reserved;
+};
+
 // Pending message structure for Gap-Free Recovery
+// 본문은 MessageBuffer 참조 + 구간 (publish batch 를 복사 없이 잡아두거나, 풀 버퍼에 한번 복사)
 struct PendingMessage {
     DataTopic topic;
     uint32_t global_seq;
     uint32_t topic_seq;
-    std::vector<char> data;
+    SimplePubSub::MessageBufferRef buffer;
+    uint32_t offset;
+    uint32_t length;
     uint64_t timestamp;
     
     PendingMessage(DataTopic t, uint32_t g_seq, uint32_t t_seq, const char* msg_data, size_t size)
-        : topic(t), global_seq(g_seq), topic_seq(t_seq), data(msg_data, msg_data + size), 
-          timestamp(std::chrono::duration_cast<std::chrono::nanoseconds>(
-              std::chrono::steady_clock::now().time_since_epoch()).count()) {}
+        : topic(t), global_seq(g_seq), topic_seq(t_seq), buffer(SimplePubSub::MessageBufferRef::acquire(size)),
+          offset(0), length(static_cast<uint32_t>(size)), timestamp(now_ns()) {
+        if (buffer) memcpy(buffer.data(), msg_data, size);
+        else length = 0;
+    }
+    // buf 의 [off, off + size) 를 참조 (add_ref)
+    PendingMessage(DataTopic t, uint32_t g_seq, uint32_t t_seq, SimplePubSub::MessageBuffer* buf, size_t off, size_t size)
+        : topic(t), global_seq(g_seq), topic_seq(t_seq), buffer(SimplePubSub::MessageBufferRef::share(buf)),
+          offset(static_cast<uint32_t>(off)), length(static_cast<uint32_t>(size)), timestamp(now_ns()) {}
+    
+    const char* data() const { return buffer.data() + offset; }
+    size_t size() const { return length; }
+    
+    static uint64_t now_ns() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+};
+// 송신 큐(output evbuffer)가 high watermark 를 넘은 느린 구독자 처리 정책
+enum SlowConsumerPolicy {
+    SLOW_CONSUMER_RESYNC = 0,       // 전송 중단 후 RECOVERY_NEEDED, 큐가 비면 MessageDB 에서 복구
+    SLOW_CONSUMER_CONFLATE = 1,     // key 별 최신 메시지만 보관, 큐가 비면 MAGIC_TOPIC_CONFLATED 로 전송
+    SLOW_CONSUMER_DISCONNECT = 2    // 연결 종료 (구독자가 재연결 후 복구)
+};
+
+// 구독자 데이터 수신 경로
+enum DataTransport {
+    TRANSPORT_SOCKET = 0,       // 구독 socket 으로 TopicMessage 수신
+    TRANSPORT_SHM = 1,          // 같은 호스트: 공유메모리 로그 (ShmTopicLog)
+    TRANSPORT_MULTICAST = 2     // 원격 호스트: UDP multicast, 누락분은 socket 복구
+};
+
+// socket 실시간 TopicMessage payload 형식 (SubscriptionRequest::wire_encoding)
+enum WireEncoding {
+    WIRE_ENCODING_NONE = 0,         // 레코드 그대로 (MAGIC_TOPIC_MSG)
+    WIRE_ENCODING_COMPACT = 1       // publisher 에 WireCodec 이 등록된 레코드는 compact 형식 (MAGIC_TOPIC_WIRE)
+};
+
+// index 비트셋 - TopicFilter 는 TopicRegistry slot, SymbolFilter 는 publisher symbol index (master 레코드 번호)
+struct IndexBitset {
+    std::vector<uint64_t> bits;
+
+    void add(int slot) {
+        if (slot < 0) return;
+        size_t word = static_cast<size_t>(slot) / 64;
+        if (word >= bits.size()) bits.resize(word + 1, 0);
+        bits[word] |= 1ULL << (slot % 64);
+    }
+    bool has(int slot) const {
+        size_t word = static_cast<size_t>(slot) / 64;
+        return slot >= 0 && word < bits.size() && (bits[word] & (1ULL << (slot % 64))) != 0;
+    }
 };
+typedef IndexBitset TopicFilter;
+typedef IndexBitset SymbolFilter;
+
 // Forward declaration removed - defined in SimplePublisherV2.h
 // Client information structure
 struct ClientInfo {
@@ -140,8 +305,64 @@ struct ClientInfo {
     void* parent;
     std::mutex mu;
 
-    // 복구 중 실시간 발행 메시지 버퍼
-    std::queue<PendingMessage> pending_messages;
+    // 복구 cursor: 복구 중 발행된 메시지는 복사해 두지 않고 MessageDB 에서 이 seq 부터 이어서 읽는다
+    // (RECOVERING 동안은 담당 워커 스레드만 접근, ONLINE 복귀 시 main 이 나머지를 보냄)
+    uint32_t recovery_next_seq = 0;
+    uint32_t recovery_sent = 0;
+    void* recovery_worker = nullptr;
+    bool recovery_throttled = false;        // 복구 대역폭 예산을 기다리는 중 (워커 throttled 목록에 있음)
+
+    // 데이터 수신 경로 (SHM/MULTICAST 이면 socket 은 구독/복구 제어용으로만 사용, fan-out 대상 아님)
+    DataTransport data_transport = TRANSPORT_SOCKET;
+
+    // 담당 I/O reactor 번호 (-1: main base), 구독 시 (reactor 가 accept 한 TCP 연결은 accept 시) 정해지며 이후 바뀌지 않는다
+    int reactor = -1;
+
+    // 복구 중(RecoveryComplete 직후 main base 복귀 전 포함) 들어온 복구 요청, ONLINE 복귀 시 처리
+    bool recovery_deferred = false;
+    uint32_t deferred_recovery_seq = 0;
+
+    // 송신 큐 backpressure (main 또는 담당 reactor 스레드에서만 접근)
+    size_t high_watermark = 0;              // output evbuffer 상한 (0: 제한 없음)
+    size_t peak_queued_bytes = 0;
+    uint64_t dropped_messages = 0;          // RESYNC 로 보내지 않은 메시지 수
+    uint64_t conflated_messages = 0;        // CONFLATE 로 대체된 메시지 수
+    uint64_t slow_consumer_events = 0;
+    uint32_t resync_from_seq = 0;           // RESYNC: 큐가 비면 이 global seq 부터 복구
+    std::deque<std::pair<uint32_t, uint32_t>> gap_ranges;  // 보내는 중인 GapRecoveryRequest 구간 [next, end]
+    bool conflating = false;
+    std::unordered_map<uint64_t, std::vector<char>> conflated;  // key -> 최신 TopicMessage (CONFLATE, conflate_mask)
+
+    // 구독 요청의 conflation 옵션 (conflate_mask 토픽은 key 별 최신값만 전송, seq 는 건너뛸 수 있음)
+    uint32_t conflate_mask = 0;
+    uint32_t conflate_interval_ms = 0;
+    bool conflate_flush_armed = false;      // write callback 또는 timer 로 flush 대기 중
+    struct event* conflate_timer = nullptr;
+
+    // write coalescing (set_write_coalescing, main 또는 담당 reactor 스레드에서만 접근)
+    bool write_held = false;                // EV_WRITE 를 꺼두고 output 에 모으는 중
+    uint64_t write_hold_since = 0;          // 모으기 시작한 시각 (ns)
+    uint64_t last_write_release = 0;        // 마지막으로 socket write 를 허용한 시각 (ns)
+    struct event* coalesce_timer = nullptr;
+
+    // TopicFilterRequest 로 받은 토픽 목록 (nullptr: topic_mask group 의 모든 토픽), 스냅샷 재구성 시 복사
+    std::shared_ptr<const TopicFilter> topic_filter;
+    // SymbolFilterRequest 로 받은 종목 index (nullptr: 모든 종목), 같은 방식으로 스냅샷에 복사
+    std::shared_ptr<const SymbolFilter> symbol_filter;
+
+    // 구독 요청의 wire_encoding (COMPACT 이면 실시간 fan-out 은 인코딩된 batch 로, 복구/conflation 은 원래 형식)
+    uint32_t wire_encoding = WIRE_ENCODING_NONE;
+
+    // 복구 요청의 compression (publisher 가 지원하지 않는 codec 이면 NONE), 워커의 복구 스트림에만 적용
+    uint32_t recovery_compression = 0;
+    // RangeFetchRequest 구간의 끝 seq (0: 일반 복구, live 까지 보내고 ONLINE), 구독하지 않은 연결에서만 사용
+    uint32_t recovery_end_seq = 0;
+
+    // ReplicaAck 를 보낸 standby 연결 (mu 로 보호, get_replica_status 가 읽음)
+    bool replica = false;
+    uint32_t replica_acked_seq = 0;
+    uint64_t replica_ack_time = 0;          // 마지막 ack 받은 시각 (ns)
+    uint64_t replica_acks = 0;
 };
 
 /* 미사용
@@ -158,20 +379,50 @@ struct RecoveryTask {
 
 // Message constants
 constexpr uint32_t MAGIC_TOPIC_MSG = 0x544F5049;     // 'TOPI'
+constexpr uint32_t MAGIC_TOPIC_CONFLATED = 0x544F5043; // 'TOPC' (TopicMessage, 느린 구독자용 key 별 최신값 - seq 가 건너뛸 수 있음)
+constexpr uint32_t MAGIC_TOPIC_WIRE = 0x544F5057;     // 'TOPW' (TopicMessage, data 는 WireCodec compact 형식)
 constexpr uint32_t MAGIC_SUBSCRIBE = 0x53554253;     // 'SUBS'
+constexpr uint32_t MAGIC_SHM_SUBSCRIBE = 0x5355424D; // 'SUBM' (SubscriptionRequest, shm 로그 수신 요청)
+constexpr uint32_t MAGIC_MCAST_SUBSCRIBE = 0x53554243; // 'SUBC' (SubscriptionRequest, multicast 수신 요청)
+constexpr uint32_t MAGIC_MCAST_DATA = 0x4D435354;    // 'MCST'
 constexpr uint32_t MAGIC_SUB_OK = 0x53554F4B;        // 'SUOK'
+constexpr uint32_t MAGIC_TOPIC_FILTER = 0x53554246;  // 'SUBF' (TopicFilterRequest)
+constexpr uint32_t MAGIC_SYMBOL_FILTER = 0x53554259; // 'SUBY' (SymbolFilterRequest)
 constexpr uint32_t MAGIC_RECOVERY_REQ = 0x52454352;  // 'RECR'
 constexpr uint32_t MAGIC_RECOVERY_RES = 0x52454353;  // 'RECS'
 constexpr uint32_t MAGIC_RECOVERY_CMP = 0x52454343;  // 'RECC'
+constexpr uint32_t MAGIC_GAP_RECOVERY_REQ = 0x52454347; // 'RECG' (GapRecoveryRequest)
+constexpr uint32_t MAGIC_TIME_RECOVERY_REQ = 0x52454354; // 'RECT' (TimeRecoveryRequest)
+constexpr uint32_t MAGIC_RECOVERY_BATCH = 0x5245435A; // 'RECZ' (RecoveryBatch, 압축된 복구 TopicMessage 묶음)
+constexpr uint32_t MAGIC_REPLICA_ACK = 0x52455041;   // 'REPA' (ReplicaAck, standby 기록 확인)
+constexpr uint32_t MAGIC_RANGE_FETCH_REQ = 0x52454346; // 'RECF' (RangeFetchRequest, 병렬 복구 구간 요청)
+
+// SubscriptionResponse::result
+constexpr uint32_t SUB_RESULT_OK = 0;
+constexpr uint32_t SUB_RESULT_FAIL = 1;
+constexpr uint32_t SUB_RESULT_SHM = 2;               // MAGIC_SHM_SUBSCRIBE 승인, 데이터는 shm 로그로 수신
+constexpr uint32_t SUB_RESULT_MCAST = 3;             // MAGIC_MCAST_SUBSCRIBE 승인, 데이터는 multicast 로 수신
 
 inline std::string magic_to_string(uint32_t magic) {
     switch(magic) {
         case MAGIC_TOPIC_MSG: return "TOPI";
+        case MAGIC_TOPIC_CONFLATED: return "TOPC";
+        case MAGIC_TOPIC_WIRE: return "TOPW";
         case MAGIC_SUBSCRIBE: return "SUBS";
+        case MAGIC_SHM_SUBSCRIBE: return "SUBM";
+        case MAGIC_MCAST_SUBSCRIBE: return "SUBC";
+        case MAGIC_MCAST_DATA: return "MCST";
         case MAGIC_SUB_OK:  return "SUOK";
+        case MAGIC_TOPIC_FILTER: return "SUBF";
+        case MAGIC_SYMBOL_FILTER: return "SUBY";
         case MAGIC_RECOVERY_REQ: return "RECR";
         case MAGIC_RECOVERY_RES: return "RECS";
         case MAGIC_RECOVERY_CMP: return "RECC";
+        case MAGIC_GAP_RECOVERY_REQ: return "RECG";
+        case MAGIC_TIME_RECOVERY_REQ: return "RECT";
+        case MAGIC_RECOVERY_BATCH: return "RECZ";
+        case MAGIC_REPLICA_ACK: return "REPA";
+        case MAGIC_RANGE_FETCH_REQ: return "RECF";
         default: return "UNKNOWN";
     }
 }
@@ -183,7 +434,11 @@ inline uint64_t get_current_timestamp() {
     ).count();
 }
 
+// 확장 토픽은 "<group>#<number>" (등록 이름은 TopicRegistry::name)
 inline std::string topic_to_string(DataTopic topic) {
+    if (topic_number(topic) != 0) {
+        return topic_to_string(static_cast<DataTopic>(topic_group(topic))) + "#" + std::to_string(topic_number(topic));
+    }
     switch (topic) {
         case TOPIC1: return "TOPIC1";
         case TOPIC2: return "TOPIC2";
@@ -194,7 +449,17 @@ inline std::string topic_to_string(DataTopic topic) {
 }
 
 inline bool is_topic_subscribed(uint32_t topic_mask, DataTopic topic) {
-    return (topic_mask & static_cast<uint32_t>(topic)) != 0;
+    return (topic_mask & topic_group(topic)) != 0;
+}
+
+// TCP socket 수신 시 커널이 NIC 큐를 busy_poll_us 동안 poll (실패 시 errno, 기본값보다 크게 하려면 CAP_NET_ADMIN 필요)
+inline bool set_socket_busy_poll(int fd, int busy_poll_us) {
+#ifdef SO_BUSY_POLL
+    return setsockopt(fd, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_us, sizeof(busy_poll_us)) == 0;
+#else
+    (void)fd; (void)busy_poll_us;
+    return false;
+#endif
 }
 
 
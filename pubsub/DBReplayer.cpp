@@ -0,0 +1,278 @@
+#include "DBReplayer.h"
+#include "SimplePublisherV2.h"
+#include <iostream>
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <cstring>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace {
+
+const uint64_t SPIN_NS = 200000;            // 이보다 적게 남으면 sleep 하지 않고 yield 하며 기다림
+const uint64_t MAX_SLEEP_NS = 1000000;      // 한번에 자는 최대 시간 (idle / stop 확인 주기)
+
+uint64_t steady_ns() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+DBReplayer::DBReplayer(const std::string& base_path)
+    : _base_path(base_path), _index_fd(-1), _data_fd(-1), _index(nullptr), _data(nullptr),
+      _index_bytes(0), _data_bytes(0), _count(0), _stop(false) {}
+
+DBReplayer::~DBReplayer() {
+    close();
+}
+
+bool DBReplayer::open() {
+    close();
+    std::string index_path = _base_path + ".idx";
+    std::string data_path = _base_path + ".data";
+    _index_fd = ::open(index_path.c_str(), O_RDONLY);
+    _data_fd = ::open(data_path.c_str(), O_RDONLY);
+    if (_index_fd < 0 || _data_fd < 0) {
+        std::cerr << "DBReplayer: failed to open " << _base_path << ": " << strerror(errno) << std::endl;
+        close();
+        return false;
+    }
+    struct stat st;
+    fstat(_index_fd, &st);
+    _index_bytes = static_cast<size_t>(st.st_size);
+    fstat(_data_fd, &st);
+    _data_bytes = static_cast<size_t>(st.st_size);
+
+    // 압축 block 형식 (데이터 파일 첫 block header) 이면 DB_SAM 으로 읽음
+    uint32_t magic = 0;
+    if (_data_bytes >= sizeof(SAM_BLOCK_HEADER) &&
+        ::pread(_data_fd, &magic, sizeof(magic), 0) == static_cast<ssize_t>(sizeof(magic)) &&
+        magic == DB_SAM_BLOCK_MAGIC) {
+        unmap();
+        _db.reset(new DB_SAM(_base_path));
+        if (!_db->open()) {
+            std::cerr << "DBReplayer: failed to open block db " << _base_path << std::endl;
+            _db.reset();
+            return false;
+        }
+        std::cout << "DBReplayer: " << _base_path << " (compressed, " << _db->count() << " messages)" << std::endl;
+        return true;
+    }
+
+    if (_index_bytes >= sizeof(SAM_INDEX) && _data_bytes > 0) {
+        void* index = mmap(nullptr, _index_bytes, PROT_READ, MAP_SHARED, _index_fd, 0);
+        void* data = mmap(nullptr, _data_bytes, PROT_READ, MAP_SHARED, _data_fd, 0);
+        if (index == MAP_FAILED || data == MAP_FAILED) {
+            std::cerr << "DBReplayer: mmap failed for " << _base_path << ": " << strerror(errno) << std::endl;
+            if (index != MAP_FAILED) munmap(index, _index_bytes);
+            if (data != MAP_FAILED) munmap(data, _data_bytes);
+            close();
+            return false;
+        }
+        madvise(index, _index_bytes, MADV_SEQUENTIAL);
+        madvise(data, _data_bytes, MADV_SEQUENTIAL);
+        _index = static_cast<const SAM_INDEX*>(index);
+        _data = static_cast<const char*>(data);
+    }
+
+    // 기록 중이거나 비정상 종료된 파일: 데이터 파일 밖을 가리키는 꼬리 entry 는 버림
+    uint32_t n = _index ? static_cast<uint32_t>(_index_bytes / sizeof(SAM_INDEX)) : 0;
+    while (n > 0 && (_index[n - 1]._seek < 0 ||
+                     static_cast<uint64_t>(_index[n - 1]._seek) + _index[n - 1]._size > _data_bytes)) {
+        --n;
+    }
+    _count = n;
+    std::cout << "DBReplayer: " << _base_path << " mapped (" << _count << " messages)" << std::endl;
+    return true;
+}
+
+void DBReplayer::unmap() {
+    if (_index) munmap(const_cast<SAM_INDEX*>(_index), _index_bytes);
+    if (_data) munmap(const_cast<char*>(_data), _data_bytes);
+    _index = nullptr;
+    _data = nullptr;
+    if (_index_fd >= 0) ::close(_index_fd);
+    if (_data_fd >= 0) ::close(_data_fd);
+    _index_fd = _data_fd = -1;
+}
+
+void DBReplayer::close() {
+    unmap();
+    if (_db) {
+        _db->close();
+        _db.reset();
+    }
+    _index_bytes = _data_bytes = 0;
+    _count = 0;
+}
+
+bool DBReplayer::get_index(uint32_t seq, SAM_INDEX& index) const {
+    if (_db) {
+        return _db->get_index(seq, index);
+    }
+    if (seq < 1 || seq > _count) {
+        return false;
+    }
+    index = _index[seq - 1];
+    return true;
+}
+
+uint32_t DBReplayer::seek_time(uint64_t timestamp) const {
+    if (_db) {
+        return _db->seek_time(timestamp);
+    }
+    const SAM_INDEX* end = _index + _count;
+    const SAM_INDEX* it = std::lower_bound(_index, end, timestamp,
+                                           [](const SAM_INDEX& e, uint64_t t) { return e._timestamp < t; });
+    return it != end ? it->_seq : 0;
+}
+
+uint32_t DBReplayer::resolve_start(const ReplayOptions& options) const {
+    if (options.since_ns) {
+        return seek_time(options.since_ns);
+    }
+    return options.start_seq ? options.start_seq : 1;
+}
+
+bool DBReplayer::wait_until(uint64_t target, const ReplayIdleFn& idle) const {
+    for (;;) {
+        if (_stop.load(std::memory_order_relaxed)) return false;
+        uint64_t now = steady_ns();
+        if (now >= target) return true;
+        if (idle) {
+            idle();
+            now = steady_ns();
+            if (now >= target) return true;
+        }
+        uint64_t left = target - now;
+        if (left > SPIN_NS) {
+            std::this_thread::sleep_for(std::chrono::nanoseconds(std::min(left - SPIN_NS, MAX_SLEEP_NS)));
+        } else {
+            std::this_thread::yield();
+        }
+    }
+}
+
+ReplayStats DBReplayer::run(const ReplayOptions& options, const ReplaySink& sink) {
+    ReplayStats stats;
+    _stop.store(false);
+    uint32_t last = count();
+    uint32_t start = resolve_start(options);
+    uint32_t end = options.end_seq ? std::min(options.end_seq, last) : last;
+    if (!sink || start == 0 || start > end) {
+        return stats;
+    }
+
+    const bool paced = options.pacing != ReplayPacing::MAX;
+    const double speed = (options.pacing == ReplayPacing::SPEED && options.speed > 0) ? options.speed : 1.0;
+    const size_t batch_max = std::max<size_t>(options.batch_max, 1);
+    const bool staged = _index == nullptr;      // DB_SAM 경로는 콜백 밖에서 넘기려고 복사
+
+    std::vector<MessageSlice> slices;
+    std::vector<size_t> offsets;
+    std::vector<char> staging;
+    slices.reserve(batch_max);
+    uint64_t batch_ts = 0, first_ts = 0, last_ts = 0, wall_start = 0;
+    bool sink_stopped = false;
+
+    auto flush = [&]() -> bool {
+        if (slices.empty()) return true;
+        if (staged) {
+            for (size_t i = 0; i < slices.size(); ++i) slices[i].data = staging.data() + offsets[i];
+        }
+        if (paced) {
+            uint64_t offset = batch_ts > first_ts ? batch_ts - first_ts : 0;
+            uint64_t target = wall_start + static_cast<uint64_t>(offset / speed);
+            if (!wait_until(target, options.idle)) return false;
+            uint64_t now = steady_ns();
+            if (now > target) stats.max_behind_ns = std::max(stats.max_behind_ns, now - target);
+        }
+        if (!sink(slices.data(), slices.size())) {
+            sink_stopped = true;
+        }
+        stats.batches++;
+        slices.clear();
+        offsets.clear();
+        staging.clear();
+        if (options.idle) options.idle();
+        return !sink_stopped && !_stop.load(std::memory_order_relaxed);
+    };
+
+    auto on_message = [&](uint32_t seq, uint64_t timestamp, const void* data, size_t size) -> bool {
+        if (options.until_ns && timestamp > options.until_ns) return false;
+        const TopicMessage* msg = static_cast<const TopicMessage*>(data);
+        if (size < sizeof(TopicMessage) || msg->magic != MAGIC_TOPIC_MSG ||
+            sizeof(TopicMessage) + msg->data_size > size ||
+            !is_topic_subscribed(options.topic_mask, msg->topic)) {
+            stats.skipped++;
+            return true;
+        }
+        if (stats.messages == 0) {
+            first_ts = timestamp;
+            wall_start = steady_ns();
+            stats.first_seq = seq;
+        }
+        if (!slices.empty() && (slices.size() >= batch_max || (paced && timestamp != batch_ts))) {
+            if (!flush()) return false;
+        }
+        if (slices.empty()) batch_ts = timestamp;
+        if (staged) {
+            offsets.push_back(staging.size());
+            staging.insert(staging.end(), static_cast<const char*>(data), static_cast<const char*>(data) + size);
+            slices.push_back(MessageSlice{nullptr, size});
+        } else {
+            slices.push_back(MessageSlice{data, size});
+        }
+        stats.messages++;
+        stats.bytes += size;
+        stats.last_seq = seq;
+        last_ts = timestamp;
+        return true;
+    };
+
+    if (_index) {
+        for (uint32_t seq = start; seq <= end; ++seq) {
+            const SAM_INDEX& e = _index[seq - 1];
+            if (e._seq != seq) {
+                stats.skipped++;
+                continue;
+            }
+            if (!on_message(seq, e._timestamp, _data + e._seek, e._size)) break;
+        }
+    } else {
+        _db->get_range(start, end, [&](uint32_t seq, const SAM_INDEX& index, const void* data, size_t size) {
+            return on_message(seq, index._timestamp, data, size);
+        });
+    }
+    if (!sink_stopped && !_stop.load()) {
+        flush();
+    }
+
+    if (stats.messages > 0) {
+        stats.source_span_ns = last_ts - first_ts;
+        stats.elapsed_ns = steady_ns() - wall_start;
+    }
+    return stats;
+}
+
+ReplaySink DBReplayer::publisher_sink(SimplePublisherV2& publisher) {
+    return [&publisher](const MessageSlice* slices, size_t count) {
+        publisher.republish_batch(slices, count);
+        return true;
+    };
+}
+
+ReplaySink DBReplayer::callback_sink(std::function<void(DataTopic topic, const char* data, int size)> callback) {
+    return [callback](const MessageSlice* slices, size_t count) {
+        for (size_t i = 0; i < count; ++i) {
+            const TopicMessage* msg = static_cast<const TopicMessage*>(slices[i].data);
+            callback(msg->topic, msg->data, static_cast<int>(msg->data_size));
+        }
+        return true;
+    };
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <string>
+#include <memory>
+#include <atomic>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "pubsub/Common.h"
+#include "common/db_sam.h"
+
+using namespace SimplePubSub;
+
+class SimplePublisherV2;
+
+// replay 속도
+enum class ReplayPacing {
+    ORIGINAL,   // 기록된 timestamp 간격 그대로
+    SPEED,      // 기록 간격 / speed (N배속)
+    MAX         // 기다리지 않고 최대한 빨리
+};
+
+// sink 한번 호출 = 같은 DB timestamp (publisher batch) 의 연속 메시지 (MAX 는 batch_max 까지 묶음)
+// slices[i].data 는 TopicMessage (header + data), 호출 동안만 유효. false 를 반환하면 replay 중단
+typedef std::function<bool(const MessageSlice* slices, size_t count)> ReplaySink;
+// 다음 batch 시각을 기다리는 동안 / batch 사이에 호출 (같은 스레드의 event loop pump 등)
+typedef std::function<void()> ReplayIdleFn;
+
+struct ReplayOptions {
+    ReplayPacing pacing;
+    double speed;               // SPEED 배율 (ORIGINAL = 1)
+    uint32_t start_seq;         // 0: 처음부터
+    uint32_t end_seq;           // 0: 끝까지
+    uint64_t since_ns;          // 0 이 아니면 start_seq 대신 이 시각 이후 첫 메시지부터 (시간 인덱스 이분 탐색)
+    uint64_t until_ns;          // 0 이 아니면 이 시각 이후 메시지에서 멈춤
+    uint32_t topic_mask;        // 이 토픽만 (DataTopic 비트 OR)
+    size_t batch_max;           // sink 한번에 넘기는 최대 메시지 수
+    ReplayIdleFn idle;
+
+    ReplayOptions()
+        : pacing(ReplayPacing::ORIGINAL), speed(1.0), start_seq(0), end_seq(0), since_ns(0), until_ns(0),
+          topic_mask(static_cast<uint32_t>(DataTopic::ALL_TOPICS)), batch_max(256) {}
+};
+
+struct ReplayStats {
+    uint64_t messages;          // sink 로 넘긴 메시지
+    uint64_t bytes;             // TopicMessage 전체 크기 합
+    uint64_t batches;
+    uint64_t skipped;           // topic_mask 로 건너뛰거나 TopicMessage 형식이 아닌 레코드
+    uint32_t first_seq;
+    uint32_t last_seq;
+    uint64_t source_span_ns;    // 첫 / 마지막 메시지 timestamp 차이
+    uint64_t elapsed_ns;        // replay 에 걸린 시간
+    uint64_t max_behind_ns;     // 예정 시각보다 가장 늦게 보낸 정도 (sink 가 따라가지 못한 정도)
+
+    ReplayStats() : messages(0), bytes(0), batches(0), skipped(0), first_seq(0), last_seq(0),
+                    source_span_ns(0), elapsed_ns(0), max_behind_ns(0) {}
+    double msgs_per_sec() const { return elapsed_ns ? messages * 1e9 / elapsed_ns : 0.0; }
+    double mb_per_sec() const { return elapsed_ns ? bytes * 1e9 / elapsed_ns / (1024.0 * 1024.0) : 0.0; }
+    // 실제 배속 (기록 구간 / 걸린 시간)
+    double achieved_speed() const { return elapsed_ns ? static_cast<double>(source_span_ns) / elapsed_ns : 0.0; }
+};
+
+/**
+ * DBReplayer - 기록된 DB_SAM 파일 (<base>.idx / <base>.data) 을 원래 간격 / N배속 / 최대 속도로 다시 흘려보낸다.
+ *
+ * raw 형식 파일은 두 파일을 읽기 전용으로 mmap 해서 (MADV_SEQUENTIAL) 복사 없이 sink 로 넘기고,
+ * 압축 block 형식이면 DB_SAM::get_range 로 읽는다. 기록 중인 파일도 열 수 있다 (open 시점까지의 메시지만).
+ * TopicMessage 는 기록된 그대로 (global/topic seq, timestamp) 넘기며, sink 는
+ *  - publisher_sink : SimplePublisherV2::republish_batch 로 live publisher 에 다시 발행
+ *  - callback_sink  : 구독자 topic callback 과 같은 형식의 콜백을 소켓 없이 직접 호출
+ * 또는 임의의 ReplaySink 를 쓴다. run() 은 호출한 스레드에서 돌고, pacing 대기 중에는 options.idle 을 부른다.
+ */
+class DBReplayer {
+private:
+    std::string _base_path;
+    int _index_fd;
+    int _data_fd;
+    const SAM_INDEX* _index;        // mmap (raw 형식)
+    const char* _data;
+    size_t _index_bytes;
+    size_t _data_bytes;
+    uint32_t _count;                // 온전한 (data 파일 안에 있는) 메시지 수
+    std::unique_ptr<DB_SAM> _db;    // 압축 block 형식이면 DB_SAM 으로 읽음
+    std::atomic<bool> _stop;
+
+    void unmap();
+    uint32_t resolve_start(const ReplayOptions& options) const;
+    /* target (steady clock ns) 까지 idle 을 부르며 기다림, stop() 되면 false */
+    bool wait_until(uint64_t target, const ReplayIdleFn& idle) const;
+
+public:
+    explicit DBReplayer(const std::string& base_path);
+    ~DBReplayer();
+
+    DBReplayer(const DBReplayer&) = delete;
+    DBReplayer& operator=(const DBReplayer&) = delete;
+
+    bool open();
+    void close();
+    bool is_mapped() const { return _index != nullptr; }
+
+    uint32_t count() const { return _db ? _db->count() : _count; }
+    bool get_index(uint32_t seq, SAM_INDEX& index) const;
+    // timestamp 이상인 첫 seq (없으면 0)
+    uint32_t seek_time(uint64_t timestamp) const;
+
+    ReplayStats run(const ReplayOptions& options, const ReplaySink& sink);
+    // 다른 스레드에서 run 중단
+    void stop() { _stop.store(true); }
+
+    static ReplaySink publisher_sink(SimplePublisherV2& publisher);
+    static ReplaySink callback_sink(std::function<void(DataTopic topic, const char* data, int size)> callback);
+};
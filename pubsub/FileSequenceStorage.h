@@ -5,6 +5,8 @@
 #include <iostream>
 #include <string>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <cstdio>
 #include <unistd.h>
 
 namespace SimplePubSub {
@@ -14,6 +16,7 @@ private:
     std::string _storage_directory;
     // std::string _file_prefix;
     std::string _file_path;
+    bool _durable = false;      // true: 임시 파일에 쓰고 fsync 후 rename (중간에 죽어도 이전/새 레코드 중 하나)
     
     std::string get_file_path() const {
         // return _storage_directory + "/" + _file_prefix + "_" + publisher_name + ".seq";
@@ -43,6 +46,9 @@ public:
             std::cerr << "Failed to create storage directory: " << _storage_directory << std::endl;
             return false;
         }
+        if (_durable) {
+            return save_sequences_atomic(record);
+        }
         
         std::string file_path = get_file_path();
         std::ofstream file(file_path, std::ios::binary | std::ios::trunc);
@@ -63,6 +69,25 @@ public:
         return true;
     }
     
+    bool save_sequences_atomic(const PublisherSequenceRecord& record) {
+        std::string file_path = get_file_path();
+        std::string tmp_path = file_path + ".tmp";
+        int fd = ::open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+        if (fd < 0) {
+            std::cerr << "Failed to open sequence file for writing: " << tmp_path << std::endl;
+            return false;
+        }
+        bool ok = ::write(fd, &record, sizeof(PublisherSequenceRecord)) == static_cast<ssize_t>(sizeof(PublisherSequenceRecord));
+        ok = ok && ::fsync(fd) == 0;
+        ::close(fd);
+        if (!ok || ::rename(tmp_path.c_str(), file_path.c_str()) != 0) {
+            std::cerr << "Failed to write sequence record to file: " << file_path << std::endl;
+            ::unlink(tmp_path.c_str());
+            return false;
+        }
+        return true;
+    }
+    
     bool load_sequences(const std::string& publisher_name, PublisherSequenceRecord* record) override {
         std::string file_path = get_file_path();
         std::ifstream file(file_path, std::ios::binary);
@@ -109,6 +134,10 @@ public:
     }
     
     // Additional file-specific methods
+    void set_durable(bool durable) {
+        _durable = durable;
+    }
+    
     void set_storage_directory(const std::string& dir) {
         _storage_directory = dir;
     }
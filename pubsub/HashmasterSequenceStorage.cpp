@@ -294,23 +294,20 @@ bool HashmasterSequenceStorage::list_all_publishers(std::vector<std::string>& pu
     publisher_names.clear();
     
     try {
-        // 현재 HashMaster API에서 iterator가 지원되지 않으므로 순차적으로 체크
-        int max_records = get_max_publishers();
-        for (int i = 0; i < max_records; i++) {
-            char* record_data = hashmaster_->get_record_by_seq(i + 1);  // 1-based index
-            if (record_data) {
-                // PublisherSequenceRecord로 캐스팅
-                PublisherSequenceRecord* record = reinterpret_cast<PublisherSequenceRecord*>(record_data);
-
-                // 유효한 레코드인지 확인 (publisher_name이 비어있지 않은지)
-                if (strlen(record->publisher_name) > 0) {
-                    std::cout << "[HashMasterStorage] Found publisher: " << record->publisher_name
-                              << " (ID: " << record->publisher_id
-                              << ", Date: " << record->publisher_date
-                              << ", All_Topics_Seq: " << record->all_topics_sequence << ")" << std::endl;
-
-                    publisher_names.emplace_back(record->publisher_name);
-                }
+        // live 레코드만 돈다
+        HashMaster::Iterator it = hashmaster_->begin();
+        while (char* record_data = it.next()) {
+            // PublisherSequenceRecord로 캐스팅
+            PublisherSequenceRecord* record = reinterpret_cast<PublisherSequenceRecord*>(record_data);
+
+            // 유효한 레코드인지 확인 (publisher_name이 비어있지 않은지)
+            if (strlen(record->publisher_name) > 0) {
+                std::cout << "[HashMasterStorage] Found publisher: " << record->publisher_name
+                          << " (ID: " << record->publisher_id
+                          << ", Date: " << record->publisher_date
+                          << ", All_Topics_Seq: " << record->all_topics_sequence << ")" << std::endl;
+
+                publisher_names.emplace_back(record->publisher_name);
             }
         }
         
@@ -415,6 +412,7 @@ bool HashmasterSequenceStorage::clear_publisher_record(const std::string& publis
             record->misc_sequence = 0;
             record->all_topics_sequence = 0;
             record->last_updated_time = get_current_time_ns();
+            record->unseal();
             
             std::cout << "[HashMasterStorage] Cleared sequences for existing publisher: " << publisher_name 
                       << " (ID: " << publisher_id << ", Date: " << publisher_date << ")" << std::endl;
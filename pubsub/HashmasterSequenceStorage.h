@@ -2,6 +2,7 @@
 
 #include "SequenceStorage.h"
 #include "../HashMaster/HashMaster.h"
+#include "../common/AsyncLog.h"
 #include <iostream>
 #include <memory>
 #include <string>
@@ -75,13 +76,10 @@ public:
         // 타임스탬프 업데이트
         direct_record_ptr_->last_updated_time = get_current_time_ns();
         
-        std::cout << "##\n## increment_sequence_direct\n ::"
-            << "\t topic:" << static_cast<int>(topic)
-            << "\t all_topic_seq=" << direct_record_ptr_->all_topics_sequence
-            << "\t TOPIC1=" << direct_record_ptr_->topic1_sequence
-            << "\t TOPIC2=" << direct_record_ptr_->topic2_sequence
-            << "\t MISC=" << direct_record_ptr_->misc_sequence
-            << std::endl;
+        ALOG_DEBUG("HashmasterSequenceStorage", "increment_sequence_direct topic:%u all_topic_seq=%u TOPIC1=%u TOPIC2=%u MISC=%u",
+                   static_cast<uint32_t>(topic), direct_record_ptr_->all_topics_sequence,
+                   direct_record_ptr_->topic1_sequence, direct_record_ptr_->topic2_sequence,
+                   direct_record_ptr_->misc_sequence);
 
         return true;
     }
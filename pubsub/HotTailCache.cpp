@@ -0,0 +1,117 @@
+#include "HotTailCache.h"
+
+namespace SimplePubSub {
+
+HotTailCache::HotTailCache()
+    : _pool(nullptr), _max_bytes(0), _head(0), _count(0), _bytes(0), _first_seq(0) {}
+
+HotTailCache::~HotTailCache() {
+    clear();
+}
+
+void HotTailCache::configure(MessageBufferPool* pool, size_t max_messages, size_t max_bytes) {
+    std::lock_guard<std::mutex> g(_mu);
+    clear_locked();
+    _pool = pool;
+    _max_bytes = max_bytes;
+    _ring.assign(pool ? max_messages : 0, Slot{nullptr, 0, 0, false});
+}
+
+void HotTailCache::append(MessageBuffer* buf, const MessageSlice* slices, size_t count, uint32_t first_seq) {
+    std::lock_guard<std::mutex> g(_mu);
+    if (_ring.empty() || count == 0) return;
+    if (_count > 0 && first_seq != _first_seq + static_cast<uint32_t>(_count)) {
+        clear_locked();
+    }
+    // ring 보다 큰 batch 는 뒤쪽만 남긴다
+    size_t skip = count > _ring.size() ? count - _ring.size() : 0;
+    _pool->add_ref(buf);
+    for (size_t i = skip; i < count; ++i) {
+        if (_count == _ring.size()) evict_front_locked();
+        if (_count == 0) _first_seq = first_seq + static_cast<uint32_t>(i);
+        Slot& s = _ring[(_head + _count) % _ring.size()];
+        s.buf = buf;
+        s.offset = static_cast<uint32_t>(static_cast<const char*>(slices[i].data) - buf->data());
+        s.size = static_cast<uint32_t>(slices[i].size);
+        s.batch_end = (i + 1 == count);
+        _count++;
+        _bytes += slices[i].size;
+    }
+    while (_max_bytes > 0 && _bytes > _max_bytes && _count > 0) {
+        evict_front_locked();
+    }
+}
+
+bool HotTailCache::covers(uint32_t from_seq, uint32_t to_seq) {
+    std::lock_guard<std::mutex> g(_mu);
+    return covers_locked(from_seq, to_seq);
+}
+
+bool HotTailCache::stream(evbuffer* out, uint32_t from_seq, uint32_t to_seq, const FilterFn* filter,
+                          uint32_t& sent) {
+    std::lock_guard<std::mutex> g(_mu);
+    sent = 0;
+    if (!covers_locked(from_seq, to_seq)) return false;
+
+    // 같은 buffer 안에서 주소가 이어지는 메시지는 참조 하나로
+    MessageBuffer* run_buf = nullptr;
+    size_t run_offset = 0, run_len = 0;
+    bool ok = true;
+    size_t first = (_head + (from_seq - _first_seq)) % _ring.size();
+    size_t n = static_cast<size_t>(to_seq - from_seq) + 1;
+    for (size_t i = 0; i < n && ok; ++i) {
+        const Slot& s = _ring[(first + i) % _ring.size()];
+        if (filter && !(*filter)(*reinterpret_cast<const TopicMessage*>(s.buf->data() + s.offset))) {
+            continue;
+        }
+        if (run_buf == s.buf && run_offset + run_len == s.offset) {
+            run_len += s.size;
+        } else {
+            if (run_buf) ok = _pool->add_to_evbuffer(out, run_buf, run_offset, run_len) == 0;
+            run_buf = s.buf;
+            run_offset = s.offset;
+            run_len = s.size;
+        }
+        sent++;
+    }
+    if (ok && run_buf) ok = _pool->add_to_evbuffer(out, run_buf, run_offset, run_len) == 0;
+    return ok;
+}
+
+void HotTailCache::clear() {
+    std::lock_guard<std::mutex> g(_mu);
+    clear_locked();
+}
+
+size_t HotTailCache::size() {
+    std::lock_guard<std::mutex> g(_mu);
+    return _count;
+}
+
+size_t HotTailCache::bytes() {
+    std::lock_guard<std::mutex> g(_mu);
+    return _bytes;
+}
+
+uint32_t HotTailCache::first_seq() {
+    std::lock_guard<std::mutex> g(_mu);
+    return _count > 0 ? _first_seq : 0;
+}
+
+void HotTailCache::evict_front_locked() {
+    Slot& s = _ring[_head];
+    if (s.batch_end) _pool->release(s.buf);
+    _bytes -= s.size;
+    s = Slot{nullptr, 0, 0, false};
+    _head = (_head + 1) % _ring.size();
+    _count--;
+    _first_seq++;
+}
+
+void HotTailCache::clear_locked() {
+    while (_count > 0) evict_front_locked();
+    _head = 0;
+    _bytes = 0;
+}
+
+} // namespace SimplePubSub
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <mutex>
+#include <vector>
+#include <functional>
+#include <event2/buffer.h>
+#include "pubsub/Common.h"
+#include "pubsub/MessageBufferPool.h"
+#include "../common/MessageDB.h"
+
+namespace SimplePubSub {
+
+/**
+ * HotTailCache - 최근 발행 메시지 N 개 (또는 M bytes) 의 ring, 짧은 복구를 DB 없이 처리
+ *
+ * publish batch 의 MessageBuffer 를 그대로 참조한다 (복사 없음, batch 당 add_ref 한번).
+ * 메시지 slot 은 {buffer, offset, size} 만 가지며 batch 의 마지막 slot 이 밀려날 때 buffer 를 release 한다.
+ * 전송은 MessageBufferPool::add_to_evbuffer 로 인접한 메시지를 묶어 참조로 추가하므로
+ * 캐시에서 밀려나도 아직 output 에 남아 있는 구간은 evbuffer 가 끝까지 유지한다.
+ *
+ * append 는 publish 스레드 (main) 에서만, stream / covers 는 어느 스레드에서나 (reactor 의 복구 요청 등).
+ * global seq 가 이어지지 않는 batch 가 들어오면 (seq 초기화 등) 이전 내용은 버린다.
+ */
+class HotTailCache {
+public:
+    typedef std::function<bool(const TopicMessage& msg)> FilterFn;
+
+    HotTailCache();
+    ~HotTailCache();
+
+    HotTailCache(const HotTailCache&) = delete;
+    HotTailCache& operator=(const HotTailCache&) = delete;
+
+    /* max_messages == 0 이면 사용 안함, max_bytes == 0 이면 bytes 제한 없음 (기존 내용은 버림) */
+    void configure(MessageBufferPool* pool, size_t max_messages, size_t max_bytes);
+    bool enabled() const { return !_ring.empty(); }
+
+    /* buf 안 연속 TopicMessage (slices) 를 추가, slices[0] 의 global seq 는 first_seq */
+    void append(MessageBuffer* buf, const MessageSlice* slices, size_t count, uint32_t first_seq);
+    /* [from_seq, to_seq] 가 모두 캐시에 있으면 true */
+    bool covers(uint32_t from_seq, uint32_t to_seq);
+    /* [from_seq, to_seq] 를 out 에 참조로 추가, 구간이 캐시에 없으면 아무 것도 하지 않고 false */
+    bool stream(evbuffer* out, uint32_t from_seq, uint32_t to_seq, const FilterFn* filter, uint32_t& sent);
+    void clear();
+
+    size_t size();
+    size_t bytes();
+    uint32_t first_seq();
+
+private:
+    struct Slot {
+        MessageBuffer* buf;
+        uint32_t offset;
+        uint32_t size;
+        bool batch_end;         // buf 를 참조하는 마지막 slot (밀려날 때 release)
+    };
+
+    bool covers_locked(uint32_t from_seq, uint32_t to_seq) const {
+        return _count > 0 && from_seq >= _first_seq && from_seq <= to_seq &&
+               to_seq - _first_seq < _count;
+    }
+    void evict_front_locked();
+    void clear_locked();
+
+    std::mutex _mu;
+    MessageBufferPool* _pool;
+    std::vector<Slot> _ring;
+    size_t _max_bytes;
+    size_t _head;               // 가장 오래된 slot
+    size_t _count;
+    size_t _bytes;
+    uint32_t _first_seq;        // _ring[_head] 의 global seq
+};
+
+} // namespace SimplePubSub
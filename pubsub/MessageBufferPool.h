@@ -0,0 +1,326 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <event2/buffer.h>
+
+namespace SimplePubSub {
+
+class MessageBufferPool;
+
+/*
+ * MessageBuffer - 참조 카운트 기반 메시지 버퍼
+ *
+ * 헤더 바로 뒤에 capacity 바이트의 데이터 영역이 붙어있는 단일 할당 블록.
+ * publish 시 한 번만 채우고, 각 클라이언트의 output evbuffer에는
+ * evbuffer_add_reference로 참조만 추가한다. (클라이언트 수만큼 복사하지 않음)
+ * 마지막 참조가 해제되면 풀로 반환된다.
+ */
+struct MessageBuffer {
+    MessageBufferPool* pool;
+    std::atomic<uint32_t> refcnt;
+    uint32_t size_class;        // MessageBufferPool size class (NO_CLASS: 풀 밖 단독 할당)
+    size_t capacity;
+    size_t size;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+    const char* data() const { return reinterpret_cast<const char*>(this + 1); }
+};
+
+/*
+ * MessageBufferPool - 크기별 (size class) MessageBuffer 재사용 풀
+ *
+ * - acquire(size): size 이상인 가장 작은 class 의 버퍼 (refcnt=1). 가장 큰 class 보다 크면 단독 할당
+ * - add_to_evbuffer(): refcnt +1 후 evbuffer에 참조로 추가, drain 시 자동 release
+ * - release(): refcnt -1, 0이 되면 free list로 반환
+ *
+ * class 마다 free list (mutex) 가 있고, shared() 풀은 스레드마다 class 별 작은 cache 를 둔다.
+ * publish 스레드가 acquire 하고 reactor / recovery 스레드가 evbuffer drain 으로 release 해도
+ * 대부분은 자기 스레드 cache 에서 끝나며, cache 가 차거나 비면 THREAD_BATCH 개씩 free list 와
+ * 주고받는다 (lock 한번). shared() 는 프로세스 끝까지 해제하지 않으므로 (스레드 종료 시 cache 반납)
+ * publisher / 복구 / pending queue 가 같은 풀의 버퍼를 복사 없이 넘겨받을 수 있다.
+ * 따로 만든 풀은 thread cache 없이 free list 만 쓴다 (풀이 먼저 없어질 수 있으므로).
+ */
+class MessageBufferPool {
+public:
+    static const uint32_t CLASS_COUNT = 6;
+    static const uint32_t NO_CLASS = CLASS_COUNT;
+    static const uint32_t THREAD_CACHE_SIZE = 32;     // class 별 스레드 cache 크기
+    static const uint32_t THREAD_BATCH = 16;          // free list 와 한번에 주고받는 수
+
+    static size_t class_capacity(uint32_t cls) {
+        return static_cast<size_t>(256) << (2 * cls);   // 256, 1K, 4K, 16K, 64K, 256K
+    }
+
+    static uint32_t class_of(size_t size) {
+        for (uint32_t cls = 0; cls < CLASS_COUNT; cls++) {
+            if (size <= class_capacity(cls)) return cls;
+        }
+        return NO_CLASS;
+    }
+
+    // 프로세스 공용 풀 (thread cache 사용, 해제하지 않음)
+    static MessageBufferPool& shared() {
+        static MessageBufferPool* pool = new MessageBufferPool(DEFAULT_MAX_CACHED_BYTES, true);
+        return *pool;
+    }
+
+private:
+    static const size_t DEFAULT_MAX_CACHED_BYTES = 16u << 20;    // class 별 free list 상한
+
+    struct FreeList {
+        std::mutex mu;
+        std::vector<MessageBuffer*> buffers;
+        size_t max_count;
+    };
+
+    struct ThreadCache {
+        MessageBuffer* bins[CLASS_COUNT][THREAD_CACHE_SIZE];
+        uint32_t count[CLASS_COUNT];
+
+        ThreadCache() { memset(count, 0, sizeof(count)); }
+        ~ThreadCache() {
+            MessageBufferPool& pool = shared();
+            for (uint32_t cls = 0; cls < CLASS_COUNT; cls++) {
+                pool.push_free(cls, bins[cls], count[cls]);
+                count[cls] = 0;
+            }
+            thread_cache_state() = THREAD_CACHE_DEAD;
+        }
+    };
+
+    enum { THREAD_CACHE_NONE = 0, THREAD_CACHE_LIVE = 1, THREAD_CACHE_DEAD = 2 };
+
+    // trivially destructible 이라 ThreadCache 가 해제된 뒤에도 (thread_local 소멸 순서) 읽을 수 있다
+    static int& thread_cache_state() {
+        static thread_local int state = THREAD_CACHE_NONE;
+        return state;
+    }
+
+    FreeList _free[CLASS_COUNT];
+    bool _thread_cache;
+    std::atomic<uint64_t> _allocated{0};      // malloc 한 버퍼 수 (누적, 단독 할당 포함)
+
+    // 스레드 종료 중 (cache 가 이미 반납됨) 이면 nullptr, free list 를 직접 쓴다
+    static ThreadCache* thread_cache() {
+        if (thread_cache_state() == THREAD_CACHE_DEAD) return nullptr;
+        static thread_local ThreadCache cache;
+        thread_cache_state() = THREAD_CACHE_LIVE;
+        return &cache;
+    }
+
+    MessageBuffer* allocate(uint32_t cls, size_t capacity) {
+        void* mem = std::malloc(sizeof(MessageBuffer) + capacity);
+        if (!mem) return nullptr;
+        _allocated.fetch_add(1, std::memory_order_relaxed);
+        MessageBuffer* buf = new (mem) MessageBuffer();
+        buf->pool = this;
+        buf->refcnt.store(1, std::memory_order_relaxed);
+        buf->size_class = cls;
+        buf->capacity = capacity;
+        buf->size = 0;
+        return buf;
+    }
+
+    static void destroy(MessageBuffer* buf) {
+        buf->~MessageBuffer();
+        std::free(buf);
+    }
+
+    // free list 에서 최대 n 개 (받은 수 반환)
+    uint32_t pop_free(uint32_t cls, MessageBuffer** out, uint32_t n) {
+        FreeList& fl = _free[cls];
+        std::lock_guard<std::mutex> g(fl.mu);
+        uint32_t got = 0;
+        while (got < n && !fl.buffers.empty()) {
+            out[got++] = fl.buffers.back();
+            fl.buffers.pop_back();
+        }
+        return got;
+    }
+
+    // free list 에 반환, 상한을 넘는 것은 해제
+    void push_free(uint32_t cls, MessageBuffer* const* bufs, uint32_t n) {
+        if (n == 0) return;
+        FreeList& fl = _free[cls];
+        uint32_t kept = 0;
+        {
+            std::lock_guard<std::mutex> g(fl.mu);
+            while (kept < n && fl.buffers.size() < fl.max_count) {
+                fl.buffers.push_back(bufs[kept++]);
+            }
+        }
+        for (uint32_t i = kept; i < n; i++) destroy(bufs[i]);
+    }
+
+    // evbuffer 참조 해제 콜백 (해당 chain이 drain/free 될 때 호출)
+    static void evbuffer_cleanup_cb(const void* /*data*/, size_t /*len*/, void* arg) {
+        MessageBuffer* buf = static_cast<MessageBuffer*>(arg);
+        buf->pool->release(buf);
+    }
+
+public:
+    /* max_cached_bytes: class 별 free list 에 남겨둘 bytes 상한 (class 마다 최소 THREAD_BATCH 개) */
+    explicit MessageBufferPool(size_t max_cached_bytes = DEFAULT_MAX_CACHED_BYTES, bool thread_cache = false)
+        : _thread_cache(thread_cache) {
+        for (uint32_t cls = 0; cls < CLASS_COUNT; cls++) {
+            size_t n = max_cached_bytes / class_capacity(cls);
+            _free[cls].max_count = n < THREAD_BATCH ? THREAD_BATCH : n;
+        }
+    }
+
+    ~MessageBufferPool() {
+        for (uint32_t cls = 0; cls < CLASS_COUNT; cls++) {
+            std::lock_guard<std::mutex> g(_free[cls].mu);
+            for (auto* buf : _free[cls].buffers) destroy(buf);
+            _free[cls].buffers.clear();
+        }
+    }
+
+    MessageBufferPool(const MessageBufferPool&) = delete;
+    MessageBufferPool& operator=(const MessageBufferPool&) = delete;
+
+    MessageBuffer* acquire(size_t size) {
+        uint32_t cls = class_of(size);
+        if (cls == NO_CLASS) {
+            // 가장 큰 class 보다 큰 메시지는 풀에 보관하지 않고 별도 할당
+            MessageBuffer* buf = allocate(NO_CLASS, size);
+            if (buf) buf->size = size;
+            return buf;
+        }
+        MessageBuffer* buf = nullptr;
+        ThreadCache* tc = _thread_cache ? thread_cache() : nullptr;
+        if (tc) {
+            if (tc->count[cls] == 0) {
+                tc->count[cls] = pop_free(cls, tc->bins[cls], THREAD_BATCH);
+            }
+            if (tc->count[cls] > 0) buf = tc->bins[cls][--tc->count[cls]];
+        } else {
+            pop_free(cls, &buf, 1);
+        }
+        if (buf) {
+            buf->refcnt.store(1, std::memory_order_relaxed);
+        } else {
+            buf = allocate(cls, class_capacity(cls));
+            if (!buf) return nullptr;
+        }
+        buf->size = size;
+        return buf;
+    }
+
+    void add_ref(MessageBuffer* buf) {
+        buf->refcnt.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void release(MessageBuffer* buf) {
+        if (buf->refcnt.fetch_sub(1, std::memory_order_acq_rel) != 1) return;
+        uint32_t cls = buf->size_class;
+        if (cls == NO_CLASS) {
+            destroy(buf);
+            return;
+        }
+        ThreadCache* tc = _thread_cache ? thread_cache() : nullptr;
+        if (tc) {
+            if (tc->count[cls] == THREAD_CACHE_SIZE) {
+                tc->count[cls] -= THREAD_BATCH;
+                push_free(cls, tc->bins[cls] + tc->count[cls], THREAD_BATCH);
+            }
+            tc->bins[cls][tc->count[cls]++] = buf;
+            return;
+        }
+        push_free(cls, &buf, 1);
+    }
+
+    // 버퍼를 복사 없이 evbuffer에 추가. 성공 시 0, 실패 시 -1 (참조는 원복)
+    int add_to_evbuffer(evbuffer* out, MessageBuffer* buf) {
+        return add_to_evbuffer(out, buf, 0, buf->size);
+    }
+
+    // 버퍼의 일부 구간 [offset, offset+len) 만 참조로 추가 (batch 내 토픽 필터링용)
+    int add_to_evbuffer(evbuffer* out, MessageBuffer* buf, size_t offset, size_t len) {
+        add_ref(buf);
+        if (evbuffer_add_reference(out, buf->data() + offset, len, evbuffer_cleanup_cb, buf) != 0) {
+            release(buf);
+            return -1;
+        }
+        return 0;
+    }
+
+    // free list 에 있는 버퍼 수 (스레드 cache 제외)
+    size_t cached_count() {
+        size_t n = 0;
+        for (uint32_t cls = 0; cls < CLASS_COUNT; cls++) {
+            std::lock_guard<std::mutex> g(_free[cls].mu);
+            n += _free[cls].buffers.size();
+        }
+        return n;
+    }
+
+    uint64_t allocated_count() const { return _allocated.load(std::memory_order_relaxed); }
+};
+
+/*
+ * MessageBufferRef - MessageBuffer 참조 하나를 가진 handle (복사 = add_ref, 소멸 = release)
+ *
+ * pending queue / 복구 / DB 로 버퍼를 넘길 때 raw 포인터 대신 쓴다. 어느 풀의 버퍼든
+ * 자기 풀로 돌아간다 (buf->pool). 일부 구간만 가리킬 때는 offset / size 를 같이 들고 다닌다.
+ */
+class MessageBufferRef {
+private:
+    MessageBuffer* _buf;
+
+public:
+    MessageBufferRef() : _buf(nullptr) {}
+    // 이미 가진 참조 하나를 넘겨받는다 (acquire 직후 등)
+    explicit MessageBufferRef(MessageBuffer* adopt) : _buf(adopt) {}
+    MessageBufferRef(const MessageBufferRef& other) : _buf(other._buf) {
+        if (_buf) _buf->pool->add_ref(_buf);
+    }
+    MessageBufferRef(MessageBufferRef&& other) : _buf(other._buf) { other._buf = nullptr; }
+    ~MessageBufferRef() { reset(); }
+
+    MessageBufferRef& operator=(MessageBufferRef other) {
+        MessageBuffer* tmp = _buf;
+        _buf = other._buf;
+        other._buf = tmp;
+        return *this;
+    }
+
+    // shared() 풀에서 size bytes 버퍼
+    static MessageBufferRef acquire(size_t size, MessageBufferPool& pool = MessageBufferPool::shared()) {
+        return MessageBufferRef(pool.acquire(size));
+    }
+
+    // 새 참조 (add_ref)
+    static MessageBufferRef share(MessageBuffer* buf) {
+        if (buf) buf->pool->add_ref(buf);
+        return MessageBufferRef(buf);
+    }
+
+    void reset() {
+        if (_buf) {
+            _buf->pool->release(_buf);
+            _buf = nullptr;
+        }
+    }
+
+    // 참조를 넘겨준다 (호출자가 release)
+    MessageBuffer* detach() {
+        MessageBuffer* buf = _buf;
+        _buf = nullptr;
+        return buf;
+    }
+
+    MessageBuffer* get() const { return _buf; }
+    char* data() const { return _buf ? _buf->data() : nullptr; }
+    size_t size() const { return _buf ? _buf->size : 0; }
+    size_t capacity() const { return _buf ? _buf->capacity : 0; }
+    explicit operator bool() const { return _buf != nullptr; }
+};
+
+} // namespace SimplePubSub
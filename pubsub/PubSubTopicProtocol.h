@@ -2,6 +2,72 @@
 #define PUBSUB_TOPIC_PROTOCOL_H
 
 #include "../eventBase/Protocol.h"
+#include "Common.h"
+#include <cstddef>
+#include <cstring>
+
+/*
+ * pubsub 프레임 decoder (EventConnection 의 ProtocolT, PubSubTopicProtocol 도 이걸 쓴다)
+ * 메시지 길이는 magic 으로 바로 결정 (TopicMessage 는 헤더의 data_size, RecoveryBatch 는 stored_size 를 읽음)
+ */
+struct PubSubTopicFrame {
+    std::vector<std::pair<uint32_t, uint32_t>> extra_magics;  // magic -> 고정길이 (registerMagic)
+
+    size_t header_size() const { return sizeof(SimplePubSub::TopicMessage); }
+
+    FrameStatus decode(const char* p, size_t avail, FrameInfo& frame) const {
+        using namespace SimplePubSub;
+        if (avail < sizeof(uint32_t)) {
+            return FRAME_NEED_MORE;
+        }
+        uint32_t magic;
+        memcpy(&magic, p, sizeof(uint32_t));   // 바이트 오더 변환 없이 직접 사용
+        frame.header = 0;
+        switch (magic) {
+            case MAGIC_TOPIC_MSG:
+            case MAGIC_TOPIC_CONFLATED:
+            case MAGIC_TOPIC_WIRE: {
+                if (avail < sizeof(TopicMessage)) {
+                    return FRAME_NEED_MORE;
+                }
+                uint32_t data_size;
+                memcpy(&data_size, p + offsetof(TopicMessage, data_size), sizeof(uint32_t));
+                frame.length = sizeof(TopicMessage) + data_size;
+                return FRAME_OK;
+            }
+            case MAGIC_RECOVERY_BATCH: {
+                if (avail < sizeof(RecoveryBatch)) {
+                    return FRAME_NEED_MORE;
+                }
+                uint32_t stored_size;
+                memcpy(&stored_size, p + offsetof(RecoveryBatch, stored_size), sizeof(uint32_t));
+                frame.length = sizeof(RecoveryBatch) + stored_size;
+                return FRAME_OK;
+            }
+            case MAGIC_SUBSCRIBE:    frame.length = sizeof(SubscriptionRequest); return FRAME_OK;
+            case MAGIC_SUB_OK:       frame.length = sizeof(SubscriptionResponse); return FRAME_OK;
+            case MAGIC_RECOVERY_REQ: frame.length = sizeof(RecoveryRequest); return FRAME_OK;
+            case MAGIC_RECOVERY_RES: frame.length = sizeof(RecoveryResponse); return FRAME_OK;
+            case MAGIC_RECOVERY_CMP: frame.length = sizeof(RecoveryComplete); return FRAME_OK;
+            default:
+                break;
+        }
+        for (const auto& e : extra_magics) {
+            if (e.first == magic) {
+                frame.length = e.second;
+                return FRAME_OK;
+            }
+        }
+        // Unknown magic, skip
+        frame.length = sizeof(uint32_t);
+        return FRAME_SKIP;
+    }
+
+    // pubsub 메시지는 자체 헤더를 가지므로 그대로 추가
+    bool encode(struct evbuffer* output, const void* data, size_t length) const {
+        return evbuffer_add(output, data, length) == 0;
+    }
+};
 
 class PubSubTopicProtocol : public Protocol {
 public:
@@ -9,17 +75,23 @@ public:
     ~PubSubTopicProtocol();
 
     size_t parseBuffer(struct evbuffer* input, const MessageCallback& callback) override;
+    size_t parseBatch(struct evbuffer* input, const BatchCallback& callback) override;
     bool encodeToBuffer(struct evbuffer* output, const void* data, size_t length) override;
     void reset() override;
 
+    // 기본 메시지 외의 고정길이 magic 추가
     void registerMagic(uint32_t magic, uint32_t fixed_length);
 
-private:
-    std::map<uint32_t, uint32_t> _magic_to_fixed_length;  // magic -> 고정길이
+    const PubSubTopicFrame& frame() const { return _frame; }
 
-    uint32_t _current_magic;
-    uint32_t _expected_length;
-    bool _reading_header;
+protected:
+    size_t frameHeaderSize() const override { return _frame.header_size(); }
+    FrameStatus decodeFrame(const char* p, size_t avail, FrameInfo& frame) const override {
+        return _frame.decode(p, avail, frame);
+    }
+
+private:
+    PubSubTopicFrame _frame;
 };
 
-#endif // PUBSUB_TOPIC_PROTOCOL_H
\ No newline at end of file
+#endif // PUBSUB_TOPIC_PROTOCOL_H
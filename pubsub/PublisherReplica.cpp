@@ -0,0 +1,199 @@
+#include "PublisherReplica.h"
+#include <iostream>
+#include <cstring>
+
+PublisherReplica::PublisherReplica(struct event_base* base, SimplePublisherV2* publisher)
+    : _base(base), _publisher(publisher), _socket_type(TCP_SOCKET), _port(0), _timer(nullptr),
+      _unacked(0), _acked_seq(0), _offline_since(0), _failover_fired(false), _promoted(false),
+      _replicated(0), _skipped(0), _acks_sent(0), _resyncs(0) {
+    _subscriber.reset(new SimpleSubscriber(base));
+}
+
+PublisherReplica::~PublisherReplica() {
+    if (_timer) {
+        event_free(_timer);
+    }
+    if (_subscriber) {
+        _subscriber->stop();
+    }
+    // record 를 가리키는 구독자를 record 보다 먼저 정리
+    _subscriber.reset();
+}
+
+void PublisherReplica::set_primary_address(SocketType socket_type, const std::string& address, int port) {
+    _socket_type = socket_type;
+    _address = address;
+    _port = port;
+}
+
+void PublisherReplica::set_client_info(uint32_t id, const std::string& name) {
+    _subscriber->set_client_info(id, name, _publisher->get_publisher_id(), _publisher->get_publisher_name());
+    _subscriber->set_publisher_name(_publisher->get_publisher_name());
+}
+
+void PublisherReplica::set_socket_profile(const SocketProfile& profile) {
+    _subscriber->set_socket_profile(profile);
+}
+
+bool PublisherReplica::start() {
+    const PublisherSequenceRecord* current = _publisher->get_sequence_record();
+    if (!current || !_publisher->db()) {
+        std::cerr << "PublisherReplica: publisher sequence storage / database not initialized" << std::endl;
+        return false;
+    }
+    if (_address.empty()) {
+        std::cerr << "PublisherReplica: primary address not set" << std::endl;
+        return false;
+    }
+    _publisher->set_standby(true);
+
+    // 구독 시작점 = standby 가 이미 기록한 seq (publisher 레코드는 republish_batch 가 갱신)
+    _record = *current;
+    if (!_subscriber->attach_sequence_record(&_record)) {
+        return false;
+    }
+    _subscriber->set_sequence_persist_policy(0, 0);
+    _subscriber->set_subscription_mask(static_cast<uint32_t>(DataTopic::ALL_TOPICS));
+    _subscriber->set_ordered_delivery(true);
+    _subscriber->set_address(_socket_type, _address, _port);
+    _subscriber->set_topic_batch_callback([this](const TopicMessageView* messages, size_t count) {
+        on_batch(messages, count);
+    });
+
+    uint32_t interval_ms = _policy.ack_interval_ms > 0 ? _policy.ack_interval_ms : 100;
+    _timer = event_new(_base, -1, EV_PERSIST, timer_cb, this);
+    struct timeval tv = {static_cast<time_t>(interval_ms / 1000), static_cast<suseconds_t>((interval_ms % 1000) * 1000)};
+    event_add(_timer, &tv);
+
+    _acked_seq = _record.all_topics_sequence;
+    _offline_since = get_current_timestamp();
+    std::cout << "PublisherReplica: standby for " << _publisher->get_publisher_name() << " from seq "
+              << _record.all_topics_sequence << " (primary " << _address;
+    if (_socket_type == TCP_SOCKET) std::cout << ":" << _port;
+    std::cout << ", ack every " << _policy.ack_every << " / " << interval_ms << "ms, failover "
+              << (_policy.failover_timeout_ms ? std::to_string(_policy.failover_timeout_ms) + "ms" : std::string("manual"))
+              << ")" << std::endl;
+
+    if (!_subscriber->connect()) {
+        _subscriber->try_reconnect();
+    }
+    return true;
+}
+
+void PublisherReplica::promote() {
+    if (_promoted) {
+        return;
+    }
+    if (_timer) {
+        event_del(_timer);
+    }
+    _subscriber->stop();
+    _publisher->set_standby(false);
+    _promoted = true;
+    std::cout << "PublisherReplica: promoted " << _publisher->get_publisher_name() << " at seq "
+              << _publisher->get_current_sequence() << " (" << _replicated << " messages replicated)" << std::endl;
+}
+
+void PublisherReplica::on_batch(const TopicMessageView* messages, size_t count) {
+    if (_promoted) {
+        return;
+    }
+    uint32_t next_seq = _publisher->get_current_sequence() + 1;
+    size_t first = 0;
+    while (first < count && messages[first].global_seq < next_seq) {
+        ++first;
+    }
+    _skipped += first;
+
+    // 순서 전달이므로 나머지는 next_seq 부터 연속 (끊기면 그 앞까지만 기록하고 다시 복구)
+    size_t total = 0;
+    size_t last = first;
+    for (; last < count; ++last) {
+        if (messages[last].global_seq != next_seq + static_cast<uint32_t>(last - first)) break;
+        total += sizeof(TopicMessage) + messages[last].size;
+    }
+    if (last > first) {
+        _staging.resize(total);
+        _slices.clear();
+        size_t offset = 0;
+        for (size_t i = first; i < last; ++i) {
+            const TopicMessageView& view = messages[i];
+            TopicMessage* msg = reinterpret_cast<TopicMessage*>(_staging.data() + offset);
+            msg->magic = MAGIC_TOPIC_MSG;
+            msg->topic = view.topic;
+            msg->global_seq = view.global_seq;
+            msg->topic_seq = view.topic_seq;
+            msg->timestamp = view.timestamp;
+            msg->data_size = view.size;
+            memcpy(msg->data, view.data, view.size);
+            size_t size = sizeof(TopicMessage) + view.size;
+            _slices.push_back(MessageSlice{msg, size});
+            offset += size;
+        }
+        _publisher->republish_batch(_slices.data(), _slices.size());
+        _replicated += _slices.size();
+        _unacked += static_cast<uint32_t>(_slices.size());
+    }
+
+    uint32_t recorded = _publisher->get_current_sequence();
+    if (last < count || recorded != _record.all_topics_sequence) {
+        // 기록 실패 (buffer 할당 등) 또는 순서가 어긋남: 구독자 seq 를 기록한 위치로 되돌리고 거기부터 다시 받음
+        std::cerr << "PublisherReplica: standby seq " << recorded << " != received seq " << _record.all_topics_sequence
+                  << ", resyncing" << std::endl;
+        _record.all_topics_sequence = recorded;
+        _resyncs++;
+        if (_subscriber->get_status() == CLIENT_ONLINE) {
+            _subscriber->change_status(CLIENT_RECOVERY_NEEDED);
+            _subscriber->send_recovery_request();
+        }
+    }
+    if (_policy.ack_every > 0 && _unacked >= _policy.ack_every) {
+        send_ack();
+    }
+}
+
+void PublisherReplica::send_ack() {
+    uint32_t seq = _publisher->get_current_sequence();
+    if (_subscriber->send_replica_ack(seq)) {
+        _acked_seq = seq;
+        _unacked = 0;
+        _acks_sent++;
+    }
+}
+
+void PublisherReplica::check_primary() {
+    if (_promoted) {
+        return;
+    }
+    uint64_t now = get_current_timestamp();
+    if (_subscriber->get_status() != CLIENT_OFFLINE) {
+        // 재연결하면 primary 는 새 연결이라 replica 인지 모르므로 한번 바로 알림
+        bool reconnected = _offline_since != 0;
+        _offline_since = 0;
+        if (reconnected || _unacked > 0 || _acked_seq != _publisher->get_current_sequence()) {
+            send_ack();
+        }
+        return;
+    }
+    if (_offline_since == 0) {
+        _offline_since = now;
+        std::cerr << "PublisherReplica: primary connection lost at seq " << _publisher->get_current_sequence() << std::endl;
+    }
+    if (_policy.failover_timeout_ms == 0 || _failover_fired) {
+        return;
+    }
+    if (now - _offline_since >= static_cast<uint64_t>(_policy.failover_timeout_ms) * 1000000) {
+        _failover_fired = true;
+        std::cerr << "PublisherReplica: primary unavailable for " << (now - _offline_since) / 1000000
+                  << "ms, failing over at seq " << _publisher->get_current_sequence() << std::endl;
+        if (_failover_callback) {
+            _failover_callback();
+        } else {
+            promote();
+        }
+    }
+}
+
+void PublisherReplica::timer_cb(evutil_socket_t /*fd*/, short /*events*/, void* arg) {
+    static_cast<PublisherReplica*>(arg)->check_primary();
+}
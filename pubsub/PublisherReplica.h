@@ -0,0 +1,101 @@
+#ifndef PUBLISHER_REPLICA_H
+#define PUBLISHER_REPLICA_H
+
+#include "SimplePublisherV2.h"
+#include "SimpleSubscriber.h"
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+* PublisherReplica - hot standby publisher (primary 스트림을 같은 seq 로 기록)
+*
+* standby 프로세스의 SimplePublisherV2 를 set_standby(true) 로 두고, primary 에 구독자 하나로 붙어
+*   - 수신: 전체 토픽, 순서 전달 (set_ordered_delivery). 구독 시작 seq 는 standby publisher 의 현재 seq 라서
+*     재시작한 standby 는 빠진 구간만 복구로 받는다.
+*   - 기록: batch view 를 TopicMessage 로 다시 만들어 republish_batch (global/topic seq, timestamp 그대로).
+*     DB / 시퀀스 레코드 / hot tail 이 primary 와 같아지고, 이미 있는 seq 는 건너뛴다.
+*   - ack: ack_every 개 기록마다 또는 ack_interval_ms 마다 지금까지 기록한 seq 를 ReplicaAck 로 보낸다.
+*     응답을 기다리지 않으므로 (pipelined) 복제 속도는 ack 와 무관하고, primary 는 get_replica_status 로 lag 만 본다.
+*   - failover: primary 연결이 failover_timeout_ms 이상 끊겨 있으면 failover callback 을 한번 부른다.
+*     callback (또는 운영자) 이 promote() 후 listener 를 시작하면 primary 의 마지막 seq 다음부터 발행한다.
+*
+* 같은 event_base 스레드에서만 사용 (publisher 와 같은 스레드).
+* primary 가 살아있는데 연결만 끊긴 경우 (network partition) 두 publisher 가 같은 seq 를 따로 매길 수 있으므로
+* 자동 failover (failover_timeout_ms > 0) 는 primary 를 확실히 내리는 장치 (fencing) 가 있을 때만 쓴다.
+*/
+struct ReplicaPolicy {
+    uint32_t ack_every = 4096;              // 이만큼 기록하면 바로 ack (0: timer 만)
+    uint32_t ack_interval_ms = 100;         // 기록한 것이 있으면 이 주기로 ack (failover 확인 주기이기도 함)
+    uint32_t failover_timeout_ms = 0;       // primary 연결이 이 시간 이상 없으면 failover callback (0: 자동 failover 안함)
+};
+
+class PublisherReplica {
+public:
+    typedef std::function<void()> FailoverCallback;
+
+    PublisherReplica(struct event_base* base, SimplePublisherV2* publisher);
+    ~PublisherReplica();
+
+    PublisherReplica(const PublisherReplica&) = delete;
+    PublisherReplica& operator=(const PublisherReplica&) = delete;
+
+    /* primary publisher 주소 (start 전에) */
+    void set_primary_address(SocketType socket_type, const std::string& address, int port = 0);
+    /* 구독자 식별 (primary 의 client id 는 id * 10000 + publisher id) */
+    void set_client_info(uint32_t id, const std::string& name);
+    void set_policy(const ReplicaPolicy& policy) {_policy = policy;}
+    void set_failover_callback(FailoverCallback callback) {_failover_callback = callback;}
+    void set_socket_profile(const SocketProfile& profile);
+
+    /* publisher 를 standby 로 두고 primary 구독 시작 (init_database 이후) */
+    bool start();
+    /* 복제 중지 후 publisher standby 해제 (listener 시작은 호출자), 이미 승격했으면 아무것도 안함 */
+    void promote();
+    bool is_promoted() const {return _promoted;}
+    bool is_primary_online() const {return _subscriber && _subscriber->get_status() == CLIENT_ONLINE;}
+    SimpleSubscriber* subscriber() {return _subscriber.get();}
+
+    inline uint64_t get_replicated_messages() const {return _replicated;}
+    inline uint64_t get_skipped_messages() const {return _skipped;}
+    inline uint64_t get_acks_sent() const {return _acks_sent;}
+    inline uint64_t get_resyncs() const {return _resyncs;}
+    inline uint32_t get_acked_seq() const {return _acked_seq;}
+
+private:
+    struct event_base* _base;
+    SimplePublisherV2* _publisher;
+    ReplicaPolicy _policy;
+    FailoverCallback _failover_callback;
+
+    // 구독자보다 먼저 선언 (구독자가 record 를 쓰는 동안 유지)
+    PublisherSequenceRecord _record;
+    std::unique_ptr<SimpleSubscriber> _subscriber;
+    SocketType _socket_type;
+    std::string _address;
+    int _port;
+
+    // republish 할 TopicMessage (batch 마다 재사용)
+    std::vector<char> _staging;
+    std::vector<MessageSlice> _slices;
+
+    struct event* _timer;
+    uint32_t _unacked;
+    uint32_t _acked_seq;
+    uint64_t _offline_since;            // primary 연결이 끊긴 시각 (0: 연결됨)
+    bool _failover_fired;
+    bool _promoted;
+
+    uint64_t _replicated;
+    uint64_t _skipped;                  // 이미 기록한 seq (재연결 직후 중복)
+    uint64_t _acks_sent;
+    uint64_t _resyncs;                  // 구독자 seq 와 publisher seq 가 어긋나 다시 복구한 횟수
+
+    void on_batch(const TopicMessageView* messages, size_t count);
+    void send_ack();
+    void check_primary();
+    static void timer_cb(evutil_socket_t fd, short events, void* arg);
+};
+
+#endif // PUBLISHER_REPLICA_H
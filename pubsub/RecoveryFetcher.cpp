@@ -0,0 +1,298 @@
+#include "RecoveryFetcher.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+// 이 시간 동안 어느 연결에서도 받은 것이 없으면 실패 (publisher 워커가 밀려 있어도 chunk 하나는 이 안에 시작됨)
+static const uint64_t FETCH_STALL_MS = 5000;
+static const uint32_t FETCH_CHECK_INTERVAL_MS = 1000;
+
+RecoveryFetcher::RecoveryFetcher(struct event_base* base)
+    : _base(base), _socket_type(TCP_SOCKET), _port(0), _client_id(0), _compression(BLOCK_CODEC_NONE),
+      _stream_count(4), _chunk_messages(65536), _active(false), _to_seq(0), _next_from(0), _head_index(0),
+      _next_index(0), _buffered(0), _last_progress(0), _fetches(0), _failures(0), _chunks_done(0), _bytes(0),
+      _buffered_peak(0) {
+    _timer = event_new(_base, -1, EV_PERSIST, timer_cb, this);
+    _close_event = evtimer_new(_base, close_cb, this);
+}
+
+RecoveryFetcher::~RecoveryFetcher() {
+    if (_timer) {
+        event_free(_timer);
+    }
+    if (_close_event) {
+        event_free(_close_event);
+    }
+    _streams.clear();
+    _retired.clear();
+}
+
+void RecoveryFetcher::set_address(SocketType socket_type, const std::string& address, int port) {
+    _socket_type = socket_type;
+    _address = address;
+    _port = port;
+}
+
+void RecoveryFetcher::set_streams(size_t streams, uint32_t chunk_messages) {
+    _stream_count = std::max<size_t>(streams, 1);
+    _chunk_messages = std::max<uint32_t>(chunk_messages, 1);
+}
+
+bool RecoveryFetcher::start(uint32_t from_seq, uint32_t to_seq, DeliverFn deliver, DoneFn done) {
+    if (_active) {
+        std::cerr << "RecoveryFetcher: fetch already in progress" << std::endl;
+        return false;
+    }
+    if (from_seq > to_seq || _address.empty()) {
+        return false;
+    }
+    _to_seq = to_seq;
+    _next_from = from_seq;
+    _head_index = 0;
+    _next_index = 0;
+    _chunks.clear();
+    _buffered = 0;
+    _deliver = deliver;
+    _done = done;
+
+    // 구간보다 연결이 많을 필요는 없음
+    uint64_t chunks = (static_cast<uint64_t>(to_seq) - from_seq) / _chunk_messages + 1;
+    size_t streams = static_cast<size_t>(std::min<uint64_t>(_stream_count, chunks));
+    bool tcp = _socket_type == TCP_SOCKET;
+    for (size_t i = 0; i < streams; ++i) {
+        std::unique_ptr<Stream> stream(new Stream());
+        stream->events.owner = this;
+        stream->events.stream = stream.get();
+        stream->conn.reset(new StreamConnection(_base, stream->events));
+        if (!_socket_profile.empty()) {
+            SocketProfile profile = _socket_profile;
+            stream->conn->set_socket_setup([profile, tcp](evutil_socket_t fd) {
+                apply_socket_profile(fd, profile, tcp);
+            });
+        }
+        try {
+            if (tcp) {
+                stream->conn->connectTcp(_address + ":" + std::to_string(_port));
+            } else {
+                stream->conn->connectUnix(_address);
+            }
+        } catch (const std::exception& e) {
+            std::cerr << "RecoveryFetcher: failed to connect stream " << i << ": " << e.what() << std::endl;
+            _streams.push_back(std::move(stream));
+            retire_streams();
+            return false;
+        }
+        _streams.push_back(std::move(stream));
+    }
+
+    _active = true;
+    _fetches++;
+    _last_progress = get_current_timestamp();
+    struct timeval tv = {static_cast<time_t>(FETCH_CHECK_INTERVAL_MS / 1000),
+                         static_cast<suseconds_t>((FETCH_CHECK_INTERVAL_MS % 1000) * 1000)};
+    event_add(_timer, &tv);
+    std::cout << "RecoveryFetcher: fetching seq " << from_seq << "-" << to_seq << " over " << streams
+              << " streams (" << chunks << " chunks of " << _chunk_messages << ")" << std::endl;
+    return true;
+}
+
+void RecoveryFetcher::cancel() {
+    if (!_active) {
+        return;
+    }
+    _active = false;
+    event_del(_timer);
+    _chunks.clear();
+    _buffered = 0;
+    retire_streams();
+}
+
+void RecoveryFetcher::on_stream_connected(Stream* stream) {
+    if (stream->retired || !_active) {
+        return;
+    }
+    stream->connected = true;
+    bufferevent* bev = stream->conn->getBev();
+    if (bev && !_socket_profile.empty()) {
+        apply_bufferevent_profile(bev, _socket_profile);
+    }
+    request_next(stream);
+}
+
+void RecoveryFetcher::on_stream_closed(Stream* stream, const char* reason) {
+    stream->connected = false;
+    if (stream->retired || !_active) {
+        return;
+    }
+    std::cerr << "RecoveryFetcher: stream " << reason << " at seq " << head_seq() << std::endl;
+    finish(false);
+}
+
+void RecoveryFetcher::request_next(Stream* stream) {
+    if (!_active || !stream->connected || stream->busy || _next_from > _to_seq) {
+        return;
+    }
+    if (_next_index - _head_index >= _stream_count * 2) {
+        // 앞 chunk 가 끝나면 advance 가 다시 부름
+        return;
+    }
+    Chunk chunk;
+    chunk.from_seq = static_cast<uint32_t>(_next_from);
+    chunk.to_seq = static_cast<uint32_t>(std::min<uint64_t>(_next_from + _chunk_messages - 1, _to_seq));
+    chunk.complete = false;
+
+    RangeFetchRequest request;
+    request.magic = MAGIC_RANGE_FETCH_REQ;
+    request.client_id = _client_id;
+    request.from_seq = chunk.from_seq;
+    request.to_seq = chunk.to_seq;
+    request.compression = _compression;
+    request.reserved = 0;
+    if (!stream->conn->trySend(&request, sizeof(request))) {
+        return;
+    }
+    stream->busy = true;
+    stream->chunk = _next_index++;
+    _next_from = static_cast<uint64_t>(chunk.to_seq) + 1;
+    _chunks.push_back(std::move(chunk));
+}
+
+void RecoveryFetcher::on_stream_frames(Stream* stream, const ProtocolMessage* messages, size_t count) {
+    if (stream->retired || !_active) {
+        return;
+    }
+    _last_progress = get_current_timestamp();
+    size_t i = 0;
+    while (i < count) {
+        if (!stream->busy) {
+            std::cerr << "RecoveryFetcher: unexpected frame on idle stream" << std::endl;
+            finish(false);
+            return;
+        }
+        // RecoveryComplete 앞까지가 이 chunk 의 frame
+        size_t j = i;
+        uint32_t magic = 0;
+        for (; j < count; ++j) {
+            memcpy(&magic, messages[j].data, sizeof(uint32_t));
+            if (magic == MAGIC_RECOVERY_CMP) break;
+        }
+        Chunk& chunk = _chunks[stream->chunk - _head_index];
+        if (j > i) {
+            size_t bytes = 0;
+            for (size_t k = i; k < j; ++k) bytes += messages[k].length;
+            _bytes += bytes;
+            if (stream->chunk == _head_index && chunk.lengths.empty()) {
+                _deliver(messages + i, j - i);
+                if (stream->retired || !_active) return;   // 콜백에서 cancel
+            } else {
+                for (size_t k = i; k < j; ++k) {
+                    chunk.data.insert(chunk.data.end(), messages[k].data, messages[k].data + messages[k].length);
+                    chunk.lengths.push_back(static_cast<uint32_t>(messages[k].length));
+                }
+                _buffered += bytes;
+                _buffered_peak = std::max(_buffered_peak, _buffered);
+            }
+        }
+        if (j == count) {
+            break;
+        }
+        // RecoveryComplete: 이 연결은 다음 chunk 로
+        chunk.complete = true;
+        stream->busy = false;
+        i = j + 1;
+        advance();
+        if (stream->retired || !_active) return;
+        request_next(stream);
+    }
+}
+
+void RecoveryFetcher::advance() {
+    while (_active && !_chunks.empty()) {
+        Chunk& front = _chunks.front();
+        if (!front.lengths.empty()) {
+            deliver_buffered(front);
+            if (!_active) return;
+        }
+        if (!front.complete) {
+            break;
+        }
+        _chunks.pop_front();
+        _head_index++;
+        _chunks_done++;
+    }
+    if (!_active) {
+        return;
+    }
+    if (_chunks.empty() && _next_from > _to_seq) {
+        finish(true);
+        return;
+    }
+    // window 때문에 쉬고 있던 연결
+    for (auto& stream : _streams) {
+        request_next(stream.get());
+    }
+}
+
+void RecoveryFetcher::deliver_buffered(Chunk& chunk) {
+    _scratch.clear();
+    const char* p = chunk.data.data();
+    for (uint32_t length : chunk.lengths) {
+        _scratch.push_back(ProtocolMessage{p, length});
+        p += length;
+    }
+    _deliver(_scratch.data(), _scratch.size());
+    // 이후 이 chunk 의 frame 은 바로 전달 (앞 chunk 가 됐으므로)
+    _buffered -= std::min(_buffered, chunk.data.size());
+    std::vector<char>().swap(chunk.data);
+    std::vector<uint32_t>().swap(chunk.lengths);
+}
+
+void RecoveryFetcher::finish(bool ok) {
+    if (!_active) {
+        return;
+    }
+    _active = false;
+    event_del(_timer);
+    if (!ok) {
+        _failures++;
+    }
+    _chunks.clear();
+    _buffered = 0;
+    retire_streams();
+    if (_done) {
+        DoneFn done = _done;
+        done(ok);
+    }
+}
+
+void RecoveryFetcher::retire_streams() {
+    for (auto& stream : _streams) {
+        stream->retired = true;
+        bufferevent* bev = stream->conn ? stream->conn->getBev() : nullptr;
+        if (bev) {
+            bufferevent_disable(bev, EV_READ | EV_WRITE);
+        }
+        _retired.push_back(std::move(stream));
+    }
+    _streams.clear();
+    // read callback 안일 수 있으므로 bufferevent 해제는 다음 loop 에서
+    struct timeval tv = {0, 0};
+    evtimer_add(_close_event, &tv);
+}
+
+void RecoveryFetcher::timer_cb(evutil_socket_t /*fd*/, short /*events*/, void* arg) {
+    RecoveryFetcher* self = static_cast<RecoveryFetcher*>(arg);
+    if (!self->_active) {
+        return;
+    }
+    uint64_t idle_ms = (get_current_timestamp() - self->_last_progress) / 1000000;
+    if (idle_ms >= FETCH_STALL_MS) {
+        std::cerr << "RecoveryFetcher: no data for " << idle_ms << "ms at seq " << self->head_seq()
+                  << ", giving up" << std::endl;
+        self->finish(false);
+    }
+}
+
+void RecoveryFetcher::close_cb(evutil_socket_t /*fd*/, short /*events*/, void* arg) {
+    static_cast<RecoveryFetcher*>(arg)->_retired.clear();
+}
@@ -0,0 +1,138 @@
+#ifndef RECOVERY_FETCHER_H
+#define RECOVERY_FETCHER_H
+
+#include "Common.h"
+#include "PubSubTopicProtocol.h"
+#include "SocketProfile.h"
+#include "../common/BlockCompression.h"
+#include "../eventBase/EventConnection.h"
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace SimplePubSub;
+
+/*
+* RecoveryFetcher - 큰 복구 구간을 여러 연결로 나눠 동시에 받는 구독자 쪽 병렬 복구 (SimpleSubscriber::set_parallel_recovery)
+*
+* [from_seq, to_seq] 를 chunk_messages 개씩 나누고, streams 개의 별도 연결 (구독하지 않은 연결) 이 각자 한 chunk 씩
+* RangeFetchRequest 로 요청한다. publisher 는 연결마다 다른 복구 워커에서 DB 를 읽으므로 구간이 동시에 읽힌다.
+*   - chunk 가 끝나면 (RecoveryComplete) 그 연결이 다음 chunk 를 요청 (연결당 요청 하나씩 pipelining)
+*   - 가장 앞 chunk 는 받는 대로 바로 전달하고, 뒤 chunk 는 frame 그대로 모아 두었다가 앞 chunk 가 끝나면 순서대로 전달
+*   - 가장 앞 chunk 보다 streams * 2 개 이상 앞선 chunk 는 요청하지 않는다 (모아 두는 메모리 상한)
+*   - 연결이 끊기거나 FETCH_STALL_MS 동안 아무것도 받지 못하면 실패 (이미 전달한 앞부분은 유효, 호출자가 이어서 복구)
+* chunk 순서대로 전달하지만 publisher DB 에 아직 없는 seq 는 빠질 수 있으므로 연속 여부는 호출자가 seq 로 확인한다.
+* 같은 event_base 스레드에서만 사용, 콜백 안에서 delete 하면 안 된다 (끝난 연결은 다음 loop 에서 닫음).
+*/
+class RecoveryFetcher {
+public:
+    /* seq 순서의 frame (TopicMessage / RecoveryBatch), 포인터는 콜백 안에서만 유효 */
+    typedef std::function<void(const ProtocolMessage* messages, size_t count)> DeliverFn;
+    /* 모든 chunk 를 전달했으면 true, 중간에 실패했으면 false */
+    typedef std::function<void(bool ok)> DoneFn;
+
+    explicit RecoveryFetcher(struct event_base* base);
+    ~RecoveryFetcher();
+
+    RecoveryFetcher(const RecoveryFetcher&) = delete;
+    RecoveryFetcher& operator=(const RecoveryFetcher&) = delete;
+
+    void set_address(SocketType socket_type, const std::string& address, int port = 0);
+    void set_socket_profile(const SocketProfile& profile) {_socket_profile = profile;}
+    void set_client_id(uint32_t id) {_client_id = id;}
+    /* RangeFetchRequest 의 BLOCK_CODEC_* (publisher 가 지원하지 않으면 압축 없이 옴) */
+    void set_compression(uint32_t codec) {_compression = codec;}
+    /* streams: 동시 연결 수, chunk_messages: 요청 하나의 구간 크기 */
+    void set_streams(size_t streams, uint32_t chunk_messages);
+
+    /* 연결을 열고 구간 요청 시작, 연결을 만들지 못하면 false (done 은 부르지 않음) */
+    bool start(uint32_t from_seq, uint32_t to_seq, DeliverFn deliver, DoneFn done);
+    /* 진행 중이면 중단 (done 은 부르지 않음) */
+    void cancel();
+    bool active() const {return _active;}
+
+    inline uint64_t get_fetches() const {return _fetches;}
+    inline uint64_t get_failures() const {return _failures;}
+    inline uint64_t get_chunks() const {return _chunks_done;}
+    inline uint64_t get_bytes() const {return _bytes;}
+    inline size_t get_buffered_peak() const {return _buffered_peak;}
+
+private:
+    struct Stream;
+    struct StreamEvents {
+        RecoveryFetcher* owner;
+        Stream* stream;
+        void on_frames(const ProtocolMessage* messages, size_t count) { owner->on_stream_frames(stream, messages, count); }
+        void on_connected() { owner->on_stream_connected(stream); }
+        void on_disconnected() { owner->on_stream_closed(stream, "disconnected"); }
+        void on_error() { owner->on_stream_closed(stream, "connection error"); }
+    };
+    typedef EventConnection<PubSubTopicFrame, StreamEvents> StreamConnection;
+    struct Stream {
+        StreamEvents events;
+        std::unique_ptr<StreamConnection> conn;
+        bool connected = false;
+        bool retired = false;               // 끝난 fetch 의 연결 (다음 loop 에서 닫힘, 콜백 무시)
+        bool busy = false;                  // chunk 를 받는 중
+        uint64_t chunk = 0;                 // 받는 중인 chunk 번호
+    };
+    // 요청한 구간 (앞 chunk 가 아니면 받은 frame 을 data 에 이어 붙여 둠)
+    struct Chunk {
+        uint32_t from_seq;
+        uint32_t to_seq;
+        bool complete;
+        std::vector<char> data;
+        std::vector<uint32_t> lengths;
+    };
+
+    struct event_base* _base;
+    SocketType _socket_type;
+    std::string _address;
+    int _port;
+    SocketProfile _socket_profile;
+    uint32_t _client_id;
+    uint32_t _compression;
+    size_t _stream_count;
+    uint32_t _chunk_messages;
+
+    bool _active;
+    uint32_t _to_seq;
+    uint64_t _next_from;                    // 다음에 요청할 chunk 시작 seq
+    uint64_t _head_index;                   // _chunks.front() 의 chunk 번호
+    uint64_t _next_index;
+    std::deque<Chunk> _chunks;              // 요청했지만 아직 전달을 끝내지 않은 chunk (번호 순)
+    std::vector<std::unique_ptr<Stream>> _streams;
+    std::vector<std::unique_ptr<Stream>> _retired;
+    std::vector<ProtocolMessage> _scratch;  // 모아 둔 chunk 전달용
+    size_t _buffered;                       // 모아 둔 bytes
+    uint64_t _last_progress;
+    DeliverFn _deliver;
+    DoneFn _done;
+    struct event* _timer;                   // stall 확인
+    struct event* _close_event;             // 끝난 연결 정리 (콜백 밖에서)
+
+    uint64_t _fetches;
+    uint64_t _failures;
+    uint64_t _chunks_done;
+    uint64_t _bytes;
+    size_t _buffered_peak;
+
+    void on_stream_frames(Stream* stream, const ProtocolMessage* messages, size_t count);
+    void on_stream_connected(Stream* stream);
+    void on_stream_closed(Stream* stream, const char* reason);
+    /* 다음 chunk 를 이 연결로 요청 (남은 구간이 없거나 window 가 차면 쉼) */
+    void request_next(Stream* stream);
+    /* 끝난 앞 chunk 들을 순서대로 전달, 모두 끝났으면 done */
+    void advance();
+    void deliver_buffered(Chunk& chunk);
+    void finish(bool ok);
+    /* 아직 전달하지 않은 첫 seq (로그용) */
+    uint32_t head_seq() const {return _chunks.empty() ? static_cast<uint32_t>(_next_from) : _chunks.front().from_seq;}
+    void retire_streams();
+    static void timer_cb(evutil_socket_t fd, short events, void* arg);
+    static void close_cb(evutil_socket_t fd, short events, void* arg);
+};
+
+#endif // RECOVERY_FETCHER_H
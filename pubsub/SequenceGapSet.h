@@ -0,0 +1,90 @@
+#ifndef SEQUENCE_GAP_SET_H
+#define SEQUENCE_GAP_SET_H
+
+#include <cstdint>
+#include <cstddef>
+#include <map>
+
+/**
+ * SequenceGapSet - 구독자가 아직 받지 못한 topic seq 구간 집합
+ *
+ * 토픽별로 겹치지 않는 [lo, hi] 구간을 시작 seq 순으로 보관한다 (interval set).
+ * 누락이 감지되면 구간을 추가하고 뒤의 메시지는 그대로 전달하며, 구간 복구로 들어온 메시지가
+ * 구간 안에 있으면 fill() 로 채운다 (구간 중간이면 둘로 나뉨).
+ *
+ * 각 구간은 복구 요청에 쓸 global seq 범위 (global_from, global_to] 와 마지막 요청 시각을 가진다.
+ * event loop 스레드에서만 사용.
+ */
+class SequenceGapSet {
+public:
+    struct Gap {
+        uint32_t hi;                // 누락 topic seq 끝 (포함)
+        uint32_t global_from;       // 이 구간 이전에 받은 마지막 global seq (이 seq 는 받음)
+        uint32_t global_to;         // 이 구간 이후 처음 받은 global seq (이 seq 는 받음)
+        uint64_t requested_ns;      // 마지막으로 구간 복구를 요청한 시각
+    };
+    typedef std::map<uint64_t, Gap> GapMap;     // key: (topic << 32) | lo
+
+    explicit SequenceGapSet(size_t max_gaps = 1024) : _max_gaps(max_gaps) {}
+
+    /* 구간 추가, 최대 개수를 넘으면 false (호출자는 전체 복구로 전환) */
+    bool add(uint32_t topic, uint32_t lo, uint32_t hi, uint32_t global_from, uint32_t global_to, uint64_t now_ns) {
+        if (lo > hi) return true;
+        if (_gaps.size() >= _max_gaps) return false;
+        Gap gap = {hi, global_from, global_to, now_ns};
+        _gaps[key(topic, lo)] = gap;
+        _missing += static_cast<uint64_t>(hi) - lo + 1;
+        return true;
+    }
+
+    /* seq 가 누락 구간 안이면 구간에서 빼고 true */
+    bool fill(uint32_t topic, uint32_t seq) {
+        if (_gaps.empty()) return false;
+        GapMap::iterator it = _gaps.upper_bound(key(topic, seq));
+        if (it == _gaps.begin()) return false;
+        --it;
+        if (topic_of(it->first) != topic || seq > it->second.hi) return false;
+
+        uint32_t lo = lo_of(it->first);
+        Gap gap = it->second;
+        _gaps.erase(it);
+        if (seq > lo) {
+            Gap left = gap;
+            left.hi = seq - 1;
+            _gaps[key(topic, lo)] = left;
+        }
+        if (seq < gap.hi) {
+            _gaps[key(topic, seq + 1)] = gap;
+        }
+        _missing--;
+        return true;
+    }
+
+    bool empty() const { return _gaps.empty(); }
+    size_t size() const { return _gaps.size(); }
+    uint64_t missing() const { return _missing; }
+    void clear() { _gaps.clear(); _missing = 0; }
+
+    /* 아직 비어있는 구간을 모두 받을 수 있는 가장 작은 global seq (이 seq 다음부터 다시 받으면 됨) */
+    uint32_t min_global_from() const {
+        uint32_t min_seq = UINT32_MAX;
+        for (GapMap::const_iterator it = _gaps.begin(); it != _gaps.end(); ++it) {
+            if (it->second.global_from < min_seq) min_seq = it->second.global_from;
+        }
+        return min_seq;
+    }
+
+    GapMap& gaps() { return _gaps; }
+
+    static uint32_t topic_of(uint64_t k) { return static_cast<uint32_t>(k >> 32); }
+    static uint32_t lo_of(uint64_t k) { return static_cast<uint32_t>(k & 0xFFFFFFFFu); }
+
+private:
+    static uint64_t key(uint32_t topic, uint32_t seq) { return (static_cast<uint64_t>(topic) << 32) | seq; }
+
+    GapMap _gaps;
+    size_t _max_gaps;
+    uint64_t _missing = 0;
+};
+
+#endif // SEQUENCE_GAP_SET_H
@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <chrono>
 #include <cstring>
+#include <cstddef>
 #include "Common.h"
 
 namespace SimplePubSub {
@@ -17,6 +18,8 @@ enum class StorageType {
 // Forward declaration
 struct PublisherSequenceRecord;
 
+#define PUBLISHER_RESTART_MAGIC 0x53454c44      // "SELD": 정상 종료 seal
+
 // HashMaster/File storage에 저장할 Publisher 시퀀스 레코드 구조체 (통합)
 struct PublisherSequenceRecord {
     char publisher_name[64];    // Primary Key
@@ -28,7 +31,13 @@ struct PublisherSequenceRecord {
     uint32_t misc_sequence;
     uint32_t all_topics_sequence;
     uint64_t last_updated_time; // timestamp (nanoseconds)
-    char reserved[32];          // 향후 확장용
+    // 재시작 seal (reserved 였던 자리): 정상 종료 시 seal(), 시작 시 검증 후 unseal().
+    // 죽은 뒤 재시작하면 seal 이 없으므로 DB 와 대조해 다시 맞춘다 (repair_sequences_from_db)
+    uint32_t restart_magic;     // PUBLISHER_RESTART_MAGIC 이면 seal 됨
+    uint32_t restart_checksum;  // compute_restart_checksum()
+    uint32_t db_watermark;      // seal 시 MessageDB max_seq
+    uint32_t master_generation; // 상위 (T2MA) 가 넘긴 마스터 내용 식별값 (0: 없음)
+    char reserved[16];          // 향후 확장용
     
     PublisherSequenceRecord() {
         memset(this, 0, sizeof(PublisherSequenceRecord));
@@ -71,6 +80,36 @@ struct PublisherSequenceRecord {
         last_updated_time = get_current_time_ns();
     }
     
+    uint32_t compute_restart_checksum() const {
+        // FNV-1a: 이름 ~ 시퀀스, watermark / generation (last_updated_time 은 save 때마다 바뀌므로 제외)
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(this);
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < offsetof(PublisherSequenceRecord, last_updated_time); i++) {
+            h = (h ^ p[i]) * 16777619u;
+        }
+        for (size_t i = offsetof(PublisherSequenceRecord, db_watermark); i < offsetof(PublisherSequenceRecord, reserved); i++) {
+            h = (h ^ p[i]) * 16777619u;
+        }
+        return h;
+    }
+    
+    void seal(uint32_t db_seq, uint32_t master_gen) {
+        db_watermark = db_seq;
+        master_generation = master_gen;
+        restart_magic = PUBLISHER_RESTART_MAGIC;
+        restart_checksum = compute_restart_checksum();
+    }
+    
+    void unseal() {
+        restart_magic = 0;
+        restart_checksum = 0;
+    }
+    
+    // 정상 종료로 seal 된 뒤 바뀌지 않은 레코드 (O(1))
+    bool is_sealed() const {
+        return restart_magic == PUBLISHER_RESTART_MAGIC && restart_checksum == compute_restart_checksum();
+    }
+    
     // Legacy support - convert to map format
     std::map<DataTopic, uint32_t> get_topic_sequences_map() const {
         std::map<DataTopic, uint32_t> result;
@@ -0,0 +1,445 @@
+#ifndef SHM_TOPIC_LOG_H
+#define SHM_TOPIC_LOG_H
+
+#include "Common.h"
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+namespace SimplePubSub {
+
+/**
+ * ShmTopicLog - 같은 호스트 구독자용 공유메모리 TopicMessage 로그 (single writer, multi reader)
+ *
+ * publisher 는 TopicMessage 를 한번만 로그에 쓰고, 각 구독자는 자기 cursor 로
+ * 로그를 제자리에서 읽는다. 구독자 수와 무관하게 publish 비용이 일정하다.
+ * writer 는 느린 reader 를 기다리지 않고 덮어쓴다 (reader 가 overrun 감지 후 복구).
+ *
+ * 레이아웃 (/dev/shm/<name>):
+ *   [ShmTopicLogHeader][index: index_slots x ShmLogIndexEntry][data: capacity bytes]
+ *   레코드: [uint32 length][uint32 global_seq][TopicMessage][8바이트 정렬 padding]
+ *   끝에 안 들어가는 레코드는 WRAP 표시 후 처음부터 (TopicMessage 는 항상 연속)
+ *
+ * - head_pos  : 공개된 쓰기 위치 (단조 증가 바이트 위치, publish() 에서만 갱신)
+ * - tail_pos  : 안전하게 읽을 수 있는 가장 오래된 위치, writer 가 덮어쓰기 전에 먼저 올린다
+ *               (덮어쓴 끝 + guard, 콜백 처리 중에 덮어써지지 않도록 여유를 둔다)
+ * - index     : global_seq -> 레코드 위치 (seq 재조회 = cursor rewind 로 복구)
+ * - cursors   : reader 별 cursor/마지막 seq (모니터링용, writer 는 보지 않는다)
+ */
+
+#define SHM_LOG_MAGIC 0x53544C47       // "STLG"
+#define SHM_LOG_VERSION 1
+#define SHM_LOG_HEADER_SIZE 8192
+#define SHM_LOG_MAX_READERS 64
+#define SHM_LOG_WRAP 0xFFFFFFFFu
+#define SHM_LOG_RECORD_HEADER 8
+
+struct ShmLogCursor {
+    std::atomic<uint32_t> client_id;    // 0 이면 빈 slot
+    std::atomic<uint32_t> last_seq;     // 마지막으로 읽은 global seq
+    std::atomic<uint64_t> pos;
+    std::atomic<uint64_t> update_ns;
+};
+
+struct ShmLogIndexEntry {
+    std::atomic<uint64_t> pos;
+    std::atomic<uint32_t> seq;
+    uint32_t reserved;
+};
+
+struct ShmTopicLogHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    uint64_t index_slots;
+    uint32_t base_seq;          // 생성 시점의 global seq (첫 레코드는 base_seq + 1)
+
+    alignas(64) std::atomic<uint64_t> head_pos;
+    std::atomic<uint64_t> tail_pos;
+    std::atomic<uint32_t> head_seq;         // 마지막으로 공개된 global seq
+    std::atomic<uint64_t> write_count;
+
+    alignas(64) std::atomic<uint32_t> wake_seq;     // futex word
+    std::atomic<uint32_t> waiters;                  // futex wait 중인 reader 수
+
+    alignas(64) ShmLogCursor cursors[SHM_LOG_MAX_READERS];
+};
+
+static_assert(sizeof(ShmTopicLogHeader) <= SHM_LOG_HEADER_SIZE, "ShmTopicLogHeader too large");
+
+class ShmTopicLog {
+public:
+    enum ReadResult {
+        READ_OK,
+        READ_EMPTY,
+        READ_OVERRUN        // writer 가 cursor 를 따라잡아 덮어씀 -> seek 또는 socket 복구 필요
+    };
+
+private:
+    std::string _name;
+    int _fd;
+    void* _addr;
+    size_t _map_size;
+    ShmTopicLogHeader* _hdr;
+    ShmLogIndexEntry* _index;
+    char* _data;
+    uint64_t _mask;
+    uint64_t _index_mask;
+    uint64_t _guard;            // tail 에서 이 거리 안에 있는 레코드는 곧 덮어쓰이므로 overrun 처리
+
+    // writer 상태
+    uint64_t _write_pos;
+
+    // reader 상태
+    int _slot;
+    uint64_t _cursor;
+    uint64_t _last_pos;         // 마지막으로 next() 가 돌려준 레코드 위치
+
+    static size_t align8(size_t n) { return (n + 7) & ~static_cast<size_t>(7); }
+
+    static long futex(std::atomic<uint32_t>* addr, int op, uint32_t val, const struct timespec* ts) {
+        return syscall(SYS_futex, reinterpret_cast<uint32_t*>(addr), op, val, ts, nullptr, 0);
+    }
+
+    bool map(int fd, size_t size) {
+        void* addr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (addr == MAP_FAILED) {
+            std::cerr << "ShmTopicLog mmap failed '" << _name << "': " << strerror(errno) << std::endl;
+            return false;
+        }
+        _fd = fd;
+        _addr = addr;
+        _map_size = size;
+        _hdr = static_cast<ShmTopicLogHeader*>(addr);
+        return true;
+    }
+
+    void setup_pointers() {
+        _index = reinterpret_cast<ShmLogIndexEntry*>(static_cast<char*>(_addr) + SHM_LOG_HEADER_SIZE);
+        _data = reinterpret_cast<char*>(_index + _hdr->index_slots);
+        _mask = _hdr->capacity - 1;
+        _index_mask = _hdr->index_slots - 1;
+        _guard = _hdr->capacity / 8;
+    }
+
+    static size_t file_size(uint64_t capacity, uint64_t index_slots) {
+        return SHM_LOG_HEADER_SIZE + index_slots * sizeof(ShmLogIndexEntry) + capacity;
+    }
+
+    // pos 의 레코드가 아직 안전하게 읽을 수 있는지 (데이터를 읽은 뒤 호출)
+    bool readable_at(uint64_t pos) const {
+        std::atomic_thread_fence(std::memory_order_acquire);
+        return pos >= _hdr->tail_pos.load(std::memory_order_relaxed);
+    }
+
+    // index 에서 global_seq 레코드 위치 조회 (writer 가 같은 slot 을 갱신 중이면 실패)
+    bool locate(uint32_t global_seq, uint64_t& pos) const {
+        const ShmLogIndexEntry& e = _index[global_seq & _index_mask];
+        if (e.seq.load(std::memory_order_acquire) != global_seq) return false;
+        pos = e.pos.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (e.seq.load(std::memory_order_relaxed) != global_seq) return false;
+        return readable_at(pos);
+    }
+
+public:
+    ShmTopicLog()
+        : _fd(-1), _addr(nullptr), _map_size(0), _hdr(nullptr), _index(nullptr), _data(nullptr),
+          _mask(0), _index_mask(0), _guard(0), _write_pos(0), _slot(-1), _cursor(0), _last_pos(0) {}
+    ~ShmTopicLog() { close(); }
+
+    ShmTopicLog(const ShmTopicLog&) = delete;
+    ShmTopicLog& operator=(const ShmTopicLog&) = delete;
+
+    /**
+     * writer 측 생성 (항상 새 shm 객체로 만든다, 이전 객체를 보던 reader 는 재구독 시 다시 open)
+     * @param capacity data 영역 크기, 2의 거듭제곱으로 올림
+     * @param base_seq 현재 global seq (다음 발행 메시지가 base_seq + 1)
+     */
+    bool create(const std::string& name, size_t capacity, uint32_t base_seq) {
+        close();
+        _name = name;
+
+        uint64_t cap = 64 * 1024;
+        while (cap < capacity) cap <<= 1;
+        uint64_t slots = cap / 64;      // 평균 레코드 64바이트 이상이면 window 전체를 index 로 커버
+
+        shm_unlink(name.c_str());
+        int fd = shm_open(name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0644);
+        if (fd < 0) {
+            std::cerr << "ShmTopicLog shm_open failed '" << name << "': " << strerror(errno) << std::endl;
+            return false;
+        }
+        size_t size = file_size(cap, slots);
+        if (ftruncate(fd, size) != 0) {
+            std::cerr << "ShmTopicLog ftruncate failed '" << name << "': " << strerror(errno) << std::endl;
+            ::close(fd);
+            return false;
+        }
+        if (!map(fd, size)) {
+            ::close(fd);
+            return false;
+        }
+
+        _hdr->capacity = cap;
+        _hdr->index_slots = slots;
+        _hdr->version = SHM_LOG_VERSION;
+        _hdr->head_pos.store(0);
+        _hdr->tail_pos.store(0);
+        _hdr->base_seq = base_seq;
+        _hdr->head_seq.store(base_seq);
+        _hdr->write_count.store(0);
+        _hdr->wake_seq.store(0);
+        _hdr->waiters.store(0);
+        setup_pointers();
+        _write_pos = 0;
+        std::atomic_thread_fence(std::memory_order_release);
+        _hdr->magic = SHM_LOG_MAGIC;
+        return true;
+    }
+
+    // reader 측 attach (client_id 로 cursor slot 을 잡는다)
+    bool open(const std::string& name, uint32_t client_id) {
+        close();
+        _name = name;
+
+        int fd = shm_open(name.c_str(), O_RDWR, 0);
+        if (fd < 0) {
+            std::cerr << "ShmTopicLog shm_open failed '" << name << "': " << strerror(errno) << std::endl;
+            return false;
+        }
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(SHM_LOG_HEADER_SIZE) || !map(fd, st.st_size)) {
+            std::cerr << "ShmTopicLog '" << name << "' is not initialized" << std::endl;
+            ::close(fd);
+            return false;
+        }
+        if (_hdr->magic != SHM_LOG_MAGIC || _hdr->version != SHM_LOG_VERSION ||
+            st.st_size != static_cast<off_t>(file_size(_hdr->capacity, _hdr->index_slots))) {
+            std::cerr << "ShmTopicLog '" << name << "' has invalid header" << std::endl;
+            close();
+            return false;
+        }
+        setup_pointers();
+
+        // 같은 client_id 의 slot 이 있으면 재사용, 없으면 빈 slot
+        for (int i = 0; i < SHM_LOG_MAX_READERS && _slot < 0; ++i) {
+            if (_hdr->cursors[i].client_id.load() == client_id) _slot = i;
+        }
+        for (int i = 0; i < SHM_LOG_MAX_READERS && _slot < 0; ++i) {
+            uint32_t expected = 0;
+            if (_hdr->cursors[i].client_id.compare_exchange_strong(expected, client_id)) _slot = i;
+        }
+        if (_slot < 0) {
+            std::cerr << "ShmTopicLog '" << name << "' has no free cursor slot" << std::endl;
+        }
+        seek_head();
+        return true;
+    }
+
+    void close() {
+        if (_addr) {
+            munmap(_addr, _map_size);
+            _addr = nullptr;
+        }
+        if (_fd >= 0) {
+            ::close(_fd);
+            _fd = -1;
+        }
+        _hdr = nullptr;
+        _index = nullptr;
+        _data = nullptr;
+        _slot = -1;
+    }
+
+    bool unlink() { return !_name.empty() && shm_unlink(_name.c_str()) == 0; }
+
+    bool is_open() const { return _hdr != nullptr; }
+    const std::string& name() const { return _name; }
+    size_t capacity() const { return _hdr ? _hdr->capacity : 0; }
+    uint32_t head_seq() const { return _hdr ? _hdr->head_seq.load(std::memory_order_acquire) : 0; }
+    uint64_t head_pos() const { return _hdr->head_pos.load(std::memory_order_acquire); }
+    uint64_t write_count() const { return _hdr ? _hdr->write_count.load(std::memory_order_relaxed) : 0; }
+
+    // ---- writer ----
+
+    // 기록할 수 있는 최대 TopicMessage 크기
+    size_t max_message_size() const { return _hdr ? _guard - SHM_LOG_RECORD_HEADER - 8 : 0; }
+
+    /**
+     * TopicMessage 하나 추가 (publish() 로 공개하기 전까지 reader 에게 보이지 않음)
+     * @return 레코드가 너무 크면 false
+     */
+    bool append(const TopicMessage* msg, size_t size) {
+        size_t need = align8(SHM_LOG_RECORD_HEADER + size);
+        if (!_hdr || need > _guard) return false;
+
+        uint64_t head = _write_pos;
+        uint64_t off = head & _mask;
+        uint64_t to_end = _hdr->capacity - off;
+        uint64_t end = head + need + (to_end < need ? to_end : 0);
+
+        // 덮어쓸 영역을 먼저 무효화 (reader 는 데이터를 읽은 뒤 tail 을 확인)
+        if (end + _guard > _hdr->capacity) {
+            _hdr->tail_pos.store(end + _guard - _hdr->capacity, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+        }
+
+        if (to_end < need) {
+            *reinterpret_cast<uint32_t*>(_data + off) = SHM_LOG_WRAP;
+            head += to_end;
+            off = 0;
+        }
+
+        char* rec = _data + off;
+        *reinterpret_cast<uint32_t*>(rec) = static_cast<uint32_t>(size);
+        *reinterpret_cast<uint32_t*>(rec + 4) = msg->global_seq;
+        memcpy(rec + SHM_LOG_RECORD_HEADER, msg, size);
+
+        ShmLogIndexEntry& e = _index[msg->global_seq & _index_mask];
+        e.seq.store(0, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        e.pos.store(head, std::memory_order_relaxed);
+        e.seq.store(msg->global_seq, std::memory_order_release);
+
+        _write_pos = head + need;
+        _hdr->write_count.fetch_add(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // append 한 레코드들을 reader 에게 공개하고 잠든 reader 를 깨운다
+    void publish(uint32_t last_seq) {
+        if (!_hdr) return;
+        _hdr->head_pos.store(_write_pos, std::memory_order_release);
+        _hdr->head_seq.store(last_seq, std::memory_order_seq_cst);
+        _hdr->wake_seq.fetch_add(1, std::memory_order_seq_cst);
+        if (_hdr->waiters.load(std::memory_order_seq_cst)) {
+            futex(&_hdr->wake_seq, FUTEX_WAKE, INT_MAX, nullptr);
+        }
+    }
+
+    void wake_all() {
+        if (!_hdr) return;
+        _hdr->wake_seq.fetch_add(1, std::memory_order_seq_cst);
+        futex(&_hdr->wake_seq, FUTEX_WAKE, INT_MAX, nullptr);
+    }
+
+    // ---- reader ----
+
+    uint64_t cursor() const { return _cursor; }
+
+    // 다음에 발행될 메시지부터 읽도록 이동
+    void seek_head() {
+        if (!_hdr) return;
+        _cursor = _hdr->head_pos.load(std::memory_order_acquire);
+    }
+
+    /**
+     * global_seq 부터 다시 읽도록 cursor 이동 (복구 = rewind)
+     * @return window 밖(이미 덮어썼거나 index 에서 밀려남)이면 false
+     */
+    bool seek(uint32_t global_seq) {
+        if (!_hdr) return false;
+        uint32_t head = head_seq();
+        if (global_seq > head + 1) return false;
+        if (global_seq == head + 1) {
+            if (head == _hdr->base_seq) {
+                _cursor = 0;
+                return true;
+            }
+            // head_pos 는 head_seq 와 따로 갱신되므로 마지막 레코드 바로 뒤로 이동
+            uint64_t pos;
+            if (!locate(head, pos)) return false;
+            uint32_t len = *reinterpret_cast<const uint32_t*>(_data + (pos & _mask));
+            if (!readable_at(pos)) return false;
+            _cursor = pos + align8(SHM_LOG_RECORD_HEADER + len);
+            return true;
+        }
+
+        uint64_t pos;
+        if (!locate(global_seq, pos)) return false;
+        _cursor = pos;
+        return true;
+    }
+
+    /**
+     * cursor 위치의 메시지를 돌려주고 cursor 를 다음 레코드로 옮긴다 (복사 없음)
+     * 콜백 처리 후 still_valid() 로 처리 중 덮어써지지 않았는지 확인한다.
+     */
+    ReadResult next(const TopicMessage*& msg, size_t& size) {
+        for (;;) {
+            if (_cursor >= _hdr->head_pos.load(std::memory_order_acquire)) return READ_EMPTY;
+
+            uint64_t off = _cursor & _mask;
+            uint32_t len = *reinterpret_cast<const uint32_t*>(_data + off);
+            if (!readable_at(_cursor)) return READ_OVERRUN;
+
+            if (len == SHM_LOG_WRAP) {
+                _cursor += _hdr->capacity - off;
+                continue;
+            }
+
+            msg = reinterpret_cast<const TopicMessage*>(_data + off + SHM_LOG_RECORD_HEADER);
+            size = len;
+            _last_pos = _cursor;
+            _cursor += align8(SHM_LOG_RECORD_HEADER + len);
+            return READ_OK;
+        }
+    }
+
+    // 마지막으로 next() 가 돌려준 메시지가 아직 덮어써지지 않았는지
+    bool still_valid() const { return readable_at(_last_pos); }
+
+    // 마지막 메시지가 tail 에 가까워 처리 중에 덮어써질 수 있는지 (이 경우 reader 는 복사 후 still_valid 확인)
+    bool near_tail() const {
+        return _last_pos < _hdr->tail_pos.load(std::memory_order_acquire) + _guard;
+    }
+
+    // cursor slot 에 진행 상황 기록 (모니터링용)
+    void report(uint32_t last_seq) {
+        if (!_hdr || _slot < 0) return;
+        ShmLogCursor& c = _hdr->cursors[_slot];
+        c.last_seq.store(last_seq, std::memory_order_relaxed);
+        c.pos.store(_cursor, std::memory_order_relaxed);
+        c.update_ns.store(get_current_timestamp(), std::memory_order_relaxed);
+    }
+
+    void release_slot() {
+        if (_hdr && _slot >= 0) {
+            _hdr->cursors[_slot].client_id.store(0);
+            _slot = -1;
+        }
+    }
+
+    /**
+     * head_seq 가 seen 에서 바뀔 때까지 futex 대기
+     * @return 바뀌었으면 true
+     */
+    bool wait(uint32_t seen, long timeout_us) {
+        if (!_hdr) return false;
+        if (head_seq() != seen) return true;
+
+        uint32_t ws = _hdr->wake_seq.load(std::memory_order_seq_cst);
+        _hdr->waiters.fetch_add(1, std::memory_order_seq_cst);
+        if (_hdr->head_seq.load(std::memory_order_seq_cst) == seen) {
+            struct timespec ts = {timeout_us / 1000000, (timeout_us % 1000000) * 1000};
+            futex(&_hdr->wake_seq, FUTEX_WAIT, ws, timeout_us > 0 ? &ts : nullptr);
+        }
+        _hdr->waiters.fetch_sub(1, std::memory_order_relaxed);
+        return head_seq() != seen;
+    }
+};
+
+} // namespace SimplePubSub
+
+#endif // SHM_TOPIC_LOG_H
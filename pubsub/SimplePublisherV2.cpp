@@ -1,15 +1,51 @@
 #include "SimplePublisherV2.h"
+#include "../common/Tracepoints.h"
 #include <cstring>
 #include <cerrno>
 #include <chrono>
+#include <algorithm>
 #include <signal.h>
 #include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+
+// multicast heartbeat 주기 (구독자가 마지막 datagram 유실을 감지하는 최대 지연)
+static const long MCAST_HEARTBEAT_INTERVAL_US = 200000;
+// DB flush_if_stale 호출 주기 (DB_SAM 은 DB_SAM_BLOCK_MAX_DELAY_MS 지난 버퍼만 내림)
+static const long DB_FLUSH_CHECK_INTERVAL_US = 200000;
+
+// 복구 스트리밍: 한번에 output 에 올리는 메시지 수, 남은 양이 이 이하가 되면 main 으로 넘겨 live 전환
+static const uint32_t RECOVERY_CHUNK_MESSAGES = 4096;
+static const uint32_t RECOVERY_HANDOFF_MESSAGES = 1024;
+// output evbuffer 가 이 크기 이하로 비면 다음 chunk 전송
+static const size_t RECOVERY_LOW_WATERMARK = 256 * 1024;
+// 압축 복구: 이 크기 (압축 전) 만큼 TopicMessage 를 모아 RecoveryBatch 하나로 보냄
+static const size_t RECOVERY_BATCH_BYTES = 64 * 1024;
+// 복구 대역폭 예산: 남은 메시지가 이 이하면 예산과 관계없이 전송 (기본값), 예산 burst 는 이 시간만큼의 rate
+static const uint32_t RECOVERY_PRIORITY_MESSAGES = 65536;
+static const uint64_t RECOVERY_BURST_MS = 50;
+// 예산을 기다리는 최소 / 최대 간격
+static const uint64_t RECOVERY_PACE_MIN_US = 200;
+static const uint64_t RECOVERY_PACE_MAX_US = 100000;
+
+// I/O reactor: publish -> reactor 큐 크기 (batch 단위), 알림 한번에 처리할 최대 항목 수 (socket 쓰기가 밀리지 않도록)
+static const size_t REACTOR_QUEUE_CAPACITY = 16384;
+static const size_t REACTOR_DRAIN_LIMIT = 256;
+
+// 구간 복구: 한번에 DB 에서 읽어 output 에 올리는 메시지 수 (DB lock 을 잡는 단위, 요청 상한은 Common.h)
+static const uint32_t GAP_RECOVERY_CHUNK_MESSAGES = 1024;
+
+// listen backlog: 재연결이 몰릴 때 accept 전 대기 연결 수 (커널 somaxconn 으로 제한됨)
+static const int LISTEN_BACKLOG = 1024;
 
 SimplePublisherV2::SimplePublisherV2(event_base *main_base) :
         _main_base(main_base),
-        _listener(nullptr),
+        _unix_listener(nullptr),
+        _tcp_listener(nullptr),
+        _msg_pool(MessageBufferPool::shared()),
         _use_unix(true),
         _publisher_id(0),
+        _publisher_sequence_record(nullptr),
         _sequence_storage(nullptr)
 {
     pipe(_main_notify_pipe);
@@ -18,20 +54,43 @@ SimplePublisherV2::SimplePublisherV2(event_base *main_base) :
                                         static_cast<SimplePublisherV2*>(arg)->main_notify_cb(fd);
                                     }, this);
     event_add(_main_notify_event, nullptr);
+    _subscriber_snapshot = std::make_shared<SubscriberSnapshot>();
+    _recovery_priority_messages = RECOVERY_PRIORITY_MESSAGES;
+    _batch_flush_event = event_new(_main_base, -1, 0,
+                                    [](evutil_socket_t, short, void* arg){
+                                        static_cast<SimplePublisherV2*>(arg)->flush_batch();
+                                    }, this);
     // _publisher_sequence_record = new PublisherSequenceRecord(); // move to set_sequence_storage
 }
 SimplePublisherV2::~SimplePublisherV2() {
+    flush_batch();
     stop();
+    if (_batch_flush_event) event_free(_batch_flush_event);
+    if (_mcast_heartbeat_event) event_free(_mcast_heartbeat_event);
+    if (_db_flush_event) event_free(_db_flush_event);
     if (_main_notify_event) event_free(_main_notify_event);
     close(_main_notify_pipe[0]);
     close(_main_notify_pipe[1]);
-    if (_sequence_storage_type == StorageType::FILE_STORAGE && _publisher_sequence_record) {
+    // DB 를 먼저 닫고 (write-behind 면 남은 tail 까지 기록) 시퀀스 레코드를 seal
+    uint32_t sealed_db_seq = _db ? _db->max_seq() : 0;
+    if (_db) {
+        _db->close();
+    }
+    seal_sequence_record(sealed_db_seq);
+    if (_write_behind_storage) {
+        // 마지막 레코드 저장 후 flusher 종료
+        delete _write_behind_storage;
+        _write_behind_storage = nullptr;
+        _sequence_storage = nullptr;
+    }
+    if (_owns_sequence_record && _publisher_sequence_record) {
         delete _publisher_sequence_record;
         _publisher_sequence_record = nullptr;
     }
-    if (_db) {
-        _db->close();
-        _db.reset();
+    _db.reset();
+    if (_shm_log) {
+        _shm_log->unlink();
+        _shm_log.reset();
     }
 }    
 
@@ -56,13 +115,20 @@ void SimplePublisherV2::set_sequence_storage(SequenceStorage* sequence_storage)
 
 bool SimplePublisherV2::init_sequence_storage(StorageType storage_type) {
     _sequence_storage_type = storage_type;
+    std::string topics_path;
     if(_sequence_storage_type == StorageType::FILE_STORAGE) {
         std::string seq_file = get_publisher_name() + ".seq";
         std::string storage_dir = "./data/sequence_data";
-        _sequence_storage = new FileSequenceStorage(storage_dir, seq_file);
+        topics_path = storage_dir + "/" + get_publisher_name() + ".topics";
+        FileSequenceStorage* file_storage = new FileSequenceStorage(storage_dir, seq_file);
+        // write-behind 는 저장 빈도가 낮으므로 rename 으로 원자적 교체 (중간에 죽어도 이전 레코드 유지)
+        file_storage->set_durable(_sequence_flush_ms > 0);
+        _sequence_storage = file_storage;
         _publisher_sequence_record = new PublisherSequenceRecord(get_publisher_name(), 0, 0);
+        _owns_sequence_record = true;
     } else {
         std::string storage_path = "./sequence_data/" + get_publisher_name() + "_sequences";
+        topics_path = storage_path + ".topics";
         _sequence_storage = new HashmasterSequenceStorage(storage_path);
     }
     _sequence_storage->initialize();
@@ -71,6 +137,11 @@ bool SimplePublisherV2::init_sequence_storage(StorageType storage_type) {
     if(_sequence_storage_type == StorageType::HASHMASTER_STORAGE) {
         HashmasterSequenceStorage* hashmaster_storage = static_cast<HashmasterSequenceStorage*>(_sequence_storage);
         _publisher_sequence_record = hashmaster_storage->load_sequences_direct(get_publisher_name());
+        if (_publisher_sequence_record && _sequence_flush_ms > 0) {
+            // write-behind: publish 는 프로세스 메모리 사본만 갱신 (mmap page 는 flusher 가 갱신)
+            _publisher_sequence_record = new PublisherSequenceRecord(*_publisher_sequence_record);
+            _owns_sequence_record = true;
+        }
     } else {
         _sequence_storage->load_sequences(get_publisher_name(), _publisher_sequence_record);
     }
@@ -78,54 +149,194 @@ bool SimplePublisherV2::init_sequence_storage(StorageType storage_type) {
         std::cerr << "Failed to load sequence record" << std::endl;
         return false;
     }
+    take_restart_seal();
+    if (_sequence_flush_ms > 0) {
+        _write_behind_storage = new WriteBehindSequenceStorage(_sequence_storage, _sequence_flush_ms);
+        _sequence_storage = _write_behind_storage;
+        _write_behind_storage->start();
+        std::cout << "Sequence storage write-behind every " << _sequence_flush_ms << "ms" << std::endl;
+    }
+    init_topic_sequences(topics_path);
+    repair_sequences_from_db();
     return true;
 }
 
+// 확장 토픽이 등록되어 있을 때만 파일에 둔다 (기본 토픽만 쓰면 레코드가 전부)
+void SimplePublisherV2::init_topic_sequences(const std::string& path) {
+    const TopicRegistry& registry = TopicRegistry::global();
+    if (!registry.has_extended() || !_topic_sequences.open(path, registry)) {
+        _topic_sequences.open("", registry);
+    }
+    _topic_sequences.attach(_publisher_sequence_record);
+}
+
+// 지난 실행의 seal 을 읽어두고 레코드는 unseal 해서 저장 (이번 실행이 죽으면 다음 시작은 seal 없음)
+void SimplePublisherV2::take_restart_seal() {
+    PublisherSequenceRecord* record = _publisher_sequence_record;
+    _restart_sealed = record->is_sealed();
+    if (!_restart_sealed && record->restart_magic == PUBLISHER_RESTART_MAGIC) {
+        std::cerr << "Sequence record seal checksum mismatch - treating as unclean shutdown" << std::endl;
+    }
+    _restart_db_watermark = record->db_watermark;
+    _restart_master_generation = record->master_generation;
+    if (record->restart_magic == 0 && record->restart_checksum == 0) {
+        return;
+    }
+    record->unseal();
+    if (_sequence_storage) {
+        _sequence_storage->save_sequences(*record);
+    }
+}
+
+// 정상 종료: DB 를 다 쓴 뒤 호출. 다음 시작은 seal / watermark 비교만으로 (O(1)) 이어받는다
+void SimplePublisherV2::seal_sequence_record(uint32_t db_seq) {
+    if (!_publisher_sequence_record || !_sequences_repaired) {
+        return;     // DB 와 맞춰본 적 없는 레코드는 seal 하지 않음
+    }
+    _publisher_sequence_record->seal(db_seq, _master_generation);
+    if (_sequence_storage) {
+        _sequence_storage->save_sequences(*_publisher_sequence_record);
+    }
+    std::cout << "Sequence record sealed: seq " << _publisher_sequence_record->all_topics_sequence
+              << ", db " << db_seq << ", master generation " << _master_generation << std::endl;
+}
+
+void SimplePublisherV2::repair_sequences_from_db() {
+    if (_sequences_repaired || !_db || !_publisher_sequence_record) {
+        return;
+    }
+    _sequences_repaired = true;
+    uint32_t saved_seq = _publisher_sequence_record->all_topics_sequence;
+    uint32_t db_seq = _db->max_seq();
+    if (_restart_sealed && _restart_db_watermark == db_seq && saved_seq == db_seq) {
+        _warm_restart = true;
+        std::cout << "Warm restart: sequence record sealed at seq " << saved_seq << " matches database" << std::endl;
+        return;
+    }
+    if (_restart_sealed) {
+        std::cout << "Sequence record seal does not match database (sealed db " << _restart_db_watermark
+                  << ", db " << db_seq << ", record " << saved_seq << ")" << std::endl;
+    }
+    if (db_seq < saved_seq) {
+        // DB tail 이 잘렸음 (repair_tail): 그 구간 복구 요청은 DB 에서 못 채운다
+        std::cerr << "Database ends at seq " << db_seq << " behind sequence record " << saved_seq << std::endl;
+    }
+    if (db_seq <= saved_seq) {
+        return;
+    }
+    uint32_t repaired = 0;
+    auto apply = [&](uint32_t seq, const void* data, size_t size) {
+        if (size < sizeof(TopicMessage)) {
+            return;
+        }
+        const TopicMessage* msg = static_cast<const TopicMessage*>(data);
+        _topic_sequences.set(seq, msg->topic, msg->topic_seq);
+        repaired++;
+    };
+    bool ranged = _db->get_range(saved_seq + 1, db_seq, [&](uint32_t seq, const SAM_INDEX&, const void* data, size_t size) {
+        apply(seq, data, size);
+        return true;
+    });
+    if (!ranged) {
+        std::string data;
+        for (uint32_t seq = saved_seq + 1; seq <= db_seq; ++seq) {
+            if (_db->get(seq, data)) apply(seq, data.data(), data.size());
+        }
+    }
+    std::cout << "Sequence record repaired from database: seq " << saved_seq << " -> "
+              << _publisher_sequence_record->all_topics_sequence << " (" << repaired << " messages)" << std::endl;
+    if (_sequence_storage) {
+        _sequence_storage->save_sequences(*_publisher_sequence_record);
+    }
+}
+
 bool SimplePublisherV2::init_database(const std::string& db_path) {
+    return init_database(db_path, db_path.empty() ? MessageDBType::MEMORY : MessageDBType::FILE);
+}
+
+bool SimplePublisherV2::init_database(const std::string& db_path, MessageDBType db_type,
+                                      const MMapSyncPolicy& sync_policy) {
     _db_path = db_path;
-    if( _db_path.empty() ) {
-        _db = std::make_unique<Memory_SAM>();
-    } else {
-        _db = std::make_unique<DB_SAM>(_db_path);
+    if (db_type != MessageDBType::MEMORY && _db_path.empty()) {
+        std::cerr << "Database path is required for file based database" << std::endl;
+        return false;
+    }
+    switch (db_type) {
+        case MessageDBType::MEMORY:
+            _db = std::make_unique<Memory_SAM>(_db_memory_chunk_size, _db_memory_max_bytes);
+            if (_db_memory_max_bytes > 0) {
+                std::cout << "Memory database ring mode (max " << (_db_memory_max_bytes >> 20) << "MB, "
+                          << "recovery older than the ring starts at its oldest message)" << std::endl;
+            }
+            break;
+        case MessageDBType::FILE: {
+            std::unique_ptr<DB_SAM> db = std::make_unique<DB_SAM>(_db_path);
+            db->set_compression(_db_compression, _db_block_size);
+            _db = std::move(db);
+            break;
+        }
+        case MessageDBType::MMAP:   _db = std::make_unique<MMAP_SAM>(_db_path, sync_policy); break;
+        case MessageDBType::SEGMENTED: _db = std::make_unique<SEGMENT_SAM>(_db_path, _db_segment_policy); break;
+    }
+    if (_db_write_behind && db_type != MessageDBType::MEMORY) {
+        // publish 는 메모리 tail 에만 쓰고 파일 기록은 writer 스레드에서
+        std::unique_ptr<MessageDB> inner = std::move(_db);
+        _db = std::make_unique<WriteBehindMessageDB>(std::move(inner), _db_lag_policy);
+        std::cout << "Database write-behind enabled (max lag " << _db_lag_policy.max_lag_messages << " messages, "
+                  << (_db_lag_policy.max_lag_bytes >> 20) << "MB, "
+                  << (_db_lag_policy.mode == DurableLagMode::BLOCK ? "block" : "warn") << ")" << std::endl;
     }
     if(!_db->open()) {
         std::cerr << "Failed to open database" << std::endl;
         return false;
     }
     std::cout << "Database initialized successfully" << std::endl;
+    repair_sequences_from_db();
+    _db_durable_seq.set(_db->durable_max_seq());
+    if (!_db_flush_event) {
+        _db_flush_event = event_new(_main_base, -1, EV_PERSIST,
+                                    [](evutil_socket_t, short, void* arg){
+                                        static_cast<SimplePublisherV2*>(arg)->db_flush_tick();
+                                    }, this);
+        struct timeval interval = {0, DB_FLUSH_CHECK_INTERVAL_US};
+        event_add(_db_flush_event, &interval);
+    }
     return true;
 }
 
+// main loop 타이머: put 이 오지 않아도 오래된 DB 버퍼를 내리고 durable watermark gauge 갱신
+void SimplePublisherV2::db_flush_tick() {
+    if (!_db->flush_if_stale()) {
+        std::cerr << "Failed to flush database buffer" << std::endl;
+    }
+    _db_durable_seq.set(_db->durable_max_seq());
+}
+
 bool SimplePublisherV2::start(size_t recovery_thread_count) {
     if (!_main_base) return false;
-    if (_use_unix) {
+    const bool listen_unix = _use_unix || _listen_both;
+    const bool listen_tcp = !_use_unix || _listen_both;
+    // reactor 별 acceptor 를 쓰면 TCP listener 는 start_io_reactors 에서 reactor base 에 만든다
+    const bool reactor_tcp = listen_tcp && _tcp_reactor_acceptors && _reactor_count > 0;
+    if (listen_unix) {
         std::cout << "Starting Unix socket server on: " << _unix_path << std::endl;
-        sockaddr_un sa; memset(&sa,0,sizeof(sa));
-        sa.sun_family = AF_UNIX;
-        strncpy(sa.sun_path, _unix_path.c_str(), sizeof(sa.sun_path)-1);
-
         // Remove existing socket file
         ::unlink(_unix_path.c_str());
         std::cout << "Removed existing socket file" << std::endl;
-         _listener = evconnlistener_new_bind(_main_base, static_accept_cb, this,
-                                            LEV_OPT_CLOSE_ON_FREE|LEV_OPT_REUSEABLE, -1,
-                                            (sockaddr*)&sa,sizeof(sa));
-        if (!_listener) {
+        _unix_listener = bind_listener(_main_base, false, false, static_accept_cb, this);
+        if (!_unix_listener) {
             std::cerr << "Failed to create evconnlistener for Unix socket" << std::endl;
             return false;
         }
         std::cout << "Created evconnlistener successfully" << std::endl;
-
-    } else {
-        sockaddr_in sin; memset(&sin,0,sizeof(sin));
-        sin.sin_family=AF_INET; sin.sin_addr.s_addr=htonl(0); sin.sin_port=htons(_tcp_port);
-        _listener = evconnlistener_new_bind(_main_base, static_accept_cb, this,
-                                            LEV_OPT_CLOSE_ON_FREE|LEV_OPT_REUSEABLE, -1,
-                                            (sockaddr*)&sin,sizeof(sin));
-    }
-    if (!_listener) {
-        std::cerr << "Failed to create listener" << std::endl;
-        return false;
+    }
+    if (listen_tcp && !reactor_tcp) {
+        std::cout << "Starting TCP socket server on port: " << _tcp_port << std::endl;
+        _tcp_listener = bind_listener(_main_base, true, false, static_tcp_accept_cb, this);
+        if (!_tcp_listener) {
+            std::cerr << "Failed to create listener" << std::endl;
+            return false;
+        }
     }
 
     // 개선된 복구 워커 생성
@@ -143,8 +354,36 @@ bool SimplePublisherV2::start(size_t recovery_thread_count) {
         event_add(w->notify_event,nullptr);
         w->running=true;
         w->th=std::thread([w](){ event_base_dispatch(w->base); });
+        if (!_recovery_cpus.empty()) {
+            int cpu = _recovery_cpus[i % _recovery_cpus.size()];
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(cpu, &cpuset);
+            int rc = pthread_setaffinity_np(w->th.native_handle(), sizeof(cpuset), &cpuset);
+            if (rc != 0) {
+                std::cerr << "Failed to pin recovery worker " << i << " to cpu " << cpu << ": " << strerror(rc) << std::endl;
+            }
+        }
         _workers.push_back(w);
     }
+    start_io_reactors();
+    if (reactor_tcp && !_tcp_listener) {
+        size_t acceptors = 0;
+        for (auto r : _reactors) {
+            if (r->listener) acceptors++;
+        }
+        if (acceptors == 0) {
+            // reactor 를 만들지 못했거나 SO_REUSEPORT bind 실패: main base 에서 받는다
+            std::cerr << "No io reactor TCP acceptor, listening on main base" << std::endl;
+            _tcp_listener = bind_listener(_main_base, true, false, static_tcp_accept_cb, this);
+            if (!_tcp_listener) {
+                std::cerr << "Failed to create listener" << std::endl;
+                return false;
+            }
+        } else {
+            std::cout << "TCP port " << _tcp_port << " accepted by " << acceptors << " io reactors (SO_REUSEPORT)" << std::endl;
+        }
+    }
     /*
     for (size_t i = 0; i < recovery_thread_count; ++i) {
         try {
@@ -273,9 +512,29 @@ bool SimplePublisherV2::start_both(const std::string& unix_path, const std::stri
     set_unix_path(unix_path);
     set_tcp_address(tcp_host);
     set_tcp_port(tcp_port);
+    _listen_both = true;
     return start();
 }
 
+evconnlistener* SimplePublisherV2::bind_listener(event_base* base, bool tcp, bool reuse_port,
+                                                 evconnlistener_cb cb, void* ctx) {
+    unsigned flags = LEV_OPT_CLOSE_ON_FREE | LEV_OPT_REUSEABLE | (reuse_port ? LEV_OPT_REUSEABLE_PORT : 0);
+    if (!tcp) {
+        sockaddr_un sa; memset(&sa,0,sizeof(sa));
+        sa.sun_family = AF_UNIX;
+        strncpy(sa.sun_path, _unix_path.c_str(), sizeof(sa.sun_path)-1);
+        return evconnlistener_new_bind(base, cb, ctx, flags, LISTEN_BACKLOG, (sockaddr*)&sa, sizeof(sa));
+    }
+    sockaddr_in sin; memset(&sin,0,sizeof(sin));
+    sin.sin_family = AF_INET;
+    sin.sin_port = htons(_tcp_port);
+    // 숫자 주소가 아니면 (호스트 이름 등) 모든 인터페이스
+    if (_tcp_address.empty() || evutil_inet_pton(AF_INET, _tcp_address.c_str(), &sin.sin_addr) != 1) {
+        sin.sin_addr.s_addr = htonl(INADDR_ANY);
+    }
+    return evconnlistener_new_bind(base, cb, ctx, flags, LISTEN_BACKLOG, (sockaddr*)&sin, sizeof(sin));
+}
+
 size_t SimplePublisherV2::get_client_count() const {
     std::lock_guard<std::mutex> lock(const_cast<std::mutex&>(_clients_mu));
     return _clients.size();
@@ -292,9 +551,12 @@ void SimplePublisherV2::stop() {
     std::cout << "SimplePublisherV2::stop - Starting graceful shutdown..." << std::endl;
 
     // 1. 먼저 새로운 연결 수락 중지
-    if (_listener) {
-        evconnlistener_free(_listener);
-        _listener = nullptr;
+    // (reactor acceptor 는 reactor 스레드 종료 후 stop_io_reactors 에서)
+    if (_unix_listener || _tcp_listener) {
+        if (_unix_listener) evconnlistener_free(_unix_listener);
+        if (_tcp_listener) evconnlistener_free(_tcp_listener);
+        _unix_listener = nullptr;
+        _tcp_listener = nullptr;
         std::cout << "Listener closed" << std::endl;
     }
 
@@ -308,12 +570,21 @@ void SimplePublisherV2::stop() {
         char c='q'; write(w->notify_pipe_w,&c,1);
         if (w->th.joinable()) w->th.join();
         if (w->notify_event) event_free(w->notify_event);
+        if (w->pace_timer) event_free(w->pace_timer);
+        w->throttled.clear();
         close(w->notify_pipe_r); close(w->notify_pipe_w);
         if (w->base) event_base_free(w->base);
         delete w;
     }
     _workers.clear();
 
+    // reactor 스레드 먼저 멈추고 (클라이언트 bev 는 아래에서 정리) base 는 마지막에 해제
+    for (auto r : _reactors) {
+        event_base_loopbreak(r->base);
+        uint64_t one = 1; write(r->notify_fd, &one, sizeof(one));
+        if (r->th.joinable()) r->th.join();
+    }
+
     /*
     for (size_t i = 0; i < _workers.size(); ++i) {
         auto* w = _workers[i];
@@ -410,250 +681,1323 @@ void SimplePublisherV2::stop() {
             }
         }
         _clients.clear();
+        rebuild_subscriber_snapshot_locked();
     }
+    stop_io_reactors();
 
     std::cout << "SimplePublisherV2::stop - Shutdown complete" << std::endl;
 }
 
 void SimplePublisherV2::publish(DataTopic topic, const char* data,size_t size) {
-    if (!_publisher_sequence_record || !_db) {
-        std::cerr << "Publisher sequence record or _db not initialized" << std::endl;
-        std::cerr << "Publisher not properly initialized - EARLY RETURN!" << std::endl;
+    if (_micro_batching) {
+        // payload만 staging 버퍼에 복사 (vector 용량은 재사용되므로 steady state에서는 할당 없음)
+        size_t offset = _batch_data.size();
+        _batch_data.insert(_batch_data.end(), data, data + size);
+        _batch_staged.push_back(StagedItem{topic, offset, size});
+        if (_batch_staged.size() == 1 && _batch_flush_event) {
+            event_active(_batch_flush_event, EV_TIMEOUT, 0);
+        }
         return;
     }
+    PublishItem item = {topic, data, size};
+    publish_batch(&item, 1);
+}
 
-    // 1. Update sequence numbers in publisher_sequence_record
-    uint32_t current_topic_seq = _publisher_sequence_record->get_topic_sequence(topic);
-    uint32_t new_topic_seq = current_topic_seq + 1;
-    uint32_t new_global_seq = _publisher_sequence_record->all_topics_sequence + 1;
-    
-    _publisher_sequence_record->set_topic_sequence(new_global_seq, topic, new_topic_seq);
-    
-    // 2. Create TopicMessage structure
-    size_t msg_size = sizeof(TopicMessage) + size;
-    std::vector<char> msg_buffer(msg_size);
-    TopicMessage* topic_msg = reinterpret_cast<TopicMessage*>(msg_buffer.data());
-    
-    topic_msg->magic = MAGIC_TOPIC_MSG;
-    topic_msg->topic = topic;
-    topic_msg->global_seq = new_global_seq;
-    topic_msg->topic_seq = new_topic_seq;
-    topic_msg->timestamp = get_current_timestamp();
-    topic_msg->data_size = static_cast<uint32_t>(size);
-    memcpy(topic_msg->data, data, size);
+void SimplePublisherV2::set_micro_batching(bool enable) {
+    if (!enable) flush_batch();
+    _micro_batching = enable;
+}
 
-    // 3. Store message in database
-    if (!_db->put(msg_buffer.data(), msg_size)) {
-        std::cerr << "Failed to store message in database - continuing anyway" << std::endl;
-        // Don't return here - continue to send to clients even if DB fails
+void SimplePublisherV2::flush_batch() {
+    if (_batch_staged.empty()) return;
+    _batch_items.clear();
+    for (auto& st : _batch_staged) {
+        _batch_items.push_back(PublishItem{st.topic, _batch_data.data() + st.offset, st.size});
     }
+    publish_batch(_batch_items.data(), _batch_items.size());
+    _batch_staged.clear();
+    _batch_data.clear();
+}
 
-    // 4. Save sequence to storage
-    if (_sequence_storage) {
-        if (!_sequence_storage->save_sequences(*_publisher_sequence_record)) {
-            std::cerr << "Failed to save sequence to storage" << std::endl;
-        }
+bool SimplePublisherV2::enable_shm_log(const std::string& name, size_t capacity) {
+    std::unique_ptr<ShmTopicLog> log(new ShmTopicLog());
+    if (!log->create(name, capacity, get_current_sequence())) {
+        std::cerr << "Failed to create shm topic log: " << name << std::endl;
+        return false;
     }
+    std::cout << "Shm topic log enabled: " << name << " (capacity=" << log->capacity()
+              << ", max_msg_size=" << log->max_message_size() << ")" << std::endl;
+    _shm_log = std::move(log);
+    return true;
+}
 
-    // 5. Send message to ONLINE clients
-    std::vector<std::shared_ptr<ClientInfo>> send_list;
-    {
-        std::lock_guard<std::mutex> g(_clients_mu);
-        for(auto&kv:_clients){
-            auto ci=kv.second;
-            std::lock_guard<std::mutex> cg(ci->mu);
-            if(!(ci->topic_mask&(1u<<topic))) continue;
+bool SimplePublisherV2::enable_multicast(const std::string& address, const std::string& iface, int ttl,
+                                         size_t max_datagram) {
+    std::unique_ptr<EventUdpSocket> udp(new EventUdpSocket(_main_base));
+    udp->setMulticastInterface(iface);
+    udp->setMulticastTtl(ttl);
+    try {
+        udp->connect(address);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to enable multicast " << address << ": " << e.what() << std::endl;
+        return false;
+    }
+    _mcast = std::move(udp);
+    _mcast_address = address;
+    _mcast_max_datagram = std::max(max_datagram, sizeof(MulticastHeader) + sizeof(TopicMessage));
+
+    if (!_mcast_heartbeat_event) {
+        _mcast_heartbeat_event = event_new(_main_base, -1, EV_PERSIST,
+                                           [](evutil_socket_t, short, void* arg){
+                                               static_cast<SimplePublisherV2*>(arg)->send_multicast_heartbeat();
+                                           }, this);
+        struct timeval interval = {0, MCAST_HEARTBEAT_INTERVAL_US};
+        event_add(_mcast_heartbeat_event, &interval);
+    }
+    std::cout << "Multicast enabled: " << address << " (ttl=" << ttl << ", max_datagram=" << _mcast_max_datagram << ")" << std::endl;
+    return true;
+}
 
-            if(ci->status==CLIENT_ONLINE) {
-                send_list.push_back(ci);
-            } else if(ci->status==CLIENT_RECOVERING) {
-                std::cout << "RECOVERING CLIENT: " << ci->fd << " PUSHING MESSAGE" << std::endl;
-                ci->pending_messages.push(PendingMessage(topic, new_global_seq, new_topic_seq, msg_buffer.data(), msg_size));
-            }
+// batch 의 TopicMessage 들은 msg_buf 에 연속으로 있으므로 [header][연속 구간] 을 복사 없이 sendmsg
+// max_datagram 보다 큰 메시지는 혼자 보내고, UDP 한계를 넘으면 보내지 않는다 (구독자가 socket 복구로 채움)
+void SimplePublisherV2::send_multicast(const MessageSlice* slices, size_t count) {
+    size_t i = 0;
+    while (i < count) {
+        size_t first = i;
+        size_t used = sizeof(MulticastHeader);
+        while (i < count && (i == first || used + slices[i].size <= _mcast_max_datagram)) {
+            used += slices[i].size;
+            ++i;
+        }
+        if (used > EventUdpSocket::MAX_DATAGRAM_SIZE) {
+            std::cerr << "Message too large for multicast: " << slices[first].size << " bytes" << std::endl;
+            _mcast_drops++;
+            continue;
+        }
+
+        MulticastHeader hdr;
+        hdr.magic = MAGIC_MCAST_DATA;
+        hdr.publisher_id = _publisher_id;
+        hdr.first_seq = static_cast<const TopicMessage*>(slices[first].data)->global_seq;
+        hdr.count = static_cast<uint16_t>(i - first);
+        hdr.reserved = 0;
+
+        struct iovec iov[2];
+        iov[0].iov_base = &hdr;
+        iov[0].iov_len = sizeof(hdr);
+        iov[1].iov_base = const_cast<void*>(slices[first].data);
+        iov[1].iov_len = used - sizeof(hdr);
+        if (_mcast->trySendv(iov, 2)) {
+            _mcast_datagrams++;
+        } else {
+            _mcast_drops++;
         }
     }
-    for(auto&ci:send_list)
-        if(ci->bev) bufferevent_write(ci->bev,msg_buffer.data(), msg_size);
-    // return new_global_seq;
 }
 
-void SimplePublisherV2::enqueue_return_client(std::shared_ptr<ClientInfo> ci) {
-    {
-        std::lock_guard<std::mutex> g(_main_return_mu);
-        _main_return_q.push(ci);
+// count=0 datagram: first_seq 는 다음에 발행될 global sequence
+void SimplePublisherV2::send_multicast_heartbeat() {
+    MulticastHeader hdr;
+    hdr.magic = MAGIC_MCAST_DATA;
+    hdr.publisher_id = _publisher_id;
+    hdr.first_seq = get_current_sequence() + 1;
+    hdr.count = 0;
+    hdr.reserved = 0;
+    if (!_mcast->trySend(&hdr, sizeof(hdr))) {
+        _mcast_drops++;
     }
-    char c='b'; write(_main_notify_pipe[1],&c,1);
 }
 
-void read_callback(bufferevent*bev,void*ctx) {
-    std::cout << "READ CALL BACK TEST FUNCTION" << std::endl;
-}
+void SimplePublisherV2::publish_batch(const PublishItem* items, size_t count) {
+    if (!_publisher_sequence_record || !_db) {
+        std::cerr << "Publisher sequence record or _db not initialized" << std::endl;
+        std::cerr << "Publisher not properly initialized - EARLY RETURN!" << std::endl;
+        return;
+    }
+    if (count == 0) return;
+    if (_standby) {
+        // 복제 중에는 primary 가 같은 seq 를 매겨 보내므로 자체 발행은 버림
+        _standby_dropped.inc(count);
+        return;
+    }
 
-// accept
-void SimplePublisherV2::static_accept_cb(evconnlistener*,evutil_socket_t fd,sockaddr*,int,void*ptr){
-    std::cout << "SimplePublisherV2::static_accept_cb called with fd=" << fd << std::endl;
-    auto*self=(SimplePublisherV2*)ptr; 
-    std::cout << "ID:" << self->_publisher_id << " name:" << self->_publisher_name << std::endl;
-    self->on_accept(fd);
-}
+    uint64_t t_start = _latency ? latency_now_ns() : 0;
 
-void SimplePublisherV2::on_accept(evutil_socket_t fd){
-    std::cout << "SimplePublisherV2::on_accept called with fd=" << fd << std::endl;
-    std::cout << "ID:" << _publisher_id << " name:" << _publisher_name << std::endl;
+    // 1. Create TopicMessages back-to-back in one pooled buffer (한 번만 복사)
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; ++i) total_size += sizeof(TopicMessage) + items[i].size;
 
-    auto bev=bufferevent_socket_new(_main_base,fd,BEV_OPT_CLOSE_ON_FREE);
-    if (!bev) {
-        std::cerr << "Failed to create bufferevent for fd=" << fd << std::endl;
-        close(fd);
+    MessageBuffer* msg_buf = _msg_pool.acquire(total_size);
+    if (!msg_buf) {
+        std::cerr << "Failed to allocate message buffer" << std::endl;
         return;
     }
-    std::cout << "Created bufferevent successfully" << std::endl;
-
-    auto ci=std::make_shared<ClientInfo>();
-    ci->fd=fd; ci->bev=bev; ci->parent=(void*)this;
-    auto*ctx=new std::pair<SimplePublisherV2*,std::shared_ptr<ClientInfo>>(this,ci);
-
-    bufferevent_setcb(bev,static_read_cb,nullptr,static_event_cb,ctx);
-    std::cout << "Set bufferevent callbacks" << std::endl;
 
-    // 버퍼 크기 설정 및 즉시 읽기 활성화
-    // bufferevent_setwatermark(bev, EV_READ, 1, 0);  // 1바이트만 와도 콜백 호출
-    bufferevent_enable(bev,EV_READ|EV_WRITE);
-    std::cout << "Enabled bufferevent for EV_READ|EV_WRITE with low watermark" << std::endl;
+    // 2. Reserve contiguous global/topic sequences in publisher_sequence_record
+    uint32_t first_global_seq = _publisher_sequence_record->all_topics_sequence + 1;
+    uint64_t timestamp = get_current_timestamp();
+    uint32_t batch_topics = 0;
+    int batch_slot = TopicRegistry::global().slot(items[0].topic);
+    _batch_slices.clear();
+
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        DataTopic topic = items[i].topic;
+        uint32_t new_topic_seq = _topic_sequences.get(topic) + 1;
+        uint32_t new_global_seq = first_global_seq + static_cast<uint32_t>(i);
+        _topic_sequences.set(new_global_seq, topic, new_topic_seq);
+
+        TopicMessage* topic_msg = reinterpret_cast<TopicMessage*>(msg_buf->data() + offset);
+        topic_msg->magic = MAGIC_TOPIC_MSG;
+        topic_msg->topic = topic;
+        topic_msg->global_seq = new_global_seq;
+        topic_msg->topic_seq = new_topic_seq;
+        topic_msg->timestamp = timestamp;
+        topic_msg->data_size = static_cast<uint32_t>(items[i].size);
+        memcpy(topic_msg->data, items[i].data, items[i].size);
+
+        size_t msg_size = sizeof(TopicMessage) + items[i].size;
+        _batch_slices.push_back(MessageSlice{topic_msg, msg_size});
+        batch_topics |= topic_group(topic);
+        if (topic != items[0].topic) batch_slot = -1;
+        offset += msg_size;
+    }
 
-    {std::lock_guard<std::mutex>g(_clients_mu);_clients[fd]=ci;}
-    std::cout<<"Client fd="<<fd<<" connected and ready to receive data\n";
+    deliver_batch(msg_buf, first_global_seq, batch_topics, batch_slot, t_start);
 }
 
-// read
-void SimplePublisherV2::static_read_cb(bufferevent*bev,void*ctx){
-    std::cout << "\n\n*** STATIC_READ_CB CALLED - DATA RECEIVED ***" << std::endl;
-    auto pairptr=(std::pair<SimplePublisherV2*,std::shared_ptr<ClientInfo>>*)ctx;
-    if (!pairptr) {
-        std::cerr << "ERROR: Invalid context in static_read_cb" << std::endl;
+void SimplePublisherV2::republish_batch(const MessageSlice* messages, size_t count) {
+    if (!_publisher_sequence_record || !_db) {
+        std::cerr << "Publisher sequence record or _db not initialized" << std::endl;
         return;
     }
-    std::cout << "Context valid, calling on_read..." << std::endl;
-    pairptr->first->on_read(bev,pairptr->second);
-    std::cout << "*** STATIC_READ_CB FINISHED ***\n" << std::endl;
+    if (count == 0) return;
+
+    uint64_t t_start = _latency ? latency_now_ns() : 0;
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; ++i) total_size += messages[i].size;
+    MessageBuffer* msg_buf = _msg_pool.acquire(total_size);
+    if (!msg_buf) {
+        std::cerr << "Failed to allocate message buffer" << std::endl;
+        return;
+    }
+
+    // 기록된 global seq 가 이 publisher 의 다음 seq 와 이어지면 그대로, 아니면 seq 만 다시 매긴다 (timestamp 는 유지)
+    uint32_t first_global_seq = _publisher_sequence_record->all_topics_sequence + 1;
+    bool keep_seq = static_cast<const TopicMessage*>(messages[0].data)->global_seq == first_global_seq;
+    if (!keep_seq && !_republish_renumber_warned) {
+        std::cerr << "republish_batch: recorded seq " << static_cast<const TopicMessage*>(messages[0].data)->global_seq
+                  << " does not follow publisher seq " << first_global_seq - 1 << ", renumbering" << std::endl;
+        _republish_renumber_warned = true;
+    }
+    uint32_t batch_topics = 0;
+    DataTopic first_topic = static_cast<const TopicMessage*>(messages[0].data)->topic;
+    int batch_slot = TopicRegistry::global().slot(first_topic);
+    _batch_slices.clear();
+
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        TopicMessage* topic_msg = reinterpret_cast<TopicMessage*>(msg_buf->data() + offset);
+        memcpy(topic_msg, messages[i].data, messages[i].size);
+        DataTopic topic = topic_msg->topic;
+        uint32_t new_global_seq = first_global_seq + static_cast<uint32_t>(i);
+        if (keep_seq && topic_msg->global_seq == new_global_seq) {
+            _topic_sequences.set(new_global_seq, topic, topic_msg->topic_seq);
+        } else {
+            keep_seq = false;
+            topic_msg->global_seq = new_global_seq;
+            topic_msg->topic_seq = _topic_sequences.get(topic) + 1;
+            _topic_sequences.set(new_global_seq, topic, topic_msg->topic_seq);
+        }
+        _batch_slices.push_back(MessageSlice{topic_msg, messages[i].size});
+        batch_topics |= topic_group(topic);
+        if (topic != first_topic) batch_slot = -1;
+        offset += messages[i].size;
+    }
+
+    deliver_batch(msg_buf, first_global_seq, batch_topics, batch_slot, t_start);
 }
-void SimplePublisherV2::on_read(bufferevent*bev,std::shared_ptr<ClientInfo>ci){
-    std::cout << " SimplePublisherV2::on_read" << std::endl;
-    auto*in=bufferevent_get_input(bev);
-    while(evbuffer_get_length(in)>0){
-        size_t len=evbuffer_get_length(in);
-        if (len < sizeof(uint32_t)) {
-            break; // Need at least 4 bytes for magic number
+
+// _batch_slices (msg_buf 안 연속 TopicMessage) 를 DB / 시퀀스 저장 / shm / multicast / 구독자로 보내고 msg_buf 반환
+void SimplePublisherV2::deliver_batch(MessageBuffer* msg_buf, uint32_t first_global_seq, uint32_t batch_topics,
+                                      int batch_slot, uint64_t t_start) {
+    size_t count = _batch_slices.size();
+    T2MA_TRACE2(publish, first_global_seq, count);
+
+    // 3. Store messages in database (같은 timestamp 구간마다 한번, publish_batch 는 batch 전체가 한 구간)
+    uint64_t t_stage = _latency ? latency_now_ns() : 0;
+    for (size_t i = 0; i < count; ) {
+        uint64_t timestamp = static_cast<const TopicMessage*>(_batch_slices[i].data)->timestamp;
+        size_t j = i + 1;
+        while (j < count && static_cast<const TopicMessage*>(_batch_slices[j].data)->timestamp == timestamp) {
+            ++j;
         }
-        uint32_t magic; evbuffer_copyout(in,&magic,sizeof(uint32_t));
-        std::cout << "magic: 0x" << std::hex << magic << std::dec << " MAGIC_SUBSCRIBE: 0x" << std::hex << MAGIC_SUBSCRIBE << std::dec << std::endl;
-        if(magic==MAGIC_SUBSCRIBE){
-            if (len >= sizeof(SubscriptionRequest)) {
-                // SubscriptionRequest *req = reinterpret_cast<SubscriptionRequest*>(data);
-                SubscriptionRequest *req = new SubscriptionRequest();
-                evbuffer_remove(in,req,sizeof(SubscriptionRequest));
-#if 0                
-                std::cout << "Received subscription request from client " << req->client_id
-                          << " topic_mask: 0x" << std::hex << req->topic_mask << std::dec << std::endl;
-                SubscriptionResponse subscription_response;
-                subscription_response.magic = MAGIC_SUB_OK;
-                subscription_response.result = 0;
-                subscription_response.approved_topics = req->topic_mask;
-                subscription_response.current_seq = 0; // TODO: Get current sequence from publisher
-
-                // Update client status and info after successful subscription
-                ci->status=CLIENT_ONLINE;
-                ci->client_id = req->client_id;
-                ci->topic_mask = req->topic_mask;
-                bufferevent_write(bev,&subscription_response,sizeof(subscription_response));
-                std::cout << "Client " << req->client_id << " status changed to ONLINE" << std::endl;
-#endif
-                handle_subscription_request(ci, req);
-                delete req;
-            } else {
-                std::cerr << "Invalid subscription request size" << std::endl;
-            }
-        }else if(magic==MAGIC_RECOVERY_REQ){
-            if (len >= sizeof(RecoveryRequest)) {
-                // RecoveryRequest* req = reinterpret_cast<RecoveryRequest*>(data);
-                RecoveryRequest *req = new RecoveryRequest();
-                evbuffer_remove(in,req,sizeof(RecoveryRequest));
-#if 0
-                std::cout << "Received recovery request from client " << req->client_id << std::endl;
+        bool stored = _db->put_batch(_batch_slices.data() + i, j - i, timestamp);
+        T2MA_TRACE3(db_put, first_global_seq + i, j - i, stored ? 1 : 0);
+        if (!stored) {
+            std::cerr << "Failed to store message in database - continuing anyway" << std::endl;
+            // Don't return here - continue to send to clients even if DB fails
+        }
+        i = j;
+    }
+    if (_latency) {
+        uint64_t t = latency_now_ns();
+        _latency->db_put.record(t - t_stage);
+        t_stage = t;
+    }
+    // 짧은 복구용 최근 메시지 캐시 (msg_buf 참조만 추가, reactor 로 넘기기 전에 넣어야 reactor 의 last_seq 까지 포함)
+    if (_hot_tail.enabled()) {
+        _hot_tail.append(msg_buf, _batch_slices.data(), count, first_global_seq);
+    }
 
-                // Send RecoveryResponse with proper target sequence
-                RecoveryResponse response;
-                response.magic = MAGIC_RECOVERY_RES;
-                response.result = 0;  // Success
-                response.start_seq = req->last_seq + 1;
-                // Capture current global sequence as recovery target (Gap-Free Recovery)
-                response.end_seq = _publisher_sequence_record ? _publisher_sequence_record->all_topics_sequence : _db->count();
-                response.total_messages = (response.end_seq >= response.start_seq) ? (response.end_seq - response.start_seq + 1) : 0;
+    // 4. Save sequence to storage (batch 단위 한번)
+    if (_sequence_storage) {
+        if (!_sequence_storage->save_sequences(*_publisher_sequence_record)) {
+            std::cerr << "Failed to save sequence to storage" << std::endl;
+        }
+    }
+    if (_latency) {
+        uint64_t t = latency_now_ns();
+        _latency->sequence_save.record(t - t_stage);
+        t_stage = t;
+    }
 
-                bufferevent_write(bev,&response,sizeof(response));
-                // std::cout << " 일단 RECOVERY 처리는 나중에... SKIIIP" << std::endl;
-                
-                ci->status=CLIENT_RECOVERING;
-                // Keep client in _clients map during recovery for pending message handling
-                // {std::lock_guard<std::mutex>g(_clients_mu);_clients.erase(ci->fd);}
-                auto*w=_workers[_rr_counter++%_workers.size()];
-                ::RecoveryTask task = {ci, response.start_seq, response.end_seq};
-                {std::lock_guard<std::mutex>qg(w->queue_mu); w->task_q.push(task);}
-                char c='r'; write(w->notify_pipe_w,&c,1);
-#endif
-                handle_recovery_request(ci, req);                
-                delete req;
-            } else {
-                std::cerr << "Invalid recovery request size" << std::endl;
+    // 5. 공유메모리 로그에 한번 기록 (shm 구독자는 각자 cursor 로 읽음)
+    if (_shm_log) {
+        for (size_t i = 0; i < count; ++i) {
+            if (!_shm_log->append(static_cast<const TopicMessage*>(_batch_slices[i].data), _batch_slices[i].size)) {
+                // 구독자는 sequence 누락으로 감지하고 socket 복구로 받는다
+                std::cerr << "Message too large for shm log: " << _batch_slices[i].size << " bytes" << std::endl;
             }
+        }
+        _shm_log->publish(first_global_seq + static_cast<uint32_t>(count) - 1);
+    }
 
-        }else{
-            std::cout << "Unknown message type: 0x" << std::hex << magic << std::dec << std::endl;
-            // Skip the unknown magic number to avoid infinite loop
-            evbuffer_drain(in, sizeof(uint32_t));
+    // 6. multicast 로 batch 를 datagram 단위로 한번 송신
+    if (_mcast) {
+        send_multicast(_batch_slices.data(), count);
+    }
+
+    std::shared_ptr<const SubscriberSnapshot> snap = std::atomic_load(&_subscriber_snapshot);
+
+    // 7. compact 구독자가 있으면 batch 를 한번 인코딩 (DB/shm/multicast/복구는 원래 형식)
+    MessageBuffer* wire_buf = nullptr;
+    if (_has_wire_codecs && snap->wire_clients > 0) {
+        wire_buf = encode_wire_batch(_batch_slices.data(), count);
+    }
+    const MessageSlice* wire_slices = wire_buf ? _wire_slices.data() : nullptr;
+
+    // 종목 필터 구독자가 있으면 메시지별 종목 index 를 batch 당 한번 계산 (클라이언트 수와 무관)
+    const int32_t* symbols = nullptr;
+    if (_symbol_index && snap->symbol_clients > 0) {
+        _batch_symbols.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            _batch_symbols[i] = _symbol_index(*static_cast<const TopicMessage*>(_batch_slices[i].data));
+        }
+        symbols = _batch_symbols.data();
+    }
+
+    // 8. I/O reactor 가 있으면 batch 참조를 각 reactor 큐로 넘긴다 (reactor 별 클라이언트 fan-out)
+    if (!_reactors.empty()) {
+        dispatch_to_reactors(msg_buf, _batch_slices.data(), count, first_global_seq, batch_topics, batch_slot,
+                             wire_buf, wire_slices, symbols);
+    }
+
+    // 9. Send messages to main base clients (스냅샷 기반, _clients_mu/ClientInfo::mu 없이 순회)
+
+    // RECOVERING 클라이언트는 스냅샷에 없음: 3 에서 DB 에 기록된 메시지를 복구 cursor 로 이어서 받는다
+
+    // 한 group batch(일반적인 publish)는 group 목록 + 필터 클라이언트만 순회,
+    // 한 토픽 batch 면 필터 클라이언트도 그 토픽을 고른 목록만 (구독자 / 토픽 수와 무관하게 관심 있는 클라이언트만)
+    int slot = SubscriberSnapshot::topic_slot(static_cast<DataTopic>(batch_topics));
+    const std::vector<SubscriberEntry>& targets = (slot >= 0) ? snap->by_topic[slot] : snap->online;
+    const std::vector<SubscriberEntry>* filtered = nullptr;
+    if (slot >= 0) {
+        filtered = (batch_slot < 0) ? &snap->filtered :
+                   (static_cast<size_t>(batch_slot) < snap->by_filter.size()) ? &snap->by_filter[batch_slot] : nullptr;
+    }
+
+    for(auto& e : targets) {
+        if(!(e.topic_mask & batch_topics)) continue;
+        fan_out_client(e.client, e.topic_mask, e.conflate_mask, e.topic_filter.get(), msg_buf, _batch_slices.data(), count,
+                       first_global_seq, batch_topics, wire_buf, wire_slices, symbols);
+    }
+    if (filtered) {
+        for(auto& e : *filtered) {
+            if(!(e.topic_mask & batch_topics)) continue;
+            fan_out_client(e.client, e.topic_mask, e.conflate_mask, e.topic_filter.get(), msg_buf, _batch_slices.data(), count,
+                           first_global_seq, batch_topics, wire_buf, wire_slices, symbols);
         }
     }
+    _msg_pool.release(msg_buf);
+    if (wire_buf) _msg_pool.release(wire_buf);
+    if (_latency) {
+        uint64_t t = latency_now_ns();
+        _latency->fan_out.record(t - t_stage);
+        _latency->batch.record(t - t_start);
+    }
 }
 
-// event
-void SimplePublisherV2::static_event_cb(bufferevent*bev,short ev,void*ctx){
-    auto pairptr=(std::pair<SimplePublisherV2*,std::shared_ptr<ClientInfo>>*)ctx;
-    auto*self=pairptr->first; auto ci=pairptr->second;
-    if(ev&(BEV_EVENT_ERROR|BEV_EVENT_EOF)){
-        self->on_client_disconnect(ci); delete pairptr;
+void SimplePublisherV2::add_wire_layout(DataTopic topic, std::shared_ptr<RecordLayout> layout) {
+    int slot = TopicRegistry::global().slot(topic);
+    if (slot < 0 || !layout || layout->getRecordSize() <= 0) {
+        std::cerr << "add_wire_layout: invalid topic or layout" << std::endl;
+        return;
     }
+    if (_wire_codecs.size() <= static_cast<size_t>(slot)) _wire_codecs.resize(slot + 1);
+    _wire_codecs[slot].push_back(std::make_shared<const WireCodec>(layout));
+    _has_wire_codecs = true;
+    std::cout << "Wire layout " << layout->getRecordType() << " (" << layout->getRecordSize()
+              << " bytes) registered for topic " << static_cast<uint32_t>(topic) << std::endl;
 }
-void SimplePublisherV2::on_client_disconnect(std::shared_ptr<ClientInfo>ci){
-    {std::lock_guard<std::mutex>g(_clients_mu);_clients.erase(ci->fd);}
-    if(ci->bev){bufferevent_free(ci->bev); ci->bev=nullptr;}
+
+const WireCodec* SimplePublisherV2::find_wire_codec(uint32_t topic, size_t size) const {
+    int slot = TopicRegistry::global().slot(topic);
+    if (slot < 0 || static_cast<size_t>(slot) >= _wire_codecs.size()) return nullptr;
+    for (const auto& codec : _wire_codecs[slot]) {
+        if (static_cast<size_t>(codec->record_size()) == size) return codec.get();
+    }
+    return nullptr;
 }
 
-// main_notify_cb
-void SimplePublisherV2::main_notify_cb(evutil_socket_t fd){
-    std::cout << "SimplePublisherV2::main_notify_cb .. back to main_base" << std::endl;
-    char buf[16]; read(fd,buf,sizeof(buf));
+MessageBuffer* SimplePublisherV2::encode_wire_batch(const MessageSlice* slices, size_t count) {
+    size_t total_size = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const TopicMessage* m = static_cast<const TopicMessage*>(slices[i].data);
+        const WireCodec* codec = find_wire_codec(m->topic, m->data_size);
+        total_size += sizeof(TopicMessage) + (codec ? std::max(codec->max_encoded_size(), static_cast<size_t>(m->data_size))
+                                                    : m->data_size);
+    }
+    MessageBuffer* wire_buf = _msg_pool.acquire(total_size);
+    if (!wire_buf) return nullptr;
+
+    _wire_slices.clear();
+    size_t offset = 0;
+    for (size_t i = 0; i < count; ++i) {
+        const TopicMessage* m = static_cast<const TopicMessage*>(slices[i].data);
+        TopicMessage* w = reinterpret_cast<TopicMessage*>(wire_buf->data() + offset);
+        const WireCodec* codec = find_wire_codec(m->topic, m->data_size);
+        // sizeof(TopicMessage) 는 data 뒤 padding 까지 덮으므로 header 를 먼저 복사
+        memcpy(w, m, sizeof(TopicMessage));
+        size_t encoded = codec ? codec->encode(m->data, m->data_size, w->data, codec->max_encoded_size()) : 0;
+        if (encoded > 0 && encoded < m->data_size) {
+            w->magic = MAGIC_TOPIC_WIRE;
+            w->data_size = static_cast<uint32_t>(encoded);
+            _wire_encoded++;
+            _wire_bytes_saved.inc(m->data_size - encoded);
+        } else {
+            memcpy(w, m, slices[i].size);
+        }
+        size_t msg_size = sizeof(TopicMessage) + w->data_size;
+        _wire_slices.push_back(MessageSlice{w, msg_size});
+        offset += msg_size;
+    }
+    wire_buf->size = offset;
+    return wire_buf;
+}
+
+// 각 클라이언트 output evbuffer에는 참조만 추가 (drain 시 풀로 반환)
+void SimplePublisherV2::fan_out_client(const std::shared_ptr<ClientInfo>& ci, uint32_t topic_mask, uint32_t conflate_mask,
+                                       const TopicFilter* topic_filter, MessageBuffer* msg_buf, const MessageSlice* slices, size_t count,
+                                       uint32_t first_global_seq, uint32_t batch_topics,
+                                       MessageBuffer* wire_buf, const MessageSlice* wire_slices, const int32_t* symbols) {
+    bufferevent* bev = ci->bev;
+    if(!bev) return;
+    evbuffer* out = bufferevent_get_output(bev);
+    if(ci->high_watermark > 0 &&
+       apply_backpressure(ci, out, slices, count, first_global_seq, symbols)) {
+        return;
+    }
+    const SymbolFilter* symbol_filter = symbols ? ci->symbol_filter.get() : nullptr;
+    uint32_t send_mask = topic_mask;
+    if(conflate_mask & batch_topics) {
+        // 보관 중인 최신값이 없고 socket 이 비어있으면 그대로 보내고, 아니면 key 별 최신값만 남긴다
+        if(ci->conflate_interval_ms > 0 || ci->conflate_flush_armed || evbuffer_get_length(out) > 0) {
+            conflate_messages(ci, slices, count, conflate_mask, symbols);
+            arm_conflation_flush(ci);
+            send_mask &= ~conflate_mask;
+            if(!(send_mask & batch_topics)) return;
+        }
+    }
+    if(wire_buf && ci->wire_encoding == WIRE_ENCODING_COMPACT) {
+        msg_buf = wire_buf;
+        slices = wire_slices;
+    }
+    uint64_t now = 0;
+    if(_coalesce_delay_ns > 0) {
+        now = get_current_timestamp();
+        coalesce_before_write(ci, out, now);
+    }
+    if(!topic_filter && !symbol_filter && (send_mask & batch_topics) == batch_topics) {
+        // batch 전체를 구독 - 연속 구간 하나로 추가
+        if(_msg_pool.add_to_evbuffer(out, msg_buf) != 0) {
+            bufferevent_write(bev, msg_buf->data(), msg_buf->size);
+        }
+        _messages_sent.inc(count);
+        if(_coalesce_delay_ns > 0) coalesce_after_write(ci, out, now);
+        return;
+    }
+    // 일부 토픽만 구독 - 연속된 구독 메시지들을 묶어서 구간 단위로 추가 (전부 고르면 구간 하나)
+    const TopicRegistry& registry = TopicRegistry::global();
+    size_t run_start = 0, run_len = 0, pos = 0, taken = 0, skipped = 0;
+    for (size_t i = 0; i <= count; ++i) {
+        DataTopic topic = (i < count) ? static_cast<const TopicMessage*>(slices[i].data)->topic : DataTopic::ALL_TOPICS;
+        bool take = (i < count) && is_topic_subscribed(send_mask, topic) &&
+                    (!topic_filter || topic_filter->has(registry.slot(topic)));
+        if (take && symbol_filter && symbols[i] >= 0 && !symbol_filter->has(symbols[i])) {
+            take = false;
+            skipped++;
+        }
+        if (take) {
+            if (run_len == 0) run_start = pos;
+            run_len += slices[i].size;
+            taken++;
+        } else if (run_len > 0) {
+            if(_msg_pool.add_to_evbuffer(out, msg_buf, run_start, run_len) != 0) {
+                bufferevent_write(bev, msg_buf->data() + run_start, run_len);
+            }
+            run_len = 0;
+        }
+        if (i < count) pos += slices[i].size;
+    }
+    _messages_sent.inc(taken);
+    if (skipped) _symbol_filtered.inc(skipped);
+    if (_coalesce_delay_ns > 0) coalesce_after_write(ci, out, now);
+}
+
+void SimplePublisherV2::coalesce_before_write(const std::shared_ptr<ClientInfo>& ci, evbuffer* out, uint64_t now) {
+    // 조용한 구간 (직전 송신 후 max_delay 경과) 이나 이미 flush_bytes 이상 밀려 있으면 원래대로 바로 송신
+    if (ci->write_held || now - ci->last_write_release >= _coalesce_delay_ns ||
+        evbuffer_get_length(out) >= _coalesce_flush_bytes) {
+        return;
+    }
+    // 쓰기 전에 꺼야 outbuf callback 이 write event 를 등록하지 않는다 (output 이 비어 있으면 event 도 없어 syscall 없음)
+    bufferevent_disable(ci->bev, EV_WRITE);
+    ci->write_held = true;
+    ci->write_hold_since = now;
+    if (ci->coalesce_timer && event_get_base(ci->coalesce_timer) != client_base(*ci)) {
+        event_free(ci->coalesce_timer);
+        ci->coalesce_timer = nullptr;
+    }
+    if (!ci->coalesce_timer) {
+        void* ctx = nullptr;
+        bufferevent_getcb(ci->bev, nullptr, nullptr, nullptr, &ctx);
+        ci->coalesce_timer = evtimer_new(client_base(*ci), static_coalesce_timer_cb, ctx);
+    }
+    struct timeval tv = {static_cast<time_t>(_coalesce_delay_ns / 1000000000),
+                         static_cast<suseconds_t>((_coalesce_delay_ns % 1000000000) / 1000)};
+    evtimer_add(ci->coalesce_timer, &tv);
+}
+
+void SimplePublisherV2::coalesce_after_write(const std::shared_ptr<ClientInfo>& ci, evbuffer* out, uint64_t now) {
+    if (!ci->write_held) {
+        ci->last_write_release = now;
+        return;
+    }
+    _write_coalesced++;
+    if (evbuffer_get_length(out) >= _coalesce_flush_bytes || now - ci->write_hold_since >= _coalesce_delay_ns) {
+        release_write_hold(ci);
+    }
+}
+
+void SimplePublisherV2::release_write_hold(const std::shared_ptr<ClientInfo>& ci) {
+    if (!ci->write_held) return;
+    ci->write_held = false;
+    ci->last_write_release = get_current_timestamp();
+    if (ci->coalesce_timer) evtimer_del(ci->coalesce_timer);
+    if (ci->bev) bufferevent_enable(ci->bev, EV_WRITE);
+    _write_coalesce_flushes++;
+}
+
+void SimplePublisherV2::static_coalesce_timer_cb(evutil_socket_t, short, void* ctx) {
+    auto pairptr = (std::pair<SimplePublisherV2*, std::shared_ptr<ClientInfo>>*)ctx;
+    pairptr->first->release_write_hold(pairptr->second);
+}
+
+bool SimplePublisherV2::apply_backpressure(const std::shared_ptr<ClientInfo>& ci, evbuffer* out,
+                                           const MessageSlice* slices, size_t count, uint32_t first_global_seq,
+                                           const int32_t* symbols) {
+    size_t queued = evbuffer_get_length(out);
+    if (queued > ci->peak_queued_bytes) ci->peak_queued_bytes = queued;
+    if (!ci->conflating && queued < ci->high_watermark) {
+        return false;
+    }
+
+    if (!ci->conflating) {
+        ci->slow_consumer_events++;
+        _slow_consumer_events++;
+        std::cerr << "Slow consumer: client " << ci->client_id << " send queue " << queued
+                  << " bytes >= " << ci->high_watermark << std::endl;
+        switch (_slow_consumer_policy) {
+            case SLOW_CONSUMER_DISCONNECT:
+                disconnect_client(ci);
+                return true;
+            case SLOW_CONSUMER_RESYNC:
+                // 이후 batch 는 스냅샷에서 빠지고, 큐가 비면 first_global_seq 부터 DB 에서 복구
+                {
+                    std::lock_guard<std::mutex> cg(ci->mu);
+                    ci->status = CLIENT_RECOVERY_NEEDED;
+                    ci->resync_from_seq = first_global_seq;
+                }
+                rebuild_subscriber_snapshot();
+                watch_send_queue(ci, true, ci->high_watermark / 2);
+                return true;
+            case SLOW_CONSUMER_CONFLATE:
+                ci->conflating = true;
+                watch_send_queue(ci, true, ci->high_watermark / 2);
+                break;
+        }
+    }
+
+    conflate_messages(ci, slices, count, ci->topic_mask, symbols);
+    return true;
+}
+
+void SimplePublisherV2::conflate_messages(const std::shared_ptr<ClientInfo>& ci, const MessageSlice* slices, size_t count,
+                                          uint32_t topic_mask, const int32_t* symbols) {
+    const TopicFilter* filter = ci->topic_filter.get();
+    const SymbolFilter* symbol_filter = symbols ? ci->symbol_filter.get() : nullptr;
+    for (size_t i = 0; i < count; ++i) {
+        const TopicMessage* m = static_cast<const TopicMessage*>(slices[i].data);
+        if (!is_topic_subscribed(topic_mask, m->topic)) continue;
+        if (filter && !filter->has(TopicRegistry::global().slot(m->topic))) continue;
+        if (symbol_filter && symbols[i] >= 0 && !symbol_filter->has(symbols[i])) continue;
+        uint64_t key = _conflation_key ? _conflation_key(*m) : static_cast<uint64_t>(m->topic);
+        std::vector<char>& latest = ci->conflated[key];
+        if (!latest.empty()) ci->conflated_messages++;
+        const char* p = static_cast<const char*>(slices[i].data);
+        latest.assign(p, p + slices[i].size);
+    }
+}
+
+void SimplePublisherV2::flush_conflated(const std::shared_ptr<ClientInfo>& ci) {
+    if (!ci->bev || ci->conflated.empty()) {
+        ci->conflated.clear();
+        return;
+    }
+    // key 별 최신값을 global seq 순서로 전송 (구독자는 seq 건너뜀을 누락으로 보지 않음)
+    std::vector<std::vector<char>*> latest;
+    latest.reserve(ci->conflated.size());
+    for (auto& kv : ci->conflated) latest.push_back(&kv.second);
+    std::sort(latest.begin(), latest.end(), [](const std::vector<char>* a, const std::vector<char>* b) {
+        return reinterpret_cast<const TopicMessage*>(a->data())->global_seq <
+               reinterpret_cast<const TopicMessage*>(b->data())->global_seq;
+    });
+    evbuffer* out = bufferevent_get_output(ci->bev);
+    for (auto* m : latest) {
+        reinterpret_cast<TopicMessage*>(m->data())->magic = MAGIC_TOPIC_CONFLATED;
+        evbuffer_add(out, m->data(), m->size());
+    }
+    ci->conflated.clear();
+}
+
+// 복구는 DB 에서 전체 구간을 다시 보내므로 보관 중인 최신값과 flush 예약은 버린다
+void SimplePublisherV2::clear_conflated(const std::shared_ptr<ClientInfo>& ci) {
+    ci->conflated.clear();
+    ci->conflating = false;
+    ci->conflate_flush_armed = false;
+    if (ci->conflate_timer) evtimer_del(ci->conflate_timer);
+    watch_send_queue(ci, false);
+}
+
+void SimplePublisherV2::arm_conflation_flush(const std::shared_ptr<ClientInfo>& ci) {
+    // 느린 구독자 conflation 중이면 그쪽 watch 가 함께 flush
+    if (ci->conflate_flush_armed || ci->conflating || !ci->bev) return;
+    ci->conflate_flush_armed = true;
+    if (ci->conflate_interval_ms == 0) {
+        watch_send_queue(ci, true, 0);
+        return;
+    }
+    if (!ci->conflate_timer) {
+        void* ctx = nullptr;
+        bufferevent_getcb(ci->bev, nullptr, nullptr, nullptr, &ctx);
+        ci->conflate_timer = evtimer_new(client_base(*ci), static_conflate_timer_cb, ctx);
+    }
+    struct timeval tv = {static_cast<time_t>(ci->conflate_interval_ms / 1000),
+                         static_cast<suseconds_t>((ci->conflate_interval_ms % 1000) * 1000)};
+    evtimer_add(ci->conflate_timer, &tv);
+}
+
+void SimplePublisherV2::static_conflate_timer_cb(evutil_socket_t, short, void* ctx) {
+    auto pairptr = (std::pair<SimplePublisherV2*, std::shared_ptr<ClientInfo>>*)ctx;
+    auto& ci = pairptr->second;
+    if (!ci->conflate_flush_armed) return;
+    ci->conflate_flush_armed = false;
+    if (ci->status == CLIENT_ONLINE && !ci->conflating) {
+        pairptr->first->flush_conflated(ci);
+    }
+}
+
+void SimplePublisherV2::watch_send_queue(const std::shared_ptr<ClientInfo>& ci, bool enable, size_t low_watermark) {
+    if (!ci->bev) return;
+    bufferevent_data_cb read_cb;
+    bufferevent_event_cb event_cb;
+    void* ctx;
+    bufferevent_getcb(ci->bev, &read_cb, nullptr, &event_cb, &ctx);
+    bufferevent_setcb(ci->bev, read_cb, enable ? static_write_cb : nullptr, event_cb, ctx);
+    bufferevent_setwatermark(ci->bev, EV_WRITE, enable ? low_watermark : 0, 0);
+}
+
+void SimplePublisherV2::static_write_cb(bufferevent*, void* ctx) {
+    auto pairptr = (std::pair<SimplePublisherV2*, std::shared_ptr<ClientInfo>>*)ctx;
+    pairptr->first->on_send_queue_drained(pairptr->second);
+}
+
+void SimplePublisherV2::on_send_queue_drained(std::shared_ptr<ClientInfo> ci) {
+    watch_send_queue(ci, false);
+
+    if (ci->status == CLIENT_ONLINE && (ci->conflating || ci->conflate_flush_armed)) {
+        if (ci->conflating) {
+            std::cout << "Client " << ci->client_id << " send queue drained, flushing " << ci->conflated.size()
+                      << " conflated messages" << std::endl;
+        }
+        flush_conflated(ci);
+        ci->conflating = false;
+        ci->conflate_flush_armed = false;
+    }
+    if (!ci->gap_ranges.empty()) {
+        pump_gap_recovery(ci);
+    }
+
+    if (ci->status == CLIENT_RECOVERY_NEEDED && ci->resync_from_seq > 0) {
+        uint32_t last_seq = ci->resync_from_seq - 1;
+        ci->dropped_messages += get_current_sequence() - last_seq;
+        ci->resync_from_seq = 0;
+        std::cout << "Client " << ci->client_id << " send queue drained, resync from seq " << last_seq + 1 << std::endl;
+        begin_recovery(ci, last_seq);
+    }
+}
+
+void SimplePublisherV2::disconnect_client(std::shared_ptr<ClientInfo> ci) {
+    if (!ci->bev) return;
+    void* ctx = nullptr;
+    bufferevent_getcb(ci->bev, nullptr, nullptr, nullptr, &ctx);
+    on_client_disconnect(ci);
+    delete static_cast<std::pair<SimplePublisherV2*, std::shared_ptr<ClientInfo>>*>(ctx);
+}
+
+void SimplePublisherV2::set_slow_consumer_policy(SlowConsumerPolicy policy, size_t high_watermark) {
+    _slow_consumer_policy = policy;
+    _send_queue_high_watermark = high_watermark;
+    std::lock_guard<std::mutex> g(_clients_mu);
+    for (auto& kv : _clients) {
+        kv.second->high_watermark = high_watermark;
+    }
+}
+
+bool SimplePublisherV2::set_client_high_watermark(uint32_t client_id, size_t high_watermark) {
+    std::lock_guard<std::mutex> g(_clients_mu);
+    for (auto& kv : _clients) {
+        if (kv.second->client_id == client_id) {
+            kv.second->high_watermark = high_watermark;
+            return true;
+        }
+    }
+    return false;
+}
+
+std::vector<ClientQueueStats> SimplePublisherV2::get_client_queue_stats() {
+    std::vector<ClientQueueStats> stats;
+    std::lock_guard<std::mutex> g(_clients_mu);
+    for (auto& kv : _clients) {
+        auto& ci = kv.second;
+        ClientQueueStats s;
+        s.client_id = ci->client_id;
+        s.status = ci->status;
+        s.queued_bytes = ci->bev ? evbuffer_get_length(bufferevent_get_output(ci->bev)) : 0;
+        s.peak_queued_bytes = std::max(ci->peak_queued_bytes, s.queued_bytes);
+        s.high_watermark = ci->high_watermark;
+        s.dropped_messages = ci->dropped_messages;
+        s.conflated_messages = ci->conflated_messages;
+        s.slow_consumer_events = ci->slow_consumer_events;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+std::vector<ReplicaStatus> SimplePublisherV2::get_replica_status() {
+    std::vector<ReplicaStatus> stats;
+    uint32_t current = get_current_sequence();
+    uint64_t now = get_current_timestamp();
+    std::lock_guard<std::mutex> g(_clients_mu);
+    for (auto& kv : _clients) {
+        auto& ci = kv.second;
+        std::lock_guard<std::mutex> cg(ci->mu);
+        if (!ci->replica) continue;
+        ReplicaStatus s;
+        s.client_id = ci->client_id;
+        s.acked_seq = ci->replica_acked_seq;
+        s.lag = current > ci->replica_acked_seq ? current - ci->replica_acked_seq : 0;
+        s.ack_age_ms = now > ci->replica_ack_time ? (now - ci->replica_ack_time) / 1000000 : 0;
+        s.acks = ci->replica_acks;
+        stats.push_back(s);
+    }
+    return stats;
+}
+
+void SimplePublisherV2::rebuild_subscriber_snapshot_locked() {
+    auto snap = std::make_shared<SubscriberSnapshot>();
+    const TopicRegistry& registry = TopicRegistry::global();
+    for(auto& kv : _clients) {
+        auto& ci = kv.second;
+        std::lock_guard<std::mutex> cg(ci->mu);
+        if(ci->data_transport != TRANSPORT_SOCKET) continue;
+        if(ci->wire_encoding == WIRE_ENCODING_COMPACT) snap->wire_clients++;
+        if(ci->symbol_filter) snap->symbol_clients++;
+        if(ci->reactor >= 0) continue;      // 담당 reactor 가 자체 목록으로 fan-out
+        SubscriberEntry e = {ci, ci->topic_mask, ci->conflate_mask, ci->topic_filter};
+        if(ci->status == CLIENT_ONLINE) {
+            snap->online.push_back(e);
+            if(e.topic_filter) {
+                // 필터 토픽별 목록 (group 이 topic_mask 에 없는 토픽은 받지 않으므로 넣지 않음)
+                snap->filtered.push_back(e);
+                for(size_t slot = 0; slot < registry.size(); ++slot) {
+                    if(!e.topic_filter->has(static_cast<int>(slot)) ||
+                       !is_topic_subscribed(e.topic_mask, registry.info(static_cast<int>(slot)).topic)) continue;
+                    if(snap->by_filter.size() <= slot) snap->by_filter.resize(slot + 1);
+                    snap->by_filter[slot].push_back(e);
+                }
+                continue;
+            }
+            if(ci->topic_mask & DataTopic::TOPIC1) snap->by_topic[0].push_back(e);
+            if(ci->topic_mask & DataTopic::TOPIC2) snap->by_topic[1].push_back(e);
+            if(ci->topic_mask & DataTopic::MISC)   snap->by_topic[2].push_back(e);
+        }
+    }
+    std::atomic_store(&_subscriber_snapshot, std::shared_ptr<const SubscriberSnapshot>(snap));
+}
+
+void SimplePublisherV2::rebuild_subscriber_snapshot() {
+    std::lock_guard<std::mutex> g(_clients_mu);
+    rebuild_subscriber_snapshot_locked();
+}
+
+void SimplePublisherV2::enqueue_return_client(std::shared_ptr<ClientInfo> ci) {
+    {
+        std::lock_guard<std::mutex> g(_main_return_mu);
+        _main_return_q.push(ci);
+    }
+    char c='b'; write(_main_notify_pipe[1],&c,1);
+}
+
+void read_callback(bufferevent*bev,void*ctx) {
+    std::cout << "READ CALL BACK TEST FUNCTION" << std::endl;
+}
+
+// accept
+void SimplePublisherV2::static_accept_cb(evconnlistener*,evutil_socket_t fd,sockaddr*,int,void*ptr){
+    std::cout << "SimplePublisherV2::static_accept_cb called with fd=" << fd << std::endl;
+    auto*self=(SimplePublisherV2*)ptr; 
+    std::cout << "ID:" << self->_publisher_id << " name:" << self->_publisher_name << std::endl;
+    self->on_accept(fd, false);
+}
+
+void SimplePublisherV2::static_tcp_accept_cb(evconnlistener*,evutil_socket_t fd,sockaddr*,int,void*ptr){
+    static_cast<SimplePublisherV2*>(ptr)->on_accept(fd, true);
+}
+
+void SimplePublisherV2::static_reactor_accept_cb(evconnlistener*,evutil_socket_t fd,sockaddr*,int,void*ptr){
+    auto* r = static_cast<IoReactor*>(ptr);
+    static_cast<SimplePublisherV2*>(r->owner)->on_accept(fd, true, r);
+}
+
+void SimplePublisherV2::on_accept(evutil_socket_t fd, bool tcp, IoReactor* r){
+    std::cout << "SimplePublisherV2::on_accept called with fd=" << fd;
+    if (r) std::cout << " (io reactor " << r->index << ")";
+    std::cout << std::endl;
+    std::cout << "ID:" << _publisher_id << " name:" << _publisher_name << std::endl;
+
+    auto bev=bufferevent_socket_new(r ? r->base : _main_base,fd,BEV_OPT_CLOSE_ON_FREE);
+    if (!bev) {
+        std::cerr << "Failed to create bufferevent for fd=" << fd << std::endl;
+        close(fd);
+        return;
+    }
+    std::cout << "Created bufferevent successfully" << std::endl;
+    if (!_socket_profile.empty()) {
+        apply_socket_profile(fd, _socket_profile, tcp);
+        apply_bufferevent_profile(bev, _socket_profile);
+    }
+
+    auto ci=std::make_shared<ClientInfo>();
+    ci->fd=fd; ci->bev=bev; ci->parent=(void*)this;
+    ci->high_watermark=_send_queue_high_watermark;
+    if (r) {
+        // accept 한 reactor 가 담당 (구독 시 옮기지 않음), ONLINE 이 되기 전까지 fan-out 은 건너뛴다
+        ci->reactor = static_cast<int>(r->index);
+        r->clients.push_back(ci);
+        r->accepted++;
+    }
+    auto*ctx=new std::pair<SimplePublisherV2*,std::shared_ptr<ClientInfo>>(this,ci);
+
+    bufferevent_setcb(bev,static_read_cb,nullptr,static_event_cb,ctx);
+    std::cout << "Set bufferevent callbacks" << std::endl;
+
+    // 버퍼 크기 설정 및 즉시 읽기 활성화
+    // bufferevent_setwatermark(bev, EV_READ, 1, 0);  // 1바이트만 와도 콜백 호출
+    bufferevent_enable(bev,EV_READ|EV_WRITE);
+    std::cout << "Enabled bufferevent for EV_READ|EV_WRITE with low watermark" << std::endl;
+
+    {std::lock_guard<std::mutex>g(_clients_mu);_clients[fd]=ci;}
+    std::cout<<"Client fd="<<fd<<" connected and ready to receive data\n";
+}
+
+// read
+void SimplePublisherV2::static_read_cb(bufferevent*bev,void*ctx){
+    auto pairptr=(std::pair<SimplePublisherV2*,std::shared_ptr<ClientInfo>>*)ctx;
+    if (!pairptr) {
+        ALOG_ERROR("SimplePublisherV2", "Invalid context in static_read_cb");
+        return;
+    }
+    pairptr->first->on_read(bev,pairptr->second);
+}
+void SimplePublisherV2::on_read(bufferevent*bev,std::shared_ptr<ClientInfo>ci){
+    ALOG_DEBUG("SimplePublisherV2", "on_read fd=%d", ci->fd);
+    auto*in=bufferevent_get_input(bev);
+    event_base* owner_base = bufferevent_get_base(bev);
+    while(evbuffer_get_length(in)>0){
+        size_t len=evbuffer_get_length(in);
+        if (len < sizeof(uint32_t)) {
+            break; // Need at least 4 bytes for magic number
+        }
+        uint32_t magic; evbuffer_copyout(in,&magic,sizeof(uint32_t));
+        ALOG_DEBUG("SimplePublisherV2", "magic: 0x%x", magic);
+        if(magic==MAGIC_SUBSCRIBE || magic==MAGIC_SHM_SUBSCRIBE || magic==MAGIC_MCAST_SUBSCRIBE){
+            if (len >= sizeof(SubscriptionRequest)) {
+                // SubscriptionRequest *req = reinterpret_cast<SubscriptionRequest*>(data);
+                SubscriptionRequest *req = new SubscriptionRequest();
+                evbuffer_remove(in,req,sizeof(SubscriptionRequest));
+                int reactor_before = ci->reactor;
+                handle_subscription_request(ci, req);
+                delete req;
+                // reactor 로 넘어갔으면 남은 입력은 그 스레드가 이어서 처리
+                if (reactor_before < 0 && ci->reactor >= 0) break;
+            } else {
+                std::cerr << "Invalid subscription request size" << std::endl;
+            }
+        }else if(magic==MAGIC_RECOVERY_REQ){
+            if (len >= sizeof(RecoveryRequest)) {
+                // RecoveryRequest* req = reinterpret_cast<RecoveryRequest*>(data);
+                RecoveryRequest *req = new RecoveryRequest();
+                evbuffer_remove(in,req,sizeof(RecoveryRequest));
+#if 0
+                std::cout << "Received recovery request from client " << req->client_id << std::endl;
+
+                // Send RecoveryResponse with proper target sequence
+                RecoveryResponse response;
+                response.magic = MAGIC_RECOVERY_RES;
+                response.result = 0;  // Success
+                response.start_seq = req->last_seq + 1;
+                // Capture current global sequence as recovery target (Gap-Free Recovery)
+                response.end_seq = _publisher_sequence_record ? _publisher_sequence_record->all_topics_sequence : _db->count();
+                response.total_messages = (response.end_seq >= response.start_seq) ? (response.end_seq - response.start_seq + 1) : 0;
+
+                bufferevent_write(bev,&response,sizeof(response));
+                // std::cout << " 일단 RECOVERY 처리는 나중에... SKIIIP" << std::endl;
+                
+                ci->status=CLIENT_RECOVERING;
+                // Keep client in _clients map during recovery for pending message handling
+                // {std::lock_guard<std::mutex>g(_clients_mu);_clients.erase(ci->fd);}
+                auto*w=_workers[_rr_counter++%_workers.size()];
+                ::RecoveryTask task = {ci, response.start_seq, response.end_seq};
+                {std::lock_guard<std::mutex>qg(w->queue_mu); w->task_q.push(task);}
+                char c='r'; write(w->notify_pipe_w,&c,1);
+#endif
+                handle_recovery_request(ci, req);                
+                delete req;
+                // 워커로 넘어갔으면 이 스레드는 bev 를 더 만지지 않는다 (남은 입력은 돌아온 뒤 처리)
+                if (bufferevent_get_base(bev) != owner_base) break;
+            } else {
+                std::cerr << "Invalid recovery request size" << std::endl;
+            }
+
+        }else if(magic==MAGIC_GAP_RECOVERY_REQ){
+            if (len < sizeof(GapRecoveryRequest)) {
+                break;
+            }
+            GapRecoveryRequest req;
+            evbuffer_remove(in,&req,sizeof(GapRecoveryRequest));
+            handle_gap_recovery_request(ci, &req);
+        }else if(magic==MAGIC_TIME_RECOVERY_REQ){
+            if (len < sizeof(TimeRecoveryRequest)) {
+                break;
+            }
+            TimeRecoveryRequest req;
+            evbuffer_remove(in,&req,sizeof(TimeRecoveryRequest));
+            handle_time_recovery_request(ci, &req);
+            if (bufferevent_get_base(bev) != owner_base) break;
+        }else if(magic==MAGIC_TOPIC_FILTER){
+            if (len < sizeof(TopicFilterRequest)) {
+                break;
+            }
+            TopicFilterRequest header;
+            evbuffer_copyout(in,&header,sizeof(TopicFilterRequest));
+            if (header.count > TopicRegistry::MAX_TOPICS) {
+                std::cerr << "Invalid topic filter request (" << header.count << " topics)" << std::endl;
+                evbuffer_drain(in, sizeof(TopicFilterRequest));
+                continue;
+            }
+            size_t req_len = sizeof(TopicFilterRequest) + header.count * sizeof(uint32_t);
+            if (len < req_len) {
+                break;
+            }
+            MessageBufferRef buf = MessageBufferRef::acquire(req_len);
+            if (!buf) break;
+            evbuffer_remove(in, buf.data(), req_len);
+            handle_topic_filter_request(ci, reinterpret_cast<const TopicFilterRequest*>(buf.data()));
+        }else if(magic==MAGIC_SYMBOL_FILTER){
+            if (len < sizeof(SymbolFilterRequest)) {
+                break;
+            }
+            SymbolFilterRequest header;
+            evbuffer_copyout(in,&header,sizeof(SymbolFilterRequest));
+            if (header.count > MAX_SYMBOL_FILTER) {
+                std::cerr << "Invalid symbol filter request (" << header.count << " symbols)" << std::endl;
+                evbuffer_drain(in, sizeof(SymbolFilterRequest));
+                continue;
+            }
+            size_t req_len = sizeof(SymbolFilterRequest) + header.count * SYMBOL_KEY_SIZE;
+            if (len < req_len) {
+                break;
+            }
+            MessageBufferRef buf = MessageBufferRef::acquire(req_len);
+            if (!buf) break;
+            evbuffer_remove(in, buf.data(), req_len);
+            handle_symbol_filter_request(ci, reinterpret_cast<const SymbolFilterRequest*>(buf.data()));
+        }else if(magic==MAGIC_REPLICA_ACK){
+            if (len < sizeof(ReplicaAck)) {
+                break;
+            }
+            ReplicaAck ack;
+            evbuffer_remove(in,&ack,sizeof(ReplicaAck));
+            handle_replica_ack(ci, &ack);
+        }else if(magic==MAGIC_RANGE_FETCH_REQ){
+            if (len < sizeof(RangeFetchRequest)) {
+                break;
+            }
+            RangeFetchRequest req;
+            evbuffer_remove(in,&req,sizeof(RangeFetchRequest));
+            handle_range_fetch_request(ci, &req);
+            // 워커로 넘어갔으면 남은 입력은 돌아온 뒤 처리
+            if (ci->status == CLIENT_RECOVERING) break;
+        }else{
+            std::cout << "Unknown message type: 0x" << std::hex << magic << std::dec << std::endl;
+            // Skip the unknown magic number to avoid infinite loop
+            evbuffer_drain(in, sizeof(uint32_t));
+        }
+    }
+}
+
+// event
+void SimplePublisherV2::static_event_cb(bufferevent*bev,short ev,void*ctx){
+    auto pairptr=(std::pair<SimplePublisherV2*,std::shared_ptr<ClientInfo>>*)ctx;
+    auto*self=pairptr->first; auto ci=pairptr->second;
+    if(ev&(BEV_EVENT_ERROR|BEV_EVENT_EOF)){
+        self->on_client_disconnect(ci); delete pairptr;
+    }
+}
+void SimplePublisherV2::on_client_disconnect(std::shared_ptr<ClientInfo>ci){
+    {std::lock_guard<std::mutex>g(_clients_mu);_clients.erase(ci->fd);rebuild_subscriber_snapshot_locked();}
+    {
+        // 복구 중 끊김 (워커 스레드): 워커 부하에서 빼고, throttled 목록의 항목은 bev 가 없으면 버려진다
+        std::lock_guard<std::mutex> g(ci->mu);
+        if (ci->recovery_worker) {
+            static_cast<RecoveryWorker*>(ci->recovery_worker)->active--;
+            ci->recovery_worker = nullptr;
+        }
+    }
+    if(ci->conflate_timer){event_free(ci->conflate_timer); ci->conflate_timer=nullptr;}
+    if(ci->coalesce_timer){event_free(ci->coalesce_timer); ci->coalesce_timer=nullptr;}
+    if(ci->bev){bufferevent_free(ci->bev); ci->bev=nullptr;}
+}
+
+// main_notify_cb
+void SimplePublisherV2::main_notify_cb(evutil_socket_t fd){
+    std::cout << "SimplePublisherV2::main_notify_cb .. back to main_base" << std::endl;
+    char buf[16]; read(fd,buf,sizeof(buf));
     std::vector<std::shared_ptr<ClientInfo>>list;
     {std::lock_guard<std::mutex>g(_main_return_mu);
     while(!_main_return_q.empty()){list.push_back(_main_return_q.front());_main_return_q.pop();}}
+    // 워커가 넘긴 cursor 부터 현재 발행 seq 까지 DB 에서 전송 (publish 와 같은 스레드이므로 누락/중복 없음)
+    uint32_t live_seq = _publisher_sequence_record ? _publisher_sequence_record->all_topics_sequence : _db->max_seq();
     for(auto&ci:list){
-        if(ci->bev){
-            bufferevent_disable(ci->bev,EV_READ|EV_WRITE);
-            bufferevent_base_set(_main_base,ci->bev);
-            bufferevent_enable(ci->bev,EV_READ|EV_WRITE);
+        if(ci->reactor >= 0 && static_cast<size_t>(ci->reactor) < _reactors.size()) {
+            // reactor 클라이언트는 담당 reactor 가 자신의 last_seq 까지 이어 보낸다 (워커가 bev 를 멈춰 둔 상태)
+            adopt_on_reactor(ci);
+            continue;
+        }
+        uint32_t tail_sent = resume_client(ci, live_seq);
+        std::cout<<"Client "<<ci->fd<<" back to main base (" << tail_sent << " live messages from db)\n";
+    }
+}
+
+uint32_t SimplePublisherV2::resume_client(std::shared_ptr<ClientInfo> ci, uint32_t live_seq) {
+    bool deferred = false;
+    RecoveryRequest deferred_req;
+    if(ci->bev){
+        bufferevent_enable(ci->bev,EV_READ|EV_WRITE);
+    }
+    if (ci->recovery_end_seq > 0) {
+        // RangeFetchRequest 연결: live 꼬리 없이 구독 전 상태로 되돌리고 다음 구간 요청을 기다린다
+        {
+            std::lock_guard<std::mutex> g(ci->mu);
+            ci->recovery_end_seq = 0;
+            ci->recovery_next_seq = 0;
+            ci->recovery_worker = nullptr;
+            ci->status = CLIENT_CONNECTED;
+        }
+        if (ci->bev && evbuffer_get_length(bufferevent_get_input(ci->bev)) > 0) {
+            on_read(ci->bev, ci);
+        }
+        return 0;
+    }
+    uint32_t tail_sent = 0;
+    if(ci->bev && ci->recovery_next_seq > 0 && ci->recovery_next_seq <= live_seq) {
+        RecoveryFilterFn filter = recovery_filter(ci);
+        tail_sent = stream_message_range(bufferevent_get_output(ci->bev), _db.get(), ci->recovery_next_seq, live_seq,
+                                         nullptr, filter ? &filter : nullptr);
+    }
+    {
+        std::lock_guard<std::mutex> g(ci->mu);
+        ci->recovery_next_seq = 0;
+        ci->recovery_worker = nullptr;
+        ci->status=CLIENT_ONLINE;
+        if (ci->recovery_deferred) {
+            deferred = true;
+            ci->recovery_deferred = false;
+            deferred_req.magic = MAGIC_RECOVERY_REQ;
+            deferred_req.client_id = ci->client_id;
+            deferred_req.topic_mask = ci->topic_mask;
+            deferred_req.last_seq = ci->deferred_recovery_seq;
+            deferred_req.compression = ci->recovery_compression;
+        }
+    }
+    //  Recovery 시작 시 _clients에서 제거하지 않도록 수정했지만, 안전성을 위해 명시적으로 다시 추가
+    if(ci->bev){std::lock_guard<std::mutex>g(_clients_mu);_clients[ci->fd]=ci;rebuild_subscriber_snapshot_locked();}
+    if (deferred && ci->bev) {
+        handle_recovery_request(ci, &deferred_req);
+    }
+    return tail_sent;
+}
+
+// -----------------------------
+// I/O reactor
+// -----------------------------
+void SimplePublisherV2::set_io_reactors(size_t count, const std::vector<int>& cpus) {
+    if (!_reactors.empty()) {
+        std::cerr << "set_io_reactors must be called before start()" << std::endl;
+        return;
+    }
+    _reactor_count = count;
+    _reactor_cpus = cpus;
+}
+
+void SimplePublisherV2::set_recovery_cpus(const std::vector<int>& cpus) {
+    if (!_workers.empty()) {
+        std::cerr << "set_recovery_cpus must be called before start()" << std::endl;
+        return;
+    }
+    _recovery_cpus = cpus;
+}
+
+void SimplePublisherV2::start_io_reactors() {
+    for (size_t i = 0; i < _reactor_count; ++i) {
+        auto* r = new IoReactor(REACTOR_QUEUE_CAPACITY);
+        r->index = i;
+        r->owner = this;
+        r->cpu = _reactor_cpus.empty() ? -1 : _reactor_cpus[i % _reactor_cpus.size()];
+        r->base = event_base_new();
+        r->notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (!r->base || r->notify_fd < 0) {
+            std::cerr << "Failed to create io reactor " << i << ": " << strerror(errno) << std::endl;
+            if (r->base) event_base_free(r->base);
+            if (r->notify_fd >= 0) close(r->notify_fd);
+            delete r;
+            break;
+        }
+        r->notify_event = event_new(r->base, r->notify_fd, EV_READ | EV_PERSIST,
+                                    [](evutil_socket_t, short, void* arg){
+                                        auto* reactor = static_cast<IoReactor*>(arg);
+                                        static_cast<SimplePublisherV2*>(reactor->owner)->reactor_notify_cb(reactor);
+                                    }, r);
+        event_add(r->notify_event, nullptr);
+        if (_tcp_reactor_acceptors && (!_use_unix || _listen_both)) {
+            // 스레드 시작 전에 등록 (base 를 다른 스레드에서 건드리지 않도록)
+            r->listener = bind_listener(r->base, true, true, static_reactor_accept_cb, r);
+            if (!r->listener) {
+                std::cerr << "Failed to create TCP acceptor on io reactor " << i << ": " << strerror(errno) << std::endl;
+            }
         }
-        {
-            std::lock_guard<std::mutex> g(ci->mu);
-            while(!ci->pending_messages.empty()){
-                auto &m=ci->pending_messages.front();
-                if(ci->bev) bufferevent_write(ci->bev,m.data.data(),m.data.size());
-                std::cout << "SENT Published: [" << topic_to_string(m.topic) << "] " << std::string(m.data.data(), m.data.size()) << std::endl;
-                ci->pending_messages.pop();
+        r->last_seq = get_current_sequence();
+        r->th = std::thread([r](){ event_base_dispatch(r->base); });
+        if (r->cpu >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(r->cpu, &cpuset);
+            int rc = pthread_setaffinity_np(r->th.native_handle(), sizeof(cpuset), &cpuset);
+            if (rc != 0) {
+                std::cerr << "Failed to pin io reactor " << i << " to cpu " << r->cpu << ": " << strerror(rc) << std::endl;
             }
-            ci->status=CLIENT_ONLINE;
         }
-        //  Recovery 시작 시 _clients에서 제거하지 않도록 수정했지만, 안전성을 위해 명시적으로 다시 추가
-        {std::lock_guard<std::mutex>g(_clients_mu);_clients[ci->fd]=ci;}
-        std::cout<<"Client "<<ci->fd<<" back to main base (flushed)\n";
+        _reactors.push_back(r);
+    }
+    if (!_reactors.empty()) {
+        std::cout << "Started " << _reactors.size() << " io reactors for subscriber fan-out" << std::endl;
+    }
+}
+
+// 스레드는 stop() 에서 먼저 join 된 상태, 큐에 남은 batch 참조 반환 후 base 해제
+void SimplePublisherV2::stop_io_reactors() {
+    for (auto r : _reactors) {
+        if (r->th.joinable()) r->th.join();
+        ReactorItem item;
+        while (r->queue.try_pop(item)) {
+            if (item.batch) release_fanout_batch(item.batch);
+            item = ReactorItem();
+        }
+        r->clients.clear();
+        if (r->listener) evconnlistener_free(r->listener);
+        if (r->notify_event) event_free(r->notify_event);
+        close(r->notify_fd);
+        if (r->base) event_base_free(r->base);
+        delete r;
+    }
+    _reactors.clear();
+}
+
+std::vector<uint64_t> SimplePublisherV2::get_reactor_accept_counts() const {
+    std::vector<uint64_t> counts;
+    for (auto r : _reactors) {
+        if (r->listener) counts.push_back(r->accepted.load());
+    }
+    return counts;
+}
+
+event_base* SimplePublisherV2::client_base(const ClientInfo& ci) const {
+    if (ci.reactor >= 0 && static_cast<size_t>(ci.reactor) < _reactors.size()) {
+        return _reactors[ci.reactor]->base;
+    }
+    return _main_base;
+}
+
+void SimplePublisherV2::hand_off_bufferevent(bufferevent* bev, event_base* to) {
+    // disable 로 지금 base 에서 event_del (이 스레드 base), base_set 은 pending 이 아닌 event 의 base 만 바꾼다
+    bufferevent_disable(bev, EV_READ | EV_WRITE);
+    if (bufferevent_get_base(bev) != to && bufferevent_base_set(to, bev) < 0) {
+        std::cerr << "Failed to hand off bufferevent to another event base" << std::endl;
+    }
+}
+
+// 모든 reactor 에 넣는다 (담당 클라이언트가 없어도 last_seq 를 맞추기 위해)
+void SimplePublisherV2::dispatch_to_reactors(MessageBuffer* msg_buf, const MessageSlice* slices, size_t count,
+                                             uint32_t first_global_seq, uint32_t batch_topics, int batch_slot,
+                                             MessageBuffer* wire_buf, const MessageSlice* wire_slices,
+                                             const int32_t* symbols) {
+    auto* b = new FanoutBatch;
+    _msg_pool.add_ref(msg_buf);
+    b->buf = msg_buf;
+    b->slices.assign(slices, slices + count);
+    if (wire_buf) {
+        _msg_pool.add_ref(wire_buf);
+        b->wire_buf = wire_buf;
+        b->wire_slices.assign(wire_slices, wire_slices + count);
+    }
+    b->first_global_seq = first_global_seq;
+    b->batch_topics = batch_topics;
+    b->batch_slot = batch_slot;
+    if (symbols) b->symbols.assign(symbols, symbols + count);
+    b->pending.store(static_cast<uint32_t>(_reactors.size()));
+    for (auto r : _reactors) {
+        ReactorItem item;
+        item.batch = b;
+        push_to_reactor(r, std::move(item));
+    }
+}
+
+void SimplePublisherV2::push_to_reactor(IoReactor* r, ReactorItem&& item) {
+    // 큐가 꽉 차면 reactor 가 비울 때까지 기다린다 (batch 를 버리면 구독자에게 누락이 생김)
+    while (!r->queue.try_push(std::move(item))) {
+        std::this_thread::yield();
+    }
+    if (!r->notified.exchange(true)) {
+        uint64_t one = 1;
+        write(r->notify_fd, &one, sizeof(one));
+    }
+}
+
+// main 스레드: bev 는 이미 멈춘 상태로 넘긴다 (base 이동/enable 은 reactor 스레드에서)
+void SimplePublisherV2::adopt_on_reactor(std::shared_ptr<ClientInfo> ci) {
+    ReactorItem item;
+    item.adopt = ci;
+    push_to_reactor(_reactors[ci->reactor], std::move(item));
+}
+
+void SimplePublisherV2::reactor_notify_cb(IoReactor* r) {
+    uint64_t v;
+    read(r->notify_fd, &v, sizeof(v));
+    r->notified.exchange(false);
+    ReactorItem item;
+    size_t processed = 0;
+    while (processed < REACTOR_DRAIN_LIMIT && r->queue.try_pop(item)) {
+        if (item.batch) {
+            reactor_fan_out(r, item.batch);
+            release_fanout_batch(item.batch);
+        } else if (item.adopt) {
+            reactor_adopt(r, item.adopt);
+        }
+        item = ReactorItem();
+        ++processed;
+    }
+    // 남은 항목은 socket 이벤트를 한번 처리한 뒤 이어서
+    if (processed == REACTOR_DRAIN_LIMIT && r->queue.size_approx() > 0 && !r->notified.exchange(true)) {
+        event_active(r->notify_event, EV_READ, 0);
+    }
+}
+
+void SimplePublisherV2::reactor_fan_out(IoReactor* r, const FanoutBatch* b) {
+    size_t count = b->slices.size();
+    r->last_seq = b->first_global_seq + static_cast<uint32_t>(count) - 1;
+    r->batches++;
+    for (size_t i = 0; i < r->clients.size();) {
+        const std::shared_ptr<ClientInfo>& ci = r->clients[i];
+        if (!ci->bev) {
+            // 연결 종료된 클라이언트는 여기서 정리
+            r->clients[i] = r->clients.back();
+            r->clients.pop_back();
+            continue;
+        }
+        if (ci->status == CLIENT_ONLINE && ci->data_transport == TRANSPORT_SOCKET &&
+            (ci->topic_mask & b->batch_topics) &&
+            (!ci->topic_filter || b->batch_slot < 0 || ci->topic_filter->has(b->batch_slot))) {
+            fan_out_client(ci, ci->topic_mask, ci->conflate_mask, ci->topic_filter.get(), b->buf, b->slices.data(), count,
+                           b->first_global_seq, b->batch_topics,
+                           b->wire_buf, b->wire_buf ? b->wire_slices.data() : nullptr,
+                           b->symbols.empty() ? nullptr : b->symbols.data());
+        }
+        ++i;
+    }
+}
+
+// 큐 순서상 adopt 이전 batch 는 모두 처리했으므로 recovery cursor 부터 last_seq 까지 DB 에서 보내면 이어진다
+void SimplePublisherV2::reactor_adopt(IoReactor* r, std::shared_ptr<ClientInfo> ci) {
+    if (!ci->bev) return;
+    if (std::find(r->clients.begin(), r->clients.end(), ci) == r->clients.end()) {
+        r->clients.push_back(ci);
+    }
+    uint32_t tail_sent = resume_client(ci, r->last_seq);
+    std::cout << "Client " << ci->fd << " on io reactor " << r->index << " (" << tail_sent
+              << " live messages from db)" << std::endl;
+    // 넘어오기 전에 읽어 둔 요청 (구독 직후 보낸 복구 요청 등)
+    if (ci->bev && ci->status == CLIENT_ONLINE && evbuffer_get_length(bufferevent_get_input(ci->bev)) > 0) {
+        on_read(ci->bev, ci);
+    }
+}
+
+void SimplePublisherV2::release_fanout_batch(FanoutBatch* b) {
+    if (b->pending.fetch_sub(1) == 1) {
+        _msg_pool.release(b->buf);
+        if (b->wire_buf) _msg_pool.release(b->wire_buf);
+        delete b;
     }
 }
 
@@ -678,16 +2022,28 @@ void RecoveryWorker::on_notify(){
             return;
         }
 
-        // 태스크 큐에서 작업 가져오기
-        ::RecoveryTask t;
-        {
-            std::lock_guard<std::mutex> g(queue_mu);
-            if (task_q.empty()) {
-                return;
+        // 태스크 큐에서 작업 가져오기 (알림 여러개가 한번에 읽힐 수 있으므로 큐를 비울 때까지)
+        while (true) {
+            ::RecoveryTask t;
+            {
+                std::lock_guard<std::mutex> g(queue_mu);
+                if (task_q.empty()) {
+                    return;
+                }
+                t = task_q.front();
+                task_q.pop();
             }
-            t = task_q.front();
-            task_q.pop();
+            run_task(t);
         }
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in RecoveryWorker::on_notify(): " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unknown exception in RecoveryWorker::on_notify()" << std::endl;
+    }
+}
+
+void RecoveryWorker::run_task(const ::RecoveryTask& t){
+    try {
         std::cout << "Processing recovery task for client " << t.client->fd
                   << " seq range: " << t.from_seq << "-" << t.to_seq << std::endl;
         // 클라이언트 유효성 검사
@@ -707,127 +2063,776 @@ void RecoveryWorker::on_notify(){
         std::cout << "Processing recovery task for client " << ci->fd
                   << " seq range: " << t.from_seq << "-" << t.to_seq << std::endl;
 
-        // bufferevent를 이 워커의 event_base로 이동 (안전하게)
-        try {
-            bufferevent_disable(ci->bev, EV_READ | EV_WRITE);
-            if (bufferevent_base_set(base, ci->bev) < 0) {
-                std::cerr << "Failed to set bufferevent base for recovery worker" << std::endl;
-                return;
-            }
-            bufferevent_enable(ci->bev, EV_READ | EV_WRITE);
-        } catch (...) {
-            std::cerr << "Exception while setting up bufferevent for recovery" << std::endl;
+        // 요청을 받은 스레드가 이 워커 base 로 넘겨 두었다 (hand_off_bufferevent): 여기서는 enable 만
+        if (bufferevent_get_base(ci->bev) != base) {
+            std::cerr << "Recovery worker: bufferevent was not handed off to this worker" << std::endl;
             return;
         }
+        bufferevent_enable(ci->bev, EV_READ | EV_WRITE);
 
-        // 복구 데이터 전송
-        uint32_t to = t.to_seq;
-        if (to == 0) {
-            to = pub->db()->max_seq();
+        // 복구 데이터 전송: from_seq 부터 chunk 단위로 live head 까지 (to_seq 는 요청 시점의 목표)
+        {
+            std::lock_guard<std::mutex> g(ci->mu);
+            ci->recovery_worker = this;
+            ci->recovery_next_seq = t.from_seq;
+            ci->recovery_sent = 0;
+            ci->recovery_throttled = false;
         }
+        active++;
+        stream_next_chunk(ci);
+    } catch (const std::exception& e) {
+        std::cerr << "Exception in RecoveryWorker::run_task(): " << e.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Unknown exception in RecoveryWorker::run_task()" << std::endl;
+    }
+    
+}
 
-        uint32_t sent_count = 0;
-        SAM_INDEX index;
-        void* buffer = nullptr;
-        uint32_t buffer_size = 0;
+// -----------------------------
+// RecoveryWorker::stream_range
+// -----------------------------
+// 1) 데이터 파일 연속 구간을 지원하는 DB(DB_SAM)는 evbuffer_add_file (sendfile)로 한번에 전송
+// 2) zero-copy 포인터를 지원하는 DB(MMAP_SAM, Memory_SAM)는 인접한 메시지를 묶어 참조로 추가
+// 3) 그 외에는 get_range 콜백으로 복사 전송 (메시지별 할당 없음)
+uint32_t RecoveryWorker::stream_range(bufferevent* bev, MessageDB* db, uint32_t from_seq, uint32_t to_seq,
+                                      uint32_t compression, const RecoveryFilterFn& filter) {
+    const RecoveryFilterFn* f = filter ? &filter : nullptr;
+    if (compression != BLOCK_CODEC_NONE) {
+        return stream_compressed_range(bufferevent_get_output(bev), db, from_seq, to_seq, compression, &running, f);
+    }
+    return stream_message_range(bufferevent_get_output(bev), db, from_seq, to_seq, &running, f);
+}
 
-        for (uint32_t seq = t.from_seq; seq <= to; seq++) {
-            // 워커가 종료 중인지 확인
-            if (!running.load()) {
-                std::cout << "Recovery worker stopping, aborting recovery task" << std::endl;
-                break;
+// DB 가 지운 앞부분은 보낼 수 없으므로 남아 있는 첫 seq 로 옮긴다 (받는 쪽은 그 구간을 잃음)
+static uint32_t skip_evicted(MessageDB* db, uint32_t from_seq, uint32_t to_seq) {
+    uint32_t oldest = db->min_seq();
+    if (from_seq < oldest && from_seq <= to_seq) {
+        ALOG_WARN("RecoveryWorker", "Recovery seq %u-%u no longer in message DB, streaming from seq %u",
+                  from_seq, std::min(oldest - 1, to_seq), oldest);
+        return oldest;
+    }
+    return from_seq;
+}
+
+// TopicMessage 를 RECOVERY_BATCH_BYTES 씩 모아 압축, 줄지 않은 batch 는 TopicMessage 그대로 보낸다
+uint32_t stream_compressed_range(evbuffer* out, MessageDB* db, uint32_t from_seq, uint32_t to_seq,
+                                 uint32_t codec, const std::atomic<bool>* running, const RecoveryFilterFn* filter) {
+    from_seq = skip_evicted(db, from_seq, to_seq);
+    std::vector<char> raw;
+    MessageBufferPool& pool = MessageBufferPool::shared();
+    raw.reserve(RECOVERY_BATCH_BYTES * 2);
+    uint32_t batch_count = 0;
+    uint32_t sent_count = 0;
+    size_t stored_total = 0, raw_total = 0;
+
+    auto flush = [&]() -> bool {
+        if (batch_count == 0) return true;
+        // 압축 결과는 풀 버퍼에 쓰고 evbuffer 에는 참조로 (전송 완료 시 풀로 반환)
+        MessageBufferRef packed = MessageBufferRef::acquire(sizeof(RecoveryBatch) + block_compress_bound(raw.size()), pool);
+        if (!packed) return false;
+        size_t stored = block_compress(codec, raw.data(), raw.size(),
+                                       packed.data() + sizeof(RecoveryBatch), packed.size() - sizeof(RecoveryBatch));
+        int rc;
+        if (stored > 0) {
+            RecoveryBatch header;
+            header.magic = MAGIC_RECOVERY_BATCH;
+            header.codec = static_cast<uint16_t>(codec);
+            header.reserved = 0;
+            header.count = batch_count;
+            header.raw_size = static_cast<uint32_t>(raw.size());
+            header.stored_size = static_cast<uint32_t>(stored);
+            memcpy(packed.data(), &header, sizeof(header));
+            rc = pool.add_to_evbuffer(out, packed.get(), 0, sizeof(header) + stored);
+            stored_total += sizeof(header) + stored;
+        } else {
+            rc = evbuffer_add(out, raw.data(), raw.size());
+            stored_total += raw.size();
+        }
+        raw_total += raw.size();
+        sent_count += batch_count;
+        raw.clear();
+        batch_count = 0;
+        return rc == 0;
+    };
+
+    db->get_range(from_seq, to_seq, [&](uint32_t seq, const SAM_INDEX&, const void* data, size_t size) {
+        if (running && !running->load()) {
+            ALOG_INFO("RecoveryWorker", "Recovery worker stopping, aborting recovery task");
+            return false;
+        }
+        if (filter && !(*filter)(*static_cast<const TopicMessage*>(data))) {
+            return true;
+        }
+        const char* p = static_cast<const char*>(data);
+        raw.insert(raw.end(), p, p + size);
+        batch_count++;
+        if (raw.size() >= RECOVERY_BATCH_BYTES && !flush()) {
+            ALOG_ERROR("RecoveryWorker", "Failed to write recovery data for seq %u", seq);
+            return false;
+        }
+        return true;
+    });
+    if (!flush()) {
+        ALOG_ERROR("RecoveryWorker", "Failed to write recovery data");
+    }
+    if (raw_total > 0) {
+        ALOG_INFO("RecoveryWorker", "Recovery streamed seq %u-%u compressed (%s, %zu -> %zu bytes)",
+                  from_seq, to_seq, block_codec_name(codec), raw_total, stored_total);
+    }
+    return sent_count;
+}
+
+uint32_t stream_message_range(evbuffer* out, MessageDB* db, uint32_t from_seq, uint32_t to_seq,
+                              const std::atomic<bool>* running, const RecoveryFilterFn* filter) {
+    from_seq = skip_evicted(db, from_seq, to_seq);
+
+    // 파일 구간은 segment (SEGMENT_SAM) 경계에서 끊겨 올 수 있으므로 end_seq 다음부터 이어서 요청
+    uint32_t sent_count = 0;
+    MessageDataRegion region;
+    while (!filter && from_seq <= to_seq && db->get_data_region(from_seq, to_seq, region)) {
+        int fd = ::open(region.path.c_str(), O_RDONLY);
+        if (fd >= 0) {
+            // 성공 시 fd는 evbuffer가 소유하고 전송 완료 후 닫는다
+            if (evbuffer_add_file(out, fd, region.offset, region.length) == 0) {
+                ALOG_INFO("RecoveryWorker", "Recovery streamed file region seq %u-%u (%zu bytes)",
+                          region.start_seq, region.end_seq, static_cast<size_t>(region.length));
+                sent_count += region.end_seq - region.start_seq + 1;
+                from_seq = region.end_seq + 1;
+                continue;
             }
+            ::close(fd);
+        }
+        ALOG_WARN("RecoveryWorker", "Failed to stream file region, falling back to per message recovery");
+        break;
+    }
+    if (from_seq > to_seq) {
+        return sent_count;
+    }
 
-            try {
-                buffer = new char[4096];
-                if (pub->db()->get(seq, index, buffer, &buffer_size)) {
-                    if (buffer && buffer_size > 0) {
-                        if (bufferevent_write(ci->bev, buffer, buffer_size) == 0) {
-                            sent_count++;
-                        } else {
-                            std::cerr << "Failed to write recovery data for seq " << seq << std::endl;
-                            break;
-                        }
-                    }
-                } else {
-                    std::cout << "No data found for sequence " << seq << std::endl;
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "Exception while sending recovery data for seq " << seq << ": " << e.what() << std::endl;
-                break;
+    SAM_INDEX index;
+    if (db->get_direct(from_seq, index)) {
+        const char* run_ptr = nullptr;
+        size_t run_len = 0;
+        uint32_t seq = from_seq;
+        for (; seq <= to_seq && (!running || running->load()); ++seq) {
+            const char* p = static_cast<const char*>(db->get_direct(seq, index));
+            if (!p) {
+                break;  // 직접 참조할 수 없는 구간 (write-behind tail 등) 부터는 get_range 로
+            }
+            if (filter && !(*filter)(*reinterpret_cast<const TopicMessage*>(p))) {
+                continue;   // 다음 메시지와 주소가 이어지지 않으므로 구간이 끊긴다
             }
+            if (run_ptr && run_ptr + run_len == p) {
+                run_len += index._size;
+            } else {
+                if (run_ptr) evbuffer_add_reference(out, run_ptr, run_len, nullptr, nullptr);
+                run_ptr = p;
+                run_len = index._size;
+            }
+            sent_count++;
+        }
+        if (run_ptr) evbuffer_add_reference(out, run_ptr, run_len, nullptr, nullptr);
+        if (seq > to_seq || (running && !running->load())) {
+            return sent_count;
+        }
+        from_seq = seq;
+    }
+
+    db->get_range(from_seq, to_seq, [&](uint32_t seq, const SAM_INDEX&, const void* data, size_t size) {
+        if (running && !running->load()) {
+            ALOG_INFO("RecoveryWorker", "Recovery worker stopping, aborting recovery task");
+            return false;
+        }
+        if (filter && !(*filter)(*static_cast<const TopicMessage*>(data))) {
+            return true;
         }
+        if (evbuffer_add(out, data, size) != 0) {
+            ALOG_ERROR("RecoveryWorker", "Failed to write recovery data for seq %u", seq);
+            return false;
+        }
+        sent_count++;
+        return true;
+    });
+    return sent_count;
+}
 
-        // std::cout << " 복구 테스트를 위해 10초가 지나면 종료합니다. " << std::endl;
-        // std::this_thread::sleep_for(std::chrono::seconds(10));
+// -----------------------------
+// RecoveryWorker::stream_next_chunk
+// -----------------------------
+// output 에는 최대 한 chunk 만 올려두고, low watermark 까지 비면(write callback) 다음 chunk 를 읽는다.
+// 복구 동안 발행된 메시지도 DB 에서 그대로 이어 읽으므로 복구 길이와 관계없이 메모리는 chunk 크기로 제한된다.
+// 대역폭 예산이 있으면 live 에서 먼 클라이언트는 예산이 남을 때만 chunk 를 읽고 (디스크 / 네트워크 보호),
+// 예산을 기다리는 클라이언트는 도착 순서대로 한 chunk 씩 받는다 (큰 복구 하나가 다른 복구를 굶기지 않도록).
+void RecoveryWorker::stream_next_chunk(std::shared_ptr<ClientInfo> ci, bool scheduled) {
+    if (!ci->bev || (ci->recovery_throttled && !scheduled)) return;
+    auto pub = static_cast<SimplePublisherV2*>(ci->parent);
+    MessageDB* db = pub->db();
+
+    // RangeFetchRequest 는 요청한 끝 seq 까지만 워커가 모두 보낸다 (main 으로 넘길 live 꼬리 없음)
+    bool bounded = ci->recovery_end_seq > 0;
+    uint32_t head = bounded ? std::min(db->max_seq(), ci->recovery_end_seq) : db->max_seq();
+    uint32_t next = ci->recovery_next_seq;
+    if (next < db->min_seq()) {
+        // ring DB 가 복구 중에 앞을 지웠으면 남은 곳부터 (빈 chunk 로 write callback 이 멈추지 않도록)
+        ALOG_WARN("RecoveryWorker", "Client %u recovery seq %u-%u no longer in message DB",
+                  ci->client_id, next, db->min_seq() - 1);
+        next = ci->recovery_next_seq = db->min_seq();
+    }
+    uint32_t remaining = (head >= next) ? head - next + 1 : 0;
+    if (!running.load() || remaining <= (bounded ? 0 : RECOVERY_HANDOFF_MESSAGES)) {
+        finish_recovery(ci);
+        return;
+    }
 
-        // 복구 완료 메시지 전송
-        try {
-            RecoveryComplete recovery_complete;
-            recovery_complete.magic = MAGIC_RECOVERY_CMP;
-            recovery_complete.total_sent = sent_count;
-            recovery_complete.timestamp = get_current_timestamp();
-
-            if (bufferevent_write(ci->bev, &recovery_complete, sizeof(recovery_complete)) == 0) {
-                std::cout << "Recovery complete sent for client " << ci->fd
-                          << ", total sent: " << sent_count << std::endl;
-            } else {
-                std::cerr << "Failed to send recovery complete message" << std::endl;
+    RecoveryBandwidth& bandwidth = pub->_recovery_bandwidth;
+    if (bandwidth.enabled() && remaining > pub->_recovery_priority_messages) {
+        uint64_t wait = (!scheduled && !throttled.empty()) ? RECOVERY_PACE_MIN_US : bandwidth.wait_us();
+        if (wait > 0) {
+            if (!ci->recovery_throttled) {
+                ci->recovery_throttled = true;
+                if (scheduled) throttled.push_front(ci);    // timer 차례였으면 맨 앞 자리 유지
+                else throttled.push_back(ci);
             }
-        } catch (const std::exception& e) {
-            std::cerr << "Exception while sending recovery complete: " << e.what() << std::endl;
+            pub->_recovery_throttled.inc();
+            arm_pace_timer(wait);
+            return;
         }
-        pub->enqueue_return_client(ci);
-    } catch (const std::exception& e) {
-        std::cerr << "Exception in RecoveryWorker::on_notify(): " << e.what() << std::endl;
-    } catch (...) {
-        std::cerr << "Unknown exception in RecoveryWorker::on_notify()" << std::endl;
     }
-    
+
+    uint32_t end = next + std::min(remaining, RECOVERY_CHUNK_MESSAGES) - 1;
+    evbuffer* out = bufferevent_get_output(ci->bev);
+    size_t before = evbuffer_get_length(out);
+    ci->recovery_sent += stream_range(ci->bev, db, next, end, ci->recovery_compression, pub->recovery_filter(ci));
+    ci->recovery_next_seq = end + 1;
+    size_t added = evbuffer_get_length(out) - before;
+    pub->_recovery_bytes.inc(added);
+    if (bandwidth.enabled()) bandwidth.consume(added);
+
+    bufferevent_data_cb read_cb;
+    bufferevent_event_cb event_cb;
+    void* ctx;
+    bufferevent_getcb(ci->bev, &read_cb, nullptr, &event_cb, &ctx);
+    bufferevent_setcb(ci->bev, read_cb, static_stream_cb, event_cb, ctx);
+    bufferevent_setwatermark(ci->bev, EV_WRITE, RECOVERY_LOW_WATERMARK, 0);
+}
+
+void RecoveryWorker::arm_pace_timer(uint64_t wait_us) {
+    if (!pace_timer) {
+        pace_timer = evtimer_new(base, [](evutil_socket_t, short, void* arg) {
+            static_cast<RecoveryWorker*>(arg)->on_pace_timer();
+        }, this);
+    }
+    if (evtimer_pending(pace_timer, nullptr)) return;
+    wait_us = std::min(std::max(wait_us, RECOVERY_PACE_MIN_US), RECOVERY_PACE_MAX_US);
+    struct timeval tv = {static_cast<time_t>(wait_us / 1000000), static_cast<suseconds_t>(wait_us % 1000000)};
+    evtimer_add(pace_timer, &tv);
+}
+
+void RecoveryWorker::on_pace_timer() {
+    while (!throttled.empty()) {
+        auto ci = throttled.front();
+        if (!ci->bev) {
+            throttled.pop_front();      // 기다리는 동안 끊김
+            continue;
+        }
+        auto pub = static_cast<SimplePublisherV2*>(ci->parent);
+        uint64_t wait = pub->_recovery_bandwidth.wait_us();
+        if (wait > 0) {
+            arm_pace_timer(wait);
+            return;
+        }
+        throttled.pop_front();
+        ci->recovery_throttled = false;
+        stream_next_chunk(ci, true);
+        // 아직 보낼 것이 남았으면 write callback (low watermark) 에서 다음 차례를 다시 요청한다
+    }
+}
+
+size_t RecoveryWorker::load() {
+    std::lock_guard<std::mutex> g(queue_mu);
+    return active.load() + task_q.size();
+}
+
+void RecoveryWorker::static_stream_cb(bufferevent* bev, void* ctx) {
+    (void)bev;
+    auto pairptr = (std::pair<SimplePublisherV2*, std::shared_ptr<ClientInfo>>*)ctx;
+    auto ci = pairptr->second;
+    auto w = static_cast<RecoveryWorker*>(ci->recovery_worker);
+    if (w) w->stream_next_chunk(ci);
+}
+
+// 남은 구간(RECOVERY_HANDOFF_MESSAGES 이하 + 그 사이 발행분)은 main 이 recovery_next_seq 부터 보내고 ONLINE 전환
+void RecoveryWorker::finish_recovery(std::shared_ptr<ClientInfo> ci) {
+    {
+        std::lock_guard<std::mutex> g(ci->mu);
+        if (ci->recovery_worker == this) {
+            active--;
+            ci->recovery_worker = nullptr;
+        }
+    }
+    bufferevent_data_cb read_cb;
+    bufferevent_event_cb event_cb;
+    void* ctx;
+    bufferevent_getcb(ci->bev, &read_cb, nullptr, &event_cb, &ctx);
+    bufferevent_setcb(ci->bev, read_cb, nullptr, event_cb, ctx);
+    bufferevent_setwatermark(ci->bev, EV_WRITE, 0, 0);
+
+    auto pub = static_cast<SimplePublisherV2*>(ci->parent);
+    MessageDB* db = pub->db();
+    // 워커가 보낸 마지막 seq 까지 보낸 뒤 RecoveryComplete, live 꼬리는 main 에서 이어 전송
+    uint32_t head = ci->recovery_end_seq > 0 ? std::min(db->max_seq(), ci->recovery_end_seq) : db->max_seq();
+    if (running.load() && ci->recovery_next_seq <= head) {
+        evbuffer* out = bufferevent_get_output(ci->bev);
+        size_t before = evbuffer_get_length(out);
+        ci->recovery_sent += stream_range(ci->bev, db, ci->recovery_next_seq, head, ci->recovery_compression,
+                                          pub->recovery_filter(ci));
+        ci->recovery_next_seq = head + 1;
+        size_t added = evbuffer_get_length(out) - before;
+        pub->_recovery_bytes.inc(added);
+        if (pub->_recovery_bandwidth.enabled()) pub->_recovery_bandwidth.consume(added);
+    }
+
+    T2MA_TRACE2(recovery_end, ci->client_id, ci->recovery_next_seq - 1);
+    RecoveryComplete recovery_complete;
+    recovery_complete.magic = MAGIC_RECOVERY_CMP;
+    recovery_complete.total_sent = ci->recovery_sent;
+    recovery_complete.timestamp = get_current_timestamp();
+    if (bufferevent_write(ci->bev, &recovery_complete, sizeof(recovery_complete)) == 0) {
+        std::cout << "Recovery complete sent for client " << ci->fd
+                  << ", total sent: " << ci->recovery_sent << std::endl;
+    } else {
+        std::cerr << "Failed to send recovery complete message" << std::endl;
+    }
+    // 이 스레드에서 멈추고 돌아갈 base 로 넘긴다 (main/reactor 는 자기 loop 에서 enable 만)
+    SimplePublisherV2::hand_off_bufferevent(ci->bev, pub->client_base(*ci));
+    pub->enqueue_return_client(ci);
 }
 
 void SimplePublisherV2::handle_subscription_request(std::shared_ptr<ClientInfo> ci, const SubscriptionRequest* req) {
     std::cout << "SimplePublisherV2::handle_subscription_request" << std::endl;
     std::cout << "Received subscription request from client " << req->client_id
                 << " topic_mask: 0x" << std::hex << req->topic_mask << std::dec << std::endl;
+    // shm 로그/multicast 가 없으면 일반 socket 구독으로 승인 (구독자는 result 로 구분)
+    DataTransport transport = TRANSPORT_SOCKET;
+    if (req->magic == MAGIC_SHM_SUBSCRIBE && _shm_log) {
+        transport = TRANSPORT_SHM;
+    } else if (req->magic == MAGIC_MCAST_SUBSCRIBE && _mcast) {
+        transport = TRANSPORT_MULTICAST;
+    }
     SubscriptionResponse subscription_response;
     subscription_response.magic = MAGIC_SUB_OK;
-    subscription_response.result = 0;
+    subscription_response.result = transport == TRANSPORT_SHM ? SUB_RESULT_SHM :
+                                   transport == TRANSPORT_MULTICAST ? SUB_RESULT_MCAST : SUB_RESULT_OK;
     subscription_response.approved_topics = req->topic_mask;
-    subscription_response.current_seq = 0; // TODO: Get current sequence from publisher
+    subscription_response.current_seq = get_current_sequence();
 
     // Update client status and info after successful subscription
-    ci->status=CLIENT_ONLINE;
-    ci->client_id = req->client_id;
-    ci->topic_mask = req->topic_mask;
+    bool adopt = false;
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        ci->status=CLIENT_ONLINE;
+        ci->client_id = req->client_id;
+        ci->topic_mask = req->topic_mask;
+        ci->data_transport = transport;
+        // socket fan-out 에만 적용 (shm/multicast 는 모든 메시지가 한번씩 기록됨)
+        ci->conflate_mask = (transport == TRANSPORT_SOCKET) ? (req->conflate_mask & req->topic_mask) : 0;
+        ci->conflate_interval_ms = req->conflate_interval_ms;
+        // 등록된 wire layout 이 없으면 인코딩할 것이 없으므로 일반 구독과 같다
+        ci->wire_encoding = (transport == TRANSPORT_SOCKET && _has_wire_codecs &&
+                             req->wire_encoding == WIRE_ENCODING_COMPACT) ? WIRE_ENCODING_COMPACT : WIRE_ENCODING_NONE;
+        // socket 구독자는 담당 reactor 로 옮긴다 (shm/multicast 는 제어용 socket 이라 main 에 둔다)
+        if (!_reactors.empty() && transport == TRANSPORT_SOCKET && ci->reactor < 0) {
+            ci->reactor = static_cast<int>(ci->client_id % _reactors.size());
+            adopt = true;
+        }
+    }
     bufferevent_write(ci->bev,&subscription_response,sizeof(subscription_response));
-    std::cout << "Client " << req->client_id << " status changed to ONLINE" << std::endl;
+    rebuild_subscriber_snapshot();
+    std::cout << "Client " << req->client_id << " status changed to ONLINE";
+    if (transport == TRANSPORT_SHM) std::cout << " (shm log: " << _shm_log->name() << ")";
+    if (transport == TRANSPORT_MULTICAST) std::cout << " (multicast: " << _mcast_address << ")";
+    if (ci->conflate_mask) std::cout << " (conflate topics: 0x" << std::hex << ci->conflate_mask << std::dec
+                                     << ", interval " << ci->conflate_interval_ms << "ms)";
+    if (ci->wire_encoding == WIRE_ENCODING_COMPACT) std::cout << " (compact wire encoding)";
+    if (adopt) std::cout << " (io reactor " << ci->reactor << ")";
+    std::cout << std::endl;
+    if (adopt) {
+        hand_off_bufferevent(ci->bev, client_base(*ci));
+        adopt_on_reactor(ci);
+    }
 }
 
 void SimplePublisherV2::handle_recovery_request(std::shared_ptr<ClientInfo> ci, const RecoveryRequest* req) {
     std::cout << "Received recovery request from client " << req->client_id << std::endl;
 
+    // 지원하지 않는 codec 이면 압축 없이 (구독자는 RecoveryBatch / TopicMessage 를 모두 받는다)
+    uint32_t compression = block_codec_available(req->compression) ? req->compression : static_cast<uint32_t>(BLOCK_CODEC_NONE);
+    if (compression != req->compression) {
+        std::cout << "Recovery compression " << req->compression << " not supported, sending uncompressed" << std::endl;
+    }
+    ci->recovery_compression = compression;
+
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        if (ci->status == CLIENT_RECOVERING) {
+            // multicast 구독자는 복구 완료 직후 다시 요청할 수 있음: 버리지 않고 ONLINE 복귀 시 처리
+            ci->recovery_deferred = true;
+            ci->deferred_recovery_seq = req->last_seq;
+            std::cout << "Client " << req->client_id << " is recovering, recovery request deferred" << std::endl;
+            return;
+        }
+    }
     if(ci->status != CLIENT_ONLINE) {
         std::cout << "\n\n####\tWARN Client " << req->client_id << " is not online, skip recovery request" << std::endl;
         return;
     }
+    if (serve_from_hot_tail(ci, req->last_seq)) {
+        return;
+    }
+    begin_recovery(ci, req->last_seq);
+}
+
+// 캐시 구간은 압축하지 않고 TopicMessage 그대로 (짧은 구간이고 구독자는 두 형식을 모두 받는다)
+bool SimplePublisherV2::serve_from_hot_tail(std::shared_ptr<ClientInfo> ci, uint32_t last_seq) {
+    if (!_hot_tail.enabled() || !ci->bev) {
+        return false;
+    }
+    // 이 bev 를 가진 스레드가 live 로 보낸 마지막 seq 까지 (그 이후는 live 로 이어서 감)
+    uint32_t live_seq = get_current_sequence();
+    if (ci->reactor >= 0 && static_cast<size_t>(ci->reactor) < _reactors.size()) {
+        live_seq = _reactors[ci->reactor]->last_seq;
+    }
+    RecoveryResponse response;
+    response.magic = MAGIC_RECOVERY_RES;
+    response.result = 0;
+    response.start_seq = last_seq + 1;
+    response.end_seq = live_seq;
+    response.total_messages = (response.end_seq >= response.start_seq) ? (response.end_seq - response.start_seq + 1) : 0;
+
+    // 응답보다 먼저 구간을 확보해 둔다 (참조만 옮기므로 복사 없음, 캐시에서 밀려났으면 워커 복구로)
+    uint32_t sent = 0;
+    evbuffer* range = nullptr;
+    if (response.total_messages > 0) {
+        range = evbuffer_new();
+        RecoveryFilterFn filter = recovery_filter(ci);
+        if (!range || !_hot_tail.stream(range, response.start_seq, response.end_seq, filter ? &filter : nullptr, sent)) {
+            if (range) evbuffer_free(range);
+            _hot_tail_misses.inc();
+            return false;
+        }
+    }
+    T2MA_TRACE3(recovery_start, ci->client_id, response.start_seq, response.end_seq);
+    clear_conflated(ci);
+    bufferevent_write(ci->bev, &response, sizeof(response));
+    if (range) {
+        evbuffer_add_buffer(bufferevent_get_output(ci->bev), range);
+        evbuffer_free(range);
+    }
+
+    RecoveryComplete recovery_complete;
+    recovery_complete.magic = MAGIC_RECOVERY_CMP;
+    recovery_complete.total_sent = sent;
+    recovery_complete.timestamp = get_current_timestamp();
+    bufferevent_write(ci->bev, &recovery_complete, sizeof(recovery_complete));
+    T2MA_TRACE2(recovery_end, ci->client_id, response.end_seq);
+    _hot_tail_hits.inc();
+    std::cout << "Client " << ci->client_id << " recovery seq " << response.start_seq << "-" << response.end_seq
+              << " served from hot tail cache (" << sent << " messages)" << std::endl;
+    return true;
+}
+
+void SimplePublisherV2::set_hot_tail_cache(size_t messages, size_t bytes) {
+    _hot_tail.configure(&_msg_pool, messages, bytes);
+}
+
+void SimplePublisherV2::handle_gap_recovery_request(std::shared_ptr<ClientInfo> ci, const GapRecoveryRequest* req) {
+    if (!ci->bev || ci->status != CLIENT_ONLINE) {
+        // 전체 복구 중이면 그 복구가 누락 구간도 채운다
+        std::cout << "Client " << req->client_id << " is not online, skip gap recovery request" << std::endl;
+        return;
+    }
+    // reactor 클라이언트는 그 reactor 가 보낸 seq 까지만 (이후 구간은 live 로 이어서 감)
+    uint32_t live_seq = get_current_sequence();
+    if (ci->reactor >= 0 && static_cast<size_t>(ci->reactor) < _reactors.size()) {
+        live_seq = _reactors[ci->reactor]->last_seq;
+    }
+    uint32_t from_seq = std::max<uint32_t>(req->from_seq, 1);
+    uint32_t to_seq = std::min(req->to_seq, live_seq);
+    if (from_seq > to_seq) {
+        return;
+    }
+    if (from_seq < _db->min_seq()) {
+        // 지워진 구간은 채울 수 없다 - 응답하지 않으면 구독자가 gap timeout 후 전체 복구로 넘어감
+        std::cerr << "Client " << req->client_id << " gap recovery seq " << from_seq << "-" << to_seq
+                  << " is older than message DB (min seq " << _db->min_seq() << "), ignored" << std::endl;
+        return;
+    }
+    if (to_seq - from_seq + 1 > GAP_RECOVERY_MAX_MESSAGES) {
+        // 구독자는 이런 구간을 전체 복구로 받는다 (Common.h), 채우지 않으면 구독자 timeout 후 전체 복구
+        std::cerr << "Client " << req->client_id << " gap recovery seq " << from_seq << "-" << to_seq
+                  << " exceeds " << GAP_RECOVERY_MAX_MESSAGES << " messages, ignored" << std::endl;
+        return;
+    }
+    std::cout << "Client " << req->client_id << " gap recovery seq " << from_seq << "-" << to_seq << std::endl;
+    ci->gap_ranges.emplace_back(from_seq, to_seq);
+    if (ci->gap_ranges.size() == 1) {
+        pump_gap_recovery(ci);
+    }
+}
+
+// bev 를 가진 스레드에서 구간 복구를 chunk 단위로: output 이 low watermark (high_watermark / 2) 이하일 때만
+// 다음 chunk 를 올리고, 넘으면 write callback (on_send_queue_drained) 에서 이어 보낸다
+void SimplePublisherV2::pump_gap_recovery(const std::shared_ptr<ClientInfo>& ci) {
+    if (!ci->bev || ci->status != CLIENT_ONLINE) {
+        ci->gap_ranges.clear();     // 전체 복구 / 연결 종료가 대신함
+        return;
+    }
+    evbuffer* out = bufferevent_get_output(ci->bev);
+    size_t low = ci->high_watermark > 0 ? ci->high_watermark / 2 : RECOVERY_LOW_WATERMARK;
+    RecoveryFilterFn filter = recovery_filter(ci);
+    while (!ci->gap_ranges.empty()) {
+        if (evbuffer_get_length(out) > low) {
+            watch_send_queue(ci, true, low);
+            return;
+        }
+        std::pair<uint32_t, uint32_t>& range = ci->gap_ranges.front();
+        uint32_t end = range.first + std::min(range.second - range.first, GAP_RECOVERY_CHUNK_MESSAGES - 1);
+        stream_message_range(out, _db.get(), range.first, end, nullptr, filter ? &filter : nullptr);
+        if (end >= range.second) {
+            ci->gap_ranges.pop_front();
+        } else {
+            range.first = end + 1;
+        }
+    }
+}
+
+void SimplePublisherV2::handle_range_fetch_request(std::shared_ptr<ClientInfo> ci, const RangeFetchRequest* req) {
+    if (!ci->bev) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        if (ci->status != CLIENT_CONNECTED) {
+            // 구독 연결은 RecoveryRequest 로 복구 (이 연결의 live 순서를 섞지 않도록)
+            std::cerr << "Client " << req->client_id << " range fetch on a subscribed connection ignored" << std::endl;
+            return;
+        }
+        ci->client_id = req->client_id;
+    }
+    uint32_t from_seq = std::max<uint32_t>(req->from_seq, 1);
+    uint32_t to_seq = std::min(req->to_seq, get_current_sequence());
+    if (!_db || _workers.empty() || from_seq > to_seq) {
+        // 보낼 구간 없음: 바로 완료 (요청자는 받은 seq 로 판단)
+        RecoveryComplete recovery_complete;
+        recovery_complete.magic = MAGIC_RECOVERY_CMP;
+        recovery_complete.total_sent = 0;
+        recovery_complete.timestamp = get_current_timestamp();
+        bufferevent_write(ci->bev, &recovery_complete, sizeof(recovery_complete));
+        return;
+    }
+    ci->recovery_compression = block_codec_available(req->compression) ? req->compression : static_cast<uint32_t>(BLOCK_CODEC_NONE);
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        ci->recovery_end_seq = to_seq;
+        ci->status = CLIENT_RECOVERING;
+    }
+    _range_fetches.inc();
+    T2MA_TRACE3(recovery_start, req->client_id, from_seq, to_seq);
+    ALOG_DEBUG("SimplePublisherV2", "client %u range fetch %u-%u", req->client_id, from_seq, to_seq);
+    auto*w=pick_recovery_worker();
+    hand_off_bufferevent(ci->bev, w->base);
+    ::RecoveryTask task = {ci, from_seq, to_seq};
+    {std::lock_guard<std::mutex>qg(w->queue_mu); w->task_q.push(task);}
+    char c='r'; write(w->notify_pipe_w,&c,1);
+}
+
+void SimplePublisherV2::handle_time_recovery_request(std::shared_ptr<ClientInfo> ci, const TimeRecoveryRequest* req) {
+    // since_ns 이후 메시지가 없으면 현재 seq 부터 (복구할 구간 없음)
+    uint32_t seq = _db ? _db->seek_time(req->since_ns) : 0;
+    RecoveryRequest recovery;
+    recovery.magic = MAGIC_RECOVERY_REQ;
+    recovery.client_id = req->client_id;
+    recovery.topic_mask = req->topic_mask;
+    recovery.last_seq = seq > 0 ? seq - 1 : get_current_sequence();
+    recovery.compression = req->compression;
+    std::cout << "Client " << req->client_id << " time recovery since " << req->since_ns
+              << " -> seq " << recovery.last_seq + 1 << std::endl;
+    handle_recovery_request(ci, &recovery);
+}
+
+void SimplePublisherV2::handle_topic_filter_request(std::shared_ptr<ClientInfo> ci, const TopicFilterRequest* req) {
+    const TopicRegistry& registry = TopicRegistry::global();
+    std::shared_ptr<TopicFilter> filter;
+    if (req->count > 0) {
+        filter = std::make_shared<TopicFilter>();
+        for (uint32_t i = 0; i < req->count; ++i) {
+            int slot = registry.slot(req->topics[i]);
+            if (slot < 0) {
+                std::cerr << "Client " << req->client_id << " topic filter: unknown topic " << req->topics[i] << std::endl;
+                continue;
+            }
+            filter->add(slot);
+        }
+    }
+    bool online;
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        ci->topic_filter = filter;
+        online = ci->status == CLIENT_ONLINE;
+    }
+    std::cout << "Client " << req->client_id << " topic filter: " << req->count << " topics" << std::endl;
+    if (online) {
+        rebuild_subscriber_snapshot();
+    }
+}
+
+void SimplePublisherV2::handle_symbol_filter_request(std::shared_ptr<ClientInfo> ci, const SymbolFilterRequest* req) {
+    if (req->count > 0 && !_symbol_resolve) {
+        std::cerr << "Client " << req->client_id << " symbol filter ignored: no symbol index on this publisher" << std::endl;
+        return;
+    }
+    std::shared_ptr<SymbolFilter> filter;
+    size_t matched = 0;
+    if (req->count > 0) {
+        filter = std::make_shared<SymbolFilter>();
+        for (uint32_t i = 0; i < req->count; ++i) {
+            const char* key = req->symbols + static_cast<size_t>(i) * SYMBOL_KEY_SIZE;
+            std::string symbol(key, strnlen(key, SYMBOL_KEY_SIZE));
+            int32_t index = _symbol_resolve(symbol);
+            if (index < 0) {
+                std::cerr << "Client " << req->client_id << " symbol filter: unknown symbol '" << symbol << "'" << std::endl;
+                continue;
+            }
+            filter->add(index);
+            matched++;
+        }
+    }
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        ci->symbol_filter = filter;
+    }
+    std::cout << "Client " << req->client_id << " symbol filter: " << matched << " of " << req->count << " symbols" << std::endl;
+    // 상태와 무관하게 갱신 (스냅샷의 symbol_clients 로 batch 종목 index 계산 여부가 바뀜)
+    rebuild_subscriber_snapshot();
+}
+
+void SimplePublisherV2::handle_replica_ack(std::shared_ptr<ClientInfo> ci, const ReplicaAck* ack) {
+    bool first = false;
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        first = !ci->replica;
+        ci->replica = true;
+        // ack 는 순서대로 오지만 재연결 직후 이전 값이 늦게 보일 수 있으므로 뒤로 돌리지 않음
+        if (ack->acked_seq > ci->replica_acked_seq) ci->replica_acked_seq = ack->acked_seq;
+        ci->replica_ack_time = get_current_timestamp();
+        ci->replica_acks++;
+    }
+    if (first) {
+        std::cout << "Client " << ack->client_id << " is a standby replica (acked seq " << ack->acked_seq << ")" << std::endl;
+    }
+}
+
+RecoveryFilterFn SimplePublisherV2::recovery_filter(const std::shared_ptr<ClientInfo>& ci) {
+    std::shared_ptr<const TopicFilter> topic_filter;
+    std::shared_ptr<const SymbolFilter> symbol_filter;
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        topic_filter = ci->topic_filter;
+        if (_symbol_index) symbol_filter = ci->symbol_filter;
+    }
+    if (!topic_filter && !symbol_filter) {
+        return RecoveryFilterFn();
+    }
+    SymbolIndexFn symbol_index = _symbol_index;
+    return [topic_filter, symbol_filter, symbol_index](const TopicMessage& msg) {
+        if (topic_filter && !topic_filter->has(TopicRegistry::global().slot(msg.topic))) return false;
+        if (symbol_filter) {
+            int32_t index = symbol_index(msg);
+            if (index >= 0 && !symbol_filter->has(index)) return false;
+        }
+        return true;
+    };
+}
+
+RecoveryWorker* SimplePublisherV2::pick_recovery_worker() {
+    size_t n = _workers.size();
+    uint32_t start = _rr_counter++;
+    RecoveryWorker* best = nullptr;
+    size_t best_load = 0;
+    for (size_t i = 0; i < n; ++i) {
+        RecoveryWorker* w = _workers[(start + i) % n];
+        size_t load = w->load();
+        if (!best || load < best_load) {
+            best = w;
+            best_load = load;
+        }
+    }
+    return best;
+}
+
+void SimplePublisherV2::set_recovery_bandwidth(uint64_t bytes_per_sec, uint32_t priority_messages) {
+    _recovery_bandwidth.set_rate(bytes_per_sec, bytes_per_sec * RECOVERY_BURST_MS / 1000);
+    _recovery_priority_messages = priority_messages;
+}
+
+void RecoveryBandwidth::set_rate(uint64_t bytes_per_sec, uint64_t burst_bytes) {
+    std::lock_guard<std::mutex> g(_mu);
+    _rate = bytes_per_sec;
+    _burst = static_cast<double>(std::max<uint64_t>(burst_bytes, 1));
+    _tokens = _burst;
+    _last_ns = 0;
+}
+
+void RecoveryBandwidth::refill_locked(uint64_t now_ns) {
+    if (_last_ns != 0 && now_ns > _last_ns) {
+        _tokens = std::min(_burst, _tokens + static_cast<double>(now_ns - _last_ns) * _rate / 1e9);
+    }
+    _last_ns = now_ns;
+}
+
+uint64_t RecoveryBandwidth::wait_us() {
+    std::lock_guard<std::mutex> g(_mu);
+    if (_rate == 0) return 0;
+    refill_locked(latency_now_ns());
+    if (_tokens > 0) return 0;
+    // 잔액이 0 을 넘을 때까지 (+1us)
+    return static_cast<uint64_t>(-_tokens * 1e6 / _rate) + 1;
+}
+
+void RecoveryBandwidth::consume(size_t bytes) {
+    std::lock_guard<std::mutex> g(_mu);
+    refill_locked(latency_now_ns());
+    _tokens -= static_cast<double>(bytes);
+}
+
+void SimplePublisherV2::begin_recovery(std::shared_ptr<ClientInfo> ci, uint32_t last_seq) {
+    // bev 가 워커 base 로 옮겨가므로 main 스레드 write callback/timer 를 먼저 해제 (전체 복구가 누락 구간도 채움)
+    clear_conflated(ci);
+    release_write_hold(ci);
+    ci->gap_ranges.clear();
     // Send RecoveryResponse with proper target sequence
     RecoveryResponse response;
     response.magic = MAGIC_RECOVERY_RES;
     response.result = 0;  // Success
-    response.start_seq = req->last_seq + 1;
+    response.start_seq = last_seq + 1;
     // Capture current global sequence as recovery target (Gap-Free Recovery)
     response.end_seq = _publisher_sequence_record ? _publisher_sequence_record->all_topics_sequence : _db->count();
     response.total_messages = (response.end_seq >= response.start_seq) ? (response.end_seq - response.start_seq + 1) : 0;
 
     bufferevent_write(ci->bev,&response,sizeof(response));
+    T2MA_TRACE3(recovery_start, ci->client_id, response.start_seq, response.end_seq);
     // std::cout << " 일단 RECOVERY 처리는 나중에... SKIIIP" << std::endl;
     
-    ci->status=CLIENT_RECOVERING;
+    {
+        std::lock_guard<std::mutex> cg(ci->mu);
+        ci->status=CLIENT_RECOVERING;
+    }
+    rebuild_subscriber_snapshot();
     // Keep client in _clients map during recovery for pending message handling
     // {std::lock_guard<std::mutex>g(_clients_mu);_clients.erase(ci->fd);}
     // 리커버리 테스크 를 리커비리 스레드로 넘김 (리커버리 스레드의 notify_pipe_w를 통해 알림)
-    auto*w=_workers[_rr_counter++%_workers.size()];
+    auto*w=pick_recovery_worker();
+    hand_off_bufferevent(ci->bev, w->base);
     ::RecoveryTask task = {ci, response.start_seq, response.end_seq};
     {std::lock_guard<std::mutex>qg(w->queue_mu); w->task_q.push(task);}
     char c='r'; write(w->notify_pipe_w,&c,1);
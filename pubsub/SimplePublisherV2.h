@@ -5,11 +5,26 @@
 #include "../common/MessageDB.h"
 #include "../common/Memory_SAM.h"
 #include "../common/db_sam.h"
+#include "../common/mmap_sam.h"
+#include "../common/segment_sam.h"
+#include "../common/WriteBehindMessageDB.h"
+#include "../common/BlockCompression.h"
+#include "../common/LatencyStats.h"
+#include "../common/AsyncLog.h"
 #include "PubSubTopicProtocol.h"
 #include "../eventBase/EventBase.h"
 #include "SequenceStorage.h"
+#include "TopicRegistry.h"
 #include "FileSequenceStorage.h"
 #include "HashmasterSequenceStorage.h"
+#include "WriteBehindSequenceStorage.h"
+#include "MessageBufferPool.h"
+#include "SpscQueue.h"
+#include "ShmTopicLog.h"
+#include "SocketProfile.h"
+#include "HotTailCache.h"
+#include "../eventBase/EventUdpSocket.h"
+#include "../HashMaster/WireCodec.h"
 
 #include <map>
 #include <memory>
@@ -19,6 +34,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <queue>
+#include <deque>
 
 using namespace SimplePubSub;
 
@@ -34,6 +50,100 @@ struct RecoveryTask {
     uint32_t to_seq;
 };
 
+// -----------------------------
+// Batch publish item
+// -----------------------------
+struct PublishItem {
+    DataTopic topic;
+    const char* data;
+    size_t size;
+};
+
+// -----------------------------
+// Slow consumer (send-queue backpressure)
+// -----------------------------
+// CONFLATE 정책에서 같은 key 의 메시지는 최신 것 하나만 남긴다 (기본 key: topic)
+typedef std::function<uint64_t(const TopicMessage& msg)> ConflationKeyFn;
+
+// 종목 필터 (SymbolFilterRequest): 메시지의 종목 index (HashMaster 레코드 번호 등 0 이상, 종목이 없는 메시지는 -1)
+// publish batch 당 메시지마다 한번 (필터 구독자가 있을 때만), 복구 워커 스레드에서도 호출된다
+typedef std::function<int32_t(const TopicMessage& msg)> SymbolIndexFn;
+// 구독자가 보낸 종목 key -> 같은 index (없으면 -1)
+typedef std::function<int32_t(const std::string& symbol)> SymbolResolveFn;
+// 복구 스트림에 보낼 메시지 (비어 있으면 전부)
+typedef std::function<bool(const TopicMessage& msg)> RecoveryFilterFn;
+
+struct ClientQueueStats {
+    uint32_t client_id;
+    ClientStatus status;
+    size_t queued_bytes;            // 현재 output evbuffer 크기
+    size_t peak_queued_bytes;
+    size_t high_watermark;
+    uint64_t dropped_messages;
+    uint64_t conflated_messages;
+    uint64_t slow_consumer_events;
+};
+
+// ReplicaAck 를 보내는 standby 연결 상태 (get_replica_status)
+struct ReplicaStatus {
+    uint32_t client_id;
+    uint32_t acked_seq;             // standby 가 기록했다고 보낸 마지막 global seq
+    uint32_t lag;                   // 현재 seq - acked_seq
+    uint64_t ack_age_ms;            // 마지막 ack 이후 경과 시간
+    uint64_t acks;
+};
+
+// -----------------------------
+// Subscriber snapshot (copy-on-write)
+// -----------------------------
+// publish 경로에서 락 없이 순회하기 위한 불변 구독자 목록.
+// 구독/해제/상태 변경(ONLINE<->RECOVERING) 시 _clients_mu 아래에서 새로 만들어 atomic 교체한다.
+struct SubscriberEntry {
+    std::shared_ptr<ClientInfo> client;
+    uint32_t topic_mask;
+    uint32_t conflate_mask;     // 구독 요청에서 conflation 을 요청한 토픽
+    std::shared_ptr<const TopicFilter> topic_filter;    // 스냅샷 생성 시점의 client->topic_filter
+};
+
+struct SubscriberSnapshot {
+    static constexpr size_t TOPIC_SLOTS = 3;    // TOPIC1, TOPIC2, MISC
+
+    std::vector<SubscriberEntry> online;                    // 전체 ONLINE 클라이언트
+    std::vector<SubscriberEntry> by_topic[TOPIC_SLOTS];     // group 별 ONLINE 클라이언트 (토픽 필터 없음)
+    std::vector<SubscriberEntry> filtered;                  // 토픽 필터가 있는 ONLINE 클라이언트
+    std::vector<std::vector<SubscriberEntry>> by_filter;    // TopicRegistry slot -> 그 토픽을 필터로 고른 클라이언트
+    size_t wire_clients{0};     // WIRE_ENCODING_COMPACT socket 클라이언트 수 (reactor/복구 중 포함, 0 이면 인코딩 생략)
+    size_t symbol_clients{0};   // 종목 필터가 있는 socket 클라이언트 수 (같은 기준, 0 이면 batch 종목 index 생략)
+    // RECOVERING 클라이언트는 목록에 없음: 복구 워커가 MessageDB 에서 live head 까지 읽어 보낸다
+    // data_transport 가 SOCKET 이 아닌 클라이언트(shm/multicast)는 socket fan-out 대상이 아니므로 어느 목록에도 넣지 않는다
+    // I/O reactor 에 속한 클라이언트도 넣지 않는다 (담당 reactor 가 자체 목록으로 fan-out)
+
+    // group 비트 (batch_topics 가 한 group 일 때) -> by_topic index
+    static int topic_slot(DataTopic topic) {
+        return TopicRegistry::legacy_slot(topic);
+    }
+};
+
+// 복구 전송 대역폭 예산 (모든 RecoveryWorker 가 공유하는 bytes/s token bucket, rate 0: 제한 없음)
+// chunk 를 보내기 전에는 잔액이 남았는지만 보고, 보낸 뒤 실제 bytes 를 차감한다 (음수 잔액 = 다음 chunk 를 그만큼 늦춤)
+class RecoveryBandwidth {
+public:
+    void set_rate(uint64_t bytes_per_sec, uint64_t burst_bytes);
+    bool enabled() const { return _rate > 0; }
+    uint64_t rate() const { return _rate; }
+    // 지금 보내도 되면 0, 아니면 잔액이 생길 때까지 기다릴 us
+    uint64_t wait_us();
+    void consume(size_t bytes);
+
+private:
+    std::mutex _mu;
+    uint64_t _rate{0};
+    double _burst{0};
+    double _tokens{0};
+    uint64_t _last_ns{0};
+    void refill_locked(uint64_t now_ns);
+};
+
 struct RecoveryWorker {
     event_base *base{nullptr};
     event *notify_event{nullptr};
@@ -43,8 +153,77 @@ struct RecoveryWorker {
     std::queue<::RecoveryTask> task_q;
     std::thread th;
     std::atomic<bool> running{false};
+    std::atomic<uint32_t> active{0};                        // 이 워커가 스트리밍 중인 클라이언트 수
+    // 대역폭 예산을 기다리는 클라이언트 (도착 순서대로 한 chunk 씩), 워커 스레드만 접근
+    std::deque<std::shared_ptr<ClientInfo>> throttled;
+    event *pace_timer{nullptr};
 
     void on_notify();
+    void run_task(const ::RecoveryTask& t);
+    // [from_seq, to_seq] 구간을 클라이언트 output evbuffer로 스트리밍, 전송한 메시지 수 반환 (compression: BLOCK_CODEC_*)
+    uint32_t stream_range(bufferevent* bev, MessageDB* db, uint32_t from_seq, uint32_t to_seq, uint32_t compression,
+                          const RecoveryFilterFn& filter);
+    // recovery_next_seq 부터 한 chunk 전송, live head 에 가까워지면 main 으로 넘김
+    // 예산이 없으면 throttled 끝에 넣고 pace_timer 가 순서대로 다시 부른다 (scheduled: timer 에서 부름)
+    void stream_next_chunk(std::shared_ptr<ClientInfo> ci, bool scheduled = false);
+    void finish_recovery(std::shared_ptr<ClientInfo> ci);
+    void arm_pace_timer(uint64_t wait_us);
+    void on_pace_timer();
+    // 진행 중 + 대기 중인 복구 수 (main 이 워커를 고를 때)
+    size_t load();
+    static void static_stream_cb(bufferevent* bev, void* ctx);
+};
+
+// [from_seq, to_seq] 구간을 evbuffer 에 추가 (running 이 false 가 되면 중단), 추가한 메시지 수 반환
+// filter 가 있으면 통과한 메시지만 (파일 구간 sendfile 은 쓰지 않음)
+// DB 가 이미 지운 앞부분 (from_seq < min_seq, ring Memory_SAM / 보존 기간) 은 건너뛰고 min_seq 부터 보낸다
+uint32_t stream_message_range(evbuffer* out, MessageDB* db, uint32_t from_seq, uint32_t to_seq,
+                              const std::atomic<bool>* running = nullptr, const RecoveryFilterFn* filter = nullptr);
+// 같은 구간을 RecoveryBatch (codec 압축) 로 묶어 추가, 추가한 메시지 수 반환
+uint32_t stream_compressed_range(evbuffer* out, MessageDB* db, uint32_t from_seq, uint32_t to_seq,
+                                 uint32_t codec, const std::atomic<bool>* running = nullptr,
+                                 const RecoveryFilterFn* filter = nullptr);
+
+// -----------------------------
+// I/O reactor (socket 구독자 fan-out 스레드)
+// -----------------------------
+// batch 하나를 모든 reactor 가 공유 (MessageBuffer 참조 1개, 마지막 reactor 가 반환)
+struct FanoutBatch {
+    MessageBuffer* buf{nullptr};
+    std::vector<MessageSlice> slices;
+    MessageBuffer* wire_buf{nullptr};       // compact 구독자용 인코딩 batch (없으면 nullptr)
+    std::vector<MessageSlice> wire_slices;
+    uint32_t first_global_seq{0};
+    uint32_t batch_topics{0};
+    int batch_slot{-1};
+    std::vector<int32_t> symbols;       // 메시지별 종목 index (종목 필터 구독자가 없으면 비어 있음)
+    std::atomic<uint32_t> pending{0};   // 아직 처리하지 않은 reactor 수
+};
+
+// publish 스레드 -> reactor: fan-out 할 batch 또는 이 reactor 로 옮겨올 클라이언트
+struct ReactorItem {
+    FanoutBatch* batch{nullptr};
+    std::shared_ptr<ClientInfo> adopt;
+};
+
+struct IoReactor : SpscAlignedNew {     // queue 의 head / tail 64 byte 정렬
+    size_t index{0};
+    int cpu{-1};                        // 고정할 CPU (-1: 고정 안함)
+    void* owner{nullptr};               // SimplePublisherV2
+    event_base* base{nullptr};
+    event* notify_event{nullptr};
+    int notify_fd{-1};                  // eventfd
+    std::atomic<bool> notified{false};  // notify_fd 에 쓴 뒤 reactor 가 아직 깨어나지 않음
+    SpscQueue<ReactorItem> queue;
+    std::thread th;
+    // 아래는 reactor 스레드에서만 접근
+    std::vector<std::shared_ptr<ClientInfo>> clients;
+    uint32_t last_seq{0};               // 마지막으로 fan-out 한 global seq
+    std::atomic<uint64_t> batches{0};
+    evconnlistener* listener{nullptr};  // SO_REUSEPORT TCP acceptor (set_tcp_reactor_acceptors)
+    std::atomic<uint64_t> accepted{0};
+
+    explicit IoReactor(size_t queue_capacity) : queue(queue_capacity) {}
 };
 
 
@@ -66,6 +245,19 @@ struct RecoveryWorker {
  * 1. 메인 스레드: 일반적인 클라이언트 통신 처리 (ONLINE 상태)
  * 2. 복구 스레드: 복구 중인 클라이언트 처리 (RECOVERING 상태)
  * 3. 복구 완료 후 클라이언트를 다시 메인 스레드로 이동
+ *
+ * I/O reactor (set_io_reactors, 기본 0 = 사용 안함):
+ * - socket 구독자는 구독 시 client_id % N 번 reactor 로 옮겨가고, 이후 ONLINE 송신/수신은 그 스레드가 처리
+ * - publish 는 DB/시퀀스/shm/multicast 까지만 하고 batch 를 reactor 별 SPSC 큐에 넣는다 (참조만, 복사 없음)
+ * - 복구 완료 후에는 메인이 아니라 담당 reactor 로 돌아가며, 큐 순서상 그 시점까지의 batch 는 모두
+ *   처리된 뒤이므로 last_seq 까지 DB 에서 이어 보내면 누락/중복이 없다
+ * - publish/구독 처리는 main base 스레드에서 호출되어야 한다 (SPSC producer 가 하나)
+ *
+ * listener:
+ * - start_both 면 Unix / TCP listener 를 함께 연다 (Unix 는 main base)
+ * - set_tcp_reactor_acceptors 면 reactor 마다 같은 port 에 SO_REUSEPORT TCP listener 를 두고 커널이 연결을 나눈다.
+ *   accept 한 reactor 가 그 클라이언트를 바로 담당하므로 (client_id % N 으로 옮기지 않음) 재연결이 몰려도
+ *   accept / 구독 / 복구 요청 처리가 main 의 publish 와 다른 reactor 의 live fan-out 을 막지 않는다
  */
 class SimplePublisherV2 {
 private:
@@ -81,14 +273,59 @@ private:
     
     // EventBase 관련
     struct event_base* _main_base;
-    evconnlistener* _listener;
+    evconnlistener* _unix_listener;
+    evconnlistener* _tcp_listener;             // main base TCP listener (reactor acceptor 를 쓰면 nullptr)
+    bool _listen_both{false};                  // start_both: Unix 와 TCP 를 함께
+    bool _tcp_reactor_acceptors{false};
+    /* base 에 Unix 또는 TCP listener 생성 (reuse_port: SO_REUSEPORT), 실패하면 nullptr */
+    evconnlistener* bind_listener(event_base* base, bool tcp, bool reuse_port, evconnlistener_cb cb, void* ctx);
+
+    // publish 메시지 버퍼 풀 (프로세스 공용 MessageBufferPool::shared(), 복구 / pending 과 같은 풀)
+    MessageBufferPool& _msg_pool;
+    // 최근 발행분 ring (publish buffer 참조)
+    HotTailCache _hot_tail;
+    StatsCounter _hot_tail_hits{"publisher.hot_tail_hits"};       // 캐시로 바로 끝낸 복구 요청
+    StatsCounter _hot_tail_misses{"publisher.hot_tail_misses"};   // 구간이 캐시 밖이라 워커로 넘긴 요청
+    /* [last_seq+1, live] 가 캐시에 있으면 이 스레드에서 RecoveryResponse ~ RecoveryComplete 를 바로 보내고 true */
+    bool serve_from_hot_tail(std::shared_ptr<ClientInfo> ci, uint32_t last_seq);
 
     std::mutex _clients_mu;
     std::map<uint32_t,std::shared_ptr<ClientInfo>> _clients;
+    // publish 용 구독자 스냅샷 (std::atomic_load/atomic_store 로만 접근)
+    std::shared_ptr<const SubscriberSnapshot> _subscriber_snapshot;
     std::vector<RecoveryWorker*> _workers;
     std::atomic<uint32_t> _rr_counter{0};
+    // 복구 스케줄링: 전체 대역폭 예산, 남은 양이 이 이하인 (live 에 가까운) 클라이언트는 예산과 관계없이 전송
+    RecoveryBandwidth _recovery_bandwidth;
+    uint32_t _recovery_priority_messages;
+    StatsCounter _recovery_bytes{"publisher.recovery_bytes"};           // 복구로 output 에 올린 bytes
+    StatsCounter _recovery_throttled{"publisher.recovery_throttled"};   // 예산 때문에 chunk 를 미룬 횟수
+    StatsCounter _range_fetches{"publisher.range_fetches"};             // 워커로 넘긴 RangeFetchRequest 구간
+    // 진행 중 + 대기 복구가 가장 적은 워커 (같으면 round-robin)
+    RecoveryWorker* pick_recovery_worker();
     
 
+    // socket 구독자 fan-out 스레드 (start() 에서 생성)
+    size_t _reactor_count{0};
+    std::vector<int> _reactor_cpus;
+    std::vector<int> _recovery_cpus;            // recovery worker i 는 _recovery_cpus[i % size] 에 고정
+    std::vector<IoReactor*> _reactors;
+    void start_io_reactors();
+    void stop_io_reactors();
+    event_base* client_base(const ClientInfo& ci) const;
+    // libevent 스레드 지원 없이 bev 를 다른 스레드 base 로 넘긴다: 지금 bev 를 가진 스레드에서 이벤트를 내리고
+    // (disable) 받을 base 에 assign 만 해 둔다. 받는 스레드는 자기 loop 에서 enable 만 한다 (두 스레드가 같은 base 를 만지지 않음)
+    static void hand_off_bufferevent(bufferevent* bev, event_base* to);
+    void dispatch_to_reactors(MessageBuffer* msg_buf, const MessageSlice* slices, size_t count,
+                              uint32_t first_global_seq, uint32_t batch_topics, int batch_slot,
+                              MessageBuffer* wire_buf, const MessageSlice* wire_slices, const int32_t* symbols);
+    void push_to_reactor(IoReactor* r, ReactorItem&& item);
+    void adopt_on_reactor(std::shared_ptr<ClientInfo> ci);
+    void reactor_notify_cb(IoReactor* r);
+    void reactor_fan_out(IoReactor* r, const FanoutBatch* b);
+    void reactor_adopt(IoReactor* r, std::shared_ptr<ClientInfo> ci);
+    void release_fanout_batch(FanoutBatch* b);
+
     int _main_notify_pipe[2];
     event *_main_notify_event{nullptr};
     std::mutex _main_return_mu;
@@ -98,19 +335,147 @@ private:
     PublisherSequenceRecord* _publisher_sequence_record;
     StorageType _sequence_storage_type;
     SequenceStorage* _sequence_storage;
+    uint32_t _sequence_flush_ms{0};     // >0: write-behind (publish 는 메모리 레코드만 갱신, flusher 가 주기 저장)
+    WriteBehindSequenceStorage* _write_behind_storage{nullptr};
+    bool _owns_sequence_record{false};
+    bool _sequences_repaired{false};
+    // 토픽별 topic seq (기본 토픽은 _publisher_sequence_record 필드, 확장 토픽은 <publisher>.topics 파일)
+    TopicSequenceTable _topic_sequences;
+    void init_topic_sequences(const std::string& path);
+    // DB 에는 있지만 sequence record 에 반영되지 않은 tail (crash 로 저장 전 종료) 을 DB 에서 다시 반영
+    void repair_sequences_from_db();
+    // 정상 종료 seal (load 직후 읽어두고 레코드는 바로 unseal, 다음 정상 종료에 다시 seal)
+    bool _restart_sealed{false};
+    uint32_t _restart_db_watermark{0};
+    uint32_t _restart_master_generation{0};
+    bool _warm_restart{false};                  // seal 과 DB tail 이 일치해서 검사 없이 이어받음
+    uint32_t _master_generation{0};
+    void take_restart_seal();
+    void seal_sequence_record(uint32_t db_seq);
     
     // 데이터 저장
     std::unique_ptr<MessageDB> _db;
     std::string _db_path;
+    BlockCodec _db_compression{BLOCK_CODEC_NONE};     // FILE(DB_SAM) 새 데이터 파일의 block 압축
+    size_t _db_block_size{DB_SAM_BLOCK_SIZE};
+    SegmentPolicy _db_segment_policy;                 // SEGMENTED(SEGMENT_SAM) segment 크기 / 보존 정책
+    size_t _db_memory_max_bytes{0};                   // MEMORY(Memory_SAM) ring 모드 상한 (0: 무제한)
+    size_t _db_memory_chunk_size{Memory_SAM::DEFAULT_CHUNK_SIZE};
+    bool _db_write_behind{false};                     // 파일 DB 앞에 WriteBehindMessageDB
+    DurableLagPolicy _db_lag_policy;
+    event* _db_flush_event{nullptr};                  // 발행이 끊겨도 DB 버퍼 (압축 block 등) 를 주기적으로 내림
+    StatsCounter _db_durable_seq{"publisher.db_durable_seq"};  // gauge: DB 가 파일에 내린 마지막 seq
+    void db_flush_tick();
 
     // 추가 멤버 변수들
     bool _use_unix{true};
+    SocketProfile _socket_profile;  // accept 한 구독자 socket 옵션 (기본: 설정 안함)
+
+    // micro-batching: publish()를 모아 두었다가 이벤트 루프 한 턴에 publish_batch로 flush
+    struct StagedItem {
+        DataTopic topic;
+        size_t offset;
+        size_t size;
+    };
+    bool _micro_batching{false};
+    event* _batch_flush_event{nullptr};
+    std::vector<char> _batch_data;
+    std::vector<StagedItem> _batch_staged;
+    std::vector<PublishItem> _batch_items;
+    std::vector<MessageSlice> _batch_slices;
+    bool _republish_renumber_warned{false};
+    // hot standby: 자체 publish 는 버리고 republish_batch (primary 복제) 만 기록
+    bool _standby{false};
+    StatsCounter _standby_dropped{"publisher.standby_dropped"};
+    /* publish_batch / republish_batch 공통: _batch_slices 를 DB 기록부터 구독자 전송까지 (msg_buf 반환)
+       batch_topics: 메시지 group 비트 OR, batch_slot: 모든 메시지가 한 토픽이면 그 TopicRegistry slot (아니면 -1) */
+    void deliver_batch(MessageBuffer* msg_buf, uint32_t first_global_seq, uint32_t batch_topics, int batch_slot,
+                       uint64_t t_start);
+
+    // compact wire encoding (WIRE_ENCODING_COMPACT 구독자가 있을 때만 batch 당 한번 인코딩)
+    std::vector<std::vector<std::shared_ptr<const WireCodec>>> _wire_codecs;     // TopicRegistry slot 별
+    bool _has_wire_codecs{false};
+    std::vector<MessageSlice> _wire_slices;
+    StatsCounter _wire_encoded{"publisher.wire_encoded"};          // compact 형식으로 인코딩한 메시지 수
+    StatsCounter _wire_bytes_saved{"publisher.wire_bytes_saved"};  // 인코딩으로 줄어든 payload 바이트 (메시지당 한번)
+    // raw batch 를 compact 형식으로 한번 더 만든다 (codec 이 없거나 줄지 않는 메시지는 원래 TopicMessage 그대로)
+    MessageBuffer* encode_wire_batch(const MessageSlice* slices, size_t count);
+    const WireCodec* find_wire_codec(uint32_t topic, size_t size) const;
+
+    // 같은 호스트 구독자용 공유메모리 로그 (batch 당 한번 기록, 구독자 수와 무관)
+    std::unique_ptr<ShmTopicLog> _shm_log;
+
+    // 원격 구독자용 UDP multicast (batch 를 datagram 단위로 한번 송신, 누락분은 socket 복구)
+    std::unique_ptr<EventUdpSocket> _mcast;
+    std::string _mcast_address;
+    size_t _mcast_max_datagram{1400};
+    uint64_t _mcast_datagrams{0};
+    uint64_t _mcast_drops{0};
+    event* _mcast_heartbeat_event{nullptr};     // 유휴 시에도 다음 seq 를 알려 끝부분 유실을 감지시킴
+    void send_multicast(const MessageSlice* slices, size_t count);
+    void send_multicast_heartbeat();
+
+    // 느린 구독자 backpressure (새 클라이언트의 ClientInfo::high_watermark 기본값, 0 이면 제한 없음)
+    SlowConsumerPolicy _slow_consumer_policy{SLOW_CONSUMER_RESYNC};
+    size_t _send_queue_high_watermark{0};
+    ConflationKeyFn _conflation_key;
+    // 종목 필터 (set_symbol_index 가 없으면 SymbolFilterRequest 는 무시)
+    SymbolIndexFn _symbol_index;
+    SymbolResolveFn _symbol_resolve;
+    std::vector<int32_t> _batch_symbols;                        // deliver_batch 의 메시지별 종목 index
+    StatsCounter _symbol_filtered{"publisher.symbol_filtered"}; // 종목 필터로 보내지 않은 메시지 수 (클라이언트별 합)
+    // 클라이언트의 토픽 / 종목 필터를 복구 스트림용 predicate 로 (필터가 없으면 빈 함수)
+    RecoveryFilterFn recovery_filter(const std::shared_ptr<ClientInfo>& ci);
+    StatsCounter _slow_consumer_events{"publisher.slow_consumer_events"};
+    StatsCounter _messages_sent{"publisher.messages_sent"};     // fan-out 으로 클라이언트 송신 큐에 넣은 메시지 수
+    std::unique_ptr<PublisherLatency> _latency;                 // publish_batch 단계별 지연 (set_latency_tracking)
+    // 클라이언트 하나에 batch 전송 (main 또는 담당 reactor 스레드)
+    // wire_buf 가 있으면 compact 구독자의 실시간 전송은 그쪽 slice 로 (backpressure/conflation 은 원래 slice)
+    // topic_filter 가 있으면 batch 안에서 필터 토픽 메시지만 골라 보낸다
+    // symbols (메시지별 종목 index) 가 있으면 ci->symbol_filter 종목도 고른다 (bev 를 가진 스레드에서만 바뀜)
+    void fan_out_client(const std::shared_ptr<ClientInfo>& ci, uint32_t topic_mask, uint32_t conflate_mask,
+                        const TopicFilter* topic_filter, MessageBuffer* msg_buf, const MessageSlice* slices, size_t count,
+                        uint32_t first_global_seq, uint32_t batch_topics,
+                        MessageBuffer* wire_buf, const MessageSlice* wire_slices, const int32_t* symbols);
+    // 송신 큐가 high watermark 이상이면 정책 적용, true 면 이번 batch 는 이 클라이언트에 쓰지 않음
+    bool apply_backpressure(const std::shared_ptr<ClientInfo>& ci, evbuffer* out,
+                            const MessageSlice* slices, size_t count, uint32_t first_global_seq,
+                            const int32_t* symbols);
+    // 송신 큐가 low_watermark 까지 비면 write callback 으로 알림 받기 / 해제
+    void watch_send_queue(const std::shared_ptr<ClientInfo>& ci, bool enable, size_t low_watermark = 0);
+    static void static_write_cb(bufferevent* bev, void* ctx);
+    void on_send_queue_drained(std::shared_ptr<ClientInfo> ci);
+    // key 별 최신값 slot 에 보관 / global seq 순으로 MAGIC_TOPIC_CONFLATED 전송
+    void conflate_messages(const std::shared_ptr<ClientInfo>& ci, const MessageSlice* slices, size_t count, uint32_t topic_mask,
+                           const int32_t* symbols);
+    void flush_conflated(const std::shared_ptr<ClientInfo>& ci);
+    void clear_conflated(const std::shared_ptr<ClientInfo>& ci);
+    // conflate_mask 토픽: socket 이 비면(write callback) 또는 conflate_interval_ms 마다 flush
+    void arm_conflation_flush(const std::shared_ptr<ClientInfo>& ci);
+    static void static_conflate_timer_cb(evutil_socket_t, short, void* ctx);
+    // write coalescing: 직전 송신 후 max_delay 안에 다시 쓰는 batch 는 EV_WRITE 를 꺼두고 output 에 모았다가
+    // flush_bytes 이상이 되거나 max_delay 가 지나면 한번에 내보낸다 (조용할 때는 바로 송신, 0: 사용 안함)
+    size_t _coalesce_flush_bytes{0};
+    uint64_t _coalesce_delay_ns{0};
+    StatsCounter _write_coalesced{"publisher.write_coalesced"};         // 모아서 보낸 batch 수 (클라이언트별 합)
+    StatsCounter _write_coalesce_flushes{"publisher.write_coalesce_flushes"};
+    void coalesce_before_write(const std::shared_ptr<ClientInfo>& ci, evbuffer* out, uint64_t now);
+    void coalesce_after_write(const std::shared_ptr<ClientInfo>& ci, evbuffer* out, uint64_t now);
+    // 모은 output 을 socket write 로 넘김 (bev 를 다른 base 로 옮기기 전에도 호출)
+    void release_write_hold(const std::shared_ptr<ClientInfo>& ci);
+    static void static_coalesce_timer_cb(evutil_socket_t, short, void* ctx);
+    void disconnect_client(std::shared_ptr<ClientInfo> ci);
+    // RecoveryResponse 전송 후 last_seq 이후 구간을 복구 워커로 넘김
+    void begin_recovery(std::shared_ptr<ClientInfo> ci, uint32_t last_seq);
     
     friend struct RecoveryWorker;
 
     // accept
     static void static_accept_cb(evconnlistener*,evutil_socket_t fd,sockaddr*,int,void*ptr);
-    void on_accept(evutil_socket_t fd);
+    static void static_tcp_accept_cb(evconnlistener*,evutil_socket_t fd,sockaddr*,int,void*ptr);
+    static void static_reactor_accept_cb(evconnlistener*,evutil_socket_t fd,sockaddr*,int,void*ptr);
+    /* r 이 있으면 그 reactor 스레드에서 호출 (bev 는 r->base, 클라이언트는 r 담당) */
+    void on_accept(evutil_socket_t fd, bool tcp, IoReactor* r = nullptr);
     // read
     static void static_read_cb(bufferevent*bev,void*ctx);
     void on_read(bufferevent*bev,std::shared_ptr<ClientInfo>ci);
@@ -119,6 +484,13 @@ private:
     
     // main notify
     void main_notify_cb(evutil_socket_t fd);
+    // 넘겨받은 클라이언트 (hand_off_bufferevent 로 이 스레드 base 에 assign 됨) 를 enable 하고
+    // recovery cursor 부터 live_seq 까지 보낸 뒤 ONLINE, 보낸 메시지 수 반환 (RangeFetchRequest 연결은 꼬리 없이 CONNECTED 로 되돌림)
+    uint32_t resume_client(std::shared_ptr<ClientInfo> ci, uint32_t live_seq);
+
+    // 구독자 스냅샷 재생성 (_clients_mu 보유 상태에서 호출)
+    void rebuild_subscriber_snapshot_locked();
+    void rebuild_subscriber_snapshot();
 
 public:
     // 생성자/소멸자
@@ -131,6 +503,11 @@ public:
     void set_unix_path(const std::string &path);
     void set_tcp_address(const std::string &address);
     void set_tcp_port(uint16_t port);
+    // accept 한 TCP socket 에 SO_BUSY_POLL 설정 (spin event loop 와 함께 사용)
+    void set_socket_busy_poll(int busy_poll_us) { _socket_profile.busy_poll_us = busy_poll_us; }
+    // accept 하는 구독자 socket 에 적용할 옵션 (이미 연결된 구독자는 그대로), start() 전에 설정
+    void set_socket_profile(const SocketProfile& profile) { _socket_profile = profile; }
+    const SocketProfile& get_socket_profile() const { return _socket_profile; }
 
     void set_publisher_id(uint32_t id) {_publisher_id = id;}
     void set_publisher_name(const std::string &name) {_publisher_name = name;}
@@ -138,14 +515,60 @@ public:
     inline uint32_t get_publisher_id() const {return _publisher_id;}
     // Sequence Storage initialization (스토리지 생성, 초기화, sequence record 로드)
     bool init_sequence_storage(StorageType storage_type);
-    // Database initialization
+    // init_sequence_storage 전에 호출, >0 이면 sequence record 를 flush_ms 주기로 write-behind 저장 (0: batch 마다 저장)
+    void set_sequence_write_behind(uint32_t flush_ms) { _sequence_flush_ms = flush_ms; }
+    // Database initialization (db_path가 비어있으면 Memory_SAM, 아니면 DB_SAM)
     bool init_database(const std::string& db_path);
+    bool init_database(const std::string& db_path, MessageDBType db_type,
+                       const MMapSyncPolicy& sync_policy = MMapSyncPolicy());
+    // init_database 전에 호출, FILE(DB_SAM) 데이터를 block 단위로 압축 저장 (실시간 전송은 그대로, 복구는 get_range 로)
+    void set_database_compression(BlockCodec codec, size_t block_size = DB_SAM_BLOCK_SIZE) {
+        _db_compression = codec;
+        _db_block_size = block_size;
+    }
+    // init_database 전에 호출, SEGMENTED(SEGMENT_SAM) 의 segment 크기 / 날짜별 roll / 보존 정책
+    void set_database_segments(const SegmentPolicy& policy) { _db_segment_policy = policy; }
+    // init_database 전에 호출, MEMORY(Memory_SAM) 를 max_bytes 상한의 ring 으로 (넘으면 오래된 chunk 부터 버림, 0: 무제한)
+    void set_database_memory_limit(size_t max_bytes, size_t chunk_size = Memory_SAM::DEFAULT_CHUNK_SIZE) {
+        _db_memory_max_bytes = max_bytes;
+        _db_memory_chunk_size = chunk_size;
+    }
+    // init_database 전에 호출, 파일 DB 기록을 writer 스레드로 넘김 (publish 는 메모리 tail 에만 쓰고 반환)
+    void set_database_write_behind(bool enable, const DurableLagPolicy& policy = DurableLagPolicy()) {
+        _db_write_behind = enable;
+        _db_lag_policy = policy;
+    }
 
     MessageDB* db(){return _db.get();}
+    // DB 가 파일에 내린 (crash 에도 남는) 마지막 global seq, write-behind / 압축 block 이면 max_seq 보다 뒤일 수 있다
+    inline uint32_t get_db_durable_seq() const { return _db ? _db->durable_max_seq() : 0; }
     event_base* main_base(){return _main_base;}
     size_t get_client_count() const;
     inline int get_publisher_date() const {return _publisher_sequence_record->publisher_date;}
     uint32_t get_current_sequence() const ;
+    // 마스터 내용 식별값 (T2MA: 적재한 CSV signature), 정상 종료 시 시퀀스 레코드에 같이 seal
+    void set_master_generation(uint32_t generation) { _master_generation = generation; }
+    // 지난 실행이 정상 종료했고 레코드 / DB tail 이 seal 과 맞으면 true (init_database 이후 유효)
+    bool is_warm_restart() const { return _warm_restart; }
+    // warm restart 일 때 지난 실행이 seal 한 master generation (아니면 0)
+    uint32_t sealed_master_generation() const { return _warm_restart ? _restart_master_generation : 0; }
+    const PublisherSequenceRecord* get_sequence_record() const { return _publisher_sequence_record; }
+
+    // hot standby (PublisherReplica): publish / publish_batch 는 버리고 republish_batch 로 받은 primary 스트림만
+    // DB / 시퀀스에 기록한다. 승격 시 false 로 바꾸고 start() 하면 같은 global seq 에서 이어 발행
+    void set_standby(bool standby) { _standby = standby; }
+    bool is_standby() const { return _standby; }
+    inline uint64_t get_standby_dropped() const { return _standby_dropped.value(); }
+
+    // socket 구독자 fan-out 을 count 개 I/O 스레드로 분산 (start() 전에 호출, cpus[i % size] 에 고정)
+    void set_io_reactors(size_t count, const std::vector<int>& cpus = std::vector<int>());
+    inline size_t get_io_reactor_count() const { return _reactors.size(); }
+    // 복구 worker 스레드를 cpus[i % size] 에 고정 (start() 전에 호출, 비어있으면 고정 안함)
+    void set_recovery_cpus(const std::vector<int>& cpus);
+    // start() 전에 호출, io reactor 가 있으면 TCP 는 reactor 별 SO_REUSEPORT listener 로 받는다 (reactor 가 없으면 무시)
+    void set_tcp_reactor_acceptors(bool enable) { _tcp_reactor_acceptors = enable; }
+    // reactor 별 accept 한 연결 수 (reactor acceptor 를 쓰지 않으면 비어 있음)
+    std::vector<uint64_t> get_reactor_accept_counts() const;
 
     // 서버 시작/종료
     bool start(size_t recovery_thread_count = 2);
@@ -160,6 +583,68 @@ public:
     
     // 메시지 발행
     void publish(DataTopic topic, const char* data, size_t size);
+    // 일괄 발행 - 시퀀스 구간 하나를 예약하고 DB/시퀀스 저장/클라이언트 전송을 batch 단위로 한번씩 수행
+    void publish_batch(const PublishItem* items, size_t count);
+    void publish_batch(const std::vector<PublishItem>& items) { publish_batch(items.data(), items.size()); }
+    // 기록된 TopicMessage (DB replay 등) 를 그대로 발행 - timestamp 는 유지하고, global seq 가 이 publisher 의
+    // 다음 seq 와 이어지면 global/topic seq 도 유지 (아니면 publish_batch 처럼 새로 매김)
+    void republish_batch(const MessageSlice* messages, size_t count);
+
+    // micro-batching 모드: publish()는 staging만 하고 다음 이벤트 루프 턴에 flush
+    void set_micro_batching(bool enable);
+    bool is_micro_batching() const { return _micro_batching; }
+    void flush_batch();
+
+    // 공유메모리 로그 활성화 (init_sequence_storage 이후 호출, MAGIC_SHM_SUBSCRIBE 구독자가 사용)
+    bool enable_shm_log(const std::string& name, size_t capacity);
+    const ShmTopicLog* shm_log() const { return _shm_log.get(); }
+
+    // UDP multicast 송신 활성화 (address "group:port", MAGIC_MCAST_SUBSCRIBE 구독자가 사용)
+    // max_datagram 은 TopicMessage 들을 묶을 datagram 크기 (MTU 이하 권장)
+    bool enable_multicast(const std::string& address, const std::string& iface = "", int ttl = 1,
+                          size_t max_datagram = 1400);
+    inline uint64_t get_multicast_datagrams() const { return _mcast_datagrams; }
+    inline uint64_t get_multicast_drops() const { return _mcast_drops; }
+
+    // topic 의 레코드 레이아웃 등록 (start() 전에 호출, 같은 topic 에 여러 개면 payload 크기로 고른다)
+    // WIRE_ENCODING_COMPACT 로 구독한 socket 클라이언트는 그 레이아웃 payload 를 MAGIC_TOPIC_WIRE 로 받는다
+    void add_wire_layout(DataTopic topic, std::shared_ptr<RecordLayout> layout);
+    inline uint64_t get_wire_encoded() const { return _wire_encoded.value(); }
+    inline uint64_t get_wire_bytes_saved() const { return _wire_bytes_saved.value(); }
+
+    // 느린 구독자 정책: output evbuffer 가 high_watermark(bytes) 이상이면 policy 적용 (0: 제한 없음)
+    void set_slow_consumer_policy(SlowConsumerPolicy policy, size_t high_watermark);
+    bool set_client_high_watermark(uint32_t client_id, size_t high_watermark);
+    // 고빈도 구간의 작은 write 모으기 (max_delay_us 0: 사용 안함), start() 전에 설정
+    // EVLOOP_ONCE (epoll 대기) 에서는 timer 가 ms 단위로 올림되므로 max_delay 도 그만큼 늘 수 있다 (spin loop 는 그대로)
+    void set_write_coalescing(size_t flush_bytes, uint32_t max_delay_us) {
+        _coalesce_flush_bytes = flush_bytes;
+        _coalesce_delay_ns = static_cast<uint64_t>(max_delay_us) * 1000;
+    }
+    inline uint64_t get_write_coalesced() const { return _write_coalesced.value(); }
+    inline uint64_t get_write_coalesce_flushes() const { return _write_coalesce_flushes.value(); }
+    void set_conflation_key(ConflationKeyFn key_fn) { _conflation_key = key_fn; }
+    /* 종목 필터 구독 허용: index_fn 은 메시지 -> 종목 index, resolve_fn 은 종목 key -> index (start() 전에 설정) */
+    void set_symbol_index(SymbolIndexFn index_fn, SymbolResolveFn resolve_fn) {
+        _symbol_index = index_fn;
+        _symbol_resolve = resolve_fn;
+    }
+    inline uint64_t get_symbol_filtered() const { return _symbol_filtered.value(); }
+    // 복구 전송 대역폭 (모든 워커 합, bytes/s, 0: 제한 없음), 남은 메시지가 priority_messages 이하인 복구는 제한 없이 보냄
+    void set_recovery_bandwidth(uint64_t bytes_per_sec, uint32_t priority_messages);
+    inline uint64_t get_recovery_bytes() const { return _recovery_bytes.value(); }
+    inline uint64_t get_recovery_throttled() const { return _recovery_throttled.value(); }
+    inline uint64_t get_range_fetches() const { return _range_fetches.value(); }
+    // 최근 메시지 캐시 (messages 개 또는 bytes 까지, 0 이면 사용 안함), start() 전에 설정
+    void set_hot_tail_cache(size_t messages, size_t bytes);
+    inline uint64_t get_hot_tail_hits() const { return _hot_tail_hits.value(); }
+    inline uint64_t get_hot_tail_misses() const { return _hot_tail_misses.value(); }
+    std::vector<ClientQueueStats> get_client_queue_stats();
+    std::vector<ReplicaStatus> get_replica_status();
+    inline uint64_t get_slow_consumer_events() const { return _slow_consumer_events.value(); }
+    inline uint64_t get_messages_sent() const { return _messages_sent.value(); }
+    // publish_batch 단계별 지연 히스토그램 ("latency.publisher.*"), publish 시작 전에 설정
+    void set_latency_tracking(bool enable) { _latency.reset(enable ? new PublisherLatency() : nullptr); }
     
     /*
     // 이벤트 핸들러
@@ -171,6 +656,20 @@ public:
     // 메시지 처리
     void handle_subscription_request(std::shared_ptr<ClientInfo> ci, const SubscriptionRequest* request);
     void handle_recovery_request(std::shared_ptr<ClientInfo> ci, const RecoveryRequest* request);
+    /* ONLINE 구독자의 누락 구간만 DB 에서 바로 전송 (bev 를 가진 스레드에서 호출) */
+    void handle_gap_recovery_request(std::shared_ptr<ClientInfo> ci, const GapRecoveryRequest* request);
+    /* ci->gap_ranges 를 송신 큐 watermark 아래에서 chunk 단위로 전송 (남으면 write callback 에서 이어서) */
+    void pump_gap_recovery(const std::shared_ptr<ClientInfo>& ci);
+    /* 구독하지 않은 연결의 [from_seq, to_seq] 를 워커가 보내고 RecoveryComplete (연결은 다음 요청을 위해 CONNECTED 로) */
+    void handle_range_fetch_request(std::shared_ptr<ClientInfo> ci, const RangeFetchRequest* request);
+    /* since_ns 를 DB 시간 인덱스로 seq 로 바꿔 handle_recovery_request 로 넘김 */
+    void handle_time_recovery_request(std::shared_ptr<ClientInfo> ci, const TimeRecoveryRequest* request);
+    /* 토픽 id 목록을 TopicRegistry slot 비트셋으로 바꿔 ci->topic_filter 에 두고 스냅샷 갱신 */
+    void handle_topic_filter_request(std::shared_ptr<ClientInfo> ci, const TopicFilterRequest* request);
+    /* 종목 key 목록을 _symbol_resolve 로 index 비트셋으로 바꿔 ci->symbol_filter 에 두고 스냅샷 갱신 */
+    void handle_symbol_filter_request(std::shared_ptr<ClientInfo> ci, const SymbolFilterRequest* request);
+    /* standby 의 기록 확인 (응답 없음, get_replica_status 로 lag 확인) */
+    void handle_replica_ack(std::shared_ptr<ClientInfo> ci, const ReplicaAck* ack);
 
     void enqueue_return_client(std::shared_ptr<ClientInfo> ci);
 
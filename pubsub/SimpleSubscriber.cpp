@@ -1,28 +1,109 @@
 #include "SimpleSubscriber.h"
 #include <iostream>
+#include <algorithm>
 #include <cstring>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/eventfd.h>
+
+// waiter 가 futex 에서 깨어나 _shm_running 을 다시 확인하는 주기
+static const long SHM_LOG_WAIT_TIMEOUT_US = 100000;
+// event loop 한 턴에 shm 로그에서 처리할 최대 메시지 수
+static const int SHM_LOG_MAX_READS_PER_WAKEUP = 1024;
+// 복구 중 보관할 multicast 메시지 최대 수 (넘치면 오래된 것부터 버리고 replay 시 다시 복구)
+static const size_t MCAST_MAX_PENDING = 65536;
+// multicast 수신 socket buffer (복구 중 burst 흡수)
+static const int MCAST_RECEIVE_BUFFER = 8 * 1024 * 1024;
+// 일련번호 지연 저장 기본값 (메시지 수 / 시간)
+static const uint32_t SEQ_PERSIST_EVERY_MESSAGES = 1024;
+static const uint32_t SEQ_PERSIST_INTERVAL_MS = 100;
+// 병렬 복구 중 보관할 live 메시지 bytes (넘으면 뒤는 버리고 끝난 뒤 RecoveryRequest 로 다시 받음)
+static const size_t FETCH_MAX_PENDING_BYTES = 256 * 1024 * 1024;
+// 누락 구간이 구간 복구로 채워지기를 기다리는 시간 (넘으면 전체 복구), 보관할 최대 구간 수
+static const uint64_t SEQ_GAP_TIMEOUT_MS = 1000;
+static const size_t SEQ_GAP_MAX_RANGES = 1024;
+// 시간 기반 저장을 끈 경우 구간 timeout 확인 주기
+static const uint32_t SEQ_GAP_CHECK_INTERVAL_MS = 100;
 
 SimpleSubscriber::SimpleSubscriber(struct event_base* shared_event_base)
-    : _libevent_base(shared_event_base) {
-    _protocol = new PubSubTopicProtocol();
+    : _libevent_base(shared_event_base), _gaps(SEQ_GAP_MAX_RANGES) {
+    _socket_events.self = this;
     _subscription_mask = 0;
     _current_status = CLIENT_OFFLINE;
     _socket_handler = nullptr;
+    _shared_parser = nullptr;
     _sequence_storage = nullptr;
     _publisher_sequence_record = new PublisherSequenceRecord();
+    _owns_sequence_record = true;
+    _stored_sequence_record = nullptr;
+    _shm_active = false;
+    _shm_notify_fd = -1;
+    _shm_notify_event = nullptr;
+    _shm_running = false;
+    _shm_messages_read = 0;
+    _shm_rewinds = 0;
+    _shm_overruns = 0;
+    _publisher_id = 0;
+    _mcast_receiver = nullptr;
+    _mcast_active = false;
+    _conflate_mask = 0;
+    _conflate_interval_ms = 0;
+    _wire_encoding = WIRE_ENCODING_NONE;
+    _wire_messages = 0;
+    _wire_decode_errors = 0;
+    _recovery_compression = BLOCK_CODEC_NONE;
+    _recovery_batches = 0;
+    _recovery_batch_errors = 0;
+    _quickack_fd = -1;
+    _batch_open = false;
+    _batch_calls = 0;
+    _mcast_next_seq = 0;
+    _mcast_resync = false;
+    _mcast_datagrams = 0;
+    _mcast_messages = 0;
+    _mcast_gaps = 0;
+    _mcast_pending_drops = 0;
+    _last_global_by_topic.assign(TopicRegistry::MAX_TOPICS, 0);
+    _topic_sequences.attach(_publisher_sequence_record);
+    _persist_every_messages = SEQ_PERSIST_EVERY_MESSAGES;
+    _persist_interval_ms = SEQ_PERSIST_INTERVAL_MS;
+    _unsaved_messages = 0;
+    _seq_timer = nullptr;
+    _seq_timer_armed = false;
+    _gaps_detected = 0;
+    _gaps_filled = 0;
+    _gap_fallbacks = 0;
+    _failover_socket_type = TCP_SOCKET;
+    _failover_port = 0;
+    _stopped = false;
+    _ordered_delivery = false;
+    _fetch_streams = 0;
+    _fetch_chunk_messages = 0;
+    _fetch_min_messages = 0;
+    _fetch_active = false;
+    _fetch_overflow = false;
+    _fetch_pending_bytes = 0;
+    _parallel_recoveries = 0;
+    _parallel_recovery_failures = 0;
 }
 
 SimpleSubscriber::~SimpleSubscriber() {
+    persist_sequences(true);
+    if (_seq_timer) {
+        event_free(_seq_timer);
+    }
+    stop_shm_reader();
+    _shm_log.close();
+    if (_mcast_receiver) {
+        delete _mcast_receiver;
+    }
     if (_socket_handler) {
         delete _socket_handler;
     }
-    if (_protocol) {
-        delete _protocol;
-    }
     if (_sequence_storage) {
         delete _sequence_storage;
     }
-    if (_publisher_sequence_record && _sequence_storage_type == StorageType::FILE_STORAGE) {
+    if (_owns_sequence_record) {
         delete _publisher_sequence_record;
     }
 }
@@ -38,8 +119,15 @@ void SimpleSubscriber::set_address(SocketType socket_type, std::string address,
     _port = port;
 }
 
+void SimpleSubscriber::set_failover_address(SocketType socket_type, std::string address, int port) {
+    _failover_socket_type = socket_type;
+    _failover_address = address;
+    _failover_port = port;
+}
+
 void SimpleSubscriber::set_client_info(uint32_t id, const std::string& name, uint32_t pub_id, const std::string& pub_name) {
     _subscriber_id = id * 10000 + pub_id;
+    _publisher_id = pub_id;
     _subscriber_name = name + "_" + pub_name;
 }
 
@@ -54,21 +142,36 @@ void SimpleSubscriber::set_sequence_storage(SequenceStorage* sequence_storage) {
 
 bool SimpleSubscriber::init_sequence_storage(StorageType storage_type) {
     _sequence_storage_type = storage_type;
+    if (_owns_sequence_record) {
+        delete _publisher_sequence_record;
+    }
+    _publisher_sequence_record = nullptr;
+    _owns_sequence_record = false;
+    _stored_sequence_record = nullptr;
+    std::string topics_path;
     if(_sequence_storage_type == StorageType::FILE_STORAGE) {
         std::string seq_file = "sub_" + _subscriber_name + ".seq";
         std::string storage_dir = "./data/sequence_data";
+        topics_path = storage_dir + "/sub_" + _subscriber_name + ".topics";
         _sequence_storage = new FileSequenceStorage(storage_dir, seq_file);
         _publisher_sequence_record = new PublisherSequenceRecord(get_publisher_name(), 0, 0);
+        _owns_sequence_record = true;
     } else {
         std::string storage_path = "./sequence_data/sub" + _subscriber_name + "_sequences";
+        topics_path = storage_path + ".topics";
         _sequence_storage = new HashmasterSequenceStorage(storage_path);
     }
     _sequence_storage->initialize();
 
-    // HashMaster storage의 경우 mmap 포인터를 직접 사용
+    // HashMaster storage 는 mmap 레코드를 저장 위치로 두고, 수신은 프로세스 메모리 사본을 갱신
+    // (누락 구간이 열린 채 죽어도 mmap 에는 구간 이전으로 낮춘 값만 남도록)
     if(_sequence_storage_type == StorageType::HASHMASTER_STORAGE) {
         HashmasterSequenceStorage* hashmaster_storage = static_cast<HashmasterSequenceStorage*>(_sequence_storage);
-        _publisher_sequence_record = hashmaster_storage->load_sequences_direct(get_publisher_name());
+        _stored_sequence_record = hashmaster_storage->load_sequences_direct(get_publisher_name());
+        if (_stored_sequence_record) {
+            _publisher_sequence_record = new PublisherSequenceRecord(*_stored_sequence_record);
+            _owns_sequence_record = true;
+        }
     } else {
         _sequence_storage->load_sequences(get_publisher_name(), _publisher_sequence_record);
     }
@@ -76,52 +179,99 @@ bool SimpleSubscriber::init_sequence_storage(StorageType storage_type) {
         std::cerr << "Failed to load sequence record" << std::endl;
         return false;
     }
+    // 확장 토픽도 같은 방식: .topics 파일은 저장 위치, 수신은 메모리 테이블
+    const TopicRegistry& registry = TopicRegistry::global();
+    if (!registry.has_extended() || !_stored_topic_sequences.open(topics_path, registry)) {
+        _stored_topic_sequences.open("", registry);
+    }
+    _topic_sequences.open("", registry);
+    _topic_sequences.copy_extended(_stored_topic_sequences);
+    _topic_sequences.attach(_publisher_sequence_record);
     return true;
 }
 
+bool SimpleSubscriber::attach_sequence_record(PublisherSequenceRecord* record, const std::string& topics_path) {
+    if (record == nullptr) {
+        std::cerr << "Failed to attach sequence record" << std::endl;
+        return false;
+    }
+    if (_owns_sequence_record) {
+        delete _publisher_sequence_record;
+    }
+    _sequence_storage_type = StorageType::HASHMASTER_STORAGE;
+    _sequence_storage = nullptr;
+    _publisher_sequence_record = record;
+    _owns_sequence_record = false;
+    _stored_sequence_record = nullptr;
+    const TopicRegistry& registry = TopicRegistry::global();
+    if (!registry.has_extended() || topics_path.empty() || !_topic_sequences.open(topics_path, registry)) {
+        _topic_sequences.open("", registry);
+    }
+    _topic_sequences.attach(_publisher_sequence_record);
+    return true;
+}
+
+void SimpleSubscriber::set_topic_filter(const std::vector<DataTopic>& topics) {
+    _topic_filter_ids.clear();
+    _topic_filter = TopicFilter();
+    for (DataTopic topic : topics) {
+        int slot = topic_index(topic);
+        if (slot < 0) {
+            std::cerr << "set_topic_filter: unknown topic " << static_cast<uint32_t>(topic) << std::endl;
+            continue;
+        }
+        _topic_filter_ids.push_back(static_cast<uint32_t>(topic));
+        _topic_filter.add(slot);
+    }
+}
+
+void SimpleSubscriber::set_symbol_filter(const std::vector<std::string>& symbols) {
+    _symbol_filter.clear();
+    for (const std::string& symbol : symbols) {
+        if (symbol.empty() || symbol.size() >= SYMBOL_KEY_SIZE) {
+            std::cerr << "set_symbol_filter: invalid symbol '" << symbol << "'" << std::endl;
+            continue;
+        }
+        if (_symbol_filter.size() >= MAX_SYMBOL_FILTER) {
+            std::cerr << "set_symbol_filter: too many symbols (max " << MAX_SYMBOL_FILTER << ")" << std::endl;
+            break;
+        }
+        _symbol_filter.push_back(symbol);
+    }
+}
+
 bool SimpleSubscriber::connect() {
     std::cout << "Connecting to " << (_socket_type == UNIX_SOCKET ? "Unix socket" : "TCP socket") << ": " << _address << std::endl;
+    _stopped = false;
     
     if (_socket_handler) {
         delete _socket_handler;
         _socket_handler = nullptr;
     }
     
-    std::string socket_type_str;
-    if (_socket_type == UNIX_SOCKET) {
-        socket_type_str = "unix_domain_socket";
-    } else if (_socket_type == TCP_SOCKET) {
-        socket_type_str = "tcp_socket";
-    } else {
+    if (_socket_type != UNIX_SOCKET && _socket_type != TCP_SOCKET) {
         std::cerr << "Unknown socket type" << std::endl;
         return false;
     }
     
-    // EventBase wrapper 생성
-    _socket_handler = createEventBase(socket_type_str, _libevent_base, false);
-    if (!_socket_handler) {
-        std::cerr << "Failed to create socket handler" << std::endl;
-        return false;
+    // 수신은 PubSubTopicFrame 으로 파싱해 SocketEvents 로 바로 전달
+    _socket_handler = new SocketConnection(_libevent_base, _socket_events);
+    _socket_handler->set_frame_parser(_shared_parser);
+    _quickack_fd = -1;
+    if (!_socket_profile.empty()) {
+        bool tcp = _socket_type == TCP_SOCKET;
+        _socket_handler->set_socket_setup([this, tcp](evutil_socket_t fd) {
+            apply_socket_profile(fd, _socket_profile, tcp);
+        });
     }
     
-    // Protocol 및 콜백 설정
-    _socket_handler->setProtocol(_protocol);
-    _socket_handler->setReadCallback([this](char *data, int size) {
-        handle_incomming_messages(data, size);
-    });
-    _socket_handler->setConnectCallback([this](char *data, int size) {
-        handle_connected(data, size);
-    });
-    _socket_handler->setDisconnectCallback([this](char *data, int size) {
-        handle_disconnected(data, size);
-    });
-    _socket_handler->setErrorCallback([this](char *data, int size) {
-        handle_error(data, size);
-    });
-    
-    // 서버에 연결 시도
+    // 서버에 연결 시도 (tcp 는 "host:port")
     try {
-        _socket_handler->connect(_address);
+        if (_socket_type == TCP_SOCKET) {
+            _socket_handler->connectTcp(_address + ":" + std::to_string(_port));
+        } else {
+            _socket_handler->connectUnix(_address);
+        }
     } catch (const std::exception& e) {
         std::cerr << "Failed to connect: " << e.what() << std::endl;
         return false;
@@ -135,6 +285,15 @@ void SimpleSubscriber::try_reconnect() {
     event_base_once(_libevent_base, -1, EV_TIMEOUT,
         [](evutil_socket_t fd, short event, void *arg) {
             SimpleSubscriber* self = static_cast<SimpleSubscriber*>(arg);
+            if (self->_stopped) {
+                return;
+            }
+            if (!self->_failover_address.empty()) {
+                // 기본 / 대체 주소를 번갈아 (standby 가 승격했으면 그쪽에서 구독이 이어짐)
+                std::swap(self->_socket_type, self->_failover_socket_type);
+                std::swap(self->_address, self->_failover_address);
+                std::swap(self->_port, self->_failover_port);
+            }
             std::cout << "Attempting reconnection..." << std::endl;
             if (!self->connect()) {
                 std::cout << "Reconnection failed, will retry in 1 second..." << std::endl;
@@ -151,26 +310,87 @@ void SimpleSubscriber::set_topic_callback(TopicDataCallback callback) {
     _topic_callback = callback;
 }
 
+void RecordViewPool::add(DataTopic topic, std::shared_ptr<RecordLayout> layout) {
+    if (!layout || layout->getRecordSize() <= 0) {
+        std::cerr << "add_record_layout: invalid layout" << std::endl;
+        return;
+    }
+    Slot slot;
+    slot.topic = topic;
+    slot.layout = layout;
+    slot.used = 0;
+    _slots.push_back(std::move(slot));
+}
+
+const BinaryRecord* RecordViewPool::bind(DataTopic topic, const char* data, uint32_t size) {
+    for (auto& slot : _slots) {
+        if (slot.topic != topic || static_cast<uint32_t>(slot.layout->getRecordSize()) != size) continue;
+        if (slot.used == slot.records.size()) {
+            slot.records.emplace_back(new BinaryRecord(slot.layout, nullptr));
+        }
+        BinaryRecord* record = slot.records[slot.used++].get();
+        record->setBuffer(const_cast<char*>(data));
+        return record;
+    }
+    return nullptr;
+}
+
+void RecordViewPool::reset() {
+    for (auto& slot : _slots) {
+        for (size_t i = 0; i < slot.used; ++i) slot.records[i]->setBuffer(nullptr);
+        slot.used = 0;
+    }
+}
+
+void SimpleSubscriber::add_record_layout(DataTopic topic, std::shared_ptr<RecordLayout> layout) {
+    _record_views.add(topic, layout);
+}
+
 void SimpleSubscriber::handle_connected(char* data, int size) {
     std::cout << "Connected to publisher" << std::endl;
     change_status(CLIENT_CONNECTED);
+    if (!_socket_profile.empty() && _socket_handler && _socket_handler->getBev()) {
+        bufferevent* bev = _socket_handler->getBev();
+        apply_bufferevent_profile(bev, _socket_profile);
+        if (_socket_profile.tcp_quickack && _socket_type == TCP_SOCKET) {
+            _quickack_fd = bufferevent_getfd(bev);
+        }
+    }
+    // publisher 재시작 시 로그가 새로 만들어지므로 연결마다 다시 open
+    stop_shm_reader();
+    if (!_shm_log_name.empty() && !_shm_log.open(_shm_log_name, _subscriber_id)) {
+        std::cerr << "Shm log " << _shm_log_name << " unavailable, subscribing over socket" << std::endl;
+    }
+    // multicast 수신 socket 은 재연결 사이에도 유지 (구독 전에 join 해서 복구 중 datagram 도 보관)
+    _mcast_active = false;
+    if (!_shm_log.is_open() && !_mcast_address.empty() && !start_multicast_receiver()) {
+        std::cerr << "Multicast " << _mcast_address << " unavailable, subscribing over socket" << std::endl;
+    }
     send_subscription_request();
 }
 
 void SimpleSubscriber::handle_disconnected(char* data, int size) {
     std::cout << "Disconnected from publisher" << std::endl;
     change_status(CLIENT_OFFLINE);
+    cancel_parallel_recovery();
+    _quickack_fd = -1;
+    stop_shm_reader();
+    _mcast_active = false;
     try_reconnect();
 }
 
 void SimpleSubscriber::handle_error(char* data, int size) {
     std::cout << "Error occurred, will reconnect in 1 second..." << std::endl;
     change_status(CLIENT_OFFLINE);
+    cancel_parallel_recovery();
+    _quickack_fd = -1;
+    stop_shm_reader();
+    _mcast_active = false;
     try_reconnect();
 }
 
 int SimpleSubscriber::validate_sequence(DataTopic topic, uint32_t sequence) {
-    uint32_t current_seq = _publisher_sequence_record->get_topic_sequence(topic);
+    uint32_t current_seq = _topic_sequences.get(topic);
     if(sequence == (current_seq + 1)) {
         return 0;
     } else if(sequence <= current_seq) {
@@ -179,78 +399,461 @@ int SimpleSubscriber::validate_sequence(DataTopic topic, uint32_t sequence) {
     return 1;
 }
 
+void SimpleSubscriber::handle_incomming_batch(const ProtocolMessage* messages, size_t count) {
+    size_t i = 0;
+    while (i < count) {
+        // 이어지는 TopicMessage 는 한번에 검증하고, 예외 (누락/중복/제어 메시지) 만 한 건씩 처리
+        i += handle_topic_run(messages + i, count - i);
+        if (i < count) {
+            uint32_t magic;
+            memcpy(&magic, messages[i].data, sizeof(uint32_t));
+            handle_incomming_messages(const_cast<char*>(messages[i].data), static_cast<int>(messages[i].length));
+            ++i;
+            if (magic == MAGIC_SUB_OK && _fetch_active && i < count) {
+                // 구독 응답으로 병렬 복구가 시작됨: 같은 read 에 이어 온 live 메시지는 보관
+                hold_live_frames(messages + i, count - i);
+                return;
+            }
+        }
+    }
+}
+
+size_t SimpleSubscriber::handle_topic_run(const ProtocolMessage* messages, size_t count) {
+    if (_current_status != CLIENT_ONLINE || _shm_active) {
+        return 0;
+    }
+    PublisherSequenceRecord* record = _publisher_sequence_record;
+    uint64_t now = _latency ? get_current_timestamp() : 0;     // run 당 한번
+    size_t n = 0;
+    while (n < count) {
+        const ProtocolMessage& m = messages[n];
+        if (m.length < sizeof(TopicMessage)) break;
+        const TopicMessage* msg = reinterpret_cast<const TopicMessage*>(m.data);
+        if (msg->magic != MAGIC_TOPIC_MSG && msg->magic != MAGIC_TOPIC_WIRE) break;
+        int index = topic_index(msg->topic);
+        if (index < 0 || topic_filtered_out(msg->topic)) break;
+        uint32_t* topic_seq = topic_sequence_field(index);
+        if (msg->topic_seq != *topic_seq + 1 && (_symbol_filter.empty() || msg->topic_seq <= *topic_seq)) break;
+        if (_ordered_delivery && msg->global_seq != record->all_topics_sequence + 1) break;
+
+        *topic_seq = msg->topic_seq;
+        if (msg->global_seq > record->all_topics_sequence) {
+            record->all_topics_sequence = msg->global_seq;
+        }
+        _last_global_by_topic[index] = msg->global_seq;
+        ++n;
+        if (_latency) {
+            _latency->record(TopicRegistry::group_slot(msg->topic), now, msg->timestamp);
+        }
+        deliver_topic_message(*msg);
+        if (_current_status != CLIENT_ONLINE) break;    // 콜백에서 stop 등
+    }
+    if (n > 0) {
+        record->last_updated_time = get_current_timestamp();
+        note_sequence_update(static_cast<uint32_t>(n));
+    }
+    return n;
+}
+
 void SimpleSubscriber::handle_incomming_messages(char* data, int size) {
     uint32_t magic = 0;
     memcpy(&magic, data, sizeof(uint32_t));
-    std::cout << "Received message - magic: 0x" << std::hex << magic << std::dec << " (" << magic << "), size: " << size << std::endl;
-    std::cout << "Expected magics - TOPIC_MSG: 0x" << std::hex << MAGIC_TOPIC_MSG << ", SUB_OK: 0x" << MAGIC_SUB_OK << std::dec << std::endl;
+    ALOG_DEBUG("SimpleSubscriber", "Received message - magic: 0x%x, size: %d", magic, size);
     
     switch(magic) {
         case MAGIC_TOPIC_MSG:
-            std::cout << "Handling TOPIC_MSG" << std::endl;
+        case MAGIC_TOPIC_CONFLATED:
+        case MAGIC_TOPIC_WIRE:
             handle_topic_message(*reinterpret_cast<const TopicMessage*>(data));
             break;
         case MAGIC_SUB_OK:
-            std::cout << "Handling SUBSCRIPTION_RESPONSE" << std::endl;
             handle_subscription_response(*reinterpret_cast<const SubscriptionResponse*>(data));
             break;
         case MAGIC_RECOVERY_RES:
-            std::cout << "Handling RECOVERY_RESPONSE" << std::endl;
             handle_recovery_response(*reinterpret_cast<const RecoveryResponse*>(data));
             break;
         case MAGIC_RECOVERY_CMP:
-            std::cout << "Handling RECOVERY_COMPLETE" << std::endl;
             handle_recovery_complete(*reinterpret_cast<const RecoveryComplete*>(data));
             break;
+        case MAGIC_RECOVERY_BATCH:
+            handle_recovery_batch(data, static_cast<size_t>(size));
+            break;
         default:
-            std::cout << "Unknown message type: 0x" << std::hex << magic << std::dec << std::endl;
+            ALOG_WARN("SimpleSubscriber", "Unknown message type: 0x%x", magic);
             break;
     }
 }
 
+void SimpleSubscriber::handle_recovery_batch(const char* data, size_t size) {
+    RecoveryBatch header;
+    if (size < sizeof(header)) {
+        _recovery_batch_errors++;
+        return;
+    }
+    memcpy(&header, data, sizeof(header));
+    if (sizeof(header) + header.stored_size > size) {
+        _recovery_batch_errors++;
+        return;
+    }
+    _recovery_batch_buffer.resize(header.raw_size);
+    if (!block_decompress(header.codec, data + sizeof(header), header.stored_size,
+                          _recovery_batch_buffer.data(), header.raw_size)) {
+        // 이 batch 의 메시지는 빠지므로 다음 메시지에서 누락으로 감지되어 다시 복구한다
+        std::cerr << "Failed to decompress recovery batch (" << block_codec_name(header.codec)
+                  << ", " << header.count << " messages)" << std::endl;
+        _recovery_batch_errors++;
+        return;
+    }
+    _recovery_batches++;
+
+    _recovery_batch_messages.clear();
+    const char* p = _recovery_batch_buffer.data();
+    const char* end = p + header.raw_size;
+    while (end - p >= static_cast<ptrdiff_t>(sizeof(TopicMessage))) {
+        const TopicMessage* msg = reinterpret_cast<const TopicMessage*>(p);
+        size_t length = sizeof(TopicMessage) + msg->data_size;
+        if (static_cast<size_t>(end - p) < length) break;
+        _recovery_batch_messages.push_back(ProtocolMessage{p, length});
+        p += length;
+    }
+    if (p != end || _recovery_batch_messages.size() != header.count) {
+        std::cerr << "Recovery batch has " << _recovery_batch_messages.size() << " of " << header.count
+                  << " messages" << std::endl;
+        _recovery_batch_errors++;
+    }
+    handle_incomming_batch(_recovery_batch_messages.data(), _recovery_batch_messages.size());
+    // 압축 해제 버퍼는 다음 RecoveryBatch 에서 다시 쓰므로 여기까지 모은 view 를 먼저 넘긴다
+    flush_topic_batch();
+}
+
 void SimpleSubscriber::handle_topic_message(const TopicMessage& topic_message) {
-    std::cout << "Received topic message - topic: " << topic_message.topic 
-              << ", global_seq: " << topic_message.global_seq 
-              << ", topic_seq: " << topic_message.topic_seq
-              << ", data_size: " << topic_message.data_size 
-              << ", currnet topic seq: " << _publisher_sequence_record->get_topic_sequence(topic_message.topic) << std::endl;
-    
+    ALOG_DEBUG("SimpleSubscriber", "Received topic message - topic: %u, global_seq: %u, topic_seq: %u, data_size: %u, current topic seq: %u",
+               static_cast<uint32_t>(topic_message.topic), topic_message.global_seq, topic_message.topic_seq,
+               topic_message.data_size, _topic_sequences.get(topic_message.topic));
+
+    if (topic_filtered_out(topic_message.topic)) {
+        // 복구 / shm / multicast 는 필터와 무관하게 전체 토픽이 오므로 여기서 버림 (topic seq 도 추적하지 않음)
+        return;
+    }
     int result = validate_sequence(topic_message.topic, topic_message.topic_seq);
+    if(result == 1 && (topic_message.magic == MAGIC_TOPIC_CONFLATED || is_topic_subscribed(_conflate_mask, topic_message.topic))) {
+        // publisher 가 key 별로 합친 최신값: 건너뛴 seq 는 복구 대상이 아님
+        result = 0;
+    }
+    if(result == 1 && !_symbol_filter.empty()) {
+        // 종목 필터: publisher 가 다른 종목 메시지를 건너뛴 것 (socket 은 연결 안에서 유실이 없고,
+        // 재연결 / 느린 구독자 resync 는 global seq 기준 전체 복구로 이어 받는다)
+        result = 0;
+    }
+    if(_ordered_delivery) {
+        // 다른 토픽 메시지가 빠진 것은 topic seq 로는 다음 그 토픽 메시지에서야 알 수 있으므로 global seq 로 판정
+        uint32_t last_seq = _publisher_sequence_record->get_topic_sequence(DataTopic::ALL_TOPICS);
+        result = topic_message.global_seq <= last_seq ? 2 : topic_message.global_seq == last_seq + 1 ? 0 : 1;
+    }
+    if(result == 2 && _gaps.fill(topic_message.topic, topic_message.topic_seq)) {
+        // 구간 복구로 채워진 메시지: 전달만 하고 topic seq 는 앞으로 그대로 둔다
+        _gaps_filled++;
+        note_sequence_update(1);
+        if (_latency) {
+            _latency->record(TopicRegistry::group_slot(topic_message.topic), get_current_timestamp(), topic_message.timestamp);
+        }
+        deliver_topic_message(topic_message);
+        return;
+    }
+    if(result == 1 && _current_status == CLIENT_ONLINE && !_shm_active && !_mcast_active && !_ordered_delivery &&
+       track_sequence_gap(topic_message)) {
+        // 누락 구간만 따로 복구, 이 메시지는 그대로 전달
+        result = 0;
+    }
     if(result == 1) {
-        std::cout << "Sequence lost" << std::endl;
+        ALOG_INFO("SimpleSubscriber", "Sequence lost (topic %u seq %u)", static_cast<uint32_t>(topic_message.topic), topic_message.topic_seq);
         if(_current_status == CLIENT_ONLINE) {
             change_status(CLIENT_RECOVERY_NEEDED);
-            send_recovery_request();
+            if(_shm_active) {
+                shm_rewind();
+            } else {
+                send_recovery_request();
+            }
         } else {
-            std::cout << "######\n#\tWarning: Client is not online, skip recovery" << std::endl;
+            ALOG_WARN("SimpleSubscriber", "Client is not online, skip recovery");
         }
         return;
     } else if(result == 2) {
-        std::cout << "Sequence duplicate, skip message" << std::endl;
+        ALOG_DEBUG("SimpleSubscriber", "Sequence duplicate, skip message (topic %u seq %u)", static_cast<uint32_t>(topic_message.topic), topic_message.topic_seq);
         return;
     }
 
-    _publisher_sequence_record->set_topic_sequence(topic_message.global_seq, topic_message.topic, topic_message.topic_seq);
-    if(_sequence_storage) {
-        _sequence_storage->save_sequences(*_publisher_sequence_record);
+    // conflation 된 메시지는 다른 토픽보다 늦게 올 수 있으므로 global seq 는 뒤로 돌리지 않음
+    uint32_t global_seq = std::max(topic_message.global_seq,
+                                   _publisher_sequence_record->get_topic_sequence(DataTopic::ALL_TOPICS));
+    _topic_sequences.set(global_seq, topic_message.topic, topic_message.topic_seq);
+    int index = topic_index(topic_message.topic);
+    if (index >= 0) {
+        _last_global_by_topic[index] = topic_message.global_seq;
+    }
+    note_sequence_update(1);
+    if (_latency) {
+        _latency->record(TopicRegistry::group_slot(topic_message.topic), get_current_timestamp(), topic_message.timestamp);
     }
     
     // 콜백 함수 호출
-    if (_topic_callback) {
-        _topic_callback(static_cast<DataTopic>(topic_message.topic), 
-                       topic_message.data, topic_message.data_size);
+    deliver_topic_message(topic_message);
+}
+
+void SimpleSubscriber::add_wire_layout(DataTopic topic, std::shared_ptr<RecordLayout> layout) {
+    if (!layout || layout->getRecordSize() <= 0) {
+        std::cerr << "add_wire_layout: invalid layout" << std::endl;
+        return;
+    }
+    WireLayout wl;
+    wl.topic = topic;
+    wl.codec = std::make_shared<const WireCodec>(layout);
+    wl.view.reset(new WireRecordView(wl.codec));
+    size_t need = std::max(static_cast<size_t>(layout->getRecordSize()), wl.codec->max_encoded_size());
+    if (_wire_buffer.size() < need) _wire_buffer.resize(need);
+    _wire_layouts.push_back(std::move(wl));
+}
+
+SimpleSubscriber::WireLayout* SimpleSubscriber::find_wire_layout(uint32_t layout_id) {
+    for (auto& wl : _wire_layouts) {
+        if (wl.codec->layout_id() == layout_id) return &wl;
+    }
+    return nullptr;
+}
+
+SimpleSubscriber::WireLayout* SimpleSubscriber::find_wire_layout(DataTopic topic, size_t size) {
+    for (auto& wl : _wire_layouts) {
+        if (wl.topic == topic && static_cast<size_t>(wl.codec->record_size()) == size) return &wl;
+    }
+    return nullptr;
+}
+
+void SimpleSubscriber::deliver_topic_message(const TopicMessage& msg) {
+    DataTopic topic = static_cast<DataTopic>(msg.topic);
+    if (msg.magic != MAGIC_TOPIC_WIRE) {
+        WireLayout* wl = _wire_callback ? find_wire_layout(topic, msg.data_size) : nullptr;
+        if (!wl) {
+            emit_topic_data(msg, msg.data, msg.data_size, true);
+            return;
+        }
+        // 복구/conflation 으로 온 원래 형식도 같은 콜백으로 (드문 경로라 한번 인코딩)
+        size_t n = wl->codec->encode(msg.data, msg.data_size, _wire_buffer.data(), _wire_buffer.size());
+        if (n > 0 && wl->view->attach(_wire_buffer.data(), n)) {
+            _wire_callback(topic, *wl->view);
+        } else {
+            _wire_decode_errors++;
+        }
+        return;
     }
+
+    _wire_messages++;
+    WireRecordHeader header;
+    WireLayout* wl = WireCodec::peek_header(msg.data, msg.data_size, header) ? find_wire_layout(header.layout_id) : nullptr;
+    if (!wl) {
+        if (_wire_decode_errors++ == 0) {
+            std::cerr << "Compact message for unregistered wire layout 0x" << std::hex << header.layout_id << std::dec
+                      << " (topic " << msg.topic << ", seq " << msg.global_seq << ")" << std::endl;
+        }
+        return;
+    }
+    if (_wire_callback) {
+        if (wl->view->attach(msg.data, msg.data_size)) {
+            _wire_callback(topic, *wl->view);
+        } else {
+            _wire_decode_errors++;
+        }
+        return;
+    }
+    if (!wl->codec->decode(msg.data, msg.data_size, _wire_buffer.data(), _wire_buffer.size())) {
+        _wire_decode_errors++;
+        return;
+    }
+    // 복원 버퍼는 다음 메시지에서 덮어쓰므로 batch 모드여도 바로 넘긴다
+    emit_topic_data(msg, _wire_buffer.data(), static_cast<uint32_t>(wl->codec->record_size()), false);
+}
+
+void SimpleSubscriber::emit_topic_data(const TopicMessage& msg, const char* data, uint32_t size, bool stable) {
+    DataTopic topic = static_cast<DataTopic>(msg.topic);
+    if (!_batch_callback) {
+        if (_topic_callback) _topic_callback(topic, data, static_cast<int>(size));
+        return;
+    }
+    TopicMessageView view;
+    view.topic = topic;
+    view.global_seq = msg.global_seq;
+    view.topic_seq = msg.topic_seq;
+    view.timestamp = msg.timestamp;
+    view.publisher_id = _publisher_id;
+    view.data = data;
+    view.size = size;
+    view.record = _record_views.bind(topic, data, size);
+    _batch_views.push_back(view);
+    // socket read 밖 (shm / multicast) 이거나 곧 덮어쓸 버퍼면 한 건 batch 로
+    if (!stable || !_batch_open) {
+        flush_topic_batch();
+    }
+}
+
+void SimpleSubscriber::flush_topic_batch() {
+    if (_batch_views.empty()) return;
+    _batch_calls++;
+    _batch_callback(_batch_views.data(), _batch_views.size());
+    _batch_views.clear();
+    _record_views.reset();
 }
 
 void SimpleSubscriber::handle_subscription_response(const SubscriptionResponse& subscription_response) {
     std::cout << "Subscription response - result: " << subscription_response.result << std::endl;
     
-    if (subscription_response.result == 0) {
+    if (subscription_response.result == SUB_RESULT_SHM && _shm_log.is_open() && start_shm_reader()) {
+        // 재시작 복구도 socket 재전송 없이 cursor 이동으로 처리
+        change_status(CLIENT_RECOVERY_NEEDED);
+        shm_rewind();
+    } else if (subscription_response.result == SUB_RESULT_MCAST && _mcast_receiver) {
+        // 마지막 seq 이후는 socket 복구로 받고, 그동안 온 datagram 은 _mcast_pending 에 보관
+        _mcast_active = true;
+        _mcast_next_seq = 0;
+        _mcast_resync = false;
+        change_status(CLIENT_RECOVERY_NEEDED);
+        send_recovery_request();
+    } else if (subscription_response.result == SUB_RESULT_OK || subscription_response.result == SUB_RESULT_SHM ||
+               subscription_response.result == SUB_RESULT_MCAST) {
+        _shm_log.close();
+        _mcast_pending.clear();
+        uint32_t last_seq = recovery_last_seq();
+        if (subscription_response.current_seq < last_seq) {
+            // publisher 가 시퀀스를 초기화했거나 DB tail 을 잃었음 (그 구간은 다시 오지 않는다)
+            std::cerr << "Publisher current seq " << subscription_response.current_seq
+                      << " is behind local seq " << last_seq << std::endl;
+        }
+        if (_gaps.empty() && subscription_response.current_seq == last_seq) {
+            // 받을 것이 없으면 복구 요청 없이 바로 live (publisher warm restart 후 재접속 등)
+            std::cout << "Up to date at seq " << last_seq << ", skipping recovery" << std::endl;
+            change_status(CLIENT_ONLINE);
+            return;
+        }
+        if (subscription_response.result == SUB_RESULT_OK &&
+            start_parallel_recovery(last_seq, subscription_response.current_seq)) {
+            return;
+        }
         change_status(CLIENT_RECOVERY_NEEDED);
         send_recovery_request();
     }
 }
 
+void SimpleSubscriber::set_parallel_recovery(size_t streams, uint32_t chunk_messages, uint32_t min_messages) {
+    _fetch_streams = streams > 1 ? streams : 0;
+    _fetch_chunk_messages = chunk_messages;
+    _fetch_min_messages = min_messages;
+}
+
+bool SimpleSubscriber::start_parallel_recovery(uint32_t last_seq, uint32_t current_seq) {
+    if (_fetch_streams == 0 || current_seq <= last_seq || current_seq - last_seq < _fetch_min_messages) {
+        return false;
+    }
+    // 종목 필터는 publisher 복구 필터로 걸러 받아야 하고, 누락 구간은 RecoveryRequest 가 앞 구간부터 다시 받는다
+    if (!_symbol_filter.empty() || !_gaps.empty() || _shm_active || _mcast_active) {
+        return false;
+    }
+    if (!_fetcher) {
+        _fetcher.reset(new RecoveryFetcher(_libevent_base));
+    }
+    _fetcher->set_address(_socket_type, _address, _port);
+    _fetcher->set_socket_profile(_socket_profile);
+    _fetcher->set_client_id(_subscriber_id);
+    _fetcher->set_compression(_recovery_compression);
+    _fetcher->set_streams(_fetch_streams, _fetch_chunk_messages);
+    bool started = _fetcher->start(last_seq + 1, current_seq,
+        [this](const ProtocolMessage* messages, size_t count) { deliver_fetched(messages, count); },
+        [this](bool ok) { finish_parallel_recovery(ok); });
+    if (!started) {
+        _parallel_recovery_failures++;
+        return false;
+    }
+    _fetch_active = true;
+    _fetch_overflow = false;
+    _fetch_pending.clear();
+    _fetch_pending_bytes = 0;
+    _parallel_recoveries++;
+    change_status(CLIENT_RECOVERING);
+    return true;
+}
+
+void SimpleSubscriber::hold_live_frames(const ProtocolMessage* messages, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        const ProtocolMessage& m = messages[i];
+        uint32_t magic;
+        memcpy(&magic, m.data, sizeof(uint32_t));
+        if (magic != MAGIC_TOPIC_MSG && magic != MAGIC_TOPIC_CONFLATED && magic != MAGIC_TOPIC_WIRE) {
+            handle_incomming_messages(const_cast<char*>(m.data), static_cast<int>(m.length));
+            continue;
+        }
+        if (_fetch_overflow || _fetch_pending_bytes + m.length > FETCH_MAX_PENDING_BYTES) {
+            if (!_fetch_overflow) {
+                std::cerr << "Parallel recovery live buffer full (" << _fetch_pending.size()
+                          << " messages), recovering the rest after fetch" << std::endl;
+            }
+            _fetch_overflow = true;
+            continue;
+        }
+        _fetch_pending.emplace_back(m.data, m.data + m.length);
+        _fetch_pending_bytes += m.length;
+    }
+}
+
+void SimpleSubscriber::deliver_fetched(const ProtocolMessage* messages, size_t count) {
+    // 일반 복구 메시지와 같은 경로 (RecoveryBatch 도 그대로 풀림), view 는 fetcher 버퍼가 유효한 동안 넘긴다
+    _batch_open = true;
+    handle_incomming_batch(messages, count);
+    _batch_open = false;
+    flush_topic_batch();
+}
+
+void SimpleSubscriber::finish_parallel_recovery(bool ok) {
+    _fetch_active = false;
+    uint32_t seq = _publisher_sequence_record->get_topic_sequence(DataTopic::ALL_TOPICS);
+    if (!ok) {
+        // 이미 받은 앞부분부터 구독 연결로 이어서 (live 보관분은 그 복구가 다시 보냄)
+        _parallel_recovery_failures++;
+        std::cerr << "Parallel recovery failed at seq " << seq << ", continuing with recovery request" << std::endl;
+        _fetch_pending.clear();
+        _fetch_pending_bytes = 0;
+        _fetch_overflow = false;
+        change_status(CLIENT_RECOVERY_NEEDED);
+        send_recovery_request();
+        return;
+    }
+    std::cout << "Parallel recovery complete at seq " << seq << " (" << _fetch_pending.size()
+              << " live messages held)" << std::endl;
+    bool resync = _fetch_overflow;
+    change_status(CLIENT_ONLINE);
+    _batch_open = true;
+    for (const auto& m : _fetch_pending) {
+        // 이어지지 않으면 handle_topic_message 가 구간 / 전체 복구를 요청하고 남은 보관분은 그 복구로 다시 받는다
+        handle_topic_message(*reinterpret_cast<const TopicMessage*>(m.data()));
+        if (_current_status != CLIENT_ONLINE) break;
+    }
+    _batch_open = false;
+    flush_topic_batch();
+    _fetch_pending.clear();
+    _fetch_pending_bytes = 0;
+    _fetch_overflow = false;
+    if (resync && _current_status == CLIENT_ONLINE) {
+        change_status(CLIENT_RECOVERY_NEEDED);
+        send_recovery_request();
+    }
+}
+
+void SimpleSubscriber::cancel_parallel_recovery() {
+    if (_fetcher) {
+        _fetcher->cancel();
+    }
+    _fetch_active = false;
+    _fetch_overflow = false;
+    _fetch_pending.clear();
+    _fetch_pending_bytes = 0;
+}
+
 void SimpleSubscriber::handle_recovery_response(const RecoveryResponse& recovery_response) {
     std::cout << "Recovery response - result: " << recovery_response.result 
               << ", start_seq: " << recovery_response.start_seq 
@@ -264,7 +867,21 @@ void SimpleSubscriber::handle_recovery_response(const RecoveryResponse& recovery
 
 void SimpleSubscriber::handle_recovery_complete(const RecoveryComplete& recovery_complete) {
     std::cout << "Recovery complete - total_sent: " << recovery_complete.total_sent << std::endl;
+    if (!_gaps.empty()) {
+        // 전체 복구가 가장 앞 구간 이전부터 보냈으므로 남은 구간은 publisher 에도 없는 메시지
+        std::cerr << "Recovery complete with " << _gaps.size() << " unfilled gaps ("
+                  << _gaps.missing() << " messages), dropping" << std::endl;
+        _gaps.clear();
+    }
+    if (_shm_active) {
+        // socket 으로 받은 구간 이후부터 로그에서 이어 읽기
+        shm_rewind();
+        return;
+    }
     change_status(CLIENT_ONLINE);
+    if (_mcast_active) {
+        replay_multicast_pending();
+    }
 }
 
 bool SimpleSubscriber::send_subscription_request() {
@@ -274,12 +891,23 @@ bool SimpleSubscriber::send_subscription_request() {
     }
     
     SubscriptionRequest subscription_request;
-    subscription_request.magic = MAGIC_SUBSCRIBE;
+    subscription_request.magic = _shm_log.is_open() ? MAGIC_SHM_SUBSCRIBE :
+                                 _mcast_receiver ? MAGIC_MCAST_SUBSCRIBE : MAGIC_SUBSCRIBE;
     subscription_request.client_id = _subscriber_id;
     subscription_request.client_name[0] = '\0';
     strncpy(subscription_request.client_name, _subscriber_name.c_str(), sizeof(subscription_request.client_name) - 1);
     subscription_request.topic_mask = _subscription_mask;
+    subscription_request.conflate_mask = _conflate_mask;
+    subscription_request.conflate_interval_ms = _conflate_interval_ms;
+    subscription_request.wire_encoding = _wire_encoding;
     
+    // 구독 승인 전에 필터가 적용되도록 먼저 보냄 (같은 연결이므로 순서대로 처리)
+    if (!_topic_filter_ids.empty()) {
+        send_topic_filter_request();
+    }
+    if (!_symbol_filter.empty()) {
+        send_symbol_filter_request();
+    }
     std::cout << "Sending subscription request" << std::endl;
     _socket_handler->trySend(&subscription_request, sizeof(subscription_request));
     return true;
@@ -295,17 +923,526 @@ bool SimpleSubscriber::send_recovery_request() {
     recovery_request.magic = MAGIC_RECOVERY_REQ;
     recovery_request.client_id = _subscriber_id;
     recovery_request.topic_mask = _subscription_mask;
-    recovery_request.last_seq = _publisher_sequence_record->get_topic_sequence(DataTopic::ALL_TOPICS);
+    recovery_request.last_seq = recovery_last_seq();
+    recovery_request.compression = _recovery_compression;
     
     std::cout << "Sending recovery request" << std::endl;
     _socket_handler->trySend(&recovery_request, sizeof(recovery_request));
     return true;
 }
 
+bool SimpleSubscriber::send_topic_filter_request() {
+    std::vector<char> buf(sizeof(TopicFilterRequest) + _topic_filter_ids.size() * sizeof(uint32_t));
+    TopicFilterRequest* request = reinterpret_cast<TopicFilterRequest*>(buf.data());
+    request->magic = MAGIC_TOPIC_FILTER;
+    request->client_id = _subscriber_id;
+    request->count = static_cast<uint32_t>(_topic_filter_ids.size());
+    memcpy(request->topics, _topic_filter_ids.data(), _topic_filter_ids.size() * sizeof(uint32_t));
+
+    std::cout << "Sending topic filter (" << request->count << " topics)" << std::endl;
+    _socket_handler->trySend(buf.data(), buf.size());
+    return true;
+}
+
+bool SimpleSubscriber::send_symbol_filter_request() {
+    std::vector<char> buf(sizeof(SymbolFilterRequest) + _symbol_filter.size() * SYMBOL_KEY_SIZE, 0);
+    SymbolFilterRequest* request = reinterpret_cast<SymbolFilterRequest*>(buf.data());
+    request->magic = MAGIC_SYMBOL_FILTER;
+    request->client_id = _subscriber_id;
+    request->count = static_cast<uint32_t>(_symbol_filter.size());
+    for (size_t i = 0; i < _symbol_filter.size(); ++i) {
+        memcpy(request->symbols + i * SYMBOL_KEY_SIZE, _symbol_filter[i].data(), _symbol_filter[i].size());
+    }
+
+    std::cout << "Sending symbol filter (" << request->count << " symbols)" << std::endl;
+    _socket_handler->trySend(buf.data(), buf.size());
+    return true;
+}
+
+bool SimpleSubscriber::send_time_recovery_request(uint64_t since_ns) {
+    if (!_socket_handler) {
+        std::cerr << "Socket handler not available" << std::endl;
+        return false;
+    }
+
+    TimeRecoveryRequest request;
+    request.magic = MAGIC_TIME_RECOVERY_REQ;
+    request.client_id = _subscriber_id;
+    request.topic_mask = _subscription_mask;
+    request.compression = _recovery_compression;
+    request.since_ns = since_ns;
+
+    std::cout << "Sending time recovery request (since " << since_ns << ")" << std::endl;
+    _socket_handler->trySend(&request, sizeof(request));
+    return true;
+}
+
+uint32_t SimpleSubscriber::recovery_last_seq() const {
+    uint32_t last_seq = _publisher_sequence_record->get_topic_sequence(DataTopic::ALL_TOPICS);
+    if (!_gaps.empty()) {
+        last_seq = std::min(last_seq, _gaps.min_global_from());
+    }
+    return last_seq;
+}
+
+bool SimpleSubscriber::track_sequence_gap(const TopicMessage& topic_message) {
+    int index = topic_index(topic_message.topic);
+    if (index < 0 || _last_global_by_topic[index] == 0) {
+        // 재시작 직후처럼 이 토픽의 직전 global seq 를 모르면 구간을 정할 수 없음
+        return false;
+    }
+    uint32_t from_seq = _last_global_by_topic[index];
+    uint32_t lo = *topic_sequence_field(index) + 1;
+    uint32_t hi = topic_message.topic_seq - 1;
+    if (topic_message.global_seq > from_seq + 1 && topic_message.global_seq - from_seq - 1 > GAP_RECOVERY_MAX_MESSAGES) {
+        // publisher 가 채우지 않는 크기: 구간 timeout 을 기다리지 않고 바로 전체 복구
+        std::cout << "Sequence gap of " << topic_message.global_seq - from_seq - 1 << " messages exceeds "
+                  << GAP_RECOVERY_MAX_MESSAGES << ", full recovery" << std::endl;
+        _gap_fallbacks++;
+        return false;
+    }
+    if (topic_message.global_seq <= from_seq + 1 ||
+        !_gaps.add(topic_message.topic, lo, hi, from_seq, topic_message.global_seq, get_current_timestamp())) {
+        std::cout << "Sequence gap tracking unavailable (" << _gaps.size() << " gaps), full recovery" << std::endl;
+        _gap_fallbacks++;
+        return false;
+    }
+    _gaps_detected++;
+    std::cout << "Sequence gap topic " << topic_message.topic << " seq " << lo << "-" << hi
+              << ", requesting global seq " << from_seq + 1 << "-" << topic_message.global_seq - 1 << std::endl;
+    send_gap_recovery_request(from_seq + 1, topic_message.global_seq - 1);
+    arm_seq_timer();
+    return true;
+}
+
+bool SimpleSubscriber::send_replica_ack(uint32_t acked_seq) {
+    if (!_socket_handler || _current_status == CLIENT_OFFLINE) {
+        return false;
+    }
+    ReplicaAck ack;
+    ack.magic = MAGIC_REPLICA_ACK;
+    ack.client_id = _subscriber_id;
+    ack.acked_seq = acked_seq;
+    ack.reserved = 0;
+    ack.timestamp = get_current_timestamp();
+    _socket_handler->trySend(&ack, sizeof(ack));
+    return true;
+}
+
+bool SimpleSubscriber::send_gap_recovery_request(uint32_t from_seq, uint32_t to_seq) {
+    if (!_socket_handler) {
+        std::cerr << "Socket handler not available" << std::endl;
+        return false;
+    }
+    GapRecoveryRequest request;
+    request.magic = MAGIC_GAP_RECOVERY_REQ;
+    request.client_id = _subscriber_id;
+    request.from_seq = from_seq;
+    request.to_seq = to_seq;
+    _socket_handler->trySend(&request, sizeof(request));
+    return true;
+}
+
+void SimpleSubscriber::check_gap_timeouts() {
+    if (_gaps.empty()) {
+        return;
+    }
+    uint64_t now = get_current_timestamp();
+    bool expired = false;
+    for (auto& entry : _gaps.gaps()) {
+        if (now - entry.second.requested_ns >= SEQ_GAP_TIMEOUT_MS * 1000000ULL) {
+            expired = true;
+            break;
+        }
+    }
+    if (!expired) {
+        return;
+    }
+    // 구간 복구로 안 채워짐: 가장 앞 구간 이전부터 전체 복구 (구간은 그대로 두고 들어오는 대로 채움)
+    for (auto& entry : _gaps.gaps()) {
+        entry.second.requested_ns = now;
+    }
+    if (_current_status == CLIENT_ONLINE) {
+        _gap_fallbacks++;
+        std::cout << _gaps.size() << " sequence gaps not filled in " << SEQ_GAP_TIMEOUT_MS
+                  << "ms, full recovery from seq " << recovery_last_seq() + 1 << std::endl;
+        change_status(CLIENT_RECOVERY_NEEDED);
+        send_recovery_request();
+    }
+}
+
+void SimpleSubscriber::set_sequence_persist_policy(uint32_t every_messages, uint32_t interval_ms) {
+    _persist_every_messages = every_messages;
+    _persist_interval_ms = interval_ms;
+}
+
+void SimpleSubscriber::note_sequence_update(uint32_t count) {
+    _unsaved_messages += count;
+    if (_persist_every_messages > 0 && _unsaved_messages >= _persist_every_messages) {
+        flush_sequences();
+    } else if (_persist_interval_ms > 0) {
+        arm_seq_timer();
+    }
+}
+
+void SimpleSubscriber::flush_sequences() {
+    persist_sequences(false);
+}
+
+void SimpleSubscriber::persist_sequences(bool closing) {
+    if (_unsaved_messages == 0) {
+        return;
+    }
+    if (!_sequence_storage || !_publisher_sequence_record) {
+        _unsaved_messages = 0;
+        return;
+    }
+    // 누락 구간이 열려 있으면 구간 이전까지만 저장한다 (구간 뒤까지 저장하고 죽으면 재시작 때 구간을 다시 받지 않음).
+    // 작업 레코드는 그대로 두고, 구간이 채워진 뒤 실제 값을 저장하도록 _unsaved_messages 도 남긴다 (종료 때는 0)
+    PublisherSequenceRecord record = *_publisher_sequence_record;
+    _stored_topic_sequences.copy_extended(_topic_sequences);
+    if (!_gaps.empty()) {
+        clamp_sequences_to_gaps(record);
+    }
+    if (_gaps.empty() || closing) {
+        _unsaved_messages = 0;
+    }
+    if (_stored_sequence_record) {
+        *_stored_sequence_record = record;      // HashMaster mmap 레코드 (페이지 반영은 커널 writeback)
+    } else {
+        _sequence_storage->save_sequences(record);
+    }
+}
+
+void SimpleSubscriber::clamp_sequences_to_gaps(PublisherSequenceRecord& record) {
+    uint32_t floor = _gaps.min_global_from();
+    if (record.all_topics_sequence > floor) {
+        record.all_topics_sequence = floor;
+    }
+    for (auto& entry : _gaps.gaps()) {
+        uint32_t topic_floor = SequenceGapSet::lo_of(entry.first) - 1;
+        uint32_t* seq = nullptr;
+        switch (int index = topic_index(SequenceGapSet::topic_of(entry.first))) {
+            case -1: break;
+            case 0: seq = &record.topic1_sequence; break;
+            case 1: seq = &record.topic2_sequence; break;
+            case 2: seq = &record.misc_sequence; break;
+            default: seq = _stored_topic_sequences.field(index); break;
+        }
+        if (seq && *seq > topic_floor) {
+            *seq = topic_floor;
+        }
+    }
+}
+
+void SimpleSubscriber::arm_seq_timer() {
+    if (_seq_timer_armed || !_libevent_base) {
+        return;
+    }
+    if (!_seq_timer) {
+        _seq_timer = event_new(_libevent_base, -1, EV_PERSIST, seq_timer_cb, this);
+        if (!_seq_timer) {
+            std::cerr << "Failed to create sequence timer" << std::endl;
+            return;
+        }
+    }
+    uint32_t interval_ms = _persist_interval_ms > 0 ? _persist_interval_ms : SEQ_GAP_CHECK_INTERVAL_MS;
+    struct timeval tv;
+    tv.tv_sec = interval_ms / 1000;
+    tv.tv_usec = (interval_ms % 1000) * 1000;
+    if (event_add(_seq_timer, &tv) == 0) {
+        _seq_timer_armed = true;
+    }
+}
+
+void SimpleSubscriber::seq_timer_cb(evutil_socket_t fd, short events, void* arg) {
+    auto* self = static_cast<SimpleSubscriber*>(arg);
+    if (self->_persist_interval_ms > 0) {
+        self->flush_sequences();
+    }
+    self->check_gap_timeouts();
+    if ((self->_unsaved_messages == 0 || self->_persist_interval_ms == 0) && self->_gaps.empty()) {
+        event_del(self->_seq_timer);
+        self->_seq_timer_armed = false;
+    }
+}
+
+bool SimpleSubscriber::start_shm_reader() {
+    if (_shm_running.load()) {
+        return true;
+    }
+
+    _shm_notify_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (_shm_notify_fd < 0) {
+        std::cerr << "Failed to create eventfd: " << strerror(errno) << std::endl;
+        return false;
+    }
+    _shm_notify_event = event_new(_libevent_base, _shm_notify_fd, EV_READ | EV_PERSIST, shm_notify_cb, this);
+    if (!_shm_notify_event || event_add(_shm_notify_event, nullptr) != 0) {
+        std::cerr << "Failed to add shm log notify event" << std::endl;
+        if (_shm_notify_event) event_free(_shm_notify_event);
+        _shm_notify_event = nullptr;
+        close(_shm_notify_fd);
+        _shm_notify_fd = -1;
+        return false;
+    }
+
+    _shm_active = true;
+    _shm_running.store(true);
+    _shm_waiter = std::thread(&SimpleSubscriber::shm_waiter_loop, this);
+    std::cout << "Shm log reader started: " << _shm_log.name() << std::endl;
+    return true;
+}
+
+void SimpleSubscriber::stop_shm_reader() {
+    _shm_active = false;
+    if (_shm_running.load()) {
+        _shm_running.store(false);
+        if (_shm_waiter.joinable()) {
+            _shm_waiter.join();
+        }
+    }
+    if (_shm_notify_event) {
+        event_del(_shm_notify_event);
+        event_free(_shm_notify_event);
+        _shm_notify_event = nullptr;
+    }
+    if (_shm_notify_fd >= 0) {
+        close(_shm_notify_fd);
+        _shm_notify_fd = -1;
+    }
+}
+
+// 로그 head 가 바뀌면 eventfd 로 event loop 를 깨운다 (읽기는 event loop 스레드에서만)
+void SimpleSubscriber::shm_waiter_loop() {
+    uint64_t one = 1;
+    uint32_t notified = _shm_log.head_seq();
+    while (_shm_running.load(std::memory_order_relaxed)) {
+        if (!_shm_log.wait(notified, SHM_LOG_WAIT_TIMEOUT_US)) {
+            continue;
+        }
+        notified = _shm_log.head_seq();
+        if (write(_shm_notify_fd, &one, sizeof(one)) < 0 && errno != EAGAIN) {
+            std::cerr << "Failed to write shm log eventfd: " << strerror(errno) << std::endl;
+        }
+    }
+}
+
+void SimpleSubscriber::shm_notify_cb(evutil_socket_t fd, short events, void* arg) {
+    auto* self = static_cast<SimpleSubscriber*>(arg);
+    uint64_t value;
+    if (read(fd, &value, sizeof(value)) < 0 && errno != EAGAIN) {
+        std::cerr << "Failed to read shm log eventfd: " << strerror(errno) << std::endl;
+    }
+    self->drain_shm_log();
+}
+
+void SimpleSubscriber::drain_shm_log() {
+    for (int i = 0; i < SHM_LOG_MAX_READS_PER_WAKEUP; ++i) {
+        if (!_shm_active || _current_status != CLIENT_ONLINE) {
+            return;
+        }
+
+        const TopicMessage* msg = nullptr;
+        size_t size = 0;
+        ShmTopicLog::ReadResult r = _shm_log.next(msg, size);
+        if (r == ShmTopicLog::READ_EMPTY) {
+            _shm_log.report(_publisher_sequence_record->get_topic_sequence(DataTopic::ALL_TOPICS));
+            return;
+        }
+        if (r == ShmTopicLog::READ_OVERRUN) {
+            _shm_overruns++;
+            std::cerr << "Shm log overrun (cursor=" << _shm_log.cursor() << "), rewinding" << std::endl;
+            change_status(CLIENT_RECOVERY_NEEDED);
+            shm_rewind();
+            continue;
+        }
+
+        _shm_messages_read++;
+        if (size < sizeof(TopicMessage) || !is_topic_subscribed(_subscription_mask, msg->topic)) {
+            continue;
+        }
+        if (_shm_log.near_tail()) {
+            // writer 가 곧 덮어쓸 위치: 복사한 뒤 유효한지 확인하고 넘긴다
+            _shm_copy.assign(reinterpret_cast<const char*>(msg), reinterpret_cast<const char*>(msg) + size);
+            if (!_shm_log.still_valid()) {
+                _shm_overruns++;
+                std::cerr << "Shm log overrun (cursor=" << _shm_log.cursor() << "), rewinding" << std::endl;
+                change_status(CLIENT_RECOVERY_NEEDED);
+                shm_rewind();
+                continue;
+            }
+            handle_topic_message(*reinterpret_cast<const TopicMessage*>(_shm_copy.data()));
+            continue;
+        }
+        // 로그 버퍼를 그대로 넘긴다 (복사 없음)
+        handle_topic_message(*msg);
+        if (!_shm_log.still_valid()) {
+            _shm_overruns++;
+            std::cerr << "Shm log overwritten while processing global_seq " << msg->global_seq << std::endl;
+        }
+    }
+    // 남은 메시지는 다음 루프 턴에 이어서 처리 (다른 이벤트가 굶지 않도록)
+    _shm_log.report(_publisher_sequence_record->get_topic_sequence(DataTopic::ALL_TOPICS));
+    event_active(_shm_notify_event, EV_READ, 0);
+}
+
+bool SimpleSubscriber::shm_rewind() {
+    uint32_t next_seq = _publisher_sequence_record->get_topic_sequence(DataTopic::ALL_TOPICS) + 1;
+    if (!_shm_log.seek(next_seq)) {
+        std::cout << "Shm log does not hold seq " << next_seq << ", recovering over socket" << std::endl;
+        send_recovery_request();
+        return false;
+    }
+    _shm_rewinds++;
+    std::cout << "Shm log cursor rewound to seq " << next_seq << std::endl;
+    change_status(CLIENT_ONLINE);
+    if (_shm_notify_event) {
+        event_active(_shm_notify_event, EV_READ, 0);
+    }
+    return true;
+}
+
+bool SimpleSubscriber::start_multicast_receiver() {
+    if (_mcast_receiver) {
+        return true;
+    }
+    EventUdpSocket* udp = new EventUdpSocket(_libevent_base);
+    udp->setMulticastInterface(_mcast_interface);
+    udp->setReceiveBufferSize(MCAST_RECEIVE_BUFFER);
+    udp->setReadCallback([this](char* data, int size) {
+        handle_multicast_datagram(data, size);
+    });
+    try {
+        udp->listen(_mcast_address);
+    } catch (const std::exception& e) {
+        std::cerr << "Failed to join multicast: " << e.what() << std::endl;
+        delete udp;
+        return false;
+    }
+    _mcast_receiver = udp;
+    return true;
+}
+
+void SimpleSubscriber::handle_multicast_datagram(const char* data, int size) {
+    if (size < static_cast<int>(sizeof(MulticastHeader))) {
+        return;
+    }
+    MulticastHeader header;
+    memcpy(&header, data, sizeof(header));
+    if (header.magic != MAGIC_MCAST_DATA || header.publisher_id != _publisher_id) {
+        return;
+    }
+    _mcast_datagrams++;
+    if (!_mcast_active) {
+        return;
+    }
+
+    // global seq 연속성으로 datagram 유실 감지 (구독하지 않는 토픽만 담긴 datagram, heartbeat 포함)
+    if (_mcast_next_seq != 0 && header.first_seq > _mcast_next_seq) {
+        _mcast_gaps++;
+        std::cout << "Multicast datagram lost (expected seq " << _mcast_next_seq << ", got " << header.first_seq << ")" << std::endl;
+        if (_current_status == CLIENT_ONLINE) {
+            change_status(CLIENT_RECOVERY_NEEDED);
+            send_recovery_request();
+        } else {
+            _mcast_resync = true;
+        }
+    }
+    if (_mcast_next_seq == 0 || header.first_seq + header.count > _mcast_next_seq) {
+        _mcast_next_seq = header.first_seq + header.count;
+    }
+
+    size_t pos = sizeof(MulticastHeader);
+    for (uint16_t i = 0; i < header.count; ++i) {
+        if (pos + sizeof(TopicMessage) > static_cast<size_t>(size)) {
+            break;
+        }
+        const TopicMessage* msg = reinterpret_cast<const TopicMessage*>(data + pos);
+        size_t msg_size = sizeof(TopicMessage) + msg->data_size;
+        if (msg->magic != MAGIC_TOPIC_MSG || pos + msg_size > static_cast<size_t>(size)) {
+            std::cerr << "Malformed multicast datagram (first_seq=" << header.first_seq << ")" << std::endl;
+            break;
+        }
+        pos += msg_size;
+        _mcast_messages++;
+        if (is_topic_subscribed(_subscription_mask, msg->topic)) {
+            handle_multicast_message(msg, msg_size);
+        }
+    }
+}
+
+void SimpleSubscriber::handle_multicast_message(const TopicMessage* msg, size_t size) {
+    if (_current_status == CLIENT_ONLINE) {
+        int result = validate_sequence(msg->topic, msg->topic_seq);
+        if (result == 2) {
+            return;
+        }
+        if (result == 0) {
+            handle_topic_message(*msg);
+            return;
+        }
+        // datagram 유실: 이 메시지는 보관하고 누락 구간은 socket 으로 복구
+        _mcast_gaps++;
+        std::cout << "Multicast gap before global_seq " << msg->global_seq << ", recovering over socket" << std::endl;
+        change_status(CLIENT_RECOVERY_NEEDED);
+        send_recovery_request();
+    }
+
+    if (_mcast_pending.size() >= MCAST_MAX_PENDING) {
+        _mcast_pending.pop_front();
+        _mcast_pending_drops++;
+    }
+    const char* p = reinterpret_cast<const char*>(msg);
+    _mcast_pending.emplace_back(p, p + size);
+}
+
+void SimpleSubscriber::replay_multicast_pending() {
+    while (!_mcast_pending.empty()) {
+        const TopicMessage* msg = reinterpret_cast<const TopicMessage*>(_mcast_pending.front().data());
+        int result = validate_sequence(msg->topic, msg->topic_seq);
+        if (result == 1) {
+            // 보관 중에도 유실이 있었음: 남은 메시지는 그대로 두고 다시 복구
+            _mcast_gaps++;
+            std::cout << "Multicast gap before global_seq " << msg->global_seq << " after recovery, recovering again" << std::endl;
+            change_status(CLIENT_RECOVERY_NEEDED);
+            send_recovery_request();
+            return;
+        }
+        if (result == 0) {
+            handle_topic_message(*msg);
+        }
+        _mcast_pending.pop_front();
+    }
+    if (_mcast_resync) {
+        // 복구 중 유실된 datagram 이 보관분 뒤쪽이었을 수 있으므로 마지막 seq 이후를 다시 받는다
+        _mcast_resync = false;
+        change_status(CLIENT_RECOVERY_NEEDED);
+        send_recovery_request();
+    }
+}
+
 void SimpleSubscriber::stop() {
     _current_status = CLIENT_OFFLINE;
+    _stopped = true;
+    persist_sequences(true);
+    if (_seq_timer_armed) {
+        event_del(_seq_timer);
+        _seq_timer_armed = false;
+    }
+    stop_shm_reader();
+    cancel_parallel_recovery();
+    _mcast_active = false;
+    _mcast_pending.clear();
+    if (_mcast_receiver) {
+        delete _mcast_receiver;
+        _mcast_receiver = nullptr;
+    }
+    _shm_log.release_slot();
+    _shm_log.close();
     if (_socket_handler) {
         delete _socket_handler;
         _socket_handler = nullptr;
     }
+    _quickack_fd = -1;
 }
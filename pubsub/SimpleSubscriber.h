@@ -4,13 +4,64 @@
 #include "Common.h"
 #include "PubSubTopicProtocol.h"
 #include "../eventBase/EventBase.h"
+#include "../eventBase/EventConnection.h"
 #include "SequenceStorage.h"
 #include "FileSequenceStorage.h"
 #include "HashmasterSequenceStorage.h"
+#include "ShmTopicLog.h"
+#include "SequenceGapSet.h"
+#include "TopicRegistry.h"
+#include "../eventBase/EventUdpSocket.h"
+#include "../common/LatencyStats.h"
+#include "../common/AsyncLog.h"
+#include "../HashMaster/WireCodec.h"
+#include "../common/BlockCompression.h"
+#include "SocketProfile.h"
+#include "RecoveryFetcher.h"
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <thread>
 
 using namespace SimplePubSub;
 
 typedef std::function<void(DataTopic topic, const char* data, int size)> TopicDataCallback;
+// add_wire_layout 로 등록한 레이아웃 레코드 (view 는 콜백 안에서만 유효)
+typedef std::function<void(DataTopic topic, const WireRecordView& record)> WireRecordCallback;
+
+// batch 콜백에 넘기는 메시지 하나 (수신 evbuffer 안의 payload 를 가리킴, 복사 없음)
+struct TopicMessageView {
+    DataTopic topic;
+    uint32_t global_seq;
+    uint32_t topic_seq;
+    uint64_t timestamp;
+    uint32_t publisher_id;      // set_client_info 의 pub_id (SubscriberGroup 에서 출처 구분)
+    const char* data;
+    uint32_t size;
+    // add_record_layout 으로 등록한 토픽 / 크기면 payload 를 가리키는 레코드 (외부 버퍼, 할당 없음), 아니면 nullptr
+    const BinaryRecord* record;
+};
+// read 한번 분량의 메시지 (views / record 는 콜백 안에서만 유효, 콜백이 끝나면 수신 버퍼를 drain)
+typedef std::function<void(const TopicMessageView* messages, size_t count)> TopicBatchCallback;
+
+/* TopicMessageView::record 용 BinaryRecord 묶음: 레이아웃마다 외부 버퍼 레코드를 batch 동안 하나씩 꺼내 쓰고 reset 으로 반납 */
+class RecordViewPool {
+public:
+    void add(DataTopic topic, std::shared_ptr<RecordLayout> layout);
+    bool empty() const { return _slots.empty(); }
+    /* topic 과 레코드 크기가 맞는 레이아웃이면 data 를 가리키는 레코드 (늘어날 때만 할당), 없으면 nullptr */
+    const BinaryRecord* bind(DataTopic topic, const char* data, uint32_t size);
+    void reset();
+
+private:
+    struct Slot {
+        DataTopic topic;
+        std::shared_ptr<RecordLayout> layout;
+        std::vector<std::unique_ptr<BinaryRecord>> records;
+        size_t used;
+    };
+    std::vector<Slot> _slots;
+};
 
 
 
@@ -26,6 +77,49 @@ typedef std::function<void(DataTopic topic, const char* data, int size)> TopicDa
 *   valid sequence이면 _publisher_sequence_record 일련번호등 관련 정보 update, 
 *   일련번호 누락이면 RECOVERY_NEEDED 상태로 변경 (publisher에 복구요청을 보내고 복구 응답을 받고 RECOVERING 상태로 변경)
 *   DUPLICATE_MESSAGE 이면 무시 (DEBUG_LOG 출력)
+*
+* 누락 구간 (socket 수신, ONLINE): 전체 연결을 RECOVERY_NEEDED 로 바꾸지 않고 누락 topic seq 구간을 _gaps 에
+*   기록한 뒤 뒤의 메시지를 계속 전달한다. 구간의 global seq 범위만 MAGIC_GAP_RECOVERY_REQ 로 요청하고,
+*   들어온 메시지가 구간 안이면 (중복 판정이어도) 전달 후 구간에서 뺀다. SEQ_GAP_TIMEOUT_MS 안에 안 채워지거나
+*   구간이 너무 많으면 가장 앞 구간부터 전체 복구로 전환. 구간은 메모리에만 있으므로 재시작 시에는 사라진다.
+*   GAP_RECOVERY_MAX_MESSAGES 보다 큰 구간은 publisher 가 채우지 않으므로 요청하지 않고 바로 전체 복구.
+*
+* 일련번호 저장은 지연 저장: N 메시지마다, M ms 마다, 또는 stop/종료 시 (set_sequence_persist_policy).
+*   재시작 시 마지막 저장 이후 메시지는 다시 받는다. 수신은 프로세스 메모리의 작업 레코드 / 확장 토픽 테이블을
+*   갱신하고, 저장할 때 열린 누락 구간 이전으로 낮춘 사본을 저장소 (HashMaster mmap 레코드 / 파일, .topics) 에 쓴다.
+*   (attach_sequence_record 는 호출한 쪽 레코드를 그대로 갱신하고 저장하지 않는다)
+*
+* SHM 로그 모드 (set_shm_log): 같은 호스트 publisher 의 공유메모리 로그에서 TopicMessage 를 제자리에서 읽는다.
+*   socket 은 구독/복구 제어용으로만 사용하고 (MAGIC_SHM_SUBSCRIBE), 복구는 로그 cursor 를
+*   마지막 global seq + 1 로 되돌리는 것으로 끝난다. 로그 window 밖이면 socket 복구 후 다시 cursor 를 맞춘다.
+*
+* MULTICAST 모드 (set_multicast): 원격 publisher 의 UDP multicast datagram 으로 TopicMessage 를 수신한다.
+*   socket(TCP) 은 구독/복구 제어용으로만 사용하고 (MAGIC_MCAST_SUBSCRIBE), 일련번호 누락이 감지되면
+*   기존 RecoveryRequest 로 누락분을 받는다. ONLINE 이 아닌 동안 받은 datagram 메시지는 보관했다가
+*   RECOVERY_COMPLETE 후 순서대로 처리한다 (중복은 무시).
+*
+* COMPACT wire encoding (set_wire_encoding): socket 실시간 메시지를 publisher 의 WireCodec 형식 (MAGIC_TOPIC_WIRE) 으로
+*   받는다. 복구/conflation/shm/multicast 는 원래 형식이라 두 형식이 섞여 온다. add_wire_layout 한 레이아웃은
+*   wire record callback 이 있으면 WireRecordView 로 (원래 형식이면 한번 인코딩해서) 전달하고, 없으면 복원한
+*   레코드를 topic callback 으로 전달한다. 등록하지 않은 레이아웃의 compact 메시지는 버리고 개수만 센다.
+*
+* 복구 압축 (set_recovery_compression): 전체 복구 요청에 codec 을 넣으면 publisher 가 지원하는 경우 워커 전송분을
+*   RecoveryBatch 로 묶어 압축해 보낸다. 풀어서 안의 TopicMessage 를 일반 복구 메시지와 같은 경로로 처리한다.
+*
+* 순서 전달 (set_ordered_delivery, PublisherReplica): global seq 가 하나씩 이어질 때만 전달한다. 구간 복구 없이
+*   건너뛴 seq 가 있으면 바로 전체 복구로 받는다 (standby 가 primary 와 같은 seq 로 기록하기 위함).
+* 대체 주소 (set_failover_address): 재연결 시도마다 기본 / 대체 주소를 번갈아 쓴다 (standby 승격 후 그쪽으로).
+*
+* 병렬 복구 (set_parallel_recovery): 구독 응답의 current_seq 까지 min_messages 이상 밀려 있으면 (재시작 후 늦게 붙은 구독자 등)
+*   RecoveryRequest 대신 RecoveryFetcher 가 별도 연결 streams 개로 구간을 나눠 받는다 (publisher 복구 워커들이 동시에 DB 를 읽음).
+*   받은 구간은 seq 순서로 일반 복구 메시지와 같은 경로로 처리하고, 그동안 구독 연결로 온 live 메시지는 보관했다가
+*   (FETCH_MAX_PENDING_BYTES 까지) 끝나면 순서대로 처리한다. 이어지지 않거나 넘친 부분, fetch 실패는 RecoveryRequest 로 이어 받는다.
+*   socket 구독이고 종목 필터 / 누락 구간이 없을 때만 사용.
+*
+* BATCH 전달 (set_topic_batch_callback): socket read 한번에 검증을 통과한 메시지를 TopicMessageView 배열로 모아
+*   on_frames 끝에서 한번 넘긴다. view 는 수신 evbuffer 안 payload 를 가리키고 콜백이 끝나면 FrameParser 가 drain 한다
+*   (콜백 밖으로 포인터를 들고 나가면 안 됨). add_record_layout 한 토픽은 같은 payload 위의 BinaryRecord 도 함께 준다.
+*   압축 복구 batch 는 풀어낸 batch 마다, 복원한 compact 메시지 / shm / multicast 는 메시지마다 바로 넘긴다.
 */
 class SimpleSubscriber {
 private:
@@ -36,6 +130,12 @@ private:
     SocketType _socket_type;
     std::string _address;
     int _port;
+    // 재연결마다 _address 와 번갈아 시도 (비어있으면 사용 안함)
+    SocketType _failover_socket_type;
+    std::string _failover_address;
+    int _failover_port;
+    bool _stopped;                      // stop() 이후 남은 재연결 timer 는 연결하지 않음
+    bool _ordered_delivery;             // global seq 연속일 때만 전달 (PublisherReplica)
 
     // int _reconnect_interval;    나중에 필요하면 추가, 현재는 연결이 끊기면 자동 재연결 처리
     // int _max_reconnect_count;
@@ -45,13 +145,183 @@ private:
 
     StorageType _sequence_storage_type;
     SequenceStorage* _sequence_storage;
-    PublisherSequenceRecord* _publisher_sequence_record;    // 현재 구독중인 topic 별 sequence 정보
+    PublisherSequenceRecord* _publisher_sequence_record;    // 현재 구독중인 topic 별 sequence 정보 (작업 레코드)
+    bool _owns_sequence_record;
+    PublisherSequenceRecord* _stored_sequence_record;       // HASHMASTER: 저장소 mmap 레코드 (persist 가 사본을 씀)
 
     struct event_base* _libevent_base;  // libevent 기본 이벤트 루프
-    EventBase* _socket_handler;         // EventBase wrapper (unix/tcp socket handler)
-    Protocol* _protocol;                // 프로토콜 인스턴스(TOPIC MSG 파싱용)
+    // 수신 루프: PubSubTopicFrame 해석과 handle_incomming_batch 호출을 inline 으로 (virtual/std::function 없음)
+    struct SocketEvents {
+        SimpleSubscriber* self;
+        void on_frames(const ProtocolMessage* messages, size_t count) {
+            if (self->_fetch_active) {
+                // 병렬 복구 중 live 메시지는 복구가 끝날 때까지 보관
+                self->hold_live_frames(messages, count);
+            } else {
+                self->_batch_open = true;
+                self->handle_incomming_batch(messages, count);
+                self->_batch_open = false;
+                // 이 뒤에 FrameParser 가 input 을 drain 하므로 view 는 여기서 넘긴다
+                self->flush_topic_batch();
+            }
+            if (self->_quickack_fd >= 0) rearm_quickack(self->_quickack_fd);
+        }
+        void on_connected() { self->handle_connected(nullptr, 0); }
+        void on_disconnected() { self->handle_disconnected(nullptr, 0); }
+        void on_error() { self->handle_error(nullptr, 0); }
+    };
+    typedef EventConnection<PubSubTopicFrame, SocketEvents> SocketConnection;
+    SocketEvents _socket_events;
+    SocketConnection* _socket_handler;  // unix/tcp socket 연결
+    FrameParser* _shared_parser;        // SubscriberGroup 공유 수신 버퍼 (nullptr: 연결마다 따로)
 
     TopicDataCallback _topic_callback;
+
+    // batch 전달 (set_topic_batch_callback): socket read 한번의 메시지를 모아 on_frames 끝 (drain 직전) 에 한번 호출
+    TopicBatchCallback _batch_callback;
+    std::vector<TopicMessageView> _batch_views;
+    RecordViewPool _record_views;
+    bool _batch_open;                   // socket read 처리 중 (views 가 drain 전까지 유효)
+    uint64_t _batch_calls;
+    /* payload 를 topic callback 으로, batch 모드면 view 로 모음 (stable: drain 전까지 data 가 유효한지) */
+    void emit_topic_data(const TopicMessage& msg, const char* data, uint32_t size, bool stable);
+    /* 모은 view 를 batch 콜백으로 넘기고 비움 (release point) */
+    void flush_topic_batch();
+
+    // compact wire encoding 수신
+    struct WireLayout {
+        DataTopic topic;
+        std::shared_ptr<const WireCodec> codec;
+        std::unique_ptr<WireRecordView> view;
+    };
+    uint32_t _wire_encoding;            // 구독 요청에 넣을 WIRE_ENCODING_*
+    std::vector<WireLayout> _wire_layouts;
+    WireRecordCallback _wire_callback;
+    std::vector<char> _wire_buffer;     // 복원 / 로컬 인코딩 용
+    uint64_t _wire_messages;
+    uint64_t _wire_decode_errors;
+
+    WireLayout* find_wire_layout(uint32_t layout_id);
+    WireLayout* find_wire_layout(DataTopic topic, size_t size);
+    /* 검증을 마친 TopicMessage 를 형식에 맞는 콜백으로 전달 */
+    void deliver_topic_message(const TopicMessage& msg);
+
+    // 압축 복구 수신
+    uint32_t _recovery_compression;     // RecoveryRequest 에 넣을 BLOCK_CODEC_*
+    std::vector<char> _recovery_batch_buffer;
+    std::vector<ProtocolMessage> _recovery_batch_messages;
+    uint64_t _recovery_batches;
+    uint64_t _recovery_batch_errors;
+    /* RecoveryBatch 를 풀어 안의 TopicMessage 를 순서대로 처리 */
+    void handle_recovery_batch(const char* data, size_t size);
+
+    // 공유메모리 로그 수신
+    std::string _shm_log_name;
+    ShmTopicLog _shm_log;
+    bool _shm_active;                   // publisher 가 SUB_RESULT_SHM 으로 승인
+    int _shm_notify_fd;                 // waiter 스레드 -> event loop 알림 (eventfd)
+    struct event* _shm_notify_event;
+    std::thread _shm_waiter;
+    std::atomic<bool> _shm_running;
+    uint64_t _shm_messages_read;
+    uint64_t _shm_rewinds;
+    uint64_t _shm_overruns;
+    std::vector<char> _shm_copy;        // tail 근처 메시지 복사용
+
+    bool start_shm_reader();
+    void stop_shm_reader();
+    void shm_waiter_loop();
+    static void shm_notify_cb(evutil_socket_t fd, short events, void* arg);
+    void drain_shm_log();
+    /* cursor 를 마지막 global seq + 1 로 이동, window 밖이면 socket 복구 요청 */
+    bool shm_rewind();
+
+    // UDP multicast 수신
+    uint32_t _publisher_id;
+    std::string _mcast_address;         // "group:port"
+    std::string _mcast_interface;
+    EventUdpSocket* _mcast_receiver;
+    bool _mcast_active;                 // publisher 가 SUB_RESULT_MCAST 로 승인
+    uint32_t _mcast_next_seq;           // 다음 datagram 의 first_seq 기대값 (0: 모름)
+    bool _mcast_resync;                 // ONLINE 이 아닐 때 datagram 유실 -> 복구 완료 후 한번 더 복구
+    std::deque<std::vector<char>> _mcast_pending;   // 복구 중 받은 TopicMessage
+    uint64_t _mcast_datagrams;
+    uint64_t _mcast_messages;
+    uint64_t _mcast_gaps;
+    uint64_t _mcast_pending_drops;
+    uint32_t _conflate_mask;            // key 별 최신값만 받을 토픽 (seq 건너뜀 허용)
+    uint32_t _conflate_interval_ms;
+    SocketProfile _socket_profile;      // connect 하는 socket 옵션 (기본: 설정 안함)
+    int _quickack_fd;                   // tcp_quickack: read batch 마다 TCP_QUICKACK 다시 설정할 fd (-1: 안함)
+
+    // 누락 구간 추적 / 일련번호 지연 저장
+    SequenceGapSet _gaps;
+    std::vector<uint32_t> _last_global_by_topic;   // TopicRegistry slot 별 마지막 (가장 큰 topic seq) 메시지의 global seq, 0: 모름
+    TopicSequenceTable _topic_sequences;           // 토픽별 topic seq (기본 토픽은 _publisher_sequence_record 필드)
+    TopicSequenceTable _stored_topic_sequences;    // 확장 토픽 .topics 파일 (persist 가 낮춘 사본을 씀)
+    std::vector<uint32_t> _topic_filter_ids;       // set_topic_filter 토픽 id (비어있으면 필터 없음)
+    TopicFilter _topic_filter;                     // 같은 목록의 slot 비트셋 (수신 메시지 확인용)
+    std::vector<std::string> _symbol_filter;       // set_symbol_filter 종목 key (비어있으면 필터 없음)
+    uint32_t _persist_every_messages;   // 이 수만큼 갱신되면 저장 (1: 매 메시지)
+    uint32_t _persist_interval_ms;      // 갱신 후 이 시간이 지나면 저장
+    uint32_t _unsaved_messages;
+    struct event* _seq_timer;           // 지연 저장 / 구간 timeout 확인 (할 일이 없으면 내림)
+    bool _seq_timer_armed;
+    uint64_t _gaps_detected;
+    uint64_t _gaps_filled;
+    uint64_t _gap_fallbacks;
+
+    // one-way 지연 히스토그램 (set_latency_tracking 일 때만, 수신 시각 - TopicMessage::timestamp)
+    std::unique_ptr<SubscriberLatency> _latency;
+
+    // TopicRegistry slot (등록되지 않은 토픽이면 -1)
+    static int topic_index(uint32_t topic) { return TopicRegistry::global().slot(topic); }
+    uint32_t* topic_sequence_field(int index) { return _topic_sequences.field(index); }
+    bool topic_filtered_out(uint32_t topic) const {
+        return !_topic_filter_ids.empty() && !_topic_filter.has(topic_index(topic));
+    }
+    bool send_topic_filter_request();
+    bool send_symbol_filter_request();
+    /* ONLINE 연속 TopicMessage 를 앞에서부터 한번에 검증/전달, 처리한 개수 반환 (첫 예외 메시지에서 멈춤) */
+    size_t handle_topic_run(const ProtocolMessage* messages, size_t count);
+    /* 누락 구간 기록 후 구간 복구 요청, 실패하면 false (전체 복구) */
+    bool track_sequence_gap(const TopicMessage& topic_message);
+    bool send_gap_recovery_request(uint32_t from_seq, uint32_t to_seq);
+    /* 전체 복구 시작 seq: 비어있는 구간이 있으면 가장 앞 구간 이전부터 */
+    uint32_t recovery_last_seq() const;
+    void note_sequence_update(uint32_t count);
+    /* 작업 레코드 / 확장 토픽을 열린 누락 구간 이전으로 낮춘 사본으로 저장 (closing: stop / 소멸, 구간이 남아도 저장 완료로) */
+    void persist_sequences(bool closing);
+    /* 사본 일련번호를 열린 누락 구간 이전으로: global 은 min_global_from, 토픽은 구간 lo - 1 (확장 토픽은 _stored_topic_sequences) */
+    void clamp_sequences_to_gaps(PublisherSequenceRecord& record);
+    void arm_seq_timer();
+    static void seq_timer_cb(evutil_socket_t fd, short events, void* arg);
+    void check_gap_timeouts();
+
+    bool start_multicast_receiver();
+    void handle_multicast_datagram(const char* data, int size);
+    void handle_multicast_message(const TopicMessage* msg, size_t size);
+    /* 복구 후 보관한 메시지 처리, 다시 누락이면 복구 요청 */
+    void replay_multicast_pending();
+
+    // 병렬 복구 (set_parallel_recovery)
+    size_t _fetch_streams;              // 0: 사용 안함
+    uint32_t _fetch_chunk_messages;
+    uint32_t _fetch_min_messages;
+    std::unique_ptr<RecoveryFetcher> _fetcher;
+    bool _fetch_active;                 // fetch 중 (구독 연결의 live 메시지는 _fetch_pending 으로)
+    bool _fetch_overflow;               // 보관 상한을 넘어 버린 live 메시지가 있음 -> 끝나면 한번 더 복구
+    std::deque<std::vector<char>> _fetch_pending;
+    size_t _fetch_pending_bytes;
+    uint64_t _parallel_recoveries;
+    uint64_t _parallel_recovery_failures;
+    /* (last_seq, current_seq] 를 RecoveryFetcher 로 받기 시작, 조건이 안 맞거나 시작 못하면 false (일반 복구) */
+    bool start_parallel_recovery(uint32_t last_seq, uint32_t current_seq);
+    void hold_live_frames(const ProtocolMessage* messages, size_t count);
+    void deliver_fetched(const ProtocolMessage* messages, size_t count);
+    /* fetch 가 끝나면 보관한 live 메시지 처리 (실패면 버리고 RecoveryRequest 로) */
+    void finish_parallel_recovery(bool ok);
+    void cancel_parallel_recovery();
     
 public:
     SimpleSubscriber(struct event_base* shared_event_base);
@@ -63,11 +333,78 @@ public:
     inline std::string get_publisher_name() const {return _publisher_name;}
 
     void set_address(SocketType socket_type, std::string address, int port=0);
+    /* 연결이 끊기면 재연결 시도마다 set_address 주소와 번갈아 시도 (hot standby 로 넘어간 publisher) */
+    void set_failover_address(SocketType socket_type, std::string address, int port=0);
+    inline ClientStatus get_status() const {return _current_status;}
+    /* global seq 가 하나씩 이어진 메시지만 전달, 건너뛰면 전체 복구 (구간 복구 안함), connect 전에 설정 */
+    void set_ordered_delivery(bool enable) {_ordered_delivery = enable;}
+    /* standby 기록 확인 (acked_seq 까지 기록), 연결이 없으면 false */
+    bool send_replica_ack(uint32_t acked_seq);
     void set_subscription_mask(uint32_t mask);
     void set_topic_callback(TopicDataCallback callback);
+    /* 메시지마다 topic callback 대신 read 단위 batch 로 받음 (설정하면 topic callback 은 호출하지 않음), connect 전에 설정 */
+    void set_topic_batch_callback(TopicBatchCallback callback) {_batch_callback = callback;}
+    /* batch view 의 record 로 바로 읽을 레이아웃 (topic 과 레코드 크기가 같은 메시지) */
+    void add_record_layout(DataTopic topic, std::shared_ptr<RecordLayout> layout);
+    inline uint64_t get_batch_calls() const {return _batch_calls;}
     void set_client_info(uint32_t id, const std::string& name, uint32_t pub_id, const std::string& pub_name);
     void set_sequence_storage(SequenceStorage* sequence_storage);
     bool init_sequence_storage(StorageType storage_type);
+    /* 다른 곳 (SubscriberGroup 의 공유 HashMaster) 이 소유한 record 에 직접 기록, 저장 호출 없음 (mmap writeback)
+       topics_path 가 있으면 확장 토픽 seq 테이블 파일 */
+    bool attach_sequence_record(PublisherSequenceRecord* record, const std::string& topics_path = "");
+    /* 같은 event_base 의 다른 연결과 수신 버퍼 공유, connect 전에 설정 */
+    void set_frame_parser(FrameParser* parser) {_shared_parser = parser;}
+    /* publisher 의 shm 로그 이름 (비어있으면 socket 으로 데이터 수신) */
+    void set_shm_log(const std::string& name) {_shm_log_name = name;}
+    inline bool is_shm_active() const {return _shm_active;}
+    inline uint64_t get_shm_messages_read() const {return _shm_messages_read;}
+    inline uint64_t get_shm_rewinds() const {return _shm_rewinds;}
+    inline uint64_t get_shm_overruns() const {return _shm_overruns;}
+    /* publisher 의 multicast 그룹 "group:port" (비어있으면 socket 으로 데이터 수신), iface 는 수신 인터페이스 IP */
+    void set_multicast(const std::string& address, const std::string& iface = "") {_mcast_address = address; _mcast_interface = iface;}
+    inline bool is_multicast_active() const {return _mcast_active;}
+    inline uint64_t get_multicast_datagrams() const {return _mcast_datagrams;}
+    inline uint64_t get_multicast_messages() const {return _mcast_messages;}
+    inline uint64_t get_multicast_gaps() const {return _mcast_gaps;}
+    /* topic_mask 토픽은 key 별 최신값만 수신 (interval_ms 0: socket 이 비면 전송, >0: 주기 전송), connect 전에 설정 */
+    void set_conflation(uint32_t topic_mask, uint32_t interval_ms = 0) {_conflate_mask = topic_mask; _conflate_interval_ms = interval_ms;}
+    /* subscription_mask group 중 이 토픽들만 실시간 수신 (TopicRegistry 에 등록된 토픽, 빈 목록: 필터 해제), connect 전에 설정 */
+    void set_topic_filter(const std::vector<DataTopic>& topics);
+    /* 이 종목 (publisher symbol index 의 master key, 최대 SYMBOL_KEY_SIZE-1 자) 메시지만 socket 으로 수신, connect 전에 설정
+       걸러진 메시지만큼 topic seq 가 건너뛰므로 필터가 있으면 앞으로 건너뛴 seq 는 누락으로 보지 않는다 */
+    void set_symbol_filter(const std::vector<std::string>& symbols);
+    /* TCP 연결 socket 에 SO_BUSY_POLL 설정 (spin event loop 와 함께 사용) */
+    void set_socket_busy_poll(int busy_poll_us) {_socket_profile.busy_poll_us = busy_poll_us;}
+    /* connect 하는 socket 옵션 (TCP_NODELAY / QUICKACK / buffer 크기 / busy poll / bufferevent 단위), connect 전에 설정 */
+    void set_socket_profile(const SocketProfile& profile) {_socket_profile = profile;}
+    const SocketProfile& get_socket_profile() const {return _socket_profile;}
+    /* 일련번호 저장 주기: every_messages 개 갱신마다 또는 interval_ms 마다 (1, 0 이면 매 메시지 저장) */
+    void set_sequence_persist_policy(uint32_t every_messages, uint32_t interval_ms);
+    /* 저장 안 된 일련번호를 바로 저장 */
+    void flush_sequences();
+    inline size_t get_pending_gaps() const {return _gaps.size();}
+    inline uint64_t get_gaps_detected() const {return _gaps_detected;}
+    inline uint64_t get_gaps_filled() const {return _gaps_filled;}
+    inline uint64_t get_gap_fallbacks() const {return _gap_fallbacks;}
+    /* 토픽별 one-way 지연 히스토그램 ("latency.subscriber.*", publisher 와 같은 wall clock 기준) */
+    void set_latency_tracking(bool enable) {_latency.reset(enable ? new SubscriberLatency() : nullptr);}
+    /* socket 실시간 payload 형식 (WIRE_ENCODING_*), connect 전에 설정 */
+    void set_wire_encoding(uint32_t encoding) {_wire_encoding = encoding;}
+    /* publisher 의 add_wire_layout 과 같은 레이아웃 등록 (compact 메시지 복원 / view 전달용) */
+    void add_wire_layout(DataTopic topic, std::shared_ptr<RecordLayout> layout);
+    void set_wire_record_callback(WireRecordCallback callback) {_wire_callback = callback;}
+    inline uint64_t get_wire_messages() const {return _wire_messages;}
+    inline uint64_t get_wire_decode_errors() const {return _wire_decode_errors;}
+    /* 전체 복구 스트림 압축 요청 (BLOCK_CODEC_*, publisher 가 지원하지 않으면 압축 없이 옴) */
+    void set_recovery_compression(BlockCodec codec) {_recovery_compression = codec;}
+    inline uint64_t get_recovery_batches() const {return _recovery_batches;}
+    inline uint64_t get_recovery_batch_errors() const {return _recovery_batch_errors;}
+    /* 밀린 양이 min_messages 이상인 재접속 복구를 streams 개 연결로 chunk_messages 씩 나눠 받음 (streams 1 이하: 사용 안함), connect 전에 설정 */
+    void set_parallel_recovery(size_t streams, uint32_t chunk_messages, uint32_t min_messages);
+    inline uint64_t get_parallel_recoveries() const {return _parallel_recoveries;}
+    inline uint64_t get_parallel_recovery_failures() const {return _parallel_recovery_failures;}
+    const RecoveryFetcher* get_recovery_fetcher() const {return _fetcher.get();}
 
     /* 서버 연결 시도, _socket_type 에 따라 소켓 생성 및 연결 */
     bool connect();
@@ -77,6 +414,8 @@ public:
 
     bool send_subscription_request();
     bool send_recovery_request();
+    /* since_ns (epoch ns) 이후 메시지부터 복구 요청 (장중 replay 용, publisher DB 시간 인덱스로 시작 seq 를 찾음) */
+    bool send_time_recovery_request(uint64_t since_ns);
 
     void handle_connected(char* data, int size);
     void handle_disconnected(char* data, int size);
@@ -86,6 +425,8 @@ public:
     int validate_sequence(DataTopic topic, uint32_t sequence);
     // Message processing
     void handle_incomming_messages(char* data, int size);   
+    /* read callback 한번에 파싱된 메시지들 (evbuffer 내부 포인터) */
+    void handle_incomming_batch(const ProtocolMessage* messages, size_t count);
     /* TOPIC MSG 파싱 처리 */
     void handle_topic_message(const TopicMessage& topic_message);
     /* SUBSCRIPTION RESPONSE 처리 */
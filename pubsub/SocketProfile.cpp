@@ -0,0 +1,116 @@
+#include "SocketProfile.h"
+#include <iostream>
+#include <cstring>
+#include <cerrno>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <event2/event.h>
+
+namespace SimplePubSub {
+
+namespace {
+
+// throughput: 10G 에서 RTT 100us 정도의 BDP 여유 (net.core.wmem_max / rmem_max 가 작으면 커널이 잘라냄)
+const int THROUGHPUT_SOCKET_BUFFER = 4 * 1024 * 1024;
+const size_t THROUGHPUT_SINGLE_IO = 256 * 1024;
+const int LATENCY_BUSY_POLL_US = 50;
+
+bool set_int_option(int fd, int level, int name, int value, const char* label) {
+    if (setsockopt(fd, level, name, &value, sizeof(value)) == 0) {
+        return true;
+    }
+    std::cerr << "SocketProfile: failed to set " << label << "=" << value << " on fd=" << fd
+              << ": " << strerror(errno) << std::endl;
+    return false;
+}
+
+bool same_profile(const SocketProfile& a, const SocketProfile& b) {
+    return a.tcp_nodelay == b.tcp_nodelay && a.tcp_quickack == b.tcp_quickack &&
+           a.send_buffer == b.send_buffer && a.recv_buffer == b.recv_buffer &&
+           a.busy_poll_us == b.busy_poll_us && a.max_single_read == b.max_single_read &&
+           a.max_single_write == b.max_single_write;
+}
+
+} // namespace
+
+SocketProfile SocketProfile::latency() {
+    SocketProfile p;
+    p.tcp_nodelay = true;
+    p.tcp_quickack = true;
+    p.busy_poll_us = LATENCY_BUSY_POLL_US;
+    return p;
+}
+
+SocketProfile SocketProfile::throughput() {
+    SocketProfile p;
+    p.send_buffer = THROUGHPUT_SOCKET_BUFFER;
+    p.recv_buffer = THROUGHPUT_SOCKET_BUFFER;
+    p.max_single_read = THROUGHPUT_SINGLE_IO;
+    p.max_single_write = THROUGHPUT_SINGLE_IO;
+    return p;
+}
+
+bool socket_profile_from_name(const std::string& name, SocketProfile& profile) {
+    if (name.empty() || name == "none" || name == "default") {
+        profile = SocketProfile();
+    } else if (name == "latency") {
+        profile = SocketProfile::latency();
+    } else if (name == "throughput") {
+        profile = SocketProfile::throughput();
+    } else {
+        return false;
+    }
+    return true;
+}
+
+const char* socket_profile_name(const SocketProfile& profile) {
+    if (profile.empty()) return "none";
+    if (same_profile(profile, SocketProfile::latency())) return "latency";
+    if (same_profile(profile, SocketProfile::throughput())) return "throughput";
+    return "custom";
+}
+
+bool apply_socket_profile(int fd, const SocketProfile& profile, bool tcp) {
+    bool ok = true;
+    if (profile.send_buffer > 0) {
+        ok &= set_int_option(fd, SOL_SOCKET, SO_SNDBUF, profile.send_buffer, "SO_SNDBUF");
+    }
+    if (profile.recv_buffer > 0) {
+        ok &= set_int_option(fd, SOL_SOCKET, SO_RCVBUF, profile.recv_buffer, "SO_RCVBUF");
+    }
+    if (!tcp) {
+        return ok;
+    }
+    if (profile.tcp_nodelay) {
+        ok &= set_int_option(fd, IPPROTO_TCP, TCP_NODELAY, 1, "TCP_NODELAY");
+    }
+    if (profile.tcp_quickack) {
+        ok &= set_int_option(fd, IPPROTO_TCP, TCP_QUICKACK, 1, "TCP_QUICKACK");
+    }
+    if (profile.busy_poll_us > 0) {
+#ifdef SO_BUSY_POLL
+        ok &= set_int_option(fd, SOL_SOCKET, SO_BUSY_POLL, profile.busy_poll_us, "SO_BUSY_POLL");
+#else
+        std::cerr << "SocketProfile: SO_BUSY_POLL not supported on this platform" << std::endl;
+        ok = false;
+#endif
+    }
+    return ok;
+}
+
+void apply_bufferevent_profile(bufferevent* bev, const SocketProfile& profile) {
+#if LIBEVENT_VERSION_NUMBER >= 0x02010100
+    if (profile.max_single_read > 0) bufferevent_set_max_single_read(bev, profile.max_single_read);
+    if (profile.max_single_write > 0) bufferevent_set_max_single_write(bev, profile.max_single_write);
+#else
+    (void)bev; (void)profile;
+#endif
+}
+
+void rearm_quickack(int fd) {
+    int one = 1;
+    setsockopt(fd, IPPROTO_TCP, TCP_QUICKACK, &one, sizeof(one));
+}
+
+} // namespace SimplePubSub
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+#include <event2/bufferevent.h>
+
+namespace SimplePubSub {
+
+/**
+ * SocketProfile - publisher / subscriber 양쪽 socket 에 같은 방식으로 거는 socket 옵션 묶음
+ *
+ * 기본값 (none) 은 아무 것도 설정하지 않는다 (커널 / libevent 기본 동작).
+ *  - latency    : TCP_NODELAY + TCP_QUICKACK, SO_BUSY_POLL 50us, bufferevent 기본 read/write 단위 (16KB)
+ *  - throughput : Nagle 유지, 송수신 socket buffer 4MB, read / write 한번에 256KB (callback / syscall 수 감소)
+ * TCP 옵션 (nodelay / quickack / busy poll) 은 TCP socket 에만, buffer 크기는 unix socket 에도 적용한다.
+ * TCP_QUICKACK 은 커널이 다시 delayed ACK 로 돌아가므로 subscriber 는 read batch 마다 다시 설정한다.
+ * SO_SNDBUF / SO_RCVBUF 를 지정하면 그 socket 의 커널 autotuning 은 꺼진다 (net.core.[rw]mem_max 까지만 허용).
+ */
+struct SocketProfile {
+    bool tcp_nodelay;
+    bool tcp_quickack;
+    int send_buffer;            // SO_SNDBUF bytes (0: 커널 기본 / autotuning)
+    int recv_buffer;            // SO_RCVBUF bytes (0: 커널 기본 / autotuning)
+    int busy_poll_us;           // SO_BUSY_POLL (0: 설정 안함)
+    size_t max_single_read;     // bufferevent 한번에 읽는 최대 bytes (0: libevent 기본)
+    size_t max_single_write;    // bufferevent 한번에 쓰는 최대 bytes (0: libevent 기본)
+
+    SocketProfile()
+        : tcp_nodelay(false), tcp_quickack(false), send_buffer(0), recv_buffer(0), busy_poll_us(0),
+          max_single_read(0), max_single_write(0) {}
+
+    static SocketProfile latency();
+    static SocketProfile throughput();
+
+    bool empty() const {
+        return !tcp_nodelay && !tcp_quickack && send_buffer == 0 && recv_buffer == 0 && busy_poll_us == 0 &&
+               max_single_read == 0 && max_single_write == 0;
+    }
+};
+
+/* "none" / "latency" / "throughput", 모르는 이름이면 false (profile 은 그대로) */
+bool socket_profile_from_name(const std::string& name, SocketProfile& profile);
+const char* socket_profile_name(const SocketProfile& profile);
+
+/* fd 에 profile 적용, 실패한 옵션은 로그를 남기고 false (나머지 옵션은 계속 적용) */
+bool apply_socket_profile(int fd, const SocketProfile& profile, bool tcp);
+/* bufferevent read / write 단위 (libevent 2.1 이상) */
+void apply_bufferevent_profile(bufferevent* bev, const SocketProfile& profile);
+/* TCP_QUICKACK 다시 설정 (ACK 를 바로 보내도록, read 처리 뒤 호출) */
+void rearm_quickack(int fd);
+
+} // namespace SimplePubSub
@@ -0,0 +1,89 @@
+#ifndef SPSC_QUEUE_H
+#define SPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * SpscQueue - 스레드 내부용 single-producer / single-consumer bounded ring
+ *
+ * publish 스레드(producer) 가 I/O reactor 스레드(consumer) 로 fan-out 작업을 넘길 때 사용.
+ * 락 없이 head/tail 만 atomic 으로 공개하며, 용량은 2의 거듭제곱으로 올림한다.
+ *
+ * - try_push(): producer 스레드에서만 호출, 꽉 차면 false
+ * - try_pop():  consumer 스레드에서만 호출, 비어있으면 false
+ */
+template <typename T>
+class SpscQueue {
+public:
+    explicit SpscQueue(size_t capacity = 4096) {
+        size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        _slots.resize(cap);
+        _mask = cap - 1;
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    bool try_push(T&& value) {
+        size_t tail = _tail.load(std::memory_order_relaxed);
+        if (tail - _head_cache > _mask) {
+            _head_cache = _head.load(std::memory_order_acquire);
+            if (tail - _head_cache > _mask) return false;
+        }
+        _slots[tail & _mask] = std::move(value);
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool try_pop(T& value) {
+        size_t head = _head.load(std::memory_order_relaxed);
+        if (head == _tail_cache) {
+            _tail_cache = _tail.load(std::memory_order_acquire);
+            if (head == _tail_cache) return false;
+        }
+        value = std::move(_slots[head & _mask]);
+        _slots[head & _mask] = T();
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t size_approx() const {
+        return _tail.load(std::memory_order_acquire) - _head.load(std::memory_order_acquire);
+    }
+
+    size_t capacity() const { return _mask + 1; }
+
+private:
+    std::vector<T> _slots;
+    size_t _mask;
+
+    alignas(64) std::atomic<size_t> _head{0};   // consumer 가 갱신
+    size_t _tail_cache{0};                      // consumer 전용
+
+    alignas(64) std::atomic<size_t> _tail{0};   // producer 가 갱신
+    size_t _head_cache{0};                      // producer 전용
+};
+
+/*
+ * SpscQueue 를 멤버로 가진 객체를 new 로 만들 때의 base.
+ * C++14 의 new 는 alignas(64) 를 보장하지 않으므로 (__STDCPP_DEFAULT_NEW_ALIGNMENT__ 까지만)
+ * head / tail 이 cache line 경계에서 어긋나 false sharing 이 생긴다. posix_memalign 으로 64 byte 정렬.
+ */
+struct SpscAlignedNew {
+    static void* operator new(size_t size) {
+        void* p = nullptr;
+        if (posix_memalign(&p, 64, size) != 0) {
+            throw std::bad_alloc();
+        }
+        return p;
+    }
+    static void operator delete(void* p) { free(p); }
+};
+
+#endif // SPSC_QUEUE_H
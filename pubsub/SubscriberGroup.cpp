@@ -0,0 +1,221 @@
+#include "SubscriberGroup.h"
+#include <iostream>
+#include <algorithm>
+
+namespace {
+
+// 병합 대기 메시지 확인 주기 (window 의 절반, 최소 1ms)
+const uint64_t MERGE_TIMER_MIN_US = 1000;
+
+} // namespace
+
+SubscriberGroup::SubscriberGroup(struct event_base* base, uint32_t id, const std::string& name)
+    : _base(base), _id(id), _name(name), _merge_window_ns(0), _merge_order(0), _last_emitted(0),
+      _merge_timer(nullptr), _merge_timer_armed(false), _merged_messages(0), _merge_late(0) {}
+
+SubscriberGroup::~SubscriberGroup() {
+    if (_merge_timer) {
+        event_free(_merge_timer);
+    }
+    // record 를 가리키는 구독자를 storage 보다 먼저 정리
+    _members.clear();
+}
+
+bool SubscriberGroup::init_sequence_storage(const std::string& storage_path) {
+    _storage_path = storage_path.empty() ? "./sequence_data/sub" + _name + "_group_sequences" : storage_path;
+    _storage.reset(new SimplePubSub::HashmasterSequenceStorage(_storage_path));
+    if (!_storage->initialize()) {
+        std::cerr << "SubscriberGroup: failed to open sequence storage " << _storage_path << std::endl;
+        _storage.reset();
+        return false;
+    }
+    return true;
+}
+
+SimpleSubscriber* SubscriberGroup::add_subscriber(uint32_t pub_id, const std::string& pub_name) {
+    if (!_storage && !init_sequence_storage()) {
+        return nullptr;
+    }
+    PublisherSequenceRecord* record = _storage->load_sequences_direct(pub_name);
+    if (record == nullptr) {
+        std::cerr << "SubscriberGroup: no sequence record for publisher " << pub_name << std::endl;
+        return nullptr;
+    }
+
+    std::unique_ptr<SimpleSubscriber> subscriber(new SimpleSubscriber(_base));
+    subscriber->set_client_info(_id, _name, pub_id, pub_name);
+    subscriber->set_publisher_name(pub_name);
+    if (!subscriber->attach_sequence_record(record, _storage_path + "_" + pub_name + ".topics")) {
+        return nullptr;
+    }
+    // record 는 mmap 에 바로 기록되므로 구독자별 저장 timer 가 필요 없다
+    subscriber->set_sequence_persist_policy(0, 0);
+    subscriber->set_frame_parser(&_parser);
+    for (const auto& layout : _layouts) {
+        subscriber->add_record_layout(layout.first, layout.second);
+    }
+    uint32_t source = static_cast<uint32_t>(_members.size());
+    subscriber->set_topic_batch_callback([this, source](const TopicMessageView* messages, size_t count) {
+        on_member_batch(source, messages, count);
+    });
+
+    Member member;
+    member.subscriber = std::move(subscriber);
+    member.last_timestamp = 0;
+    member.last_arrival = 0;
+    _members.push_back(std::move(member));
+    std::cout << "SubscriberGroup " << _name << ": publisher " << pub_name << " (id " << pub_id << ", seq "
+              << record->all_topics_sequence << ")" << std::endl;
+    return _members.back().subscriber.get();
+}
+
+void SubscriberGroup::set_merge_by_timestamp(uint32_t window_ms) {
+    if (window_ms == 0) {
+        release_merged(true);
+    }
+    _merge_window_ns = static_cast<uint64_t>(window_ms) * 1000000;
+}
+
+void SubscriberGroup::add_record_layout(DataTopic topic, std::shared_ptr<RecordLayout> layout) {
+    _layouts.push_back(std::make_pair(topic, layout));
+    _record_views.add(topic, layout);
+    for (auto& member : _members) {
+        member.subscriber->add_record_layout(topic, layout);
+    }
+}
+
+void SubscriberGroup::connect_all() {
+    for (auto& member : _members) {
+        if (!member.subscriber->connect()) {
+            member.subscriber->try_reconnect();
+        }
+    }
+}
+
+void SubscriberGroup::flush() {
+    release_merged(true);
+}
+
+void SubscriberGroup::stop() {
+    for (auto& member : _members) {
+        member.subscriber->stop();
+    }
+    release_merged(true);
+    if (_merge_timer_armed) {
+        event_del(_merge_timer);
+        _merge_timer_armed = false;
+    }
+}
+
+void SubscriberGroup::on_member_batch(uint32_t source, const TopicMessageView* messages, size_t count) {
+    if (_merge_window_ns == 0) {
+        if (_callback) _callback(messages, count);
+        return;
+    }
+    Member& member = _members[source];
+    for (size_t i = 0; i < count; ++i) {
+        Pending p;
+        p.timestamp = messages[i].timestamp;
+        p.source = source;
+        p.order = _merge_order++;
+        p.offset = _arena.size();
+        p.view = messages[i];
+        p.view.record = nullptr;
+        _arena.insert(_arena.end(), messages[i].data, messages[i].data + messages[i].size);
+        _pending.push_back(p);
+        if (p.timestamp > member.last_timestamp) member.last_timestamp = p.timestamp;
+    }
+    member.last_arrival = get_current_timestamp();
+    release_merged(false);
+    if (!_pending.empty()) {
+        arm_merge_timer();
+    }
+}
+
+void SubscriberGroup::release_merged(bool force) {
+    if (_pending.empty()) {
+        return;
+    }
+    uint64_t now = get_current_timestamp();
+    uint64_t cutoff = UINT64_MAX;
+    if (!force) {
+        // 최근 window 안에 받은 publisher 중 가장 뒤처진 timestamp 까지 (모두 쉬면 now - window)
+        uint64_t floor = now > _merge_window_ns ? now - _merge_window_ns : 0;
+        uint64_t slowest = UINT64_MAX;
+        for (const auto& member : _members) {
+            if (member.last_arrival != 0 && member.last_arrival + _merge_window_ns >= now) {
+                slowest = std::min(slowest, member.last_timestamp);
+            }
+        }
+        cutoff = (slowest != UINT64_MAX) ? std::max(slowest, floor) : floor;
+    }
+
+    std::sort(_pending.begin(), _pending.end(), [](const Pending& a, const Pending& b) {
+        return a.timestamp != b.timestamp ? a.timestamp < b.timestamp : a.order < b.order;
+    });
+    size_t ready = 0;
+    while (ready < _pending.size() && _pending[ready].timestamp <= cutoff) {
+        ++ready;
+    }
+    if (ready == 0) {
+        return;
+    }
+
+    _out.clear();
+    for (size_t i = 0; i < ready; ++i) {
+        Pending& p = _pending[i];
+        if (p.timestamp < _last_emitted) {
+            _merge_late++;
+        } else {
+            _last_emitted = p.timestamp;
+        }
+        p.view.data = _arena.data() + p.offset;
+        p.view.record = _record_views.bind(p.view.topic, p.view.data, p.view.size);
+        _out.push_back(p.view);
+    }
+    _merged_messages += ready;
+    if (_callback) _callback(_out.data(), _out.size());
+    _record_views.reset();
+
+    // 남은 메시지 payload 를 앞으로 모은다 (버퍼는 교대로 재사용)
+    _arena_spare.clear();
+    size_t kept = 0;
+    for (size_t i = ready; i < _pending.size(); ++i) {
+        Pending p = _pending[i];
+        size_t offset = _arena_spare.size();
+        _arena_spare.insert(_arena_spare.end(), _arena.data() + p.offset, _arena.data() + p.offset + p.view.size);
+        p.offset = offset;
+        _pending[kept++] = p;
+    }
+    _pending.resize(kept);
+    _arena.swap(_arena_spare);
+}
+
+void SubscriberGroup::arm_merge_timer() {
+    if (_merge_timer_armed) {
+        return;
+    }
+    if (!_merge_timer) {
+        _merge_timer = event_new(_base, -1, EV_PERSIST, merge_timer_cb, this);
+        if (!_merge_timer) {
+            std::cerr << "SubscriberGroup: failed to create merge timer" << std::endl;
+            return;
+        }
+    }
+    uint64_t interval_us = std::max<uint64_t>(_merge_window_ns / 2000, MERGE_TIMER_MIN_US);
+    struct timeval tv;
+    tv.tv_sec = static_cast<time_t>(interval_us / 1000000);
+    tv.tv_usec = static_cast<suseconds_t>(interval_us % 1000000);
+    if (event_add(_merge_timer, &tv) == 0) {
+        _merge_timer_armed = true;
+    }
+}
+
+void SubscriberGroup::merge_timer_cb(evutil_socket_t, short, void* arg) {
+    SubscriberGroup* self = static_cast<SubscriberGroup*>(arg);
+    self->release_merged(self->_merge_window_ns == 0);
+    if (self->_pending.empty()) {
+        event_del(self->_merge_timer);
+        self->_merge_timer_armed = false;
+    }
+}
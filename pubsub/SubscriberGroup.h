@@ -0,0 +1,101 @@
+#ifndef SUBSCRIBER_GROUP_H
+#define SUBSCRIBER_GROUP_H
+
+#include "SimpleSubscriber.h"
+#include "HashmasterSequenceStorage.h"
+#include <memory>
+#include <string>
+#include <vector>
+
+/*
+* SubscriberGroup - 한 event loop 에서 여러 publisher 를 구독하는 fan-in
+*
+* 구독자마다 파일 / HashMaster 를 따로 여는 대신
+*   - 일련번호: HashMaster 하나에 publisher 별 record (key: pub_name) 를 두고 구독자는 mmap record 에 바로 기록한다.
+*     메시지마다 save 호출이 없고 반영은 커널 writeback (publisher 의 HashMaster direct record 와 같음).
+*   - 수신: FrameParser 하나를 모든 연결이 같이 쓴다 (read callback 은 한 스레드에서 하나씩 끝나므로 겹치지 않음).
+*   - 전달: 구독자의 batch view 를 그대로 group 콜백으로 (publisher_id 로 출처 구분, 복사 없음).
+* set_merge_by_timestamp(window_ms) 이면 모든 publisher 메시지를 TopicMessage::timestamp 순으로 합쳐 전달한다.
+*   payload 를 group 버퍼로 복사해 두고, 최근 window 안에 수신한 publisher 들의 마지막 timestamp 중 가장 작은 값
+*   (없으면 now - window) 까지를 정렬해 넘긴다. 쉬는 publisher 는 window 가 지나면 기다리지 않는다.
+*   이미 넘긴 시각보다 이른 메시지가 늦게 오면 (window 보다 늦은 수신) 순서를 어기고 바로 다음 batch 로 넘기고 센다.
+*
+* 모든 구독자는 group 과 같은 event_base 를 쓴다. 주소 / 필터 등 구독자별 설정은 add_subscriber 가 돌려준 구독자에 한다.
+*/
+class SubscriberGroup {
+public:
+    SubscriberGroup(struct event_base* base, uint32_t id, const std::string& name);
+    ~SubscriberGroup();
+
+    SubscriberGroup(const SubscriberGroup&) = delete;
+    SubscriberGroup& operator=(const SubscriberGroup&) = delete;
+
+    /* publisher record 를 둘 HashMaster 파일 (비어있으면 ./sequence_data/sub<name>_group_sequences), add_subscriber 전에 */
+    bool init_sequence_storage(const std::string& storage_path = "");
+    /* publisher 하나 추가 (client info / 공유 record / 공유 parser / batch 콜백 설정까지), 실패하면 nullptr */
+    SimpleSubscriber* add_subscriber(uint32_t pub_id, const std::string& pub_name);
+
+    void set_batch_callback(TopicBatchCallback callback) {_callback = callback;}
+    /* window_ms > 0 이면 timestamp 순 병합 (0: 수신 순서대로 구독자 batch 그대로) */
+    void set_merge_by_timestamp(uint32_t window_ms);
+    void add_record_layout(DataTopic topic, std::shared_ptr<RecordLayout> layout);
+
+    /* 모든 구독자 연결 시도, 실패한 구독자는 재연결 timer */
+    void connect_all();
+    /* 병합 대기 메시지를 모두 넘김 */
+    void flush();
+    void stop();
+
+    size_t size() const {return _members.size();}
+    SimpleSubscriber* subscriber(size_t index) {return _members[index].subscriber.get();}
+    inline uint64_t get_merged_messages() const {return _merged_messages;}
+    inline uint64_t get_merge_late() const {return _merge_late;}
+    inline size_t get_merge_pending() const {return _pending.size();}
+
+private:
+    struct Member {
+        std::unique_ptr<SimpleSubscriber> subscriber;
+        uint64_t last_timestamp;        // 마지막으로 받은 메시지 timestamp
+        uint64_t last_arrival;          // 마지막 수신 시각 (같은 clock)
+    };
+    struct Pending {
+        uint64_t timestamp;
+        uint32_t source;
+        uint64_t order;                 // 같은 timestamp 면 수신 순서
+        size_t offset;                  // _arena 안 payload 위치
+        TopicMessageView view;
+    };
+
+    struct event_base* _base;
+    uint32_t _id;
+    std::string _name;
+    // 구독자보다 먼저 선언 (구독자가 record 를 쓰는 동안 유지)
+    std::unique_ptr<SimplePubSub::HashmasterSequenceStorage> _storage;
+    std::string _storage_path;
+    FrameParser _parser;
+    std::vector<Member> _members;
+    std::vector<std::pair<DataTopic, std::shared_ptr<RecordLayout>>> _layouts;
+    TopicBatchCallback _callback;
+
+    // timestamp 병합
+    uint64_t _merge_window_ns;
+    std::vector<Pending> _pending;
+    std::vector<char> _arena;
+    std::vector<char> _arena_spare;
+    std::vector<TopicMessageView> _out;
+    RecordViewPool _record_views;
+    uint64_t _merge_order;
+    uint64_t _last_emitted;
+    struct event* _merge_timer;
+    bool _merge_timer_armed;
+    uint64_t _merged_messages;
+    uint64_t _merge_late;
+
+    void on_member_batch(uint32_t source, const TopicMessageView* messages, size_t count);
+    /* cutoff 이하 timestamp 를 순서대로 넘김 (force: 전부) */
+    void release_merged(bool force);
+    void arm_merge_timer();
+    static void merge_timer_cb(evutil_socket_t fd, short events, void* arg);
+};
+
+#endif // SUBSCRIBER_GROUP_H
@@ -0,0 +1,230 @@
+#include "TopicRegistry.h"
+#include <iostream>
+#include <fstream>
+#include <cstring>
+#include <cerrno>
+#include <cstdlib>
+#include <climits>
+#include <algorithm>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace SimplePubSub {
+
+namespace {
+
+std::string trim(const std::string& str) {
+    size_t first = str.find_first_not_of(" \t\r\n");
+    if (first == std::string::npos) return "";
+    size_t last = str.find_last_not_of(" \t\r\n");
+    return str.substr(first, last - first + 1);
+}
+
+std::string parse_value(const std::string& str) {
+    std::string value = trim(str);
+    size_t comment = value.find('#');
+    if (comment != std::string::npos) value = trim(value.substr(0, comment));
+    if (value.size() >= 2 && (value.front() == '"' || value.front() == '\'') && value.back() == value.front()) {
+        value = value.substr(1, value.size() - 2);
+    }
+    return value;
+}
+
+bool parse_group(const std::string& value, DataTopic& group) {
+    if (value == "TOPIC1") group = DataTopic::TOPIC1;
+    else if (value == "TOPIC2") group = DataTopic::TOPIC2;
+    else if (value == "MISC") group = DataTopic::MISC;
+    else return false;
+    return true;
+}
+
+} // namespace
+
+TopicRegistry::TopicRegistry() {
+    _topics.push_back(TopicInfo{DataTopic::TOPIC1, "TOPIC1", 0, DataTopic::TOPIC1});
+    _topics.push_back(TopicInfo{DataTopic::TOPIC2, "TOPIC2", 0, DataTopic::TOPIC2});
+    _topics.push_back(TopicInfo{DataTopic::MISC, "MISC", 0, DataTopic::MISC});
+    for (int i = 0; i < LEGACY_SLOTS; ++i) {
+        _by_name[_topics[i].name] = i;
+    }
+}
+
+TopicRegistry& TopicRegistry::global() {
+    static TopicRegistry registry;
+    return registry;
+}
+
+bool TopicRegistry::add(const std::string& name, uint32_t number, DataTopic group) {
+    if (name.empty() || number == 0 || number > (UINT32_MAX >> TOPIC_GROUP_BITS) || TopicRegistry::legacy_slot(group) < 0) {
+        std::cerr << "TopicRegistry: invalid topic '" << name << "' number " << number << std::endl;
+        return false;
+    }
+    DataTopic topic = make_topic(number, group);
+    auto named = _by_name.find(name);
+    if (named != _by_name.end() || (number < _slot_by_number.size() && _slot_by_number[number] >= 0)) {
+        if (named != _by_name.end() && _topics[named->second].topic == topic) {
+            return true;
+        }
+        std::cerr << "TopicRegistry: duplicate topic '" << name << "' number " << number << std::endl;
+        return false;
+    }
+    if (_topics.size() >= MAX_TOPICS) {
+        std::cerr << "TopicRegistry: too many topics (max " << MAX_TOPICS << ")" << std::endl;
+        return false;
+    }
+    int slot = static_cast<int>(_topics.size());
+    _topics.push_back(TopicInfo{topic, name, number, group});
+    if (number >= _slot_by_number.size()) {
+        _slot_by_number.resize(number + 1, -1);
+    }
+    _slot_by_number[number] = slot;
+    _by_name[name] = slot;
+    return true;
+}
+
+// BinaryRecord 의 spec yaml 과 같이 줄 단위로 읽음 (YAMLParser 는 목록을 지원하지 않음)
+bool TopicRegistry::load_from_file(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        std::cerr << "TopicRegistry: cannot open " << path << std::endl;
+        return false;
+    }
+    std::string line, name, group_name;
+    uint32_t number = 0;
+    bool in_topics = false, has_entry = false, ok = true;
+    size_t loaded = 0;
+
+    auto flush_entry = [&]() {
+        if (!has_entry) return;
+        DataTopic group = DataTopic::TOPIC1;
+        if (!parse_group(group_name, group)) {
+            std::cerr << "TopicRegistry: topic '" << name << "' has invalid group '" << group_name << "'" << std::endl;
+            ok = false;
+        } else if (add(name, number, group)) {
+            loaded++;
+        } else {
+            ok = false;
+        }
+        name.clear();
+        group_name.clear();
+        number = 0;
+        has_entry = false;
+    };
+
+    while (std::getline(file, line)) {
+        std::string trimmed = trim(line);
+        if (trimmed.empty() || trimmed[0] == '#') continue;
+        bool top_level = line.find_first_not_of(" \t") == 0;
+        if (top_level) {
+            flush_entry();
+            in_topics = (trimmed == "topics:");
+            continue;
+        }
+        if (!in_topics) continue;
+        if (trimmed[0] == '-') {
+            flush_entry();
+            has_entry = true;
+            trimmed = trim(trimmed.substr(1));
+            if (trimmed.empty()) continue;
+        }
+        size_t colon = trimmed.find(':');
+        if (colon == std::string::npos) continue;
+        std::string key = trim(trimmed.substr(0, colon));
+        std::string value = parse_value(trimmed.substr(colon + 1));
+        if (key == "name") name = value;
+        else if (key == "number") number = static_cast<uint32_t>(strtoul(value.c_str(), nullptr, 0));
+        else if (key == "group") group_name = value;
+    }
+    flush_entry();
+    std::cout << "TopicRegistry: " << loaded << " topics loaded from " << path
+              << " (" << _topics.size() << " slots)" << std::endl;
+    return ok;
+}
+
+DataTopic TopicRegistry::find(const std::string& name) const {
+    auto it = _by_name.find(name);
+    return it != _by_name.end() ? _topics[it->second].topic : static_cast<DataTopic>(0);
+}
+
+std::string TopicRegistry::name(uint32_t topic) const {
+    int s = slot(topic);
+    return s >= 0 ? _topics[s].name : topic_to_string(static_cast<DataTopic>(topic));
+}
+
+TopicSequenceTable::TopicSequenceTable()
+    : _record(nullptr), _registry(&TopicRegistry::global()), _entries(nullptr), _fd(-1) {
+    _memory.resize(TopicRegistry::MAX_TOPICS, Entry{0, 0});
+    _entries = _memory.data();
+}
+
+TopicSequenceTable::~TopicSequenceTable() {
+    close();
+}
+
+bool TopicSequenceTable::open(const std::string& path, const TopicRegistry& registry) {
+    close();
+    _registry = &registry;
+    if (path.empty()) {
+        return true;
+    }
+    const size_t bytes = TopicRegistry::MAX_TOPICS * sizeof(Entry);
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (fd < 0 || ftruncate(fd, static_cast<off_t>(bytes)) != 0) {
+        std::cerr << "TopicSequenceTable: failed to open " << path << ": " << strerror(errno) << std::endl;
+        if (fd >= 0) ::close(fd);
+        return false;
+    }
+    void* p = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (p == MAP_FAILED) {
+        std::cerr << "TopicSequenceTable: mmap failed for " << path << ": " << strerror(errno) << std::endl;
+        ::close(fd);
+        return false;
+    }
+    Entry* entries = static_cast<Entry*>(p);
+
+    // 저장된 {topic, seq} 를 현재 registry slot 순서로 다시 배치 (등록이 빠진 토픽은 버림)
+    std::unordered_map<uint32_t, uint32_t> saved;
+    for (size_t i = TopicRegistry::LEGACY_SLOTS; i < TopicRegistry::MAX_TOPICS; ++i) {
+        if (entries[i].topic != 0) saved[entries[i].topic] = entries[i].seq;
+    }
+    for (size_t i = TopicRegistry::LEGACY_SLOTS; i < TopicRegistry::MAX_TOPICS; ++i) {
+        if (i < registry.size()) {
+            uint32_t topic = static_cast<uint32_t>(registry.info(static_cast<int>(i)).topic);
+            auto it = saved.find(topic);
+            entries[i] = Entry{topic, it != saved.end() ? it->second : 0};
+        } else {
+            entries[i] = Entry{0, 0};
+        }
+    }
+    _fd = fd;
+    _entries = entries;
+    std::cout << "TopicSequenceTable: " << path << " (" << saved.size() << " saved, "
+              << registry.size() - TopicRegistry::LEGACY_SLOTS << " extended topics)" << std::endl;
+    return true;
+}
+
+void TopicSequenceTable::close() {
+    if (_fd >= 0) {
+        munmap(_entries, TopicRegistry::MAX_TOPICS * sizeof(Entry));
+        ::close(_fd);
+        _fd = -1;
+    }
+    std::fill(_memory.begin(), _memory.end(), Entry{0, 0});
+    _entries = _memory.data();
+}
+
+void TopicSequenceTable::reset() {
+    for (size_t i = TopicRegistry::LEGACY_SLOTS; i < TopicRegistry::MAX_TOPICS; ++i) {
+        _entries[i].seq = 0;
+    }
+}
+
+void TopicSequenceTable::copy_extended(const TopicSequenceTable& other) {
+    for (size_t i = TopicRegistry::LEGACY_SLOTS; i < TopicRegistry::MAX_TOPICS; ++i) {
+        _entries[i] = other._entries[i];
+    }
+}
+
+} // namespace SimplePubSub
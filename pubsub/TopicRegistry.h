@@ -0,0 +1,147 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include "pubsub/Common.h"
+#include "pubsub/SequenceStorage.h"
+
+namespace SimplePubSub {
+
+/**
+ * TopicRegistry - 토픽 id 와 dense slot 번호 매핑
+ *
+ * slot 0..2 는 기본 토픽 (TOPIC1, TOPIC2, MISC), 확장 토픽은 등록 순서대로 3 부터.
+ * slot 은 토픽별 배열 (시퀀스, 구독자 목록, wire codec) 의 index 로 쓰며 slot() 은 배열 한번 조회 (O(1)).
+ * 프로세스 시작 시 (publisher / subscriber 생성 전) load_from_file 로 채우고 이후에는 읽기만 한다 (락 없음).
+ *
+ * config/TopicMessage.yaml 의 topics: 섹션
+ *   topics:
+ *     - name: KRX_KOSPI_TRADE
+ *       number: 1            # 1 이상, 토픽마다 유일
+ *       group: TOPIC1        # TOPIC1 / TOPIC2 / MISC (구독 topic_mask 단위)
+ */
+class TopicRegistry {
+public:
+    static constexpr int LEGACY_SLOTS = 3;          // TOPIC1, TOPIC2, MISC
+    static constexpr size_t MAX_TOPICS = 4096;      // slot 수 상한 (TopicSequenceTable 파일 크기)
+
+    struct TopicInfo {
+        DataTopic topic;
+        std::string name;
+        uint32_t number;
+        DataTopic group;
+    };
+
+    TopicRegistry();
+
+    static TopicRegistry& global();
+
+    bool load_from_file(const std::string& path);
+    /* 확장 토픽 등록, 이미 같은 이름/number 로 등록되어 있으면 그대로 true */
+    bool add(const std::string& name, uint32_t number, DataTopic group);
+
+    static int legacy_slot(uint32_t topic) {
+        switch (topic) {
+            case DataTopic::TOPIC1: return 0;
+            case DataTopic::TOPIC2: return 1;
+            case DataTopic::MISC:   return 2;
+            default:                return -1;
+        }
+    }
+    // 토픽 group 의 기본 slot (토픽별 latency 통계 등 group 단위 자료)
+    static int group_slot(uint32_t topic) { return legacy_slot(topic_group(topic)); }
+
+    // 등록되지 않은 토픽이면 -1
+    int slot(uint32_t topic) const {
+        uint32_t number = topic_number(topic);
+        if (number == 0) return legacy_slot(topic);
+        if (number >= _slot_by_number.size()) return -1;
+        int s = _slot_by_number[number];
+        return (s >= 0 && static_cast<uint32_t>(_topics[s].topic) == topic) ? s : -1;
+    }
+
+    size_t size() const { return _topics.size(); }
+    bool has_extended() const { return _topics.size() > static_cast<size_t>(LEGACY_SLOTS); }
+    const TopicInfo& info(int slot) const { return _topics[slot]; }
+    /* 이름으로 토픽 id, 없으면 0 */
+    DataTopic find(const std::string& name) const;
+    std::string name(uint32_t topic) const;
+
+private:
+    std::vector<TopicInfo> _topics;                 // slot 순
+    std::vector<int32_t> _slot_by_number;           // number -> slot (-1: 없음)
+    std::unordered_map<std::string, int> _by_name;
+};
+
+/**
+ * TopicSequenceTable - 토픽별 시퀀스 배열 (slot index)
+ *
+ * 기본 토픽 slot 은 PublisherSequenceRecord 의 필드를 그대로 가리키고 (레코드 형식 / 저장소 호환),
+ * 확장 토픽은 이 테이블의 배열에 둔다. open(path) 이면 배열을 파일에 mmap 하고
+ * (MAX_TOPICS 개의 {topic, seq}, 토픽 id 로 저장하므로 yaml 순서가 바뀌어도 다시 맞춰 읽음),
+ * path 가 비어 있으면 메모리에만 둔다. 페이지 반영은 커널 writeback (HashMaster direct 레코드와 같음),
+ * 비정상 종료 시 publisher 는 repair_sequences_from_db 로 DB 에서 다시 맞춘다.
+ */
+class TopicSequenceTable {
+public:
+    struct Entry {
+        uint32_t topic;
+        uint32_t seq;
+    };
+
+    TopicSequenceTable();
+    ~TopicSequenceTable();
+
+    TopicSequenceTable(const TopicSequenceTable&) = delete;
+    TopicSequenceTable& operator=(const TopicSequenceTable&) = delete;
+
+    bool open(const std::string& path, const TopicRegistry& registry = TopicRegistry::global());
+    void close();
+    void attach(PublisherSequenceRecord* record) { _record = record; }
+    bool is_mapped() const { return _fd >= 0; }
+
+    // slot 의 topic seq 위치 (registry.slot 결과, 0 <= slot < MAX_TOPICS)
+    uint32_t* field(int slot) {
+        switch (slot) {
+            case 0: return &_record->topic1_sequence;
+            case 1: return &_record->topic2_sequence;
+            case 2: return &_record->misc_sequence;
+            default: return &_entries[slot].seq;
+        }
+    }
+
+    uint32_t get(uint32_t topic) const {
+        if (topic == static_cast<uint32_t>(DataTopic::ALL_TOPICS)) return _record->all_topics_sequence;
+        switch (int slot = _registry->slot(topic)) {
+            case -1: return 0;
+            case 0: return _record->topic1_sequence;
+            case 1: return _record->topic2_sequence;
+            case 2: return _record->misc_sequence;
+            default: return _entries[slot].seq;
+        }
+    }
+
+    // PublisherSequenceRecord::set_topic_sequence 와 같은 의미 (all_topics_sequence = global_seq)
+    void set(uint32_t global_seq, uint32_t topic, uint32_t topic_seq) {
+        int slot = _registry->slot(topic);
+        if (slot >= 0) *field(slot) = topic_seq;
+        _record->all_topics_sequence = global_seq;
+        _record->last_updated_time = get_current_timestamp();
+    }
+
+    // 확장 토픽 시퀀스 0 으로 (기본 토픽은 레코드에서 초기화)
+    void reset();
+    // 확장 토픽 시퀀스를 other 에서 복사 (같은 registry 로 연 테이블끼리, 기본 토픽은 레코드로 복사)
+    void copy_extended(const TopicSequenceTable& other);
+
+private:
+    PublisherSequenceRecord* _record;
+    const TopicRegistry* _registry;
+    Entry* _entries;                    // MAX_TOPICS 개 (mmap 또는 _memory)
+    std::vector<Entry> _memory;
+    int _fd;
+};
+
+} // namespace SimplePubSub
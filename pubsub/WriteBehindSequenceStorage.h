@@ -0,0 +1,138 @@
+#pragma once
+
+#include "SequenceStorage.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace SimplePubSub {
+
+/**
+ * WriteBehindSequenceStorage - 다른 SequenceStorage 앞에서 저장을 모아 주기적으로 내려쓰는 wrapper
+ *
+ * save_sequences() 는 프로세스 메모리의 레코드에 복사하고 dirty 표시만 한다 (publish 경로에 syscall /
+ * mmap page dirty 없음). 백그라운드 flusher 가 flush_interval_ms 마다 dirty 면 마지막 레코드를 내부
+ * storage 에 한번 저장한다.
+ *
+ * crash 시 저장된 레코드는 실제보다 최대 flush 주기만큼 뒤쳐질 수 있지만 앞서지는 않는다.
+ * 뒤쳐진 부분은 재시작 시 MessageDB::max_seq() 까지 DB 를 읽어 복구한다 (SimplePublisherV2::repair_sequences_from_db).
+ *
+ * 사용: 내부 storage 는 initialize()/load_sequences() 를 마친 뒤 넘기고, start() 로 flusher 를 시작한다.
+ */
+class WriteBehindSequenceStorage : public SequenceStorage {
+public:
+    WriteBehindSequenceStorage(SequenceStorage* inner, uint32_t flush_interval_ms)
+        : _inner(inner), _flush_interval_ms(flush_interval_ms > 0 ? flush_interval_ms : 1),
+          _dirty(false), _running(false), _flush_count(0), _flush_failures(0) {
+    }
+
+    virtual ~WriteBehindSequenceStorage() {
+        cleanup();
+    }
+
+    bool save_sequences(const PublisherSequenceRecord& record) override {
+        std::lock_guard<std::mutex> g(_mu);
+        _pending = record;
+        _dirty = true;
+        return true;
+    }
+
+    bool load_sequences(const std::string& publisher_name, PublisherSequenceRecord* record) override {
+        return _inner->load_sequences(publisher_name, record);
+    }
+
+    // 내부 storage 는 이미 초기화되어 있어야 함, flusher 시작
+    bool initialize() override {
+        return start();
+    }
+
+    bool start() {
+        if (_running.exchange(true)) {
+            return true;
+        }
+        _flusher = std::thread(&WriteBehindSequenceStorage::flusher_loop, this);
+        return true;
+    }
+
+    void clear() override {
+        {
+            std::lock_guard<std::mutex> g(_mu);
+            _dirty = false;
+        }
+        _inner->clear();
+    }
+
+    // flusher 를 멈추고 남은 레코드를 저장
+    void cleanup() override {
+        if (_running.exchange(false)) {
+            _cv.notify_all();
+            if (_flusher.joinable()) {
+                _flusher.join();
+            }
+        }
+        if (_inner) {
+            flush();
+        }
+    }
+
+    std::string get_storage_type() const override {
+        return "write_behind_" + _inner->get_storage_type();
+    }
+
+    /* dirty 면 마지막 레코드를 내부 storage 에 바로 저장 */
+    bool flush() {
+        PublisherSequenceRecord record;
+        {
+            std::lock_guard<std::mutex> g(_mu);
+            if (!_dirty) return true;
+            record = _pending;
+            _dirty = false;
+        }
+        if (!_inner->save_sequences(record)) {
+            _flush_failures++;
+            std::lock_guard<std::mutex> g(_mu);
+            _dirty = true;      // 다음 주기에 (더 최신 레코드로) 다시 시도
+            return false;
+        }
+        _flush_count++;
+        return true;
+    }
+
+    SequenceStorage* inner() { return _inner.get(); }
+    uint32_t get_flush_interval_ms() const { return _flush_interval_ms; }
+    uint64_t get_flush_count() const { return _flush_count.load(); }
+    uint64_t get_flush_failures() const { return _flush_failures.load(); }
+
+private:
+    void flusher_loop() {
+        std::unique_lock<std::mutex> lock(_cv_mu);
+        while (_running.load()) {
+            _cv.wait_for(lock, std::chrono::milliseconds(_flush_interval_ms));
+            if (!_running.load()) break;
+            lock.unlock();
+            flush();
+            lock.lock();
+        }
+    }
+
+    std::unique_ptr<SequenceStorage> _inner;
+    uint32_t _flush_interval_ms;
+
+    std::mutex _mu;                     // _pending / _dirty
+    PublisherSequenceRecord _pending;
+    bool _dirty;
+
+    std::mutex _cv_mu;
+    std::condition_variable _cv;
+    std::atomic<bool> _running;
+    std::thread _flusher;
+    std::atomic<uint64_t> _flush_count;
+    std::atomic<uint64_t> _flush_failures;
+};
+
+} // namespace SimplePubSub
@@ -0,0 +1,133 @@
+#ifndef CSV_PARSER_H
+#define CSV_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "TrepParser.h"
+
+/**
+ * 마스터 CSV 파싱 유틸리티
+ *
+ * - parseLine : 행 하나를 std::string 필드로 (소량 / 디버깅용)
+ * - next_row  : 버퍼 위에서 행을 앞쪽 필드만 TrepSpan 으로 자르고 다음 행으로 이동 (복사/할당 없음)
+ *               ',' 와 '\n' 을 TrepParser::find_either (SSE2) 로 한번에 찾는다
+ * 필드 규칙은 std::getline(',') 과 같다: 빈 필드는 그대로, 행 끝의 빈 필드 하나는 버림. 행 끝 CR 은 제거.
+ * 따옴표 필드는 지원하지 않는다 (마스터 CSV 에는 값 안의 ',' 가 없음).
+ */
+class CsvParser {
+public:
+    static std::vector<std::string> parseLine(const std::string& line) {
+        std::vector<std::string> result;
+        std::stringstream ss(line);
+        std::string field;
+
+        while (std::getline(ss, field, ',')) {
+            result.push_back(field);
+        }
+        return result;
+    }
+
+    // p 에서 시작하는 행의 앞쪽 필드를 최대 max 개 fields 에 채우고 p 를 다음 행 시작으로, 채운 필드 수 반환
+    static size_t next_row(const char*& p, const char* end, TrepSpan* fields, size_t max) {
+        size_t n = 0;
+        const char* q = p;
+        while (q < end) {
+            const char* d = TrepParser::find_either(q, end, ',', '\n');
+            bool row_end = d == end || *d == '\n';
+            size_t len = static_cast<size_t>(d - q);
+            if (row_end && len > 0 && q[len - 1] == '\r') len--;
+            if (!(row_end && len == 0)) {               // 마지막 ',' 뒤의 빈 필드 / 빈 행은 세지 않음
+                fields[n++] = TrepSpan{q, len};
+            }
+            if (row_end) {
+                p = d == end ? end : d + 1;
+                return n;
+            }
+            q = d + 1;
+            if (n == max) {
+                // 필요한 필드까지만 보고 나머지는 행 끝만 찾는다
+                const char* nl = TrepParser::find_char(q, end, '\n');
+                p = nl == end ? end : nl + 1;
+                return n;
+            }
+        }
+        p = end;
+        return n;
+    }
+
+    // p 다음 행의 시작 (없으면 end)
+    static const char* skip_row(const char* p, const char* end) {
+        const char* nl = TrepParser::find_char(p, end, '\n');
+        return nl == end ? end : nl + 1;
+    }
+
+    // [p, end) 의 행 수 (마지막 행에 '\n' 이 없어도 한 행)
+    static size_t count_rows(const char* p, const char* end) {
+        size_t rows = 0;
+        while (p < end) {
+            p = skip_row(p, end);
+            rows++;
+        }
+        return rows;
+    }
+};
+
+/**
+ * 읽기 전용 mmap CSV 파일 (getline 복사 없이 행 단위 병렬 처리용)
+ * 빈 파일은 data() == nullptr, size() == 0 으로 열린다.
+ */
+class MappedCsvFile {
+private:
+    const char* _data;
+    size_t _size;
+
+public:
+    MappedCsvFile() : _data(nullptr), _size(0) {}
+    ~MappedCsvFile() { close(); }
+
+    MappedCsvFile(const MappedCsvFile&) = delete;
+    MappedCsvFile& operator=(const MappedCsvFile&) = delete;
+
+    bool open(const std::string& path) {
+        close();
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return false;
+        }
+        _size = static_cast<size_t>(st.st_size);
+        if (_size > 0) {
+            void* p = mmap(nullptr, _size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                _size = 0;
+                return false;
+            }
+            madvise(p, _size, MADV_WILLNEED);
+            _data = static_cast<const char*>(p);
+        }
+        ::close(fd);    // 매핑은 fd 를 닫아도 유지된다
+        return true;
+    }
+
+    void close() {
+        if (_data) munmap(const_cast<char*>(_data), _size);
+        _data = nullptr;
+        _size = 0;
+    }
+
+    const char* data() const { return _data; }
+    size_t size() const { return _size; }
+    const char* end() const { return _data + _size; }
+};
+
+#endif // CSV_PARSER_H
@@ -0,0 +1,202 @@
+#ifndef FID_MAP_TABLE_H
+#define FID_MAP_TABLE_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "TrepParser.h"
+#include "../HashMaster/BinaryRecord.h"
+
+/**
+ * TREP FID -> 레코드 필드 매핑 테이블
+ *
+ * config 의 fid_map 섹션을 시작 시 한번 컴파일해서
+ * fid 로 바로 인덱싱되는 평평한 배열 {fid -> (필드 핸들, 변환기, 옵션)} 을 만든다.
+ * 틱마다 파싱된 필드를 한번 순회하며 apply() 로 레코드에 반영한다.
+ *
+ * 매핑 문법 (fid_map.<layout>.<fid>):
+ *   "<FIELD>[|옵션|옵션...]"
+ *   changed       값이 바뀌었을 때만 반영하고 trigger 표시 (예: TRD_PRC, SVOL)
+ *   updated       반영하면 항상 trigger 표시 (예: CLOSE_PRC)
+ *   stamp=<FIELD> FID 가 라인에 있으면 (blank 포함) <FIELD> 에 시각 기록 대상으로 표시
+ *   double        숫자로 변환해서 setDouble (기본은 text 그대로 setString)
+ */
+
+#define FIDMAP_MAX_FID 65535
+#define FIDMAP_MAX_STAMPS 16
+
+enum FidMapFlag : uint8_t {
+    FIDMAP_TRIGGER_CHANGED = 0x01,
+    FIDMAP_TRIGGER_UPDATED = 0x02
+};
+
+enum class FidConverter : uint8_t {
+    TEXT,
+    DOUBLE
+};
+
+struct FidMapEntry {
+    int fid;
+    std::string name;       // 로그용 필드명
+    FieldHandle field;
+    FieldHandle stamp;      // valid() == false 이면 stamp 없음
+    FidConverter converter;
+    uint8_t flags;
+};
+
+// apply() 결과
+struct FidApplyResult {
+    bool trigger;                                   // changed/updated 필드가 반영됨
+    size_t applied;                                 // 실제로 바뀐 필드 수
+    size_t stamp_count;
+    const FieldHandle* stamps[FIDMAP_MAX_STAMPS];   // 시각을 기록할 필드
+
+    FidApplyResult() : trigger(false), applied(0), stamp_count(0) {}
+};
+
+class FidMapTable {
+private:
+    std::vector<FidMapEntry> _entries;
+    std::vector<int32_t> _index;        // fid -> _entries 위치 (-1 이면 매핑 없음)
+
+    static std::string trim(const std::string& s) {
+        size_t b = s.find_first_not_of(" \t");
+        if (b == std::string::npos) return "";
+        size_t e = s.find_last_not_of(" \t");
+        return s.substr(b, e - b + 1);
+    }
+
+    // 값이 실제로 바뀌었을 때만 기록 (바뀐 필드는 dirty 에 표시)
+    static bool convert(BinaryRecordView& record, const FidMapEntry& e, const TrepSpan& value, DirtyFieldSet* dirty) {
+        switch (e.converter) {
+        case FidConverter::DOUBLE: {
+            char buf[64];
+            size_t n = value.size < sizeof(buf) - 1 ? value.size : sizeof(buf) - 1;
+            memcpy(buf, value.data, n);
+            buf[n] = '\0';
+            return record.updateDouble(e.field, strtod(buf, nullptr), dirty);
+        }
+        case FidConverter::TEXT:
+        default:
+            return record.updateString(e.field, value.data, value.size, dirty);
+        }
+    }
+
+public:
+    FidMapTable() {}
+
+    void clear() {
+        _entries.clear();
+        _index.clear();
+    }
+
+    /**
+     * 매핑 스펙을 layout 기준으로 컴파일
+     * 레이아웃에 없는 필드나 잘못된 스펙은 경고 후 건너뛴다.
+     * @return 컴파일된 매핑 수
+     */
+    size_t compile(const RecordLayout& layout, const std::map<int, std::string>& specs) {
+        clear();
+        int max_fid = -1;
+
+        for (const auto& spec : specs) {
+            int fid = spec.first;
+            if (fid < 0 || fid > FIDMAP_MAX_FID) {
+                std::cerr << "WARNING: fid_map FID 범위 초과: " << fid << std::endl;
+                continue;
+            }
+
+            std::stringstream ss(spec.second);
+            std::string token;
+            std::getline(ss, token, '|');
+
+            FidMapEntry e;
+            e.fid = fid;
+            e.name = trim(token);
+            e.field = layout.handle(e.name);
+            e.converter = FidConverter::TEXT;
+            e.flags = 0;
+            if (!e.field.valid()) {
+                std::cerr << "WARNING: fid_map " << fid << ": " << layout.getRecordType()
+                          << " 레이아웃에 " << e.name << " 필드가 없습니다" << std::endl;
+                continue;
+            }
+
+            while (std::getline(ss, token, '|')) {
+                std::string opt = trim(token);
+                if (opt == "changed") {
+                    e.flags |= FIDMAP_TRIGGER_CHANGED;
+                } else if (opt == "updated") {
+                    e.flags |= FIDMAP_TRIGGER_UPDATED;
+                } else if (opt == "double") {
+                    e.converter = FidConverter::DOUBLE;
+                } else if (opt == "text") {
+                    e.converter = FidConverter::TEXT;
+                } else if (opt.compare(0, 6, "stamp=") == 0) {
+                    std::string stamp_name = trim(opt.substr(6));
+                    e.stamp = layout.handle(stamp_name);
+                    if (!e.stamp.valid()) {
+                        std::cerr << "WARNING: fid_map " << fid << ": " << layout.getRecordType()
+                                  << " 레이아웃에 " << stamp_name << " 필드가 없습니다" << std::endl;
+                    }
+                } else if (!opt.empty()) {
+                    std::cerr << "WARNING: fid_map " << fid << ": 알 수 없는 옵션 " << opt << std::endl;
+                }
+            }
+
+            _entries.push_back(e);
+            if (fid > max_fid) max_fid = fid;
+        }
+
+        _index.assign(max_fid + 1, -1);
+        for (size_t i = 0; i < _entries.size(); ++i) {
+            _index[_entries[i].fid] = static_cast<int32_t>(i);
+        }
+        return _entries.size();
+    }
+
+    size_t size() const { return _entries.size(); }
+    bool empty() const { return _entries.empty(); }
+    const std::vector<FidMapEntry>& entries() const { return _entries; }
+
+    const FidMapEntry* lookup(int fid) const {
+        if (fid < 0 || static_cast<size_t>(fid) >= _index.size()) return nullptr;
+        int32_t pos = _index[fid];
+        return pos < 0 ? nullptr : &_entries[pos];
+    }
+
+    /**
+     * 파싱된 필드를 라인 순서대로 한번 순회하며 record 에 반영
+     * 값이 비었거나 "blank" 인 필드는 반영하지 않는다 (stamp 표시는 함).
+     * record 는 마스터 mmap 레코드를 감싼 view 그대로 (BinaryRecord 는 view() 로)
+     * 값이 같은 필드는 쓰지 않는다 (mmap page 를 더럽히지 않음). dirty 가 있으면 바뀐 필드를 표시.
+     */
+    FidApplyResult apply(const TrepFieldList& fields, BinaryRecordView record, DirtyFieldSet* dirty = nullptr) const {
+        FidApplyResult result;
+
+        for (const TrepField& f : fields) {
+            const FidMapEntry* e = lookup(f.fid);
+            if (!e) continue;
+
+            if (e->stamp.valid() && result.stamp_count < FIDMAP_MAX_STAMPS) {
+                result.stamps[result.stamp_count++] = &e->stamp;
+            }
+
+            const TrepSpan& value = f.value;
+            if (value.is_blank()) continue;
+
+            bool written = convert(record, *e, value, dirty);
+            if (written) result.applied++;
+            if ((e->flags & FIDMAP_TRIGGER_UPDATED) || (written && (e->flags & FIDMAP_TRIGGER_CHANGED))) {
+                result.trigger = true;
+            }
+        }
+        return result;
+    }
+};
+
+#endif // FID_MAP_TABLE_H
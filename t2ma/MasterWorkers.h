@@ -0,0 +1,430 @@
+#ifndef MASTER_WORKERS_H
+#define MASTER_WORKERS_H
+
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+#include <event2/event.h>
+#include "../HashMaster/MasterManager.h"
+#include "../pubsub/MessageBufferPool.h"
+#include "../pubsub/SpscQueue.h"
+
+#define MASTER_WORKER_QUEUE_CAPACITY 16384
+#define MASTER_WORKER_DRAIN_LIMIT 256     // Guard 하나로 처리하는 최대 메시지 수 (retireMaster 가 오래 기다리지 않도록)
+#define MASTER_WORKER_OUTPUT_BATCH 256    // batch output handler 한번에 넘기는 최대 결과 수
+
+class MasterWorkerPool;
+
+// worker 가 owner event loop 로 돌려보내는 결과 (publish 같이 loop 스레드에서만 해야 하는 일)
+struct MasterWorkerOutput {
+    int tag = 0;
+    std::string data;
+};
+
+/**
+ * @brief update handler 에 넘기는 partition 정보
+ *
+ * handler 는 worker 스레드에서 돈다. partition() 별로 scratch 버퍼를 따로 두면 lock 이 필요 없고,
+ * publisher 처럼 loop 스레드 전용인 자원은 emit() 으로 넘긴다.
+ */
+class MasterWorkerContext {
+private:
+    friend class MasterWorkerPool;
+    MasterWorkerPool* _pool;
+    void* _worker;
+    const std::string* _master_name;
+    int _partition;
+
+public:
+    MasterWorkerContext() : _pool(nullptr), _worker(nullptr), _master_name(nullptr), _partition(0) {}
+
+    int partition() const { return _partition; }
+    const std::string& master_name() const { return *_master_name; }
+
+    // owner loop 에서 output handler(tag, data, size) 로 전달 (순서는 partition 안에서 유지)
+    inline void emit(int tag, const char* data, size_t size);
+};
+
+/**
+ * @brief 마스터별 update worker 스레드 (RIC hash partition)
+ *
+ * T2MA event loop 는 메시지를 받아 key (RIC) 만 꺼내고 submit() 으로 넘긴다. 마스터 갱신은
+ * add_master() 로 등록한 마스터마다 따로 둔 worker 스레드에서 하므로 한 시장의 burst 가
+ * 다른 시장 마스터 갱신을 늦추지 않는다.
+ *
+ *  - 같은 key 는 항상 같은 partition (hash % partitions) 으로 가므로 종목별 순서가 유지된다
+ *  - 입력은 loop -> worker SPSC 큐 (MessageBufferPool 버퍼에 복사 1번, 메시지마다 malloc/free 없음),
+ *    큐가 차면 loop 가 기다린다 (버리지 않음)
+ *  - worker 는 MasterManager::epoch() reader 로 등록하고 처리 구간을 Guard 로 감싸
+ *    마스터 재로드 (swapMaster / retireMaster) 와 같이 동작한다. 마스터 포인터는 구간마다 getMaster 로 다시 얻는다
+ *  - partitions > 1 이면 같은 마스터에 writer 가 여럿이므로 마스터 설정이 use_lock 이어야 한다 (아니면 1 로 줄인다)
+ *  - emit() 결과는 worker -> loop SPSC 큐와 eventfd 로 owner event_base 에서 output handler 로 전달
+ *
+ * start / stop / drain_outputs 는 owner loop 스레드에서 호출한다. submit 은 기본으로 owner loop 스레드에서만,
+ * set_multi_producer(true) 이면 다른 스레드 (pipeline reader 등) 에서도 호출할 수 있다 (worker 별 mutex).
+ */
+class MasterWorkerPool {
+public:
+    typedef std::function<void(MasterWorkerContext& ctx, Master* master, const char* data, size_t size)> UpdateHandler;
+    typedef std::function<void(int tag, const char* data, size_t size)> OutputHandler;
+    // drain 한번에 모인 결과를 묶어서 (publish_batch 용), 설정되면 OutputHandler 대신 호출
+    typedef std::function<void(const MasterWorkerOutput* outputs, size_t count)> BatchOutputHandler;
+
+private:
+    friend class MasterWorkerContext;
+
+    struct Group;
+
+    struct Worker : SpscAlignedNew {
+        Group* group;
+        int partition;
+        int cpu;
+        SpscQueue<SimplePubSub::MessageBufferRef> in;
+        SpscQueue<MasterWorkerOutput> out;
+        int wake_fd;
+        std::atomic<bool> notified;     // wake_fd 에 쓴 뒤 worker 가 아직 깨어나지 않음
+        std::mutex submit_mu;           // multi producer 일 때 in 큐 push
+        std::thread th;
+        MasterWorkerContext ctx;
+
+        std::atomic<uint64_t> processed;
+        std::atomic<uint64_t> full_waits;   // 입력 큐가 차서 loop 가 기다린 횟수
+
+        Worker() : group(nullptr), partition(0), cpu(-1),
+                   in(MASTER_WORKER_QUEUE_CAPACITY), out(MASTER_WORKER_QUEUE_CAPACITY),
+                   wake_fd(-1), notified(false), processed(0), full_waits(0) {}
+    };
+
+    struct Group {
+        std::string name;
+        UpdateHandler handler;
+        std::vector<std::unique_ptr<Worker>> workers;
+    };
+
+    MasterManager& _manager;
+    struct event_base* _owner_base;
+    OutputHandler _output;
+    BatchOutputHandler _batch_output;
+    std::vector<MasterWorkerOutput> _output_batch;
+    std::vector<std::unique_ptr<Group>> _groups;
+    std::atomic<bool> _running;
+    bool _multi_producer;
+    std::thread::id _owner_thread;
+
+    int _output_fd;
+    std::atomic<bool> _output_notified;
+    struct event* _output_event;
+
+    // FNV-1a (partition 선택용, 마스터 index hash 와 독립)
+    static inline uint32_t key_hash(const char* key, size_t len) {
+        uint32_t h = 2166136261u;
+        for (size_t i = 0; i < len; i++) {
+            h ^= (unsigned char)key[i];
+            h *= 16777619u;
+        }
+        return h;
+    }
+
+    static void wake(int fd, std::atomic<bool>& notified) {
+        if (!notified.exchange(true)) {
+            uint64_t one = 1;
+            ssize_t n = write(fd, &one, sizeof(one));
+            (void)n;
+        }
+    }
+
+    void worker_loop(Worker* w) {
+        MasterEpoch::Reader reader(_manager.epoch());
+        if (!reader.registered()) {
+            std::cerr << "master worker " << w->group->name << "/" << w->partition
+                      << ": no free epoch slot, reload is not safe while this worker runs" << std::endl;
+        }
+        SimplePubSub::MessageBufferRef item;
+        while (true) {
+            uint64_t v;
+            if (read(w->wake_fd, &v, sizeof(v)) < 0 && errno == EINTR) continue;
+            w->notified.store(false);
+            if (!_running.load(std::memory_order_acquire)) break;
+
+            size_t processed;
+            do {
+                MasterEpoch::Guard guard(reader);
+                Master* master = _manager.getMaster(w->group->name);
+                processed = 0;
+                while (processed < MASTER_WORKER_DRAIN_LIMIT && w->in.try_pop(item)) {
+                    if (master) w->group->handler(w->ctx, master, item.data(), item.size());
+                    item.reset();
+                    ++processed;
+                }
+                w->processed.fetch_add(processed, std::memory_order_relaxed);
+            } while (processed == MASTER_WORKER_DRAIN_LIMIT);
+        }
+    }
+
+    void push_output(Worker* w, int tag, const char* data, size_t size) {
+        MasterWorkerOutput out;
+        out.tag = tag;
+        out.data.assign(data, size);
+        // loop 가 비울 때까지 기다린다 (loop 는 submit 에서 기다리는 동안에도 출력을 비운다, stop 중이면 버림)
+        while (!w->out.try_push(std::move(out))) {
+            if (!_running.load(std::memory_order_acquire)) return;
+            wake(_output_fd, _output_notified);
+            std::this_thread::yield();
+        }
+        wake(_output_fd, _output_notified);
+    }
+
+    static void on_output(evutil_socket_t fd, short /*events*/, void* arg) {
+        auto* pool = static_cast<MasterWorkerPool*>(arg);
+        uint64_t v;
+        ssize_t n = read(fd, &v, sizeof(v));
+        (void)n;
+        pool->_output_notified.store(false);
+        pool->drain_outputs();
+    }
+
+public:
+    MasterWorkerPool(MasterManager& manager, struct event_base* owner_base, OutputHandler output)
+        : _manager(manager), _owner_base(owner_base), _output(output), _running(false),
+          _multi_producer(false), _output_fd(-1), _output_notified(false), _output_event(nullptr) {}
+
+    ~MasterWorkerPool() {
+        stop();
+    }
+
+    MasterWorkerPool(const MasterWorkerPool&) = delete;
+    MasterWorkerPool& operator=(const MasterWorkerPool&) = delete;
+
+    /**
+     * @brief 마스터 하나에 worker partitions 개를 등록 (start 전)
+     * @param cpus worker i 를 cpus[i % size] 에 고정 (비어있으면 고정 안함)
+     * @return submit 에 쓸 group id, 실패 시 -1
+     */
+    int add_master(const std::string& name, int partitions, UpdateHandler handler,
+                   const std::vector<int>& cpus = std::vector<int>()) {
+        if (_running) {
+            std::cerr << "MasterWorkerPool::add_master must be called before start()" << std::endl;
+            return -1;
+        }
+        const MasterInfo* info = _manager.getMasterInfo(name);
+        if (!info) {
+            std::cerr << "master worker: unknown master " << name << std::endl;
+            return -1;
+        }
+        if (partitions < 1) partitions = 1;
+        if (partitions > 1 && !info->config._use_lock) {
+            std::cerr << "master worker: " << name << " has use_lock off, using 1 partition instead of "
+                      << partitions << std::endl;
+            partitions = 1;
+        }
+
+        std::unique_ptr<Group> group(new Group());
+        group->name = name;
+        group->handler = handler;
+        for (int i = 0; i < partitions; i++) {
+            std::unique_ptr<Worker> w(new Worker());
+            w->group = group.get();
+            w->partition = i;
+            w->cpu = cpus.empty() ? -1 : cpus[i % cpus.size()];
+            w->ctx._pool = this;
+            w->ctx._worker = w.get();
+            w->ctx._master_name = &group->name;
+            w->ctx._partition = i;
+            group->workers.push_back(std::move(w));
+        }
+        _groups.push_back(std::move(group));
+        return (int)_groups.size() - 1;
+    }
+
+    void set_batch_output(BatchOutputHandler handler) { _batch_output = handler; }
+    
+    // submit 을 owner loop 외의 스레드에서도 호출 (start 전)
+    void set_multi_producer(bool enable) { _multi_producer = enable; }
+    
+    bool start() {
+        if (_running) return true;
+        _owner_thread = std::this_thread::get_id();
+        _output_batch.reserve(MASTER_WORKER_OUTPUT_BATCH);
+        _output_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (_output_fd < 0) {
+            std::cerr << "master worker: eventfd failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        _output_event = event_new(_owner_base, _output_fd, EV_READ | EV_PERSIST, &MasterWorkerPool::on_output, this);
+        if (!_output_event || event_add(_output_event, nullptr) != 0) {
+            std::cerr << "master worker: failed to add output event" << std::endl;
+            return false;
+        }
+
+        _running.store(true, std::memory_order_release);
+        for (auto& group : _groups) {
+            for (auto& w : group->workers) {
+                // worker 는 blocking read 로 잠든다
+                w->wake_fd = eventfd(0, EFD_CLOEXEC);
+                if (w->wake_fd < 0) {
+                    std::cerr << "master worker: eventfd failed: " << strerror(errno) << std::endl;
+                    stop();
+                    return false;
+                }
+                Worker* raw = w.get();
+                w->th = std::thread([this, raw]() { worker_loop(raw); });
+                if (w->cpu >= 0) {
+                    cpu_set_t cpuset;
+                    CPU_ZERO(&cpuset);
+                    CPU_SET(w->cpu, &cpuset);
+                    int rc = pthread_setaffinity_np(w->th.native_handle(), sizeof(cpuset), &cpuset);
+                    if (rc != 0) {
+                        std::cerr << "Failed to pin master worker " << group->name << "/" << w->partition
+                                  << " to cpu " << w->cpu << ": " << strerror(rc) << std::endl;
+                    }
+                }
+            }
+            std::cout << "Started " << group->workers.size() << " update workers for master " << group->name << std::endl;
+        }
+        return true;
+    }
+
+    // worker join 후 남은 출력을 loop 에서 처리. 처리하지 못한 입력은 버린다
+    void stop() {
+        bool was_running = _running.exchange(false);
+        for (auto& group : _groups) {
+            for (auto& w : group->workers) {
+                if (w->wake_fd >= 0) {
+                    uint64_t one = 1;
+                    ssize_t n = write(w->wake_fd, &one, sizeof(one));
+                    (void)n;
+                }
+            }
+        }
+        for (auto& group : _groups) {
+            for (auto& w : group->workers) {
+                if (w->th.joinable()) w->th.join();
+                if (w->wake_fd >= 0) {
+                    close(w->wake_fd);
+                    w->wake_fd = -1;
+                }
+                size_t dropped = w->in.size_approx();
+                if (dropped > 0) {
+                    std::cerr << "master worker " << group->name << "/" << w->partition
+                              << ": dropped " << dropped << " pending messages" << std::endl;
+                }
+                SimplePubSub::MessageBufferRef item;
+                while (w->in.try_pop(item)) {}
+            }
+        }
+        if (was_running) drain_outputs();
+        if (_output_event) {
+            event_free(_output_event);
+            _output_event = nullptr;
+        }
+        if (_output_fd >= 0) {
+            close(_output_fd);
+            _output_fd = -1;
+        }
+    }
+
+    int partition_of(int group, const char* key, size_t key_len) const {
+        return (int)(key_hash(key, key_len) % _groups[group]->workers.size());
+    }
+
+    /**
+     * @brief key 의 partition worker 로 메시지 (data 복사) 를 넘긴다 (owner loop 스레드)
+     * @return group 이 없거나 실행 중이 아니면 false
+     */
+    bool submit(int group, const char* key, size_t key_len, const char* data, size_t size) {
+        if (group < 0 || group >= (int)_groups.size() || !_running.load(std::memory_order_relaxed)) {
+            return false;
+        }
+        Worker* w = _groups[group]->workers[partition_of(group, key, key_len)].get();
+        // 풀 버퍼는 worker 가 처리 후 자기 스레드 cache 로 반납하고 묶음으로 돌아오므로 메시지마다 할당이 없다
+        SimplePubSub::MessageBufferRef item = SimplePubSub::MessageBufferRef::acquire(size);
+        if (!item) {
+            return false;
+        }
+        memcpy(item.data(), data, size);
+        // owner loop 에서 기다리는 동안에는 worker 가 emit 에서 막히지 않도록 출력도 비운다
+        bool owner = std::this_thread::get_id() == _owner_thread;
+        std::unique_lock<std::mutex> lock(w->submit_mu, std::defer_lock);
+        if (_multi_producer) {
+            if (owner) {
+                // 다른 producer 가 lock 을 잡고 in 이 빌 때까지 기다리는 중이면, 그 worker 는 out 이 차서
+                // 막혀 있을 수 있다 (out 은 owner 만 비움). owner 는 lock 을 기다리며 막히지 않고 출력을 비운다
+                while (!lock.try_lock()) {
+                    drain_outputs();
+                    std::this_thread::yield();
+                }
+            } else {
+                lock.lock();
+            }
+        }
+        if (!w->in.try_push(std::move(item))) {
+            w->full_waits.fetch_add(1, std::memory_order_relaxed);
+            do {
+                wake(w->wake_fd, w->notified);
+                if (owner) drain_outputs();
+                std::this_thread::yield();
+            } while (!w->in.try_push(std::move(item)));
+        }
+        wake(w->wake_fd, w->notified);
+        return true;
+    }
+
+    // emit() 된 결과를 output handler 로 (owner loop 스레드)
+    size_t drain_outputs() {
+        size_t drained = 0;
+        MasterWorkerOutput out;
+        for (auto& group : _groups) {
+            for (auto& w : group->workers) {
+                while (w->out.try_pop(out)) {
+                    ++drained;
+                    if (!_batch_output) {
+                        if (_output) _output(out.tag, out.data.data(), out.data.size());
+                        continue;
+                    }
+                    _output_batch.push_back(std::move(out));
+                    out = MasterWorkerOutput();
+                    if (_output_batch.size() >= MASTER_WORKER_OUTPUT_BATCH) {
+                        _batch_output(_output_batch.data(), _output_batch.size());
+                        _output_batch.clear();
+                    }
+                }
+            }
+        }
+        if (!_output_batch.empty()) {
+            _batch_output(_output_batch.data(), _output_batch.size());
+            _output_batch.clear();
+        }
+        return drained;
+    }
+
+    size_t group_count() const { return _groups.size(); }
+    int partition_count(int group) const { return (int)_groups[group]->workers.size(); }
+
+    void display_statistics() const {
+        for (const auto& group : _groups) {
+            std::cout << "master workers " << group->name << ":";
+            for (const auto& w : group->workers) {
+                std::cout << " [" << w->partition << "] processed=" << w->processed.load()
+                          << " queued=" << w->in.size_approx() << " full_waits=" << w->full_waits.load();
+            }
+            std::cout << std::endl;
+        }
+    }
+};
+
+inline void MasterWorkerContext::emit(int tag, const char* data, size_t size) {
+    _pool->push_output(static_cast<MasterWorkerPool::Worker*>(_worker), tag, data, size);
+}
+
+#endif // MASTER_WORKERS_H
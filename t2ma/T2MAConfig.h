@@ -9,6 +9,13 @@
 #include <sstream>
 #include "../HashMaster/HashTable.h"  // For LogLevel enum
 #include "../pubsub/SequenceStorage.h"
+#include "../common/MessageDB.h"
+#include "../common/mmap_sam.h"
+#include "../common/segment_sam.h"
+#include "../common/WriteBehindMessageDB.h"
+#include "../common/BlockCompression.h"
+#include "../pubsub/SocketProfile.h"
+#include "../common/NumaPlacement.h"
 
 using namespace SimplePubSub;
 
@@ -22,6 +29,20 @@ struct SubscriberConfig {
     std::string host;  // for tcp
     int port;          // for tcp
     std::string socket_path;  // for unix
+    std::string failover_host;        // 재연결 시 번갈아 시도할 standby publisher (tcp, 비어있으면 사용 안함)
+    int failover_port = 0;
+    std::string failover_socket_path; // unix
+    std::string shm_log;      // 같은 호스트 publisher 의 shm 로그 이름 (설정 시 데이터는 shm, socket 은 제어용)
+    std::string multicast_group;      // 원격 publisher 의 multicast "group:port" (설정 시 데이터는 UDP, tcp 는 제어/복구용)
+    std::string multicast_interface;  // multicast 수신 인터페이스 IP
+    uint32_t conflate_topics = 0;     // key 별 최신값만 받을 토픽 마스크 (예: 2 = 호가)
+    uint32_t conflate_interval_ms = 0;  // 0: socket 이 비면 전송, >0: 주기 전송
+    uint32_t seq_persist_every = 1024;      // 일련번호 저장: 이 수만큼 받을 때마다 (1: 매 메시지)
+    uint32_t seq_persist_interval_ms = 100; // 또는 마지막 저장 후 이 시간이 지나면
+    BlockCodec recovery_compression = BLOCK_CODEC_NONE;  // 전체 복구 스트림 압축 요청 (none / lz / deflate)
+    uint32_t parallel_recovery_streams = 0;         // 재접속 복구를 나눠 받을 연결 수 (0, 1: 사용 안함)
+    uint32_t parallel_recovery_chunk = 65536;       // 연결당 요청 하나의 구간 (메시지 수)
+    uint32_t parallel_recovery_min = 262144;        // 밀린 양이 이 이상일 때만 나눠 받음
     bool enabled;
     uint32_t topic_mask;
 };
@@ -51,11 +72,58 @@ struct T2MAConfig {
     struct {
         struct {
             std::string database_name = "t2ma_pubsub_db";
+            MessageDBType database_type = MessageDBType::FILE;   // memory / file / mmap / segmented
+            MMapSyncPolicy database_sync;                        // mmap 전용 sync 정책
+            BlockCodec database_compression = BLOCK_CODEC_NONE;  // file 전용: 새 데이터 파일 block 압축 (none / lz / deflate)
+            int database_block_size = DB_SAM_BLOCK_SIZE;
+            SegmentPolicy database_segments;                     // segmented 전용: segment 크기 / 날짜별 roll / 보존
+            int database_memory_mb = 0;                          // memory 전용: ring 모드 상한 (MB, 0: 무제한)
+            bool database_write_behind = false;                  // 파일 DB 기록을 writer 스레드로 (publish 경로에서 파일 I/O 제거)
+            DurableLagPolicy database_lag;                       // write-behind 의 durable watermark 지연 한도
             std::string unix_socket_path = "/tmp/t2ma.sock";
             std::string tcp_host = "127.0.0.1";
             int tcp_port = 9999;
+            std::string shm_log;                                 // 공유메모리 로그 이름 (비어있으면 사용 안함)
+            size_t shm_log_capacity = 16 * 1024 * 1024;
+            std::string multicast_group;                         // 원격 구독자용 multicast "group:port" (비어있으면 사용 안함)
+            std::string multicast_interface;
+            int multicast_ttl = 1;
+            int multicast_max_datagram = 1400;                   // MTU 이하
+            SlowConsumerPolicy slow_consumer_policy = SLOW_CONSUMER_RESYNC;
+            size_t send_queue_high_watermark = 0;                // 구독자별 송신 큐 상한 bytes (0: 제한 없음)
+            int write_coalesce_us = 0;                           // 고빈도 구간의 작은 write 를 모으는 최대 지연 us (0: 사용 안함)
+            int write_coalesce_bytes = 16384;                    // 모은 output 이 이 이상이면 지연과 관계없이 송신
+            bool micro_batching = false;                         // publish 를 모아 loop 한 턴에 publish_batch 한번으로 (MQ drain 묶음)
+            int io_reactors = 0;                                 // socket 구독자 fan-out 스레드 수 (0: main 스레드에서 처리)
+            std::vector<int> io_reactor_cpus;                    // reactor i 는 io_reactor_cpus[i % size] 에 고정
+            std::vector<int> recovery_cpus;                      // recovery worker i 는 recovery_cpus[i % size] 에 고정
+            int sequence_flush_ms = 0;                           // >0: sequence record write-behind 저장 주기 (0: batch 마다 저장)
+            int recovery_bandwidth_mb = 0;                       // 복구 전송 대역폭 (모든 복구 합, MB/s, 0: 제한 없음)
+            int recovery_priority_messages = 65536;              // 남은 메시지가 이 이하인 복구는 대역폭 제한 없이 우선 전송
+            int hot_tail_messages = 0;                           // 최근 메시지 캐시 (짧은 복구를 DB 없이 바로 처리, 0: 사용 안함)
+            int hot_tail_mb = 0;                                 // 캐시 bytes 상한 MB (0: 메시지 수로만 제한)
+            bool wire_encoding = false;                          // sise/hoga 레이아웃을 compact wire 형식으로 제공 (구독자가 선택)
         } publisher;
         
+        // publisher accept / subscriber connect socket 옵션 (preset: none / latency / throughput + 개별 항목 덮어쓰기)
+        SocketProfile socket_profile;
+        // 구독자 fan-in: 모든 구독자를 SubscriberGroup 하나로 (일련번호 HashMaster 하나 + parser 공유)
+        struct {
+            bool enabled = false;
+            int merge_window_ms = 0;        // >0: publisher 들의 메시지를 timestamp 순으로 합쳐 전달 (최대 지연 window)
+            std::string sequence_path;      // 비어있으면 ./sequence_data/sub<name>_group_sequences
+        } subscriber_group;
+        // hot standby: standby 는 primary 스트림을 같은 seq 로 DB / 시퀀스에 기록하고, failover 시 listener 를 연다
+        struct {
+            std::string role = "primary";           // primary / standby
+            std::string primary_type = "tcp";       // primary publisher 연결 (tcp / unix)
+            std::string primary_host = "127.0.0.1";
+            int primary_port = 9999;
+            std::string primary_socket_path;
+            int ack_every = 4096;                   // 이만큼 기록하면 ack (0: timer 만)
+            int ack_interval_ms = 100;
+            int failover_timeout_ms = 0;            // primary 연결이 이 시간 이상 없으면 승격 (0: 수동, SIGUSR2)
+        } replication;
         std::vector<SubscriberConfig> subscribers;
     } pubsub;
     
@@ -66,18 +134,42 @@ struct T2MAConfig {
         int max_messages = 10;
         int message_size = 512;
         std::string mode = "read";
+        int batch_size = 1;        // wakeup 한번에 읽을 최대 메시지 수
+        std::string transport = "posix";    // posix (POSIX MQ) / shm (공유메모리 SPSC ring)
+        int shm_capacity = 4 * 1024 * 1024; // shm ring data 영역 크기
+        int spin_us = 0;                    // shm: futex 대기 전 spin 시간
     } messagequeue;
     
     // Monitoring settings
     struct {
         int stats_interval = 30;
         int log_interval = 100;
+        std::string log_level = "info";     // AsyncLogger runtime level: debug / info / warn / error / off
+        bool latency_tracking = false;      // 단계별 / 구독자 one-way 지연 히스토그램 (메시지당 시각 읽기 추가)
+        // 마스터 용량 advisor (scheduler handler control_capacity_advisor)
+        std::string capacity_output_dir;    // 권장 설정을 <dir>/<MASTER>.yaml.recommended 로 (비어있으면 로그 / stats 만)
+        int capacity_full_pct = 90;         // 레코드 / index 사용률이 이 % 이상이면 near full
+        int capacity_max_chain = 8;         // v1 index 최대 chain 길이 (v2 는 probe group 3)
+        bool capacity_auto_resize = false;  // near full 인 HashMaster 를 online resize 로 미리 늘림
     } monitoring;
     
     // System behavior
     struct {
-        std::string event_loop_mode = "EVLOOP_ONCE";
+        std::string event_loop_mode = "EVLOOP_ONCE";    // EVLOOP_ONCE: epoll 대기 / SPIN: non-blocking busy loop
+        int spin_idle_us = 100000;          // SPIN: 이 시간 동안 처리한 것이 없으면 epoll 대기로 전환 (0: 항상 spin)
+        int spin_cpu = -1;                  // SPIN: event loop 스레드를 고정할 CPU (-1: 고정 안함)
+        bool spin_poll_source = true;       // SPIN: MQ/shm ring 을 loop 에서 직접 poll (wakeup 없이 수신)
+        int timer_tick_ms = 10;             // 스케줄러/종목별 타이머 wheel 의 tick 해상도
+        int socket_busy_poll_us = 0;        // TCP publisher/subscriber socket 의 SO_BUSY_POLL (0: 설정 안함)
+        int master_workers = 0;             // 마스터 갱신 worker 스레드 수 (RIC hash partition, 0: event loop 에서 처리)
+        std::vector<int> master_worker_cpus;            // worker i 는 master_worker_cpus[i % size] 에 고정
+        bool pipeline = false;              // reader 스레드 -> RIC worker -> event loop (sequencer) publish (master_workers > 0 필요)
+        int pipeline_reader_cpu = -1;       // pipeline: MQ/shm reader 스레드 고정 CPU
+        int numa_node = -1;                 // 스레드 / 마스터 / ring / DB 를 둘 NUMA node (-1: 지정 안함)
+        std::string event_loop_cpus;        // main 스레드 (와 고정하지 않은 스레드) CPU 목록 "0-3" (비어있으면 numa_node 의 CPU)
+        std::vector<std::string> preload_masters;       // 시작 시 활성 마스터와 같이 병렬로 여는 마스터
         bool auto_load_csv = true;
+        bool warm_restart = false;          // 정상 종료 후 재시작이고 CSV 가 그대로면 auto_load_csv 를 생략 (mmap 마스터 유지)
         bool enable_periodic_stats = true;
         std::string symbol = "";
     } system;
@@ -92,6 +184,14 @@ struct T2MAConfig {
     // Master name configuration
     std::string master = "JAPAN_EQUITY_MASTER";  // Default master to use
 
+    // TREP FID -> 레이아웃 필드 매핑 (fid_map.<layout>.<fid>: "<FIELD>|옵션", FidMapTable 로 컴파일)
+    struct {
+        int gmt_offset = 32400;                                     // 시각 필드 변환용 (초)
+        std::string timezone = "";                                  // IANA 이름 (DST 포함), 있으면 gmt_offset 대신 사용
+        std::string master_delta_topic = "";                        // 마스터 바뀐 필드 delta (RecordDelta) 송신 토픽, 비면 끔
+        std::map<std::string, std::map<int, std::string>> layouts;  // layout 키(master/sise/hoga) -> fid -> spec
+    } fid_map;
+
     // 상속 클래스별 동적 확장 설정
     std::map<std::string, std::string> extensions;  // 클래스별 확장 설정
     
@@ -295,6 +395,22 @@ public:
         return default_value;
     }
     
+    // "2,3" / "4-7,12" 형식 CPU 목록 (형식이 틀리면 비움)
+    std::vector<int> getCpuList(const std::string& key) {
+        std::vector<int> cpus;
+        std::string list = getString(key, "");
+        if (list.empty()) return cpus;
+        cpu_set_t set;
+        if (!NumaPlacement::parse_cpu_list(list, set)) {
+            std::cerr << "Invalid cpu list for " << key << ": " << list << std::endl;
+            return cpus;
+        }
+        for (int c = 0; c < CPU_SETSIZE; c++) {
+            if (CPU_ISSET(c, &set)) cpus.push_back(c);
+        }
+        return cpus;
+    }
+    
     bool getBool(const std::string& key, bool default_value = false) {
         auto it = config_values.find(key);
         if (it != config_values.end()) {
@@ -323,9 +439,127 @@ public:
         
         // Pub-Sub publisher settings
         config.pubsub.publisher.database_name = getString("pubsub.publisher.database_name", config.pubsub.publisher.database_name);
+        // database_type 미지정 시 기존 동작 유지 (database_name이 비어있으면 memory)
+        std::string db_type = getString("pubsub.publisher.database_type",
+                                        config.pubsub.publisher.database_name.empty() ? "memory" : "file");
+        if (db_type == "memory") {
+            config.pubsub.publisher.database_type = MessageDBType::MEMORY;
+        } else if (db_type == "mmap") {
+            config.pubsub.publisher.database_type = MessageDBType::MMAP;
+        } else if (db_type == "segmented") {
+            config.pubsub.publisher.database_type = MessageDBType::SEGMENTED;
+        } else {
+            config.pubsub.publisher.database_type = MessageDBType::FILE;
+        }
+        std::string db_sync = getString("pubsub.publisher.database_sync", "count");
+        if (db_sync == "none") {
+            config.pubsub.publisher.database_sync.mode = MMapSyncMode::NONE;
+        } else if (db_sync == "message") {
+            config.pubsub.publisher.database_sync.mode = MMapSyncMode::EVERY_MESSAGE;
+        } else if (db_sync == "interval") {
+            config.pubsub.publisher.database_sync.mode = MMapSyncMode::INTERVAL;
+        } else {
+            config.pubsub.publisher.database_sync.mode = MMapSyncMode::EVERY_N;
+        }
+        config.pubsub.publisher.database_sync.every_n = getInt("pubsub.publisher.database_sync_count",
+                                                               config.pubsub.publisher.database_sync.every_n);
+        config.pubsub.publisher.database_sync.interval_ms = getInt("pubsub.publisher.database_sync_interval_ms",
+                                                                   config.pubsub.publisher.database_sync.interval_ms);
+        std::string db_compression = getString("pubsub.publisher.database_compression", "none");
+        if (!block_codec_from_name(db_compression, config.pubsub.publisher.database_compression)) {
+            std::cerr << "Unknown pubsub.publisher.database_compression: " << db_compression << ", using none" << std::endl;
+        }
+        config.pubsub.publisher.database_block_size = getInt("pubsub.publisher.database_block_size",
+                                                             config.pubsub.publisher.database_block_size);
+        SegmentPolicy& segments = config.pubsub.publisher.database_segments;
+        segments.segment_bytes = static_cast<size_t>(getInt("pubsub.publisher.database_segment_mb",
+                                                            static_cast<int>(segments.segment_bytes >> 20))) << 20;
+        segments.retain_days = getInt("pubsub.publisher.database_retain_days", segments.retain_days);
+        segments.max_segments = getInt("pubsub.publisher.database_max_segments", segments.max_segments);
+        segments.roll_daily = getBool("pubsub.publisher.database_roll_daily", segments.roll_daily);
+        config.pubsub.publisher.database_memory_mb = getInt("pubsub.publisher.database_memory_mb",
+                                                            config.pubsub.publisher.database_memory_mb);
+        config.pubsub.publisher.database_write_behind = getBool("pubsub.publisher.database_write_behind",
+                                                                config.pubsub.publisher.database_write_behind);
+        DurableLagPolicy& lag = config.pubsub.publisher.database_lag;
+        lag.max_lag_messages = getInt("pubsub.publisher.database_max_lag_messages", lag.max_lag_messages);
+        lag.max_lag_bytes = static_cast<size_t>(getInt("pubsub.publisher.database_max_lag_mb",
+                                                       static_cast<int>(lag.max_lag_bytes >> 20))) << 20;
+        lag.mode = getString("pubsub.publisher.database_lag_policy", "block") == "warn" ? DurableLagMode::WARN
+                                                                                        : DurableLagMode::BLOCK;
         config.pubsub.publisher.unix_socket_path = getString("pubsub.publisher.unix_socket_path", config.pubsub.publisher.unix_socket_path);
         config.pubsub.publisher.tcp_host = getString("pubsub.publisher.tcp_host", config.pubsub.publisher.tcp_host);
         config.pubsub.publisher.tcp_port = getInt("pubsub.publisher.tcp_port", config.pubsub.publisher.tcp_port);
+        config.pubsub.publisher.shm_log = getString("pubsub.publisher.shm_log", config.pubsub.publisher.shm_log);
+        config.pubsub.publisher.shm_log_capacity = getInt("pubsub.publisher.shm_log_capacity",
+                                                          static_cast<int>(config.pubsub.publisher.shm_log_capacity));
+        config.pubsub.publisher.multicast_group = getString("pubsub.publisher.multicast_group", config.pubsub.publisher.multicast_group);
+        config.pubsub.publisher.multicast_interface = getString("pubsub.publisher.multicast_interface",
+                                                                config.pubsub.publisher.multicast_interface);
+        config.pubsub.publisher.multicast_ttl = getInt("pubsub.publisher.multicast_ttl", config.pubsub.publisher.multicast_ttl);
+        config.pubsub.publisher.multicast_max_datagram = getInt("pubsub.publisher.multicast_max_datagram",
+                                                                config.pubsub.publisher.multicast_max_datagram);
+        std::string slow_consumer_policy = getString("pubsub.publisher.slow_consumer_policy", "resync");
+        if (slow_consumer_policy == "conflate") {
+            config.pubsub.publisher.slow_consumer_policy = SLOW_CONSUMER_CONFLATE;
+        } else if (slow_consumer_policy == "disconnect") {
+            config.pubsub.publisher.slow_consumer_policy = SLOW_CONSUMER_DISCONNECT;
+        } else {
+            config.pubsub.publisher.slow_consumer_policy = SLOW_CONSUMER_RESYNC;
+        }
+        config.pubsub.publisher.send_queue_high_watermark = getInt("pubsub.publisher.send_queue_high_watermark",
+                                                                   static_cast<int>(config.pubsub.publisher.send_queue_high_watermark));
+        config.pubsub.publisher.write_coalesce_us = getInt("pubsub.publisher.write_coalesce_us", config.pubsub.publisher.write_coalesce_us);
+        config.pubsub.publisher.write_coalesce_bytes = getInt("pubsub.publisher.write_coalesce_bytes",
+                                                              config.pubsub.publisher.write_coalesce_bytes);
+        config.pubsub.publisher.micro_batching = getBool("pubsub.publisher.micro_batching", config.pubsub.publisher.micro_batching);
+        config.pubsub.publisher.io_reactors = getInt("pubsub.publisher.io_reactors", config.pubsub.publisher.io_reactors);
+        config.pubsub.publisher.sequence_flush_ms = getInt("pubsub.publisher.sequence_flush_ms", config.pubsub.publisher.sequence_flush_ms);
+        config.pubsub.publisher.recovery_bandwidth_mb = getInt("pubsub.publisher.recovery_bandwidth_mb",
+                                                               config.pubsub.publisher.recovery_bandwidth_mb);
+        config.pubsub.publisher.recovery_priority_messages = getInt("pubsub.publisher.recovery_priority_messages",
+                                                                    config.pubsub.publisher.recovery_priority_messages);
+        config.pubsub.publisher.hot_tail_messages = getInt("pubsub.publisher.hot_tail_messages",
+                                                           config.pubsub.publisher.hot_tail_messages);
+        config.pubsub.publisher.hot_tail_mb = getInt("pubsub.publisher.hot_tail_mb", config.pubsub.publisher.hot_tail_mb);
+        config.pubsub.publisher.wire_encoding = getBool("pubsub.publisher.wire_encoding", config.pubsub.publisher.wire_encoding);
+        config.pubsub.publisher.io_reactor_cpus = getCpuList("pubsub.publisher.io_reactor_cpus");
+        config.pubsub.publisher.recovery_cpus = getCpuList("pubsub.publisher.recovery_cpus");
+        {
+            SocketProfile& profile = config.pubsub.socket_profile;
+            std::string preset = getString("pubsub.socket_profile.preset", "none");
+            if (!socket_profile_from_name(preset, profile)) {
+                std::cerr << "Unknown pubsub.socket_profile.preset: " << preset << ", using none" << std::endl;
+            }
+            profile.tcp_nodelay = getBool("pubsub.socket_profile.tcp_nodelay", profile.tcp_nodelay);
+            profile.tcp_quickack = getBool("pubsub.socket_profile.tcp_quickack", profile.tcp_quickack);
+            profile.send_buffer = getInt("pubsub.socket_profile.send_buffer", profile.send_buffer);
+            profile.recv_buffer = getInt("pubsub.socket_profile.recv_buffer", profile.recv_buffer);
+            profile.busy_poll_us = getInt("pubsub.socket_profile.busy_poll_us", profile.busy_poll_us);
+            profile.max_single_read = static_cast<size_t>(getInt("pubsub.socket_profile.max_single_read",
+                                                                 static_cast<int>(profile.max_single_read)));
+            profile.max_single_write = static_cast<size_t>(getInt("pubsub.socket_profile.max_single_write",
+                                                                  static_cast<int>(profile.max_single_write)));
+        }
+        config.pubsub.subscriber_group.enabled = getBool("pubsub.subscriber_group.enabled",
+                                                         config.pubsub.subscriber_group.enabled);
+        config.pubsub.subscriber_group.merge_window_ms = getInt("pubsub.subscriber_group.merge_window_ms",
+                                                                config.pubsub.subscriber_group.merge_window_ms);
+        config.pubsub.subscriber_group.sequence_path = getString("pubsub.subscriber_group.sequence_path",
+                                                                 config.pubsub.subscriber_group.sequence_path);
+        auto& replication = config.pubsub.replication;
+        replication.role = getString("pubsub.replication.role", replication.role);
+        if (replication.role != "primary" && replication.role != "standby") {
+            std::cerr << "Unknown pubsub.replication.role: " << replication.role << ", using primary" << std::endl;
+            replication.role = "primary";
+        }
+        replication.primary_type = getString("pubsub.replication.primary_type", replication.primary_type);
+        replication.primary_host = getString("pubsub.replication.primary_host", replication.primary_host);
+        replication.primary_port = getInt("pubsub.replication.primary_port", replication.primary_port);
+        replication.primary_socket_path = getString("pubsub.replication.primary_socket_path", replication.primary_socket_path);
+        replication.ack_every = getInt("pubsub.replication.ack_every", replication.ack_every);
+        replication.ack_interval_ms = getInt("pubsub.replication.ack_interval_ms", replication.ack_interval_ms);
+        replication.failover_timeout_ms = getInt("pubsub.replication.failover_timeout_ms", replication.failover_timeout_ms);
         
         // Storage type
         std::string storage_type = getString("sequence_storage_type", "file");
@@ -379,6 +613,77 @@ public:
                 subscriber.socket_path = socket_path_it->second;
             }
             
+            auto failover_host_it = sub_config.find("failover_host");
+            if (failover_host_it != sub_config.end()) {
+                subscriber.failover_host = failover_host_it->second;
+            }
+            
+            auto failover_port_it = sub_config.find("failover_port");
+            if (failover_port_it != sub_config.end()) {
+                subscriber.failover_port = std::stoi(failover_port_it->second);
+            }
+            
+            auto failover_socket_path_it = sub_config.find("failover_socket_path");
+            if (failover_socket_path_it != sub_config.end()) {
+                subscriber.failover_socket_path = failover_socket_path_it->second;
+            }
+            
+            auto shm_log_it = sub_config.find("shm_log");
+            if (shm_log_it != sub_config.end()) {
+                subscriber.shm_log = shm_log_it->second;
+            }
+            
+            auto multicast_group_it = sub_config.find("multicast_group");
+            if (multicast_group_it != sub_config.end()) {
+                subscriber.multicast_group = multicast_group_it->second;
+            }
+            
+            auto multicast_interface_it = sub_config.find("multicast_interface");
+            if (multicast_interface_it != sub_config.end()) {
+                subscriber.multicast_interface = multicast_interface_it->second;
+            }
+            
+            auto conflate_topics_it = sub_config.find("conflate_topics");
+            if (conflate_topics_it != sub_config.end()) {
+                subscriber.conflate_topics = std::stoi(conflate_topics_it->second);
+            }
+            
+            auto conflate_interval_it = sub_config.find("conflate_interval_ms");
+            if (conflate_interval_it != sub_config.end()) {
+                subscriber.conflate_interval_ms = std::stoi(conflate_interval_it->second);
+            }
+            
+            auto seq_persist_every_it = sub_config.find("seq_persist_every");
+            if (seq_persist_every_it != sub_config.end()) {
+                subscriber.seq_persist_every = std::stoi(seq_persist_every_it->second);
+            }
+
+            auto seq_persist_interval_it = sub_config.find("seq_persist_interval_ms");
+            if (seq_persist_interval_it != sub_config.end()) {
+                subscriber.seq_persist_interval_ms = std::stoi(seq_persist_interval_it->second);
+            }
+
+            auto recovery_compression_it = sub_config.find("recovery_compression");
+            if (recovery_compression_it != sub_config.end() &&
+                !block_codec_from_name(recovery_compression_it->second, subscriber.recovery_compression)) {
+                std::cerr << "Unknown recovery_compression: " << recovery_compression_it->second << ", using none" << std::endl;
+            }
+
+            auto parallel_streams_it = sub_config.find("parallel_recovery_streams");
+            if (parallel_streams_it != sub_config.end()) {
+                subscriber.parallel_recovery_streams = std::stoi(parallel_streams_it->second);
+            }
+
+            auto parallel_chunk_it = sub_config.find("parallel_recovery_chunk");
+            if (parallel_chunk_it != sub_config.end()) {
+                subscriber.parallel_recovery_chunk = std::stoi(parallel_chunk_it->second);
+            }
+
+            auto parallel_min_it = sub_config.find("parallel_recovery_min");
+            if (parallel_min_it != sub_config.end()) {
+                subscriber.parallel_recovery_min = std::stoi(parallel_min_it->second);
+            }
+            
             auto enabled_it = sub_config.find("enabled");
             if (enabled_it != sub_config.end()) {
                 subscriber.enabled = (enabled_it->second == "true");
@@ -399,14 +704,44 @@ public:
         config.messagequeue.max_messages = getInt("messagequeue.max_messages", config.messagequeue.max_messages);
         config.messagequeue.message_size = getInt("messagequeue.message_size", config.messagequeue.message_size);
         config.messagequeue.mode = getString("messagequeue.mode", config.messagequeue.mode);
+        config.messagequeue.batch_size = getInt("messagequeue.batch_size", config.messagequeue.batch_size);
+        config.messagequeue.transport = getString("messagequeue.transport", config.messagequeue.transport);
+        config.messagequeue.shm_capacity = getInt("messagequeue.shm_capacity", config.messagequeue.shm_capacity);
+        config.messagequeue.spin_us = getInt("messagequeue.spin_us", config.messagequeue.spin_us);
         
         // Monitoring settings
         config.monitoring.stats_interval = getInt("monitoring.stats_interval", config.monitoring.stats_interval);
         config.monitoring.log_interval = getInt("monitoring.log_interval", config.monitoring.log_interval);
+        config.monitoring.log_level = getString("monitoring.log_level", config.monitoring.log_level);
+        config.monitoring.latency_tracking = getBool("monitoring.latency_tracking", config.monitoring.latency_tracking);
+        config.monitoring.capacity_output_dir = getString("monitoring.capacity_output_dir", config.monitoring.capacity_output_dir);
+        config.monitoring.capacity_full_pct = getInt("monitoring.capacity_full_pct", config.monitoring.capacity_full_pct);
+        config.monitoring.capacity_max_chain = getInt("monitoring.capacity_max_chain", config.monitoring.capacity_max_chain);
+        config.monitoring.capacity_auto_resize = getBool("monitoring.capacity_auto_resize", config.monitoring.capacity_auto_resize);
         
         // System settings
         config.system.event_loop_mode = getString("system.event_loop_mode", config.system.event_loop_mode);
+        config.system.spin_idle_us = getInt("system.spin_idle_us", config.system.spin_idle_us);
+        config.system.spin_cpu = getInt("system.spin_cpu", config.system.spin_cpu);
+        config.system.spin_poll_source = getBool("system.spin_poll_source", config.system.spin_poll_source);
+        config.system.timer_tick_ms = getInt("system.timer_tick_ms", config.system.timer_tick_ms);
+        config.system.socket_busy_poll_us = getInt("system.socket_busy_poll_us", config.system.socket_busy_poll_us);
+        config.system.master_workers = getInt("system.master_workers", config.system.master_workers);
+        config.system.pipeline = getBool("system.pipeline", config.system.pipeline);
+        config.system.pipeline_reader_cpu = getInt("system.pipeline_reader_cpu", config.system.pipeline_reader_cpu);
+        config.system.master_worker_cpus = getCpuList("system.master_worker_cpus");
+        config.system.numa_node = getInt("system.numa_node", config.system.numa_node);
+        config.system.event_loop_cpus = getString("system.event_loop_cpus", config.system.event_loop_cpus);
+        {
+            // "NASDAQ_BASIC_EQUITY_MASTER,..." 형식
+            std::stringstream names(getString("system.preload_masters", ""));
+            std::string name;
+            while (std::getline(names, name, ',')) {
+                if (!name.empty()) config.system.preload_masters.push_back(name);
+            }
+        }
         config.system.auto_load_csv = getBool("system.auto_load_csv", config.system.auto_load_csv);
+        config.system.warm_restart = getBool("system.warm_restart", config.system.warm_restart);
         config.system.enable_periodic_stats = getBool("system.enable_periodic_stats", config.system.enable_periodic_stats);
         config.system.symbol = getString("system.symbol", config.system.symbol);
         
@@ -418,6 +753,23 @@ public:
         // Master configuration
         config.master = getString("master", config.master);
         
+        // FID 매핑 (fid_map.gmt_offset, fid_map.<layout>.<fid>)
+        config.fid_map.gmt_offset = getInt("fid_map.gmt_offset", config.fid_map.gmt_offset);
+        config.fid_map.timezone = getString("fid_map.timezone", config.fid_map.timezone);
+        config.fid_map.master_delta_topic = getString("fid_map.master_delta_topic", config.fid_map.master_delta_topic);
+        for (const auto& pair : config_values) {
+            if (pair.first.compare(0, 8, "fid_map.") != 0) continue;
+            std::string remainder = pair.first.substr(8);
+            size_t dot_pos = remainder.find('.');
+            if (dot_pos == std::string::npos) continue;
+            try {
+                int fid = std::stoi(remainder.substr(dot_pos + 1));
+                config.fid_map.layouts[remainder.substr(0, dot_pos)][fid] = pair.second;
+            } catch (...) {
+                std::cerr << "Invalid fid_map key: " << pair.first << std::endl;
+            }
+        }
+        
         // Extensions settings (클래스별 확장 설정)
         for (const auto& pair : config_values) {
             if (pair.first.substr(0, 11) == "extensions.") {
@@ -6,6 +6,9 @@
 #include <cstring>
 #include <regex>
 #include <event2/event.h>
+#include <cerrno>
+#include <sys/eventfd.h>
+#include <unistd.h>
 
 void T2MASystem::setup_message_handlers() {
     // Debug: Print handler configuration
@@ -75,6 +78,8 @@ void T2MASystem::init_scheduler_handlers() {
     scheduler_handlers_["control_reload_master"] = [this]() { this->control_reload_master(); };
     scheduler_handlers_["control_clear_stats"] = [this]() { this->control_clear_stats(); };
     scheduler_handlers_["control_heartbeat"] = [this]() { this->control_heartbeat(); };
+    scheduler_handlers_["control_latency_stats"] = [this]() { this->control_latency_stats(); };
+    scheduler_handlers_["control_capacity_advisor"] = [this]() { this->control_capacity_advisor(); };
 
     std::cout << "✓ Default scheduler handlers registered: " << scheduler_handlers_.size() << " handlers" << std::endl;
 }
@@ -105,21 +110,12 @@ void T2MASystem::setup_schedulers() {
 
         // Create event based on scheduler type
         if (sched_config.type == "interval") {
-            struct timeval interval;
-            interval.tv_sec = sched_config.interval_sec;
-            interval.tv_usec = 0;
-
-            // Create persistent timer event
-            sched_data->event_ptr = event_new(event_base_, -1, EV_PERSIST, scheduler_callback, sched_data);
-            if (sched_data->event_ptr == nullptr) {
-                std::cerr << "❌ Failed to create timer event for scheduler: " << sched_config.name << std::endl;
-                delete sched_data;
-                continue;
-            }
-
-            if (event_add(sched_data->event_ptr, &interval) < 0) {
-                std::cerr << "❌ Failed to add timer event for scheduler: " << sched_config.name << std::endl;
-                event_free(sched_data->event_ptr);
+            // Periodic timer on the shared timer wheel
+            sched_data->timer_id = timer_wheel_->schedule_periodic(
+                std::chrono::seconds(sched_config.interval_sec),
+                [sched_data]() { scheduler_callback(sched_data); });
+            if (sched_data->timer_id == 0) {
+                std::cerr << "❌ Failed to add timer for scheduler: " << sched_config.name << std::endl;
                 delete sched_data;
                 continue;
             }
@@ -137,21 +133,11 @@ void T2MASystem::setup_schedulers() {
                 delay_duration = std::chrono::seconds(1);
             }
 
-            struct timeval delay;
-            delay.tv_sec = delay_duration.count();
-            delay.tv_usec = 0;
-
-            // Create one-time timer event
-            sched_data->event_ptr = event_new(event_base_, -1, 0, scheduler_callback, sched_data);
-            if (sched_data->event_ptr == nullptr) {
-                std::cerr << "❌ Failed to create timer event for scheduler: " << sched_config.name << std::endl;
-                delete sched_data;
-                continue;
-            }
-
-            if (event_add(sched_data->event_ptr, &delay) < 0) {
-                std::cerr << "❌ Failed to add timer event for scheduler: " << sched_config.name << std::endl;
-                event_free(sched_data->event_ptr);
+            // One-time timer on the shared timer wheel
+            sched_data->timer_id = timer_wheel_->schedule(
+                delay_duration, [sched_data]() { scheduler_callback(sched_data); });
+            if (sched_data->timer_id == 0) {
+                std::cerr << "❌ Failed to add timer for scheduler: " << sched_config.name << std::endl;
                 delete sched_data;
                 continue;
             }
@@ -181,9 +167,8 @@ void T2MASystem::cleanup_schedulers() {
     std::cout << "🧹 Cleaning up schedulers..." << std::endl;
 
     for (auto* sched_data : scheduled_data_) {
-        if (sched_data->event_ptr) {
-            event_del(sched_data->event_ptr);
-            event_free(sched_data->event_ptr);
+        if (sched_data->timer_id && timer_wheel_) {
+            timer_wheel_->cancel(sched_data->timer_id);
         }
         delete sched_data;
     }
@@ -270,20 +255,170 @@ void T2MASystem::control_reload_master() {
     reload_master_data();
 }
 
+// ===== 마스터 재로드 (snapshot-and-swap) =====
+
+bool T2MASystem::init_master_reload() {
+    reload_event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (reload_event_fd_ < 0) {
+        std::cerr << "eventfd failed: " << strerror(errno) << std::endl;
+        return false;
+    }
+    reload_event_ = event_new(event_base_, reload_event_fd_, EV_READ | EV_PERSIST, &T2MASystem::on_master_swap, this);
+    if (!reload_event_ || event_add(reload_event_, nullptr) != 0) {
+        std::cerr << "Failed to add master reload event" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void T2MASystem::cleanup_master_reload() {
+    if (reload_thread_.joinable()) {
+        reload_thread_.join();
+    }
+    pending_master_.reset();
+    retired_master_.reset();
+    if (reload_event_) {
+        event_free(reload_event_);
+        reload_event_ = nullptr;
+    }
+    if (reload_event_fd_ >= 0) {
+        close(reload_event_fd_);
+        reload_event_fd_ = -1;
+    }
+}
+
+void T2MASystem::reload_master_data() {
+    if (!master_manager_ || !active_master_) {
+        return;
+    }
+    bool expected = false;
+    if (!reload_running_.compare_exchange_strong(expected, true)) {
+        std::cout << "마스터 재로드가 이미 진행 중입니다" << std::endl;
+        return;
+    }
+    if (reload_thread_.joinable()) {
+        reload_thread_.join();  // 이전 재로드 스레드 (끝난 상태)
+    }
+    std::cout << "마스터 데이터 재로드 시작 (백그라운드)" << std::endl;
+    reload_thread_ = std::thread(&T2MASystem::master_reload_worker, this);
+}
+
+void T2MASystem::master_reload_worker() {
+    auto start = std::chrono::steady_clock::now();
+    std::unique_ptr<Master> next = master_manager_->buildMaster(config_.master);
+    if (!next || !load_symbols_from_csv(next.get())) {
+        std::cerr << "마스터 재로드 실패: 기존 마스터를 계속 사용합니다" << std::endl;
+        reload_running_.store(false);
+        return;
+    }
+
+    std::unique_ptr<Master> old;
+    {
+        std::unique_lock<std::mutex> lock(reload_mutex_);
+        pending_master_ = std::move(next);
+        reload_swapped_ = false;
+        uint64_t one = 1;
+        if (write(reload_event_fd_, &one, sizeof(one)) != (ssize_t)sizeof(one)) {
+            std::cerr << "Failed to signal master swap: " << strerror(errno) << std::endl;
+        }
+        // event loop 가 교체할 때까지 (종료 중이면 포기)
+        while (!reload_swapped_ && running_) {
+            reload_cv_.wait_for(lock, std::chrono::milliseconds(100));
+        }
+        old = std::move(retired_master_);
+        pending_master_.reset();
+    }
+
+    if (old) {
+        master_manager_->retireMaster(std::move(old));
+        long ms = (long)std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+        std::cout << "✓ 마스터 재로드 완료 (" << ms << " ms)" << std::endl;
+    }
+    reload_running_.store(false);
+}
+
+void T2MASystem::on_master_swap(evutil_socket_t fd, short /*events*/, void* arg) {
+    uint64_t value;
+    while (read(fd, &value, sizeof(value)) == (ssize_t)sizeof(value)) {
+    }
+    static_cast<T2MASystem*>(arg)->swap_pending_master();
+}
+
+// event loop 스레드: 메시지 사이에서 바꾸므로 이 스레드의 handler 는 교체 중인 마스터를 보지 않는다
+void T2MASystem::swap_pending_master() {
+    std::lock_guard<std::mutex> lock(reload_mutex_);
+    if (!pending_master_) {
+        return;
+    }
+    Master* next = pending_master_.get();
+    retired_master_ = master_manager_->swapMaster(config_.master, std::move(pending_master_));
+    active_master_ = next;
+    reload_swapped_ = true;
+    reload_cv_.notify_all();
+    std::cout << "🔄 마스터 generation 교체: " << config_.master
+              << " (" << active_master_->get_record_count() << "건)" << std::endl;
+}
+
 void T2MASystem::control_clear_stats() {
     std::cout << "🧹 [Scheduler] Clearing statistics..." << std::endl;
     clear_statistics();
 }
 
+void T2MASystem::control_latency_stats() {
+    std::cout << "⏱️ [Scheduler] Latency (ns):" << std::endl;
+    std::cout << dump_latency_stats(true);
+}
+
+// 열린 마스터마다 통계를 capacity.<name>.* gauge 로 올리고 권장 설정 / online resize
+// (마스터 교체와 같은 event loop 스레드라 Master* 는 이 호출 안에서 유효)
+void T2MASystem::control_capacity_advisor() {
+    if (!master_manager_) {
+        return;
+    }
+    const auto& monitoring = config_.monitoring;
+    CapacityPolicy policy;
+    policy.full_ratio = monitoring.capacity_full_pct / 100.0;
+    policy.max_chain = monitoring.capacity_max_chain;
+    std::cout << "📐 [Scheduler] Master capacity:" << std::endl;
+    for (const auto& name : master_manager_->getOpenMasterNames()) {
+        Master* master = master_manager_->getMaster(name);
+        const MasterInfo* info = master_manager_->getMasterInfo(name);
+        std::unique_ptr<CapacityAdvisor>& advisor = capacity_advisors_[name];
+        if (!advisor) {
+            advisor.reset(new CapacityAdvisor(name, policy));
+            // 레코드는 레이아웃 크기로 put 하므로 (load_master_csv) slot 크기 기준도 레이아웃
+            if (masterLayout_ && info && (info->layout == masterLayout_->getRecordType() || name == config_.master)) {
+                advisor->set_record_size(masterLayout_->getRecordSize());
+            }
+        }
+        CapacityAdvice advice = advisor->sample(master);
+        std::cout << advice.to_string() << std::endl;
+
+        if (!monitoring.capacity_output_dir.empty() && info && !info->config_file.empty() && advice.changed()) {
+            std::string path = monitoring.capacity_output_dir + "/" + name + ".yaml.recommended";
+            if (CapacityAdvisor::write_recommended(info->config_file, path, advice)) {
+                std::cout << "  권장 설정: " << path << std::endl;
+            }
+        }
+        if (monitoring.capacity_auto_resize && advice.near_full) {
+            // HashMaster::resize 는 single writer: 갱신이 worker 스레드에서 lock 없이 돌면 하지 않는다
+            if (master_workers_enabled() && !master->getUseLock()) {
+                std::cout << "  online resize 생략 (master_workers 에서 use_lock 없이 갱신 중)" << std::endl;
+            } else if (CapacityAdvisor::apply_resize(master, advice)) {
+                std::cout << "  online resize: max_record_count " << advice.recommended_record_count << std::endl;
+            }
+        }
+    }
+}
+
 void T2MASystem::control_heartbeat() {
     std::cout << "💗 [Scheduler] Heartbeat - System is running" << std::endl;
     // Additional heartbeat logic can be added here
 }
 
-// libevent callback wrapper (moved from T2MA_JAPAN_EQUITY)
-void T2MASystem::scheduler_callback(evutil_socket_t /*fd*/, short /*what*/, void* arg) {
-    SchedulerData* sched_data = static_cast<SchedulerData*>(arg);
-
+// Timer wheel callback wrapper (moved from T2MA_JAPAN_EQUITY)
+void T2MASystem::scheduler_callback(SchedulerData* sched_data) {
     try {
         // Check if within schedule time
         if (sched_data->instance->isWithinScheduleTime(sched_data->config)) {
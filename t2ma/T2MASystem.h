@@ -6,6 +6,9 @@
 #include <thread>
 #include <chrono>
 #include <signal.h>
+#include <pthread.h>
+#include <sched.h>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <string>
@@ -13,19 +16,37 @@
 #include <map>
 #include <unordered_map>
 #include <functional>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
 #include <mqueue.h>
+#include <sys/stat.h>
 #include <event2/event.h>
 
 // Include components
 #include "../common/MQReader.h"
+#include "../common/ShmRingReader.h"
 #include "../pubsub/Common.h"
 #include "../common/IPCHeader.h"
+#include "../common/StatsRegistry.h"
+#include "../common/AsyncLog.h"
+#include "../common/LatencyStats.h"
+#include "../common/NumaPlacement.h"
+#include "../eventBase/TimerWheel.h"
 #include "../pubsub/SimplePublisherV2.h"
 #include "../pubsub/SimpleSubscriber.h"
+#include "../pubsub/SubscriberGroup.h"
+#include "../pubsub/PublisherReplica.h"
 #include "../HashMaster/HashMaster.h"
 #include "../HashMaster/BinaryRecord.h"
+#include "../HashMaster/HashFunctions.h"
 #include "../HashMaster/MasterManager.h"
+#include "../HashMaster/CapacityAdvisor.h"
+#include "../HashMaster/BulkLoad.h"
 #include "T2MAConfig.h"
+#include "TrepParser.h"
+#include "CsvParser.h"
+#include "MasterWorkers.h"
 #include "../pubsub/FileSequenceStorage.h"
 #include "../pubsub/HashmasterSequenceStorage.h"
 #include "../pubsub/SequenceStorage.h"
@@ -42,7 +63,7 @@ struct SchedulerData {
     T2MASystem* instance;
     T2MAConfig::SchedulerItem config;
     std::function<void()> handler;
-    struct event* event_ptr;  // Store event pointer for rescheduling
+    TimerWheel::TimerId timer_id;  // Timer wheel 등록 id (0: 없음)
 };
 
 /* get system date time YYYYMMDDhhmmss */
@@ -64,6 +85,29 @@ inline std::string getDateTime() {
     return std::string(datetime);
 }
 
+// getDateTime() 의 초 단위 캐시: 초가 바뀔 때만 localtime_r/sprintf (처리 스레드마다 하나씩 둔다)
+class DateTimeCache {
+private:
+    time_t _sec;
+    char _text[14+1];
+
+public:
+    DateTimeCache() : _sec(-1) { _text[0] = 0; }
+
+    const char* get() {
+        time_t now = time(nullptr);
+        if (now != _sec) {
+            struct tm t_tm;
+            localtime_r(&now, &t_tm);
+            snprintf(_text, sizeof(_text), "%04d%02d%02d%02d%02d%02d",
+                t_tm.tm_year + 1900, t_tm.tm_mon + 1, t_tm.tm_mday,
+                t_tm.tm_hour, t_tm.tm_min, t_tm.tm_sec);
+            _sec = now;
+        }
+        return _text;
+    }
+};
+
 inline std::string cvt_gmt2local_ymd2(char *ymd, char *hms, char *hms1, int gmt_second) {
     struct tm stime = {0};  // Initialize to zero
     struct tm t_tm;
@@ -126,72 +170,71 @@ inline std::string set_time(int hms, int gmt_second) {
     return std::string(time_temp);
 }
 
-// CSV 파싱 유틸리티
-class CsvParser {
-public:
-    static std::vector<std::string> parseLine(const std::string& line) {
-        std::vector<std::string> result;
-        std::stringstream ss(line);
-        std::string field;
-        
-        while (std::getline(ss, field, ',')) {
-            result.push_back(field);
-        }
-        return result;
-    }
-};
 
-// TREP 데이터 파싱 유틸리티
-class TrepParser {
-public:
-    static std::map<std::string, std::string> parseLine(const std::string& line) {
-        std::map<std::string, std::string> result;
-        std::stringstream ss(line);
-        std::string field;
-        
-        while (std::getline(ss, field, ',')) {
-            size_t eqPos = field.find('=');
-            if (eqPos != std::string::npos) {
-                std::string fid = field.substr(0, eqPos);
-                std::string value = field.substr(eqPos + 1);
-                
-                // 따옴표 제거
-                if (value.length() >= 2 && value.front() == '"' && value.back() == '"') {
-                    value = value.substr(1, value.length() - 2);
-                }
-                
-                result[fid] = value;
-            }
-        }
-        return result;
-    }
-};
 
+// 이 크기 이상인 CSV 는 행 경계로 나눠 병렬 파싱
+#define CSV_PARALLEL_MIN_BYTES (4 * 1024 * 1024)
 
 // Config 기반 T2MA 메인 시스템 클래스
-class T2MASystem {
+class T2MASystem : public SpscAlignedNew {  // pipeline_inbox_ 정렬 (플러그인이 new 로 생성)
 protected:
     // libevent 이벤트 루프 (상속 클래스에서 접근 가능)
     struct event_base* event_base_;
+    std::unique_ptr<TimerWheel> timer_wheel_;   // 스케줄러/종목별 타이머 (event_base_ 의 tick 하나로 구동)
+    std::unique_ptr<PipelineLatency> latency_;  // 단계별 지연 히스토그램 (monitoring.latency_tracking 일 때만)
     bool running_;
     
     // 컴포넌트들 (상속 클래스에서 접근 가능)
     std::unique_ptr<MQReader> mq_reader_;
+    std::unique_ptr<ShmRingReader> shm_reader_;   // messagequeue.transport: shm 일 때 mq_reader_ 대신
     std::unique_ptr<SimplePublisherV2> publisher_;
     std::vector<std::unique_ptr<SimpleSubscriber>> subscribers_;
+    std::unique_ptr<SubscriberGroup> subscriber_group_;   // pubsub.subscriber_group.enabled 면 구독자는 여기 소속
+    std::unique_ptr<PublisherReplica> replica_;           // pubsub.replication.role: standby 일 때 primary 복제
+    struct event* promote_signal_;                        // standby 수동 승격 (SIGUSR2)
     std::unique_ptr<MasterManager> master_manager_;
-    Master* active_master_;  // 현재 사용 중인 Master 인스턴스
+    Master* active_master_;  // 현재 사용 중인 Master 인스턴스 (event loop 스레드에서만 교체)
+    std::map<std::string, std::unique_ptr<CapacityAdvisor>> capacity_advisors_;  // 마스터 이름별 (control_capacity_advisor)
+    
+    // 마스터 재로드 (snapshot-and-swap): 새 generation 은 reload_thread_ 에서 만들고
+    // eventfd 로 event loop 를 깨워 그 스레드에서 active_master_ 를 바꾼다 (tick 처리와 겹치지 않음).
+    // 이전 generation 은 MasterManager::retireMaster 가 epoch reader 를 기다린 뒤 reload_thread_ 에서 지운다.
+    std::thread reload_thread_;
+    std::atomic<bool> reload_running_;
+    std::mutex reload_mutex_;
+    std::condition_variable reload_cv_;
+    std::unique_ptr<Master> pending_master_;    // 교체 대기 중인 새 generation (reload_mutex_)
+    std::unique_ptr<Master> retired_master_;    // 교체된 이전 generation (reload_mutex_)
+    bool reload_swapped_;                       // (reload_mutex_)
+    int reload_event_fd_;
+    struct event* reload_event_;
+    
+    // 마스터 갱신 worker (system.master_workers > 0): loop 는 RIC 만 보고 submit_master_work 로 넘기고
+    // worker 스레드가 handle_master_work 를 호출한다. worker 의 emit 결과는 loop 에서 publish
+    std::unique_ptr<MasterWorkerPool> master_workers_;
+    int master_worker_group_;
+    std::vector<PublishItem> worker_publish_items_;     // worker 결과 publish_batch 용 (loop 스레드)
+    
+    // pipeline (system.pipeline): MQ/shm reader 스레드가 TREP 메시지는 RIC 으로 바로 worker 에 넘기고
+    // 나머지 (제어 등) 는 pipeline_inbox_ 로 loop 에 넘긴다. loop 는 worker 결과를 publish 하는 sequencer
+    bool pipeline_;
+    SpscQueue<MessageBufferRef> pipeline_inbox_;
+    std::atomic<bool> pipeline_notified_;
+    int pipeline_event_fd_;
+    struct event* pipeline_event_;
+    StatsCounter pipeline_routed_;
+    StatsCounter pipeline_forwarded_;
     
     // 레이아웃 (스펙 파일에서 로드)
     std::shared_ptr<RecordLayout> masterLayout_;
     std::shared_ptr<RecordLayout> siseLayout_;
     std::shared_ptr<RecordLayout> hogaLayout_;
     
-    // 통계 (상속 클래스에서 접근 가능)
-    int processed_count_;
-    int master_update_count_;
-    int sise_count_;
-    int hoga_count_;
+    // 통계 (상속 클래스에서 접근 가능, 스레드별 shard 카운터 - StatsRegistry snapshot 에 "t2ma.*" 로 보임)
+    StatsCounter processed_count_;
+    StatsCounter master_update_count_;
+    StatsCounter sise_count_;
+    StatsCounter hoga_count_;
     
     // Configuration (상속 클래스에서 접근 가능)
     T2MAConfig config_;
@@ -208,8 +251,13 @@ protected:
     
 public:
     T2MASystem(const T2MAConfig& config) :
-        event_base_(nullptr), running_(false), config_(config),
-        active_master_(nullptr), processed_count_(0), master_update_count_(0), sise_count_(0), hoga_count_(0) {
+        event_base_(nullptr), running_(false), config_(config), promote_signal_(nullptr),
+        active_master_(nullptr), reload_running_(false), reload_swapped_(false), reload_event_fd_(-1), reload_event_(nullptr),
+        master_worker_group_(-1), pipeline_(false), pipeline_inbox_(4096), pipeline_notified_(false),
+        pipeline_event_fd_(-1), pipeline_event_(nullptr),
+        pipeline_routed_("t2ma.pipeline.routed"), pipeline_forwarded_("t2ma.pipeline.forwarded"),
+        processed_count_("t2ma.processed"), master_update_count_("t2ma.master_update"),
+        sise_count_("t2ma.sise"), hoga_count_("t2ma.hoga") {
     }
     
     virtual ~T2MASystem() {
@@ -219,12 +267,28 @@ public:
     virtual void regist_handlers() {}
     
     virtual bool initialize() {
+        AsyncLogLevel log_level;
+        if (async_log_level_from_name(config_.monitoring.log_level, log_level)) {
+            AsyncLogger::instance().set_level(log_level);
+        } else {
+            std::cerr << "WARNING: unknown monitoring.log_level " << config_.monitoring.log_level << ", using info" << std::endl;
+        }
+
+        // 이후 만드는 스레드 / 메모리가 물려받도록 가장 먼저
+        init_numa_placement();
+
         // libevent 초기화
         event_base_ = event_base_new();
         if (!event_base_) {
             std::cerr << "Failed to create event base" << std::endl;
             return false;
         }
+
+        // 스케줄러와 종목별 타이머가 공유하는 timer wheel (libevent 타이머 하나로 구동)
+        timer_wheel_.reset(new TimerWheel(event_base_, std::chrono::milliseconds(config_.system.timer_tick_ms)));
+        if (config_.monitoring.latency_tracking) {
+            latency_.reset(new PipelineLatency());
+        }
         
         // 스펙 파일 로드
         if (!init_layouts()) {
@@ -237,6 +301,10 @@ public:
             std::cerr << "Failed to initialize Master Manager" << std::endl;
             return false;
         }
+        if (!init_master_reload()) {
+            std::cerr << "Failed to initialize master reload event" << std::endl;
+            return false;
+        }
         
         // Publisher 초기화
         if (!init_publisher()) {
@@ -244,6 +312,16 @@ public:
             return false;
         }
         
+        // 마스터 갱신 worker (publisher 이후: worker 결과를 publish)
+        if (!init_master_workers()) {
+            std::cerr << "Failed to initialize master workers" << std::endl;
+            return false;
+        }
+        if (!init_pipeline()) {
+            std::cerr << "Failed to initialize pipeline" << std::endl;
+            return false;
+        }
+        
         // MQ Reader 초기화
         if (!init_mq_reader()) {
             std::cerr << "Failed to initialize MQ Reader" << std::endl;
@@ -259,6 +337,8 @@ public:
         // 메시지 핸들러 테이블 초기화
         init_message_handlers();
 
+        report_numa_layout();
+
         // message type 별 handler, command 별 handler 설정
         setup_message_handlers();
         setup_command_handlers();
@@ -308,9 +388,85 @@ public:
         return true;
     }
     
+    // system.event_loop_cpus / numa_node: main 스레드를 CPU 집합에 묶고 preferred memory policy 를 건다.
+    // 이후 만드는 스레드 (worker, reactor, recovery, reader) 는 이 집합과 정책을 물려받으며
+    // 개별 고정 (spin_cpu, *_cpus) 이 있으면 그 스레드만 다시 묶는다. 실패는 경고만 한다.
+    void init_numa_placement() {
+        int node = config_.system.numa_node;
+        if (node >= NumaPlacement::node_count()) {
+            std::cerr << "WARNING: system.numa_node " << node << " is not present ("
+                      << NumaPlacement::node_count() << " nodes), ignoring" << std::endl;
+            config_.system.numa_node = node = -1;
+        }
+        cpu_set_t cpus;
+        bool have_cpus = false;
+        if (!config_.system.event_loop_cpus.empty()) {
+            have_cpus = NumaPlacement::parse_cpu_list(config_.system.event_loop_cpus, cpus);
+            if (!have_cpus) {
+                std::cerr << "WARNING: invalid system.event_loop_cpus: " << config_.system.event_loop_cpus << std::endl;
+            }
+        } else if (node >= 0) {
+            have_cpus = NumaPlacement::node_cpus(node, cpus);
+        }
+        if (have_cpus) {
+            int rc = NumaPlacement::bind_thread(pthread_self(), cpus);
+            if (rc != 0) {
+                std::cerr << "Failed to bind main thread to cpus " << NumaPlacement::format_cpu_list(cpus)
+                          << ": " << strerror(rc) << std::endl;
+            }
+        }
+        if (node >= 0 && !NumaPlacement::prefer_node(node)) {
+            std::cerr << "Failed to set preferred memory node " << node << ": " << strerror(errno) << std::endl;
+        }
+    }
+
+    // 시작 시 스레드 / 메모리 배치 출력
+    void report_numa_layout() {
+        std::cout << "=== NUMA layout ===" << std::endl;
+        int nodes = NumaPlacement::node_count();
+        for (int n = 0; n < nodes; n++) {
+            cpu_set_t cpus;
+            std::cout << "  node " << n << " cpus: "
+                      << (NumaPlacement::node_cpus(n, cpus) ? NumaPlacement::format_cpu_list(cpus) : std::string("?")) << std::endl;
+        }
+        cpu_set_t main_cpus;
+        CPU_ZERO(&main_cpus);
+        pthread_getaffinity_np(pthread_self(), sizeof(main_cpus), &main_cpus);
+        int policy_node = -1;
+        int policy = NumaPlacement::current_policy(&policy_node);
+        std::cout << "  memory node: " << config_.system.numa_node
+                  << " (policy " << (policy == MPOL_PREFERRED ? "preferred" : policy == MPOL_DEFAULT ? "default" : "other")
+                  << (policy == MPOL_PREFERRED ? " node " + std::to_string(policy_node) : std::string()) << ")" << std::endl;
+        std::cout << "  event loop: cpus " << NumaPlacement::format_cpu_list(main_cpus);
+        if (config_.system.event_loop_mode == "SPIN" && config_.system.spin_cpu >= 0) {
+            std::cout << " (SPIN pinned to " << config_.system.spin_cpu << ")";
+        }
+        std::cout << std::endl;
+        auto pinned = [](const std::vector<int>& cpus) {
+            return cpus.empty() ? std::string("inherit") : NumaPlacement::format_cpu_list(cpus);
+        };
+        std::cout << "  master workers: " << config_.system.master_workers
+                  << " cpus " << pinned(config_.system.master_worker_cpus) << std::endl;
+        if (config_.system.pipeline) {
+            std::cout << "  pipeline reader: cpu "
+                      << (config_.system.pipeline_reader_cpu >= 0 ? std::to_string(config_.system.pipeline_reader_cpu) : std::string("inherit"))
+                      << std::endl;
+        }
+        std::cout << "  io reactors: " << config_.pubsub.publisher.io_reactors
+                  << " cpus " << pinned(config_.pubsub.publisher.io_reactor_cpus) << std::endl;
+        std::cout << "  recovery workers: cpus " << pinned(config_.pubsub.publisher.recovery_cpus) << std::endl;
+        if (master_manager_) {
+            std::cout << "  masters: node " << master_manager_->getNumaNode() << " (per-master numa_node overrides)" << std::endl;
+        }
+        if (config_.messagequeue.transport == "shm") {
+            std::cout << "  shm ring " << config_.messagequeue.name << ": node " << config_.system.numa_node << std::endl;
+        }
+    }
+
     bool init_master_manager() {
         // MasterManager 초기화
         master_manager_.reset(new MasterManager(LOG_INFO));
+        master_manager_->setNumaNode(config_.system.numa_node);
 
         // Config에서 지정된 master 설정 파일 로드
         if (!master_manager_->loadMasterConfigs(config_.files.master_file)) {
@@ -318,8 +474,13 @@ public:
             return false;
         }
 
-        // Config에서 지정된 master 가져오기
+        // Config에서 지정된 master 가져오기 (preload_masters 가 있으면 같이 병렬로 open)
         std::string master_name = config_.master;  // "JAPAN_EQUITY_MASTER"
+        std::vector<std::string> open_names(1, master_name);
+        open_names.insert(open_names.end(), config_.system.preload_masters.begin(), config_.system.preload_masters.end());
+        if (!master_manager_->openMasters(open_names)) {
+            std::cerr << "Failed to open some masters" << std::endl;
+        }
         active_master_ = master_manager_->getMaster(master_name);
         if (!active_master_) {
             std::cerr << "Failed to get master: " << master_name << std::endl;
@@ -335,6 +496,158 @@ public:
         return true;
     }
     
+    bool init_master_workers() {
+        if (config_.system.master_workers <= 0) {
+            return true;
+        }
+        master_workers_.reset(new MasterWorkerPool(*master_manager_, event_base_,
+            [this](int tag, const char* data, size_t size) {
+                if (running_ && publisher_) {
+                    LatencyScope scope(latency_ ? &latency_->publish : nullptr);
+                    publisher_->publish(static_cast<DataTopic>(tag), data, size);
+                }
+            }));
+        // drain 한번에 모인 worker 결과는 publish_batch 한번으로 (시퀀스는 loop 에서 순서대로 부여)
+        master_workers_->set_batch_output([this](const MasterWorkerOutput* outputs, size_t count) {
+            if (!running_ || !publisher_) return;
+            worker_publish_items_.resize(count);
+            for (size_t i = 0; i < count; i++) {
+                worker_publish_items_[i].topic = static_cast<DataTopic>(outputs[i].tag);
+                worker_publish_items_[i].data = outputs[i].data.data();
+                worker_publish_items_[i].size = outputs[i].data.size();
+            }
+            LatencyScope scope(latency_ ? &latency_->publish : nullptr);
+            publisher_->publish_batch(worker_publish_items_.data(), count);
+        });
+        // pipeline 이면 reader 스레드도 submit 한다 (subscriber 로 받은 TREP 는 loop 에서)
+        master_workers_->set_multi_producer(config_.system.pipeline);
+        master_worker_group_ = master_workers_->add_master(config_.master, config_.system.master_workers,
+            [this](MasterWorkerContext& ctx, Master* master, const char* data, size_t size) {
+                handle_master_work(ctx, master, data, size);
+            }, config_.system.master_worker_cpus);
+        if (master_worker_group_ < 0 || !master_workers_->start()) {
+            master_workers_.reset();
+            master_worker_group_ = -1;
+            return false;
+        }
+        std::cout << "✓ 마스터 갱신 worker " << master_workers_->partition_count(master_worker_group_)
+                  << "개 시작 (" << config_.master << ")" << std::endl;
+        return true;
+    }
+    
+    bool init_pipeline() {
+        if (!config_.system.pipeline) {
+            return true;
+        }
+        if (!master_workers_enabled()) {
+            std::cerr << "WARNING: system.pipeline 은 master_workers > 0 이 필요합니다, event loop 에서 처리합니다" << std::endl;
+            return true;
+        }
+        pipeline_event_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (pipeline_event_fd_ < 0) {
+            std::cerr << "pipeline eventfd failed: " << strerror(errno) << std::endl;
+            return false;
+        }
+        pipeline_event_ = event_new(event_base_, pipeline_event_fd_, EV_READ | EV_PERSIST, &T2MASystem::on_pipeline_inbox, this);
+        if (!pipeline_event_ || event_add(pipeline_event_, nullptr) != 0) {
+            std::cerr << "Failed to add pipeline inbox event" << std::endl;
+            return false;
+        }
+        pipeline_ = true;
+        std::cout << "✓ pipeline 모드: reader 스레드 -> 마스터 갱신 worker -> event loop publish" << std::endl;
+        return true;
+    }
+    
+    void cleanup_pipeline() {
+        if (pipeline_event_) {
+            event_free(pipeline_event_);
+            pipeline_event_ = nullptr;
+        }
+        if (pipeline_event_fd_ >= 0) {
+            close(pipeline_event_fd_);
+            pipeline_event_fd_ = -1;
+        }
+        MessageBufferRef item;
+        while (pipeline_inbox_.try_pop(item)) {}
+        pipeline_ = false;
+    }
+    
+    // pipeline reader 는 run() 에서 시작 (상속 클래스 initialize 가 worker scratch 를 만든 뒤)
+    void start_pipeline_reader() {
+        if (!pipeline_) return;
+        if (mq_reader_ && !mq_reader_->is_running()) {
+            mq_reader_->start_poll_thread(config_.system.pipeline_reader_cpu, 100000);
+        }
+        if (shm_reader_ && !shm_reader_->is_running()) {
+            shm_reader_->start_poll_thread(config_.system.pipeline_reader_cpu);
+        }
+    }
+    
+    // reader 스레드: TREP 메시지는 RIC (FID 0) 만 찾아 worker 로, 그 외는 loop 의 기존 경로로
+    void route_pipeline_message(DataTopic topic, const char* data, size_t size) {
+        if (size >= sizeof(ipc_header)) {
+            const ipc_header* header = reinterpret_cast<const ipc_header*>(data);
+            if (header->_msg_size == size && header->_msg_type == static_cast<char>(MsgType::TREP_DATA)) {
+                const char* msg_data = data + sizeof(ipc_header);
+                size_t msg_data_size = size - sizeof(ipc_header);
+                TrepSpan ric;
+                if (TrepParser::find_value(msg_data, msg_data_size, 0, ric) && !ric.empty() &&
+                    submit_master_work(ric.data, ric.size, msg_data, msg_data_size)) {
+                    pipeline_routed_++;
+                    return;
+                }
+            }
+        }
+        
+        MessageBufferRef item = MessageBufferRef::acquire(size);
+        if (!item) {
+            std::cerr << "pipeline: buffer allocation failed, dropping " << size << " bytes" << std::endl;
+            return;
+        }
+        memcpy(item.data(), data, size);
+        while (!pipeline_inbox_.try_push(std::move(item))) {
+            std::this_thread::yield();
+        }
+        pipeline_forwarded_++;
+        if (!pipeline_notified_.exchange(true)) {
+            uint64_t one = 1;
+            ssize_t n = write(pipeline_event_fd_, &one, sizeof(one));
+            (void)n;
+        }
+    }
+    
+    static void on_pipeline_inbox(evutil_socket_t fd, short /*events*/, void* arg) {
+        T2MASystem* self = static_cast<T2MASystem*>(arg);
+        uint64_t v;
+        ssize_t n = read(fd, &v, sizeof(v));
+        (void)n;
+        self->pipeline_notified_.store(false);
+        MessageBufferRef item;
+        while (self->pipeline_inbox_.try_pop(item)) {
+            self->handle_trep_data_from_mq(DataTopic::TOPIC1, item.data(), item.size());
+            item.reset();
+        }
+    }
+    
+    // 마스터 갱신 worker 사용 여부 / key (RIC) 로 partition worker 에 메시지 넘기기 (loop 스레드, pipeline 이면 reader 도)
+    bool master_workers_enabled() const { return master_worker_group_ >= 0; }
+    bool submit_master_work(const char* key, size_t key_len, const char* data, size_t size) {
+        return master_workers_ && master_workers_->submit(master_worker_group_, key, key_len, data, size);
+    }
+    
+    // worker 스레드에서 호출 (ctx.partition() 별 scratch 를 쓰고, publish 는 ctx.emit(DataTopic, ...) 으로)
+    virtual void handle_master_work(MasterWorkerContext& /*ctx*/, Master* /*master*/, const char* /*data*/, size_t /*size*/) {}
+    
+    // 레이아웃의 첫번째 키 필드 (없으면 invalid)
+    static FieldHandle find_key_field(const std::shared_ptr<RecordLayout>& layout) {
+        if (layout) {
+            for (const auto& field : layout->getFields()) {
+                if (field.isKey) return FieldHandle(field);
+            }
+        }
+        return FieldHandle();
+    }
+    
     bool init_publisher() {
         publisher_.reset(new SimplePublisherV2(event_base_));
         
@@ -358,16 +671,113 @@ public:
         }
         publisher_->set_sequence_storage(storage);
         */
+        if (config_.pubsub.publisher.sequence_flush_ms > 0) {
+            publisher_->set_sequence_write_behind(config_.pubsub.publisher.sequence_flush_ms);
+        }
+        publisher_->set_latency_tracking(config_.monitoring.latency_tracking);
         if(!publisher_->init_sequence_storage(config_.storage_type)) {
             std::cerr << "Failed to initialize sequence storage" << std::endl;
             return false;
         }
 
-        if (!publisher_->init_database(config_.pubsub.publisher.database_name)) {
+        publisher_->set_database_compression(config_.pubsub.publisher.database_compression,
+                                             static_cast<size_t>(config_.pubsub.publisher.database_block_size));
+        publisher_->set_database_segments(config_.pubsub.publisher.database_segments);
+        publisher_->set_database_memory_limit(static_cast<size_t>(config_.pubsub.publisher.database_memory_mb) << 20);
+        publisher_->set_database_write_behind(config_.pubsub.publisher.database_write_behind,
+                                              config_.pubsub.publisher.database_lag);
+        if (!publisher_->init_database(config_.pubsub.publisher.database_name,
+                                       config_.pubsub.publisher.database_type,
+                                       config_.pubsub.publisher.database_sync)) {
             std::cerr << "Failed to initialize Publisher database" << std::endl;
             return false;
         }
         
+        // 같은 호스트 구독자용 공유메모리 로그 (실패해도 socket 구독은 그대로 동작)
+        if (!config_.pubsub.publisher.shm_log.empty() &&
+            !publisher_->enable_shm_log(config_.pubsub.publisher.shm_log, config_.pubsub.publisher.shm_log_capacity)) {
+            std::cerr << "WARNING: shm log disabled: " << config_.pubsub.publisher.shm_log << std::endl;
+        }
+        
+        // 느린 구독자가 publisher 메모리를 잡아먹지 않도록 구독자별 송신 큐 상한
+        publisher_->set_slow_consumer_policy(config_.pubsub.publisher.slow_consumer_policy,
+                                             config_.pubsub.publisher.send_queue_high_watermark);
+        // 장 시작처럼 몰릴 때 구독자별 작은 writev 를 모아서 (조용할 때는 바로 송신)
+        if (config_.pubsub.publisher.write_coalesce_us > 0) {
+            publisher_->set_write_coalescing(static_cast<size_t>(config_.pubsub.publisher.write_coalesce_bytes),
+                                             static_cast<uint32_t>(config_.pubsub.publisher.write_coalesce_us));
+        }
+        
+        // MQ drain 한번 (messagequeue.batch_size) 에 받은 메시지를 publish_batch 한번으로 (DB / 구독자 송신도 한번)
+        if (config_.pubsub.publisher.micro_batching) {
+            publisher_->set_micro_batching(true);
+        }
+
+        // 재연결이 몰릴 때 복구가 디스크 / 네트워크를 다 쓰지 않도록 (live 에 가까운 복구는 제한 없음)
+        if (config_.pubsub.publisher.recovery_bandwidth_mb > 0) {
+            publisher_->set_recovery_bandwidth(static_cast<uint64_t>(config_.pubsub.publisher.recovery_bandwidth_mb) << 20,
+                                               static_cast<uint32_t>(config_.pubsub.publisher.recovery_priority_messages));
+        }
+        // 재연결 직후의 짧은 복구는 최근 메시지 캐시에서 바로 (DB / 워커를 거치지 않음)
+        if (config_.pubsub.publisher.hot_tail_messages > 0) {
+            publisher_->set_hot_tail_cache(static_cast<size_t>(config_.pubsub.publisher.hot_tail_messages),
+                                           static_cast<size_t>(config_.pubsub.publisher.hot_tail_mb) << 20);
+        }
+        
+        // socket profile 을 먼저 걸고 system.socket_busy_poll_us 가 있으면 busy poll 만 덮어씀
+        publisher_->set_socket_profile(config_.pubsub.socket_profile);
+        if (config_.system.socket_busy_poll_us > 0) {
+            publisher_->set_socket_busy_poll(config_.system.socket_busy_poll_us);
+        }
+        
+        if (!config_.pubsub.publisher.recovery_cpus.empty()) {
+            publisher_->set_recovery_cpus(config_.pubsub.publisher.recovery_cpus);
+        }
+        
+        // socket 구독자가 많으면 fan-out 을 I/O 스레드로 분산
+        if (config_.pubsub.publisher.io_reactors > 0) {
+            publisher_->set_io_reactors(config_.pubsub.publisher.io_reactors,
+                                        config_.pubsub.publisher.io_reactor_cpus);
+        }
+        
+        // conflation key: 레이아웃의 키 필드(종목코드 등) 값, 토픽별로 구분
+        {
+            FieldHandle sise_key = find_key_field(siseLayout_);
+            FieldHandle hoga_key = find_key_field(hogaLayout_);
+            publisher_->set_conflation_key([sise_key, hoga_key](const TopicMessage& msg) -> uint64_t {
+                const FieldHandle& key = (msg.topic == DataTopic::TOPIC2) ? hoga_key : sise_key;
+                uint64_t h = 0;
+                if (key.valid() && static_cast<uint32_t>(key.offset + key.length) <= msg.data_size) {
+                    h = hash_wymix(msg.data + key.offset, key.length);
+                }
+                return (h << 8) | static_cast<uint32_t>(msg.topic);
+            });
+        }
+        
+        // COMPACT 로 구독한 socket 구독자용 레이아웃 (sise: TOPIC1, hoga: TOPIC2)
+        if (config_.pubsub.publisher.wire_encoding) {
+            if (siseLayout_) publisher_->add_wire_layout(DataTopic::TOPIC1, siseLayout_);
+            if (hogaLayout_) publisher_->add_wire_layout(DataTopic::TOPIC2, hogaLayout_);
+        }
+        
+        if (config_.pubsub.replication.role == "standby") {
+            // listener 는 승격할 때 연다 (그 전까지 primary 스트림을 같은 seq 로 기록)
+            return init_replica();
+        }
+        return start_publisher_listener();
+    }
+    
+    // multicast / listener 시작 (primary 는 init_publisher 에서, standby 는 승격할 때)
+    bool start_publisher_listener() {
+        // 원격 구독자용 multicast (실패해도 socket 구독은 그대로 동작)
+        if (!config_.pubsub.publisher.multicast_group.empty() &&
+            !publisher_->enable_multicast(config_.pubsub.publisher.multicast_group,
+                                          config_.pubsub.publisher.multicast_interface,
+                                          config_.pubsub.publisher.multicast_ttl,
+                                          config_.pubsub.publisher.multicast_max_datagram)) {
+            std::cerr << "WARNING: multicast disabled: " << config_.pubsub.publisher.multicast_group << std::endl;
+        }
+        
         if (!publisher_->start_both(config_.pubsub.publisher.unix_socket_path, 
                                    config_.pubsub.publisher.tcp_host, 
                                    config_.pubsub.publisher.tcp_port)) {
@@ -380,8 +790,64 @@ public:
         return true;
     }
     
+    // hot standby: primary 구독 -> 같은 seq 로 DB / 시퀀스 기록, 자체 publish 는 버림 (마스터는 계속 갱신)
+    bool init_replica() {
+        const auto& replication = config_.pubsub.replication;
+        replica_.reset(new PublisherReplica(event_base_, publisher_.get()));
+        if (replication.primary_type == "unix") {
+            replica_->set_primary_address(SocketType::UNIX_SOCKET, replication.primary_socket_path);
+        } else {
+            replica_->set_primary_address(SocketType::TCP_SOCKET, replication.primary_host, replication.primary_port);
+        }
+        replica_->set_client_info(config_.id, config_.name + "_standby");
+        replica_->set_socket_profile(config_.pubsub.socket_profile);
+        ReplicaPolicy policy;
+        policy.ack_every = static_cast<uint32_t>(std::max(0, replication.ack_every));
+        policy.ack_interval_ms = static_cast<uint32_t>(std::max(0, replication.ack_interval_ms));
+        policy.failover_timeout_ms = static_cast<uint32_t>(std::max(0, replication.failover_timeout_ms));
+        replica_->set_policy(policy);
+        replica_->set_failover_callback([this]() { promote_standby(); });
+        if (!replica_->start()) {
+            std::cerr << "Failed to start standby replication" << std::endl;
+            return false;
+        }
+        // 수동 승격: kill -USR2 (loop 스레드에서 처리)
+        promote_signal_ = evsignal_new(event_base_, SIGUSR2, &T2MASystem::on_promote_signal, this);
+        if (promote_signal_) {
+            event_add(promote_signal_, nullptr);
+        }
+        std::cout << "✓ Publisher standby (primary " << (replication.primary_type == "unix" ? replication.primary_socket_path :
+                     replication.primary_host + ":" + std::to_string(replication.primary_port)) << ")" << std::endl;
+        return true;
+    }
+    
+    static void on_promote_signal(evutil_socket_t /*fd*/, short /*events*/, void* arg) {
+        std::cout << "SIGUSR2: promoting standby publisher" << std::endl;
+        static_cast<T2MASystem*>(arg)->promote_standby();
+    }
+    
+    // standby 승격: 복제를 멈추고 같은 global seq 에서 listener 를 연다 (loop 스레드)
+    void promote_standby() {
+        if (!replica_ || replica_->is_promoted()) {
+            return;
+        }
+        replica_->promote();
+        if (!start_publisher_listener()) {
+            std::cerr << "Failed to start Publisher server after promotion" << std::endl;
+            return;
+        }
+        std::cout << "✓ Standby promoted at seq " << publisher_->get_current_sequence() << std::endl;
+    }
+    
     bool init_mq_reader() {
+        if (config_.messagequeue.transport == "shm") {
+            return init_shm_reader();
+        }
+        
         mq_reader_.reset(new MQReader(event_base_));
+        if (config_.messagequeue.batch_size > 1) {
+            mq_reader_->set_batch_size(config_.messagequeue.batch_size);
+        }
         
         // 먼저 메인 큐 생성 시도
         if (mq_reader_->create_mq(config_.messagequeue.name.c_str(), 
@@ -393,7 +859,13 @@ public:
             return false;
         }
         
-        // TREP 데이터 콜백 설정
+        // TREP 데이터 콜백 설정 (pipeline 이면 reader 스레드에서 분배, 시작은 run() 에서)
+        if (pipeline_) {
+            mq_reader_->set_topic_callback([this](DataTopic topic, const char* data, size_t size) {
+                this->route_pipeline_message(topic, data, size);
+            });
+            return true;
+        }
         mq_reader_->set_topic_callback([this](DataTopic topic, const char* data, size_t size) {
             this->handle_trep_data_from_mq(topic, data, size);
         });
@@ -402,7 +874,56 @@ public:
         return true;
     }
     
+    // 공유메모리 SPSC ring 으로 TREP 수신 (producer 는 ShmRing::open(name) 후 write)
+    bool init_shm_reader() {
+        shm_reader_.reset(new ShmRingReader(event_base_));
+        if (config_.messagequeue.batch_size > 1) {
+            shm_reader_->set_batch_size(config_.messagequeue.batch_size);
+        }
+        shm_reader_->set_spin_us(config_.messagequeue.spin_us);
+        
+        if (!shm_reader_->create_ring(config_.messagequeue.name, config_.messagequeue.shm_capacity,
+                                      config_.system.numa_node)) {
+            std::cerr << "Failed to create shm ring: " << config_.messagequeue.name << std::endl;
+            return false;
+        }
+        std::cout << "✓ SHM Reader started on ring: " << config_.messagequeue.name << std::endl;
+        
+        if (pipeline_) {
+            shm_reader_->set_topic_callback([this](DataTopic topic, const char* data, size_t size) {
+                this->route_pipeline_message(topic, data, size);
+            });
+            return true;
+        }
+        shm_reader_->set_topic_callback([this](DataTopic topic, const char* data, size_t size) {
+            this->handle_trep_data_from_mq(topic, data, size);
+        });
+        
+        shm_reader_->start();
+        return true;
+    }
+    
+    bool init_subscriber_group() {
+        const auto& group_config = config_.pubsub.subscriber_group;
+        subscriber_group_.reset(new SubscriberGroup(event_base_, config_.id, config_.name));
+        if (!subscriber_group_->init_sequence_storage(group_config.sequence_path)) {
+            std::cerr << "Failed to initialize subscriber group sequence storage" << std::endl;
+            return false;
+        }
+        subscriber_group_->set_merge_by_timestamp(group_config.merge_window_ms);
+        subscriber_group_->set_batch_callback([this](const TopicMessageView* messages, size_t count) {
+            for (size_t i = 0; i < count; ++i) {
+                this->handle_trep_data_from_subscriber(messages[i].topic, messages[i].data, messages[i].size);
+            }
+        });
+        std::cout << "✓ Subscriber group enabled (merge window: " << group_config.merge_window_ms << "ms)" << std::endl;
+        return true;
+    }
+
     bool init_subscribers() {
+        if (config_.pubsub.subscriber_group.enabled && !init_subscriber_group()) {
+            return false;
+        }
         // Config에서 subscriber 설정들을 읽어와서 생성
         for (const auto& sub_config : config_.pubsub.subscribers) {
             if (!sub_config.enabled) {
@@ -410,28 +931,69 @@ public:
                 continue;
             }
             
-            std::unique_ptr<SimpleSubscriber> subscriber(new SimpleSubscriber(event_base_));
-            subscriber->set_client_info(config_.id, config_.name, sub_config.pub_id, sub_config.pub_name);
+            std::unique_ptr<SimpleSubscriber> owned;
+            SimpleSubscriber* subscriber = nullptr;
+            if (subscriber_group_) {
+                // 일련번호 / parser / 콜백은 group 이 설정
+                subscriber = subscriber_group_->add_subscriber(sub_config.pub_id, sub_config.pub_name);
+                if (!subscriber) {
+                    std::cerr << "Failed to add subscriber " << sub_config.name << " to group" << std::endl;
+                    return false;
+                }
+            } else {
+                owned.reset(new SimpleSubscriber(event_base_));
+                subscriber = owned.get();
+                subscriber->set_client_info(config_.id, config_.name, sub_config.pub_id, sub_config.pub_name);
 
-            if(!subscriber->init_sequence_storage(config_.storage_type)) {
-                std::cerr << "Failed to initialize sequence storage" << std::endl;
-                return false;
+                if(!subscriber->init_sequence_storage(config_.storage_type)) {
+                    std::cerr << "Failed to initialize sequence storage" << std::endl;
+                    return false;
+                }
+                // TREP 데이터 콜백 설정
+                subscriber->set_topic_callback([this](DataTopic topic, const char* data, int size) {
+                    this->handle_trep_data_from_subscriber(topic, data, size);
+                });
+                subscriber->set_sequence_persist_policy(sub_config.seq_persist_every, sub_config.seq_persist_interval_ms);
             }
             // sub_config.topic_mask = DataTopic::ALL_TOPICS;
             subscriber->set_subscription_mask(sub_config.topic_mask);
             // subscriber->set_subscription_mask(DataTopic::ALL_TOPICS);
             std::cout << "✓ Subscriber " << sub_config.name << " subscription mask: " << sub_config.topic_mask << std::endl;
             
-            // TREP 데이터 콜백 설정
-            subscriber->set_topic_callback([this](DataTopic topic, const char* data, int size) {
-                this->handle_trep_data_from_subscriber(topic, data, size);
-            });
             if (sub_config.type == "unix") {
                 subscriber->set_address(SocketType::UNIX_SOCKET, sub_config.socket_path);
             } else if (sub_config.type == "tcp") {
                 subscriber->set_address(SocketType::TCP_SOCKET, sub_config.host, sub_config.port);
             }
-            subscribers_.push_back(std::move(subscriber));
+            // publisher 가 hot standby 로 넘어가면 재연결 시 그쪽 주소에서 이어 구독
+            if (sub_config.type == "unix" && !sub_config.failover_socket_path.empty()) {
+                subscriber->set_failover_address(SocketType::UNIX_SOCKET, sub_config.failover_socket_path);
+            } else if (sub_config.type == "tcp" && !sub_config.failover_host.empty()) {
+                subscriber->set_failover_address(SocketType::TCP_SOCKET, sub_config.failover_host,
+                                                 sub_config.failover_port ? sub_config.failover_port : sub_config.port);
+            }
+            if (!sub_config.shm_log.empty()) {
+                subscriber->set_shm_log(sub_config.shm_log);
+            }
+            if (!sub_config.multicast_group.empty()) {
+                subscriber->set_multicast(sub_config.multicast_group, sub_config.multicast_interface);
+            }
+            if (sub_config.conflate_topics) {
+                subscriber->set_conflation(sub_config.conflate_topics, sub_config.conflate_interval_ms);
+            }
+            subscriber->set_socket_profile(config_.pubsub.socket_profile);
+            if (config_.system.socket_busy_poll_us > 0) {
+                subscriber->set_socket_busy_poll(config_.system.socket_busy_poll_us);
+            }
+            subscriber->set_recovery_compression(sub_config.recovery_compression);
+            if (sub_config.parallel_recovery_streams > 1) {
+                subscriber->set_parallel_recovery(sub_config.parallel_recovery_streams, sub_config.parallel_recovery_chunk,
+                                                  sub_config.parallel_recovery_min);
+            }
+            subscriber->set_latency_tracking(config_.monitoring.latency_tracking);
+            if (owned) {
+                subscribers_.push_back(std::move(owned));
+            }
             
             std::cout << "✓ Initialized subscriber: " << sub_config.name 
                       << " (ID: " << sub_config.client_id 
@@ -441,19 +1003,41 @@ public:
             } else if (sub_config.type == "unix") {
                 std::cout << " Socket: " << sub_config.socket_path;
             }
+            if (!sub_config.shm_log.empty()) {
+                std::cout << " Shm log: " << sub_config.shm_log;
+            }
+            if (!sub_config.multicast_group.empty()) {
+                std::cout << " Multicast: " << sub_config.multicast_group;
+            }
+            if (sub_config.conflate_topics) {
+                std::cout << " Conflate: " << sub_config.conflate_topics << " (" << sub_config.conflate_interval_ms << "ms)";
+            }
             std::cout << std::endl;
         }
         
-        std::cout << "✓ Initialized " << subscribers_.size() << " active subscribers" << std::endl;
+        size_t active = subscribers_.size() + (subscriber_group_ ? subscriber_group_->size() : 0);
+        std::cout << "✓ Initialized " << active << " active subscribers" << std::endl;
         return true;
     }
     
     
 
+    // 현재 메시지를 꺼낸 source (MQ / shm ring) 의 마지막 drain 완료 시각
+    uint64_t source_drain_ns() const {
+        if (mq_reader_) return mq_reader_->get_last_drain_ns();
+        if (shm_reader_) return shm_reader_->get_last_drain_ns();
+        return latency_now_ns();
+    }
+
     // MQ에서 IPC 헤더 기반 메시지 처리
     void handle_trep_data_from_mq(DataTopic /*topic*/, const char* data, size_t size) {
+        uint64_t drain_ns = 0;
+        if (latency_) {
+            drain_ns = source_drain_ns();
+            latency_->queue.record(latency_now_ns() - drain_ns);
+        }
         if (size < sizeof(ipc_header)) {
-            std::cerr << "메시지가 너무 작습니다: " << size << " bytes" << std::endl;
+            ALOG_WARN("T2MA", "메시지가 너무 작습니다: %zu bytes", size);
             return;
         }
         
@@ -462,8 +1046,7 @@ public:
         
         // 메시지 크기 검증
         if (header->_msg_size != size) {
-            std::cerr << "메시지 크기 불일치: header=" << header->_msg_size 
-                      << ", actual=" << size << std::endl;
+            ALOG_WARN("T2MA", "메시지 크기 불일치: header=%d, actual=%zu", header->_msg_size, size);
             return;
         }
         
@@ -476,10 +1059,13 @@ public:
         if (handler_it != msg_type_handlers_.end()) {
             handler_it->second(msg_data, msg_data_size);
         } else {
-            std::cerr << "알 수 없는 메시지 타입: '" << header->_msg_type 
-                      << "' (0x" << std::hex << (int)(unsigned char)header->_msg_type << ")" << std::endl;
+            ALOG_WARN("T2MA", "알 수 없는 메시지 타입: '%c' (0x%02x)", header->_msg_type,
+                      static_cast<unsigned>(static_cast<unsigned char>(header->_msg_type)));
         }
         
+        if (latency_) {
+            latency_->total.record(latency_now_ns() - drain_ns);
+        }
         processed_count_++;
     }
     
@@ -487,24 +1073,24 @@ public:
     void handle_trep_data_message(const char* data, size_t size) {
         // std::string trep_line(data, size);
         // process_trep_line(trep_line);
-        std::cout << "\n\n\thandle_trep_data_message: " << size << " bytes" << std::endl;
+        ALOG_DEBUG("T2MA", "handle_trep_data_message: %zu bytes", size);
         // trep data를 파싱해서 처리 (각 업무별 클래스에서 실제 구현)
     }
     
     void handle_master_update_message(const char* data, size_t size) {
-        std::cout << "🔄 마스터 업데이트 메시지 수신: " << size << " bytes" << std::endl;
+        ALOG_DEBUG("T2MA", "마스터 업데이트 메시지 수신: %zu bytes", size);
         master_update_count_++;
         // 마스터 업데이트 로직 구현
     }
     
     void handle_sise_data_message(const char* data, size_t size) {
-        std::cout << "📊 시세 데이터 메시지 수신: " << size << " bytes" << std::endl;
+        ALOG_DEBUG("T2MA", "시세 데이터 메시지 수신: %zu bytes", size);
         sise_count_++;
         // 시세 데이터 처리 로직 구현
     }
     
     void handle_hoga_data_message(const char* data, size_t size) {
-        std::cout << "📈 호가 데이터 메시지 수신: " << size << " bytes" << std::endl;
+        ALOG_DEBUG("T2MA", "호가 데이터 메시지 수신: %zu bytes", size);
         hoga_count_++;
         // 호가 데이터 처리 로직 구현
     }
@@ -528,7 +1114,7 @@ public:
     }
     
     void handle_heartbeat_message(const char* data, size_t size) {
-        std::cout << "💗 하트비트 수신: " << size << " bytes" << std::endl;
+        ALOG_DEBUG("T2MA", "하트비트 수신: %zu bytes", size);
     }
     
     void load_message_handlers() {
@@ -577,9 +1163,18 @@ public:
     virtual void control_reload_master();
     virtual void control_clear_stats();
     virtual void control_heartbeat();
+    virtual void control_latency_stats();   // 지연 히스토그램 출력 후 초기화 (구간 분포)
+    virtual void control_capacity_advisor(); // 열린 마스터의 용량 gauge 갱신 / 권장 설정 (monitoring.capacity_*)
+
+    // 마스터 재로드 (snapshot-and-swap)
+    bool init_master_reload();
+    void cleanup_master_reload();
+    void master_reload_worker();
+    void swap_pending_master();
+    static void on_master_swap(evutil_socket_t fd, short events, void* arg);
 
-    // libevent callback wrapper (moved from T2MA_JAPAN_EQUITY)
-    static void scheduler_callback(evutil_socket_t fd, short what, void* arg);
+    // Timer wheel callback wrapper (moved from T2MA_JAPAN_EQUITY)
+    static void scheduler_callback(SchedulerData* sched_data);
 
     // 메소드 테이블 초기화
     virtual void init_message_handlers() {
@@ -647,39 +1242,53 @@ public:
     // 통계 출력
     void print_statistics() {
         std::cout << "\n=== T2MA 시스템 통계 ===" << std::endl;
-        std::cout << "총 처리 메시지: " << processed_count_ << std::endl;
-        std::cout << "마스터 업데이트: " << master_update_count_ << std::endl;
-        std::cout << "시세 데이터: " << sise_count_ << std::endl;
-        std::cout << "호가 데이터: " << hoga_count_ << std::endl;
+        std::cout << "총 처리 메시지: " << processed_count_.value() << std::endl;
+        std::cout << "마스터 업데이트: " << master_update_count_.value() << std::endl;
+        std::cout << "시세 데이터: " << sise_count_.value() << std::endl;
+        std::cout << "호가 데이터: " << hoga_count_.value() << std::endl;
         
         if (publisher_) {
             std::cout << "연결된 클라이언트: " << publisher_->get_client_count() << std::endl;
             std::cout << "Publisher 시퀀스: " << publisher_->get_current_sequence() << std::endl;
+            for (const auto& replica : publisher_->get_replica_status()) {
+                std::cout << "Standby " << replica.client_id << ": acked " << replica.acked_seq << " (lag " << replica.lag
+                          << ", " << replica.ack_age_ms << "ms ago)" << std::endl;
+            }
+            if (publisher_->get_write_coalesce_flushes() > 0) {
+                std::cout << "Write coalescing: " << publisher_->get_write_coalesced() << " batches in "
+                          << publisher_->get_write_coalesce_flushes() << " flushes" << std::endl;
+            }
+        }
+        if (replica_ && !replica_->is_promoted()) {
+            std::cout << "Standby 복제: " << replica_->get_replicated_messages() << " (acked " << replica_->get_acked_seq()
+                      << ", primary " << (replica_->is_primary_online() ? "online" : "offline")
+                      << ", 발행 버림 " << publisher_->get_standby_dropped() << ")" << std::endl;
         }
         
         if (mq_reader_) {
             std::cout << "MQ 수신 메시지: " << mq_reader_->get_messages_received() << std::endl;
         }
+        if (shm_reader_) {
+            std::cout << "SHM 수신 메시지: " << shm_reader_->get_messages_received()
+                      << " (drop=" << shm_reader_->get_drop_count() << ")" << std::endl;
+        }
+        if (master_workers_) {
+            master_workers_->display_statistics();
+        }
         
+        // 프로세스 전체 카운터 / 히스토그램 (처리 스레드를 멈추지 않고 읽음)
+        std::cout << "--- stats snapshot ---\n" << StatsRegistry::instance().snapshot().to_string();
         std::cout << "========================\n" << std::endl;
     }
     
-    // 통계 초기화
+    // 통계 초기화 (StatsRegistry 에 등록된 프로세스 전체 카운터 / 히스토그램)
     void clear_statistics() {
-        processed_count_ = 0;
-        master_update_count_ = 0;
-        sise_count_ = 0;
-        hoga_count_ = 0;
+        StatsRegistry::instance().reset_all();
     }
     
-    // 마스터 데이터 재로드
-    void reload_master_data() {
-        if (master_manager_ && active_master_) {
-            std::cout << "마스터 데이터 재로드 중..." << std::endl;
-            // CSV 로딩은 별도 함수로 처리 (load_symbols_from_csv 참조)
-            load_symbols_from_csv();
-        }
-    }
+    // 마스터 데이터 재로드: 새 generation 을 백그라운드에서 CSV 로 채운 뒤 event loop 에서 교체한다.
+    // 이미 재로드 중이면 무시. 호출한 스레드 (scheduler / control command = event loop) 는 기다리지 않는다.
+    void reload_master_data();
     
     // Subscriber에서 TREP 데이터 처리
     void handle_trep_data_from_subscriber(DataTopic /*topic*/, const char* data, int size) {
@@ -688,9 +1297,9 @@ public:
         // process_trep_line(trep_line);
         msg_type_handlers_[static_cast<char>(MsgType::TREP_DATA)](data, size);
         */
-        std::cout << "\n\n\thandle_trep_data_from_subscriber: " << size << " bytes" << std::endl;
-        if (size < sizeof(ipc_header)) {
-            std::cerr << "메시지가 너무 작습니다: " << size << " bytes" << std::endl;
+        ALOG_DEBUG("T2MA", "handle_trep_data_from_subscriber: %d bytes", size);
+        if (size < static_cast<int>(sizeof(ipc_header))) {
+            ALOG_WARN("T2MA", "메시지가 너무 작습니다: %d bytes", size);
             return;
         }
         
@@ -699,16 +1308,10 @@ public:
         
         // 메시지 크기 검증
         if (header->_msg_size != size) {
-            std::cerr << "메시지 크기 불일치: header=" << header->_msg_size 
-                      << ", actual=" << size << std::endl;
+            ALOG_WARN("T2MA", "메시지 크기 불일치: header=%d, actual=%d", header->_msg_size, size);
             return;
         }
-        {
-            // for debug
-            std::cout << "header->_msg_type: " << header->_msg_type << std::endl;
-            std::cout << "header->_msg_size: " << header->_msg_size << std::endl;
-            
-        }
+        ALOG_DEBUG("T2MA", "header->_msg_type: %c, _msg_size: %d", header->_msg_type, header->_msg_size);
         
         // 메시지 데이터 포인터 (헤더 이후)
         const char* msg_data = data + sizeof(ipc_header);
@@ -718,13 +1321,13 @@ public:
         auto handler_it = msg_type_handlers_.find(header->_msg_type);
         if (handler_it != msg_type_handlers_.end()) {
             if(header->_msg_type != 'T') {
-                std::cerr << "메시지타입에 따른 헨들러 호출: '" << header->_msg_type 
-                          << "' (0x" << std::hex << (int)(unsigned char)header->_msg_type << ")" << std::endl;
+                ALOG_DEBUG("T2MA", "메시지타입에 따른 헨들러 호출: '%c' (0x%02x)", header->_msg_type,
+                           static_cast<unsigned>(static_cast<unsigned char>(header->_msg_type)));
             }
             handler_it->second(msg_data, msg_data_size);
         } else {
-            std::cerr << "알 수 없는 메시지 타입: '" << header->_msg_type 
-                      << "' (0x" << std::hex << (int)(unsigned char)header->_msg_type << ")" << std::endl;
+            ALOG_WARN("T2MA", "알 수 없는 메시지 타입: '%c' (0x%02x)", header->_msg_type,
+                      static_cast<unsigned>(static_cast<unsigned char>(header->_msg_type)));
         }
         
         processed_count_++;
@@ -735,13 +1338,14 @@ public:
         if (line.empty()) return;
         
         // TREP 데이터 파싱
-        auto trepData = TrepParser::parseLine(line);
+        TrepFieldList trepData;
+        TrepParser::parse(line.data(), line.size(), trepData);
         
         // RIC 코드 추출
-        auto ricIt = trepData.find("0");
-        if (ricIt == trepData.end()) return;
+        const TrepSpan* ricValue = trepData.find(0);
+        if (!ricValue) return;
         
-        std::string ric = ricIt->second;
+        std::string ric = ricValue->str();
         
         
         
@@ -765,8 +1369,8 @@ public:
         
         processed_count_++;
         
-        if (processed_count_ % config_.monitoring.log_interval == 0) {
-            std::cout << "Processed " << processed_count_ << " Japan Equity TREP messages" << std::endl;
+        if (processed_count_.local() % config_.monitoring.log_interval == 0) {
+            ALOG_INFO("T2MA", "Processed %llu Japan Equity TREP messages", static_cast<unsigned long long>(processed_count_.local()));
         }
     }
     
@@ -783,89 +1387,188 @@ public:
         if (line.empty()) return;
         
         // TREP 데이터 파싱
-        auto trepData = TrepParser::parseLine(line);
+        TrepFieldList trepData;
+        TrepParser::parse(line.data(), line.size(), trepData);
         
         // RIC 코드 추출
-        auto ricIt = trepData.find("0");
-        if (ricIt == trepData.end()) return;
+        if (!trepData.has(0)) return;
         
        
         processed_count_++;
         
         // Config에서 설정한 간격으로 처리 로그
-        if (processed_count_ % config_.monitoring.log_interval == 0) {
-            std::cout << "Processed " << processed_count_ << " TREP messages" << std::endl;
+        if (processed_count_.local() % config_.monitoring.log_interval == 0) {
+            ALOG_INFO("T2MA", "Processed %llu TREP messages", static_cast<unsigned long long>(processed_count_.local()));
         }
     }
     
     
     
     // CSV 파일에서 종목 로딩
+    // 파일을 mmap 해서 행 경계로 나눈 구간을 스레드마다 파싱하고, 레코드는 미리 잡아둔 버퍼에 바로 만든다.
+    // 적재는 bulk_load 한번으로 한다 (마스터를 비우고 행마다 조회 + put 하던 것 대신, 중복 RIC 은 먼저 나온 행이 남는다)
     bool load_symbols_from_csv() {
-        if (!active_master_) {
+        return load_symbols_from_csv(active_master_);
+    }
+
+    // CSV 파일 식별값 (경로 + 크기 + mtime 의 FNV-1a, 0 은 쓰지 않음). 파일이 없으면 0
+    uint32_t csv_signature() const {
+        struct stat st;
+        const std::string& filename = config_.files.csv_file;
+        if (stat(filename.c_str(), &st) != 0) {
+            return 0;
+        }
+        uint64_t parts[3] = {static_cast<uint64_t>(st.st_size), static_cast<uint64_t>(st.st_mtim.tv_sec),
+                             static_cast<uint64_t>(st.st_mtim.tv_nsec)};
+        uint32_t h = 2166136261u;
+        for (char c : filename) h = (h ^ static_cast<unsigned char>(c)) * 16777619u;
+        const unsigned char* p = reinterpret_cast<const unsigned char*>(parts);
+        for (size_t i = 0; i < sizeof(parts); i++) h = (h ^ p[i]) * 16777619u;
+        return h ? h : 1;
+    }
+
+    // 레코드 수는 프로세스별로 세므로 (다시 연 mmap 마스터는 0) 첫 레코드가 있는지 본다
+    static bool master_has_records(Master* master) {
+        if (master->get_record_count() > 0) {
+            return true;
+        }
+        std::unique_ptr<Master::Iterator> it = master->create_iterator();
+        return it && it->has_next();
+    }
+
+    // 시작 시 마스터 적재 (auto_load_csv). warm_restart 이고 publisher 가 정상 종료 seal 로 이어받았으며
+    // 그때 적재한 CSV 가 그대로면, mmap 마스터에 이미 CSV + 이후 TREP 갱신이 있으므로 다시 읽지 않는다
+    bool load_symbols_on_start() {
+        uint32_t generation = csv_signature();
+        if (config_.system.warm_restart && publisher_ && active_master_ && generation != 0 &&
+            publisher_->sealed_master_generation() == generation && master_has_records(active_master_)) {
+            publisher_->set_master_generation(generation);
+            std::cout << "✓ Warm restart: CSV 재적재 생략 (seq " << publisher_->get_current_sequence() << ")" << std::endl;
+            return true;
+        }
+        return load_symbols_from_csv();
+    }
+
+    // target 에 적재 (재로드 시에는 아직 공개하지 않은 새 generation)
+    bool load_symbols_from_csv(Master* target) {
+        if (!target) {
             std::cerr << "Active master not available" << std::endl;
             return false;
         }
 
-        active_master_->clear();
         std::string filename = config_.files.csv_file;
+        uint32_t generation = csv_signature();     // 읽는 도중 파일이 바뀌면 다음 시작은 다시 적재
         std::cout << "CSV 파일에서 마스터 데이터 로딩: " << filename << std::endl;
+        auto started = std::chrono::steady_clock::now();
 
-        // CSV 파일 파싱 및 Master에 데이터 로드
-        std::ifstream file(filename);
-        if (!file.is_open()) {
+        MappedCsvFile csv;
+        if (!csv.open(filename)) {
             std::cerr << "Cannot open CSV file: " << filename << std::endl;
             return false;
         }
-
-        std::string line;
-        int count = 0;
-        int inserted = 0;
+        const char* begin = csv.data();
+        const char* end = csv.end();
 
         // 헤더 스킵 (있는 경우)
-        if (std::getline(file, line)) {
-            std::cout << "CSV 헤더: " << line << std::endl;
+        const char* body = CsvParser::skip_row(begin, end);
+        if (body > begin) {
+            const char* header_end = body;
+            while (header_end > begin && (header_end[-1] == '\n' || header_end[-1] == '\r')) header_end--;
+            std::cout << "CSV 헤더: " << std::string(begin, header_end) << std::endl;
         }
 
-        while (std::getline(file, line)) {
-            if (line.empty()) continue;
+        // 행 경계로 구간 분할 -> 구간별 행 수 -> 전체 행 번호가 정해지므로 버퍼를 한번에 잡는다
+        int tasks = (size_t)(end - body) >= CSV_PARALLEL_MIN_BYTES ? bulk_load_threads(BULK_PARALLEL_MIN) : 1;
+        std::vector<const char*> bounds(tasks + 1);
+        bounds[0] = body;
+        bounds[tasks] = end;
+        for (int t = 1; t < tasks; t++) {
+            const char* at = body + (size_t)(end - body) * t / tasks;
+            const char* row = CsvParser::skip_row(at - 1, end);    // at 이 행 시작이면 그대로
+            bounds[t] = row > bounds[t - 1] ? row : bounds[t - 1];
+        }
+        std::vector<int> first_row(tasks + 1, 0);
+        bulk_parallel_tasks(tasks, [&](int t) {
+            first_row[t + 1] = (int)CsvParser::count_rows(bounds[t], bounds[t + 1]);
+        });
+        for (int t = 0; t < tasks; t++) {
+            first_row[t + 1] += first_row[t];
+        }
 
-            auto fields = CsvParser::parseLine(line);
-            if (fields.size() < 2) continue;
+        const int count = first_row[tasks];
+        const int record_size = masterLayout_->getRecordSize();
+        std::vector<char> buffers((size_t)count * record_size, 0);
+        std::vector<MasterBulkRecord> bulk(count);
+        // key 는 파일과 같은 위치에 복사하고 바로 뒤 (원래 ',' / 행 끝 자리) 를 NUL 로 만든다
+        std::unique_ptr<char[]> keys(new char[csv.size() + 1]);
 
-            std::string ric = fields[3];  // RIC_CD
-            std::string symbol = fields[4]; // SYMBOL_CD
+        const FieldHandle ric_h = masterLayout_->handle("RIC_CD");
+        const FieldHandle symbol_h = masterLayout_->handle("SYMBOL_CD");
+        const FieldHandle exchg_h = masterLayout_->handle("EXCHG_CD");
+        const FieldHandle cur_h = masterLayout_->handle("CUR_CD");
 
-            // 기본 레코드 생성
-            BinaryRecord record(masterLayout_);
-            record.setString("RIC_CD", ric);
-            if (fields.size() > 5) record.setString("SYMBOL_CD", symbol);
-            if (fields.size() > 2) record.setString("EXCHG_CD", fields[2]);
-            if (fields.size() > 3) record.setString("CUR_CD", fields[3]);
+        bulk_parallel_tasks(tasks, [&](int t) {
+            BinaryRecordView record;
+            TrepSpan fields[6];
+            const char* p = bounds[t];
+            for (int i = first_row[t]; i < first_row[t + 1]; i++) {
+                MasterBulkRecord& r = bulk[i];
+                r.pkey = nullptr;   // 필드가 모자란 행 (빈 행 포함) 은 bulk_load 가 건너뛴다
+                r.skey = nullptr;
+                r.record = nullptr;
+                r.record_size = 0;
 
-            // Primary key: RIC, Secondary key: SYMBOL.EXCHANGE 형식
-            std::string secondary_key = symbol + "." + (fields.size() > 2 ? fields[2] : "");
+                size_t n = CsvParser::next_row(p, end, fields, 6);
+                if (n < 5) continue;
 
-            if(active_master_->get_by_primary(ric.c_str()) == nullptr) {
-                if (active_master_->put(ric.c_str(), symbol.c_str(),
-                                    record.getBuffer(), record.getSize()) == 0) {
-                    inserted++;
-                }
-            }
-            count++;
+                const TrepSpan& ric = fields[3];     // RIC_CD
+                const TrepSpan& symbol = fields[4];  // SYMBOL_CD
+                char* ric_key = keys.get() + (ric.data - begin);
+                char* symbol_key = keys.get() + (symbol.data - begin);
+                memcpy(ric_key, ric.data, ric.size);
+                ric_key[ric.size] = '\0';
+                memcpy(symbol_key, symbol.data, symbol.size);
+                symbol_key[symbol.size] = '\0';
+
+                // 기본 레코드 생성
+                record.reset(&buffers[(size_t)i * record_size], record_size);
+                record.setString(ric_h, ric.data, ric.size);
+                if (n > 5) record.setString(symbol_h, symbol.data, symbol.size);
+                record.setString(exchg_h, fields[2].data, fields[2].size);
+                record.setString(cur_h, ric.data, ric.size);
 
-            if (count % 10000 == 0) {
-                std::cout << "CSV 처리 진행: " << count << "건" << std::endl;
+                // Primary key: RIC, Secondary key: SYMBOL
+                r.pkey = ric_key;
+                r.skey = symbol_key;
+                r.record = record.getBuffer();
+                r.record_size = record_size;
             }
+        });
+        auto parsed = std::chrono::steady_clock::now();
+
+        int inserted = 0;
+        int ret = target->bulk_load(bulk.data(), count, &inserted);
+        if (ret != MASTER_OK) {
+            std::cerr << "CSV 마스터 데이터 적재 실패: " << ret << std::endl;
+            return false;
         }
 
-        std::cout << "✓ CSV 마스터 데이터 로드 완료: " << count << "건 처리, " << inserted << "건 저장" << std::endl;
+        auto ms = [](std::chrono::steady_clock::duration d) {
+            return std::chrono::duration_cast<std::chrono::milliseconds>(d).count();
+        };
+        std::cout << "✓ CSV 마스터 데이터 로드 완료: " << count << "건 처리, " << inserted << "건 저장 (parse "
+                  << ms(parsed - started) << "ms / " << tasks << " threads, load "
+                  << ms(std::chrono::steady_clock::now() - parsed) << "ms)" << std::endl;
+        if (publisher_) {
+            publisher_->set_master_generation(generation);
+        }
         return true;
     }
     
     void run() {
         running_ = true;
         std::cout << "\n\n\tT2MA System running...\n\n" << std::endl;
+        start_pipeline_reader();
         
         // 일단 여기서 publisher 에 연결시도
         for(auto& subscriber: subscribers_) {
@@ -880,12 +1583,62 @@ public:
             #endif
             subscriber->try_reconnect();
         }
+        if (subscriber_group_) {
+            for (size_t i = 0; i < subscriber_group_->size(); ++i) {
+                subscriber_group_->subscriber(i)->try_reconnect();
+            }
+        }
         // 이벤트 루프 실행
+        if (config_.system.event_loop_mode == "SPIN") {
+            run_spin_loop();
+            return;
+        }
         while (running_) {
             event_base_loop(event_base_, EVLOOP_ONCE);
         }
     }
     
+    // epoll 에서 잠들지 않고 EVLOOP_NONBLOCK 을 반복 (wakeup 지연 제거)
+    // spin_idle_us 동안 처리한 것이 없으면 EVLOOP_ONCE 로 한번 잠들고 (MQ fd / ring eventfd 가 깨움) 다시 spin
+    void run_spin_loop() {
+        if (config_.system.spin_cpu >= 0) {
+            cpu_set_t cpuset;
+            CPU_ZERO(&cpuset);
+            CPU_SET(config_.system.spin_cpu, &cpuset);
+            int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset);
+            if (rc != 0) {
+                std::cerr << "Failed to pin event loop to cpu " << config_.system.spin_cpu << ": " << strerror(rc) << std::endl;
+            }
+        }
+        std::cout << "Event loop: SPIN (idle " << config_.system.spin_idle_us << "us, cpu " << config_.system.spin_cpu
+                  << ", poll source " << (config_.system.spin_poll_source ? "on" : "off") << ")" << std::endl;
+        
+        const std::chrono::microseconds idle_limit(config_.system.spin_idle_us);
+        auto last_active = std::chrono::steady_clock::now();
+        uint64_t last_processed = processed_count_.local();
+        uint64_t idle_sleeps = 0;
+        while (running_) {
+            size_t polled = 0;
+            if (config_.system.spin_poll_source) {
+                if (mq_reader_) polled += mq_reader_->poll();
+                if (shm_reader_) polled += shm_reader_->poll();
+            }
+            event_base_loop(event_base_, EVLOOP_NONBLOCK);
+            
+            if (polled > 0 || processed_count_.local() != last_processed) {
+                last_processed = processed_count_.local();
+                last_active = std::chrono::steady_clock::now();
+                continue;
+            }
+            if (config_.system.spin_idle_us > 0 && std::chrono::steady_clock::now() - last_active >= idle_limit) {
+                idle_sleeps++;
+                event_base_loop(event_base_, EVLOOP_ONCE);
+                last_active = std::chrono::steady_clock::now();
+            }
+        }
+        std::cout << "Event loop: SPIN stopped (" << idle_sleeps << " idle sleeps)" << std::endl;
+    }
+    
     void stop() {
         running_ = false;
         std::cout << "Stopping T2MA System..." << std::endl;
@@ -893,6 +1646,9 @@ public:
         if (mq_reader_) {
             mq_reader_->stop();
         }
+        if (shm_reader_) {
+            shm_reader_->stop();
+        }
         
         if (publisher_) {
             publisher_->stop();
@@ -901,21 +1657,45 @@ public:
         for (auto& subscriber : subscribers_) {
             subscriber->stop();
         }
+        if (subscriber_group_) {
+            subscriber_group_->stop();
+        }
+        if (replica_ && !replica_->is_promoted()) {
+            replica_->subscriber()->stop();
+        }
         
         if (event_base_) {
             event_base_loopbreak(event_base_);
         }
+        reload_cv_.notify_all();
+        AsyncLogger::instance().flush();
     }
     
     void cleanup() {
         stop();
+        // loop 가 끝난 뒤 worker 정리 (stop 은 signal 등 다른 스레드에서도 불린다)
+        if (master_workers_) {
+            master_workers_->stop();
+            master_workers_.reset();
+            master_worker_group_ = -1;
+        }
+        cleanup_pipeline();
+        cleanup_master_reload();
 
         // Cleanup schedulers
         cleanup_schedulers();
+        timer_wheel_.reset();
 
         subscribers_.clear();
+        subscriber_group_.reset();
+        if (promote_signal_) {
+            event_free(promote_signal_);
+            promote_signal_ = nullptr;
+        }
+        replica_.reset();
         publisher_.reset();
         mq_reader_.reset();
+        shm_reader_.reset();
         master_manager_.reset();
 
         if (event_base_) {
@@ -924,6 +1704,9 @@ public:
         }
     }
 
+    // 상속 클래스의 종목별 타이머 (stale 감지 등) 용
+    TimerWheel* timer_wheel() { return timer_wheel_.get(); }
+
     // Scheduler 설정 헬퍼 메소드 (moved from T2MA_JAPAN_EQUITY)
     const std::vector<T2MAConfig::SchedulerItem>& getSchedulers() const {
         return config_.schedulers_ext;
@@ -1,4 +1,5 @@
 #include "T2MA_JAPAN_EQUITY.h"
+#include "TrepIngest.h"
 
 // Factory function for creating T2MA_JAPAN_EQUITY instances
 extern "C" T2MASystem* create_t2ma_japan_equity(const T2MAConfig& config) {
@@ -16,6 +17,13 @@ extern "C" void destroy_t2ma_japan_equity(T2MASystem* instance) {
 #include <cstring>
 #include <regex>
 #include <event2/event.h>
+#include <strings.h>
+
+// RAFR_JAPANEQUITYTREP2MAST 에서 가져온 FID
+#define JAPAN_FID_CLOSE_PRC     3372    // 종가 (체결 없이 오면 종가로 체결 보정)
+#define JAPAN_FID_SAL_TM        379     // 체결시간
+#define JAPAN_FID_SISE_HOGA_MSG 99997   // "S": 시세 메시지 (refresh 첫 수신 시 마스터 분배)
+#define JAPAN_CLOSE_SAL_TM      "060000"    // 종가만 오고 체결시간이 없을 때 (GMT, 15:00 KST)
 
 T2MA_JAPAN_EQUITY::T2MA_JAPAN_EQUITY(const T2MAConfig& config) : T2MASystem(config) {
     std::cout << "=== T2MA_JAPAN_EQUITY 초기화 시작 ===" << std::endl;
@@ -50,34 +58,226 @@ T2MA_JAPAN_EQUITY::~T2MA_JAPAN_EQUITY() {
 
 void T2MA_JAPAN_EQUITY::handle_trep_data_message(const char* data, size_t size) {
     std::cout << "T2MA_JAPAN_EQUITY::handle_trep_data_message called with size: " << size << std::endl;
-    std::string trep_line(data, size);
-    std::cout << "TREP DATA : " << trep_line << std::endl;
-
-    if (trep_line.empty()) return;
+    if (!data || size == 0) return;
+    std::cout << "TREP DATA : ";
+    std::cout.write(data, size) << std::endl;
         
-    // TREP 데이터 파싱
-    auto trepData = TrepParser::parseLine(trep_line);
+    // TREP 데이터 파싱 (메시지 버퍼를 그대로 토큰화, 필드 목록은 멤버 재사용)
+    TrepFieldList& trepData = loop_state_.trep_fields;
+    {
+        LatencyScope scope(latency_ ? &latency_->parse : nullptr);
+        TrepParser::parse(data, size, trepData);
+    }
     
     // RIC 코드 추출
-    auto ricIt = trepData.find("0");
-    if (ricIt == trepData.end()) {
+    const TrepSpan* ricValue = trepData.find(0);
+    if (!ricValue) {
         std::cout <<  "can not find ric fid " << std::endl;
         return;
     }
     
-    std::string ric = ricIt->second;
+    // 마스터 갱신 worker 가 있으면 RIC partition 으로 넘기고 (worker 에서 다시 파싱) loop 는 다음 메시지로
+    if (master_workers_enabled()) {
+        submit_master_work(ricValue->data, ricValue->size, data, size);
+        return;
+    }
+    
+    loop_state_.ric.assign(ricValue->data, ricValue->size);
     
     // 1. 일본 주식 마스터 업데이트
-    update_japan_equity_master(ric, trepData);
+    {
+        LatencyScope scope(latency_ ? &latency_->master_update : nullptr);
+        update_japan_equity_master(active_master_, loop_state_, loop_state_.ric, trepData);
+    }
     master_update_count_++;
     processed_count_++;
 }
 
-// 일본 주식 마스터 업데이트 (RAFR 코드 기반)
-void T2MA_JAPAN_EQUITY::update_japan_equity_master(const std::string& ric, const std::map<std::string, std::string>& trepData) {
-    BinaryRecord record(masterLayout_);
+// 마스터 갱신 worker 스레드 (같은 RIC 은 항상 같은 partition, master 는 현재 generation)
+void T2MA_JAPAN_EQUITY::handle_master_work(MasterWorkerContext& ctx, Master* master, const char* data, size_t size) {
+    WorkState& state = *worker_states_[ctx.partition()];
+    state.ctx = &ctx;
     
-    char* result = active_master_->get_by_primary(ric.c_str());
+    TrepFieldList& trepData = state.trep_fields;
+    {
+        LatencyScope scope(latency_ ? &latency_->parse : nullptr);
+        TrepParser::parse(data, size, trepData);
+    }
+    const TrepSpan* ricValue = trepData.find(0);
+    if (!ricValue) return;
+    state.ric.assign(ricValue->data, ricValue->size);
+    
+    {
+        LatencyScope scope(latency_ ? &latency_->master_update : nullptr);
+        update_japan_equity_master(master, state, state.ric, trepData);
+    }
+    master_update_count_++;
+    processed_count_++;
+}
+
+void T2MA_JAPAN_EQUITY::init_work_state(WorkState& state) {
+    state.local_time = local_time_;
+    state.sise_record.reset(new BinaryRecord(siseLayout_));
+    state.dirty.reset(masterLayout_->getFields().size());
+}
+
+// 레이아웃 필드 핸들 준비 (layout 은 T2MASystem::initialize 에서 로드됨)
+bool T2MA_JAPAN_EQUITY::resolve_field_handles() {
+    if (!masterLayout_ || !siseLayout_) {
+        std::cerr << "마스터/체결 레이아웃이 없어 필드 핸들을 만들 수 없습니다" << std::endl;
+        return false;
+    }
+    
+    // 없는 필드는 쓰기/읽기가 무시되므로 (기존 이름 lookup 과 동일) 경고만 출력
+    auto resolve = [](const std::shared_ptr<RecordLayout>& layout, const char* name) {
+        FieldHandle h = layout->handle(name);
+        if (!h.valid()) {
+            std::cerr << "WARNING: " << layout->getRecordType() << " 레이아웃에 " << name << " 필드가 없습니다" << std::endl;
+        }
+        return h;
+    };
+    
+    MasterFields& mf = master_fields_;
+    mf.symbol_cd   = resolve(masterLayout_, "SYMBOL_CD");
+    mf.trd_dt      = resolve(masterLayout_, "TRD_DT");
+    mf.trd_prc     = resolve(masterLayout_, "TRD_PRC");
+    mf.high_prc    = resolve(masterLayout_, "HIGH_PRC");
+    mf.low_prc     = resolve(masterLayout_, "LOW_PRC");
+    mf.open_prc    = resolve(masterLayout_, "OPEN_PRC");
+    mf.close_prc   = resolve(masterLayout_, "CLOSE_PRC");
+    mf.base_prc    = resolve(masterLayout_, "BASE_PRC");
+    mf.bid_prc     = resolve(masterLayout_, "BID_PRC");
+    mf.ask_prc     = resolve(masterLayout_, "ASK_PRC");
+    mf.bid_size    = resolve(masterLayout_, "BID_SIZE");
+    mf.ask_size    = resolve(masterLayout_, "ASK_SIZE");
+    mf.trd_vol     = resolve(masterLayout_, "TRD_VOL");
+    mf.svol        = resolve(masterLayout_, "SVOL");
+    mf.samt        = resolve(masterLayout_, "SAMT");
+    mf.net_chng    = resolve(masterLayout_, "NET_CHNG");
+    mf.pct_chng    = resolve(masterLayout_, "PCT_CHNG");
+    mf.uplimit     = resolve(masterLayout_, "UPLIMIT");
+    mf.dnlimit     = resolve(masterLayout_, "DNLIMIT");
+    mf.local_tm    = resolve(masterLayout_, "LOCAL_TM");
+    mf.sal_tm      = resolve(masterLayout_, "SAL_TM");
+    mf.open_prc_tm = resolve(masterLayout_, "OPEN_PRC_TM");
+    mf.high_prc_tm = resolve(masterLayout_, "HIGH_PRC_TM");
+    mf.low_prc_tm  = resolve(masterLayout_, "LOW_PRC_TM");
+    mf.update_count      = resolve(masterLayout_, "UPDATE_COUNT");
+    mf.send_master_max   = resolve(masterLayout_, "SEND_MASTER_MAX");
+    mf.send_master_count = resolve(masterLayout_, "SEND_MASTER_COUNT");
+    mf.dist_flag         = resolve(masterLayout_, "DIST_FLAG");
+    
+    SiseFields& sf = sise_fields_;
+    sf.data_gb            = resolve(siseLayout_, "DATA_GB");
+    sf.info_gb            = resolve(siseLayout_, "INFO_GB");
+    sf.mkt_gb             = resolve(siseLayout_, "MKT_GB");
+    sf.exchg_cd           = resolve(siseLayout_, "EXCHG_CD");
+    sf.trans_tm           = resolve(siseLayout_, "TRANS_TM");
+    sf.ric_cd             = resolve(siseLayout_, "RIC_CD");
+    sf.symbol_cd          = resolve(siseLayout_, "SYMBOL_CD");
+    sf.local_dt           = resolve(siseLayout_, "LOCAL_DT");
+    sf.local_tm           = resolve(siseLayout_, "LOCAL_TM");
+    sf.kor_dt             = resolve(siseLayout_, "KOR_DT");
+    sf.kor_tm             = resolve(siseLayout_, "KOR_TM");
+    sf.open_prc           = resolve(siseLayout_, "OPEN_PRC");
+    sf.high_prc           = resolve(siseLayout_, "HIGH_PRC");
+    sf.low_prc            = resolve(siseLayout_, "LOW_PRC");
+    sf.trd_prc            = resolve(siseLayout_, "TRD_PRC");
+    sf.net_chng_sign      = resolve(siseLayout_, "NET_CHNG_SIGN");
+    sf.net_chng           = resolve(siseLayout_, "NET_CHNG");
+    sf.pct_chng           = resolve(siseLayout_, "PCT_CHNG");
+    sf.open_prc_tm        = resolve(siseLayout_, "OPEN_PRC_TM");
+    sf.high_prc_tm        = resolve(siseLayout_, "HIGH_PRC_TM");
+    sf.low_prc_tm         = resolve(siseLayout_, "LOW_PRC_TM");
+    sf.bid_prc            = resolve(siseLayout_, "BID_PRC");
+    sf.ask_prc            = resolve(siseLayout_, "ASK_PRC");
+    sf.bid_size           = resolve(siseLayout_, "BID_SIZE");
+    sf.ask_size           = resolve(siseLayout_, "ASK_SIZE");
+    sf.trd_vol            = resolve(siseLayout_, "TRD_VOL");
+    sf.svol               = resolve(siseLayout_, "SVOL");
+    sf.samt               = resolve(siseLayout_, "SAMT");
+    sf.session_gb         = resolve(siseLayout_, "SESSION_GB");
+    sf.trand_gb           = resolve(siseLayout_, "TRAND_GB");
+    sf.trd_gb             = resolve(siseLayout_, "TRD_GB");
+    sf.aftmkt_prc         = resolve(siseLayout_, "AFTMKT_PRC");
+    sf.ttype              = resolve(siseLayout_, "TTYPE");
+    sf.base_net_chng_sign = resolve(siseLayout_, "BASE_NET_CHNG_SIGN");
+    sf.base_net_chng      = resolve(siseLayout_, "BASE_NET_CHNG");
+    sf.base_pct_chng      = resolve(siseLayout_, "BASE_PCT_CHNG");
+    sf.filler             = resolve(siseLayout_, "FILLER");
+    sf.ff                 = resolve(siseLayout_, "FF");
+    
+    // GMT -> local offset: timezone 이 있으면 어제부터 400일의 DST 전환을 미리 계산
+    local_time_.set_fixed(config_.fid_map.gmt_offset);
+    if (!config_.fid_map.timezone.empty()) {
+        int64_t from = static_cast<int64_t>(time(nullptr)) - 86400;
+        if (local_time_.load_zone(config_.fid_map.timezone, from, 400)) {
+            std::cout << "시간대 " << config_.fid_map.timezone << ": 현재 offset " << local_time_.offset_at(from + 86400)
+                      << "초, 전환 " << local_time_.transition_count() << "회" << std::endl;
+        } else {
+            std::cerr << "WARNING: fid_map.timezone 을 찾을 수 없어 gmt_offset(" << config_.fid_map.gmt_offset
+                      << ") 을 사용합니다: " << config_.fid_map.timezone << std::endl;
+        }
+    }
+    
+    init_work_state(loop_state_);
+    worker_states_.clear();
+    if (master_workers_) {
+        for (int i = 0; i < master_workers_->partition_count(master_worker_group_); i++) {
+            worker_states_.emplace_back(new WorkState());
+            init_work_state(*worker_states_.back());
+        }
+    }
+    
+    // config 에 fid_map.master 가 없으면 기존 RAFR 매핑을 그대로 사용
+    auto mapIt = config_.fid_map.layouts.find("master");
+    const std::map<int, std::string>& masterSpecs =
+        (mapIt != config_.fid_map.layouts.end()) ? mapIt->second : default_master_fid_map();
+    size_t mapped = master_fid_map_.compile(*masterLayout_, masterSpecs);
+    std::cout << "마스터 FID 매핑 " << mapped << "개 컴파일"
+              << (mapIt != config_.fid_map.layouts.end() ? "" : " (기본 매핑)") << std::endl;
+    
+    master_delta_topic_ = static_cast<DataTopic>(0);
+    if (!config_.fid_map.master_delta_topic.empty()) {
+        master_delta_topic_ = TopicRegistry::global().find(config_.fid_map.master_delta_topic);
+        if (master_delta_topic_ == 0) {
+            std::cerr << "WARNING: fid_map.master_delta_topic 토픽이 없습니다: " << config_.fid_map.master_delta_topic << std::endl;
+        } else {
+            std::cout << "마스터 delta 송신 토픽: " << config_.fid_map.master_delta_topic << std::endl;
+        }
+    }
+    return true;
+}
+
+// 일본 주식 기본 FID 매핑 (RAFR 코드 기반, config 에 fid_map 이 없을 때)
+const std::map<int, std::string>& T2MA_JAPAN_EQUITY::default_master_fid_map() {
+    static const std::map<int, std::string> specs = {
+        {6,     "TRD_PRC|changed"},             // 현재가
+        {12,    "HIGH_PRC|stamp=HIGH_PRC_TM"},  // 고가
+        {13,    "LOW_PRC|stamp=LOW_PRC_TM"},    // 저가
+        {19,    "OPEN_PRC|stamp=OPEN_PRC_TM"},  // 시가
+        {22,    "BID_PRC"},                     // 매수호가
+        {25,    "ASK_PRC"},                     // 매도호가
+        {30,    "BID_SIZE"},                    // 매수잔량
+        {31,    "ASK_SIZE"},                    // 매도잔량
+        {178,   "TRD_VOL"},                     // 체결량
+        {32,    "SVOL|changed"},                // 누적거래량
+        {11,    "NET_CHNG"},                    // 전일대비
+        {56,    "PCT_CHNG"},                    // 등락률
+        {3372,  "CLOSE_PRC|updated"},           // 종가
+        {1465,  "BASE_PRC"},                    // 기준가
+        {75,    "UPLIMIT"},                     // 상한가
+        {76,    "DNLIMIT"},                     // 하한가
+        {18,    "LOCAL_TM"},                    // 로컬시간
+        {379,   "SAL_TM"},                      // 체결시간
+        {32741, "SAMT"},                        // 누적거래대금
+    };
+    return specs;
+}
+
+// 일본 주식 마스터 업데이트 (RAFR 코드 기반)
+void T2MA_JAPAN_EQUITY::update_japan_equity_master(Master* master, WorkState& state, const std::string& ric, const TrepFieldList& trepData) {
+    char* result = master->get_by_primary(ric.c_str());
     if (!result) {
         std::cout << "일본 주식 마스터에 없는 RIC: " << ric << std::endl;
         /* 마스터 추가 기능 주석처리
@@ -99,199 +299,229 @@ void T2MA_JAPAN_EQUITY::update_japan_equity_master(const std::string& ric, const
         */
         return ;
     }
-    record.setBuffer(result, false);
+    // 마스터 버퍼를 그대로 감싸서 제자리 갱신 (레코드 버퍼 할당 / layout 참조 카운트 없음)
+    BinaryRecordView record(*masterLayout_, result);
+    const MasterFields& mf = master_fields_;
+    // 마스터 레코드를 제자리에서 갱신하므로 read_by_primary 하는 reader가 재시도할 수 있도록 표시
+    master->begin_record_update(result);
 
     // int trd_unit = record.getInt("TRD_UNIT"); // 사용하지 않으므로 주석처리
     
-    bool svol_changed = false;
-    bool trd_prc_changed = false;
-    bool close_prc_updated = false;
-    // 일본 주식 TREP FID 매핑 (RAFR 코드 기반)
-    for (const auto& pair : trepData) {
-        const std::string& fid = pair.first;
-        const std::string& value = pair.second;
-        
-        if (value == "blank" || value.empty()) continue;
-        
-        // RAFR 코드의 FID 매핑 따름
-        if (fid == "6") {          // 현재가 (일본 TREP)
-            if(record.getString("TRD_PRC") != value) {
-                record.setString("TRD_PRC", value);
-                trd_prc_changed = true;
-                std::cout << ric << " trd_prc: " << value << " :: " << record.getString("TRD_PRC") << std::endl;
-            }
-            std::cout << "\n\n\t\tMASTER TRD_PRC:" << record.getString("TRD_PRC") << " trep TRD_PRC:" << value << "\n\n" << std::endl;
-        } else if (fid == "12") {  // 고가 (일본)
-            record.setString("HIGH_PRC", value);
-        } else if (fid == "13") {  // 저가 (일본)
-            record.setString("LOW_PRC", value);
-        } else if (fid == "19") {  // 시가 (일본)
-            record.setString("OPEN_PRC", value);
-        } else if (fid == "22") {  // 매수호가 (일본)
-            record.setString("BID_PRC", value);
-        } else if (fid == "25") {  // 매도호가 (일본)
-            record.setString("ASK_PRC", value);
-        } else if (fid == "30") {  // 매수잔량
-            record.setString("BID_SIZE", value);
-        } else if (fid == "31") {  // 매도잔량
-            record.setString("ASK_SIZE", value);
-        } else if (fid == "178") { // 체결량 (일본)
-            record.setString("TRD_VOL", value);
-        } else if (fid == "32") {  // 누적거래량 SVOL
-            if(record.getString("SVOL") != value) {
-                record.setString("SVOL", value);
-                svol_changed =  true;
-            }
-        } else if (fid == "11") {  // 전일대비 (일본)
-            record.setString("NET_CHNG", value);
-        } else if (fid == "56") {  // 등락률 (일본)
-            record.setString("PCT_CHNG", value);
-        } else if (fid == "3372") { // 종가 (일본)
-            record.setString("CLOSE_PRC", value);
-            close_prc_updated = true;
-        } else if (fid == "1465") { // 기준가
-            record.setString("BASE_PRC", value);
-        } else if (fid == "75") {   // 상한가
-            record.setString("UPLIMIT", value);
-        } else if (fid == "76") {   // 하한가
-            record.setString("DNLIMIT", value);
-        } else if (fid == "18") {   // 로컬시간
-            record.setString("LOCAL_TM", value);
-        } else if (fid == "379") {  // 체결시간
-            record.setString("SAL_TM", value);
-        } else if (fid == "32741") {    // 누적거래대금
-            record.setString("SAMT", value);
+    // FID 99999 (REFRESH/UPDATE). 없으면 update 로 본다
+    const TrepSpan* dataType = trepData.find(TREP_INGEST_DATATYPE_FID);
+    bool refresh = dataType && dataType->size >= 7 && strncasecmp(dataType->data, "REFRESH", 7) == 0;
+    
+    // fid_map 테이블로 한번에 반영 (changed/updated 옵션 필드가 체결 송신 trigger)
+    // 값이 같은 필드는 쓰지 않고, 바뀐 필드는 state.dirty 에 표시
+    state.dirty.clear();
+    FidApplyResult applied = master_fid_map_.apply(trepData, record, &state.dirty);
+
+    // refresh 는 마스터만 채운다 (시가/고가/저가 시각, 체결 송신 없음 - RAFR isUpdateData)
+    bool send_sise = applied.trigger && !refresh;
+    if (!refresh && applied.stamp_count > 0) {
+        const char* local_tm = state.local_time.local_hms(record.getInt(mf.sal_tm));
+        for (size_t i = 0; i < applied.stamp_count; ++i) {
+            record.updateString(*applied.stamps[i], local_tm, 6, &state.dirty);
         }
     }
+    if (send_sise && !state.dirty.test(mf.trd_prc.index) && !state.dirty.test(mf.svol.index) &&
+        trepData.find(JAPAN_FID_CLOSE_PRC)) {
+        apply_close_without_trade(state, record, trepData);
+    }
+    if (refresh) {
+        send_master_on_refresh(state, record, trepData);
+    }
+    if (refresh || send_sise) {
+        char count[16];
+        int n = snprintf(count, sizeof(count), "%d", record.getInt(mf.update_count) + 1);
+        record.updateString(mf.update_count, count, static_cast<size_t>(n), &state.dirty);
+    }
+    master->end_record_update(result);
+    std::cout << " changed : " << applied.trigger << " applied=" << applied.applied
+              << " dirty=" << state.dirty.count() << std::endl;
+    if (master_delta_topic_ != 0 && !state.dirty.empty()) {
+        send_master_delta(state, ric, record);
+    }
+    if(send_sise) {
+        send_japan_sise_data(state, ric, record, trepData);
+    }
+}
 
-    if(trepData.find("19") != trepData.end()) {
-        std::string local_tm = set_time(record.getInt("SAL_TM"), 9*60*60);
-        record.setString("OPEN_PRC_TM", local_tm);
+// 당일 첫 refresh 의 시세 메시지 (FID 99997 == "S") 면 마스터 전체를 한번 분배한다 (RAFR process_master_outfile).
+// 파일 대신 master_delta_topic 으로 모든 필드를 보낸다. record_update 구간 안에서 호출.
+bool T2MA_JAPAN_EQUITY::send_master_on_refresh(WorkState& state, BinaryRecordView& record, const TrepFieldList& trepData) {
+    const MasterFields& mf = master_fields_;
+    if (record.getInt(mf.send_master_max) < 1 || record.getInt(mf.send_master_count) != 0) {
+        return false;
     }
-    if(trepData.find("12") != trepData.end()) {
-        std::string local_tm = set_time(record.getInt("SAL_TM"), 9*60*60);
-        record.setString("HIGH_PRC_TM", local_tm);
+    const TrepSpan* siseMsg = trepData.find(JAPAN_FID_SISE_HOGA_MSG);
+    if (!siseMsg || siseMsg->is_blank() || !siseMsg->equals("S", 1)) {
+        return false;
     }
-    if(trepData.find("13") != trepData.end()) {
-        std::string local_tm = set_time(record.getInt("SAL_TM"), 9*60*60);
-        record.setString("LOW_PRC_TM", local_tm);
+    
+    record.updateString(mf.dist_flag, "Y", 1, &state.dirty);
+    char count[16];
+    int n = snprintf(count, sizeof(count), "%d", record.getInt(mf.send_master_count) + 1);
+    record.updateString(mf.send_master_count, count, static_cast<size_t>(n), &state.dirty);
+    
+    // delta 가 전체 레코드가 되도록 모든 필드를 dirty 로
+    for (size_t i = 0; i < masterLayout_->getFields().size(); i++) {
+        state.dirty.mark(static_cast<int>(i));
     }
-    std::cout << " changed : " << trd_prc_changed << svol_changed << close_prc_updated << std::endl;
-    if(trd_prc_changed || svol_changed) {
-        send_japan_sise_data(ric, trepData);
-    } else if(close_prc_updated) {
-        send_japan_sise_data(ric, trepData);
+    return true;
+}
+
+// 체결 없이 종가만 온 update (장 종료): 체결시간이 없으면 15:00 KST, 누적거래량이 그대로면 체결량 0,
+// 현재가는 종가, 전일대비 0 으로 맞춰 체결로 보낸다 (RAFR "Ending without trade")
+void T2MA_JAPAN_EQUITY::apply_close_without_trade(WorkState& state, BinaryRecordView& record, const TrepFieldList& trepData) {
+    const MasterFields& mf = master_fields_;
+    if (!trepData.find(JAPAN_FID_SAL_TM)) {
+        record.updateString(mf.sal_tm, JAPAN_CLOSE_SAL_TM, strlen(JAPAN_CLOSE_SAL_TM), &state.dirty);
+    }
+    if (!state.dirty.test(mf.svol.index)) {
+        record.updateString(mf.trd_vol, "0", 1, &state.dirty);
+    }
+    record.updateString(mf.trd_prc, record.getValue(mf.close_prc), &state.dirty);
+    record.updateString(mf.net_chng, "0", 1, &state.dirty);
+}
+
+// 마스터에서 바뀐 필드만 RecordDelta 로 송신 (fid_map.master_delta_topic 구독자용)
+void T2MA_JAPAN_EQUITY::send_master_delta(WorkState& state, const std::string& ric, const BinaryRecordView& masterRecord) {
+    size_t capacity = RecordDelta::max_encoded_size(*masterLayout_, ric.size());
+    if (state.delta_buf.size() < capacity) {
+        state.delta_buf.resize(capacity);
+    }
+    size_t size = RecordDelta::encode(*masterLayout_, masterRecord, state.dirty, ric.data(), ric.size(),
+                                      state.delta_buf.data(), state.delta_buf.size());
+    if (size == 0) {
+        return;
+    }
+    if (state.ctx) {
+        state.ctx->emit(static_cast<int>(master_delta_topic_), state.delta_buf.data(), size);
+    } else if (publisher_) {
+        publisher_->publish(master_delta_topic_, state.delta_buf.data(), size);
     }
 }
 
 // 일본 주식 체결 데이터 송신 (RAFR process_sise_outfile 기반)
-void T2MA_JAPAN_EQUITY::send_japan_sise_data(const std::string& ric, const std::map<std::string, std::string>& trepData) {
-    BinaryRecord siseRecord(siseLayout_);
+// masterRecord 는 방금 갱신한 마스터 레코드 (이 RIC 의 writer 스레드이므로 복사 없이 제자리에서 읽는다)
+void T2MA_JAPAN_EQUITY::send_japan_sise_data(WorkState& state, const std::string& ric, const BinaryRecordView& masterRecord, const TrepFieldList& trepData) {
+    BinaryRecord& siseRecord = *state.sise_record;
+    const MasterFields& mf = master_fields_;
+    const SiseFields& sf = sise_fields_;
     
-    BinaryRecord masterRecord(masterLayout_);
+    // 재사용 버퍼이므로 매번 새 레코드처럼 비운다
+    siseRecord.clear();
     
-    char* masterResult = active_master_->get_by_primary(ric.c_str());
-    if (!masterResult) {
-        std::cout << "일본 주식 마스터에 없는 RIC: " << ric << std::endl;
+    siseRecord.setString(sf.data_gb, "A3");
+    siseRecord.setString(sf.info_gb, "22");
+    siseRecord.setString(sf.mkt_gb, "B");
+    siseRecord.setString(sf.exchg_cd, "TYO");
+    siseRecord.setString(sf.trans_tm, state.trans_tm.get());
+
+    siseRecord.setString(sf.ric_cd, ric);
+    siseRecord.copyField(sf.symbol_cd, masterRecord, mf.symbol_cd);
+    
+    // TRD_DT(YYYYMMDD), SAL_TM(hhmmss) 은 스냅샷 버퍼에서 바로 읽는다
+    char* local_dt = const_cast<char*>(masterRecord.data(mf.trd_dt));
+    char* local_tm = const_cast<char*>(masterRecord.data(mf.sal_tm));
+    if (!local_dt || !local_tm) {
+        std::cerr << "마스터 레이아웃에 TRD_DT/SAL_TM 필드가 없습니다" << std::endl;
         return ;
     }
+    const char* local_ymd = nullptr;
+    const char* local_hms = nullptr;
+    if (!state.local_time.convert(local_dt, local_tm, &local_ymd, &local_hms)) {
+        // 숫자가 아닌 값 (공백 등) 은 기존 변환 결과를 그대로 유지
+        static thread_local std::string fallback_ymd, fallback_hms;
+        fallback_ymd = cvt_gmt2local_ymd2(local_dt, local_tm, nullptr, config_.fid_map.gmt_offset);
+        fallback_hms = set_time(masterRecord.getInt(mf.sal_tm), config_.fid_map.gmt_offset);
+        local_ymd = fallback_ymd.c_str();
+        local_hms = fallback_hms.c_str();
+    }
+    siseRecord.setString(sf.local_dt, local_ymd);
+    siseRecord.setString(sf.local_tm, local_hms);
+    siseRecord.setString(sf.kor_dt, local_ymd);
+    siseRecord.setString(sf.kor_tm, local_hms);
     
-    siseRecord.setString("DATA_GB", "A3");
-    siseRecord.setString("INFO_GB", "22");
-    siseRecord.setString("MKT_GB", "B");
-    siseRecord.setString("EXCHG_CD", "TYO");
-    siseRecord.setString("TRANS_TM", getDateTime());
-
-    siseRecord.setString("RIC_CD", ric);
-    siseRecord.setString("SYMBOL_CD", masterRecord.getString("SYMBOL_CD"));
-    int trd_dt = masterRecord.getInt("TRD_DT");
-    // std::cout << "TRD_DT : " << trd_dt << std::endl;
-    
-    const char *local_dt = masterRecord.getString("TRD_DT").c_str();
-    const char *local_tm = masterRecord.getString("SAL_TM").c_str();
-    siseRecord.setString("LOCAL_DT", cvt_gmt2local_ymd2((char*)local_dt, (char*)local_tm, nullptr, 32400));
-    siseRecord.setString("LOCAL_TM", set_time(atoi(local_tm), 32400 /*9시*/));
-    siseRecord.setString("KOR_DT", cvt_gmt2local_ymd2((char*)local_dt, (char*)local_tm, nullptr, 32400));
-    siseRecord.setString("KOR_TM", set_time(atoi(local_tm), 32400 /*9시*/));
-    
-    siseRecord.setString("OPEN_PRC", masterRecord.getString("OPEN_PRC"));
-    siseRecord.setString("HIGH_PRC", masterRecord.getString("HIGH_PRC"));
-    siseRecord.setString("LOW_PRC", masterRecord.getString("LOW_PRC"));
-    siseRecord.setString("TRD_PRC", masterRecord.getString("TRD_PRC"));
-
-    double net_chng = masterRecord.getDouble("NET_CHNG");
-    double pct_chng = masterRecord.getDouble("PCT_CHNG");
-    double trd_prc = masterRecord.getDouble("TRD_PRC");
+    siseRecord.copyField(sf.open_prc, masterRecord, mf.open_prc);
+    siseRecord.copyField(sf.high_prc, masterRecord, mf.high_prc);
+    siseRecord.copyField(sf.low_prc, masterRecord, mf.low_prc);
+    siseRecord.copyField(sf.trd_prc, masterRecord, mf.trd_prc);
+
+    double net_chng = masterRecord.getDouble(mf.net_chng);
+    double pct_chng = masterRecord.getDouble(mf.pct_chng);
+    double trd_prc = masterRecord.getDouble(mf.trd_prc);
     if(net_chng == 0 || trd_prc == 0) {
-        siseRecord.setString("NET_CHNG_SIGN", "3");
-        siseRecord.setDouble("NET_CHNG", net_chng);
-        siseRecord.setDouble("PCT_CHNG", pct_chng);
+        siseRecord.setString(sf.net_chng_sign, "3");
+        siseRecord.setDouble(sf.net_chng, net_chng);
+        siseRecord.setDouble(sf.pct_chng, pct_chng);
     } else if(net_chng > 0) {
-        double uplimit = masterRecord.getDouble("UPLIMIT");
+        double uplimit = masterRecord.getDouble(mf.uplimit);
         if(trd_prc >= uplimit && uplimit > 0) {
-            siseRecord.setString("NET_CHNG_SIGN", "1");
+            siseRecord.setString(sf.net_chng_sign, "1");
         } else {
-            siseRecord.setString("NET_CHNG_SIGN", "2");
+            siseRecord.setString(sf.net_chng_sign, "2");
         }
-        siseRecord.setDouble("NET_CHNG", net_chng);
-        siseRecord.setDouble("PCT_CHNG", pct_chng);
+        siseRecord.setDouble(sf.net_chng, net_chng);
+        siseRecord.setDouble(sf.pct_chng, pct_chng);
     } else if(net_chng < 0) {
-        double dnlimit = masterRecord.getDouble("DNLIMIT");
+        double dnlimit = masterRecord.getDouble(mf.dnlimit);
         if(trd_prc <= dnlimit && dnlimit > 0) {
-            siseRecord.setString("NET_CHNG_SIGN", "4");
+            siseRecord.setString(sf.net_chng_sign, "4");
         } else {
-            siseRecord.setString("NET_CHNG_SIGN", "5");
+            siseRecord.setString(sf.net_chng_sign, "5");
         }
         // net_chng *= (-1);
-        siseRecord.setDouble("NET_CHNG", net_chng);
-        siseRecord.setDouble("PCT_CHNG", pct_chng);
+        siseRecord.setDouble(sf.net_chng, net_chng);
+        siseRecord.setDouble(sf.pct_chng, pct_chng);
     } else {
-        siseRecord.setString("NET_CHNG_SIGN", "3");
-        siseRecord.setDouble("NET_CHNG", net_chng);
-        siseRecord.setDouble("PCT_CHNG", pct_chng);
+        siseRecord.setString(sf.net_chng_sign, "3");
+        siseRecord.setDouble(sf.net_chng, net_chng);
+        siseRecord.setDouble(sf.pct_chng, pct_chng);
     }
     
-    siseRecord.setString("OPEN_PRC_TM", masterRecord.getString("OPEN_PRC_TM"));
-    siseRecord.setString("HIGH_PRC_TM", masterRecord.getString("HIGH_PRC_TM"));
-    siseRecord.setString("LOW_PRC_TM", masterRecord.getString("LOW_PRC_TM"));
-
-    siseRecord.setString("BID_PRC", masterRecord.getString("BID_PRC"));
-    siseRecord.setString("ASK_PRC", masterRecord.getString("ASK_PRC"));
-    siseRecord.setString("BID_SIZE", masterRecord.getString("BID_SIZE"));
-    siseRecord.setString("ASK_SIZE", masterRecord.getString("ASK_SIZE"));
-
-    siseRecord.setString("TRD_VOL", masterRecord.getString("TRD_VOL"));
-    siseRecord.setString("SVOL", masterRecord.getString("SVOL"));
-    long samt = masterRecord.getLong("SAMT");
-    siseRecord.setInt("SAMT", (samt+500)/1000); // round
-
-    siseRecord.setString("SESSION_GB", "0");
-    if(trd_prc <= masterRecord.getDouble("BID_PRC")) {
-        siseRecord.setString("TRAND_GB", "2");
+    siseRecord.copyField(sf.open_prc_tm, masterRecord, mf.open_prc_tm);
+    siseRecord.copyField(sf.high_prc_tm, masterRecord, mf.high_prc_tm);
+    siseRecord.copyField(sf.low_prc_tm, masterRecord, mf.low_prc_tm);
+
+    siseRecord.copyField(sf.bid_prc, masterRecord, mf.bid_prc);
+    siseRecord.copyField(sf.ask_prc, masterRecord, mf.ask_prc);
+    siseRecord.copyField(sf.bid_size, masterRecord, mf.bid_size);
+    siseRecord.copyField(sf.ask_size, masterRecord, mf.ask_size);
+
+    siseRecord.copyField(sf.trd_vol, masterRecord, mf.trd_vol);
+    siseRecord.copyField(sf.svol, masterRecord, mf.svol);
+    long samt = masterRecord.getLong(mf.samt);
+    siseRecord.setInt(sf.samt, (samt+500)/1000); // round
+
+    siseRecord.setString(sf.session_gb, "0");
+    if(trd_prc <= masterRecord.getDouble(mf.bid_prc)) {
+        siseRecord.setString(sf.trand_gb, "2");
     } else {
-        siseRecord.setString("TRAND_GB", "1");
+        siseRecord.setString(sf.trand_gb, "1");
     }
 
-    siseRecord.setString("TRD_GB", "0");
+    siseRecord.setString(sf.trd_gb, "0");
 
-    siseRecord.init9Mode("AFTMKT_PRC", ' ');
-    siseRecord.initXMode("TTYPE", ' ');
-    siseRecord.initXMode("BASE_NET_CHNG_SIGN", ' ');
-    siseRecord.init9Mode("BASE_NET_CHNG", ' ');
-    siseRecord.init9Mode("BASE_PCT_CHNG", ' ');
+    siseRecord.fill(sf.aftmkt_prc, ' ');
+    siseRecord.fill(sf.ttype, ' ');
+    siseRecord.fill(sf.base_net_chng_sign, ' ');
+    siseRecord.fill(sf.base_net_chng, ' ');
+    siseRecord.fill(sf.base_pct_chng, ' ');
 
-    siseRecord.initXMode("FILLER", ' ');
-    siseRecord.initXMode("FF", 0xff);
+    siseRecord.fill(sf.filler, ' ');
+    siseRecord.fill(sf.ff, static_cast<char>(0xff));
 
     // 기본 필드들 설정
-    auto trdPrcIt = trepData.find("6");   // 현재가
-    auto trdVolIt = trepData.find("178"); // 체결량
-    auto netChngIt = trepData.find("11"); // 전일대비
-    auto pctChngIt = trepData.find("56"); // 등락률
+    const TrepSpan* trdPrc = trepData.find(6);   // 현재가
+    const TrepSpan* trdVol = trepData.find(178); // 체결량
+    // const TrepSpan* netChng = trepData.find(11); // 전일대비
+    // const TrepSpan* pctChng = trepData.find(56); // 등락률
     // auto openPrcIt = trepData.find("19"); // 시가
     // auto highPrcIt = trepData.find("12"); // 고가
     // auto lowPrcIt = trepData.find("13");  // 저가
-    auto svolIt = trepData.find("32");    // 누적거래량
+    // const TrepSpan* svol = trepData.find(32);    // 누적거래량
     
     // if (trdPrcIt != trepData.end() && trdPrcIt->second != "blank") {
     //     siseRecord.setString("TRD_PRC", trdPrcIt->second);
@@ -318,15 +548,20 @@ void T2MA_JAPAN_EQUITY::send_japan_sise_data(const std::string& ric, const std::
     //     siseRecord.setString("SVOL", svolIt->second);
     // }
     
-    // Publisher로 일본 주식 체결 데이터 송신
-    publisher_->publish(DataTopic::TOPIC1, siseRecord.getBuffer(), siseRecord.getSize());
+    // Publisher로 일본 주식 체결 데이터 송신 (worker 에서는 event loop 로 넘겨 그 스레드에서 publish)
+    if (state.ctx) {
+        state.ctx->emit(static_cast<int>(DataTopic::TOPIC1), siseRecord.getBuffer(), siseRecord.getSize());
+    } else {
+        LatencyScope scope(latency_ ? &latency_->publish : nullptr);
+        publisher_->publish(DataTopic::TOPIC1, siseRecord.getBuffer(), siseRecord.getSize());
+    }
     siseRecord.dump();
     std::cout << "📈 일본주식 체결데이터 송신: " << ric;
-    if (trdPrcIt != trepData.end()) {
-        std::cout << " 가격=" << trdPrcIt->second << "¥";
+    if (trdPrc) {
+        std::cout << " 가격=" << trdPrc->str() << "¥";
     }
-    if (trdVolIt != trepData.end()) {
-        std::cout << " 량=" << trdVolIt->second;
+    if (trdVol) {
+        std::cout << " 량=" << trdVol->str();
     }
     std::cout << std::endl;
     std::cout << "SISE : " << std::string(siseRecord.getBuffer(), siseRecord.getSize()) << std::endl;
@@ -405,9 +640,9 @@ void T2MA_JAPAN_EQUITY::control_heartbeat() {
     }
 
     // Processing statistics
-    std::cout << "   📈 Processed Messages: " << processed_count_ << std::endl;
-    std::cout << "   🔄 Master Updates: " << master_update_count_ << std::endl;
-    std::cout << "   📊 Market Data: " << sise_count_ << std::endl;
+    std::cout << "   📈 Processed Messages: " << processed_count_.value() << std::endl;
+    std::cout << "   🔄 Master Updates: " << master_update_count_.value() << std::endl;
+    std::cout << "   📊 Market Data: " << sise_count_.value() << std::endl;
 
     std::cout << "   ✅ Japan Equity System ALIVE and HEALTHY" << std::endl;
 }
@@ -466,9 +701,9 @@ void T2MA_JAPAN_EQUITY::control_heartbeat_japan() {
 
     // Processing statistics
     std::cout << "   📊 Processing Stats:" << std::endl;
-    std::cout << "      - Total Messages: " << processed_count_ << std::endl;
-    std::cout << "      - Master Updates: " << master_update_count_ << std::endl;
-    std::cout << "      - SISE Data: " << sise_count_ << std::endl;
+    std::cout << "      - Total Messages: " << processed_count_.value() << std::endl;
+    std::cout << "      - Master Updates: " << master_update_count_.value() << std::endl;
+    std::cout << "      - SISE Data: " << sise_count_.value() << std::endl;
 
     std::cout << "   🎌 Japan Equity System - Operating Normally" << std::endl;
 }
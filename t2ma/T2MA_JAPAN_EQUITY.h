@@ -4,6 +4,9 @@
 #include "T2MASystem.h"
 #include "../HashMaster/HashMaster.h"
 #include "../HashMaster/BinaryRecord.h"
+#include "../HashMaster/RecordDelta.h"
+#include "FidMapTable.h"
+#include "TimeConvert.h"
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -23,6 +26,56 @@
  */
 class T2MA_JAPAN_EQUITY : public T2MASystem {
 private:
+    // 마스터/체결 레이아웃 필드 핸들 (initialize 에서 한번 찾아두고 tick 마다 재사용)
+    struct MasterFields {
+        FieldHandle symbol_cd, trd_dt;
+        FieldHandle trd_prc, high_prc, low_prc, open_prc, close_prc, base_prc;
+        FieldHandle bid_prc, ask_prc, bid_size, ask_size;
+        FieldHandle trd_vol, svol, samt, net_chng, pct_chng, uplimit, dnlimit;
+        FieldHandle local_tm, sal_tm, open_prc_tm, high_prc_tm, low_prc_tm;
+        FieldHandle update_count, send_master_max, send_master_count, dist_flag;
+    } master_fields_;
+    
+    struct SiseFields {
+        FieldHandle data_gb, info_gb, mkt_gb, exchg_cd, trans_tm, ric_cd, symbol_cd;
+        FieldHandle local_dt, local_tm, kor_dt, kor_tm;
+        FieldHandle open_prc, high_prc, low_prc, trd_prc;
+        FieldHandle net_chng_sign, net_chng, pct_chng;
+        FieldHandle open_prc_tm, high_prc_tm, low_prc_tm;
+        FieldHandle bid_prc, ask_prc, bid_size, ask_size, trd_vol, svol, samt;
+        FieldHandle session_gb, trand_gb, trd_gb;
+        FieldHandle aftmkt_prc, ttype, base_net_chng_sign, base_net_chng, base_pct_chng, filler, ff;
+    } sise_fields_;
+    
+    // 메시지 처리 scratch (event loop 하나 + 마스터 갱신 worker partition 마다 하나)
+    struct WorkState {
+        TrepFieldList trep_fields;                      // 재사용하는 TREP 필드 목록 (메시지 버퍼를 가리킴)
+        std::unique_ptr<BinaryRecord> sise_record;      // send_japan_sise_data 에서 재사용하는 레코드 버퍼
+        MasterWorkerContext* ctx = nullptr;             // worker 에서 처리 중이면 publish 대신 ctx->emit
+        DirtyFieldSet dirty;                            // 이번 갱신에서 바뀐 마스터 필드
+        std::vector<char> delta_buf;                    // RecordDelta 인코딩 버퍼
+        std::string ric;                                // 현재 RIC (NUL 종료, capacity 재사용)
+        DateTimeCache trans_tm;                         // 체결 TRANS_TM (초 단위 캐시)
+        LocalTimeConverter local_time;                  // GMT -> local (local_time_ 복사본, memo 가 스레드별)
+    };
+    WorkState loop_state_;
+    std::vector<std::unique_ptr<WorkState>> worker_states_;
+    void init_work_state(WorkState& state);
+    
+    // fid_map.gmt_offset / fid_map.timezone 으로 만든 변환기 (WorkState 마다 복사)
+    LocalTimeConverter local_time_;
+    
+    // TREP FID -> 마스터 필드 매핑 (config fid_map.master 에서 컴파일)
+    FidMapTable master_fid_map_;
+    // fid_map.master_delta_topic (0: delta 송신 끔)
+    DataTopic master_delta_topic_ = static_cast<DataTopic>(0);
+    void send_master_delta(WorkState& state, const std::string& ric, const BinaryRecordView& masterRecord);
+    
+    bool resolve_field_handles();
+    // RAFR 규칙: refresh 첫 수신 시 마스터 전체 분배 / 거래 없는 종가 수신 시 체결 보정
+    bool send_master_on_refresh(WorkState& state, BinaryRecordView& record, const TrepFieldList& trepData);
+    void apply_close_without_trade(WorkState& state, BinaryRecordView& record, const TrepFieldList& trepData);
+    static const std::map<int, std::string>& default_master_fid_map();
     
 public:
     T2MA_JAPAN_EQUITY(const T2MAConfig& config);
@@ -31,15 +84,21 @@ public:
     void handle_trep_data_message(const char* data, size_t size);
     void handle_control_message(const char* data, size_t size);
 
-    void update_japan_equity_master(const std::string& ric, const std::map<std::string, std::string>& trepData) ;
-    void send_japan_sise_data(const std::string& ric, const std::map<std::string, std::string>& trepData);
+    void update_japan_equity_master(Master* master, WorkState& state, const std::string& ric, const TrepFieldList& trepData) ;
+    void send_japan_sise_data(WorkState& state, const std::string& ric, const BinaryRecordView& masterRecord, const TrepFieldList& trepData);
+    
+    // system.master_workers > 0: RIC partition worker 스레드에서 마스터 갱신 + 체결 레코드 생성
+    void handle_master_work(MasterWorkerContext& ctx, Master* master, const char* data, size_t size) override;
 
     /* message handler for trep data */
     void handle_japan_equity(const char* data, size_t size);
     void handle_german_equity(const char* data, size_t size);
 
     /* command_handler */
-    void control_reload_master_command(const char* data, size_t size) {};
+    // RELOAD_MASTER: 새 마스터 generation 을 백그라운드에서 만들어 교체 (tick 처리는 계속)
+    void control_reload_master_command(const char* /*data*/, size_t /*size*/) {
+        reload_master_data();
+    }
     void execute_helloworld(const char* data, size_t size) {
         std::cout << "execute_helloworld" << std::endl;
         std::cout << "size: " << size << std::endl;
@@ -62,6 +121,7 @@ public:
         REGISTER_MEMBER_HANDLER(handle_japan_equity);
         REGISTER_MEMBER_HANDLER(handle_german_equity);
 
+        REGISTER_MEMBER_HANDLER(control_reload_master_command);
         REGISTER_MEMBER_HANDLER(execute_helloworld);
     }
     
@@ -73,9 +133,9 @@ public:
             return false;
         }
         
-        
-        
-        
+        if (!resolve_field_handles()) {
+            return false;
+        }
         
 
         return true;
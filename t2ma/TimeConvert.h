@@ -0,0 +1,198 @@
+#ifndef TIME_CONVERT_H
+#define TIME_CONVERT_H
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <string>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * GMT -> 거래소 local 시각 변환 (set_time / cvt_gmt2local_ymd2 대체)
+ *
+ * 기존 함수는 tick 마다 mktime + localtime_r (tz lock, /etc/localtime stat) + sprintf 를 했다.
+ * 여기서는 UTC offset 구간 (transition) 을 시작 시 한번 만들어두고, 변환은 정수 연산
+ * (days_from_civil / civil_from_days) 만 한다. 같은 초가 연속으로 오면 포맷한 문자열을 그대로 쓴다.
+ *
+ * - set_fixed(offset): config fid_map.gmt_offset (DST 없음)
+ * - load_zone("Asia/Tokyo"): fid_map.timezone. 프로세스 TZ 를 잠시 바꿔 [from, from + days) 를
+ *   1시간 간격으로 훑고, offset 이 바뀐 시각은 초 단위로 찾는다 (DST 포함). 시작 시 한번만
+ *   (다른 스레드가 localtime 을 쓰기 전에) 호출한다. 구간 밖은 가장 가까운 끝의 offset.
+ * - memo 가 있으므로 처리 스레드마다 복사본을 둔다 (WorkState).
+ */
+class LocalTimeConverter {
+private:
+    struct Transition {
+        int64_t utc;        // 이 시각부터
+        int offset;         // local = utc + offset (초)
+    };
+    std::vector<Transition> _transitions;   // utc 오름차순, 최소 1개
+
+    // offset_at 캐시 구간 [_from, _to)
+    int64_t _from, _to;
+    int _offset;
+
+    // 마지막 변환 (같은 초면 재사용)
+    int64_t _memo_utc;
+    char _memo_ymd[8 + 1];
+    char _memo_hms[6 + 1];
+
+    static bool parse_digits(const char* p, int n, int& value) {
+        value = 0;
+        for (int i = 0; i < n; i++) {
+            unsigned d = static_cast<unsigned>(p[i] - '0');
+            if (d > 9) return false;
+            value = value * 10 + static_cast<int>(d);
+        }
+        return true;
+    }
+
+    static void put2(char* p, int v) { p[0] = static_cast<char>('0' + v / 10); p[1] = static_cast<char>('0' + v % 10); }
+
+public:
+    // 1970-01-01 부터의 일 수 (proleptic Gregorian, H. Hinnant)
+    static int64_t days_from_civil(int y, int m, int d) {
+        y -= m <= 2;
+        int64_t era = (y >= 0 ? y : y - 399) / 400;
+        int64_t yoe = y - era * 400;
+        int64_t doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+        int64_t doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + doe - 719468;
+    }
+
+    static void civil_from_days(int64_t z, int& y, int& m, int& d) {
+        z += 719468;
+        int64_t era = (z >= 0 ? z : z - 146096) / 146097;
+        int64_t doe = z - era * 146097;
+        int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        int64_t mp = (5 * doy + 2) / 153;
+        d = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+        m = static_cast<int>(mp < 10 ? mp + 3 : mp - 9);
+        y = static_cast<int>(yoe + era * 400 + (m <= 2));
+    }
+
+    LocalTimeConverter() { set_fixed(0); }
+
+    void set_fixed(int offset) {
+        _transitions.assign(1, Transition{INT64_MIN, offset});
+        _from = INT64_MIN;
+        _to = INT64_MAX;
+        _offset = offset;
+        _memo_utc = INT64_MIN;
+        _memo_ymd[0] = _memo_hms[0] = 0;
+    }
+
+    // tz: IANA 이름. zoneinfo 에 없으면 false (glibc 는 모르는 이름을 조용히 UTC 로 처리하므로 먼저 확인)
+    bool load_zone(const std::string& tz, int64_t from_utc, int days) {
+        const char* tzdir = getenv("TZDIR");
+        std::string path = std::string(tzdir ? tzdir : "/usr/share/zoneinfo") + "/" + tz;
+        if (tz.empty() || tz.find("..") != std::string::npos || access(path.c_str(), R_OK) != 0) {
+            return false;
+        }
+
+        const char* old = getenv("TZ");
+        bool had_tz = old != nullptr;
+        std::string saved = had_tz ? old : "";
+        setenv("TZ", tz.c_str(), 1);
+        tzset();
+
+        auto gmtoff = [](int64_t utc) {
+            time_t t = static_cast<time_t>(utc);
+            struct tm tm_local;
+            localtime_r(&t, &tm_local);
+            return static_cast<int>(tm_local.tm_gmtoff);
+        };
+
+        std::vector<Transition> transitions;
+        int64_t end = from_utc + static_cast<int64_t>(days) * 86400;
+        int current = gmtoff(from_utc);
+        transitions.push_back(Transition{INT64_MIN, current});
+        for (int64_t t = from_utc + 3600; t <= end; t += 3600) {
+            int next = gmtoff(t);
+            if (next == current) continue;
+            // (t - 3600, t] 안에서 바뀐 첫 초
+            int64_t lo = t - 3600, hi = t;
+            while (hi - lo > 1) {
+                int64_t mid = lo + (hi - lo) / 2;
+                if (gmtoff(mid) == current) lo = mid; else hi = mid;
+            }
+            transitions.push_back(Transition{hi, next});
+            current = next;
+        }
+
+        if (had_tz) setenv("TZ", saved.c_str(), 1); else unsetenv("TZ");
+        tzset();
+
+        _transitions.swap(transitions);
+        _from = _to = 0;            // 다음 offset_at 에서 다시 찾음
+        _memo_utc = INT64_MIN;
+        return true;
+    }
+
+    size_t transition_count() const { return _transitions.size() - 1; }
+
+    int offset_at(int64_t utc) {
+        if (utc >= _from && utc < _to) {
+            return _offset;
+        }
+        size_t i = 0;
+        while (i + 1 < _transitions.size() && _transitions[i + 1].utc <= utc) i++;
+        _from = _transitions[i].utc;
+        _to = (i + 1 < _transitions.size()) ? _transitions[i + 1].utc : INT64_MAX;
+        _offset = _transitions[i].offset;
+        return _offset;
+    }
+
+    // ymd "YYYYMMDD", hms "hhmmss" (GMT) -> local YYYYMMDD / hhmmss (NUL 종료, 다음 호출까지 유효).
+    // 숫자가 아니면 false
+    bool convert(const char* ymd, const char* hms, const char** local_ymd, const char** local_hms) {
+        int iymd, ihms;
+        if (!parse_digits(ymd, 8, iymd) || !parse_digits(hms, 6, ihms)) {
+            return false;
+        }
+        int64_t utc = days_from_civil(iymd / 10000, (iymd % 10000) / 100, iymd % 100) * 86400
+                    + (ihms / 10000) * 3600 + ((ihms % 10000) / 100) * 60 + ihms % 100;
+        format(utc);
+        if (local_ymd) *local_ymd = _memo_ymd;
+        if (local_hms) *local_hms = _memo_hms;
+        return true;
+    }
+
+    // hhmmss (GMT, 날짜 없음) -> local hhmmss. offset 은 오늘 (UTC) 그 시각 기준
+    // (set_time 과 같이 hms 를 정수로 받으며, 날짜가 바뀌는 것은 무시)
+    const char* local_hms(int hms) {
+        int64_t now = static_cast<int64_t>(time(nullptr));
+        int64_t day = now >= 0 ? now / 86400 : (now - 86399) / 86400;
+        int64_t utc = day * 86400 + (hms / 10000) * 3600 + ((hms % 10000) / 100) * 60 + hms % 100;
+        format(utc);
+        return _memo_hms;
+    }
+
+private:
+    void format(int64_t utc) {
+        if (utc == _memo_utc) {
+            return;
+        }
+        int64_t local = utc + offset_at(utc);
+        int64_t day = local >= 0 ? local / 86400 : (local - 86399) / 86400;
+        int sod = static_cast<int>(local - day * 86400);
+        int y, m, d;
+        civil_from_days(day, y, m, d);
+
+        put2(_memo_ymd, (y / 100) % 100);
+        put2(_memo_ymd + 2, y % 100);
+        put2(_memo_ymd + 4, m);
+        put2(_memo_ymd + 6, d);
+        _memo_ymd[8] = 0;
+        put2(_memo_hms, sod / 3600);
+        put2(_memo_hms + 2, (sod / 60) % 60);
+        put2(_memo_hms + 4, sod % 60);
+        _memo_hms[6] = 0;
+        _memo_utc = utc;
+    }
+};
+
+#endif // TIME_CONVERT_H
@@ -0,0 +1,116 @@
+#ifndef TREP_INGEST_H
+#define TREP_INGEST_H
+
+#include "../common/IPCHeader.h"
+#include "../common/ShmRing.h"
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * TREP feed handler -> T2MA 직접 ingest (producer 쪽, header-only)
+ *
+ * 예전에는 RAFR_JAPANEQUITYTREP2MAST 가 TREP 필드 목록을 메시지마다 new fidbuf 로 파싱하고
+ * master/sise 파일을 쓴 뒤 MQ 로 다시 T2MA 에 넘겼다 (T2MA 에서 한번 더 파싱).
+ * 이제 feed handler 는 field list 를 decode 하는 루프에서 바로 add() 하고 send() 로
+ * T2MA 의 shm ring (messagequeue.transport: shm) 에 쓴다. RAFR 의 마스터 규칙
+ * (refresh/update, 종가 처리, UPDATE_COUNT 등) 은 T2MA_JAPAN_EQUITY 가 처리한다.
+ *
+ * - 라인 버퍼는 한번 잡아두고 재사용 (메시지당 할당 없음)
+ * - 값에 ',' 가 있으면 따옴표로 감싼다 (TrepParser 규칙)
+ * - ring 이 가득 차면 send() 는 false (ShmRing 과 같이 막지 않고 drop)
+ * - writer 하나는 한 스레드에서만 쓴다 (ring 이 SPSC)
+ */
+
+#define TREP_INGEST_DATATYPE_FID 99999      // 값 "REFRESH" / "UPDATE"
+#define TREP_INGEST_KEY_FID 0               // RIC
+
+class TrepRingWriter {
+private:
+    SimplePubSub::ShmRing* _ring;
+    std::vector<char> _line;
+    size_t _size;
+    size_t _fields;
+    bool _overflow;
+
+    void append(const char* p, size_t n) {
+        if (_size + n > _line.size()) {
+            _overflow = true;
+            return;
+        }
+        memcpy(_line.data() + _size, p, n);
+        _size += n;
+    }
+
+    void append_fid(int fid) {
+        char buf[16];
+        int n = snprintf(buf, sizeof(buf), _fields ? ",%d=" : "%d=", fid);
+        append(buf, static_cast<size_t>(n));
+        _fields++;
+    }
+
+public:
+    // max_line: ipc_header 를 뺀 라인 최대 길이 (_msg_size 가 short 이므로 32K 미만)
+    explicit TrepRingWriter(SimplePubSub::ShmRing* ring, size_t max_line = 16 * 1024)
+        : _ring(ring), _line(max_line), _size(0), _fields(0), _overflow(false) {
+        if (_line.size() > 32767 - sizeof(ipc_header)) {
+            _line.resize(32767 - sizeof(ipc_header));
+        }
+    }
+
+    // 새 메시지 시작. RIC 과 refresh 여부가 먼저 온다 (T2MA 가 partition / 처리 분기에 쓴다)
+    void begin(const char* ric, size_t ric_len, bool refresh) {
+        _size = 0;
+        _fields = 0;
+        _overflow = false;
+        add(TREP_INGEST_KEY_FID, ric, ric_len);
+        add(TREP_INGEST_DATATYPE_FID, refresh ? "REFRESH" : "UPDATE");
+    }
+
+    void add(int fid, const char* value, size_t len) {
+        append_fid(fid);
+        if (memchr(value, ',', len)) {
+            append("\"", 1);
+            append(value, len);
+            append("\"", 1);
+        } else {
+            append(value, len);
+        }
+    }
+    void add(int fid, const char* value) { add(fid, value, strlen(value)); }
+    void add(int fid, const std::string& value) { add(fid, value.data(), value.size()); }
+
+    void add(int fid, long long value) {
+        char buf[24];
+        int n = snprintf(buf, sizeof(buf), "%lld", value);
+        add(fid, buf, static_cast<size_t>(n));
+    }
+
+    // precision: 소수 자리 (TREP 원값 자리수를 그대로 넘길 때)
+    void add(int fid, double value, int precision) {
+        char buf[48];
+        int n = snprintf(buf, sizeof(buf), "%.*f", precision, value);
+        add(fid, buf, static_cast<size_t>(n));
+    }
+
+    // 값이 지워진 필드 (T2MA 는 blank 를 갱신하지 않음)
+    void add_blank(int fid) { add(fid, "blank", 5); }
+
+    size_t size() const { return _size; }
+    bool overflow() const { return _overflow; }
+
+    // ipc_header(TREP_DATA) + 라인을 ring 에 한 레코드로 쓴다
+    bool send() {
+        if (!_ring || _overflow || _size == 0) {
+            return false;
+        }
+        ipc_header hdr;
+        hdr._msg_type = static_cast<char>(MsgType::TREP_DATA);
+        hdr._reserved = 0;
+        hdr._msg_size = static_cast<short>(sizeof(ipc_header) + _size);
+        return _ring->write(&hdr, sizeof(hdr), _line.data(), _size);
+    }
+};
+
+#endif // TREP_INGEST_H
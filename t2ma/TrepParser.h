@@ -0,0 +1,234 @@
+#ifndef TREP_PARSER_H
+#define TREP_PARSER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+/**
+ * TREP 라인 ("FID=값,FID=값,...") 토크나이저
+ *
+ * - 값은 입력 버퍼를 가리키는 TrepSpan 으로 돌려준다 (복사/할당 없음)
+ *   입력 버퍼(MQ 메시지)가 살아있는 동안만 유효하다.
+ * - 필드는 라인 순서대로 고정 크기 배열에 저장 (TREP_MAX_FIELDS 초과분은 버림)
+ * - 값이 '"' 로 시작하면 닫는 '"' 까지가 값이다 (값 안의 ',' 허용, 따옴표 제거)
+ * - '=' 없는 토큰은 무시, 라인 끝의 CR/LF/NUL 은 제거
+ * - 같은 FID가 여러번 나오면 find() 는 마지막 값을 돌려준다 (기존 std::map 과 동일)
+ */
+
+#define TREP_MAX_FIELDS 256
+
+// 버퍼 안의 구간 (C++14 이므로 std::string_view 대신)
+struct TrepSpan {
+    const char* data;
+    size_t size;
+
+    TrepSpan() : data(""), size(0) {}
+    TrepSpan(const char* d, size_t n) : data(d), size(n) {}
+
+    bool empty() const { return size == 0; }
+    bool equals(const char* s, size_t n) const { return size == n && memcmp(data, s, n) == 0; }
+    bool operator==(const char* s) const { return equals(s, strlen(s)); }
+    bool operator!=(const char* s) const { return !(*this == s); }
+    std::string str() const { return std::string(data, size); }
+
+    // 값이 없거나 "blank" 이면 갱신하지 않는 필드
+    bool is_blank() const { return size == 0 || equals("blank", 5); }
+};
+
+struct TrepField {
+    int fid;            // key 가 정수가 아니면 TREP_INVALID_FID
+    TrepSpan key;
+    TrepSpan value;
+};
+
+#define TREP_INVALID_FID (-0x7fffffff - 1)
+
+class TrepFieldList {
+private:
+    TrepField _fields[TREP_MAX_FIELDS];
+    size_t _count;
+    size_t _dropped;
+
+public:
+    TrepFieldList() : _count(0), _dropped(0) {}
+
+    void clear() { _count = 0; _dropped = 0; }
+
+    void add(const TrepSpan& key, const TrepSpan& value) {
+        if (_count >= TREP_MAX_FIELDS) {
+            _dropped++;
+            return;
+        }
+        TrepField& f = _fields[_count++];
+        f.fid = parse_fid(key);
+        f.key = key;
+        f.value = value;
+    }
+
+    size_t size() const { return _count; }
+    size_t dropped() const { return _dropped; }
+    bool empty() const { return _count == 0; }
+    const TrepField& operator[](size_t i) const { return _fields[i]; }
+    const TrepField* begin() const { return _fields; }
+    const TrepField* end() const { return _fields + _count; }
+
+    // 라인당 필드 수가 수십개 수준이므로 뒤에서부터 선형 탐색 (마지막 값 우선)
+    const TrepSpan* find(int fid) const {
+        for (size_t i = _count; i > 0; --i) {
+            if (_fields[i - 1].fid == fid) return &_fields[i - 1].value;
+        }
+        return nullptr;
+    }
+    bool has(int fid) const { return find(fid) != nullptr; }
+
+    static int parse_fid(const TrepSpan& key) {
+        const char* p = key.data;
+        const char* end = key.data + key.size;
+        bool negative = p < end && *p == '-';
+        if (negative) p++;
+        if (p == end || end - p > 9) return TREP_INVALID_FID;
+
+        int value = 0;
+        for (; p < end; ++p) {
+            unsigned d = static_cast<unsigned char>(*p) - '0';
+            if (d > 9) return TREP_INVALID_FID;
+            value = value * 10 + static_cast<int>(d);
+        }
+        return negative ? -value : value;
+    }
+};
+
+class TrepParser {
+public:
+    // [p, end) 에서 a 또는 b 가 처음 나오는 위치 (없으면 end)
+    static const char* find_either(const char* p, const char* end, char a, char b) {
+#ifdef __SSE2__
+        const __m128i va = _mm_set1_epi8(a);
+        const __m128i vb = _mm_set1_epi8(b);
+        while (end - p >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+            int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(chunk, va), _mm_cmpeq_epi8(chunk, vb)));
+            if (mask) return p + __builtin_ctz(mask);
+            p += 16;
+        }
+#endif
+        for (; p < end; ++p) {
+            if (*p == a || *p == b) return p;
+        }
+        return end;
+    }
+
+    static const char* find_char(const char* p, const char* end, char c) {
+        const void* found = memchr(p, c, end - p);
+        return found ? static_cast<const char*>(found) : end;
+    }
+
+    // data 를 토큰화해서 out 에 채운다. 필드 수 반환
+    static size_t parse(const char* data, size_t size, TrepFieldList& out) {
+        out.clear();
+        if (!data) return 0;
+
+        const char* p = data;
+        const char* end = data + size;
+        while (end > p && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == '\0')) {
+            --end;
+        }
+
+        while (p < end) {
+            const char* delim = find_either(p, end, '=', ',');
+            if (delim == end) break;               // '=' 없는 마지막 토큰
+            if (*delim == ',') {                   // '=' 없는 토큰은 무시
+                p = delim + 1;
+                continue;
+            }
+
+            TrepSpan key(p, delim - p);
+            const char* v = delim + 1;
+            const char* next;
+
+            if (v < end && *v == '"') {
+                const char* close = find_char(v + 1, end, '"');
+                if (close != end) {
+                    out.add(key, TrepSpan(v + 1, close - v - 1));
+                    next = find_char(close + 1, end, ',');
+                    p = next + (next < end ? 1 : 0);
+                    continue;
+                }
+                // 닫는 따옴표가 없으면 따옴표 포함 그대로
+            }
+
+            next = find_char(v, end, ',');
+            out.add(key, TrepSpan(v, next - v));
+            p = next + (next < end ? 1 : 0);
+        }
+        return out.size();
+    }
+
+    // 필드 하나만 찾는다 (TrepFieldList 를 채우지 않음, parse() + find() 와 같은 값: 마지막 값 우선)
+    // pipeline reader 가 RIC 으로 worker 를 고를 때 사용
+    static bool find_value(const char* data, size_t size, int fid, TrepSpan& out) {
+        if (!data) return false;
+
+        const char* p = data;
+        const char* end = data + size;
+        while (end > p && (end[-1] == '\n' || end[-1] == '\r' || end[-1] == '\0')) {
+            --end;
+        }
+
+        bool found = false;
+        while (p < end) {
+            const char* delim = find_either(p, end, '=', ',');
+            if (delim == end) break;
+            if (*delim == ',') {
+                p = delim + 1;
+                continue;
+            }
+
+            bool match = TrepFieldList::parse_fid(TrepSpan(p, delim - p)) == fid;
+            const char* v = delim + 1;
+            const char* next;
+
+            if (v < end && *v == '"') {
+                const char* close = find_char(v + 1, end, '"');
+                if (close != end) {
+                    if (match) {
+                        out = TrepSpan(v + 1, close - v - 1);
+                        found = true;
+                    }
+                    next = find_char(close + 1, end, ',');
+                    p = next + (next < end ? 1 : 0);
+                    continue;
+                }
+            }
+
+            next = find_char(v, end, ',');
+            if (match) {
+                out = TrepSpan(v, next - v);
+                found = true;
+            }
+            p = next + (next < end ? 1 : 0);
+        }
+        return found;
+    }
+
+    // 이전 인터페이스 (std::map 사본). 새 코드는 parse() 사용
+    static std::map<std::string, std::string> parseLine(const std::string& line) {
+        TrepFieldList fields;
+        parse(line.data(), line.size(), fields);
+
+        std::map<std::string, std::string> result;
+        for (const TrepField& f : fields) {
+            result[f.key.str()] = f.value.str();
+        }
+        return result;
+    }
+};
+
+#endif // TREP_PARSER_H
@@ -103,7 +103,7 @@ int main(int argc, char* argv[]) {
     
     // Config에서 auto_load_csv가 설정된 경우 자동으로 CSV 로딩
     if (config.system.auto_load_csv) {
-        if (!g_t2ma_system->load_symbols_from_csv()) {
+        if (!g_t2ma_system->load_symbols_on_start()) {
             std::cerr << "Failed to load symbols from CSV: " << config.files.csv_file << std::endl;
         }
     }
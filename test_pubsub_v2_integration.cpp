@@ -7,6 +7,21 @@
 #include <condition_variable>
 #include <signal.h>
 #include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <dirent.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 #include <event2/event.h>
 #include "pubsub/Common.h"
@@ -14,6 +29,13 @@
 #include "pubsub/SimpleSubscriber.h"
 #include "pubsub/FileSequenceStorage.h"
 #include "pubsub/HashmasterSequenceStorage.h"
+#include "pubsub/PubSubTopicProtocol.h"
+#include "pubsub/ShmTopicLog.h"
+#include "HashMaster/HashTable.h"
+#include "HashMaster/WireCodec.h"
+#include "common/db_sam.h"
+#include "common/segment_sam.h"
+#include "common/mmap_sam.h"
 
 using namespace SimplePubSub;
 
@@ -882,6 +904,1116 @@ bool test_error_handling() {
     return all_passed;
 }
 
+// WireCodec 테스트용 레이아웃 (X 모드 / 9 모드 / char 가 섞인 sise 레코드 형태)
+static std::shared_ptr<RecordLayout> make_wire_test_layout() {
+    std::shared_ptr<RecordLayout> layout = std::make_shared<RecordLayout>("WIRE_TEST");
+    layout->addField("code", FieldType::X_MODE, 12, 0, true);
+    layout->addField("price", FieldType::NINE_MODE, 10);
+    layout->addField("volume", FieldType::NINE_MODE, 12);
+    layout->addField("name", FieldType::CHAR, 16);
+    layout->calculateLayout();
+    return layout;
+}
+
+static std::string make_wire_test_record(const RecordLayout& layout, int i) {
+    std::string record(layout.getRecordSize(), '\0');
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%-12s", ("CODE" + std::to_string(i)).c_str());
+    memcpy(&record[layout.handle("code").offset], buf, 12);
+    snprintf(buf, sizeof(buf), "%010d", 12345 + i);
+    memcpy(&record[layout.handle("price").offset], buf, 10);
+    snprintf(buf, sizeof(buf), "%012d", 100 * i);
+    memcpy(&record[layout.handle("volume").offset], buf, 12);
+    snprintf(buf, sizeof(buf), "name%d", i);
+    memcpy(&record[layout.handle("name").offset], buf, strlen(buf));
+    return record;
+}
+
+// Test Case 8: WireCodec encode/decode 와 raw 구독자 호환
+bool test_wire_codec() {
+    std::cout << "\n=== Test 8: WireCodec Encoding ===" << std::endl;
+
+    bool all_passed = true;
+    std::shared_ptr<RecordLayout> layout = make_wire_test_layout();
+    std::shared_ptr<WireCodec> codec = std::make_shared<WireCodec>(layout);
+    std::string record = make_wire_test_record(*layout, 7);
+    std::vector<char> encoded(codec->max_encoded_size());
+    std::vector<char> decoded(codec->record_size());
+
+    // Test 8.1: round-trip (복원 불가 필드는 raw bitmap 으로 그대로 보내야 함)
+    std::cout << "\nTest 8.1: encode -> decode round-trip" << std::endl;
+    size_t encoded_size = codec->encode(record.data(), record.size(), encoded.data(), encoded.size());
+    bool ok = encoded_size > 0 && encoded_size < record.size() &&
+              codec->decode(encoded.data(), encoded_size, decoded.data(), decoded.size()) &&
+              memcmp(decoded.data(), record.data(), record.size()) == 0;
+    std::string odd = record;
+    memcpy(&odd[layout->handle("price").offset], "12 45", 5);      // 9 모드에 공백
+    odd[layout->handle("name").offset + 10] = 'x';                  // char 의 NUL 뒤 쓰레기
+    size_t odd_size = codec->encode(odd.data(), odd.size(), encoded.data(), encoded.size());
+    ok = ok && odd_size > 0 &&
+         codec->decode(encoded.data(), odd_size, decoded.data(), decoded.size()) &&
+         memcmp(decoded.data(), odd.data(), odd.size()) == 0;
+    std::cout << "Test 8.1: " << (ok ? "PASSED" : "FAILED") << " (" << record.size() << " -> "
+              << encoded_size << " bytes)" << std::endl;
+    all_passed = all_passed && ok;
+
+    // Test 8.2: 잘린 frame 은 어느 위치에서 잘려도 거부
+    std::cout << "\nTest 8.2: truncated frame" << std::endl;
+    encoded_size = codec->encode(record.data(), record.size(), encoded.data(), encoded.size());
+    WireRecordView view(codec);
+    ok = encoded_size > 0;
+    for (size_t len = 0; ok && len < encoded_size; ++len) {
+        if (codec->decode(encoded.data(), len, decoded.data(), decoded.size()) || view.attach(encoded.data(), len)) {
+            std::cout << "Truncated frame of " << len << " bytes accepted" << std::endl;
+            ok = false;
+        }
+    }
+    ok = ok && view.attach(encoded.data(), encoded_size) &&
+         view.getString(layout->handle("code")) == "CODE7";
+    std::cout << "Test 8.2: " << (ok ? "PASSED" : "FAILED") << std::endl;
+    all_passed = all_passed && ok;
+
+    // Test 8.3: 필드 길이보다 긴 텍스트 길이 / 다른 레이아웃 header 는 거부
+    std::cout << "\nTest 8.3: oversized length" << std::endl;
+    size_t first = sizeof(WireRecordHeader) + (codec->segment_count() + 7) / 8;
+    ok = codec->segment(0).kind == WireCodec::SEG_TEXT && encoded[first] == 5;     // "CODE7"
+    std::vector<char> bad(encoded.begin(), encoded.begin() + encoded_size);
+    bad[first] = static_cast<char>(codec->segment(0).length + 1);
+    ok = ok && !codec->decode(bad.data(), bad.size(), decoded.data(), decoded.size()) &&
+         !view.attach(bad.data(), bad.size());
+    bad.assign(encoded.begin(), encoded.begin() + encoded_size);
+    WireRecordHeader header;
+    memcpy(&header, bad.data(), sizeof(header));
+    header.record_size += 1;
+    memcpy(bad.data(), &header, sizeof(header));
+    ok = ok && !codec->decode(bad.data(), bad.size(), decoded.data(), decoded.size()) &&
+         !codec->decode(encoded.data(), encoded_size, decoded.data(), decoded.size() - 1);
+    std::cout << "Test 8.3: " << (ok ? "PASSED" : "FAILED") << std::endl;
+    all_passed = all_passed && ok;
+
+    // Test 8.4: compact 구독자와 raw 구독자가 같은 레코드를 받는지
+    std::cout << "\nTest 8.4: compact / uncompressed subscribers" << std::endl;
+    const int count = 20;
+    struct event_base* pub_base = event_base_new();
+    struct event_base* sub_base = event_base_new();
+    try {
+        std::vector<std::string> compact_records;
+        std::vector<std::string> raw_records;
+        std::atomic<bool> done{false};
+
+        SimplePublisherV2 publisher(pub_base);
+        publisher.set_publisher_id(8);
+        publisher.set_publisher_name("WirePublisher");
+        publisher.set_address(UNIX_SOCKET, "/tmp/test_wire.sock");
+        publisher.init_database("");       // memory DB: 이전 실행의 메시지가 복구로 섞이지 않게
+        remove("./data/sequence_data/WirePublisher.seq");
+        remove("./data/sequence_data/WirePublisher.topics");
+        publisher.add_wire_layout(TOPIC1, layout);
+        if (!publisher.init_sequence_storage(SimplePubSub::StorageType::FILE_STORAGE) || !publisher.start(1)) {
+            throw std::runtime_error("failed to start publisher");
+        }
+
+        SimpleSubscriber compact(sub_base);
+        compact.set_address(UNIX_SOCKET, "/tmp/test_wire.sock");
+        compact.set_subscription_mask(ALL_TOPICS);
+        compact.set_wire_encoding(WIRE_ENCODING_COMPACT);
+        compact.add_wire_layout(TOPIC1, layout);
+        compact.set_topic_callback([&](DataTopic, const char* data, int size) {
+            compact_records.push_back(std::string(data, size));
+        });
+
+        SimpleSubscriber raw(sub_base);
+        raw.set_address(UNIX_SOCKET, "/tmp/test_wire.sock");
+        raw.set_subscription_mask(ALL_TOPICS);
+        raw.set_topic_callback([&](DataTopic, const char* data, int size) {
+            raw_records.push_back(std::string(data, size));
+        });
+
+        std::thread pub_thread([&]() {
+            // 구독 요청을 처리해 두 구독자가 live 가 된 뒤 발행 (복구로 받으면 원래 형식이라 compact 경로를 못 탄다)
+            auto publish_at = std::chrono::steady_clock::now() + std::chrono::seconds(2);
+            bool published = false;
+            while (!done) {
+                if (!published && std::chrono::steady_clock::now() >= publish_at) {
+                    for (int i = 0; i < count; ++i) {
+                        std::string r = make_wire_test_record(*layout, i);
+                        publisher.publish(TOPIC1, r.data(), r.size());
+                    }
+                    published = true;
+                }
+                struct timeval tv = {0, 100000};
+                event_base_loopexit(pub_base, &tv);
+                event_base_dispatch(pub_base);
+            }
+        });
+
+        bool connected = compact.connect() && raw.connect();
+        auto start_time = std::chrono::steady_clock::now();
+        while (connected && (compact_records.size() < static_cast<size_t>(count) ||
+                             raw_records.size() < static_cast<size_t>(count)) &&
+               std::chrono::steady_clock::now() - start_time < std::chrono::seconds(10)) {
+            struct timeval tv = {0, 100000};
+            event_base_loopexit(sub_base, &tv);
+            event_base_dispatch(sub_base);
+        }
+        done = true;
+        pub_thread.join();
+
+        ok = connected && compact_records.size() == static_cast<size_t>(count) && compact_records == raw_records &&
+             publisher.get_wire_encoded() > 0 && compact.get_wire_messages() > 0 && compact.get_wire_decode_errors() == 0;
+        for (int i = 0; ok && i < count; ++i) {
+            ok = raw_records[i] == make_wire_test_record(*layout, i);
+        }
+        std::cout << "Test 8.4: " << (ok ? "PASSED" : "FAILED") << " (compact " << compact_records.size()
+                  << ", raw " << raw_records.size() << ", encoded " << publisher.get_wire_encoded()
+                  << ", decode errors " << compact.get_wire_decode_errors() << ")" << std::endl;
+        all_passed = all_passed && ok;
+
+        compact.stop();
+        raw.stop();
+        publisher.stop();
+    } catch (const std::exception& e) {
+        std::cout << "Test 8.4: FAILED (exception: " << e.what() << ")" << std::endl;
+        all_passed = false;
+    }
+    event_base_free(pub_base);
+    event_base_free(sub_base);
+
+    std::cout << "Test 8 Result: " << (all_passed ? "PASSED" : "FAILED") << std::endl;
+    return all_passed;
+}
+
+// 메시지 1 건 발행 후 idle 로 두다가 SIGKILL 된 publisher 의 DB 를 다시 열어 그 메시지가 남았는지
+static bool check_idle_crash(const char* label, BlockCodec codec) {
+    const std::string db_path = std::string("/tmp/test_idle_crash_") + label;
+    const std::string name = std::string("IdleCrashPublisher_") + label;
+    remove((db_path + ".idx").c_str());
+    remove((db_path + ".data").c_str());
+    remove(("./data/sequence_data/" + name + ".seq").c_str());
+    remove(("./data/sequence_data/" + name + ".topics").c_str());
+
+    std::cout << std::flush;
+    pid_t pid = fork();
+    if (pid < 0) {
+        return false;
+    }
+    if (pid == 0) {
+        // SIGKILL 로 끝나므로 소멸자 / close 는 불리지 않는다
+        struct event_base* base = event_base_new();
+        SimplePublisherV2* publisher = new SimplePublisherV2(base);
+        publisher->set_publisher_id(9);
+        publisher->set_publisher_name(name);
+        publisher->set_address(UNIX_SOCKET, db_path + ".sock");
+        publisher->set_database_compression(codec);
+        if (!publisher->init_database(db_path) ||
+            !publisher->init_sequence_storage(SimplePubSub::StorageType::FILE_STORAGE) || !publisher->start(1)) {
+            _exit(2);
+        }
+        const char message[] = "idle crash";
+        publisher->publish(TOPIC1, message, sizeof(message) - 1);
+        // 더 발행하지 않고 DB_SAM_BLOCK_MAX_DELAY_MS 를 넘겨 loop 만 돌림
+        struct timeval idle = {2, 0};
+        event_base_loopexit(base, &idle);
+        event_base_dispatch(base);
+        kill(getpid(), SIGKILL);
+        _exit(3);
+    }
+
+    int status = 0;
+    waitpid(pid, &status, 0);
+    bool killed = WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+    DB_SAM db(db_path);
+    bool ok = killed && db.open() && db.max_seq() == 1 && db.durable_max_seq() == 1;
+    std::cout << "Test 9 (" << label << "): " << (ok ? "PASSED" : "FAILED") << " (killed=" << killed
+              << ", max_seq=" << db.max_seq() << ")" << std::endl;
+    db.close();
+    return ok;
+}
+
+// Test Case 9: 발행이 끊긴 뒤 crash 해도 DB 버퍼 (raw fstream / 압축 block) 가 타이머로 기록되는지
+bool test_db_crash_after_idle() {
+    std::cout << "\n=== Test 9: DB Flush After Idle Crash ===" << std::endl;
+    bool raw_ok = check_idle_crash("raw", BLOCK_CODEC_NONE);
+    bool block_ok = check_idle_crash("block", BLOCK_CODEC_LZ);
+    bool ok = raw_ok && block_ok;
+    std::cout << "Test 9 Result: " << (ok ? "PASSED" : "FAILED") << std::endl;
+    return ok;
+}
+
+// 구독자 <-> publisher Unix socket 중계. publisher -> 구독자 방향에서 global seq 가 drop_seq 인 TopicMessage 를 버린다
+// (drop_all: 구간 복구로 다시 온 것까지 버려 누락 구간이 열린 채로 남음)
+class DropProxy {
+public:
+    DropProxy(const std::string& listen_path, const std::string& target_path, uint32_t drop_seq, bool drop_all)
+        : _listen_path(listen_path), _target_path(target_path), _drop_seq(drop_seq), _drop_all(drop_all),
+          _listen_fd(-1), _running(false), _dropped(0) {}
+    ~DropProxy() { stop(); }
+
+    bool start() {
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, _listen_path.c_str(), sizeof(addr.sun_path) - 1);
+        unlink(_listen_path.c_str());
+        _listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (_listen_fd < 0 || bind(_listen_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0 ||
+            listen(_listen_fd, 1) != 0) {
+            return false;
+        }
+        _running = true;
+        _thread = std::thread(&DropProxy::run, this);
+        return true;
+    }
+
+    void stop() {
+        _running = false;
+        if (_thread.joinable()) _thread.join();
+        if (_listen_fd >= 0) close(_listen_fd);
+        _listen_fd = -1;
+        unlink(_listen_path.c_str());
+    }
+
+    int dropped() const { return _dropped.load(); }
+
+private:
+    static bool write_all(int fd, const char* p, size_t n) {
+        while (n > 0) {
+            ssize_t w = write(fd, p, n);
+            if (w <= 0) return false;
+            p += w;
+            n -= static_cast<size_t>(w);
+        }
+        return true;
+    }
+
+    // 완성된 프레임만 골라서 전달, 남은 조각은 pending 에 둔다
+    bool forward_frames(std::string& pending, int to_fd) {
+        PubSubTopicFrame frame;
+        size_t pos = 0;
+        while (pos < pending.size()) {
+            FrameInfo info;
+            FrameStatus st = frame.decode(pending.data() + pos, pending.size() - pos, info);
+            if (st == FRAME_NEED_MORE || (st == FRAME_OK && info.length > pending.size() - pos)) break;
+            const char* p = pending.data() + pos;
+            uint32_t magic;
+            memcpy(&magic, p, sizeof(magic));
+            bool drop = false;
+            if (st == FRAME_OK && magic == MAGIC_TOPIC_MSG) {
+                const TopicMessage* msg = reinterpret_cast<const TopicMessage*>(p);
+                drop = msg->global_seq == _drop_seq && (_drop_all || _dropped.load() == 0);
+            }
+            if (drop) {
+                _dropped++;
+            } else if (!write_all(to_fd, p, info.length)) {
+                return false;
+            }
+            pos += info.length;
+        }
+        pending.erase(0, pos);
+        return true;
+    }
+
+    void run() {
+        int client_fd = -1;
+        while (_running && client_fd < 0) {
+            pollfd pfd = {_listen_fd, POLLIN, 0};
+            if (poll(&pfd, 1, 100) > 0) client_fd = accept(_listen_fd, nullptr, nullptr);
+        }
+        if (client_fd < 0) return;
+        sockaddr_un addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, _target_path.c_str(), sizeof(addr.sun_path) - 1);
+        int target_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (target_fd < 0 || ::connect(target_fd, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            close(client_fd);
+            if (target_fd >= 0) close(target_fd);
+            return;
+        }
+        std::string pending;
+        char buf[65536];
+        while (_running) {
+            pollfd pfds[2] = {{client_fd, POLLIN, 0}, {target_fd, POLLIN, 0}};
+            if (poll(pfds, 2, 100) <= 0) continue;
+            if (pfds[0].revents) {
+                ssize_t n = read(client_fd, buf, sizeof(buf));
+                if (n <= 0 || !write_all(target_fd, buf, static_cast<size_t>(n))) break;
+            }
+            if (pfds[1].revents) {
+                ssize_t n = read(target_fd, buf, sizeof(buf));
+                if (n <= 0) break;
+                pending.append(buf, static_cast<size_t>(n));
+                if (!forward_frames(pending, client_fd)) break;
+            }
+        }
+        close(client_fd);
+        close(target_fd);
+    }
+
+    std::string _listen_path;
+    std::string _target_path;
+    uint32_t _drop_seq;
+    bool _drop_all;
+    int _listen_fd;
+    std::atomic<bool> _running;
+    std::atomic<int> _dropped;
+    std::thread _thread;
+};
+
+// 두 event base 를 짧게 번갈아 돌리며 done 이 될 때까지 (timeout_ms 초과 시 false)
+static bool pump_until(struct event_base* a, struct event_base* b, int timeout_ms, const std::function<bool()>& done) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+    while (!done()) {
+        if (std::chrono::steady_clock::now() > deadline) return false;
+        struct timeval tv = {0, 10000};
+        if (a) {
+            event_base_loopexit(a, &tv);
+            event_base_dispatch(a);
+        }
+        if (b) {
+            event_base_loopexit(b, &tv);
+            event_base_dispatch(b);
+        }
+    }
+    return true;
+}
+
+static void remove_gap_test_files(const std::string& db_path, const std::string& pub_name, const std::string& sub_name) {
+    remove((db_path + ".idx").c_str());
+    remove((db_path + ".data").c_str());
+    remove(("./data/sequence_data/" + pub_name + ".seq").c_str());
+    remove(("./data/sequence_data/" + pub_name + ".topics").c_str());
+    if (!sub_name.empty()) {
+        remove(("./data/sequence_data/sub_" + sub_name + "_" + pub_name + ".seq").c_str());
+        remove(("./data/sequence_data/sub_" + sub_name + "_" + pub_name + ".topics").c_str());
+    }
+}
+
+static void publish_numbered(SimplePublisherV2& publisher, int from, int to) {
+    for (int i = from; i <= to; ++i) {
+        std::string message = std::to_string(i);
+        publisher.publish(TOPIC1, message.c_str(), message.length());
+    }
+}
+
+// 10.1: ONLINE 구독자에게 seq 5 가 빠지면 RECG 로 그 구간만 채우고 뒤 메시지는 계속 전달
+static bool check_online_gap_fill() {
+    const std::string pub_sock = "/tmp/test_gap_pub.sock";
+    const std::string proxy_sock = "/tmp/test_gap_proxy.sock";
+    const std::string db_path = "/tmp/test_gap_fill";
+    remove_gap_test_files(db_path, "GapFillPublisher", "");
+
+    struct event_base* pub_base = event_base_new();
+    struct event_base* sub_base = event_base_new();
+    bool ok = false;
+    {
+        SimplePublisherV2 publisher(pub_base);
+        publisher.set_publisher_id(10);
+        publisher.set_publisher_name("GapFillPublisher");
+        publisher.set_address(UNIX_SOCKET, pub_sock);
+        DropProxy proxy(proxy_sock, pub_sock, 5, false);
+        std::vector<int> received;
+        SimpleSubscriber subscriber(sub_base);
+        subscriber.set_address(UNIX_SOCKET, proxy_sock);
+        subscriber.set_subscription_mask(ALL_TOPICS);
+        subscriber.set_topic_callback([&](DataTopic, const char* data, int size) {
+            received.push_back(std::stoi(std::string(data, size)));
+        });
+
+        if (publisher.init_database(db_path) &&
+            publisher.init_sequence_storage(SimplePubSub::StorageType::FILE_STORAGE) && publisher.start(1) &&
+            proxy.start() && subscriber.connect() &&
+            pump_until(pub_base, sub_base, 5000, [&]() { return subscriber.get_status() == CLIENT_ONLINE; })) {
+            publish_numbered(publisher, 1, 4);
+            pump_until(pub_base, sub_base, 5000, [&]() { return received.size() >= 4; });
+            publish_numbered(publisher, 5, 10);
+            pump_until(pub_base, sub_base, 5000, [&]() { return received.size() >= 10; });
+            // 끝난 뒤 중복이 더 오지 않는지 잠깐 더
+            pump_until(pub_base, sub_base, 200, []() { return false; });
+
+            std::vector<int> sorted = received;
+            std::sort(sorted.begin(), sorted.end());
+            bool complete = sorted.size() == 10;
+            for (size_t i = 0; complete && i < sorted.size(); ++i) complete = sorted[i] == static_cast<int>(i) + 1;
+            auto pos5 = std::find(received.begin(), received.end(), 5);
+            auto pos6 = std::find(received.begin(), received.end(), 6);
+            bool kept_flowing = pos5 != received.end() && pos6 < pos5;
+            ok = proxy.dropped() == 1 && complete && kept_flowing && subscriber.get_gaps_detected() == 1 &&
+                 subscriber.get_gaps_filled() == 1 && subscriber.get_gap_fallbacks() == 0 &&
+                 subscriber.get_pending_gaps() == 0 && subscriber.get_status() == CLIENT_ONLINE;
+            std::cout << "Test 10.1: " << (ok ? "PASSED" : "FAILED") << " (received " << received.size()
+                      << ", dropped " << proxy.dropped() << ", gaps detected " << subscriber.get_gaps_detected()
+                      << ", filled " << subscriber.get_gaps_filled() << ", fallbacks " << subscriber.get_gap_fallbacks()
+                      << ", seq 6 before 5 " << kept_flowing << ")" << std::endl;
+        } else {
+            std::cout << "Test 10.1: FAILED (setup)" << std::endl;
+        }
+        subscriber.stop();
+        proxy.stop();
+        publisher.stop();
+    }
+    event_base_free(pub_base);
+    event_base_free(sub_base);
+    return ok;
+}
+
+// 10.2: 누락 구간 (seq 5) 이 열린 채 SIGKILL 된 구독자가 다시 시작하면 구간 앞 (seq 4) 부터 이어받는다
+static bool check_gap_crash_restart() {
+    const std::string pub_sock = "/tmp/test_gap_crash_pub.sock";
+    const std::string proxy_sock = "/tmp/test_gap_crash_proxy.sock";
+    const std::string db_path = "/tmp/test_gap_crash";
+    const std::string pub_name = "GapCrashPublisher";
+    const std::string sub_name = "GapCrashSubscriber";
+    remove_gap_test_files(db_path, pub_name, sub_name);
+
+    int ready[2], online[2];
+    if (pipe(ready) != 0 || pipe(online) != 0) {
+        return false;
+    }
+    std::cout << std::flush;
+    pid_t pid = fork();
+    if (pid < 0) {
+        return false;
+    }
+    if (pid == 0) {
+        // 구독자 프로세스: proxy 가 seq 5 를 계속 버리므로 구간 timeout (1초) 전에 SIGKILL
+        char c;
+        if (read(ready[0], &c, 1) != 1) _exit(2);
+        struct event_base* base = event_base_new();
+        DropProxy* proxy = new DropProxy(proxy_sock, pub_sock, 5, true);
+        SimpleSubscriber* subscriber = new SimpleSubscriber(base);
+        subscriber->set_client_info(1, sub_name, 11, pub_name);
+        subscriber->set_publisher_name(pub_name);
+        subscriber->set_address(UNIX_SOCKET, proxy_sock);
+        subscriber->set_subscription_mask(ALL_TOPICS);
+        subscriber->set_sequence_persist_policy(1, 0);
+        int count = 0;
+        subscriber->set_topic_callback([&](DataTopic, const char*, int) { count++; });
+        if (!subscriber->init_sequence_storage(SimplePubSub::StorageType::FILE_STORAGE) || !proxy->start() ||
+            !subscriber->connect() ||
+            !pump_until(base, nullptr, 5000, [&]() { return subscriber->get_status() == CLIENT_ONLINE; })) {
+            _exit(3);
+        }
+        if (write(online[1], "o", 1) != 1) _exit(4);
+        if (!pump_until(base, nullptr, 800, [&]() { return count >= 9; }) || subscriber->get_pending_gaps() != 1) {
+            _exit(5);
+        }
+        kill(getpid(), SIGKILL);
+        _exit(6);
+    }
+
+    struct event_base* pub_base = event_base_new();
+    struct event_base* sub_base = event_base_new();
+    bool ok = false;
+    {
+        SimplePublisherV2 publisher(pub_base);
+        publisher.set_publisher_id(11);
+        publisher.set_publisher_name(pub_name);
+        publisher.set_address(UNIX_SOCKET, pub_sock);
+        bool started = publisher.init_database(db_path) &&
+                       publisher.init_sequence_storage(SimplePubSub::StorageType::FILE_STORAGE) && publisher.start(1);
+        char c = 0;
+        bool child_online = started && write(ready[1], "r", 1) == 1;
+        // 구독자가 ONLINE 이 될 때까지 publisher 를 돌림
+        child_online = child_online && pump_until(pub_base, nullptr, 5000, [&]() {
+            pollfd pfd = {online[0], POLLIN, 0};
+            return poll(&pfd, 1, 0) > 0;
+        }) && read(online[0], &c, 1) == 1;
+        if (child_online) {
+            publish_numbered(publisher, 1, 10);
+        }
+        int status = 0;
+        if (!pump_until(pub_base, nullptr, 5000, [&]() { return waitpid(pid, &status, WNOHANG) == pid; })) {
+            kill(pid, SIGKILL);
+            waitpid(pid, &status, 0);
+            status = 0;     // 구독자가 스스로 죽지 못함
+        }
+        bool killed = WIFSIGNALED(status) && WTERMSIG(status) == SIGKILL;
+
+        // 재시작: 저장된 seq 는 구간 앞 (4) 이므로 복구는 5 부터
+        std::vector<int> received;
+        SimpleSubscriber subscriber(sub_base);
+        subscriber.set_client_info(1, sub_name, 11, pub_name);
+        subscriber.set_publisher_name(pub_name);
+        subscriber.set_address(UNIX_SOCKET, pub_sock);
+        subscriber.set_subscription_mask(ALL_TOPICS);
+        subscriber.set_topic_callback([&](DataTopic, const char* data, int size) {
+            received.push_back(std::stoi(std::string(data, size)));
+        });
+        if (killed && subscriber.init_sequence_storage(SimplePubSub::StorageType::FILE_STORAGE) && subscriber.connect()) {
+            pump_until(pub_base, sub_base, 5000, [&]() { return received.size() >= 6; });
+            pump_until(pub_base, sub_base, 200, []() { return false; });
+        }
+        std::vector<int> expected = {5, 6, 7, 8, 9, 10};
+        ok = killed && received == expected;
+        std::cout << "Test 10.2: " << (ok ? "PASSED" : "FAILED") << " (killed=" << killed << ", exit="
+                  << (WIFEXITED(status) ? WEXITSTATUS(status) : 0) << ", restart received " << received.size()
+                  << (received.empty() ? "" : ", first " + std::to_string(received.front())) << ")" << std::endl;
+        subscriber.stop();
+        publisher.stop();
+    }
+    event_base_free(pub_base);
+    event_base_free(sub_base);
+    close(ready[0]);
+    close(ready[1]);
+    close(online[0]);
+    close(online[1]);
+    return ok;
+}
+
+// Test Case 10: ONLINE 구독자 구간 복구 (RECG) 와 구간이 열린 채 crash 한 뒤 재시작
+bool test_online_gap_recovery() {
+    std::cout << "\n=== Test 10: Online Gap Recovery ===" << std::endl;
+    bool fill_ok = check_online_gap_fill();
+    bool restart_ok = check_gap_crash_restart();
+    bool ok = fill_ok && restart_ok;
+    std::cout << "Test 10 Result: " << (ok ? "PASSED" : "FAILED") << std::endl;
+    return ok;
+}
+
+// HashTable 을 같은 파일로 다시 연다 (요청 포맷이 달라도 기존 파일 포맷을 따라야 함)
+static std::unique_ptr<HashTable> open_resize_table(const std::string& name, int version, bool lock_free) {
+    std::unique_ptr<HashTable> table(new HashTable(64, 16, 256, true, name.c_str(), true));
+    table->setIndexVersion(version);
+    table->setLockFreeRead(lock_free);
+    if (table->init() != HASH_OK) {
+        return nullptr;
+    }
+    return table;
+}
+
+static std::string resize_key(int i) {
+    return "KEY" + std::to_string(i);
+}
+
+// keys [0, count) 중 deleted 를 뺀 key 가 dataIndex i 로 보이는지
+static bool check_resize_keys(HashTable& table, int count, const std::vector<int>& deleted) {
+    for (int i = 0; i < count; ++i) {
+        bool gone = std::find(deleted.begin(), deleted.end(), i) != deleted.end();
+        int result = table.get(resize_key(i).c_str());
+        if (result != (gone ? HASH_ERROR_KEY_NOT_FOUND : i)) {
+            std::cout << "  key " << resize_key(i) << ": got " << result << std::endl;
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool put_resize_keys(HashTable& table, int from, int to) {
+    for (int i = from; i < to; ++i) {
+        if (table.put(resize_key(i).c_str(), i) != HASH_OK) return false;
+    }
+    return true;
+}
+
+// 11.x: 200 key 를 넣고 두 번 resize (.g1 -> .g2), migration 도중과 끝난 뒤 다시 열어 put/get/del 확인
+static bool check_resize_generations(int version, bool lock_free) {
+    const std::string name = "test_resize_v" + std::to_string(version) + (lock_free ? "_lf" : "");
+    const char* exts[] = {".hashindex", ".dataindex", ".revindex"};
+    for (const std::string& file : {name, name + ".g1", name + ".g2"}) {
+        for (const char* ext : exts) remove(("mmap/" + file + ext).c_str());
+    }
+    int other_version = version == HASH_INDEX_V1_CHAINED ? HASH_INDEX_V2_OPEN_ADDRESSING : HASH_INDEX_V1_CHAINED;
+    std::vector<int> deleted;
+    bool ok = false;
+    std::string step = "create";
+    do {
+        std::unique_ptr<HashTable> table = open_resize_table(name, version, lock_free);
+        if (!table || table->getIndexVersion() != version || !put_resize_keys(*table, 0, 200)) break;
+
+        // 1차 resize: put 한번에 HASH_MIGRATE_BATCH 개만 옮기므로 put 두 번 뒤에도 200 개 중 일부는 base 에 남는다
+        step = "resize g1";
+        if (table->resize(128, 512) != HASH_OK || !put_resize_keys(*table, 200, 202) || !table->is_resizing()) break;
+        if (table->del(resize_key(3).c_str()) != HASH_OK || table->del(resize_key(201).c_str()) != HASH_OK) break;
+        deleted = {3, 201};
+        if (table->del(resize_key(3).c_str()) != HASH_ERROR_KEY_NOT_FOUND) break;
+        table.reset();
+
+        // migration 도중 다시 열기 (다른 포맷을 요청해도 파일 포맷 유지)
+        step = "reopen mid g1";
+        table = open_resize_table(name, other_version, lock_free);
+        if (!table || table->getIndexVersion() != version || !table->is_resizing() ||
+            table->get_generation() != 0 || !check_resize_keys(*table, 202, deleted)) break;
+
+        // 2차 resize: 남은 g1 migration 을 끝내고 g1 -> g2
+        step = "resize g2";
+        if (table->resize(256, 1024) != HASH_OK || !put_resize_keys(*table, 202, 204) || !table->is_resizing()) break;
+        if (table->del(resize_key(100).c_str()) != HASH_OK || table->del(resize_key(203).c_str()) != HASH_OK) break;
+        deleted.push_back(100);
+        deleted.push_back(203);
+        if (!check_resize_keys(*table, 204, deleted) || table->get_total_data_count() != 1024) break;
+        table.reset();
+
+        step = "reopen mid g2";
+        table = open_resize_table(name, version, lock_free);
+        if (!table || !table->is_resizing() || !check_resize_keys(*table, 204, deleted)) break;
+
+        // 다시 연 뒤 남은 migration 을 migrate() 로 끝까지
+        step = "migrate";
+        while (table->migrate(INT_MAX) > 0) {}
+        if (table->is_resizing() || !check_resize_keys(*table, 204, deleted) || !put_resize_keys(*table, 204, 300)) break;
+        table.reset();
+
+        step = "reopen migrated";
+        table = open_resize_table(name, version, lock_free);
+        if (!table || table->is_resizing() || table->get_total_data_count() != 1024 ||
+            !check_resize_keys(*table, 300, deleted) || table->get("MISSING") != HASH_ERROR_KEY_NOT_FOUND) break;
+        ok = true;
+    } while (false);
+
+    std::cout << "Test 11 (v" << version << (lock_free ? ", lock-free read" : "") << "): "
+              << (ok ? "PASSED" : "FAILED at " + step) << std::endl;
+    return ok;
+}
+
+// Test Case 11: HashTable v1 / v2 index 파일과 online resize generation (.g<N>) 을 다시 열기
+bool test_hashtable_resize_generations() {
+    std::cout << "\n=== Test 11: HashTable Index Formats and Resize Generations ===" << std::endl;
+    bool ok = true;
+    for (int version : {HASH_INDEX_V1_CHAINED, HASH_INDEX_V2_OPEN_ADDRESSING}) {
+        for (bool lock_free : {false, true}) {
+            ok = check_resize_generations(version, lock_free) && ok;
+        }
+    }
+    std::cout << "Test 11 Result: " << (ok ? "PASSED" : "FAILED") << std::endl;
+    return ok;
+}
+
+// dir 안의 파일과 dir 자신을 지움 (하위 디렉터리 없음)
+static void remove_dir_files(const std::string& dir) {
+    DIR* d = opendir(dir.c_str());
+    if (!d) return;
+    while (struct dirent* e = readdir(d)) {
+        if (strcmp(e->d_name, ".") != 0 && strcmp(e->d_name, "..") != 0) {
+            remove((dir + "/" + e->d_name).c_str());
+        }
+    }
+    closedir(d);
+    rmdir(dir.c_str());
+}
+
+static std::string db_test_message(uint32_t seq, size_t size) {
+    std::string message = "message " + std::to_string(seq) + " ";
+    message.resize(size, static_cast<char>('a' + seq % 26));
+    return message;
+}
+
+// [from, to] 가 get_range 한번으로 순서대로 원래 내용 그대로 읽히는지
+static bool check_db_range(const MessageDB& db, uint32_t from, uint32_t to, size_t size) {
+    uint32_t expected = from;
+    bool ranged = db.get_range(from, to, [&](uint32_t seq, const SAM_INDEX&, const void* data, size_t len) {
+        if (seq != expected || std::string(static_cast<const char*>(data), len) != db_test_message(seq, size)) {
+            return false;
+        }
+        expected++;
+        return true;
+    });
+    return ranged && expected == to + 1;
+}
+
+// Test Case 12: SEGMENT_SAM segment roll / max_segments 보존 / 다시 열기
+bool test_segment_sam_retention() {
+    std::cout << "\n=== Test 12: SEGMENT_SAM Rolling and Retention ===" << std::endl;
+    const std::string base = "/tmp/test_segment_sam";
+    const size_t size = 200;
+    remove_dir_files(base + ".seg");
+
+    bool ok = false;
+    std::string step = "open";
+    do {
+        // 4KB segment 에 200 바이트 메시지 -> segment 당 20 개, 3 개만 보존
+        SegmentPolicy policy(4096, 0, 3, false);
+        std::unique_ptr<SEGMENT_SAM> db(new SEGMENT_SAM(base, policy));
+        if (!db->open()) break;
+        step = "write";
+        for (uint32_t seq = 1; seq <= 100; ++seq) {
+            std::string message = db_test_message(seq, size);
+            if (!db->put(message.data(), message.size())) break;
+        }
+        if (db->max_seq() != 100 || db->segment_count() != 3) break;
+
+        // 지운 segment 의 seq 는 조회 실패, 남은 구간은 segment 를 넘어 이어 읽힘
+        step = "retention";
+        uint32_t oldest = db->min_seq();
+        std::string data;
+        if (oldest <= 1 || db->count() != 100 - oldest + 1 || db->get(oldest - 1, data) || db->get(1, data) ||
+            db->get_range(1, 100, [](uint32_t, const SAM_INDEX&, const void*, size_t) { return true; }) ||
+            !check_db_range(*db, oldest, 100, size) || !db->verify_integrity()) break;
+
+        // 수동 roll 뒤 retire_before 로 앞 segment 정리 (기록 중인 segment 는 남김)
+        step = "roll";
+        if (!db->roll_segment() || db->segment_count() != 3) break;
+        std::string message = db_test_message(101, size);
+        if (!db->put(message.data(), message.size()) || db->retire_before(101) != 2 || db->segment_count() != 1 ||
+            db->min_seq() != 101 || !check_db_range(*db, 101, 101, size)) break;
+        db->close();
+        if (db->roll_segment() || db->put(message.data(), message.size())) break;
+
+        // 다시 열면 남은 segment 와 sequence 를 이어받는다
+        step = "reopen";
+        db.reset(new SEGMENT_SAM(base, policy));
+        if (!db->open() || db->min_seq() != 101 || db->max_seq() != 101 || db->get(100, data)) break;
+        message = db_test_message(102, size);
+        if (!db->put(message.data(), message.size()) || !check_db_range(*db, 101, 102, size)) break;
+        db->close();
+        ok = true;
+    } while (false);
+    remove_dir_files(base + ".seg");
+
+    std::cout << "Test 12 Result: " << (ok ? "PASSED" : "FAILED at " + step) << std::endl;
+    return ok;
+}
+
+static long file_size(const std::string& path) {
+    struct stat st;
+    return stat(path.c_str(), &st) == 0 ? static_cast<long>(st.st_size) : -1;
+}
+
+static void remove_mmap_sam_files(const std::string& base) {
+    remove((base + ".idx").c_str());
+    remove((base + ".data").c_str());
+}
+
+// Test Case 13: MMAP_SAM 다시 열기 / 비정상 종료 뒤 preallocated tail / 잘린 index tail
+bool test_mmap_sam_torn_tail() {
+    std::cout << "\n=== Test 13: MMAP_SAM Reopen and Torn Tail ===" << std::endl;
+    const std::string base = "/tmp/test_mmap_sam";
+    const size_t size = 200;
+    // chunk 를 작게 잡아 50 건이 data chunk 여러 개에 걸치게 한다
+    const MMapSyncPolicy policy(MMapSyncMode::EVERY_MESSAGE);
+    const size_t data_chunk = 4096;
+    const size_t index_entries = 64;
+    remove_mmap_sam_files(base);
+
+    bool ok = false;
+    std::string step = "crash";
+    do {
+        // 자식이 50 건 쓰고 close 없이 SIGKILL -> 파일은 chunk 크기로 preallocate 된 채 남는다
+        pid_t pid = fork();
+        if (pid < 0) break;
+        if (pid == 0) {
+            MMAP_SAM db(base, policy, data_chunk, index_entries);
+            if (!db.open()) _exit(1);
+            for (uint32_t seq = 1; seq <= 50; ++seq) {
+                std::string message = db_test_message(seq, size);
+                if (!db.put(message.data(), message.size())) _exit(1);
+            }
+            kill(getpid(), SIGKILL);
+            _exit(1);
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+        if (!WIFSIGNALED(status) || WTERMSIG(status) != SIGKILL ||
+            file_size(base + ".idx") <= static_cast<long>(50 * sizeof(SAM_INDEX))) break;
+
+        // 0 으로 채워진 tail 은 기록으로 보지 않고 51 부터 이어 쓴다
+        step = "recover";
+        std::unique_ptr<MMAP_SAM> db(new MMAP_SAM(base, policy, data_chunk, index_entries));
+        std::string data;
+        if (!db->open() || db->count() != 50 || db->get(51, data) || db->get(0, data) ||
+            !check_db_range(*db, 1, 50, size)) break;
+        std::string message = db_test_message(51, size);
+        if (!db->put(message.data(), message.size()) || !check_db_range(*db, 1, 51, size)) break;
+        db->close();
+        if (file_size(base + ".idx") != static_cast<long>(51 * sizeof(SAM_INDEX))) break;
+
+        // close 가 truncate 한 파일은 DB_SAM 으로도 그대로 읽힌다
+        step = "db_sam";
+        {
+            DB_SAM file_db(base);
+            if (!file_db.open() || file_db.count() != 51 || !check_db_range(file_db, 1, 51, size)) break;
+            file_db.close();
+        }
+
+        // index 끝에 쓰다 만 entry (절반, garbage) -> 무시되고 그 자리에 52 가 덮어써진다
+        step = "torn";
+        FILE* f = fopen((base + ".idx").c_str(), "ab");
+        if (!f) break;
+        char garbage[sizeof(SAM_INDEX) / 2];
+        memset(garbage, 0xff, sizeof(garbage));
+        fwrite(garbage, 1, sizeof(garbage), f);
+        fclose(f);
+        db.reset(new MMAP_SAM(base, policy, data_chunk, index_entries));
+        if (!db->open() || db->count() != 51 || db->get(52, data)) break;
+        message = db_test_message(52, size);
+        if (!db->put(message.data(), message.size()) || !check_db_range(*db, 1, 52, size) ||
+            !db->verify_integrity()) break;
+        db->close();
+
+        // 디렉터리를 만들 수 없는 경로는 open 실패
+        step = "bad_path";
+        MMAP_SAM bad("/tmp/test_mmap_sam_missing/a/b", policy, data_chunk, index_entries);
+        if (bad.open() || bad.put(message.data(), message.size())) break;
+        ok = true;
+    } while (false);
+    remove_mmap_sam_files(base);
+
+    std::cout << "Test 13 Result: " << (ok ? "PASSED" : "FAILED at " + step) << std::endl;
+    return ok;
+}
+
+static bool append_shm_message(ShmTopicLog& log, uint32_t seq, size_t size) {
+    std::string payload = db_test_message(seq, size);
+    std::vector<char> buf(sizeof(TopicMessage) + payload.size());
+    TopicMessage* msg = reinterpret_cast<TopicMessage*>(buf.data());
+    msg->magic = MAGIC_TOPIC_MSG;
+    msg->topic = DataTopic::TOPIC1;
+    msg->global_seq = seq;
+    msg->topic_seq = seq;
+    msg->timestamp = get_current_timestamp();
+    msg->data_size = static_cast<uint32_t>(payload.size());
+    memcpy(msg->data, payload.data(), payload.size());
+    return log.append(msg, buf.size());
+}
+
+// reader 의 다음 레코드가 seq 이고 내용이 그대로인지
+static bool read_shm_message(ShmTopicLog& reader, uint32_t seq, size_t size) {
+    const TopicMessage* msg = nullptr;
+    size_t len = 0;
+    if (reader.next(msg, len) != ShmTopicLog::READ_OK || len != sizeof(TopicMessage) + size) return false;
+    return msg->global_seq == seq && msg->data_size == size &&
+           std::string(msg->data, msg->data_size) == db_test_message(seq, size) && reader.still_valid();
+}
+
+// Test Case 14: shm topic log 왕복 / seek / 느린 reader overrun 후 head 로 복구
+bool test_shm_topic_log_overrun() {
+    std::cout << "\n=== Test 14: Shm Topic Log Seek and Overrun ===" << std::endl;
+    const std::string name = "/test_shm_topic_log";
+    const size_t size = 100;
+
+    bool ok = false;
+    std::string step = "open";
+    ShmTopicLog writer;
+    do {
+        ShmTopicLog reader;
+        if (reader.open("/test_shm_topic_log_missing", 1) || reader.is_open()) break;
+        if (!writer.create(name, 0, 0) || writer.capacity() != 64 * 1024 || !reader.open(name, 1)) break;
+
+        step = "round_trip";
+        const TopicMessage* msg = nullptr;
+        size_t len = 0;
+        if (reader.next(msg, len) != ShmTopicLog::READ_EMPTY) break;
+        for (uint32_t seq = 1; seq <= 10; ++seq) {
+            if (!append_shm_message(writer, seq, size)) break;
+        }
+        // publish 전에는 보이지 않는다
+        if (reader.next(msg, len) != ShmTopicLog::READ_EMPTY) break;
+        writer.publish(10);
+        bool read_all = true;
+        for (uint32_t seq = 1; seq <= 10 && read_all; ++seq) {
+            read_all = read_shm_message(reader, seq, size);
+        }
+        if (!read_all || reader.next(msg, len) != ShmTopicLog::READ_EMPTY) break;
+
+        // window 안의 seq 로 rewind, head + 1 은 끝, 그 너머는 실패
+        step = "seek";
+        if (!reader.seek(3) || !read_shm_message(reader, 3, size) || !read_shm_message(reader, 4, size)) break;
+        if (!reader.seek(11) || reader.next(msg, len) != ShmTopicLog::READ_EMPTY || reader.seek(12)) break;
+
+        // reader 가 멈춘 채 window 를 몇 바퀴 덮어쓰면 overrun, 밀려난 seq 로는 seek 실패
+        step = "overrun";
+        const uint32_t last = 2010;
+        for (uint32_t seq = 11; seq <= last; ++seq) {
+            if (!append_shm_message(writer, seq, size)) break;
+            if (seq % 100 == 0) writer.publish(seq);
+        }
+        writer.publish(last);
+        if (reader.head_seq() != last || reader.next(msg, len) != ShmTopicLog::READ_OVERRUN ||
+            reader.seek(1) || reader.seek(11)) break;
+
+        // 최신 seq 로 다시 맞추면 이어 읽는다
+        step = "recover";
+        if (!reader.seek(last - 1) || !read_shm_message(reader, last - 1, size) ||
+            !read_shm_message(reader, last, size) || reader.next(msg, len) != ShmTopicLog::READ_EMPTY) break;
+        if (!append_shm_message(writer, last + 1, size)) break;
+        writer.publish(last + 1);
+        if (!read_shm_message(reader, last + 1, size)) break;
+        ok = true;
+    } while (false);
+    writer.unlink();
+    writer.close();
+
+    std::cout << "Test 14 Result: " << (ok ? "PASSED" : "FAILED at " + step) << std::endl;
+    return ok;
+}
+
+// 그룹 A 의 multicast datagram 을 loopback 에서 받아 그룹 B 로 다시 보내는 중계기
+// drop_seq 를 담은 data datagram 하나만 버린다 (datagram 유실 재현)
+class McastDropForwarder {
+public:
+    McastDropForwarder(const std::string& from_group, int from_port, const std::string& to_group, int to_port,
+                       uint32_t drop_seq)
+        : _from_group(from_group), _to_group(to_group), _from_port(from_port), _to_port(to_port),
+          _drop_seq(drop_seq), _recv_fd(-1), _send_fd(-1), _running(false), _dropped(0), _forwarded(0) {}
+    ~McastDropForwarder() { stop(); }
+
+    bool start() {
+        struct in_addr loopback;
+        inet_pton(AF_INET, "127.0.0.1", &loopback);
+
+        _recv_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        int on = 1;
+        setsockopt(_recv_fd, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on));
+        sockaddr_in bind_addr;
+        memset(&bind_addr, 0, sizeof(bind_addr));
+        bind_addr.sin_family = AF_INET;
+        bind_addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        bind_addr.sin_port = htons(_from_port);
+        struct ip_mreq mreq;
+        inet_pton(AF_INET, _from_group.c_str(), &mreq.imr_multiaddr);
+        mreq.imr_interface = loopback;
+        if (_recv_fd < 0 || bind(_recv_fd, reinterpret_cast<sockaddr*>(&bind_addr), sizeof(bind_addr)) != 0 ||
+            setsockopt(_recv_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &mreq, sizeof(mreq)) != 0) {
+            return false;
+        }
+
+        _send_fd = socket(AF_INET, SOCK_DGRAM, 0);
+        unsigned char loop = 1;
+        memset(&_to_addr, 0, sizeof(_to_addr));
+        _to_addr.sin_family = AF_INET;
+        _to_addr.sin_port = htons(_to_port);
+        inet_pton(AF_INET, _to_group.c_str(), &_to_addr.sin_addr);
+        if (_send_fd < 0 || setsockopt(_send_fd, IPPROTO_IP, IP_MULTICAST_IF, &loopback, sizeof(loopback)) != 0 ||
+            setsockopt(_send_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop)) != 0) {
+            return false;
+        }
+        _running = true;
+        _thread = std::thread(&McastDropForwarder::run, this);
+        return true;
+    }
+
+    void stop() {
+        _running = false;
+        if (_thread.joinable()) _thread.join();
+        if (_recv_fd >= 0) close(_recv_fd);
+        if (_send_fd >= 0) close(_send_fd);
+        _recv_fd = _send_fd = -1;
+    }
+
+    int dropped() const { return _dropped; }
+    int forwarded() const { return _forwarded; }
+
+private:
+    void run() {
+        std::vector<char> buf(65536);
+        while (_running) {
+            pollfd pfd = {_recv_fd, POLLIN, 0};
+            if (poll(&pfd, 1, 20) <= 0) continue;
+            ssize_t n = recv(_recv_fd, buf.data(), buf.size(), 0);
+            if (n < static_cast<ssize_t>(sizeof(MulticastHeader))) continue;
+            MulticastHeader hdr;
+            memcpy(&hdr, buf.data(), sizeof(hdr));
+            if (_dropped == 0 && hdr.count > 0 && hdr.first_seq <= _drop_seq && _drop_seq < hdr.first_seq + hdr.count) {
+                _dropped++;
+                continue;
+            }
+            if (sendto(_send_fd, buf.data(), n, 0, reinterpret_cast<sockaddr*>(&_to_addr), sizeof(_to_addr)) == n) {
+                _forwarded++;
+            }
+        }
+    }
+
+    std::string _from_group;
+    std::string _to_group;
+    int _from_port;
+    int _to_port;
+    uint32_t _drop_seq;
+    int _recv_fd;
+    int _send_fd;
+    sockaddr_in _to_addr;
+    std::atomic<bool> _running;
+    std::atomic<int> _dropped;
+    std::atomic<int> _forwarded;
+    std::thread _thread;
+};
+
+static bool is_numbered_sequence(const std::vector<int>& received, int count) {
+    if (received.size() != static_cast<size_t>(count)) return false;
+    for (int i = 0; i < count; ++i) {
+        if (received[i] != i + 1) return false;
+    }
+    return true;
+}
+
+// Test Case 15: multicast datagram 유실을 TCP(socket) 복구로 채움 / multicast 를 못 여는 구독자는 socket 으로 수신
+bool test_multicast_gap_fill() {
+    std::cout << "\n=== Test 15: Multicast Gap Fill over Socket ===" << std::endl;
+    const std::string pub_sock = "/tmp/test_mcast_pub.sock";
+    const std::string db_path = "/tmp/test_mcast_gap";
+    remove_gap_test_files(db_path, "McastPublisher", "");
+
+    struct event_base* pub_base = event_base_new();
+    struct event_base* sub_base = event_base_new();
+    bool ok = false;
+    {
+        SimplePublisherV2 publisher(pub_base);
+        publisher.set_publisher_id(15);
+        publisher.set_publisher_name("McastPublisher");
+        publisher.set_address(UNIX_SOCKET, pub_sock);
+        McastDropForwarder forwarder("239.255.15.1", 31501, "239.255.15.2", 31502, 5);
+
+        std::vector<int> received;
+        SimpleSubscriber subscriber(sub_base);
+        subscriber.set_client_info(1, "McastSub", 15, "McastPublisher");
+        subscriber.set_address(UNIX_SOCKET, pub_sock);
+        subscriber.set_multicast("239.255.15.2:31502", "127.0.0.1");
+        subscriber.set_subscription_mask(ALL_TOPICS);
+        subscriber.set_topic_callback([&](DataTopic, const char* data, int size) {
+            received.push_back(std::stoi(std::string(data, size)));
+        });
+
+        // multicast 주소가 잘못된 구독자는 socket 구독으로 내려간다
+        std::vector<int> fallback_received;
+        SimpleSubscriber fallback(sub_base);
+        fallback.set_client_info(2, "McastFallbackSub", 15, "McastPublisher");
+        fallback.set_address(UNIX_SOCKET, pub_sock);
+        fallback.set_multicast("not-a-group", "127.0.0.1");
+        fallback.set_subscription_mask(ALL_TOPICS);
+        fallback.set_topic_callback([&](DataTopic, const char* data, int size) {
+            fallback_received.push_back(std::stoi(std::string(data, size)));
+        });
+
+        if (publisher.init_database(db_path) &&
+            publisher.init_sequence_storage(SimplePubSub::StorageType::FILE_STORAGE) &&
+            publisher.enable_multicast("239.255.15.1:31501", "127.0.0.1") && publisher.start(1) &&
+            forwarder.start() && subscriber.connect() && fallback.connect() &&
+            pump_until(pub_base, sub_base, 5000, [&]() {
+                return subscriber.get_status() == CLIENT_ONLINE && subscriber.is_multicast_active() &&
+                       fallback.get_status() == CLIENT_ONLINE;
+            })) {
+            // 메시지마다 datagram 하나가 되도록 한 건씩 발행
+            for (int i = 1; i <= 10; ++i) {
+                publish_numbered(publisher, i, i);
+                pump_until(pub_base, sub_base, 30, []() { return false; });
+            }
+            pump_until(pub_base, sub_base, 5000, [&]() {
+                return received.size() >= 10 && fallback_received.size() >= 10;
+            });
+            pump_until(pub_base, sub_base, 200, []() { return false; });
+
+            ok = forwarder.dropped() == 1 && is_numbered_sequence(received, 10) &&
+                 subscriber.get_multicast_gaps() >= 1 && subscriber.get_multicast_messages() >= 9 &&
+                 subscriber.get_status() == CLIENT_ONLINE && is_numbered_sequence(fallback_received, 10) &&
+                 !fallback.is_multicast_active() && fallback.get_multicast_messages() == 0;
+            std::cout << "Test 15: received " << received.size() << " (multicast " << subscriber.get_multicast_messages()
+                      << ", gaps " << subscriber.get_multicast_gaps() << ", dropped " << forwarder.dropped()
+                      << "), fallback received " << fallback_received.size() << std::endl;
+        } else {
+            std::cout << "Test 15: setup failed" << std::endl;
+        }
+        fallback.stop();
+        subscriber.stop();
+        forwarder.stop();
+        publisher.stop();
+    }
+    event_base_free(pub_base);
+    event_base_free(sub_base);
+    remove_gap_test_files(db_path, "McastPublisher", "");
+
+    std::cout << "Test 15 Result: " << (ok ? "PASSED" : "FAILED") << std::endl;
+    return ok;
+}
+
 // Main test runner
 int main() {
     signal(SIGINT, signal_handler);
@@ -891,7 +2023,7 @@ int main() {
     std::cout << "Running comprehensive integration tests..." << std::endl;
 
     int passed = 0;
-    int total = 2;
+    int total = 10;
 
     // Run only HashMaster specific tests for now
     try {
@@ -908,6 +2040,38 @@ int main() {
             passed++;
         }
 
+        if (test_wire_codec()) {
+            passed++;
+        }
+
+        if (test_db_crash_after_idle()) {
+            passed++;
+        }
+
+        if (test_online_gap_recovery()) {
+            passed++;
+        }
+
+        if (test_hashtable_resize_generations()) {
+            passed++;
+        }
+
+        if (test_segment_sam_retention()) {
+            passed++;
+        }
+
+        if (test_mmap_sam_torn_tail()) {
+            passed++;
+        }
+
+        if (test_shm_topic_log_overrun()) {
+            passed++;
+        }
+
+        if (test_multicast_gap_fill()) {
+            passed++;
+        }
+
     } catch (const std::exception& e) {
         std::cerr << "Fatal exception during tests: " << e.what() << std::endl;
         return 1;
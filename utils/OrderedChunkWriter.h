@@ -0,0 +1,129 @@
+#ifndef ORDERED_CHUNK_WRITER_H
+#define ORDERED_CHUNK_WRITER_H
+
+#include <condition_variable>
+#include <cstdio>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * OrderedChunkWriter - 큰 파일 viewer 출력용 병렬 format + 순서대로 streaming
+ *
+ * 전체를 chunk (레코드 / sequence 구간) 로 나눠 worker 스레드들이 format(chunk, out) 을 부르고,
+ * 호출한 스레드가 결과를 chunk 순서대로 바로 fwrite 한다 (출력 순서는 스레드 수와 관계없이 같음).
+ * 동시에 들고 있는 결과는 threads * 4 chunk 까지라서 파일 크기와 관계없이 메모리가 일정하다.
+ * max_lines > 0 이면 그 줄 수까지만 쓰고 나머지 chunk 는 format 하지 않는다.
+ * format 이 false 를 돌려주면 그 chunk 결과까지 쓰고 멈춘다.
+ */
+class OrderedChunkWriter {
+public:
+    typedef std::function<bool(size_t chunk, std::string& out)> FormatFn;
+
+    explicit OrderedChunkWriter(int threads, FILE* out = stdout)
+        : _threads(threads < 1 ? 1 : threads), _out(out), _lines(0) {}
+
+    /* 쓴 줄 수 반환 */
+    size_t run(size_t chunks, const FormatFn& format, size_t max_lines = 0) {
+        const size_t window = static_cast<size_t>(_threads) * 4;
+        std::vector<Slot> slots(window);
+        std::mutex mutex;
+        std::condition_variable cv;
+        size_t next = 0;        // 다음에 format 할 chunk
+        size_t written = 0;     // 다음에 쓸 chunk
+        bool stop = false;
+        _lines = 0;
+
+        auto worker = [&]() {
+            std::string text;
+            for (;;) {
+                size_t chunk;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return stop || next >= chunks || next < written + window; });
+                    if (stop || next >= chunks) return;
+                    chunk = next++;
+                }
+                text.clear();
+                bool more = format(chunk, text);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    Slot& slot = slots[chunk % window];
+                    slot.text.swap(text);
+                    slot.last = !more;
+                    slot.ready = true;
+                }
+                cv.notify_all();
+            }
+        };
+
+        std::vector<std::thread> workers;
+        for (int i = 0; i < _threads; ++i) {
+            workers.emplace_back(worker);
+        }
+
+        std::string text;
+        while (written < chunks && !stop) {
+            bool last;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                Slot& slot = slots[written % window];
+                cv.wait(lock, [&] { return slot.ready; });
+                text.swap(slot.text);
+                last = slot.last;
+                slot.ready = false;
+                written++;
+            }
+            cv.notify_all();
+            if (!write(text, max_lines) || last) {
+                std::lock_guard<std::mutex> lock(mutex);
+                stop = true;
+            }
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stop = true;
+        }
+        cv.notify_all();
+        for (auto& t : workers) {
+            t.join();
+        }
+        fflush(_out);
+        return _lines;
+    }
+
+private:
+    struct Slot {
+        std::string text;
+        bool ready = false;
+        bool last = false;
+    };
+
+    int _threads;
+    FILE* _out;
+    size_t _lines;
+
+    // max_lines 에 닿으면 false
+    bool write(const std::string& text, size_t max_lines) {
+        if (max_lines == 0) {
+            fwrite(text.data(), 1, text.size(), _out);
+            for (char c : text) {
+                if (c == '\n') _lines++;
+            }
+            return true;
+        }
+        size_t pos = 0;
+        while (pos < text.size() && _lines < max_lines) {
+            size_t nl = text.find('\n', pos);
+            size_t end = nl == std::string::npos ? text.size() : nl + 1;
+            fwrite(text.data() + pos, 1, end - pos, _out);
+            if (nl != std::string::npos) _lines++;
+            pos = end;
+        }
+        return _lines < max_lines;
+    }
+};
+
+#endif // ORDERED_CHUNK_WRITER_H
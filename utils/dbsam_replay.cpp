@@ -0,0 +1,200 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <ctime>
+#include <event2/event.h>
+
+#include "pubsub/DBReplayer.h"
+#include "pubsub/SimplePublisherV2.h"
+
+using namespace std;
+
+// DB_SAM 기록을 다시 흘려보내는 도구 (부하 시험 / 장애 재현)
+//   publish 대상이 없으면 sink 없이 읽기만 해서 replay 자체 처리량을 잰다
+
+static DBReplayer* g_replayer = nullptr;
+
+static void on_signal(int) {
+    if (g_replayer) g_replayer->stop();
+}
+
+static void printUsage(const char* program_name) {
+    cout << "Usage: " << program_name << " <db_path> [options]" << endl;
+    cout << endl;
+    cout << "Pacing (default: original timestamps):" << endl;
+    cout << "  --speed=<N>                      - N x original speed" << endl;
+    cout << "  --max                            - As fast as possible" << endl;
+    cout << "Range:" << endl;
+    cout << "  --start=<seq>, --end=<seq>       - Sequence range" << endl;
+    cout << "  --since=<time>, --until=<time>   - Time range (HH:MM:SS[.fff] on the recorded day, or epoch ns)" << endl;
+    cout << "  --topics=<mask>                  - Topic mask (default: all)" << endl;
+    cout << "  --batch=<n>                      - Max messages per publish batch (default: 256)" << endl;
+    cout << "Output (default: read only, report throughput):" << endl;
+    cout << "  --publish=unix:<path>            - Republish through a SimplePublisherV2 on a unix socket" << endl;
+    cout << "  --publish=tcp:<port>             - Republish through a SimplePublisherV2 on a tcp port" << endl;
+    cout << "  --name=<publisher_name>          - Publisher name (default: ReplayPub)" << endl;
+    cout << "  --out-db=<path>                  - Publisher DB_SAM path (default: memory)" << endl;
+    cout << "  --wait=<sec>                     - Wait for subscribers before replay (default: 3)" << endl;
+    cout << endl;
+    cout << "Examples:" << endl;
+    cout << "  " << program_name << " ./data/pub.db --max" << endl;
+    cout << "  " << program_name << " ./data/pub.db --since=08:59:50 --until=09:01:00 --speed=10 --publish=unix:/tmp/replay.sock" << endl;
+}
+
+// HH:MM:SS[.fff] 는 첫 메시지 날짜 (local) 기준, 숫자만 있으면 epoch ns
+static bool parseTime(const DBReplayer& replayer, const string& text, uint64_t& timestamp_ns) {
+    if (text.find(':') == string::npos) {
+        timestamp_ns = stoull(text);
+        return true;
+    }
+    int hour = 0, minute = 0;
+    double second = 0;
+    if (sscanf(text.c_str(), "%d:%d:%lf", &hour, &minute, &second) < 2) {
+        cerr << "Error: Invalid time '" << text << "'" << endl;
+        return false;
+    }
+    SAM_INDEX first;
+    time_t base = time(nullptr);
+    if (replayer.get_index(1, first)) {
+        base = static_cast<time_t>(first._timestamp / 1000000000ULL);
+    }
+    struct tm tm_day;
+    localtime_r(&base, &tm_day);
+    tm_day.tm_hour = hour;
+    tm_day.tm_min = minute;
+    tm_day.tm_sec = 0;
+    tm_day.tm_isdst = -1;
+    timestamp_ns = static_cast<uint64_t>(mktime(&tm_day)) * 1000000000ULL + static_cast<uint64_t>(second * 1e9 + 0.5);
+    return true;
+}
+
+static void pump_for(event_base* base, double seconds) {
+    auto until = chrono::steady_clock::now() + chrono::duration_cast<chrono::steady_clock::duration>(
+        chrono::duration<double>(seconds));
+    while (chrono::steady_clock::now() < until) {
+        struct timeval tv = {0, 10000};
+        event_base_loopexit(base, &tv);
+        event_base_dispatch(base);
+    }
+}
+
+int main(int argc, char* argv[]) {
+    if (argc < 2 || string(argv[1]) == "--help") {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    string db_path = argv[1];
+    DBReplayer replayer(db_path);
+    if (!replayer.open()) {
+        return 1;
+    }
+
+    ReplayOptions options;
+    string since, until, publish, name = "ReplayPub", out_db;
+    double wait_sec = 3;
+    for (int i = 2; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--max") {
+            options.pacing = ReplayPacing::MAX;
+        } else if (arg.find("--speed=") == 0) {
+            options.pacing = ReplayPacing::SPEED;
+            options.speed = stod(arg.substr(8));
+        } else if (arg.find("--start=") == 0) {
+            options.start_seq = stoul(arg.substr(8));
+        } else if (arg.find("--end=") == 0) {
+            options.end_seq = stoul(arg.substr(6));
+        } else if (arg.find("--since=") == 0) {
+            since = arg.substr(8);
+        } else if (arg.find("--until=") == 0) {
+            until = arg.substr(8);
+        } else if (arg.find("--topics=") == 0) {
+            options.topic_mask = stoul(arg.substr(9), nullptr, 0);
+        } else if (arg.find("--batch=") == 0) {
+            options.batch_max = stoul(arg.substr(8));
+        } else if (arg.find("--publish=") == 0) {
+            publish = arg.substr(10);
+        } else if (arg.find("--name=") == 0) {
+            name = arg.substr(7);
+        } else if (arg.find("--out-db=") == 0) {
+            out_db = arg.substr(9);
+        } else if (arg.find("--wait=") == 0) {
+            wait_sec = stod(arg.substr(7));
+        } else {
+            cerr << "Error: Unknown option '" << arg << "'" << endl;
+            printUsage(argv[0]);
+            return 1;
+        }
+    }
+    if ((!since.empty() && !parseTime(replayer, since, options.since_ns)) ||
+        (!until.empty() && !parseTime(replayer, until, options.until_ns))) {
+        return 1;
+    }
+
+    event_base* base = nullptr;
+    unique_ptr<SimplePublisherV2> publisher;
+    ReplaySink sink = [](const MessageSlice*, size_t) { return true; };
+    if (!publish.empty()) {
+        base = event_base_new();
+        publisher.reset(new SimplePublisherV2(base));
+        publisher->set_publisher_id(1);
+        publisher->set_publisher_name(name);
+        if (publish.find("unix:") == 0) {
+            publisher->set_address(UNIX_SOCKET, publish.substr(5));
+        } else if (publish.find("tcp:") == 0) {
+            publisher->set_address(TCP_SOCKET, "0.0.0.0", stoi(publish.substr(4)));
+        } else {
+            cerr << "Error: --publish must be unix:<path> or tcp:<port>" << endl;
+            return 1;
+        }
+        publisher->init_sequence_storage(StorageType::FILE_STORAGE);
+        if (!publisher->init_database(out_db, out_db.empty() ? MessageDBType::MEMORY : MessageDBType::FILE) ||
+            !publisher->start(2)) {
+            cerr << "Error: Failed to start publisher" << endl;
+            return 1;
+        }
+        sink = DBReplayer::publisher_sink(*publisher);
+        options.idle = [base]() { event_base_loop(base, EVLOOP_NONBLOCK); };
+        cout << "Waiting " << wait_sec << "s for subscribers on " << publish << endl;
+        pump_for(base, wait_sec);
+    }
+
+    g_replayer = &replayer;
+    signal(SIGINT, on_signal);
+    signal(SIGTERM, on_signal);
+
+    const char* pacing = options.pacing == ReplayPacing::MAX ? "max" :
+                         options.pacing == ReplayPacing::SPEED ? "speed" : "original";
+    cout << "Replaying " << db_path << " (" << replayer.count() << " messages, " << (replayer.is_mapped() ? "mmap" : "block")
+         << ", pacing " << pacing;
+    if (options.pacing == ReplayPacing::SPEED) cout << " x" << options.speed;
+    cout << ")" << endl;
+
+    ReplayStats stats = replayer.run(options, sink);
+    g_replayer = nullptr;
+
+    if (publisher) {
+        // 송신 큐를 비울 시간
+        pump_for(base, 1.0);
+        publisher->stop();
+    }
+
+    cout << "=== Replay Result ===" << endl;
+    cout << "Seq Range: " << stats.first_seq << " - " << stats.last_seq << endl;
+    cout << "Messages: " << stats.messages << " (" << stats.batches << " batches, " << stats.skipped << " skipped)" << endl;
+    cout << "Bytes: " << stats.bytes << endl;
+    cout << fixed << setprecision(3);
+    cout << "Source Span: " << stats.source_span_ns / 1e9 << " s" << endl;
+    cout << "Elapsed: " << stats.elapsed_ns / 1e9 << " s" << endl;
+    cout << "Throughput: " << setprecision(0) << stats.msgs_per_sec() << " msgs/s, "
+         << setprecision(2) << stats.mb_per_sec() << " MB/s" << endl;
+    cout << "Achieved Speed: x" << stats.achieved_speed() << endl;
+    cout << "Max Behind Schedule: " << setprecision(3) << stats.max_behind_ns / 1e6 << " ms" << endl;
+
+    publisher.reset();
+    if (base) event_base_free(base);
+    return 0;
+}
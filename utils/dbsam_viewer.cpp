@@ -9,28 +9,75 @@
 #include <sys/stat.h>
 #include <algorithm>
 #include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <fcntl.h>
+#include <thread>
+#include <atomic>
 #include <unistd.h>
+#include <sys/mman.h>
 
 #include "../common/db_sam.h"
 #include "../HashMaster/BinaryRecord.h"
+#include "../HashMaster/MmapOptions.h"
+#include "OrderedChunkWriter.h"
 
 using namespace std;
 
+// list / search / export 가 한 번에 읽는 seq 수 (chunk 하나 = 스레드 하나의 작업 단위)
+static const uint32_t SCAN_CHUNK_MESSAGES = 4096;
+
+// list / search / export 공통 조건
+struct ScanOptions {
+    uint32_t start_seq;
+    uint32_t end_seq;
+    string key_prefix;      // --key: spec 이 있으면 key 필드, 없으면 메시지 앞부분과 비교
+    int threads;
+
+    ScanOptions() : start_seq(1), end_seq(0), threads(1) {}
+};
+
+typedef function<void(uint32_t seq, const SAM_INDEX& index, const char* data, size_t size, string& out)> MessageFormatFn;
+
 // Forward declarations
 void printUsage(const char* program_name);
 void printDatabaseInfo(const DB_SAM& db);
-void listMessages(const DB_SAM& db, uint32_t start_seq, uint32_t end_seq, bool show_data);
-void searchMessages(const DB_SAM& db, const string& search_term);
-void exportMessages(const DB_SAM& db, const string& output_file, uint32_t start_seq, uint32_t end_seq);
+void listMessages(const DB_SAM& db, const ScanOptions& options, bool show_data);
+void searchMessages(const DB_SAM& db, const string& search_term, const ScanOptions& options);
+void exportMessages(const DB_SAM& db, const string& output_file, const ScanOptions& options);
+size_t scanMessages(const DB_SAM& db, const ScanOptions& options, FILE* out, size_t max_lines, const MessageFormatFn& format);
+bool loadKeyLayout(const string& spec_path, const string& record_type);
+bool ensureSpecLoaded(const string& spec_path);
 void dumpMessage(const DB_SAM& db, uint32_t seq, bool use_binary_record, const string& spec_path, const string& record_type);
 void verifyDatabase(const DB_SAM& db);
 string formatTimestamp(uint64_t timestamp_ns);
+bool parseTime(const DB_SAM& db, const string& text, uint64_t& timestamp_ns);
+bool resolveTimeRange(const DB_SAM& db, const string& since, const string& until, uint32_t& start_seq, uint32_t& end_seq);
 string formatSize(uint64_t size);
 bool isValidSpecPath(const string& path);
 
 // Global variables for BinaryRecord support
 unique_ptr<SpecFileParser> g_spec_parser = nullptr;
 bool g_spec_loaded = false;
+shared_ptr<RecordLayout> g_key_layout;     // --key 비교용 (--spec / --type)
+FieldHandle g_key_handle;
+
+// list / search / export 공통 옵션. 처리하지 않은 인자는 false
+bool parseScanOption(const string& arg, ScanOptions& options, string& spec_path, string& record_type) {
+    if (arg.find("--threads=") == 0) {
+        int threads = atoi(arg.substr(10).c_str());
+        options.threads = threads > 0 ? threads : 1;
+    } else if (arg.find("--key=") == 0) {
+        options.key_prefix = arg.substr(6);
+    } else if (arg.find("--spec=") == 0) {
+        spec_path = arg.substr(7);
+    } else if (arg.find("--type=") == 0) {
+        record_type = arg.substr(7);
+    } else {
+        return false;
+    }
+    return true;
+}
 
 int main(int argc, char* argv[]) {
     if (argc < 2) {
@@ -51,8 +98,9 @@ int main(int argc, char* argv[]) {
     }
 
     try {
-        // Open database
+        // Open database (읽기 전용: 운영 중인 파일을 고치거나 flush 하지 않음)
         DB_SAM db(db_path);
+        db.set_read_only(true);
         if (!db.open()) {
             cerr << "Error: Failed to open database at " << db_path << endl;
             return 1;
@@ -62,6 +110,10 @@ int main(int argc, char* argv[]) {
         cout << "Database: " << db_path << endl;
         cout << "Command: " << command << endl << endl;
 
+        ScanOptions scan;
+        scan.threads = (int)min(max(thread::hardware_concurrency(), 1u), 8u);
+        string scan_spec, scan_type;
+
         // Parse command
         if (command == "info" || command == "i") {
             printDatabaseInfo(db);
@@ -69,24 +121,47 @@ int main(int argc, char* argv[]) {
         } else if (command == "list" || command == "l") {
             uint32_t start_seq = 1;
             uint32_t end_seq = min(10u, db.count());
+            uint32_t count = 0;
             bool show_data = false;
+            string since, until;
 
             // Parse additional arguments
             for (int i = 3; i < argc; i++) {
                 string arg = argv[i];
-                if (arg == "--data" || arg == "-d") {
+                if (parseScanOption(arg, scan, scan_spec, scan_type)) {
+                    continue;
+                } else if (arg == "--data" || arg == "-d") {
                     show_data = true;
                 } else if (arg.find("--start=") == 0) {
                     start_seq = stoul(arg.substr(8));
                 } else if (arg.find("--end=") == 0) {
                     end_seq = stoul(arg.substr(6));
                 } else if (arg.find("--count=") == 0) {
-                    uint32_t count = stoul(arg.substr(8));
+                    count = stoul(arg.substr(8));
                     end_seq = start_seq + count - 1;
+                } else if (arg.find("--since=") == 0) {
+                    since = arg.substr(8);
+                } else if (arg.find("--until=") == 0) {
+                    until = arg.substr(8);
+                }
+            }
+
+            if (!since.empty() || !until.empty()) {
+                if (!resolveTimeRange(db, since, until, start_seq, end_seq)) {
+                    return 1;
+                }
+                // --until 이 없으면 --count (기본 10) 개만
+                if (until.empty()) {
+                    end_seq = start_seq + (count ? count : 10) - 1;
                 }
             }
 
-            listMessages(db, start_seq, end_seq, show_data);
+            if (!scan.key_prefix.empty() && !scan_spec.empty() && !loadKeyLayout(scan_spec, scan_type)) {
+                return 1;
+            }
+            scan.start_seq = start_seq;
+            scan.end_seq = end_seq;
+            listMessages(db, scan, show_data);
 
         } else if (command == "dump" || command == "d") {
             if (argc < 4) {
@@ -116,12 +191,39 @@ int main(int argc, char* argv[]) {
         } else if (command == "search" || command == "s") {
             if (argc < 4) {
                 cerr << "Error: search command requires search term" << endl;
-                cerr << "Usage: " << argv[0] << " <db_path> search <term>" << endl;
+                cerr << "Usage: " << argv[0] << " <db_path> search <term> [--start=<seq>] [--end=<seq>] [--key=<prefix>]" << endl;
                 return 1;
             }
 
             string search_term = argv[3];
-            searchMessages(db, search_term);
+            uint32_t start_seq = 1;
+            uint32_t end_seq = db.max_seq();
+            string since, until;
+
+            for (int i = 4; i < argc; i++) {
+                string arg = argv[i];
+                if (parseScanOption(arg, scan, scan_spec, scan_type)) {
+                    continue;
+                } else if (arg.find("--start=") == 0) {
+                    start_seq = stoul(arg.substr(8));
+                } else if (arg.find("--end=") == 0) {
+                    end_seq = stoul(arg.substr(6));
+                } else if (arg.find("--since=") == 0) {
+                    since = arg.substr(8);
+                } else if (arg.find("--until=") == 0) {
+                    until = arg.substr(8);
+                }
+            }
+
+            if ((!since.empty() || !until.empty()) && !resolveTimeRange(db, since, until, start_seq, end_seq)) {
+                return 1;
+            }
+            if (!scan.key_prefix.empty() && !scan_spec.empty() && !loadKeyLayout(scan_spec, scan_type)) {
+                return 1;
+            }
+            scan.start_seq = start_seq;
+            scan.end_seq = end_seq;
+            searchMessages(db, search_term, scan);
 
         } else if (command == "export" || command == "e") {
             if (argc < 4) {
@@ -133,18 +235,34 @@ int main(int argc, char* argv[]) {
             string output_file = argv[3];
             uint32_t start_seq = 1;
             uint32_t end_seq = db.count();
+            string since, until;
 
             // Parse additional arguments
             for (int i = 4; i < argc; i++) {
                 string arg = argv[i];
-                if (arg.find("--start=") == 0) {
+                if (parseScanOption(arg, scan, scan_spec, scan_type)) {
+                    continue;
+                } else if (arg.find("--start=") == 0) {
                     start_seq = stoul(arg.substr(8));
                 } else if (arg.find("--end=") == 0) {
                     end_seq = stoul(arg.substr(6));
+                } else if (arg.find("--since=") == 0) {
+                    since = arg.substr(8);
+                } else if (arg.find("--until=") == 0) {
+                    until = arg.substr(8);
                 }
             }
 
-            exportMessages(db, output_file, start_seq, end_seq);
+            if ((!since.empty() || !until.empty()) && !resolveTimeRange(db, since, until, start_seq, end_seq)) {
+                return 1;
+            }
+
+            if (!scan.key_prefix.empty() && !scan_spec.empty() && !loadKeyLayout(scan_spec, scan_type)) {
+                return 1;
+            }
+            scan.start_seq = start_seq;
+            scan.end_seq = end_seq;
+            exportMessages(db, output_file, scan);
 
         } else if (command == "verify" || command == "v") {
             verifyDatabase(db);
@@ -175,13 +293,21 @@ void printUsage(const char* program_name) {
     cout << "    --end=<seq>                    - End sequence number (default: 10)" << endl;
     cout << "    --count=<n>                    - Number of messages to show" << endl;
     cout << "    --data, -d                     - Show message data (first 32 bytes in hex + ASCII)" << endl;
+    cout << "    --since=<time>                 - Start from first message at/after time (HH:MM:SS[.fff] or epoch ns)" << endl;
+    cout << "    --until=<time>                 - End at last message at/before time" << endl;
+    cout << "    --key=<prefix>                 - Only messages whose key starts with prefix" << endl;
+    cout << "                                     (key field with --spec/--type, else leading bytes)" << endl;
+    cout << "    --threads=<n>                  - Format with n threads (default: min(cores, 8))" << endl;
     cout << "  dump, d <seq> [options]          - Dump specific message" << endl;
     cout << "    --spec=<path>                  - Use BinaryRecord with spec file/directory" << endl;
     cout << "    --type=<record_type>           - Record type for BinaryRecord parsing" << endl;
-    cout << "  search, s <term>                 - Search messages containing term" << endl;
+    cout << "  search, s <term> [options]       - Search messages containing term" << endl;
+    cout << "    --start/--end/--since/--until/--key/--threads (same as list)" << endl;
     cout << "  export, e <file> [options]       - Export messages to file" << endl;
     cout << "    --start=<seq>                  - Start sequence number" << endl;
     cout << "    --end=<seq>                    - End sequence number" << endl;
+    cout << "    --since=<time>, --until=<time> - Time range (same format as list)" << endl;
+    cout << "    --key/--spec/--type/--threads  - Same as list" << endl;
     cout << "  verify, v                        - Verify database integrity" << endl;
     cout << endl;
     cout << "Examples:" << endl;
@@ -190,6 +316,8 @@ void printUsage(const char* program_name) {
     cout << "  " << program_name << " /tmp/test.db dump 1 --spec=config/SPECs --type=TRADE_DATA" << endl;
     cout << "  " << program_name << " /tmp/test.db search \"error\"" << endl;
     cout << "  " << program_name << " /tmp/test.db export output.txt --start=1 --end=100" << endl;
+    cout << "  " << program_name << " /tmp/test.db list --since=09:00:00 --until=09:00:05" << endl;
+    cout << "  " << program_name << " /tmp/test.db list --count=1000000 --key=7203 --spec=config/SPECs --type=TRADE_DATA --threads=8" << endl;
 }
 
 void printDatabaseInfo(const DB_SAM& db) {
@@ -214,147 +342,210 @@ void printDatabaseInfo(const DB_SAM& db) {
     cout << "Database Open: " << (db.isOpen() ? "Yes" : "No") << endl;
 }
 
-void listMessages(const DB_SAM& db, uint32_t start_seq, uint32_t end_seq, bool show_data) {
-    cout << "=== Message List (seq " << start_seq << " to " << end_seq << ") ===" << endl;
-
-    uint32_t max_seq = db.max_seq();
-    if (end_seq > max_seq) {
-        end_seq = max_seq;
-    }
+// 메시지 한 줄: seq, size, offset, timestamp [+ 앞 32 bytes hex / ASCII]
+static void formatListRow(uint32_t seq, const SAM_INDEX& index, const char* data, size_t size, bool show_data, string& out) {
+    char buf[128];
+    snprintf(buf, sizeof(buf), "%u\t%u\t%lld\t\t", seq, index._size, (long long)index._seek);
+    out += buf;
+    out += formatTimestamp(index._timestamp);
+    out += '\t';
+
+    if (show_data) {
+        // Show binary data in hex + ASCII format (first 32 bytes)
+        size_t display_size = min(size, size_t(32));
+
+        // Hex part
+        for (size_t i = 0; i < display_size; i++) {
+            snprintf(buf, sizeof(buf), "%02x", static_cast<unsigned int>(static_cast<unsigned char>(data[i])));
+            out += buf;
+            if (i < display_size - 1) out += ' ';
+        }
 
-    cout << "Seq\tSize\tOffset\t\tTimestamp\t\tData (first 32 bytes)" << endl;
-    cout << "---\t----\t------\t\t---------\t\t--------------------" << endl;
+        // Padding for alignment
+        for (size_t i = display_size; i < 32; i++) {
+            out += "   ";
+        }
 
-    for (uint32_t seq = start_seq; seq <= end_seq; seq++) {
-        SAM_INDEX index;
-        string data;
+        out += "  ";
 
-        if (db.get(seq, data)) {
-            // Get index info manually
-            uint32_t buffer_size = data.size() + 100;
-            vector<char> buffer(buffer_size);
-
-            if (db.get(seq, index, buffer.data(), &buffer_size)) {
-                cout << seq << "\t"
-                     << index._size << "\t"
-                     << index._seek << "\t\t"
-                     << formatTimestamp(index._timestamp) << "\t";
-
-                if (show_data) {
-                    // Show binary data in hex + ASCII format (first 32 bytes)
-                    const char* raw_data = data.c_str();
-                    size_t display_size = min(data.size(), size_t(32));
-
-                    // Hex part
-                    for (size_t i = 0; i < display_size; i++) {
-                        cout << setfill('0') << setw(2) << hex << static_cast<unsigned int>(static_cast<unsigned char>(raw_data[i]));
-                        if (i < display_size - 1) cout << " ";
-                    }
+        // ASCII part
+        for (size_t i = 0; i < display_size; i++) {
+            unsigned char c = static_cast<unsigned char>(data[i]);
+            out += isprint(c) ? static_cast<char>(c) : '.';
+        }
 
-                    // Padding for alignment
-                    if (display_size < 32) {
-                        for (size_t i = display_size; i < 32; i++) {
-                            cout << "   ";
-                        }
-                    }
+        if (size > 32) {
+            out += "...";
+        }
+    }
+    out += '\n';
+}
 
-                    cout << "  ";
+void listMessages(const DB_SAM& db, const ScanOptions& options, bool show_data) {
+    cout << "=== Message List (seq " << options.start_seq << " to " << options.end_seq << ") ===" << endl;
 
-                    // ASCII part
-                    for (size_t i = 0; i < display_size; i++) {
-                        char c = raw_data[i];
-                        cout << (isprint(c) ? c : '.');
-                    }
+    cout << "Seq\tSize\tOffset\t\tTimestamp\t\tData (first 32 bytes)" << endl;
+    cout << "---\t----\t------\t\t---------\t\t--------------------" << endl;
+    cout << flush;
 
-                    if (data.size() > 32) {
-                        cout << "...";
-                    }
+    size_t shown = scanMessages(db, options, stdout, 0,
+        [show_data](uint32_t seq, const SAM_INDEX& index, const char* data, size_t size, string& out) {
+            formatListRow(seq, index, data, size, show_data, out);
+        });
 
-                    cout << dec; // Reset to decimal
-                }
-                cout << endl;
-            }
-        } else {
-            cout << seq << "\t[NOT FOUND]" << endl;
-        }
+    if (!options.key_prefix.empty()) {
+        cout << "Matched " << shown << " messages with key prefix \"" << options.key_prefix << "\"" << endl;
     }
 }
 
-void searchMessages(const DB_SAM& db, const string& search_term) {
-    cout << "=== Searching for: \"" << search_term << "\" ===" << endl;
+void searchMessages(const DB_SAM& db, const string& search_term, const ScanOptions& options) {
+    cout << "=== Searching for: \"" << search_term << "\" ===" << endl << flush;
 
-    uint32_t found_count = 0;
-    uint32_t max_seq = db.max_seq();
-
-    for (uint32_t seq = 1; seq <= max_seq; seq++) {
-        string data;
-        if (db.get(seq, data)) {
-            if (data.find(search_term) != string::npos) {
-                SAM_INDEX index;
-                uint32_t buffer_size = data.size() + 100;
-                vector<char> buffer(buffer_size);
-
-                if (db.get(seq, index, buffer.data(), &buffer_size)) {
-                    cout << "Seq " << seq << " [" << formatTimestamp(index._timestamp) << "]: ";
-                    if (data.size() > 80) {
-                        cout << data.substr(0, 80) << "..." << endl;
-                    } else {
-                        cout << data << endl;
-                    }
-                    found_count++;
-                }
+    size_t found_count = scanMessages(db, options, stdout, 0,
+        [&search_term](uint32_t seq, const SAM_INDEX& index, const char* data, size_t size, string& out) {
+            if (std::search(data, data + size, search_term.begin(), search_term.end()) == data + size) {
+                return;
             }
-        }
-    }
+            out += "Seq " + to_string(seq) + " [" + formatTimestamp(index._timestamp) + "]: ";
+            if (size > 80) {
+                out.append(data, 80);
+                out += "...";
+            } else {
+                out.append(data, size);
+            }
+            out += '\n';
+        });
 
     cout << "Found " << found_count << " messages containing \"" << search_term << "\"" << endl;
 }
 
-void exportMessages(const DB_SAM& db, const string& output_file, uint32_t start_seq, uint32_t end_seq) {
+void exportMessages(const DB_SAM& db, const string& output_file, const ScanOptions& options) {
     cout << "=== Exporting messages to: " << output_file << " ===" << endl;
 
-    ofstream out(output_file);
-    if (!out.is_open()) {
+    FILE* out = fopen(output_file.c_str(), "w");
+    if (!out) {
         cerr << "Error: Cannot open output file " << output_file << endl;
         return;
     }
 
-    uint32_t max_seq = db.max_seq();
-    if (end_seq > max_seq) {
-        end_seq = max_seq;
+    uint32_t end_seq = min(options.end_seq, db.max_seq());
+
+    // Write header
+    fprintf(out, "# DB_SAM Export\n");
+    fprintf(out, "# Database: %s\n", db.get_base_path().c_str());
+    fprintf(out, "# Export range: %u to %u\n", options.start_seq, end_seq);
+    fprintf(out, "# Export time: %s\n\n", formatTimestamp(chrono::duration_cast<chrono::nanoseconds>(
+            chrono::system_clock::now().time_since_epoch()).count()).c_str());
+
+    // SEQ / SIZE / TIMESTAMP / DATA / --- 5 줄이 메시지 하나
+    size_t lines = scanMessages(db, options, out, 0,
+        [](uint32_t seq, const SAM_INDEX& index, const char* data, size_t size, string& text) {
+            text += "SEQ=" + to_string(seq) + "\n";
+            text += "SIZE=" + to_string(index._size) + "\n";
+            text += "TIMESTAMP=" + formatTimestamp(index._timestamp) + "\n";
+            text += "DATA=";
+            text.append(data, size);
+            text += "\n---\n";
+        });
+
+    fclose(out);
+    cout << "Exported " << lines / 5 << " messages to " << output_file << endl;
+}
+
+// --key 비교. spec 이 있으면 key 필드 값, 없으면 메시지 앞부분 bytes
+static bool matchesKey(const char* data, size_t size, const string& prefix) {
+    if (prefix.empty()) return true;
+    if (g_key_layout && g_key_handle.valid()) {
+        if ((int)size < g_key_layout->getRecordSize()) return false;
+        BinaryRecordView view(const_cast<char*>(data), (int)size);
+        return view.getValue(g_key_handle).compare(0, prefix.size(), prefix) == 0;
+    }
+    return size >= prefix.size() && memcmp(data, prefix.data(), prefix.size()) == 0;
+}
+
+// 비압축 파일은 chunk 구간을 직접 mmap (PROT_READ) 해서 읽는다. DB_SAM 의 fstream / mutex_ 를
+// 거치지 않으므로 스레드끼리 막히지 않고, 다 읽은 뒤 scan 이 새로 올린 page 만 page cache 에서 내린다.
+static bool scanMappedChunk(const DB_SAM& db, int fd, uint32_t start_seq, uint32_t end_seq,
+                            const string& key_prefix, const MessageFormatFn& format, string& out) {
+    MessageDataRegion region;
+    if (!db.get_data_region(start_seq, end_seq, region)) {
+        return false;
     }
 
-    uint32_t exported_count = 0;
+    const int64_t page = sysconf(_SC_PAGESIZE);
+    int64_t map_offset = region.offset / page * page;
+    size_t map_len = static_cast<size_t>(region.offset + region.length - map_offset);
+    void* addr = mmap(nullptr, map_len, PROT_READ, MAP_SHARED, fd, map_offset);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    vector<unsigned char> resident;
+    bool tracked = mmap_residency(addr, map_len, resident);
 
-    // Write header
-    out << "# DB_SAM Export" << endl;
-    out << "# Database: " << db.get_base_path() << endl;
-    out << "# Export range: " << start_seq << " to " << end_seq << endl;
-    out << "# Export time: " << formatTimestamp(chrono::duration_cast<chrono::nanoseconds>(
-           chrono::system_clock::now().time_since_epoch()).count()) << endl;
-    out << endl;
-
-    for (uint32_t seq = start_seq; seq <= end_seq; seq++) {
+    const char* base = static_cast<const char*>(addr);
+    for (uint32_t seq = region.start_seq; seq <= region.end_seq; seq++) {
         SAM_INDEX index;
-        string data;
+        if (!db.lookup_index(seq, index)) {
+            continue;
+        }
+        if (index._seek < map_offset || index._seek + index._size > map_offset + (int64_t)map_len) {
+            continue;
+        }
+        const char* data = base + (index._seek - map_offset);
+        if (matchesKey(data, index._size, key_prefix)) {
+            format(seq, index, data, index._size, out);
+        }
+    }
 
-        if (db.get(seq, data)) {
-            uint32_t buffer_size = data.size() + 100;
-            vector<char> buffer(buffer_size);
-
-            if (db.get(seq, index, buffer.data(), &buffer_size)) {
-                out << "SEQ=" << seq << endl;
-                out << "SIZE=" << index._size << endl;
-                out << "TIMESTAMP=" << formatTimestamp(index._timestamp) << endl;
-                out << "DATA=" << data << endl;
-                out << "---" << endl;
-                exported_count++;
-            }
+    if (tracked) {
+        mmap_release_cold(addr, map_len, fd, map_offset, resident);
+    }
+    munmap(addr, map_len);
+    return true;
+}
+
+// [start_seq, end_seq] 를 SCAN_CHUNK_MESSAGES 단위로 나눠 options.threads 개 스레드가 format 하고,
+// 결과는 seq 순서대로 out 에 흘려보낸다 (전체를 메모리에 모으지 않음). 출력한 줄 수를 반환.
+size_t scanMessages(const DB_SAM& db, const ScanOptions& options, FILE* out, size_t max_lines, const MessageFormatFn& format) {
+    uint32_t start_seq = max(options.start_seq, 1u);
+    uint32_t end_seq = min(options.end_seq, db.max_seq());
+    if (start_seq > end_seq) {
+        return 0;
+    }
+
+    // 압축 모드는 block 을 풀어야 하므로 get_range (mutex_ 직렬화) 로 읽고 format 만 병렬
+    int fd = -1;
+    if (!db.is_compressed()) {
+        fd = ::open(db.get_data_file_path().c_str(), O_RDONLY);
+        if (fd < 0) {
+            cerr << "Warning: Cannot mmap " << db.get_data_file_path() << ", reading through DB_SAM" << endl;
         }
     }
 
-    out.close();
-    cout << "Exported " << exported_count << " messages to " << output_file << endl;
+    size_t chunks = (static_cast<size_t>(end_seq - start_seq) + SCAN_CHUNK_MESSAGES) / SCAN_CHUNK_MESSAGES;
+    OrderedChunkWriter writer(options.threads, out);
+    size_t lines = writer.run(chunks, [&](size_t chunk, string& text) {
+        uint32_t first = start_seq + static_cast<uint32_t>(chunk * SCAN_CHUNK_MESSAGES);
+        uint32_t last = static_cast<uint32_t>(min<uint64_t>(static_cast<uint64_t>(first) + SCAN_CHUNK_MESSAGES - 1, end_seq));
+
+        if (fd >= 0 && scanMappedChunk(db, fd, first, last, options.key_prefix, format, text)) {
+            return true;
+        }
+        text.clear();
+        db.get_range(first, last, [&](uint32_t seq, const SAM_INDEX& index, const void* data, size_t size) {
+            const char* p = static_cast<const char*>(data);
+            if (matchesKey(p, size, options.key_prefix)) {
+                format(seq, index, p, size, text);
+            }
+            return true;
+        });
+        return true;
+    }, max_lines);
+
+    if (fd >= 0) {
+        ::close(fd);
+    }
+    return lines;
 }
 
 void dumpMessage(const DB_SAM& db, uint32_t seq, bool use_binary_record, const string& spec_path, const string& record_type) {
@@ -419,33 +610,7 @@ void dumpMessage(const DB_SAM& db, uint32_t seq, bool use_binary_record, const s
     if (use_binary_record && !spec_path.empty()) {
         cout << "=== BinaryRecord Parsing ===" << endl;
 
-        // Initialize spec parser if not already done
-        if (!g_spec_loaded) {
-            g_spec_parser = make_unique<SpecFileParser>();
-
-            if (isValidSpecPath(spec_path)) {
-                struct stat path_stat;
-                if (stat(spec_path.c_str(), &path_stat) == 0) {
-                    bool load_success = false;
-                    if (S_ISDIR(path_stat.st_mode)) {
-                        load_success = g_spec_parser->loadFromYamlDirectory(spec_path);
-                    } else {
-                        load_success = g_spec_parser->loadFromFile(spec_path);
-                    }
-
-                    if (load_success) {
-                        g_spec_loaded = true;
-                        cout << "Loaded spec from: " << spec_path << endl;
-                    } else {
-                        cerr << "Warning: Failed to load spec from " << spec_path << endl;
-                    }
-                }
-            } else {
-                cerr << "Warning: Invalid spec path " << spec_path << endl;
-            }
-        }
-
-        if (g_spec_loaded) {
+        if (ensureSpecLoaded(spec_path)) {
             // Determine record type
             string actual_record_type = record_type;
             if (actual_record_type.empty()) {
@@ -498,6 +663,67 @@ void dumpMessage(const DB_SAM& db, uint32_t seq, bool use_binary_record, const s
     }
 }
 
+// spec 파일 / YAML 디렉토리를 한 번만 읽음 (g_spec_parser)
+bool ensureSpecLoaded(const string& spec_path) {
+    if (g_spec_loaded) {
+        return true;
+    }
+    g_spec_parser = make_unique<SpecFileParser>();
+
+    struct stat path_stat;
+    if (!isValidSpecPath(spec_path) || stat(spec_path.c_str(), &path_stat) != 0) {
+        cerr << "Warning: Invalid spec path " << spec_path << endl;
+        return false;
+    }
+
+    bool load_success = false;
+    if (S_ISDIR(path_stat.st_mode)) {
+        load_success = g_spec_parser->loadFromYamlDirectory(spec_path);
+    } else {
+        load_success = g_spec_parser->loadFromFile(spec_path);
+    }
+
+    if (load_success) {
+        g_spec_loaded = true;
+        cout << "Loaded spec from: " << spec_path << endl;
+    } else {
+        cerr << "Warning: Failed to load spec from " << spec_path << endl;
+    }
+    return g_spec_loaded;
+}
+
+// --key 비교 필드: 첫 key 필드, 없으면 첫 필드
+bool loadKeyLayout(const string& spec_path, const string& record_type) {
+    if (!ensureSpecLoaded(spec_path)) {
+        return false;
+    }
+    string type = record_type;
+    if (type.empty()) {
+        auto types = g_spec_parser->getRecordTypes();
+        if (types.empty()) {
+            cerr << "No record types found in spec" << endl;
+            return false;
+        }
+        type = types[0];
+    }
+    g_key_layout = g_spec_parser->getLayout(type);
+    if (!g_key_layout || g_key_layout->getFields().empty()) {
+        cerr << "Error: Record type '" << type << "' not found in spec" << endl;
+        return false;
+    }
+    const auto& fields = g_key_layout->getFields();
+    string key_field = fields[0].name;
+    for (const auto& field : fields) {
+        if (field.isKey) {
+            key_field = field.name;
+            break;
+        }
+    }
+    g_key_handle = g_key_layout->handle(key_field);
+    cout << "Key filter: " << type << "." << key_field << endl;
+    return true;
+}
+
 void verifyDatabase(const DB_SAM& db) {
     cout << "=== Database Verification ===" << endl;
 
@@ -540,15 +766,68 @@ string formatTimestamp(uint64_t timestamp_ns) {
     auto nanoseconds = timestamp_ns % 1000000000ULL;
 
     time_t time_sec = static_cast<time_t>(seconds);
-    struct tm* tm_info = localtime(&time_sec);
+    struct tm tm_info;
+    localtime_r(&time_sec, &tm_info);     // list / export 는 여러 스레드에서 부른다
 
     ostringstream oss;
-    oss << put_time(tm_info, "%Y-%m-%d %H:%M:%S");
+    oss << put_time(&tm_info, "%Y-%m-%d %H:%M:%S");
     oss << "." << setfill('0') << setw(9) << nanoseconds;
 
     return oss.str();
 }
 
+// HH:MM:SS[.fff] 는 DB 첫 메시지 날짜 (local) 기준, 숫자만 있으면 epoch ns
+bool parseTime(const DB_SAM& db, const string& text, uint64_t& timestamp_ns) {
+    if (text.find(':') == string::npos) {
+        timestamp_ns = stoull(text);
+        return true;
+    }
+
+    int hour = 0, minute = 0;
+    double second = 0;
+    if (sscanf(text.c_str(), "%d:%d:%lf", &hour, &minute, &second) < 2) {
+        cerr << "Error: Invalid time '" << text << "' (expected HH:MM:SS[.fff] or epoch ns)" << endl;
+        return false;
+    }
+
+    SAM_INDEX first;
+    time_t base = time(nullptr);
+    uint32_t first_seq = db.seek_time(0);
+    if (first_seq != 0 && db.get_index(first_seq, first)) {
+        base = static_cast<time_t>(first._timestamp / 1000000000ULL);
+    }
+    struct tm tm_day;
+    localtime_r(&base, &tm_day);
+    tm_day.tm_hour = hour;
+    tm_day.tm_min = minute;
+    tm_day.tm_sec = 0;
+    tm_day.tm_isdst = -1;
+    time_t day_sec = mktime(&tm_day);
+    timestamp_ns = static_cast<uint64_t>(day_sec) * 1000000000ULL + static_cast<uint64_t>(second * 1e9 + 0.5);
+    return true;
+}
+
+// 시간 인덱스 (seek_time, 이분 탐색) 로 [since, until] 을 seq 구간으로 바꿈
+bool resolveTimeRange(const DB_SAM& db, const string& since, const string& until, uint32_t& start_seq, uint32_t& end_seq) {
+    uint64_t since_ns = 0, until_ns = 0;
+    if (!since.empty()) {
+        if (!parseTime(db, since, since_ns)) return false;
+        start_seq = db.seek_time(since_ns);
+        if (start_seq == 0) {
+            start_seq = db.get_next_sequence();     // since 이후 메시지 없음
+        }
+    }
+    if (!until.empty()) {
+        if (!parseTime(db, until, until_ns)) return false;
+        uint32_t after = db.seek_time(until_ns + 1);
+        end_seq = after == 0 ? db.max_seq() : after - 1;
+    }
+    cout << "Time range: " << (since.empty() ? string("-") : formatTimestamp(since_ns)) << " ~ "
+         << (until.empty() ? string("-") : formatTimestamp(until_ns))
+         << " -> seq " << start_seq << " to " << end_seq << endl << endl;
+    return true;
+}
+
 string formatSize(uint64_t size) {
     const char* units[] = {"B", "KB", "MB", "GB", "TB"};
     int unit_index = 0;
@@ -1,23 +1,47 @@
 #include "../HashMaster/HashMaster.h"
+#include "../HashMaster/HashMasterReader.h"
 #include "../HashMaster/BinaryRecord.h"
+#include "OrderedChunkWriter.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <vector>
 #include <memory>
+#include <thread>
 #include <sys/stat.h>
 
+// --list 를 나눠 읽는 단위 (record index, bitmap word 경계)
+static const int LIST_CHUNK_RECORDS = 64 * 1024;
+
+// 조회 (--search-*) 만 HashMaster 로 열고 (index 필요), 요약 / 목록은 HashMasterReader 로 읽기 전용 scan 한다.
 class HashMasterViewer {
 private:
     HashMaster* hashMaster;
     bool ownHashMaster;
     HashMasterConfig config;
+    HashMasterReader reader;
     std::shared_ptr<RecordLayout> recordLayout;
     SpecFileParser specParser;
+    std::vector<FieldHandle> columns;   // 목록에 보일 앞쪽 필드
+    FieldHandle keyHandle;              // --prefix 비교 필드 (첫 key 필드, 없으면 첫 필드)
     
 public:
     HashMasterViewer() : hashMaster(nullptr), ownHashMaster(false) {}
     
+    // 읽기 전용 매핑 (운영 중인 파일도 건드리지 않음)
+    bool openReader(const std::string& filename) {
+        if (!reader.open(filename)) {
+            return false;
+        }
+        config._filename = filename;
+        config._max_record_count = reader.header()._max_record_count;
+        config._max_record_size = reader.header()._max_record_size;
+        config._hash_count = reader.header()._hash_count;
+        std::cout << "✓ HashMaster mapped read-only: " << filename << " (capacity " << reader.capacity()
+                  << (reader.has_live_bitmap() ? ", live bitmap" : ", no live bitmap") << ")" << std::endl;
+        return true;
+    }
+    
     ~HashMasterViewer() {
         if (ownHashMaster && hashMaster) {
             delete hashMaster;
@@ -93,6 +117,15 @@ public:
             return false;
         }
         
+        columns.clear();
+        keyHandle = FieldHandle();
+        const auto& fields = recordLayout->getFields();
+        for (size_t i = 0; i < fields.size(); i++) {
+            if (columns.size() < 8) columns.push_back(recordLayout->handle(fields[i].name));
+            if (!keyHandle.valid() && fields[i].isKey) keyHandle = recordLayout->handle(fields[i].name);
+        }
+        if (!keyHandle.valid() && !fields.empty()) keyHandle = recordLayout->handle(fields[0].name);
+        
         std::cout << "✓ Loaded spec layout for: " << recordType << std::endl;
         std::cout << "  Record size: " << recordLayout->getRecordSize() << " bytes" << std::endl;
         std::cout << "  Field count: " << recordLayout->getFields().size() << std::endl;
@@ -100,7 +133,7 @@ public:
     }
     
     void printSummary() {
-        if (!hashMaster) {
+        if (!reader.is_open()) {
             std::cerr << "HashMaster not loaded" << std::endl;
             return;
         }
@@ -109,20 +142,22 @@ public:
         std::cout << "        HashMaster Summary" << std::endl;
         std::cout << "========================================" << std::endl;
         
-        auto stats = hashMaster->get_statistics();
+        int capacity = reader.capacity();
+        int used = reader.count_live();
         
         std::cout << "Configuration:" << std::endl;
         std::cout << "  Base filename: " << config._filename << std::endl;
         std::cout << "  Max records: " << config._max_record_count << std::endl;
         std::cout << "  Record size: " << config._max_record_size << " bytes" << std::endl;
         std::cout << "  Hash buckets: " << config._hash_count << std::endl;
+        std::cout << "  Segments: " << reader.segment_count() << std::endl;
         
         std::cout << "\nRecord Statistics:" << std::endl;
-        std::cout << "  Total records: " << stats.total_records << std::endl;
-        std::cout << "  Used records: " << stats.used_records << std::endl;
-        std::cout << "  Free records: " << stats.free_records << std::endl;
+        std::cout << "  Total records: " << capacity << std::endl;
+        std::cout << "  Used records: " << used << std::endl;
+        std::cout << "  Free records: " << (capacity - used) << std::endl;
         std::cout << "  Utilization: " << std::fixed << std::setprecision(1) 
-                  << stats.record_utilization << "%" << std::endl;
+                  << (capacity > 0 ? used * 100.0 / capacity : 0.0) << "%" << std::endl;
         
         if (recordLayout) {
             std::cout << "\nRecord Layout:" << std::endl;
@@ -133,73 +168,62 @@ public:
         std::cout << std::endl;
     }
     
-    void listAllRecords(int limit = 100) {
-        if (!hashMaster) {
+    // limit == 0 이면 전부. 구간을 threads 개 스레드로 나눠 읽고 format 해서 순서대로 stdout 에 흘려보낸다.
+    void listAllRecords(int limit, const std::string& keyPrefix, int threads) {
+        if (!reader.is_open()) {
             std::cerr << "HashMaster not loaded" << std::endl;
             return;
         }
+        if (!keyPrefix.empty() && recordLayout && !keyHandle.valid()) {
+            std::cerr << "Layout has no field for --prefix" << std::endl;
+            return;
+        }
         
         std::cout << "\n========================================" << std::endl;
         std::cout << "         All Records List" << std::endl;
         std::cout << "========================================" << std::endl;
         
-        int recordCount = 0;
-        int maxRecords = config._max_record_count;
-        
         if (recordLayout) {
             printHeaderRow();
             std::cout << std::string(120, '-') << std::endl;
         }
-        
-        // Use HashMaster's iterator approach by checking each record entry directly
-        for (int i = 0; i < maxRecords && recordCount < limit; i++) {
-            try {
-                // Get record entry directly to check if it's occupied
-                // Note: get_record_by_seq expects 1-based index, we use 0-based
-                char* recordData = hashMaster->get_record_by_seq(i + 1);
-                
-                if (recordData) {
-                    // Check if the record is actually occupied by checking the first few bytes
-                    bool hasData = false;
-                    for (int j = 0; j < std::min(20, config._max_record_size); j++) {
-                        if (recordData[j] != 0) {
-                            hasData = true;
-                            break;
-                        }
-                    }
-                    
-                    if (hasData) {
-                        recordCount++;
-                        
-                        if (recordLayout) {
-                            printRecordRow(recordCount, recordData, config._max_record_size);
-                        } else {
-                            printRawRecord(recordCount, i, recordData, config._max_record_size);
-                        }
-                        
-                        if (recordCount >= limit) {
-                            std::cout << "\n... (showing first " << limit << " records)" << std::endl;
-                            break;
-                        }
-                    }
+        std::cout << std::flush;
+        
+        size_t chunks = ((size_t)reader.capacity() + LIST_CHUNK_RECORDS - 1) / LIST_CHUNK_RECORDS;
+        std::atomic<int> busy(0);
+        OrderedChunkWriter writer(threads);
+        size_t shown = writer.run(chunks, [&](size_t chunk, std::string& out) {
+            int from = (int)(chunk * LIST_CHUNK_RECORDS);
+            int busyCount = 0;
+            reader.scan(from, from + LIST_CHUNK_RECORDS, [&](int index, const char* record) {
+                if (!matchesPrefix(record, keyPrefix)) return true;
+                if (recordLayout) {
+                    formatRecordRow(out, index, record);
+                } else {
+                    formatRawRecord(out, index, record, config._max_record_size);
                 }
-            } catch (...) {
-                // Skip invalid records
-                continue;
-            }
-        }
+                return true;
+            }, &busyCount);
+            busy += busyCount;
+            return true;
+        }, limit > 0 ? (size_t)limit : 0);
         
-        if (recordCount == 0) {
+        if (shown == 0) {
             std::cout << "No records found in HashMaster" << std::endl;
         } else {
-            std::cout << "\nTotal records displayed: " << recordCount << std::endl;
+            std::cout << "\nTotal records displayed: " << shown
+                      << (limit > 0 && shown >= (size_t)limit ? " (limit reached)" : "") << std::endl;
+        }
+        if (busy > 0) {
+            std::cout << "Skipped " << busy.load() << " records being written" << std::endl;
         }
         
         std::cout << std::endl;
     }
     
     void searchRecord(const std::string& key, bool isPrimary = true) {
-        if (!hashMaster) {
+        // key 조회는 index 가 필요하므로 HashMaster 로 연다
+        if (!hashMaster && !loadHashMasterFromFile(config._filename)) {
             std::cerr << "HashMaster not loaded" << std::endl;
             return;
         }
@@ -287,27 +311,44 @@ private:
         std::cout << std::endl;
     }
     
-    void printRecordRow(int recordNo, char* recordData, int recordSize) {
-        if (!recordLayout || !recordData) return;
-        
-        BinaryRecord record(recordLayout, recordData);
-        const auto& fields = recordLayout->getFields();
-        
-        std::cout << std::left << std::setw(6) << recordNo;
+    bool matchesPrefix(const char* record, const std::string& prefix) const {
+        if (prefix.empty()) return true;
+        if (!recordLayout) {
+            return strncmp(record, prefix.c_str(), prefix.size()) == 0;
+        }
+        BinaryRecordView view(const_cast<char*>(record), config._max_record_size);
+        return view.getValue(keyHandle).compare(0, prefix.size(), prefix) == 0;
+    }
+    
+    void formatRecordRow(std::string& out, int index, const char* record) const {
+        BinaryRecordView view(const_cast<char*>(record), config._max_record_size);
+        char cell[16];
+        snprintf(cell, sizeof(cell), "%-6d", index);
+        out += cell;
         
         // Print first few important fields as columns
-        int fieldCount = 0;
-        for (const auto& field : fields) {
-            if (fieldCount >= 8) break;  // Limit columns for readability
-            
-            std::string value = record.getValue(field.name);
-            if (value.length() > 11) {
-                value = value.substr(0, 11);
-            }
-            std::cout << std::setw(12) << value;
-            fieldCount++;
+        for (const auto& h : columns) {
+            std::string value = view.getValue(h);
+            snprintf(cell, sizeof(cell), "%-12.11s", value.c_str());
+            out += cell;
         }
-        std::cout << std::endl;
+        out += '\n';
+    }
+    
+    void formatRawRecord(std::string& out, int index, const char* recordData, int recordSize) const {
+        out += "Record index " + std::to_string(index) + ": ";
+        
+        // Print first 60 characters of raw data
+        int printLen = std::min(60, recordSize);
+        for (int i = 0; i < printLen; i++) {
+            char c = recordData[i];
+            if (c == '\0') break;
+            out += std::isprint(static_cast<unsigned char>(c)) ? c : '.';
+        }
+        if (recordSize > 60) {
+            out += "...";
+        }
+        out += '\n';
     }
     
     void printDetailedRecord(const std::string& key, char* recordData, int recordSize) {
@@ -346,26 +387,6 @@ private:
         }
     }
     
-    void printRawRecord(int recordNo, int index, char* recordData, int recordSize) {
-        std::cout << "Record " << recordNo << " (index " << index << "): ";
-        
-        // Print first 60 characters of raw data
-        int printLen = std::min(60, recordSize);
-        for (int i = 0; i < printLen; i++) {
-            char c = recordData[i];
-            if (c == '\0') break;
-            if (std::isprint(c)) {
-                std::cout << c;
-            } else {
-                std::cout << '.';
-            }
-        }
-        if (recordSize > 60) {
-            std::cout << "...";
-        }
-        std::cout << std::endl;
-    }
-    
     void printRawRecordData(const std::string& key, char* recordData, int recordSize) {
         std::cout << "\nRaw record data for key: " << key << std::endl;
         std::cout << std::string(60, '-') << std::endl;
@@ -413,7 +434,9 @@ void printUsage(const char* program) {
     std::cout << "Options:" << std::endl;
     std::cout << "  --spec <path> <type> Load spec layout from YAML directory or TSV file for record type" << std::endl;
     std::cout << "  --summary            Show HashMaster summary (default if no other options)" << std::endl;
-    std::cout << "  --list [N]           List all records (limit to N records, default: 100)" << std::endl;
+    std::cout << "  --list [N]           List all records (limit to N records, default: 100, 0: all)" << std::endl;
+    std::cout << "  --prefix <str>       With --list, only records whose key field starts with <str>" << std::endl;
+    std::cout << "  --threads <N>        Threads for --list (default: min(cores, 8))" << std::endl;
     std::cout << "  --search-primary <key>  Search by primary key" << std::endl;
     std::cout << "  --search-secondary <key> Search by secondary key" << std::endl;
     std::cout << "  --fields             Show field layout (requires --spec)" << std::endl;
@@ -425,6 +448,9 @@ void printUsage(const char* program) {
     std::cout << "  # List records with YAML spec layout" << std::endl;
     std::cout << "  " << program << " equity_master --spec config/SPECs MMP_EQUITY_MASTER --list 50" << std::endl;
     std::cout << std::endl;
+    std::cout << "  # Stream every record of a live master whose key starts with 72" << std::endl;
+    std::cout << "  " << program << " equity_master --spec config/SPECs MMP_EQUITY_MASTER --list 0 --prefix 72 --threads 8" << std::endl;
+    std::cout << std::endl;
     std::cout << "  # Search for specific record using YAML specs" << std::endl;
     std::cout << "  " << program << " equity_master --spec config/SPECs MMP_EQUITY_MASTER --search-primary \"AAPL.O\"" << std::endl;
     std::cout << std::endl;
@@ -456,6 +482,8 @@ int main(int argc, char* argv[]) {
     bool listRecords = false;
     bool showFields = false;
     int listLimit = 100;
+    std::string keyPrefix;
+    int threads = (int)std::min(std::max(std::thread::hardware_concurrency(), 1u), 8u);
     std::string searchPrimaryKey;
     std::string searchSecondaryKey;
     
@@ -478,6 +506,18 @@ int main(int argc, char* argv[]) {
             if (i + 1 < argc && std::isdigit(argv[i + 1][0])) {
                 listLimit = std::atoi(argv[++i]);
             }
+        } else if (arg == "--prefix") {
+            if (i + 1 >= argc) {
+                std::cerr << "Error: --prefix requires a string argument" << std::endl;
+                return 1;
+            }
+            keyPrefix = argv[++i];
+        } else if (arg == "--threads") {
+            if (i + 1 >= argc || std::atoi(argv[i + 1]) <= 0) {
+                std::cerr << "Error: --threads requires a positive number" << std::endl;
+                return 1;
+            }
+            threads = std::atoi(argv[++i]);
         } else if (arg == "--search-primary") {
             if (i + 1 >= argc) {
                 std::cerr << "Error: --search-primary requires a key argument" << std::endl;
@@ -506,8 +546,8 @@ int main(int argc, char* argv[]) {
     
     HashMasterViewer viewer;
     
-    // Load HashMaster
-    if (!viewer.loadHashMasterFromFile(filename)) {
+    // Map HashMaster read-only (search 는 필요할 때 HashMaster 로 다시 연다)
+    if (!viewer.openReader(filename)) {
         std::cerr << "Failed to load HashMaster: " << filename << std::endl;
         return 1;
     }
@@ -530,7 +570,7 @@ int main(int argc, char* argv[]) {
     }
     
     if (listRecords) {
-        viewer.listAllRecords(listLimit);
+        viewer.listAllRecords(listLimit, keyPrefix, threads);
     }
     
     if (!searchPrimaryKey.empty()) {